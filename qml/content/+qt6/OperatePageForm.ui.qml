@@ -8,6 +8,7 @@ import QtQuick.Dialogs
 import QtCore
 import SettingsGUI 1.0
 import "./controls"
+import "./dialog"
 
 Item {
     id: root
@@ -16,6 +17,12 @@ Item {
 
     property alias exportButton: exportButton
     property alias exportScreenshotsButton: exportScreenshotsButton
+    property alias viewScreenshotsButton: viewScreenshotsButton
+    property alias screenshotGalleryPopup: screenshotGalleryPopup
+    property alias screenshotArchiveSwitch: screenshotArchiveSwitch
+    property alias screenshotProgressLayout: screenshotProgressLayout
+    property alias screenshotProgressBar: screenshotProgressBar
+    property alias screenshotProgressLabel: screenshotProgressLabel
     property alias importButton: importButton
     property alias exitButton: exitButton
     property alias opfileDialog: opfileDialog
@@ -66,6 +73,42 @@ Item {
                 objectName: "exportScreenshotsButton"
                 Layout.leftMargin: Constants.baseMargin
             }
+            NetworkButton {
+                id: viewScreenshotsButton
+                text: qsTr("View")
+                objectName: "viewScreenshotsButton"
+                Layout.leftMargin: Constants.baseMargin
+            }
+            RowLayout {
+                spacing: 10
+                Layout.leftMargin: Constants.baseMargin
+
+                ScreenLabel {
+                    text: qsTr("Export as one archive ")
+                }
+                NetworkSwitch {
+                    id: screenshotArchiveSwitch
+                    objectName: "screenshotArchiveSwitch"
+                }
+            }
+            ColumnLayout {
+                id: screenshotProgressLayout
+                visible: false
+                spacing: 10
+                Layout.leftMargin: Constants.baseMargin
+
+                PercentageBar {
+                    id: screenshotProgressBar
+                }
+                ScreenLabel {
+                    id: screenshotProgressLabel
+                }
+                NetworkButton {
+                    id: cancelScreenshotsButton
+                    text: qsTr("Cancel")
+                    objectName: "cancelScreenshotsButton"
+                }
+            }
         }
 
         ColumnLayout {
@@ -193,4 +236,9 @@ Item {
         property bool isConfig: true
         property bool isScreenshot: false
     }
+
+    ScreenshotGalleryPopup {
+        id: screenshotGalleryPopup
+        objectName: "screenshotGalleryPopup"
+    }
 }
@@ -0,0 +1,15 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+import QtQuick 2.15
+
+DiagnosticsPageForm {
+    // these functions call from c++
+    function showResult(result) {
+        resultLabel.text = result;
+    }
+
+    function showStatistics(statistics) {
+        statisticsLabel.text = statistics;
+    }
+}
@@ -0,0 +1,130 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Layouts 1.15
+import SettingsGUI 1.0
+import "./controls"
+
+Item {
+    id: root
+    width: Constants.pageWidth
+    height: Constants.pageHeight
+    clip: true
+
+    property alias hostTextField: hostTextField
+    property alias portTextField: portTextField
+    property alias countTextField: countTextField
+    property alias resultLabel: resultLabel
+    property alias statisticsLabel: statisticsLabel
+
+    Rectangle {
+        anchors.fill: parent
+        color: appPalette.pageBGColor
+    }
+
+    Flickable {
+        id: flickable
+        anchors.fill: parent
+        contentWidth: parent.width
+        contentHeight: mainLayout.implicitHeight + Constants.baseMargin * 2
+        clip: true
+        ScrollBar.vertical: ScrollBar {}
+
+        ColumnLayout {
+            id: mainLayout
+            spacing: Constants.splitMargin
+            anchors.fill: parent
+            anchors.margins: Constants.baseMargin
+            Layout.alignment: Qt.AlignTop
+
+            GridLayout {
+                columns: 2
+                rowSpacing: Constants.itemMargin
+                columnSpacing: Constants.itemMargin
+                Layout.alignment: Qt.AlignTop
+
+                ScreenLabel {
+                    text: qsTr("Host: ")
+                }
+                GeneralTextField {
+                    id: hostTextField
+                    objectName: "hostTextField"
+                    placeholderText: qsTr("Empty for loopback")
+                }
+
+                ScreenLabel {
+                    text: qsTr("TCP Port: ")
+                }
+                NumberTextField {
+                    id: portTextField
+                    objectName: "portTextField"
+                    text: "80"
+                }
+
+                ScreenLabel {
+                    text: qsTr("Count: ")
+                }
+                NumberTextField {
+                    id: countTextField
+                    objectName: "countTextField"
+                    text: "10"
+                }
+            }
+
+            RowLayout {
+                spacing: Constants.itemMargin
+
+                NetworkButton {
+                    id: pingButton
+                    objectName: "pingButton"
+                    text: qsTr("Ping")
+                }
+                NetworkButton {
+                    id: connectButton
+                    objectName: "connectButton"
+                    text: qsTr("TCP Connect")
+                }
+                NetworkButton {
+                    id: throughputButton
+                    objectName: "throughputButton"
+                    text: qsTr("Throughput")
+                }
+            }
+
+            ScreenLabel {
+                text: qsTr("Result: ")
+            }
+            ScreenLabel {
+                id: resultLabel
+                objectName: "resultLabel"
+                font.family: "monospace"
+                Layout.maximumWidth: mainLayout.width
+            }
+
+            RowLayout {
+                spacing: Constants.itemMargin
+
+                ScreenLabel {
+                    text: qsTr("Interface Statistics: ")
+                }
+                NetworkButton {
+                    id: refreshButton
+                    objectName: "refreshButton"
+                    text: qsTr("Refresh")
+                }
+            }
+            ScreenLabel {
+                id: statisticsLabel
+                objectName: "statisticsLabel"
+                font.family: "monospace"
+                Layout.maximumWidth: mainLayout.width
+            }
+
+            Item {
+                Layout.fillHeight: true
+            }
+        }
+    }
+}
@@ -27,6 +27,7 @@ DrawerSideBarForm {
         updateForm.visible = updateButton.checked
         operateForm.visible = operateButton.checked
         passwordForm.visible = passwordButton.checked
+        diagnosticsForm.visible = diagnosticsButton.checked
         aboutForm.visible = aboutButton.checked
     }
 
@@ -149,6 +150,13 @@ DrawerSideBarForm {
         showPage()
     }
 
+    diagnosticsButton.onClicked: {
+        root.currentTab = qsTr("Diagnostics")
+        root.tabSelected()
+
+        showPage()
+    }
+
     aboutButton.onClicked: {
         root.currentTab = qsTr("About")
         root.tabSelected()
@@ -33,6 +33,7 @@ Drawer {
     property alias updateButton: updateButton
     property alias operateButton: operateButton
     property alias passwordButton: passwordButton
+    property alias diagnosticsButton: diagnosticsButton
     property alias aboutButton: aboutButton
     property alias exitButton: exitButton
 
@@ -175,6 +176,13 @@ Drawer {
                 ButtonGroup.group: btnGroup
             }
 
+            SideBarButton {
+                id: diagnosticsButton
+                objectName: "diagnosticsButton"
+                text: qsTr("Diagnostics")
+                ButtonGroup.group: btnGroup
+            }
+
             SideBarButton {
                 id: aboutButton
                 objectName: "aboutButton"
@@ -6,7 +6,7 @@ import QtQuick.Controls 2.15
 
 LogoPageForm {
     selectLogoButton.onClicked: {
-        fileDialog.nameFilters = ["Image files (*.bmp)"];
+        fileDialog.nameFilters = ["Image files (*.bmp *.png)"];
         fileDialog.open();
     }
 }
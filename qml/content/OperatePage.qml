@@ -25,4 +25,22 @@ OperatePageForm {
         opfolderDialog.isScreenshot = true;
         opfolderDialog.open();
     }
+
+    function openScreenshotGallery() {
+        screenshotGalleryPopup.open();
+    }
+
+    function showScreenshotProgress(isShow) {
+        exportScreenshotsButton.enabled = !isShow;
+        screenshotProgressLayout.visible = isShow;
+        if (isShow) {
+            updateScreenshotProgress(0, "");
+        }
+    }
+
+    function updateScreenshotProgress(percentage, progressText) {
+        screenshotProgressBar.percentage = percentage;
+        screenshotProgressBar.state = "valueChanged";
+        screenshotProgressLabel.text = progressText;
+    }
 }
@@ -7,6 +7,7 @@ import QtQuick.Layouts 1.15
 import Qt.labs.platform 1.1
 import SettingsGUI 1.0
 import "./controls"
+import "./dialog"
 
 Item {
     id: root
@@ -15,6 +16,12 @@ Item {
 
     property alias exportButton: exportButton
     property alias exportScreenshotsButton: exportScreenshotsButton
+    property alias viewScreenshotsButton: viewScreenshotsButton
+    property alias screenshotGalleryPopup: screenshotGalleryPopup
+    property alias screenshotArchiveSwitch: screenshotArchiveSwitch
+    property alias screenshotProgressLayout: screenshotProgressLayout
+    property alias screenshotProgressBar: screenshotProgressBar
+    property alias screenshotProgressLabel: screenshotProgressLabel
     property alias importButton: importButton
     property alias exitButton: exitButton
     property alias opfileDialog: opfileDialog
@@ -65,6 +72,42 @@ Item {
                 objectName: "exportScreenshotsButton"
                 Layout.leftMargin: Constants.baseMargin
             }
+            NetworkButton {
+                id: viewScreenshotsButton
+                text: qsTr("View")
+                objectName: "viewScreenshotsButton"
+                Layout.leftMargin: Constants.baseMargin
+            }
+            RowLayout {
+                spacing: 10
+                Layout.leftMargin: Constants.baseMargin
+
+                ScreenLabel {
+                    text: qsTr("Export as one archive ")
+                }
+                NetworkSwitch {
+                    id: screenshotArchiveSwitch
+                    objectName: "screenshotArchiveSwitch"
+                }
+            }
+            ColumnLayout {
+                id: screenshotProgressLayout
+                visible: false
+                spacing: 10
+                Layout.leftMargin: Constants.baseMargin
+
+                PercentageBar {
+                    id: screenshotProgressBar
+                }
+                ScreenLabel {
+                    id: screenshotProgressLabel
+                }
+                NetworkButton {
+                    id: cancelScreenshotsButton
+                    text: qsTr("Cancel")
+                    objectName: "cancelScreenshotsButton"
+                }
+            }
         }
 
         ColumnLayout {
@@ -192,4 +235,9 @@ Item {
         property bool isConfig: true
         property bool isScreenshot: false
     }
+
+    ScreenshotGalleryPopup {
+        id: screenshotGalleryPopup
+        objectName: "screenshotGalleryPopup"
+    }
 }
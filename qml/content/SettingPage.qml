@@ -44,6 +44,13 @@ SettingPageForm {
         calendarPopup.close()
     }
 
+    timezoneSearchPopup.onTimezoneSelected: function (timezone) {
+        if (timeForm.visible)
+            timeForm.timezoneComboBox.currentIndex = timeForm.timezoneComboBox.model.indexOf(timezone)
+        if (wiztimeForm.visible)
+            wiztimeForm.timezoneComboBox.currentIndex = wiztimeForm.timezoneComboBox.model.indexOf(timezone)
+    }
+
     loadingIndicatorTimer.onTriggered: {
         loadingIndicator.close();
     }
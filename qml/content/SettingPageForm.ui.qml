@@ -23,6 +23,7 @@ Item {
     property alias folderDialog: folderDialog
     property alias calendarPopup: calendarPopup
     property alias dateCalendar: dateCalendar
+    property alias timezoneSearchPopup: timezoneSearchPopup
     property alias arrowButton: arrowButton
     property alias sideBar: sideBar
     property alias drawerSideBar: drawerSideBar
@@ -43,6 +44,7 @@ Item {
     property alias updateForm: updateForm
     property alias operateForm: operateForm
     property alias passwordForm: passwordForm
+    property alias diagnosticsForm: diagnosticsForm
     property alias aboutForm: aboutForm
 
     Rectangle {
@@ -187,6 +189,13 @@ Item {
         visible: false
     }
 
+    DiagnosticsPage {
+        id: diagnosticsForm
+        objectName: "diagnosticsForm"
+        anchors.left: sideBar.right
+        visible: false
+    }
+
     AboutPage {
         id: aboutForm
         objectName: "aboutForm"
@@ -230,6 +239,11 @@ Item {
         anchors.centerIn: parent
     }
 
+    TimezoneSearchPopup {
+        id: timezoneSearchPopup
+        objectName: "timezoneSearchPopup"
+    }
+
     Popup {
         id: loadingIndicator
         objectName: "loadingIndicator"
@@ -241,9 +255,21 @@ Item {
             color: "transparent"
         }
 
-        BusyIndicator {
-            palette.dark: appPalette.btnTextColor
-            running: true
+        ColumnLayout {
+            spacing: 10
+            BusyIndicator {
+                palette.dark: appPalette.btnTextColor
+                running: true
+                Layout.alignment: Qt.AlignHCenter
+            }
+            // shown while the running job can be cancelled
+            NetworkButton {
+                id: loadingCancelButton
+                text: qsTr("Cancel")
+                objectName: "loadingCancelButton"
+                visible: false
+                Layout.alignment: Qt.AlignHCenter
+            }
         }
     }
     Timer {
@@ -27,6 +27,7 @@ SideBarForm {
         updateForm.visible = updateButton.checked
         operateForm.visible = operateButton.checked
         passwordForm.visible = passwordButton.checked
+        diagnosticsForm.visible = diagnosticsButton.checked
         aboutForm.visible = aboutButton.checked
     }
 
@@ -149,6 +150,13 @@ SideBarForm {
         showPage()
     }
 
+    diagnosticsButton.onClicked: {
+        root.currentTab = qsTr("Diagnostics")
+        root.tabSelected()
+
+        showPage()
+    }
+
     aboutButton.onClicked: {
         root.currentTab = qsTr("About")
         root.tabSelected()
@@ -30,6 +30,7 @@ Item {
     property alias updateButton: updateButton
     property alias operateButton: operateButton
     property alias passwordButton: passwordButton
+    property alias diagnosticsButton: diagnosticsButton
     property alias aboutButton: aboutButton
     property alias exitButton: exitButton
 
@@ -171,6 +172,13 @@ Item {
                 ButtonGroup.group: btnGroup
             }
 
+            SideBarButton {
+                id: diagnosticsButton
+                objectName: "diagnosticsButton"
+                text: qsTr("Diagnostics")
+                ButtonGroup.group: btnGroup
+            }
+
             SideBarButton {
                 id: aboutButton
                 objectName: "aboutButton"
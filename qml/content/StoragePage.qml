@@ -23,8 +23,9 @@ StoragePageForm {
         sdPartitionModel.clear();
     }
 
-    function addToEMMCPratitionModelList(label, mountPoint, uuid, fstype, size, usedPercent) {
+    function addToEMMCPratitionModelList(name, label, mountPoint, uuid, fstype, size, usedPercent) {
         let element = {
+            "name": name,
             "label": label, 
             "mountPoint": mountPoint,
             "uuid": uuid,
@@ -35,8 +36,9 @@ StoragePageForm {
         emmcPartitionModel.append(element);
     }
 
-    function addToSDPratitionModelList(label, mountPoint, uuid, fstype, size, usedPercent) {
+    function addToSDPratitionModelList(name, label, mountPoint, uuid, fstype, size, usedPercent) {
         let element = {
+            "name": name,
             "label": label, 
             "mountPoint": mountPoint,
             "uuid": uuid,
@@ -47,6 +49,87 @@ StoragePageForm {
         sdPartitionModel.append(element);
     }
 
+    function clearDevicePratitionModelList(isEMMC) {
+        let model = isEMMC ? emmcPartitionModel : sdPartitionModel;
+        model.clear();
+    }
+
+    // update single partition by name, append if not exists
+    function updatePratition(isEMMC, name, label, mountPoint, uuid, fstype, size, usedPercent) {
+        let model = isEMMC ? emmcPartitionModel : sdPartitionModel;
+        let element = {
+            "name": name,
+            "label": label, 
+            "mountPoint": mountPoint,
+            "uuid": uuid,
+            "fstype": fstype,
+            "size": size,
+            "usedPercent": usedPercent,
+        };
+        for (let i = 0; i < model.count; i++) {
+            if (model.get(i).name === name) {
+                model.set(i, element);
+                return;
+            }
+        }
+        model.append(element);
+    }
+
+    function removePratition(isEMMC, name) {
+        let model = isEMMC ? emmcPartitionModel : sdPartitionModel;
+        for (let i = 0; i < model.count; i++) {
+            if (model.get(i).name === name) {
+                model.remove(i);
+                return;
+            }
+        }
+    }
+
+    function refreshSDStoragePratitionUI() {
+        // show/hide sd partition without changing selection
+        sdColumnLayout.visible = (sdStorageGrid.count > 0);
+        sdNotExistColumnLayout.visible = (sdStorageGrid.count == 0);
+        refreshBenchmarkPartitionModel();
+    }
+
+    function showBenchmarkResult(result) {
+        benchmarkResultLabel.text = result;
+    }
+
+    function getCurrentTelemetryDevice() {
+        return telemetryDeviceModel.get(telemetryDeviceComboBox.currentIndex).value;
+    }
+
+    function updateTelemetry(readSeries, writeSeries, utilizationSeries, capacity, maxThroughput, summary) {
+        throughputChart.capacity = capacity;
+        throughputChart.title = maxThroughput;
+        throughputChart.series = [readSeries, writeSeries];
+        utilizationChart.capacity = capacity;
+        utilizationChart.series = [utilizationSeries];
+        telemetrySummaryLabel.text = summary;
+    }
+
+    function showHealth(health, isWarning) {
+        telemetryHealthLabel.text = health;
+        telemetryHealthLabel.color = isWarning ? "red" : appPalette.labelTextColor;
+    }
+
+    function getCurrentBenchmarkPartition() {
+        if (benchmarkPartitionComboBox.currentIndex < 0 ||
+            benchmarkPartitionComboBox.currentIndex >= benchmarkPartitionModel.count) {
+            return "";
+        }
+        return benchmarkPartitionModel.get(benchmarkPartitionComboBox.currentIndex).name;
+    }
+
+    function getCurrentBenchmarkMountPoint() {
+        if (benchmarkPartitionComboBox.currentIndex < 0 ||
+            benchmarkPartitionComboBox.currentIndex >= benchmarkPartitionModel.count) {
+            return "";
+        }
+        return benchmarkPartitionModel.get(benchmarkPartitionComboBox.currentIndex).mountPoint;
+    }
+
     function initEMMCStoragePratitionUI() {
         // wait 200 milliseconds for UI component is ready
         // without delay might occur "Cannot read property 'children' of null"
@@ -71,6 +154,7 @@ StoragePageForm {
         // show/hide sd partition
         sdColumnLayout.visible = (sdStorageGrid.count > 0);
         sdNotExistColumnLayout.visible = (sdStorageGrid.count == 0);
+        refreshBenchmarkPartitionModel();
         if (storageSwipeView.currentIndex == 1) {
             // click sd card first partition
             if (sdStorageGrid.count > 0) {
@@ -84,6 +168,31 @@ StoragePageForm {
     }
 
     // these functions call from qml
+    function refreshBenchmarkPartitionModel() {
+        // only mounted partitions can hold the temp file
+        let current = getCurrentBenchmarkPartition();
+        let nIndex = 0;
+        benchmarkPartitionModel.clear();
+        let models = [emmcPartitionModel, sdPartitionModel];
+        for (let m = 0; m < models.length; m++) {
+            for (let i = 0; i < models[m].count; i++) {
+                let item = models[m].get(i);
+                if (item.mountPoint === "") {
+                    continue;
+                }
+                if (item.name === current) {
+                    nIndex = benchmarkPartitionModel.count;
+                }
+                benchmarkPartitionModel.append({
+                    "text": item.name + " (" + item.mountPoint + ")",
+                    "name": item.name,
+                    "mountPoint": item.mountPoint,
+                });
+            }
+        }
+        benchmarkPartitionComboBox.currentIndex = nIndex;
+    }
+
     function showPratition(label, mountPoint, uuid, fstype, size, usedPercent) {
         if (storageSwipeView.currentIndex == 0) {
             // emmc
@@ -124,9 +233,12 @@ StoragePageForm {
         if (storageSwipeView.currentIndex == 0) {
             // emmc
             initEMMCStoragePratitionUI();
-        } else {
+        } else if (storageSwipeView.currentIndex == 1) {
             // sd card
             initSDStoragePratitionUI();
+        } else if (storageSwipeView.currentIndex == 2) {
+            // benchmark
+            refreshBenchmarkPartitionModel();
         }
     }
 }
@@ -32,6 +32,15 @@ Item {
     property alias fsTypeLabel2: fsTypeLabel2
     property alias sizeLabel2: sizeLabel2
     property alias usedPercentBar2: usedPercentBar2
+    property alias benchmarkPartitionModel: benchmarkPartitionModel
+    property alias benchmarkPartitionComboBox: benchmarkPartitionComboBox
+    property alias benchmarkResultLabel: benchmarkResultLabel
+    property alias telemetryDeviceModel: telemetryDeviceModel
+    property alias telemetryDeviceComboBox: telemetryDeviceComboBox
+    property alias telemetrySummaryLabel: telemetrySummaryLabel
+    property alias throughputChart: throughputChart
+    property alias utilizationChart: utilizationChart
+    property alias telemetryHealthLabel: telemetryHealthLabel
     property int tabbarHeight: tabBar.height
 
     Rectangle {
@@ -59,6 +68,10 @@ Item {
         id: sdPartitionModel
     }
 
+    ListModel {
+        id: benchmarkPartitionModel
+    }
+
     ColumnLayout {
         id: mainLayout
         width: parent.width
@@ -76,6 +89,12 @@ Item {
             NetworkTabButton {
                 text: qsTr("SD Card")
             }
+            NetworkTabButton {
+                text: qsTr("Benchmark")
+            }
+            NetworkTabButton {
+                text: qsTr("Telemetry")
+            }
         }
 
         SwipeView {
@@ -333,6 +352,168 @@ Item {
                     }
                 }
             }
+
+            Item {
+                id: thirdPage
+                width: storageSwipeView.width
+                height: storageSwipeView.height
+
+                ColumnLayout {
+                    width: parent.width
+                    height: parent.height
+                    anchors.fill: parent
+                    anchors.margins: Constants.baseMargin
+                    Layout.alignment: Qt.AlignTop
+
+                    GridLayout {
+                        columns: 2
+                        rowSpacing: Constants.itemMargin
+                        columnSpacing: Constants.itemMargin
+                        Layout.alignment: Qt.AlignTop
+
+                        ScreenLabel {
+                            text: qsTr("Volume: ")
+                        }
+                        TimeComboBox {
+                            id: benchmarkPartitionComboBox
+                            objectName: "benchmarkPartitionComboBox"
+                            implicitWidth: Constants.generalComboBoxWidth
+                            textRole: "text"
+                            model: benchmarkPartitionModel
+                        }
+
+                        ScreenLabel {
+                            text: qsTr("File Size (MB): ")
+                        }
+                        NumberTextField {
+                            id: benchmarkSizeTextField
+                            objectName: "benchmarkSizeTextField"
+                            text: "64"
+                        }
+
+                        ScreenLabel {
+                            text: qsTr("Queue Depth: ")
+                        }
+                        NumberTextField {
+                            id: benchmarkQueueDepthTextField
+                            objectName: "benchmarkQueueDepthTextField"
+                            text: "1"
+                        }
+                    }
+
+                    RowLayout {
+                        spacing: Constants.itemMargin
+
+                        NetworkButton {
+                            id: benchmarkButton
+                            objectName: "benchmarkButton"
+                            text: qsTr("Run")
+                        }
+                        NetworkButton {
+                            id: benchmarkExportButton
+                            objectName: "benchmarkExportButton"
+                            text: qsTr("Export JSON")
+                        }
+                    }
+
+                    ScreenLabel {
+                        text: qsTr("Result: ")
+                    }
+                    ScreenLabel {
+                        id: benchmarkResultLabel
+                        objectName: "benchmarkResultLabel"
+                        font.family: "monospace"
+                        Layout.maximumWidth: mainLayout.width
+                    }
+
+                    Item {
+                        Layout.fillHeight: true
+                    }
+                }
+            }
+
+            Item {
+                id: fourthPage
+                width: storageSwipeView.width
+                height: storageSwipeView.height
+
+                Flickable {
+                    anchors.fill: parent
+                    contentWidth: parent.width
+                    contentHeight: telemetryLayout.implicitHeight + Constants.baseMargin * 2
+                    clip: true
+                    ScrollBar.vertical: ScrollBar {}
+
+                    ColumnLayout {
+                        id: telemetryLayout
+                        anchors.fill: parent
+                        anchors.margins: Constants.baseMargin
+                        Layout.alignment: Qt.AlignTop
+
+                        RowLayout {
+                            spacing: Constants.itemMargin
+
+                            ScreenLabel {
+                                text: qsTr("Device: ")
+                            }
+                            TimeComboBox {
+                                id: telemetryDeviceComboBox
+                                objectName: "telemetryDeviceComboBox"
+                                implicitWidth: Constants.generalComboBoxWidth
+                                textRole: "text"
+                                model: ListModel {
+                                    id: telemetryDeviceModel
+
+                                    ListElement {
+                                        text: "eMMC"
+                                        value: "mmcblk2"
+                                    }
+
+                                    ListElement {
+                                        text: "SD Card"
+                                        value: "mmcblk1"
+                                    }
+                                }
+                            }
+                        }
+
+                        ScreenLabel {
+                            id: telemetrySummaryLabel
+                            objectName: "telemetrySummaryLabel"
+                            font.family: "monospace"
+                        }
+
+                        ScreenLabel {
+                            text: qsTr("Throughput (read / write): ")
+                        }
+                        TelemetryChart {
+                            id: throughputChart
+                        }
+
+                        ScreenLabel {
+                            text: qsTr("Utilization: ")
+                        }
+                        TelemetryChart {
+                            id: utilizationChart
+                            maxValue: 100
+                            title: "100%"
+                        }
+
+                        ScreenLabel {
+                            text: qsTr("Health: ")
+                        }
+                        ScreenLabel {
+                            id: telemetryHealthLabel
+                            objectName: "telemetryHealthLabel"
+                            Layout.maximumWidth: Constants.maximumLabelWidth
+                        }
+
+                        Item {
+                            Layout.fillHeight: true
+                        }
+                    }
+                }
+            }
         }
     }
 }
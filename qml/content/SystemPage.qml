@@ -202,6 +202,14 @@ SystemPageForm {
         return com1ModeModel.get(com1ModeComboBox.currentIndex).value;
     }
 
+    function getCurrentComBenchmarkPort() {
+        return comPortModel.get(comBenchmarkComboBox.currentIndex).value;
+    }
+
+    function showComBenchmarkResult(result) {
+        comBenchmarkResultLabel.text = result;
+    }
+
     function getCurrentCronMode() {
         return cronModeModel.get(cronModeComboBox.currentIndex).value;
     }
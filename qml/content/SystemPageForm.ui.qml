@@ -29,6 +29,9 @@ Item {
     property alias com1BaudRateComboBox: com1BaudRateComboBox
     property alias com2BaudRateComboBox: com2BaudRateComboBox
     property alias comBaudRateModel: comBaudRateModel
+    property alias comPortModel: comPortModel
+    property alias comBenchmarkComboBox: comBenchmarkComboBox
+    property alias comBenchmarkResultLabel: comBenchmarkResultLabel
     property alias webPageGroup: webPageGroup
     property alias webPageModel: webPageModel
     property alias webPageRepeater: webPageRepeater
@@ -41,6 +44,7 @@ Item {
     property alias cronHourComboBox: cronHourComboBox
     property alias cronDayofweekLabel: cronDayofweekLabel
     property alias cronDayofweekComboBox: cronDayofweekComboBox
+    property alias nextRebootLabel: nextRebootLabel
     property int tabbarHeight: systemTabBar.height
 
     Rectangle {
@@ -451,6 +455,15 @@ Item {
                                 model: [0, 1, 2, 3, 4, 5, 6, 7]
                                 implicitWidth: Constants.smallComboBoxWidth
                             }
+
+                            ScreenLabel {
+                                text: qsTr("Next reboot: ")
+                            }
+                            ScreenLabel {
+                                id: nextRebootLabel
+                                objectName: "nextRebootLabel"
+                                text: "-"
+                            }
                         }
                     }
 
@@ -537,6 +550,33 @@ Item {
                         }
                     }
 
+                    RowLayout {
+                        spacing: Constants.itemMargin
+                        Layout.alignment: Qt.AlignTop
+
+                        ScreenLabel {
+                            text: qsTr("Loopback Test: ")
+                        }
+                        TimeComboBox {
+                            id: comBenchmarkComboBox
+                            objectName: "comBenchmarkComboBox"
+                            implicitWidth: Constants.generalComboBoxWidth
+                            textRole: "text"
+                            model: comPortModel
+                        }
+                        NetworkButton {
+                            id: comBenchmarkButton
+                            objectName: "comBenchmarkButton"
+                            text: qsTr("Run")
+                        }
+                    }
+
+                    ScreenLabel {
+                        id: comBenchmarkResultLabel
+                        objectName: "comBenchmarkResultLabel"
+                        font.family: "monospace"
+                    }
+
                     Item {
                         Layout.fillHeight: true
                     }
@@ -601,6 +641,19 @@ Item {
         }
     }
 
+    ListModel {
+        id: comPortModel
+
+        ListElement {
+            text: "COM1"
+            value: "com1"
+        }
+        ListElement {
+            text: "COM2"
+            value: "com2"
+        }
+    }
+
     ListModel {
         id: comBaudRateModel
 
@@ -15,8 +15,8 @@ Item {
     property alias currentDateText: currentDateText
     property alias currentTimeText: currentTimeText
     property alias timezoneComboBox: timezoneComboBox
-    property alias timezoneModel: timezoneModel
     property alias timezoneTextField: timezoneTextField
+    property alias timezoneSearchButton: timezoneSearchButton
     property alias ntpRadioButton: ntpRadioButton
     property alias manualRadioButton: manualRadioButton
     property alias ntpServerTextField: ntpServerTextField
@@ -25,6 +25,8 @@ Item {
     property alias hourComboBox: hourComboBox
     property alias minuteComboBox: minuteComboBox
     property alias secondComboBox: secondComboBox
+    property alias timeSyncChart: timeSyncChart
+    property alias timeSyncSummaryLabel: timeSyncSummaryLabel
 
     Rectangle {
         anchors.fill: parent
@@ -76,9 +78,12 @@ Item {
                 id: timezoneComboBox
                 objectName: "timezoneComboBox"
                 textRole: "text"
-                model: ListModel {
-                    id: timezoneModel
-                }
+            }
+
+            NetworkButton {
+                id: timezoneSearchButton
+                objectName: "timezoneSearchButton"
+                text: qsTr("Search")
             }
 
             GeneralTextField {
@@ -115,6 +120,22 @@ Item {
             }
         }
 
+        RowLayout {
+            Layout.leftMargin: Constants.indentMargin
+            spacing: Constants.itemMargin
+
+            // offset and jitter history
+            TelemetryChart {
+                id: timeSyncChart
+            }
+
+            ScreenLabel {
+                id: timeSyncSummaryLabel
+                objectName: "timeSyncSummaryLabel"
+                font.family: "monospace"
+            }
+        }
+
         Item {
             height: Constants.baseMargin
         }
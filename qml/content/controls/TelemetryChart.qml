@@ -0,0 +1,76 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+import QtQuick 2.15
+import SettingsGUI 1.0
+
+Item {
+    id: root
+    implicitWidth: Constants.telemetryChartWidth
+    implicitHeight: Constants.telemetryChartHeight
+    // array of arrays, oldest value first
+    property var series: []
+    property var colors: [appPalette.barColor, appPalette.chartSecondColor]
+    // 0 means scaling to the largest value
+    property real maxValue: 0
+    // samples across the whole width
+    property int capacity: 120
+    property string title: ""
+
+    onSeriesChanged: canvas.requestPaint()
+
+    function scaleValue() {
+        if (maxValue > 0) {
+            return maxValue;
+        }
+        let max = 0;
+        for (let s = 0; s < series.length; s++) {
+            for (let i = 0; i < series[s].length; i++) {
+                max = Math.max(max, series[s][i]);
+            }
+        }
+        return max > 0 ? max : 1;
+    }
+
+    Canvas {
+        id: canvas
+        anchors.fill: parent
+
+        onPaint: {
+            let ctx = getContext("2d");
+            ctx.reset();
+            ctx.strokeStyle = appPalette.borderColor;
+            ctx.lineWidth = 1;
+            ctx.strokeRect(0.5, 0.5, width - 1, height - 1);
+
+            let scale = root.scaleValue();
+            let step = width / Math.max(root.capacity - 1, 1);
+            ctx.lineWidth = 2;
+            for (let s = 0; s < root.series.length; s++) {
+                let values = root.series[s];
+                // newest sample sticks to the right border
+                let offset = root.capacity - values.length;
+                ctx.strokeStyle = root.colors[s % root.colors.length];
+                ctx.beginPath();
+                for (let i = 0; i < values.length; i++) {
+                    let x = (offset + i) * step;
+                    let y = height - 1 - (values[i] / scale) * (height - 2);
+                    if (i === 0) {
+                        ctx.moveTo(x, y);
+                    } else {
+                        ctx.lineTo(x, y);
+                    }
+                }
+                ctx.stroke();
+            }
+        }
+    }
+
+    Text {
+        anchors.top: parent.top
+        anchors.left: parent.left
+        anchors.margins: 4
+        color: appPalette.labelTextColor
+        text: root.title
+    }
+}
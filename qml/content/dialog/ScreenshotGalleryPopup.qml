@@ -0,0 +1,128 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Layouts 1.15
+import SettingsGUI 1.0
+import "../controls"
+
+// model is set from c++, thumbnails come from image://screenshots
+Popup {
+    id: control
+    modal: true
+    focus: true
+    closePolicy: Popup.CloseOnEscape
+    x: 0
+    y: 0
+    width: Constants.screenWidth
+    height: Constants.screenHeight
+
+    readonly property int thumbnailWidth: 240
+    readonly property int thumbnailHeight: 160
+
+    background: Rectangle {
+        color: appPalette.pageBGColor
+    }
+
+    onClosed: {
+        previewImage.source = "";
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        spacing: 10
+
+        RowLayout {
+            Layout.fillWidth: true
+
+            ScreenLabel {
+                text: qsTr("Screenshots: ") + screenshotGalleryView.count
+                Layout.fillWidth: true
+            }
+            NetworkButton {
+                text: qsTr("Close")
+                onClicked: {
+                    control.close();
+                }
+            }
+        }
+
+        GridView {
+            id: screenshotGalleryView
+            objectName: "screenshotGalleryView"
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            cellWidth: control.thumbnailWidth + 20
+            cellHeight: control.thumbnailHeight + 60
+            // keep about two rows ready outside the view while scrolling
+            cacheBuffer: cellHeight * 2
+            boundsBehavior: Flickable.StopAtBounds
+            ScrollBar.vertical: ScrollBar {}
+
+            delegate: Item {
+                width: screenshotGalleryView.cellWidth
+                height: screenshotGalleryView.cellHeight
+
+                Column {
+                    anchors.centerIn: parent
+                    spacing: 4
+
+                    Rectangle {
+                        width: control.thumbnailWidth
+                        height: control.thumbnailHeight
+                        color: appPalette.btnBGColor
+
+                        Image {
+                            anchors.fill: parent
+                            source: model.thumbnail
+                            asynchronous: true
+                            fillMode: Image.PreserveAspectFit
+                        }
+                        MouseArea {
+                            anchors.fill: parent
+                            onClicked: {
+                                previewImage.source = "file://" + model.path;
+                            }
+                        }
+                    }
+                    Text {
+                        width: control.thumbnailWidth
+                        text: model.name
+                        color: appPalette.labelTextColor
+                        elide: Text.ElideMiddle
+                    }
+                    Text {
+                        width: control.thumbnailWidth
+                        text: model.modified + "  " + model.size
+                        color: appPalette.labelTextColor
+                    }
+                }
+            }
+        }
+    }
+
+    // full size view, tap to go back to the list
+    Rectangle {
+        anchors.fill: parent
+        color: appPalette.pageBGColor
+        visible: previewImage.source != ""
+
+        Image {
+            id: previewImage
+            anchors.fill: parent
+            asynchronous: true
+            cache: false
+            fillMode: Image.PreserveAspectFit
+            sourceSize.width: width
+            sourceSize.height: height
+        }
+        MouseArea {
+            anchors.fill: parent
+            onClicked: {
+                previewImage.source = "";
+            }
+        }
+    }
+}
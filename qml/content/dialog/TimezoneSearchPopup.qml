@@ -0,0 +1,98 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Layouts 1.15
+import SettingsGUI 1.0
+import "../controls"
+
+// model is TimezoneFilterModel set from c++, upper half of the screen so the keyboard stays visible
+Popup {
+    id: control
+    modal: true
+    focus: true
+    closePolicy: Popup.CloseOnEscape
+    x: 0
+    y: 0
+    width: Constants.screenWidth
+    height: Constants.screenHeight / 2
+
+    signal timezoneSelected(string timezone)
+
+    background: Rectangle {
+        color: appPalette.pageBGColor
+    }
+
+    onOpened: {
+        timezoneSearchTextField.text = "";
+        timezoneSearchTextField.forceActiveFocus();
+    }
+
+    onClosed: {
+        Qt.inputMethod.hide();
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        spacing: 10
+
+        RowLayout {
+            Layout.fillWidth: true
+
+            GeneralTextField {
+                id: timezoneSearchTextField
+                objectName: "timezoneSearchTextField"
+                Layout.fillWidth: true
+                placeholderText: qsTr("City, country or region")
+                // commit every key so the list follows each keystroke
+                inputMethodHints: Qt.ImhNoPredictiveText | Qt.ImhNoAutoUppercase
+                onTextChanged: {
+                    if (timezoneSearchView.model)
+                        timezoneSearchView.model.filterText = text;
+                }
+            }
+            NetworkButton {
+                text: qsTr("Close")
+                onClicked: {
+                    control.close();
+                }
+            }
+        }
+
+        ListView {
+            id: timezoneSearchView
+            objectName: "timezoneSearchView"
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            boundsBehavior: Flickable.StopAtBounds
+            ScrollBar.vertical: ScrollBar {}
+
+            section.property: "section"
+            section.criteria: ViewSection.FullString
+            section.delegate: Rectangle {
+                width: timezoneSearchView.width
+                height: sectionLabel.implicitHeight + 8
+                color: appPalette.btnBGColor
+
+                ScreenLabel {
+                    id: sectionLabel
+                    anchors.verticalCenter: parent.verticalCenter
+                    leftPadding: 8
+                    text: section
+                }
+            }
+
+            delegate: ItemDelegate {
+                width: timezoneSearchView.width
+                text: model.value + (model.isDst ? "  (" + model.abbreviation + ")" : "")
+                font.pointSize: Constants.timezoneComboBoxFontSize
+                onClicked: {
+                    control.timezoneSelected(model.value);
+                    control.close();
+                }
+            }
+        }
+    }
+}
@@ -11,6 +11,7 @@ QtObject {
     readonly property color pageBGColor: "white"
     readonly property color borderColor: "black"
     readonly property color barColor: "#f08b26"
+    readonly property color chartSecondColor: "#2d3133"
     readonly property color tabBtnBGColor: "#ffba75"
     readonly property color radioBtnBGColor: "black"
     readonly property color pressedBtnBGColor: "white"
@@ -11,6 +11,7 @@ QtObject {
     readonly property color pageBGColor: "#1e2122"
     readonly property color borderColor: "white"
     readonly property color barColor: "#52d161"
+    readonly property color chartSecondColor: "#3fa9f5"
     readonly property color tabBtnBGColor: "#3e4f54"
     readonly property color radioBtnBGColor: "white"
     readonly property color pressedBtnBGColor: "#1e2122"
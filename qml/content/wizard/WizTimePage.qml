@@ -4,39 +4,9 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import SettingsGUI 1.0
-import "../js/moment.js" as Moment
-import "../js/moment-timezone.js" as MomentTimezone
-import "../js/moment-timezone-with-data-10-year-range.js" as MomentTimezoneData
 
 WizTimePageForm {
     // these functions call from c++
-    function initTimezoneModel(sysTimezones) {
-        for(let i in sysTimezones)
-        {
-            let tmz = {
-                "text": " (GMT" + moment.tz(sysTimezones[i]).format('Z') + ") " + sysTimezones[i],
-                "value": sysTimezones[i],
-            };
-            timezoneModel.append(tmz);
-        }
-    }
-
-    function initTimezoneComboBox(timezone) {
-        let tIndex;
-
-        for(let i = 0; i < timezoneModel.count; i++)
-        {
-            if (timezoneModel.get(i).value === timezone) {
-                tIndex = i;
-                break;
-            } else if (timezoneModel.get(i).value === "UTC" && timezone === "Universal") {
-                tIndex = i;
-                break;
-            }
-        }
-        timezoneComboBox.currentIndex = tIndex;
-    }
-
     function initTimeComboBox() {
         let current = new Date();
         let hour = Qt.formatDateTime(current, "hh");
@@ -78,6 +48,10 @@ WizTimePageForm {
         calendarPopup.open()
     }
 
+    timezoneSearchButton.onClicked: {
+        timezoneSearchPopup.open()
+    }
+
     ntpRadioButton.onClicked: {
         ntpServerTextField.enabled = ntpRadioButton.checked
         dateButton.enabled = manualRadioButton.checked
@@ -95,6 +69,8 @@ WizTimePageForm {
     }
 
     timezoneComboBox.onCurrentIndexChanged: {
-        timezoneTextField.text = timezoneModel.get(timezoneComboBox.currentIndex).value;
+        // model is TimezoneListModel set from c++
+        if (timezoneComboBox.currentIndex >= 0)
+            timezoneTextField.text = timezoneComboBox.model.valueAt(timezoneComboBox.currentIndex);
     }
 }
@@ -15,8 +15,8 @@ Item {
     property alias currentDateText: currentDateText
     property alias currentTimeText: currentTimeText
     property alias timezoneComboBox: timezoneComboBox
-    property alias timezoneModel: timezoneModel
     property alias timezoneTextField: timezoneTextField
+    property alias timezoneSearchButton: timezoneSearchButton
     property alias ntpRadioButton: ntpRadioButton
     property alias manualRadioButton: manualRadioButton
     property alias ntpServerTextField: ntpServerTextField
@@ -76,9 +76,12 @@ Item {
                 id: timezoneComboBox
                 objectName: "timezoneComboBox"
                 textRole: "text"
-                model: ListModel {
-                    id: timezoneModel
-                }
+            }
+
+            NetworkButton {
+                id: timezoneSearchButton
+                objectName: "timezoneSearchButton"
+                text: qsTr("Search")
             }
 
             GeneralTextField {
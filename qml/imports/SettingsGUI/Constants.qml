@@ -81,6 +81,8 @@ QtObject {
     readonly property int textFieldHeight: inMiniScreen ? vscale(86) : vscale(56)
     readonly property int percentageBarWidth: hscale(900)
     readonly property int percentageBarFrontWidth: hscale(795)
+    readonly property int telemetryChartWidth: hscale(900)
+    readonly property int telemetryChartHeight: vscale(160)
     readonly property int tabBarWidth: hscale(260)
     readonly property int tabBarHeight: vscale(60)
     readonly property int buttonWidth: inPortrait ? hscale(180) : hscale(230)
@@ -111,7 +113,7 @@ QtObject {
     readonly property int pageWidth: inPortrait ? screenWidth : screenWidth - leftSideBarWidth
     readonly property int pageHeight: screenHeight
     readonly property int popupWidth: pageWidth * 0.8
-    readonly property int sideBarButtonCount: 14
+    readonly property int sideBarButtonCount: 15
 
     property DirectoryFontLoader directoryFontLoader: DirectoryFontLoader {
         id: directoryFontLoader
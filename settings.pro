@@ -9,13 +9,20 @@ win32 {
 
 configSettings {
 
-QT += core gui widgets quick qml xml
+QT += core gui widgets quick qml xml dbus
 CONFIG += c++17
 TEMPLATE = app
 TARGET = settings
 
 unix {
     LIBS += -lpam
+    # screenshot archive compression, gzip by default, CONFIG+=screenshot_zstd for zstd
+    screenshot_zstd {
+        DEFINES += SCREENSHOT_ARCHIVE_ZSTD
+        LIBS += -lzstd
+    } else {
+        LIBS += -lz
+    }
 }
 
 # output directory
@@ -56,11 +63,34 @@ HEADERS += src/include/qmlwindow.h \
     src/include/storage_utility.h \
     src/include/time_utility.h \
     src/include/update_utility.h \
-    src/include/polling_thread.h \
+    src/include/job_scheduler.h \
+    src/include/uevent_monitor.h \
+    src/include/storage_benchmark_utility.h \
+    src/include/storage_telemetry.h \
+    src/include/ini_document.h \
+    src/include/brightness_controller.h \
+    src/include/screenshot_utility.h \
+    src/include/screenshot_thumbnailer.h \
+    src/include/screenshot_gallery_model.h \
+    src/include/boot_logo_utility.h \
+    src/include/time_dbus_utility.h \
+    src/include/timezone_index.h \
+    src/include/timezone_list_model.h \
+    src/include/timezone_search_index.h \
+    src/include/time_sync_monitor.h \
+    src/include/service_manager.h \
+    src/include/process_utility.h \
+    src/include/serial_utility.h \
+    src/include/usb_policy.h \
+    src/include/reboot_schedule.h \
+    src/include/boot_environment.h \
+    src/include/startup_launcher.h \
+    src/include/startup_supervisor.h \
     src/include/utility.h \
     src/include/pam_utility.h \
     src/include/log_utility.h \
     src/include/network_utility.h \
+    src/include/network_diagnostics_utility.h \
     src/include/screen_utility.h \
     src/include/ftp_utility.h \
     src/include/restore_utility.h \
@@ -74,11 +104,34 @@ SOURCES += src/main.cpp src/qmlwindow.cpp \
     src/storage_utility.cpp \
     src/time_utility.cpp \
     src/update_utility.cpp \
-    src/polling_thread.cpp \
+    src/job_scheduler.cpp \
+    src/uevent_monitor.cpp \
+    src/storage_benchmark_utility.cpp \
+    src/storage_telemetry.cpp \
+    src/ini_document.cpp \
+    src/brightness_controller.cpp \
+    src/screenshot_utility.cpp \
+    src/screenshot_thumbnailer.cpp \
+    src/screenshot_gallery_model.cpp \
+    src/boot_logo_utility.cpp \
+    src/time_dbus_utility.cpp \
+    src/timezone_index.cpp \
+    src/timezone_list_model.cpp \
+    src/timezone_search_index.cpp \
+    src/time_sync_monitor.cpp \
+    src/service_manager.cpp \
+    src/process_utility.cpp \
+    src/serial_utility.cpp \
+    src/usb_policy.cpp \
+    src/reboot_schedule.cpp \
+    src/boot_environment.cpp \
+    src/startup_launcher.cpp \
+    src/startup_supervisor.cpp \
     src/utility.cpp \
     src/pam_utility.cpp \
     src/log_utility.cpp \
     src/network_utility.cpp \
+    src/network_diagnostics_utility.cpp \
     src/screen_utility.cpp \
     src/ftp_utility.cpp \
     src/restore_utility.cpp \
@@ -2,14 +2,17 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <cstdio>
+#include <cstdlib>
 #include <string>
 #include <array>
+#include <csignal>
 #include <QDebug>
 
 #include "./include/utility.h"
 #include "./include/app_utility.h"
 #include "./include/config_utility.h"
-#include "./include/polling_thread.h"
+#include "./include/job_scheduler.h"
+#include "./include/process_utility.h"
 
 // ex: java -jar /usr/java/vncviewer/tightvnc-jviewer.jar
 /*
@@ -51,27 +54,67 @@ Options format: -optionName=optionValue. Ex. -host=localhost -port=5900 -viewonl
 Both option name and option value are case insensitive.
 */
 const char* START_TIGHTVNC_CMD = "LD_PRELOAD=/usr/local/lib/injectpassword.so java -jar /usr/java/vncviewer/tightvnc-jviewer.jar";
-const char* STOP_TIGHTVNC_CMD = "ps ax | grep 'tightvnc-jviewer.jar' | awk -F ' ' '{print $1}' | head -n -1 | xargs -r kill";
+const char* TIGHTVNC_CMDLINE = "tightvnc-jviewer.jar";
 const char* TMP_FILE = "/tmp/.tmpconfig";
 
-TightVNCUtility::TightVNCUtility() {
+TightVNCUtility::TightVNCUtility(IProcessUtility *processUtil) {
     m_is_server_online = false;
     m_is_started = false;
     m_unavailable_count = 0;
-    m_pollingThread = nullptr;
+    m_isProcessUtilOwned = (processUtil == nullptr);
+    m_processUtil = processUtil ? processUtil : new TPCProcessUtility();
 }
 
 TightVNCUtility::~TightVNCUtility() {
-    if (m_pollingThread) 
-        delete m_pollingThread;
+    stop_monitoring();
+    if (m_isProcessUtilOwned)
+        delete m_processUtil;
 }
 
-void TightVNCUtility::start_monitoring() {
-    if (!m_pollingThread) 
-        m_pollingThread = new PollingThread(this);
-    // start polling thread
-    m_pollingThread->start();
-    m_pollingThread->wait();
+void TightVNCUtility::start_monitoring(JobScheduler *scheduler) {
+    // check input
+    if (!scheduler) {
+        qDebug("missing parameter");
+        return;
+    }
+    if (m_pollingToken)
+        return;
+    m_pollingToken = make_shared<JobToken>();
+    auto pPollingFunction = std::bind(&TightVNCUtility::_poll_vnc_server, this, m_pollingToken);
+    scheduler->start(new Job(pPollingFunction, JobPriority::BACKGROUND, m_pollingToken));
+}
+
+void TightVNCUtility::stop_monitoring() {
+    if (!m_pollingToken)
+        return;
+    // the job uses this object until it returns
+    m_pollingToken->cancel();
+    m_pollingToken->wait_finished();
+    m_pollingToken = nullptr;
+}
+
+bool TightVNCUtility::_poll_vnc_server(shared_ptr<JobToken> token) {
+    ConfigUtility configUtil;
+    bool isSuccess = true;
+    bool isServerOnline;
+    string address = configUtil.get_vnc_server_address();
+    string port = configUtil.get_vnc_server_port();
+    int pollingPeriod = configUtil.get_vnc_server_polling_period();
+    // polling until cancelled
+    while (address.length() > 0 && port.length() > 0) {
+        // check connection established
+        isServerOnline = is_server_available(address.c_str(), port.c_str());
+        if (isServerOnline) {
+            qDebug("%s:%s vnc server is available!", address.c_str(), port.c_str());
+        } else {
+            qDebug("%s:%s vnc server is not available!", address.c_str(), port.c_str());
+        }
+        this->pollingVNCServerIsReady(isSuccess, isServerOnline);
+        // sleep polling period 30 seconds
+        if (!token->wait_for(pollingPeriod * 1000))
+            break;
+    }
+    return isSuccess;
 }
 
 bool TightVNCUtility::is_configuration_ready() {
@@ -153,7 +196,10 @@ pair<string, int> TightVNCUtility::start() {
 
 pair<string, int> TightVNCUtility::stop() {
     qDebug("Stop tightVNC viewer!");
-    return execute_cmd(STOP_TIGHTVNC_CMD);
+    const auto snapshot = m_processUtil->get_snapshot();
+    size_t count = m_processUtil->signal_processes(snapshot->find_by_cmdline(TIGHTVNC_CMDLINE), SIGTERM);
+    qDebug("%zu viewer stopped", count);
+    return make_pair(string(), EXIT_SUCCESS);
 }
 
 void TightVNCUtility::pollingVNCServerIsReady(bool isSuccess, bool isServerOnline) {
@@ -0,0 +1,167 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <QDebug>
+
+#include "./include/boot_environment.h"
+#include "./include/utility.h"
+
+#define DEV_FOLDER_PREFIX           "/dev/"
+// mount id, parent id, major:minor, root, mount point, options, optional fields, -, fstype, source, super options
+#define MOUNTINFO_MOUNT_POINT_INDEX 4
+#define MOUNTINFO_OPTIONS_INDEX     5
+#define MOUNT_OPTION_READ_ONLY      "ro"
+#define READONLY_PENDING_ON         "1"
+#define READONLY_PENDING_OFF        "0"
+
+pair<string, bool> get_cmdline_value(const string& cmdline, const char* key)
+{
+    pair<string, bool> result = make_pair(string(), false);
+    // check input
+    if (!key) {
+        qDebug("missing parameter");
+        return result;
+    }
+    const string prefix = string(key) + "=";
+    stringstream stream(cmdline);
+    string word;
+    while (stream >> word)
+    {
+        if (word.rfind(prefix, 0) == 0)
+            result = make_pair(word.substr(prefix.size()), true);
+    }
+    return result;
+}
+
+BootEnvironmentProbe::BootEnvironmentProbe(const char* cmdlineFile, const char* mountInfoFile,
+                                           const char* readonlyPendingFile)
+{
+    m_cmdlineFile = cmdlineFile ? cmdlineFile : PROC_CMDLINE_FILE;
+    m_mountInfoFile = mountInfoFile ? mountInfoFile : PROC_SELF_MOUNTINFO_FILE;
+    m_readonlyPendingFile = readonlyPendingFile ? readonlyPendingFile : READONLY_PENDING_FILE;
+    m_isLoaded = false;
+}
+
+pair<BootEnvironment, bool> BootEnvironmentProbe::get()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_isLoaded) {
+        BootEnvironment environment;
+        bool result = _load(environment);
+        m_environment = make_pair(environment, result);
+        m_isLoaded = true;
+    }
+    return m_environment;
+}
+
+void BootEnvironmentProbe::invalidate()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_isLoaded = false;
+}
+
+bool BootEnvironmentProbe::is_root_on_disk(const char* diskName)
+{
+    // check input
+    if (!diskName) {
+        qDebug("missing parameter");
+        return false;
+    }
+    const auto ret = get();
+    const string &device = ret.first.rootDevice;
+    size_t length = strlen(diskName);
+    if (length == 0 || device.compare(0, length, diskName) != 0)
+        return false;
+    if (device.size() == length)
+        return true;
+    // partitions of disks ending in a digit are named <disk>p<n> like mmcblk1p2, others <disk><n> like sda1
+    if (isdigit((unsigned char)diskName[length - 1])) {
+        if (device[length] != 'p')
+            return false;
+        length++;
+    }
+    return device.size() > length && isdigit((unsigned char)device[length]);
+}
+
+pair<bool, bool> BootEnvironmentProbe::get_pending_readonly_mode()
+{
+    // a missing file means nothing was set since the boot
+    ifstream file(m_readonlyPendingFile);
+    string value;
+    if (!file.good() || !getline(file, value))
+        return make_pair(false, false);
+    if (value.compare(READONLY_PENDING_ON) == 0)
+        return make_pair(true, true);
+    if (value.compare(READONLY_PENDING_OFF) == 0)
+        return make_pair(false, true);
+    qDebug("unknown value %s in %s", value.c_str(), m_readonlyPendingFile.c_str());
+    return make_pair(false, false);
+}
+
+bool BootEnvironmentProbe::set_pending_readonly_mode(bool readonly)
+{
+    const char *value = readonly ? READONLY_PENDING_ON "\n" : READONLY_PENDING_OFF "\n";
+    if (!write_file_atomic(m_readonlyPendingFile.c_str(), value)) {
+        qDebug("write %s failed", m_readonlyPendingFile.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool BootEnvironmentProbe::_load(BootEnvironment &environment)
+{
+    environment.isRootOverlay = false;
+    environment.isRootReadOnly = false;
+
+    ifstream cmdlineFile(m_cmdlineFile);
+    if (!cmdlineFile.good()) {
+        qDebug("open %s failed", m_cmdlineFile.c_str());
+        return false;
+    }
+    string cmdline;
+    getline(cmdlineFile, cmdline);
+    const auto root = get_cmdline_value(cmdline, CMDLINE_KEY_ROOT);
+    environment.rootDevice = root.first;
+    if (environment.rootDevice.rfind(DEV_FOLDER_PREFIX, 0) == 0)
+        environment.rootDevice = environment.rootDevice.substr(strlen(DEV_FOLDER_PREFIX));
+
+    ifstream mountInfoFile(m_mountInfoFile);
+    if (!mountInfoFile.good()) {
+        qDebug("open %s failed", m_mountInfoFile.c_str());
+        return false;
+    }
+    bool isRootFound = false;
+    string line;
+    while (getline(mountInfoFile, line))
+    {
+        istringstream stream(line);
+        vector<string> fields;
+        string field, fstype, source;
+        while (stream >> field)
+        {
+            if (field.compare("-") == 0) {
+                stream >> fstype >> source;
+                break;
+            }
+            fields.push_back(field);
+        }
+        if ((int)fields.size() <= MOUNTINFO_OPTIONS_INDEX || fields[MOUNTINFO_MOUNT_POINT_INDEX].compare("/") != 0)
+            continue;
+        // later mounts on / cover earlier ones, the last one is what is seen
+        const string &options = fields[MOUNTINFO_OPTIONS_INDEX];
+        environment.rootFsType = fstype;
+        environment.rootSource = source;
+        environment.isRootOverlay = (fstype.compare(ROOT_FSTYPE_OVERLAY) == 0);
+        environment.isRootReadOnly = (options.compare(MOUNT_OPTION_READ_ONLY) == 0 ||
+                                      options.rfind(MOUNT_OPTION_READ_ONLY ",", 0) == 0);
+        isRootFound = true;
+    }
+    if (!isRootFound)
+        qDebug("no / in %s", m_mountInfoFile.c_str());
+    return isRootFound;
+}
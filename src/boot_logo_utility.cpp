@@ -0,0 +1,469 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include <QImage>
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/boot_logo_utility.h"
+
+#define BOOT_LOGO_BYTES_PER_PIXEL   4
+#define BOOT_LOGO_DEFAULT_COLOR     0x000000
+#define BMP_FILE_HEADER_SIZE        14
+#define BMP_INFO_HEADER_SIZE        40
+// 300 dpi, only informative
+#define BMP_PIXELS_PER_METER        11811
+
+BootLogoImage::BootLogoImage()
+{
+    m_width = 0;
+    m_height = 0;
+}
+
+BootLogoImage::BootLogoImage(int width, int height)
+    : m_pixels((size_t)max(width, 0) * max(height, 0) * BOOT_LOGO_BYTES_PER_PIXEL)
+{
+    m_width = max(width, 0);
+    m_height = max(height, 0);
+}
+
+int BootLogoImage::getWidth() const
+{
+    return m_width;
+}
+
+int BootLogoImage::getHeight() const
+{
+    return m_height;
+}
+
+int BootLogoImage::getStride() const
+{
+    return m_width * BOOT_LOGO_BYTES_PER_PIXEL;
+}
+
+unsigned char* BootLogoImage::getPixels()
+{
+    return m_pixels.data();
+}
+
+const unsigned char* BootLogoImage::getPixels() const
+{
+    return m_pixels.data();
+}
+
+// source span and coverage of every target pixel along one axis
+static void get_area_weights(int sourceLength, int targetLength, vector<int> &firsts,
+                             vector<int> &counts, vector<float> &weights)
+{
+    double scale = (double)sourceLength / targetLength;
+    firsts.resize(targetLength);
+    counts.resize(targetLength);
+    weights.clear();
+    for (int i = 0; i < targetLength; i++)
+    {
+        double start = i * scale;
+        double end = min((i + 1) * scale, (double)sourceLength);
+        int first = (int)floor(start);
+        int last = min((int)ceil(end), sourceLength);
+        firsts[i] = first;
+        counts[i] = last - first;
+        for (int j = first; j < last; j++)
+        {
+            double covered = min(end, (double)(j + 1)) - max(start, (double)j);
+            weights.push_back((float)(covered / scale));
+        }
+    }
+}
+
+// adds one weighted source row into the float row sums
+static void accumulate_row(float *sums, const unsigned char *row, float weight, int count)
+{
+    int i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16_t pixels = vld1q_u8(row + i);
+        uint16x8_t low = vmovl_u8(vget_low_u8(pixels));
+        uint16x8_t high = vmovl_u8(vget_high_u8(pixels));
+        vst1q_f32(sums + i, vmlaq_n_f32(vld1q_f32(sums + i), vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))), weight));
+        vst1q_f32(sums + i + 4, vmlaq_n_f32(vld1q_f32(sums + i + 4), vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))), weight));
+        vst1q_f32(sums + i + 8, vmlaq_n_f32(vld1q_f32(sums + i + 8), vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))), weight));
+        vst1q_f32(sums + i + 12, vmlaq_n_f32(vld1q_f32(sums + i + 12), vcvtq_f32_u32(vmovl_u16(vget_high_u16(high))), weight));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 factor = _mm_set1_ps(weight);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i low = _mm_unpacklo_epi8(pixels, zero);
+        __m128i high = _mm_unpackhi_epi8(pixels, zero);
+        __m128 values[4] = {
+            _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)),
+            _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)),
+            _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)),
+            _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero))
+        };
+        for (int j = 0; j < 4; j++)
+        {
+            _mm_storeu_ps(sums + i + j * 4, _mm_add_ps(_mm_loadu_ps(sums + i + j * 4), _mm_mul_ps(values[j], factor)));
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        sums[i] += row[i] * weight;
+    }
+}
+
+bool resample_area(const BootLogoImage &source, BootLogoImage &target)
+{
+    int sourceWidth = source.getWidth();
+    int sourceHeight = source.getHeight();
+    int width = target.getWidth();
+    int height = target.getHeight();
+    // check input
+    if (width <= 0 || height <= 0 || width > sourceWidth || height > sourceHeight) {
+        qDebug("invalid parameter");
+        return false;
+    }
+    vector<int> rowFirsts, rowCounts, columnFirsts, columnCounts;
+    vector<float> rowWeights, columnWeights;
+    get_area_weights(sourceHeight, height, rowFirsts, rowCounts, rowWeights);
+    get_area_weights(sourceWidth, width, columnFirsts, columnCounts, columnWeights);
+    // vertical pass runs over whole source rows with simd, horizontal pass over one summed row
+    int count = sourceWidth * BOOT_LOGO_BYTES_PER_PIXEL;
+    vector<float> sums(count);
+    const float *rowWeight = rowWeights.data();
+    for (int y = 0; y < height; y++)
+    {
+        fill(sums.begin(), sums.end(), 0.0f);
+        for (int i = 0; i < rowCounts[y]; i++)
+        {
+            accumulate_row(sums.data(), source.getPixels() + (size_t)(rowFirsts[y] + i) * source.getStride(),
+                           *rowWeight++, count);
+        }
+        unsigned char *pixel = target.getPixels() + (size_t)y * target.getStride();
+        const float *columnWeight = columnWeights.data();
+        for (int x = 0; x < width; x++)
+        {
+            float total[BOOT_LOGO_BYTES_PER_PIXEL] = {0};
+            const float *column = sums.data() + (size_t)columnFirsts[x] * BOOT_LOGO_BYTES_PER_PIXEL;
+            for (int i = 0; i < columnCounts[x]; i++)
+            {
+                for (int channel = 0; channel < BOOT_LOGO_BYTES_PER_PIXEL; channel++)
+                {
+                    total[channel] += column[channel] * *columnWeight;
+                }
+                column += BOOT_LOGO_BYTES_PER_PIXEL;
+                columnWeight++;
+            }
+            for (int channel = 0; channel < BOOT_LOGO_BYTES_PER_PIXEL; channel++)
+            {
+                *pixel++ = (unsigned char)min(max(total[channel] + 0.5f, 0.0f), 255.0f);
+            }
+        }
+    }
+    return true;
+}
+
+bool fit_on_canvas(const BootLogoImage &source, unsigned int color, int width, int height, BootLogoImage &canvas)
+{
+    // check input
+    if (source.getWidth() <= 0 || source.getHeight() <= 0 || width <= 0 || height <= 0) {
+        qDebug("invalid parameter");
+        return false;
+    }
+    unsigned char background[BOOT_LOGO_BYTES_PER_PIXEL] = {
+        (unsigned char)(color & 0xff), (unsigned char)((color >> 8) & 0xff), (unsigned char)((color >> 16) & 0xff), 0xff
+    };
+    // psplash has no alpha, blend over background color first
+    BootLogoImage opaque(source.getWidth(), source.getHeight());
+    const unsigned char *from = source.getPixels();
+    unsigned char *to = opaque.getPixels();
+    for (int i = 0; i < source.getWidth() * source.getHeight(); i++)
+    {
+        unsigned int alpha = from[3];
+        for (int channel = 0; channel < 3; channel++)
+        {
+            to[channel] = (unsigned char)((from[channel] * alpha + background[channel] * (255 - alpha) + 127) / 255);
+        }
+        to[3] = 0xff;
+        from += BOOT_LOGO_BYTES_PER_PIXEL;
+        to += BOOT_LOGO_BYTES_PER_PIXEL;
+    }
+    // smaller logo keeps its size, psplash shows it centered anyway
+    double scale = max((double)source.getWidth() / width, (double)source.getHeight() / height);
+    BootLogoImage logo;
+    if (scale > 1)
+    {
+        logo = BootLogoImage(max(1, min(width, (int)lround(source.getWidth() / scale))),
+                             max(1, min(height, (int)lround(source.getHeight() / scale))));
+        if (!resample_area(opaque, logo))
+            return false;
+    }
+    else
+    {
+        logo = opaque;
+    }
+    canvas = BootLogoImage(width, height);
+    unsigned char *pixel = canvas.getPixels();
+    for (int i = 0; i < width * height; i++)
+    {
+        memcpy(pixel, background, BOOT_LOGO_BYTES_PER_PIXEL);
+        pixel += BOOT_LOGO_BYTES_PER_PIXEL;
+    }
+    int left = (width - logo.getWidth()) / 2;
+    int top = (height - logo.getHeight()) / 2;
+    for (int y = 0; y < logo.getHeight(); y++)
+    {
+        memcpy(canvas.getPixels() + (size_t)(top + y) * canvas.getStride() + (size_t)left * BOOT_LOGO_BYTES_PER_PIXEL,
+               logo.getPixels() + (size_t)y * logo.getStride(), logo.getStride());
+    }
+    return true;
+}
+
+void quantize_rgb565(BootLogoImage &image)
+{
+    // 4x4 bayer thresholds scaled to 0-255
+    static const unsigned int BAYER[4][4] = {
+        {   8, 136,  40, 168 },
+        { 200,  72, 232, 104 },
+        {  56, 184,  24, 152 },
+        { 248, 120, 216,  88 }
+    };
+    // b, g, r levels, alpha untouched
+    static const unsigned int LEVELS[3] = { 31, 63, 31 };
+    for (int y = 0; y < image.getHeight(); y++)
+    {
+        unsigned char *pixel = image.getPixels() + (size_t)y * image.getStride();
+        for (int x = 0; x < image.getWidth(); x++)
+        {
+            unsigned int threshold = BAYER[y & 3][x & 3];
+            for (int channel = 0; channel < 3; channel++)
+            {
+                unsigned int level = (pixel[channel] * LEVELS[channel] + threshold) / 255;
+                pixel[channel] = (unsigned char)((level * 255 + LEVELS[channel] / 2) / LEVELS[channel]);
+            }
+            pixel += BOOT_LOGO_BYTES_PER_PIXEL;
+        }
+    }
+}
+
+static void put_le16(string &buffer, unsigned int value)
+{
+    buffer.push_back((char)(value & 0xff));
+    buffer.push_back((char)((value >> 8) & 0xff));
+}
+
+static void put_le32(string &buffer, unsigned int value)
+{
+    put_le16(buffer, value & 0xffff);
+    put_le16(buffer, (value >> 16) & 0xffff);
+}
+
+string encode_bmp24(const BootLogoImage &image)
+{
+    unsigned int rowSize = (image.getWidth() * 3 + 3) & ~3u;
+    unsigned int imageSize = rowSize * image.getHeight();
+    string buffer;
+    buffer.reserve(BMP_FILE_HEADER_SIZE + BMP_INFO_HEADER_SIZE + imageSize);
+    // file header
+    buffer.append("BM");
+    put_le32(buffer, BMP_FILE_HEADER_SIZE + BMP_INFO_HEADER_SIZE + imageSize);
+    put_le32(buffer, 0);
+    put_le32(buffer, BMP_FILE_HEADER_SIZE + BMP_INFO_HEADER_SIZE);
+    // info header, BI_RGB
+    put_le32(buffer, BMP_INFO_HEADER_SIZE);
+    put_le32(buffer, image.getWidth());
+    put_le32(buffer, image.getHeight());
+    put_le16(buffer, 1);
+    put_le16(buffer, 24);
+    put_le32(buffer, 0);
+    put_le32(buffer, imageSize);
+    put_le32(buffer, BMP_PIXELS_PER_METER);
+    put_le32(buffer, BMP_PIXELS_PER_METER);
+    put_le32(buffer, 0);
+    put_le32(buffer, 0);
+    // bottom-up rows of b, g, r
+    for (int y = image.getHeight() - 1; y >= 0; y--)
+    {
+        const unsigned char *pixel = image.getPixels() + (size_t)y * image.getStride();
+        size_t rowStart = buffer.size();
+        for (int x = 0; x < image.getWidth(); x++)
+        {
+            buffer.append((const char *)pixel, 3);
+            pixel += BOOT_LOGO_BYTES_PER_PIXEL;
+        }
+        buffer.append(rowSize - (buffer.size() - rowStart), '\0');
+    }
+    return buffer;
+}
+
+TPCBootLogoUtility::TPCBootLogoUtility(const char* logoPath, const char* psplashConfigFile, const char* framebufferFolder)
+{
+    m_logoPath = logoPath ? logoPath : BOOT_LOGO_PATH;
+    m_psplashConfigFile = psplashConfigFile ? psplashConfigFile : PSPLASH_CONFIG_FILE;
+    m_framebufferFolder = framebufferFolder ? framebufferFolder : FRAMEBUFFER_SYSFS_FOLDER;
+}
+
+bool TPCBootLogoUtility::get_framebuffer_info(int &width, int &height, int &bitsPerPixel)
+{
+    // ex: modes "U:1280x800p-60", virtual_size may be doubled for panning so prefer the mode
+    ifstream modesFile(m_framebufferFolder + "/modes");
+    string mode;
+    bool isFound = false;
+    if (modesFile.good() && getline(modesFile, mode))
+    {
+        size_t pos = mode.find(':');
+        isFound = (sscanf(mode.c_str() + (pos == string::npos ? 0 : pos + 1), "%dx%d", &width, &height) == 2);
+    }
+    if (!isFound)
+    {
+        // ex: virtual_size "1280,800"
+        ifstream sizeFile(m_framebufferFolder + "/virtual_size");
+        string size;
+        isFound = sizeFile.good() && getline(sizeFile, size) &&
+            sscanf(size.c_str(), "%d,%d", &width, &height) == 2;
+    }
+    if (!isFound || width <= 0 || height <= 0) {
+        qDebug("Cannot get framebuffer resolution::%s", m_framebufferFolder.c_str());
+        return false;
+    }
+    ifstream bppFile(m_framebufferFolder + "/bits_per_pixel");
+    if (!(bppFile >> bitsPerPixel))
+        bitsPerPixel = 0;
+    return true;
+}
+
+pair<string, bool> TPCBootLogoUtility::get_background_color()
+{
+    ifstream file(m_psplashConfigFile);
+    if (!file.good()) {
+        qDebug("Cannot open file for reading::%s", m_psplashConfigFile.c_str());
+        return make_pair(string(), false);
+    }
+    string prefix = string(PSPLASH_BG_COLOR_KEY) + "=";
+    string line;
+    while (getline(file, line))
+    {
+        if (line.rfind(prefix, 0) == 0)
+        {
+            string value = line.substr(prefix.length());
+            value.erase(value.find_last_not_of(" \t\r") + 1);
+            return make_pair(value, true);
+        }
+    }
+    return make_pair(string(), false);
+}
+
+pair<string, bool> TPCBootLogoUtility::apply_boot_logo(const char* imagePath, const char* color)
+{
+    // check input
+    if (!imagePath) {
+        qDebug("missing parameter");
+        return make_pair("Boot logo path is empty, please select boot logo file path.", false);
+    }
+    bool isColorChanged = (color && strlen(color) > 0);
+    string colorText = isColorChanged ? color : get_background_color().first;
+    unsigned int colorValue = BOOT_LOGO_DEFAULT_COLOR;
+    if (!_parse_color(colorText, colorValue))
+    {
+        if (isColorChanged)
+            return make_pair("Background color format is incorrect.", false);
+        qDebug("Use default background color, configured one is invalid::%s", colorText.c_str());
+    }
+
+    BootLogoImage source;
+    if (!_decode_image(imagePath, source))
+        return make_pair("Boot logo file cannot be read, please select a BMP or PNG image.", false);
+    int width = source.getWidth();
+    int height = source.getHeight();
+    int bitsPerPixel = 0;
+    if (!get_framebuffer_info(width, height, bitsPerPixel)) {
+        // keep image size, still converted to a plain 24 bit bmp
+        width = source.getWidth();
+        height = source.getHeight();
+    }
+    BootLogoImage canvas;
+    if (!fit_on_canvas(source, colorValue, width, height, canvas))
+        return make_pair("Boot logo cannot be converted.", false);
+    if (bitsPerPixel == FRAMEBUFFER_RGB565_BPP)
+        quantize_rgb565(canvas);
+
+    // logo first, a failure in between leaves the new logo on the old color, never a half written file
+    string logo = encode_bmp24(canvas);
+    if (!write_file_atomic(m_logoPath.c_str(), logo.data(), logo.size())) {
+        qDebug("Cannot write boot logo::%s", m_logoPath.c_str());
+        return make_pair("Boot logo cannot be written.", false);
+    }
+    if (isColorChanged)
+    {
+        string content;
+        ifstream file(m_psplashConfigFile, ios::in | ios::binary);
+        if (file.good()) {
+            stringstream stream;
+            stream << file.rdbuf();
+            content = stream.str();
+        }
+        string line = string(PSPLASH_BG_COLOR_KEY) + "=" + colorText;
+        string prefix = string(PSPLASH_BG_COLOR_KEY) + "=";
+        size_t start = (content.compare(0, prefix.length(), prefix) == 0) ? 0 : content.find("\n" + prefix);
+        if (start == string::npos) {
+            if (!content.empty() && content.back() != '\n')
+                content.append("\n");
+            content.append(line + "\n");
+        } else {
+            if (start > 0)
+                start++;
+            size_t end = content.find('\n', start);
+            content.replace(start, (end == string::npos ? content.length() : end) - start, line);
+        }
+        if (!write_file_atomic(m_psplashConfigFile.c_str(), content.c_str())) {
+            qDebug("Cannot write background color::%s", m_psplashConfigFile.c_str());
+            return make_pair("Background color cannot be written.", false);
+        }
+    }
+    return make_pair("", true);
+}
+
+bool TPCBootLogoUtility::_decode_image(const char* imagePath, BootLogoImage &image)
+{
+    QImage source(QString::fromLocal8Bit(imagePath));
+    if (source.isNull()) {
+        qDebug("Cannot decode image::%s", imagePath);
+        return false;
+    }
+    if (source.format() != QImage::Format_ARGB32)
+        source = source.convertToFormat(QImage::Format_ARGB32);
+    image = BootLogoImage(source.width(), source.height());
+    for (int y = 0; y < source.height(); y++)
+    {
+        memcpy(image.getPixels() + (size_t)y * image.getStride(), source.constScanLine(y), image.getStride());
+    }
+    return true;
+}
+
+bool TPCBootLogoUtility::_parse_color(const string& color, unsigned int &value)
+{
+    // ex: 0xffffff
+    if (color.length() != 8 || color.rfind("0x", 0) != 0 ||
+        color.find_first_not_of("0123456789abcdefABCDEF", 2) != string::npos)
+        return false;
+    value = (unsigned int)strtoul(color.c_str() + 2, nullptr, 16);
+    return true;
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QTimer>
+#include <QDebug>
+
+#include "./include/screen_utility.h"
+#include "./include/brightness_controller.h"
+
+BrightnessController::BrightnessController(IScreenUtility *screenUtil, qreal refreshRate, QObject *parent)
+    : QObject(parent)
+{
+    this->m_screenUtil = screenUtil;
+    this->m_pendingBrightness = -1;
+    this->m_writtenBrightness = -1;
+    this->m_isPersistPending = false;
+    if (refreshRate <= 0)
+        refreshRate = BRIGHTNESS_DEFAULT_REFRESH_RATE;
+    int frameInterval = qMax(1, qRound(1000 / refreshRate));
+    this->m_frameTimer = new QTimer(this);
+    this->m_frameTimer->setInterval(frameInterval);
+    QObject::connect(this->m_frameTimer, SIGNAL(timeout()),
+                     this, SLOT(frameTimeout()));
+    this->m_settleTimer = new QTimer(this);
+    this->m_settleTimer->setSingleShot(true);
+    this->m_settleTimer->setInterval(BRIGHTNESS_SETTLE_MS);
+    QObject::connect(this->m_settleTimer, SIGNAL(timeout()),
+                     this, SLOT(settleTimeout()));
+}
+
+BrightnessController::~BrightnessController()
+{
+    this->m_frameTimer->stop();
+    this->m_settleTimer->stop();
+}
+
+void BrightnessController::requestBrightness(int brightness)
+{
+    this->m_pendingBrightness = brightness;
+    this->m_isPersistPending = true;
+    // first change of a drag is written at once, the rest once per frame
+    if (!this->m_frameTimer->isActive()) {
+        this->_write_pending();
+        this->m_frameTimer->start();
+    }
+    this->m_settleTimer->start();
+}
+
+void BrightnessController::flush()
+{
+    this->m_frameTimer->stop();
+    this->m_settleTimer->stop();
+    if (this->m_pendingBrightness != this->m_writtenBrightness)
+        this->_write_pending();
+    if (!this->m_isPersistPending)
+        return;
+    this->m_isPersistPending = false;
+    this->m_screenUtil->save_brightness();
+    emit brightnessSettled(this->m_writtenBrightness);
+}
+
+void BrightnessController::frameTimeout()
+{
+    // stop ticking when slider did not move during the last frame
+    if (this->m_pendingBrightness == this->m_writtenBrightness) {
+        this->m_frameTimer->stop();
+        return;
+    }
+    this->_write_pending();
+}
+
+void BrightnessController::settleTimeout()
+{
+    this->flush();
+}
+
+void BrightnessController::_write_pending()
+{
+    if (!this->m_screenUtil->set_brightness(this->m_pendingBrightness)) {
+        qDebug("set brightness failed:%d", this->m_pendingBrightness);
+    }
+    // not retried on failure, next slider change writes again
+    this->m_writtenBrightness = this->m_pendingBrightness;
+}
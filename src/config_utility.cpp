@@ -80,8 +80,14 @@ const char* KEY_RS_CRON_MODE =      "rs_cron_mode";
 const char* KEY_RS_CRON_MINUTE =    "rs_cron_minute";
 const char* KEY_RS_CRON_HOUR =      "rs_cron_hour";
 const char* KEY_RS_CRON_DAYOFWEEK = "rs_cron_dayofweek";
+// ex: rs_cron_windows=6 04:30, rs_cron_blackouts=08:00-18:00, 0 22:00-02:00
+const char* KEY_RS_CRON_WINDOWS =   "rs_cron_windows";
+const char* KEY_RS_CRON_BLACKOUTS = "rs_cron_blackouts";
 const char* KEY_ETHERNET_ENABLE =   "ethernet_enable";
 const char* KEY_USB_ENABLE =        "usb_enable";
+// ex: usb_blocked_classes=08 e0, usb_blocked_ports=1-1.2
+const char* KEY_USB_BLOCKED_CLASSES = "usb_blocked_classes";
+const char* KEY_USB_BLOCKED_PORTS = "usb_blocked_ports";
 const char* KEY_CHROMIUM_USE_SYS_VIRTUAL_KEYBOARD = "chromium_use_sys_vkb";
 const char* KEY_CHROMIUM_USE_CUSTOM_VIRTUAL_KEYBOARD = "chromium_use_custom_vkb";
 const char* KEY_COM_IS_SHOWED_FOR_USER = "com_is_showed_for_user";
@@ -165,6 +171,8 @@ const char* KEY_REBOOT_IS_SHOWED_FOR_USER = "reboot_is_showed_for_user";
 const char* KEY_SHUTDOWN_IS_SHOWED_FOR_USER = "shutdown_is_showed_for_user";
 const char* KEY_OPEN_TERMIANL_IS_SHOWED_FOR_USER = "open_terminal_is_showed_for_user";
 const char* KEY_FACTORY_RESET_IS_SHOWED_FOR_USER = "factory_reset_is_showed_for_user";
+// diagnostics related
+const char* CONF_SECTION_DIAGNOSTICS = "diagnostics";
 // about related
 const char* CONF_SECTION_ABOUT =   "about";
 // exit related
@@ -479,21 +487,7 @@ void ConfigUtility::set_startup(const char* name) {
         qDebug("missing parameter");
         return;
     }
-    StartupApplication* app;
-    if (strcmp(name, STARTUP_NAME_SETTINGS) == 0)
-        app = new StartupSettings();
-    else if (strcmp(name, STARTUP_NAME_CHROMIUM) == 0)
-        app = new StartupChromium();
-    else if (strcmp(name, STARTUP_NAME_CHROMIUM_KIOSK) == 0)
-        app = new StartupKioskChromium();
-    else if (strcmp(name, STARTUP_NAME_STATIC_PAGE) == 0)
-        app = new StartupStaticPage();
-    else if (strcmp(name, STARTUP_NAME_STATIC_PAGE_CUSTOM) == 0)
-        app = new StartupStaticPageCustom();
-    else if (strcmp(name, STARTUP_NAME_VNC_VIEWER) == 0)
-        app = new StartupVNC();
-    else
-        app = new StartupNone();
+    StartupApplication* app = create_startup_application(name);
     _set_config_value_string(CONF_SECTION_STARTUP, KEY_STARTUP_NAME, app->get_startup_name().c_str());
     _set_config_value_string(CONF_SECTION_STARTUP, KEY_STARTUP_COMMAND, app->get_startup_command().c_str());
     delete app;
@@ -591,6 +585,14 @@ int ConfigUtility::get_reboot_system_crontab_dayofweek() {
     return _get_config_value(CONF_SECTION_SYSTEM, KEY_RS_CRON_DAYOFWEEK).toInt();
 }
 
+string ConfigUtility::get_reboot_system_crontab_windows() {
+    return _get_config_value_string(CONF_SECTION_SYSTEM, KEY_RS_CRON_WINDOWS);
+}
+
+string ConfigUtility::get_reboot_system_crontab_blackouts() {
+    return _get_config_value_string(CONF_SECTION_SYSTEM, KEY_RS_CRON_BLACKOUTS);
+}
+
 string ConfigUtility::get_ethernet_enable_string() {
     return _get_config_value_string(CONF_SECTION_SYSTEM, KEY_ETHERNET_ENABLE);
 }
@@ -607,6 +609,14 @@ bool ConfigUtility::get_usb_enable() {
     return _get_config_value(CONF_SECTION_SYSTEM, KEY_USB_ENABLE).toBool();
 }
 
+string ConfigUtility::get_usb_blocked_classes() {
+    return _get_config_value_string(CONF_SECTION_SYSTEM, KEY_USB_BLOCKED_CLASSES);
+}
+
+string ConfigUtility::get_usb_blocked_ports() {
+    return _get_config_value_string(CONF_SECTION_SYSTEM, KEY_USB_BLOCKED_PORTS);
+}
+
 bool ConfigUtility::get_chromium_use_sys_virtual_keyboard() {
     return _get_config_value(CONF_SECTION_SYSTEM, KEY_CHROMIUM_USE_SYS_VIRTUAL_KEYBOARD).toBool();
 }
@@ -663,6 +673,14 @@ void ConfigUtility::set_usb_enable(bool enabled) {
     _set_config_value_string(CONF_SECTION_SYSTEM, KEY_USB_ENABLE, bool_cast(enabled));
 }
 
+void ConfigUtility::set_usb_blocked_classes(const char* classes) {
+    _set_config_value_string(CONF_SECTION_SYSTEM, KEY_USB_BLOCKED_CLASSES, classes);
+}
+
+void ConfigUtility::set_usb_blocked_ports(const char* ports) {
+    _set_config_value_string(CONF_SECTION_SYSTEM, KEY_USB_BLOCKED_PORTS, ports);
+}
+
 void ConfigUtility::set_chromium_use_sys_virtual_keyboard(bool enabled) {
     _set_config_value_string(CONF_SECTION_SYSTEM, KEY_CHROMIUM_USE_SYS_VIRTUAL_KEYBOARD, bool_cast(enabled));
 }
@@ -1125,6 +1143,11 @@ bool ConfigUtility::get_factory_reset_function_is_showed_for_user() {
     return _get_function_is_showed_for_user(CONF_SECTION_OPERATE, KEY_FACTORY_RESET_IS_SHOWED_FOR_USER);
 }
 
+// diagnostics related
+bool ConfigUtility::get_diagnostics_page_is_showed() {
+    return _get_page_is_showed(CONF_SECTION_DIAGNOSTICS);
+}
+
 // about related
 bool ConfigUtility::get_about_page_is_showed() {
     return _get_page_is_showed(CONF_SECTION_ABOUT);
@@ -2,8 +2,16 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
 #include <string>
 #include <array>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#endif
 #include <QDebug>
 
 #include "./include/utility.h"
@@ -19,10 +27,10 @@ Options:
         -p,--password   Password
         -P,--port       Port number
 */
-const char* FTPGET_CMD = "ftpget -u %s -p %s -P %s %s %s %s 2>&1";
+const char* FTPGET_BIN = "ftpget";
 
 bool TPCFTPUtility::download_from_remote(const char* server, const char* port, const char* username, 
-        const char* password, const char* remotePath, const char* localPath) {
+        const char* password, const char* remotePath, const char* localPath, CancelCheckFunc isCancelled) {
     char localFile[BUFF_SIZE] = {0};
     // check input
     if (!server || !port || !username || !password || !remotePath || !localPath) {
@@ -42,5 +50,41 @@ bool TPCFTPUtility::download_from_remote(const char* server, const char* port, c
     else {
         snprintf(localFile, BUFF_SIZE, "%s", localPath);
     }
-    return execute_cmd_set_info(FTPGET_CMD, username, password, port, server, localFile, remotePath);
+#ifdef _WIN32
+    return false;
+#else
+    // run without a shell so it can be stopped, the arguments are not parsed by sh either
+    pid_t pid = fork();
+    if (pid == 0) {
+        execlp(FTPGET_BIN, FTPGET_BIN, "-u", username, "-p", password, "-P", port,
+               server, localFile, remotePath, (char *)nullptr);
+        _exit(127);
+    }
+    if (pid < 0) {
+        qDebug("fork failed:%s", strerror(errno));
+        return false;
+    }
+    int status = 0;
+    bool isCancelledDownload = false;
+    while (true)
+    {
+        pid_t ret = waitpid(pid, &status, WNOHANG);
+        if (ret == pid || (ret < 0 && errno != EINTR))
+            break;
+        if (!isCancelledDownload && isCancelled && isCancelled()) {
+            kill(pid, SIGTERM);
+            isCancelledDownload = true;
+        }
+        usleep(FTP_CANCEL_INTERVAL_MS * 1000);
+    }
+    if (isCancelledDownload) {
+        // a partial file is not kept
+        unlink(localFile);
+        qDebug("ftpget %s%s cancelled", server, remotePath);
+        return false;
+    }
+    int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    qDebug("ftpget %s:%s %s to %s ret:%d", server, port, remotePath, localFile, exitCode);
+    return exitCode == EXIT_SUCCESS;
+#endif
 }
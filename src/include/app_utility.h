@@ -5,12 +5,15 @@
 #define APP_UTILITY_H
 
 #include <string>
+#include <memory>
 
 #define MAX_UNAVAILABLE_LIMIT 3
 
 using namespace std;
 
-class PollingThread;
+class JobScheduler;
+class JobToken;
+class IProcessUtility;
 
 class IAppUtility {
 public:
@@ -22,19 +25,26 @@ public:
 class TightVNCUtility: public IAppUtility
 {
 public:
-    TightVNCUtility();
+    explicit TightVNCUtility(IProcessUtility *processUtil = nullptr);
     ~TightVNCUtility();
-    void start_monitoring();
+    // polls the configured server on a background job until stop_monitoring
+    void start_monitoring(JobScheduler *scheduler);
+    void stop_monitoring();
     bool is_configuration_ready();
     pair<string, int> start() override;
     pair<string, int> stop() override;
     void pollingVNCServerIsReady(bool isSuccess, bool isServerOnline);
 
 private:
+    bool _poll_vnc_server(shared_ptr<JobToken> token);
+
     bool m_is_started;
     bool m_is_server_online;
     int m_unavailable_count;
-    PollingThread *m_pollingThread;
+    shared_ptr<JobToken> m_pollingToken;
+    // shared process snapshot, created here when none is given
+    IProcessUtility *m_processUtil;
+    bool m_isProcessUtilOwned;
 };
 
 #endif // APP_UTILITY_H
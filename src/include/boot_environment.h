@@ -0,0 +1,62 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef BOOT_ENVIRONMENT_H
+#define BOOT_ENVIRONMENT_H
+
+#include <string>
+#include <mutex>
+
+#define PROC_CMDLINE_FILE           "/proc/cmdline"
+#define PROC_SELF_MOUNTINFO_FILE    "/proc/self/mountinfo"
+#define CMDLINE_KEY_ROOT            "root"
+#define ROOT_FSTYPE_OVERLAY         "overlay"
+// /run is a tmpfs, the file is gone after the reboot that applies the mode
+#define READONLY_PENDING_FILE       "/run/settings-readonly-pending"
+
+using namespace std;
+
+// what the system booted from and how / is mounted, fixed until the next boot
+struct BootEnvironment
+{
+    // root= of the kernel command line without /dev/, ex: mmcblk2p3. PARTUUID= style is kept as is
+    string rootDevice;
+    // filesystem type and source of the top mount on /
+    string rootFsType;
+    string rootSource;
+    // read-only mode puts an overlay on the read-only root
+    bool isRootOverlay;
+    bool isRootReadOnly;
+};
+
+// value of "key=value" in a kernel command line, the last one wins like the kernel
+pair<string, bool> get_cmdline_value(const string& cmdline, const char* key);
+
+// reads /proc/cmdline and /proc/self/mountinfo in process, the files are injectable for fixtures
+class BootEnvironmentProbe
+{
+public:
+    explicit BootEnvironmentProbe(const char* cmdlineFile = PROC_CMDLINE_FILE,
+                                  const char* mountInfoFile = PROC_SELF_MOUNTINFO_FILE,
+                                  const char* readonlyPendingFile = READONLY_PENDING_FILE);
+    // parsed on first use, later calls return the cached result
+    pair<BootEnvironment, bool> get();
+    // next get parses the files again
+    void invalidate();
+    // root partition is on the disk, ex: mmcblk1 matches mmcblk1p2 but not mmcblk10p2, sda matches sda1
+    bool is_root_on_disk(const char* diskName);
+    // read-only mode set for the next boot, shared by every process until then
+    pair<bool, bool> get_pending_readonly_mode();
+    bool set_pending_readonly_mode(bool readonly);
+
+private:
+    bool _load(BootEnvironment &environment);
+
+    string m_cmdlineFile;
+    string m_mountInfoFile;
+    string m_readonlyPendingFile;
+    mutex m_mutex;
+    pair<BootEnvironment, bool> m_environment;
+    bool m_isLoaded;
+};
+#endif // BOOT_ENVIRONMENT_H
@@ -0,0 +1,74 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef BOOT_LOGO_UTILITY_H
+#define BOOT_LOGO_UTILITY_H
+
+#include <string>
+#include <vector>
+
+#include "system_utility.h"
+
+#define PSPLASH_CONFIG_FILE         "/etc/psplash.conf"
+#define PSPLASH_BG_COLOR_KEY        "BACKGROUND_COLOR"
+#define FRAMEBUFFER_SYSFS_FOLDER    "/sys/class/graphics/fb0"
+// psplash draws on the framebuffer, a 16 bpp panel shows rgb565
+#define FRAMEBUFFER_RGB565_BPP      16
+
+using namespace std;
+
+// 4 bytes per pixel in memory order b, g, r, a (QImage::Format_ARGB32 on little endian)
+class BootLogoImage
+{
+public:
+    BootLogoImage();
+    BootLogoImage(int width, int height);
+    int getWidth() const;
+    int getHeight() const;
+    int getStride() const;
+    unsigned char* getPixels();
+    const unsigned char* getPixels() const;
+
+private:
+    int m_width;
+    int m_height;
+    vector<unsigned char> m_pixels;
+};
+
+// area average resampling, every source pixel contributes by covered area. downscale only
+bool resample_area(const BootLogoImage &source, BootLogoImage &target);
+// blend alpha over color, scale down to fit and center on a width x height canvas of color
+bool fit_on_canvas(const BootLogoImage &source, unsigned int color, int width, int height, BootLogoImage &canvas);
+// ordered dither to rgb565 levels, result stays 8 bit per channel
+void quantize_rgb565(BootLogoImage &image);
+// 24 bit bottom-up bmp
+string encode_bmp24(const BootLogoImage &image);
+
+class IBootLogoUtility {
+public:
+    virtual ~IBootLogoUtility() {}
+    // panel resolution and bits per pixel from framebuffer
+    virtual bool get_framebuffer_info(int &width, int &height, int &bitsPerPixel) = 0;
+    virtual pair<string, bool> get_background_color() = 0;
+    // decode bmp/png, fit to panel, write logo and psplash color together.
+    // color keeps the configured one when empty. first is error message on failure
+    virtual pair<string, bool> apply_boot_logo(const char* imagePath, const char* color) = 0;
+};
+
+class TPCBootLogoUtility: public IBootLogoUtility {
+public:
+    TPCBootLogoUtility(const char* logoPath = BOOT_LOGO_PATH, const char* psplashConfigFile = PSPLASH_CONFIG_FILE,
+                       const char* framebufferFolder = FRAMEBUFFER_SYSFS_FOLDER);
+    bool get_framebuffer_info(int &width, int &height, int &bitsPerPixel) override;
+    pair<string, bool> get_background_color() override;
+    pair<string, bool> apply_boot_logo(const char* imagePath, const char* color) override;
+
+private:
+    bool _decode_image(const char* imagePath, BootLogoImage &image);
+    bool _parse_color(const string& color, unsigned int &value);
+
+    string m_logoPath;
+    string m_psplashConfigFile;
+    string m_framebufferFolder;
+};
+#endif // BOOT_LOGO_UTILITY_H
@@ -0,0 +1,47 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef BRIGHTNESS_CONTROLLER_H
+#define BRIGHTNESS_CONTROLLER_H
+
+#include <QObject>
+
+#define BRIGHTNESS_DEFAULT_REFRESH_RATE 60
+// persist once the slider stays still for this long
+#define BRIGHTNESS_SETTLE_MS            500
+
+class QTimer;
+class IScreenUtility;
+
+// coalesces slider changes to one backlight write per display frame,
+// the last value is persisted once after the drag settles
+class BrightnessController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BrightnessController(IScreenUtility *screenUtil, qreal refreshRate = BRIGHTNESS_DEFAULT_REFRESH_RATE,
+                                  QObject *parent = nullptr);
+    ~BrightnessController();
+    void requestBrightness(int brightness);
+    // write pending value and persist now, ex: before exit
+    void flush();
+
+private slots:
+    void frameTimeout();
+    void settleTimeout();
+
+private:
+    void _write_pending();
+
+    IScreenUtility *m_screenUtil;
+    QTimer *m_frameTimer;
+    QTimer *m_settleTimer;
+    int m_pendingBrightness;
+    int m_writtenBrightness;
+    bool m_isPersistPending;
+
+signals:
+    void brightnessSettled(int);
+};
+#endif // BRIGHTNESS_CONTROLLER_H
@@ -114,10 +114,16 @@ public:
     int get_reboot_system_crontab_minute();
     int get_reboot_system_crontab_hour();
     int get_reboot_system_crontab_dayofweek();
+    // more windows and blackout periods in the format of reboot_schedule.h, only set by file
+    string get_reboot_system_crontab_windows();
+    string get_reboot_system_crontab_blackouts();
     string get_ethernet_enable_string();
     string get_usb_enable_string();
     bool get_ethernet_enable();
     bool get_usb_enable();
+    // usb class codes in hex and port names, separated by space
+    string get_usb_blocked_classes();
+    string get_usb_blocked_ports();
     bool get_chromium_use_sys_virtual_keyboard();
     bool get_chromium_use_custom_virtual_keyboard();
     void set_com1_mode(const char* mode);
@@ -132,6 +138,8 @@ public:
     void set_reboot_system_crontab_dayofweek(int dayofweek);
     void set_ethernet_enable(bool enabled);
     void set_usb_enable(bool enabled);
+    void set_usb_blocked_classes(const char* classes);
+    void set_usb_blocked_ports(const char* ports);
     void set_chromium_use_sys_virtual_keyboard(bool enabled);
     bool get_com_function_is_showed_for_user();
 
@@ -242,6 +250,8 @@ public:
     bool get_shutdown_function_is_showed_for_user();
     bool get_open_terminal_function_is_showed_for_user();
     bool get_factory_reset_function_is_showed_for_user();
+    // diagnostics related
+    bool get_diagnostics_page_is_showed();
     // about related
     bool get_about_page_is_showed();
     // exit related
@@ -4,17 +4,25 @@
 #ifndef FTP_UTILITY_H
 #define FTP_UTILITY_H
 
+#include "utility.h"
+
+// ftpget is checked this often for exit and cancel
+#define FTP_CANCEL_INTERVAL_MS  100
+
 class IFTPUtility {
 public:
     virtual ~IFTPUtility() {}
+    // a cancelled download removes the partial file
     virtual bool download_from_remote(const char* server, const char* port, const char* username, 
-        const char* password, const char* remotePath, const char* localPath) = 0;
+        const char* password, const char* remotePath, const char* localPath,
+        CancelCheckFunc isCancelled = nullptr) = 0;
 };
 
 class TPCFTPUtility: public IFTPUtility {
 public:
     bool download_from_remote(const char* server, const char* port, const char* username, 
-        const char* password, const char* remotePath, const char* localPath) override;
+        const char* password, const char* remotePath, const char* localPath,
+        CancelCheckFunc isCancelled = nullptr) override;
 };
 
 #endif // FTP_UTILITY_H
@@ -0,0 +1,47 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef INI_DOCUMENT_H
+#define INI_DOCUMENT_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// in-memory ini file, keeps comments, blank lines and key order untouched
+// so an unmodified document writes back byte for byte.
+// sections may repeat (ex: weston.ini [output], [launcher]), a repeated
+// section is selected by one of its key/value pairs (ex: name=DSI-1)
+class IniDocument
+{
+public:
+    IniDocument();
+    bool load(const char* path);
+    void load_from_string(const string& content);
+    string to_string();
+    // atomic write, clears modified flag
+    bool save(const char* path);
+    bool is_loaded();
+    // true when content differs from what was loaded or saved last
+    bool is_modified();
+    pair<string, bool> get_value(const char* section, const char* key);
+    pair<string, bool> get_value(const char* section, const char* matchKey, const char* matchValue, const char* key);
+    // adds key or section when missing, only marks modified when value changed
+    bool set_value(const char* section, const char* key, const char* value);
+    bool set_value(const char* section, const char* matchKey, const char* matchValue, const char* key, const char* value);
+
+private:
+    int _find_section(const char* section, const char* matchKey, const char* matchValue, int *sectionEnd);
+    int _find_key(int sectionStart, int sectionEnd, const char* key);
+    bool _parse_section(const string& line, string &section);
+    bool _parse_key_value(const string& line, string &key, string &value);
+
+    vector<string> m_lines;
+    bool m_endsWithNewline;
+    bool m_loaded;
+    bool m_modified;
+    string m_savedContent;
+};
+
+#endif // INI_DOCUMENT_H
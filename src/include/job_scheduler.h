@@ -0,0 +1,114 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef JOB_SCHEDULER_H
+#define JOB_SCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include <QObject>
+#include <QString>
+
+#define JOB_SCHEDULER_WORKER_COUNT      3
+#define JOB_SCHEDULER_MIN_WORKER_COUNT  2
+#define JOB_CANCELLED_MESSAGE           "Cancelled."
+
+using namespace std;
+
+enum class JobPriority {
+    // the user waits for it behind the loading indicator
+    UI_CRITICAL,
+    // never takes the last free worker, a ui critical job can always start
+    BACKGROUND
+};
+
+// shared by a job and whoever may cancel it, the job function polls it
+class JobToken
+{
+public:
+    using PProgressFunc = std::function<void(int, const string&)>;
+    JobToken();
+    void cancel();
+    bool is_cancelled();
+    // sleeps up to timeoutMs, returns false when cancelled meanwhile
+    bool wait_for(int timeoutMs);
+    // percent 0 - 100
+    void set_progress(int percent, const string& text);
+    void set_progress_handler(PProgressFunc handler);
+    void set_finished();
+    void wait_finished();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_isCancelled;
+    bool m_isFinished;
+    PProgressFunc m_progressHandler;
+};
+
+// one unit of work, created on the gui thread so its signals are queued there.
+// deleted by the scheduler after the finished signal
+class Job : public QObject
+{
+    Q_OBJECT
+
+public:
+    // function pointer
+    using PBoolFunc = std::function<bool()>;
+    using PPairFunc = std::function<std::pair<std::string, bool>()>;
+    // the function binds the same token when it reports progress or can be cancelled
+    Job(PBoolFunc pWorkFunction, JobPriority priority,
+        shared_ptr<JobToken> token = make_shared<JobToken>());
+    Job(PPairFunc pWorkFunction, JobPriority priority,
+        shared_ptr<JobToken> token = make_shared<JobToken>());
+    JobPriority get_priority();
+    shared_ptr<JobToken> get_token();
+    // called on a worker thread, a job cancelled before it started finishes with false
+    void run();
+
+signals:
+    void progressChanged(int percent, QString text);
+    void workFinished(bool);
+    void workFinishedWithResult(QString, bool);
+
+private:
+    PBoolFunc m_pWorkFunction;
+    PPairFunc m_pWorkPairFunction;
+    JobPriority m_priority;
+    shared_ptr<JobToken> m_token;
+};
+
+// fixed worker pool, ui critical jobs first, each priority in start order.
+// background jobs use all workers but one, smaller pools are raised to JOB_SCHEDULER_MIN_WORKER_COUNT
+class JobScheduler
+{
+public:
+    explicit JobScheduler(int workerCount = JOB_SCHEDULER_WORKER_COUNT);
+    // queued jobs are dropped, running jobs are cancelled and waited for,
+    // job functions check their token so this takes one iteration of them
+    ~JobScheduler();
+    // takes ownership, connect the job signals before
+    void start(Job *job);
+    size_t get_pending_count();
+
+private:
+    void _work();
+    bool _has_runnable_job();
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    deque<Job *> m_uiQueue;
+    deque<Job *> m_backgroundQueue;
+    vector<shared_ptr<JobToken>> m_runningTokens;
+    vector<std::thread> m_workers;
+    int m_backgroundLimit;
+    int m_backgroundRunning;
+    bool m_isStopping;
+};
+#endif // JOB_SCHEDULER_H
@@ -0,0 +1,128 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef NETWORK_DIAGNOSTICS_UTILITY_H
+#define NETWORK_DIAGNOSTICS_UTILITY_H
+
+#include <string>
+#include <vector>
+
+#include "utility.h"
+
+#define SYS_CLASS_NET_FOLDER            "/sys/class/net"
+#define LOOPBACK_ADDRESS                "127.0.0.1"
+
+#define DIAGNOSTICS_DEFAULT_COUNT       10
+#define DIAGNOSTICS_MAX_COUNT           100
+#define DIAGNOSTICS_DEFAULT_TIMEOUT_MS  1000
+#define DIAGNOSTICS_DEFAULT_PORT        80
+#define DIAGNOSTICS_THROUGHPUT_SECONDS  3
+#define DIAGNOSTICS_THROUGHPUT_BUFF     (64 * 1024)
+#define DIAGNOSTICS_CONNECT_TIMEOUT_MS  5000
+// a pending connect is checked for cancel this often
+#define DIAGNOSTICS_CANCEL_INTERVAL_MS  100
+// upper bound (ms) of each histogram bucket, last bucket collects the rest
+#define LATENCY_BUCKET_BOUNDS           {1, 2, 5, 10, 20, 50, 100, 200, 500}
+
+using namespace std;
+
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    void addSample(double latencyMs);
+    void addLost();
+    int getSent();
+    int getReceived();
+    int getLost();
+    double getMin();
+    double getMax();
+    double getAverage();
+    vector<int> getBuckets();
+    static vector<string> getBucketLabels();
+    string toString();
+
+private:
+    int m_sent;
+    int m_received;
+    double m_min;
+    double m_max;
+    double m_sum;
+    vector<double> m_bounds;
+    vector<int> m_buckets;
+};
+
+class InterfaceStatistics
+{
+public:
+    InterfaceStatistics();
+    void setName(const string& name);
+    void setOperState(const string& operstate);
+    void setRxBytes(unsigned long long value);
+    void setTxBytes(unsigned long long value);
+    void setRxPackets(unsigned long long value);
+    void setTxPackets(unsigned long long value);
+    void setRxErrors(unsigned long long value);
+    void setTxErrors(unsigned long long value);
+    void setRxDropped(unsigned long long value);
+    void setTxDropped(unsigned long long value);
+    string getName();
+    string getOperState();
+    unsigned long long getRxBytes();
+    unsigned long long getTxBytes();
+    unsigned long long getRxPackets();
+    unsigned long long getTxPackets();
+    unsigned long long getRxErrors();
+    unsigned long long getTxErrors();
+    unsigned long long getRxDropped();
+    unsigned long long getTxDropped();
+    string toString();
+
+private:
+    string m_name;
+    string m_operstate;
+    unsigned long long m_rx_bytes;
+    unsigned long long m_tx_bytes;
+    unsigned long long m_rx_packets;
+    unsigned long long m_tx_packets;
+    unsigned long long m_rx_errors;
+    unsigned long long m_tx_errors;
+    unsigned long long m_rx_dropped;
+    unsigned long long m_tx_dropped;
+};
+
+// isCancelled is checked between probes and sends
+class INetworkDiagnosticsUtility {
+public:
+    virtual ~INetworkDiagnosticsUtility() {}
+    virtual pair<LatencyHistogram, bool> icmp_latency(const char* host, int count, int timeoutMs,
+                                                      CancelCheckFunc isCancelled = nullptr) = 0;
+    virtual pair<LatencyHistogram, bool> tcp_connect_latency(const char* host, int port, int count, int timeoutMs,
+                                                             CancelCheckFunc isCancelled = nullptr) = 0;
+    virtual pair<double, bool> tcp_throughput(const char* host, int port, int seconds,
+                                              CancelCheckFunc isCancelled = nullptr) = 0;
+    virtual pair<double, bool> tcp_loopback_throughput(int seconds, CancelCheckFunc isCancelled = nullptr) = 0;
+    virtual pair<vector<InterfaceStatistics>, bool> get_interface_statistics() = 0;
+};
+
+class TPCNetworkDiagnosticsUtility: public INetworkDiagnosticsUtility {
+public:
+    // sysfs root is injectable for running against a fake tree
+    explicit TPCNetworkDiagnosticsUtility(const char* sysClassNetFolder = SYS_CLASS_NET_FOLDER);
+    pair<LatencyHistogram, bool> icmp_latency(const char* host, int count, int timeoutMs,
+                                              CancelCheckFunc isCancelled = nullptr) override;
+    pair<LatencyHistogram, bool> tcp_connect_latency(const char* host, int port, int count, int timeoutMs,
+                                                     CancelCheckFunc isCancelled = nullptr) override;
+    pair<double, bool> tcp_throughput(const char* host, int port, int seconds,
+                                      CancelCheckFunc isCancelled = nullptr) override;
+    pair<double, bool> tcp_loopback_throughput(int seconds, CancelCheckFunc isCancelled = nullptr) override;
+    pair<vector<InterfaceStatistics>, bool> get_interface_statistics() override;
+
+private:
+    int _start_sink_server(int *port);
+    static void _run_sink_server(int listenFd);
+    unsigned long long _read_statistics_value(const string& ethernet, const char* name);
+    string m_sysClassNetFolder;
+};
+
+#endif // NETWORK_DIAGNOSTICS_UTILITY_H
@@ -29,6 +29,9 @@
 
 using namespace std;
 
+class IServiceManager;
+class IProcessUtility;
+
 class INetworkUtility {
 public:
     virtual ~INetworkUtility() {}
@@ -69,6 +72,8 @@ public:
 
 class TPCNetworkUtility: public INetworkUtility {
 public:
+    explicit TPCNetworkUtility(IServiceManager *serviceManager = nullptr, IProcessUtility *processUtil = nullptr);
+    ~TPCNetworkUtility();
     pair<vector<string>, bool> get_available_networks() override;
     pair<vector<string>, bool> get_network_nameservers(const char* ethernet) override;
     pair<string, bool> get_network_mode(const char* ethernet, bool isIpv4) override;
@@ -107,6 +112,12 @@ private:
     pair<string, bool> _get_eth_status(string eth);
     map<string, string> m_ethNetworkMap;
     map<string, bool> m_ethOnlineMap;
+    // shared systemd1 client, created here when none is given
+    IServiceManager *m_serviceManager;
+    bool m_isServiceManagerOwned;
+    // shared process snapshot, created here when none is given
+    IProcessUtility *m_processUtil;
+    bool m_isProcessUtilOwned;
 };
 
 #endif // NETWORK_UTILITY_H
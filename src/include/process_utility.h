@@ -0,0 +1,96 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef PROCESS_UTILITY_H
+#define PROCESS_UTILITY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+
+#define PROC_FOLDER                     "/proc"
+// callers within this window share one scan
+#define PROCESS_SNAPSHOT_MAX_AGE_MS     500
+
+using namespace std;
+
+struct ProcessInfo
+{
+    int pid;
+    int ppid;
+    // effective uid, the one pgrep -u matches
+    unsigned int uid;
+    char state;
+    // clock ticks after boot, tells a reused pid from the original process
+    unsigned long long startTime;
+    // comm, at most 15 characters
+    string name;
+    // arguments joined by a space, empty for kernel threads
+    string cmdline;
+};
+
+// ex: "1234 (ip) S 1 ..." fills pid, name, state, ppid and startTime
+bool parse_proc_stat(const string& text, ProcessInfo &info);
+pair<unsigned int, bool> get_user_id(const char* user);
+
+// processes read from /proc at one point in time, indexed by name, user and parent
+class ProcessSnapshot
+{
+public:
+    explicit ProcessSnapshot(const char* procFolder = PROC_FOLDER);
+    // false when the folder can not be listed, processes exiting meanwhile are skipped
+    bool scan();
+    size_t size() const;
+    pair<ProcessInfo, bool> get_process(int pid) const;
+    vector<ProcessInfo> find_by_name(const char* name) const;
+    vector<ProcessInfo> find_by_user(unsigned int uid) const;
+    vector<ProcessInfo> find_by_name_and_user(const char* name, unsigned int uid) const;
+    vector<ProcessInfo> find_children(int ppid) const;
+    // substring of the command line, as ps ax | grep does
+    vector<ProcessInfo> find_by_cmdline(const char* pattern) const;
+
+private:
+    bool _read_process(const string& pidName, ProcessInfo &info);
+
+    string m_procFolder;
+    vector<ProcessInfo> m_processes;
+    unordered_map<int, size_t> m_pidIndex;
+    multimap<string, size_t> m_nameIndex;
+    multimap<unsigned int, size_t> m_userIndex;
+    multimap<int, size_t> m_parentIndex;
+};
+
+class IProcessUtility {
+public:
+    virtual ~IProcessUtility() {}
+    // shared by all callers, rescanned when older than PROCESS_SNAPSHOT_MAX_AGE_MS
+    virtual shared_ptr<const ProcessSnapshot> get_snapshot() = 0;
+    virtual void invalidate_snapshot() = 0;
+    // false when the process is gone or its pid now belongs to another process
+    virtual bool signal_process(const ProcessInfo &process, int signal) = 0;
+    // returns how many processes were signaled
+    virtual size_t signal_processes(const vector<ProcessInfo> &processes, int signal) = 0;
+};
+
+// signals go through a pidfd, once it is open the pid can not be reused under it
+class TPCProcessUtility: public IProcessUtility {
+public:
+    explicit TPCProcessUtility(const char* procFolder = PROC_FOLDER);
+    shared_ptr<const ProcessSnapshot> get_snapshot() override;
+    void invalidate_snapshot() override;
+    bool signal_process(const ProcessInfo &process, int signal) override;
+    size_t signal_processes(const vector<ProcessInfo> &processes, int signal) override;
+
+private:
+    pair<unsigned long long, bool> _get_start_time(int pid);
+
+    string m_procFolder;
+    std::mutex m_snapshotMutex;
+    shared_ptr<const ProcessSnapshot> m_snapshot;
+    chrono::steady_clock::time_point m_snapshotTime;
+};
+#endif // PROCESS_UTILITY_H
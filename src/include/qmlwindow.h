@@ -4,6 +4,7 @@
 #ifndef QMLWINDOW_H
 #define QMLWINDOW_H
 
+#include <memory>
 #include <QObject>
 
 #define COMMON_TIMEOUT 5
@@ -13,20 +14,40 @@
 #define LOCK_FILE_NAME "/tmp/settings.lock"
 #endif
 
-class PollingThread;
-class WorkerThread;
+class Job;
+class JobToken;
+class JobScheduler;
 class ConfigUtility;
 class RestoreUtility;
 class QFileSystemWatcher;
+class UEventMonitor;
+class StorageTelemetrySampler;
+class BrightnessController;
+class QTimer;
+class BlockDeviceData;
+class IServiceManager;
+class IProcessUtility;
 class IDeviceInfoUtility;
 class INetworkUtility;
+class INetworkDiagnosticsUtility;
 class IScreenUtility;
 class ISystemUtility;
+class IBootLogoUtility;
 class IStorageUtility;
+class IStorageBenchmarkUtility;
+class IScreenshotUtility;
+class ScreenshotGalleryModel;
+class BenchmarkResult;
 class ITimeUtility;
+class TimezoneListModel;
+class TimezoneFilterModel;
+class ITimeSyncClockSource;
+class TimeSyncMonitor;
+class NTPMessageWatcher;
 class IUpdateUtility;
 class IVersionUtility;
 class IFTPUtility;
+class RebootSchedule;
 
 class QMLWindow : public QObject
 {
@@ -39,6 +60,27 @@ public:
     // run these functions in background thread
     std::pair<std::string, bool> bg_applyTimeSetting(QObject *rootObject, ITimeUtility *pTimeUtil, 
         ConfigUtility* pConfigUtil);
+    std::pair<std::string, bool> bg_runDiagnostics(INetworkDiagnosticsUtility *pDiagnosticsUtil, int diagnosticsType,
+        std::string host, int port, int count, std::shared_ptr<JobToken> token);
+    std::pair<std::string, bool> bg_runStorageBenchmark(IStorageBenchmarkUtility *pBenchmarkUtil,
+        std::string folder, int fileSizeMB, int queueDepth, std::shared_ptr<std::vector<BenchmarkResult>> results,
+        std::shared_ptr<JobToken> token);
+    std::pair<std::string, bool> bg_runComBenchmark(ISystemUtility *pSystemUtil, std::string com,
+        std::shared_ptr<JobToken> token);
+    bool bg_downloadFTPFile(IFTPUtility *pFTPUtil, std::string server, std::string port, std::string username,
+        std::string password, std::string remotePath, std::string localPath, std::shared_ptr<JobToken> token);
+    std::pair<std::string, bool> bg_exportScreenshots(IScreenshotUtility *pScreenshotUtil, std::string folder, bool isArchive,
+        std::shared_ptr<JobToken> token);
+    std::pair<std::string, bool> bg_waitNetworkIP(INetworkUtility *pNetworkUtil, std::string ethernet, int timeout,
+        std::shared_ptr<JobToken> token);
+    std::pair<std::string, bool> bg_applyWizardTimeSetting(ITimeUtility *pTimeUtil, std::string timezone,
+        bool setIsNTP, std::string ntpServer, std::string datetime);
+    std::pair<std::string, bool> bg_applyBootLogo(IBootLogoUtility *pBootLogoUtil, std::string logoPath,
+        std::string bgColor);
+    std::pair<std::string, bool> bg_importConfig(RestoreUtility *pRestoreUtil, std::string filePath,
+        ConfigUtility *pConfigUtil);
+    bool bg_restartGestureService(IScreenUtility *pScreenUtil);
+    bool bg_setRebootSystemCrontab(ISystemUtility *pSystemUtil, bool enabled, RebootSchedule schedule);
 
 private:
     bool m_inPortrait;
@@ -52,19 +94,42 @@ private:
     std::string m_appMode;
     std::string m_keyboardLocale;
     int m_pageIndex;
-    std::string m_threadParameter;
-    QStringList m_timezones;
     RestoreUtility *m_restoreUtility;
     QFileSystemWatcher *m_watcher;
-    PollingThread *m_pollingThread;
-    WorkerThread *m_workThread;
+    UEventMonitor *m_ueventMonitor;
+    StorageTelemetrySampler *m_storageTelemetry;
+    QTimer *m_storageTelemetryTimer;
+    BrightnessController *m_brightnessController;
+    // fixed worker pool for everything that would block the gui thread
+    JobScheduler *m_jobScheduler;
+    Job *m_screenshotJob;
+    // job behind the loading indicator, its cancel button cancels it
+    std::shared_ptr<JobToken> m_loadingToken;
+    std::string m_screenshotExportFolder;
     ConfigUtility *m_configUtil;
+    // shared by the utilities that control systemd units
+    IServiceManager *m_serviceManager;
+    // one process snapshot for all utilities
+    IProcessUtility *m_processUtil;
     IDeviceInfoUtility *m_deviceInfoUtil;
     INetworkUtility *m_networkUtil;
+    INetworkDiagnosticsUtility *m_networkDiagnosticsUtil;
     IScreenUtility *m_screenUtil;
     ISystemUtility *m_systemUtil;
+    IBootLogoUtility *m_bootLogoUtil;
     IStorageUtility *m_storageUtil;
+    IStorageBenchmarkUtility *m_storageBenchmarkUtil;
+    IScreenshotUtility *m_screenshotUtil;
+    ScreenshotGalleryModel *m_screenshotGalleryModel;
+    std::vector<BenchmarkResult> m_storageBenchmarkResults;
+    std::string m_storageBenchmarkDevice;
     ITimeUtility *m_timeUtil;
+    TimezoneListModel *m_timezoneModel;
+    TimezoneFilterModel *m_timezoneFilterModel;
+    ITimeSyncClockSource *m_timeSyncClockSource;
+    TimeSyncMonitor *m_timeSyncMonitor;
+    NTPMessageWatcher *m_ntpMessageWatcher;
+    QTimer *m_timeSyncTimer;
     IUpdateUtility *m_updateUtil;
     IVersionUtility *m_versionUtil;
     IFTPUtility *m_ftpUtil;
@@ -75,7 +140,7 @@ private:
     void initSideBarHandler(QObject *rootObject);
     void initCredentialsWindowHandler(QObject *rootObject);
     void initWizardNetworkWindowHandler(QObject *rootObject);
-    void initWizardTimeWindowHandler(QObject *rootObject, QStringList &timezones);
+    void initWizardTimeWindowHandler(QObject *rootObject);
     void initWizardScreenWindowHandler(QObject *rootObject);
     void initWizardStartupWindowHandler(QObject *rootObject);
     void initScreenWindowValue(QObject *rootObject);
@@ -85,11 +150,19 @@ private:
     void initNetworkWindowWired2Value(QObject *rootObject);
     void initNetworkWindowFirewallValue(QObject *rootObject);
     void initNetworkWindowHandler(QObject *rootObject);
-    void initTimeWindowValue(QObject *rootObject, QStringList &timezones);
+    void initTimeWindowValue(QObject *rootObject);
+    void initTimeSyncValue(QObject *rootObject);
     void initTimeWindowHandler(QObject *rootObject);
     void initStorageWindowValue(QObject *rootObject);
+    void initStorageDeviceValue(QObject *rootObject, const char* deviceName);
+    void updateStoragePartitionValue(QObject *rootObject, const char* deviceName, BlockDeviceData &partition);
+    void initStorageWindowHandler(QObject *rootObject);
+    void initStorageTelemetryValue(QObject *rootObject);
     void initSystemWindowValue(QObject *rootObject);
     void initSystemWindowHandler(QObject *rootObject);
+    // daily or weekly window of the page with windows and blackouts of the config
+    RebootSchedule getRebootSchedule();
+    void updateNextRebootLabel(QObject *systemForm, bool enabled, const RebootSchedule &schedule);
     void initSecurityWindowValue(QObject *rootObject);
     void initSecurityWindowHandler(QObject *rootObject);
     void initFTPWindowValue(QObject *rootObject);
@@ -101,10 +174,12 @@ private:
     void initOperateWindowValue(QObject *rootObject);
     void initPasswordWindowHandler(QObject *rootObject);
     void initPasswordWindowValue(QObject *rootObject);
+    void initDiagnosticsWindowHandler(QObject *rootObject);
+    void initDiagnosticsWindowValue(QObject *rootObject);
     void initAboutWindowHandler(QObject *rootObject);
     void initAboutWindowValue(QObject *rootObject);
     void initLoginFlow(QObject *rootObject);
-    void initTimezones(QStringList &timezones);
+    void initTimezoneComboBox(QObject *form, const std::string &timezone);
     void startWorker();
 
     void waitNetworkSettingIsReady(QObject *rootObject, const char* ethernet);
@@ -113,43 +188,69 @@ private:
     void applyNetworkFirewallSetting(QObject *rootObject);
     void applyTimeSetting(QObject *rootObject);
     void applyScreenSetting(QObject *rootObject);
+    void showScreenSettingResult(QObject *rootObject, bool isSuccess, bool isWestonChanged, const std::string &msg);
     void applySystemStartupSetting(QObject *rootObject);
     void applySystemGeneralSetting(QObject *rootObject);
     void applySystemCOMSetting(QObject *rootObject);
+    void runComBenchmark(QObject *rootObject);
     void applySecuritySetting(QObject *rootObject);
     void applyLogoSetting(QObject *rootObject);
     void applyPasswordSetting(QObject *rootObject);
+    void runDiagnostics(QObject *rootObject, int diagnosticsType);
+    void runStorageBenchmark(QObject *rootObject);
+    void exportScreenshots(QObject *rootObject, QString folderPath, bool isArchive);
     bool applyCredentialsSetting(QObject *rootObject);
     bool applyUserCredentialsSetting(QObject *rootObject, const char *username);
     bool applyWizardNetworkSetting(QObject *rootObject);
     bool applyWizardEthernetNetworkSetting(QObject *rootObject, const char* ethernet);
-    bool applyWizardTimeSetting(QObject *rootObject);
+    void applyWizardTimeSetting(QObject *rootObject);
     bool applyWizardScreenSetting(QObject *rootObject);
     bool applyWizardStartupSetting(QObject *rootObject);
-    bool applyWizard(QObject *rootObject);
+    void applyWizard(QObject *rootObject);
+    void applyWizardRemainingSettings(QObject *rootObject);
     bool checkCredentialsRequirement(QObject *rootObject);
     bool checkCredentialsFields(QObject *rootObject, const char *username);
     bool checkWizardEthernetNetworkFields(QObject *rootObject, const char *ethernet);
     void moveToNextPage(QObject *rootObject, const std::string &currentPageName);
-    bool downloadFTPFile(QObject *rootObject);
+    void downloadFTPFile(QObject *rootObject);
     void startNetworkMonitor();
     void stopNetworkMonitor();
+    void startStorageMonitor();
+    void stopStorageMonitor();
+    void startStorageTelemetry();
+    void stopStorageTelemetry();
+    void startTimeSyncMonitor();
+    void stopTimeSyncMonitor();
 
     // message box dialog
     void showMessageDialog(QObject *rootObject, bool isSuccess, std::string *customMessage, int handlerIndex);
     void showQuestionDialog(QObject *rootObject, std::string message, int handlerIndex);
-    // loading indicator
-    void showLoadingIndicator(QObject *rootObject, bool isShow);
+    // loading indicator, the cancel button is shown with a token
+    void showLoadingIndicator(QObject *rootObject, bool isShow, std::shared_ptr<JobToken> token = nullptr);
+    bool isLoadingCancelled();
     // login dialog
     void showLoginDialog(QObject *rootObject, bool isLogin);
 
 private slots:
-    void pollingNetworkSettingIsReady(bool isSuccess, bool isWiredOnline);
-    void pollingNetworkIPIsReady(bool isSuccess, bool isWiredOnline);
+    void pollingNetworkSettingIsReady(QString customMessage, bool isSuccess);
+    void pollingNetworkIPIsReady(QString customMessage, bool isSuccess);
     void ipMonitorFileChangedEvent(const QString & path);
+    void storageDeviceChangedEvent(QString action, QString deviceName, QString partitionName);
+    void storageMountChangedEvent();
+    void usbDeviceChangedEvent(QString action, QString name);
+    void storageTelemetryTimeout();
+    void timeSyncTimeout();
+    void brightnessSettledEvent(int value);
     void importConfigIsFinished(QString customMessage, bool isSuccess);
     void downloadIsFinished(bool isSuccess);
     void applyTimeSettingIsFinished(QString customMessage, bool isSuccess);
+    void applyWizardTimeSettingIsFinished(QString customMessage, bool isSuccess);
+    void applyLogoSettingIsFinished(QString customMessage, bool isSuccess);
+    void diagnosticsIsFinished(QString result, bool isSuccess);
+    void storageBenchmarkIsFinished(QString result, bool isSuccess);
+    void comBenchmarkIsFinished(QString result, bool isSuccess);
+    void screenshotExportProgressChanged(int percentage, QString progressText);
+    void screenshotExportIsFinished(QString customMessage, bool isSuccess);
 
 public slots:
     // sidebar handler
@@ -164,6 +265,7 @@ public slots:
     void on_update_toggled();
     void on_operate_toggled();
     void on_password_toggled();
+    void on_diagnostics_toggled();
     void on_about_toggled();
     // network window handler
     void on_networkWindow_swipeView_changed();
@@ -187,6 +289,7 @@ public slots:
     void on_systemWindow_startupApplyButton_clicked();
     void on_systemWindow_generalApplyButton_clicked();
     void on_systemWindow_comApplyButton_clicked();
+    void on_systemWindow_comBenchmarkButton_clicked();
     void on_systemWindow_questionDialog_readonly_okButton_clicked();
     void on_systemWindow_questionDialog_user_login_okButton_clicked();
     // security window handler
@@ -210,16 +313,29 @@ public slots:
     void on_operateWindow_openTerminalButton_clicked();
     void on_operateWindow_factoryResetButton_clicked();
     void on_operateWindow_exportScreenshotsButton_clicked();
+    void on_operateWindow_viewScreenshotsButton_clicked();
+    void on_operateWindow_cancelScreenshotsButton_clicked();
     void on_operateWindow_questionDialog_reboot_okButton_clicked();
     void on_operateWindow_questionDialog_shutdown_okButton_clicked();
     void on_operateWindow_questionDialog_deleteScreenshots_okButton_clicked();
     void on_operateWindow_questionDialog_factoryReset_okButton_clicked();
+    // storage window handler
+    void on_storageWindow_benchmarkButton_clicked();
+    void on_storageWindow_benchmarkExportButton_clicked();
+    void on_storageWindow_swipeView_changed();
+    void on_storageWindow_telemetryDeviceComboBox_changed();
+    // diagnostics window handler
+    void on_diagnosticsWindow_pingButton_clicked();
+    void on_diagnosticsWindow_connectButton_clicked();
+    void on_diagnosticsWindow_throughputButton_clicked();
+    void on_diagnosticsWindow_refreshButton_clicked();
     // about window handler
     void on_aboutWindow_licenseButton_clicked();
     // login handler
     void on_loginDialog_okButton_clicked();
     void on_loginDialog_cancelButton_clicked();
     // dialog handler
+    void on_loadingIndicator_cancelButton_clicked();
     void on_questionDialog_cancelButton_clicked();
     void on_messageDialog_button_clicked();
     void on_messageDialog_button_clicked_relogin();
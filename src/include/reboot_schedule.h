@@ -0,0 +1,70 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef REBOOT_SCHEDULE_H
+#define REBOOT_SCHEDULE_H
+
+#include <ctime>
+#include <string>
+#include <vector>
+#include <set>
+
+#define REBOOT_SCHEDULE_MODE_DAILY      "daily"
+#define REBOOT_SCHEDULE_MODE_WEEKLY     "weekly"
+#define REBOOT_SCHEDULE_EVERY_DAY       -1
+#define REBOOT_SCHEDULE_COMMAND         "/sbin/reboot"
+#define MINUTES_PER_DAY                 1440
+#define DAYS_PER_WEEK                   7
+
+using namespace std;
+
+// local time, dayofweek 0 is sunday like cron
+struct RebootWindow
+{
+    int dayofweek;
+    int hour;
+    int minute;
+};
+
+// [start, end) in minutes of the day, an end before the start continues into the next day
+struct RebootBlackout
+{
+    int dayofweek;
+    int startMinute;
+    int endMinute;
+};
+
+// "03:00, 6 04:30" is every day at 03:00 and saturday at 04:30, invalid entries are skipped
+vector<RebootWindow> parse_reboot_windows(const string& text);
+// "08:00-18:00, 0 22:00-02:00"
+vector<RebootBlackout> parse_reboot_blackouts(const string& text);
+
+class RebootSchedule
+{
+public:
+    RebootSchedule();
+    void addWindow(const RebootWindow &window);
+    void addBlackout(const RebootBlackout &blackout);
+    vector<RebootWindow> getWindows() const;
+    vector<RebootBlackout> getBlackouts() const;
+    bool isBlackedOut(int dayofweek, int minuteOfDay) const;
+    // false when there is no window or every window is blacked out
+    bool hasFireTime() const;
+    // first fire time after now, -1 when there is none. the clock is the caller's so it can be simulated
+    time_t getNextFireTime(time_t now) const;
+    // cron.d lines, blacked out weekdays are left out of the weekday field
+    string toCrontab(const char* user, const char* command) const;
+
+private:
+    // distinct (minute of day, weekday) outside blackouts
+    set<pair<int, int>> _get_fire_points() const;
+
+    vector<RebootWindow> m_windows;
+    vector<RebootBlackout> m_blackouts;
+};
+
+// the daily or weekly window of the system page plus windows and blackouts in text,
+// dayofweek 7 is sunday too
+RebootSchedule make_reboot_schedule(const char* mode, int minute, int hour, int dayofweek,
+                                    const string& windows = "", const string& blackouts = "");
+#endif // REBOOT_SCHEDULE_H
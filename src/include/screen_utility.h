@@ -8,6 +8,14 @@
 #include <vector>
 #include <map>
 
+#include "ini_document.h"
+
+class IServiceManager;
+
+#define WESTON_CONFIG_FILE "/etc/xdg/weston/weston.ini"
+#define BACKLIGHT_FOLDER "/sys/class/backlight/lvds_backlight@0"
+#define GESTURE_CONFIG_FILE "/etc/gester/gester.conf"
+
 #define GESTURE_TYPE_GENERAL "general"
 #define GESTURE_TYPE_CUSTOM "custom"
 
@@ -18,7 +26,9 @@ class IScreenUtility {
 public:
     virtual ~IScreenUtility() {}
     virtual int get_brightness() = 0;
+    // only writes the backlight, call save_brightness() to persist across reboot
     virtual bool set_brightness(const int brightness) = 0;
+    virtual bool save_brightness() = 0;
     virtual int get_screensaver_idle_time() = 0;
     virtual bool set_screensaver_idle_time(const int seconds) = 0;
     virtual bool get_hide_cursor() = 0;
@@ -27,10 +37,18 @@ public:
     virtual bool set_top_bar_position(const char* position) = 0;
     virtual std::string get_rotate_screen() = 0;
     virtual bool set_rotate_screen(const char* rotateDegree) = 0;
+    // weston.ini is loaded once and kept in memory, the setters above only change the model
+    virtual bool reload_weston_config() = 0;
+    // writes pending weston.ini changes at once, first is true when the file changed
+    virtual std::pair<bool, bool> save_weston_config() = 0;
     virtual void restart_desktop_service() = 0;
     virtual std::string get_gesture_type() = 0;
     virtual std::pair<std::vector<std::string>, bool> get_gesture_list() = 0;
     virtual std::pair<std::vector<std::string>, bool> get_gesture_action_list() = 0;
+    // gester.conf is loaded once and kept in memory, the gesture setters only change the model
+    virtual bool reload_gesture_config() = 0;
+    // writes pending gester.conf changes at once, first is true when the file changed
+    virtual std::pair<bool, bool> save_gesture_config() = 0;
     virtual bool get_2_finger_gesture_swipe_up_enabled() = 0;
     virtual bool set_2_finger_gesture_swipe_up_enabled(const bool enabled) = 0;
     virtual bool get_2_finger_gesture_swipe_down_enabled() = 0;
@@ -47,16 +65,16 @@ public:
     virtual bool enable_gesture_service() = 0;
     virtual bool disable_gesture_service() = 0;
     virtual bool restart_gesture_service() = 0;
-    virtual int get_screenshots_count() = 0;
-    virtual std::pair<std::string, bool> export_screenshots(const char* exportFolder) = 0;
-    virtual bool delete_screenshots() = 0;
 };
 
 class TPCScreenUtility: public IScreenUtility {
 public:
-    TPCScreenUtility();
+    TPCScreenUtility(const char* westonConfigFile = WESTON_CONFIG_FILE, const char* backlightFolder = BACKLIGHT_FOLDER,
+                     const char* gestureConfigFile = GESTURE_CONFIG_FILE, IServiceManager *serviceManager = nullptr);
+    ~TPCScreenUtility();
     int get_brightness() override;
     bool set_brightness(const int brightness) override;
+    bool save_brightness() override;
     int get_screensaver_idle_time() override;
     bool set_screensaver_idle_time(const int seconds) override;
     bool get_hide_cursor() override;
@@ -65,10 +83,14 @@ public:
     bool set_top_bar_position(const char* position) override;
     std::string get_rotate_screen() override;
     bool set_rotate_screen(const char* rotateDegree) override;
+    bool reload_weston_config() override;
+    std::pair<bool, bool> save_weston_config() override;
     void restart_desktop_service() override;
     std::string get_gesture_type() override;
     std::pair<std::vector<std::string>, bool> get_gesture_list() override;
     std::pair<std::vector<std::string>, bool> get_gesture_action_list() override;
+    bool reload_gesture_config() override;
+    std::pair<bool, bool> save_gesture_config() override;
     bool get_2_finger_gesture_swipe_up_enabled() override;
     bool set_2_finger_gesture_swipe_up_enabled(const bool enabled) override;
     bool get_2_finger_gesture_swipe_down_enabled() override;
@@ -85,12 +107,11 @@ public:
     bool enable_gesture_service() override;
     bool disable_gesture_service() override;
     bool restart_gesture_service() override;
-    int get_screenshots_count() override;
-    std::pair<std::string, bool> export_screenshots(const char* exportFolder) override;
-    bool delete_screenshots() override;
 
 private:
-    bool _is_display_device_exist(const char* device);
+    int _open_backlight();
+    bool _load_weston_config();
+    bool _load_gesture_config();
     std::string _get_gesture_action(const char *gestureType, const char *actionKey);
     bool _get_gesture_action_enabled(const char *gestureType, const char *actionKey);
     bool _set_gesture_action_enabled(const char *gestureType, const char *actionKey, bool enabled);
@@ -98,5 +119,15 @@ private:
     std::vector<std::string> m_gestureList;
     std::vector<std::string> m_gestureActionList;
     std::map<std::string, std::string> m_gestureActionMap;
+    std::string m_westonConfigFile;
+    std::string m_backlightFolder;
+    // brightness attribute is kept open, slider writes often
+    int m_backlightFd;
+    IniDocument m_westonConfig;
+    std::string m_gestureConfigFile;
+    IniDocument m_gestureConfig;
+    // shared systemd1 client, created here when none is given
+    IServiceManager *m_serviceManager;
+    bool m_isServiceManagerOwned;
 };
 #endif // SCREEN_UTILITY_H
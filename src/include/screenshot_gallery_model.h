@@ -0,0 +1,68 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef SCREENSHOT_GALLERY_MODEL_H
+#define SCREENSHOT_GALLERY_MODEL_H
+
+#include <string>
+#include <vector>
+#include <QAbstractListModel>
+#include <QQuickImageProvider>
+
+#include "screenshot_thumbnailer.h"
+
+// qml loads thumbnails from image://screenshots/<name>?<mtime>
+#define SCREENSHOT_THUMBNAIL_PROVIDER   "screenshots"
+
+class IScreenshotUtility;
+
+struct ScreenshotGalleryItem
+{
+    string name;
+    // seconds since epoch
+    long long modified;
+    unsigned long long size;
+};
+
+// screenshots list for the gallery view, thumbnails are only requested
+// for delegates the view creates so they load as the list scrolls
+class ScreenshotGalleryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum ScreenshotRoles {
+        NameRole = Qt::UserRole + 1,
+        PathRole,
+        ThumbnailRole,
+        ModifiedRole,
+        SizeRole
+    };
+
+    explicit ScreenshotGalleryModel(IScreenshotUtility *screenshotUtil, const char* screenshotFolder = SCREENSHOTS_FOLDER,
+                                    const char* cacheFolder = SCREENSHOT_THUMBNAIL_FOLDER, QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+    // re-read screenshot folder and drop thumbnails of deleted screenshots
+    void refresh();
+
+private:
+    IScreenshotUtility *m_screenshotUtil;
+    ScreenshotThumbnailer m_thumbnailer;
+    string m_screenshotFolder;
+    std::vector<ScreenshotGalleryItem> m_items;
+};
+
+// requests run on the qml image loader thread, never on the gui thread
+class ScreenshotThumbnailProvider : public QQuickImageProvider
+{
+public:
+    explicit ScreenshotThumbnailProvider(const char* screenshotFolder = SCREENSHOTS_FOLDER,
+                                         const char* cacheFolder = SCREENSHOT_THUMBNAIL_FOLDER);
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+
+private:
+    ScreenshotThumbnailer m_thumbnailer;
+};
+#endif // SCREENSHOT_GALLERY_MODEL_H
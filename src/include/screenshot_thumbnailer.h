@@ -0,0 +1,70 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef SCREENSHOT_THUMBNAILER_H
+#define SCREENSHOT_THUMBNAILER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <sys/stat.h>
+
+#include "screenshot_utility.h"
+
+#define SCREENSHOT_THUMBNAIL_FOLDER     "/userdata/.screenshot-thumbnails"
+#define SCREENSHOT_THUMBNAIL_EXTENSION  ".thumb"
+#define SCREENSHOT_THUMBNAIL_MAX_WIDTH  240
+#define SCREENSHOT_THUMBNAIL_MAX_HEIGHT 160
+// 16 bit row accumulator holds up to 257 rows of 8 bit values
+#define SCREENSHOT_THUMBNAIL_MAX_FACTOR 255
+
+using namespace std;
+
+// 4 bytes per pixel, channel order is up to the caller, box filter treats channels alike
+class ThumbnailImage
+{
+public:
+    ThumbnailImage();
+    ThumbnailImage(int width, int height);
+    int getWidth() const;
+    int getHeight() const;
+    int getStride() const;
+    unsigned char* getPixels();
+    const unsigned char* getPixels() const;
+
+private:
+    int m_width;
+    int m_height;
+    vector<unsigned char> m_pixels;
+};
+
+// decode full screenshot at path into image, runs on the caller thread
+using ThumbnailDecodeFunc = std::function<bool(const string&, ThumbnailImage&)>;
+
+// integer downscale factor so the thumbnail fits in maxWidth x maxHeight
+int get_thumbnail_factor(int width, int height, int maxWidth = SCREENSHOT_THUMBNAIL_MAX_WIDTH,
+                         int maxHeight = SCREENSHOT_THUMBNAIL_MAX_HEIGHT);
+// averages factor x factor blocks, right and bottom remainders are dropped
+bool box_downscale(const ThumbnailImage &source, int factor, ThumbnailImage &thumbnail);
+
+// thumbnails cached on disk next to the screenshots, keyed by the screenshot mtime and size
+// so an overwritten screenshot gets a new thumbnail
+class ScreenshotThumbnailer
+{
+public:
+    explicit ScreenshotThumbnailer(const char* screenshotFolder = SCREENSHOTS_FOLDER,
+                                   const char* cacheFolder = SCREENSHOT_THUMBNAIL_FOLDER);
+    // cached thumbnail, or decode, downscale and cache it
+    pair<ThumbnailImage, bool> get_thumbnail(const char* name, ThumbnailDecodeFunc decode);
+    // remove cached thumbnails of screenshots not in names
+    void prune(const vector<string>& names);
+
+private:
+    string _get_cache_path(const string& name);
+    bool _read_cache(const string& path, const struct stat &sourceStat, ThumbnailImage &thumbnail);
+    bool _write_cache(const string& path, const struct stat &sourceStat, const ThumbnailImage &thumbnail);
+
+    string m_screenshotFolder;
+    string m_cacheFolder;
+};
+#endif // SCREENSHOT_THUMBNAILER_H
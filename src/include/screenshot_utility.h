@@ -0,0 +1,67 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef SCREENSHOT_UTILITY_H
+#define SCREENSHOT_UTILITY_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "utility.h"
+
+#define SCREENSHOTS_FOLDER          "/userdata"
+#define SCREENSHOT_FILE_PREFIX      "wayland-screenshot-"
+#define SCREENSHOT_SYS_DEV_BLOCK    "/sys/dev/block"
+// flash media gains nothing from more parallel writers
+#define SCREENSHOT_EXPORT_MAX_WORKERS       4
+#define SCREENSHOT_EXPORT_REMOVABLE_WORKERS 2
+// copy chunk, cancel is checked between chunks
+#define SCREENSHOT_COPY_CHUNK_SIZE  (1024 * 1024)
+// archive input and compressed output buffers, memory use does not grow with file count
+#define SCREENSHOT_ARCHIVE_BUFF_SIZE (64 * 1024)
+#define SCREENSHOT_ARCHIVE_PREFIX   "screenshots-"
+#define SCREENSHOT_MANIFEST_NAME    "MANIFEST.txt"
+
+using namespace std;
+
+// done files, total files, last finished file name, bytes per second
+using ScreenshotProgressFunc = std::function<void(int, int, const string&, double)>;
+
+class IScreenshotUtility {
+public:
+    virtual ~IScreenshotUtility() {}
+    virtual pair<vector<string>, bool> get_screenshots() = 0;
+    virtual int get_screenshots_count() = 0;
+    // progress and isCancelled are called from worker threads, a cancelled export removes its partial files
+    virtual pair<string, bool> export_screenshots(const char* exportFolder, ScreenshotProgressFunc progress,
+                                                  CancelCheckFunc isCancelled = nullptr) = 0;
+    // one compressed tar with a manifest, first is archive path on success
+    virtual pair<string, bool> export_screenshots_archive(const char* exportFolder, ScreenshotProgressFunc progress,
+                                                          CancelCheckFunc isCancelled = nullptr) = 0;
+    virtual bool delete_screenshots() = 0;
+};
+
+class TPCScreenshotUtility: public IScreenshotUtility {
+public:
+    TPCScreenshotUtility(const char* screenshotFolder = SCREENSHOTS_FOLDER, const char* sysDevBlockFolder = SCREENSHOT_SYS_DEV_BLOCK);
+    pair<vector<string>, bool> get_screenshots() override;
+    int get_screenshots_count() override;
+    pair<string, bool> export_screenshots(const char* exportFolder, ScreenshotProgressFunc progress,
+                                          CancelCheckFunc isCancelled = nullptr) override;
+    pair<string, bool> export_screenshots_archive(const char* exportFolder, ScreenshotProgressFunc progress,
+                                                  CancelCheckFunc isCancelled = nullptr) override;
+    bool delete_screenshots() override;
+    // worker count by device type of export folder
+    int get_export_workers(const char* exportFolder);
+
+private:
+    pair<string, bool> _prepare_export(const char* exportFolder, vector<string> &screenshots);
+    bool _copy_file(const string& source, const string& target, unsigned long long *copiedBytes,
+                    const CancelCheckFunc &isCancelled);
+    bool _read_sysfs_value(const string& path, string &value);
+
+    string m_screenshotFolder;
+    string m_sysDevBlockFolder;
+};
+#endif // SCREENSHOT_UTILITY_H
@@ -0,0 +1,89 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef SERIAL_UTILITY_H
+#define SERIAL_UTILITY_H
+
+#include <string>
+#include <vector>
+
+#include "utility.h"
+
+#define COM1_DEVICE                     "/dev/ttymxc1"
+#define COM2_DEVICE                     "/dev/ttymxc2"
+
+#define SERIAL_MODE_RS232               "rs232"
+#define SERIAL_MODE_RS422               "rs422"
+#define SERIAL_MODE_RS485               "rs485"
+#define SERIAL_DEFAULT_BAUDRATE         9600
+
+// throughput test sends about this long at the port baud rate
+#define SERIAL_BENCHMARK_SECONDS        2
+#define SERIAL_BENCHMARK_MIN_BYTES      256
+#define SERIAL_BENCHMARK_MAX_BYTES      (64 * 1024)
+#define SERIAL_BENCHMARK_ROUNDS         20
+#define SERIAL_BENCHMARK_PACKET_SIZE    16
+// no byte back for this long means no loopback
+#define SERIAL_BENCHMARK_IDLE_MS        1000
+
+using namespace std;
+
+struct SerialPortConfig
+{
+    int baudrate;
+    // 5 to 8
+    int dataBits;
+    // 'N', 'E' or 'O'
+    char parity;
+    // 1 or 2
+    int stopBits;
+    // rs232, rs422 or rs485, only rs485 drives RTS around transmit
+    string mode;
+    // ASYNC_LOW_LATENCY, the driver pushes received bytes without waiting a tick
+    bool lowLatency;
+};
+
+// 8N1 with low latency
+SerialPortConfig make_serial_config(int baudrate, const char* mode);
+// raw mode with the given line settings, rs485 through TIOCSRS485
+bool configure_serial_port(int fd, const SerialPortConfig &config);
+pair<SerialPortConfig, bool> read_serial_port_config(int fd);
+
+class SerialBenchmarkResult
+{
+public:
+    SerialBenchmarkResult();
+    void setBaudrate(int baudrate);
+    void setBytes(unsigned long long bytes);
+    void setSeconds(double seconds);
+    void setErrors(int errors);
+    // round trip in microseconds, one per packet
+    void setLatencies(vector<double> &latencies);
+    int getBaudrate();
+    unsigned long long getBytes();
+    double getSeconds();
+    int getErrors();
+    // bytes per second
+    double getThroughput();
+    // received payload against the line rate, 10 bits per 8N1 byte
+    double getEfficiency();
+    double getLatencyAverage();
+    double getLatencyPercentile(double percentile);
+    double getLatencyMax();
+    string toString();
+
+private:
+    int m_baudrate;
+    unsigned long long m_bytes;
+    double m_seconds;
+    int m_errors;
+    // sorted
+    vector<double> m_latencies;
+};
+
+// writeFd sends and readFd receives, the same fd with a loopback plug on the port,
+// the two sides of a pty pair in tests. data read back is compared with what was sent.
+// isCancelled is checked between chunks and rounds
+pair<SerialBenchmarkResult, bool> run_serial_benchmark(int writeFd, int readFd, size_t bytes, int rounds,
+                                                       CancelCheckFunc isCancelled = nullptr);
+#endif // SERIAL_UTILITY_H
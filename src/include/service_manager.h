@@ -0,0 +1,122 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef SERVICE_MANAGER_H
+#define SERVICE_MANAGER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+#include <QStringList>
+#include <QDBusConnection>
+#include <QDBusObjectPath>
+
+#define SYSTEMD1_SERVICE            "org.freedesktop.systemd1"
+#define SYSTEMD1_PATH               "/org/freedesktop/systemd1"
+#define SYSTEMD1_MANAGER_INTERFACE  "org.freedesktop.systemd1.Manager"
+#define SYSTEMD1_UNIT_INTERFACE     "org.freedesktop.systemd1.Unit"
+#define DBUS_PROPERTIES_INTERFACE   "org.freedesktop.DBus.Properties"
+#define SYSTEMD1_CALL_TIMEOUT_MS    5000
+// start jobs of slow units are given up, the unit itself keeps starting
+#define SYSTEMD1_JOB_TIMEOUT        30
+
+#define GESTURE_SERVICE_NAME        "gester.service"
+#define CROND_SERVICE_NAME          "crond.service"
+#define CONNMAN_SERVICE_NAME        "connman.service"
+#define WESTON_SERVICE_PATTERN      "weston*.service"
+
+using namespace std;
+
+// collects JobRemoved of the jobs a call queued. a job can finish before
+// its path is known from the reply, so results are kept for unknown jobs too
+class SystemdJobWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SystemdJobWatcher(QObject *parent = nullptr);
+    void add_job(const QString &job);
+    bool is_finished() const;
+    // "<unit> <result>" of added jobs that did not end with "done"
+    vector<string> get_failed_units() const;
+
+public slots:
+    void jobRemoved(uint id, QDBusObjectPath job, QString unit, QString result);
+
+signals:
+    void allFinished();
+
+private:
+    // every added job, and the ones still waited for
+    set<QString> m_jobs;
+    set<QString> m_pendingJobs;
+    map<QString, pair<QString, QString>> m_results;
+};
+
+// PropertiesChanged of one unit, finished once ActiveState is active
+class SystemdUnitWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SystemdUnitWatcher(QObject *parent = nullptr);
+    void set_active_state(const QString &state);
+    bool is_active() const;
+
+public slots:
+    void propertiesChanged(QString interface, QVariantMap changed, QStringList invalidated);
+
+signals:
+    void becameActive();
+
+private:
+    bool m_active;
+};
+
+// calls block until systemd finished the jobs, up to SYSTEMD1_JOB_TIMEOUT, run them in a job off the gui thread
+class IServiceManager {
+public:
+    virtual ~IServiceManager() {}
+    // jobs of all units are queued at once and waited for together
+    virtual bool start_units(const vector<string>& units) = 0;
+    virtual bool stop_units(const vector<string>& units) = 0;
+    virtual bool restart_units(const vector<string>& units) = 0;
+    // unit files of all units in one call, followed by a single reload
+    virtual bool enable_units(const vector<string>& units) = 0;
+    virtual bool disable_units(const vector<string>& units) = 0;
+    // running units are restarted so they pick up changed configuration
+    virtual bool enable_and_start_units(const vector<string>& units) = 0;
+    virtual bool stop_and_disable_units(const vector<string>& units) = 0;
+    virtual pair<bool, bool> get_unit_enabled(const char* unit) = 0;
+    // first loaded unit matching the glob, ex: weston@root.service for weston*.service
+    virtual pair<string, bool> find_unit(const char* pattern) = 0;
+    // returns at once when active, else when the unit reports it or on timeout
+    virtual bool wait_unit_active(const char* unit, int timeoutMs) = 0;
+};
+
+// org.freedesktop.systemd1 manager, the bus is injectable so it can run against a mock service
+class TPCServiceManager: public IServiceManager {
+public:
+    explicit TPCServiceManager(const QDBusConnection &bus = QDBusConnection::systemBus());
+    bool start_units(const vector<string>& units) override;
+    bool stop_units(const vector<string>& units) override;
+    bool restart_units(const vector<string>& units) override;
+    bool enable_units(const vector<string>& units) override;
+    bool disable_units(const vector<string>& units) override;
+    bool enable_and_start_units(const vector<string>& units) override;
+    bool stop_and_disable_units(const vector<string>& units) override;
+    pair<bool, bool> get_unit_enabled(const char* unit) override;
+    pair<string, bool> find_unit(const char* pattern) override;
+    bool wait_unit_active(const char* unit, int timeoutMs) override;
+
+private:
+    bool _run_jobs(const char* method, const vector<string>& units);
+    bool _call_manager(const char* method, const QList<QVariant> &arguments, int timeout = SYSTEMD1_CALL_TIMEOUT_MS);
+
+    QDBusConnection m_bus;
+};
+#endif // SERVICE_MANAGER_H
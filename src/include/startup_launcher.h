@@ -0,0 +1,67 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef STARTUP_LAUNCHER_H
+#define STARTUP_LAUNCHER_H
+
+#include <ctime>
+#include <string>
+
+// settings --launch-startup, run once after boot instead of the GUI
+#define STARTUP_LAUNCHER_OPTION     "--launch-startup"
+#define STARTUP_LAUNCHER_TIMEOUT_MS 60000
+// wait for xwayland once the wayland display is there
+#define STARTUP_LAUNCHER_X11_GRACE_MS 2000
+
+#define RUNTIME_FOLDER_PREFIX       "/run/user/"
+#define WAYLAND_DISPLAY_NAME        "wayland-0"
+// xwayland of weston listens here before it logs "xserver listening on display"
+#define X11_SOCKET_FOLDER           "/tmp/.X11-unix"
+#define X11_SOCKET_NAME             "X0"
+#define X11_DISPLAY_NAME            ":0"
+#define PROFILE_FILE                "/etc/profile"
+
+using namespace std;
+
+class ConfigUtility;
+class IServiceManager;
+
+// waits with inotify until name exists in folder, the folder may not exist yet either.
+// false on timeout
+bool wait_for_file(const string& folder, const char* name, int timeoutMs);
+
+// milliseconds of each phase and since boot, logged as they pass
+class BootPhaseTimer
+{
+public:
+    BootPhaseTimer();
+    void mark(const char* phase);
+    string get_summary();
+
+private:
+    double _get_time_ms(clockid_t clock);
+
+    double m_startMs;
+    double m_lastMs;
+    string m_summary;
+};
+
+class StartupLauncher
+{
+public:
+    explicit StartupLauncher(ConfigUtility *configUtil, IServiceManager *serviceManager,
+                             const char* x11SocketFolder = X11_SOCKET_FOLDER);
+    // waits up to timeoutMs in total for the wayland display, then runs the configured startup application
+    // under StartupSupervisor. returns once it is not restarted anymore
+    int run(int timeoutMs = STARTUP_LAUNCHER_TIMEOUT_MS);
+
+private:
+    // XDG_RUNTIME_DIR or /run/user/<uid>, created when missing
+    string _prepare_runtime_folder();
+
+    ConfigUtility *m_configUtil;
+    IServiceManager *m_serviceManager;
+    string m_x11SocketFolder;
+    BootPhaseTimer m_timer;
+};
+#endif // STARTUP_LAUNCHER_H
@@ -0,0 +1,106 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef STARTUP_SUPERVISOR_H
+#define STARTUP_SUPERVISOR_H
+
+#include <string>
+#include <vector>
+#include <deque>
+
+#define SUPERVISOR_BACKOFF_INITIAL_MS       1000
+#define SUPERVISOR_BACKOFF_MAX_MS           60000
+// a run this long counts as healthy and resets the backoff
+#define SUPERVISOR_STABLE_RUN_MS            60000
+// this many exits within the window is a crash loop, restarting stops
+#define SUPERVISOR_CRASH_LOOP_COUNT         5
+#define SUPERVISOR_CRASH_LOOP_WINDOW_MS     120000
+#define SUPERVISOR_FIRST_WINDOW_TIMEOUT_MS  30000
+#define SUPERVISOR_FIRST_WINDOW_INTERVAL_MS 50
+#define SUPERVISOR_SAMPLE_INTERVAL_MS       1000
+
+#define STARTUP_SHELL                       "/bin/sh"
+#define CGROUP2_FOLDER                      "/sys/fs/cgroup"
+#define STARTUP_CGROUP_NAME                 "settings-startup"
+#define PROC_NET_UNIX_FILE                  "/proc/net/unix"
+
+using namespace std;
+
+struct RestartPolicy
+{
+    bool isAutoRestart;
+    int initialBackoffMs;
+    int maxBackoffMs;
+    int stableRunMs;
+    int crashLoopCount;
+    int crashLoopWindowMs;
+};
+
+RestartPolicy make_restart_policy(bool isAutoRestart);
+
+// restart delays and crash loop state, times are passed in so the clock can be simulated
+class RestartTracker
+{
+public:
+    explicit RestartTracker(const RestartPolicy &policy);
+    // delay before the next start after an exit at nowMs of a run of runMs, -1 to stop
+    int on_exit(double nowMs, double runMs);
+    bool is_crash_loop();
+
+private:
+    RestartPolicy m_policy;
+    int m_backoffMs;
+    deque<double> m_exitTimes;
+    bool m_isCrashLoop;
+};
+
+// one run of the startup application
+struct LaunchRecord
+{
+    int attempt;
+    int pid;
+    // first connection to the compositor or xwayland, the earliest it can show a window. -1 when none
+    double firstWindowMs;
+    double runMs;
+    // exit code, or 128 + signal like the shell
+    int exitStatus;
+    // -1 without cgroup v2
+    long long memoryPeakBytes;
+    long long cpuUsec;
+};
+
+string format_launch_record(const LaunchRecord &record);
+
+// runs the command under /bin/sh, tracked by pidfd and a cgroup v2 of its own where available.
+// the cgroup also keeps track of what a start script leaves running in the background
+class StartupSupervisor
+{
+public:
+    explicit StartupSupervisor(const string& command, const RestartPolicy &policy,
+                               const vector<string>& displaySockets,
+                               const char* cgroupFolder = CGROUP2_FOLDER,
+                               const char* netUnixFile = PROC_NET_UNIX_FILE);
+    // returns when the application is gone for good, with the exit status of the last run
+    int run();
+    vector<LaunchRecord> get_records();
+
+private:
+    LaunchRecord _launch(int attempt);
+    bool _prepare_cgroup();
+    // processes left in the cgroup from a run before
+    void _kill_cgroup();
+    bool _is_cgroup_populated();
+    long long _read_cgroup_value(const char* file, const char* key);
+    // connected sockets of the display servers in /proc/net/unix
+    int _count_display_connections();
+
+    string m_command;
+    RestartPolicy m_policy;
+    vector<string> m_displaySockets;
+    string m_cgroupFolder;
+    string m_cgroup;
+    string m_netUnixFile;
+    bool m_hasCgroup;
+    vector<LaunchRecord> m_records;
+};
+#endif // STARTUP_SUPERVISOR_H
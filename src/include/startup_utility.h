@@ -85,4 +85,7 @@ public:
     ~StartupNone();
 };
 
+// subclass of the startup name, StartupNone for an unknown name. caller deletes it
+StartupApplication* create_startup_application(const char* name);
+
 #endif // STARTUP_UTILITY_H
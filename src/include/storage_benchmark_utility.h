@@ -0,0 +1,101 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef STORAGE_BENCHMARK_UTILITY_H
+#define STORAGE_BENCHMARK_UTILITY_H
+
+#include <string>
+#include <vector>
+
+#include "utility.h"
+
+#define BENCHMARK_FILE_PREFIX           ".settings_benchmark_"
+#define BENCHMARK_JSON_FILE_NAME        "storage_benchmark.json"
+#define BENCHMARK_DEFAULT_FILE_SIZE_MB  64
+#define BENCHMARK_MAX_FILE_SIZE_MB      1024
+#define BENCHMARK_DEFAULT_QUEUE_DEPTH   1
+#define BENCHMARK_MAX_QUEUE_DEPTH       32
+#define BENCHMARK_SEQ_BLOCK_SIZE        (1024 * 1024)
+#define BENCHMARK_RANDOM_BLOCK_SIZE     4096
+// O_DIRECT needs buffer, offset and length aligned to logical block size
+#define BENCHMARK_ALIGNMENT             4096
+// random tests stop on whichever comes first
+#define BENCHMARK_RANDOM_MAX_OPS        4096
+#define BENCHMARK_RANDOM_MAX_SECONDS    10
+
+#define BENCHMARK_ENGINE_AIO            "aio"
+#define BENCHMARK_ENGINE_SYNC           "psync"
+
+using namespace std;
+
+enum class BenchmarkType {
+    SEQ_WRITE, SEQ_READ, RANDOM_WRITE, RANDOM_READ
+};
+
+class BenchmarkResult
+{
+public:
+    BenchmarkResult();
+    void setType(BenchmarkType type);
+    void setBlockSize(int blockSize);
+    void setQueueDepth(int queueDepth);
+    void setEngine(const string& engine);
+    void setDirect(bool isDirect);
+    void setSeconds(double seconds);
+    // latencies in microseconds, one per completed request
+    void setLatencies(vector<double> &latencies);
+    BenchmarkType getType();
+    string getName();
+    int getBlockSize();
+    int getQueueDepth();
+    string getEngine();
+    bool getDirect();
+    int getOps();
+    unsigned long long getBytes();
+    double getSeconds();
+    double getThroughput();
+    double getIOPS();
+    double getLatencyPercentile(double percentile);
+    double getLatencyMax();
+    string toString();
+    string toJson();
+
+private:
+    BenchmarkType m_type;
+    int m_block_size;
+    int m_queue_depth;
+    string m_engine;
+    bool m_direct;
+    double m_seconds;
+    // sorted
+    vector<double> m_latencies;
+};
+
+class IStorageBenchmarkUtility {
+public:
+    virtual ~IStorageBenchmarkUtility() {}
+    // sequential and 4K random write/read on a temp file under folder, isCancelled is checked between requests
+    virtual pair<vector<BenchmarkResult>, bool> run_benchmark(const char* folder, int fileSizeMB, int queueDepth,
+                                                              CancelCheckFunc isCancelled = nullptr) = 0;
+    virtual bool export_json(vector<BenchmarkResult> &results, const char* device, const char* filePath) = 0;
+};
+
+class TPCStorageBenchmarkUtility: public IStorageBenchmarkUtility {
+public:
+    pair<vector<BenchmarkResult>, bool> run_benchmark(const char* folder, int fileSizeMB, int queueDepth,
+                                                      CancelCheckFunc isCancelled = nullptr) override;
+    bool export_json(vector<BenchmarkResult> &results, const char* device, const char* filePath) override;
+
+private:
+    int _open_temp_file(const char* folder, bool *isDirect);
+    vector<unsigned long long> _make_offsets(BenchmarkType type, unsigned long long fileSize);
+    pair<BenchmarkResult, bool> _run_test(int fd, BenchmarkType type, unsigned long long fileSize,
+                                          int queueDepth, bool isDirect, const CancelCheckFunc &isCancelled);
+    // maxSeconds 0 means running all offsets
+    bool _run_sync(int fd, bool isWrite, int blockSize, vector<unsigned long long> &offsets,
+                   char *buffer, int maxSeconds, vector<double> &latencies, const CancelCheckFunc &isCancelled);
+    bool _run_aio(int fd, bool isWrite, int blockSize, int queueDepth, vector<unsigned long long> &offsets,
+                  char *buffers, int maxSeconds, vector<double> &latencies, const CancelCheckFunc &isCancelled);
+};
+
+#endif // STORAGE_BENCHMARK_UTILITY_H
@@ -0,0 +1,93 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef STORAGE_TELEMETRY_H
+#define STORAGE_TELEMETRY_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "storage_utility.h"
+
+#define STORAGE_TELEMETRY_INTERVAL_MS   1000
+// 2 minutes history at 1 second interval
+#define STORAGE_TELEMETRY_CAPACITY      120
+// health attributes change slowly, re-read every N samples
+#define STORAGE_HEALTH_SAMPLE_INTERVAL  60
+
+using namespace std;
+
+class StorageTelemetrySample
+{
+public:
+    StorageTelemetrySample();
+    void setTime(double time);
+    void setReadIOPS(double readIOPS);
+    void setWriteIOPS(double writeIOPS);
+    void setReadBytesPerSecond(double readBytes);
+    void setWriteBytesPerSecond(double writeBytes);
+    void setUtilization(double utilization);
+    double getTime();
+    double getReadIOPS();
+    double getWriteIOPS();
+    double getReadBytesPerSecond();
+    double getWriteBytesPerSecond();
+    // percentage of time the device was busy, 0-100
+    double getUtilization();
+    string toString();
+
+private:
+    double m_time;
+    double m_read_iops;
+    double m_write_iops;
+    double m_read_bytes;
+    double m_write_bytes;
+    double m_utilization;
+};
+
+// fixed size history, oldest sample is overwritten
+class StorageTelemetryRing
+{
+public:
+    explicit StorageTelemetryRing(size_t capacity = STORAGE_TELEMETRY_CAPACITY);
+    void push(const StorageTelemetrySample &sample);
+    void clear();
+    size_t size();
+    size_t capacity();
+    // index 0 is the oldest sample
+    StorageTelemetrySample at(size_t index);
+    StorageTelemetrySample latest();
+
+private:
+    vector<StorageTelemetrySample> m_samples;
+    size_t m_head;
+    size_t m_size;
+};
+
+// turns /sys/block/<device>/stat counters into rates, time is injectable for running against a fake tree
+class StorageTelemetrySampler
+{
+public:
+    explicit StorageTelemetrySampler(IStorageUtility *storageUtil, size_t capacity = STORAGE_TELEMETRY_CAPACITY);
+    void add_device(const char* device_name);
+    // sample all devices with monotonic clock
+    void sample();
+    void sample(double now);
+    pair<StorageTelemetryRing, bool> get_samples(const char* device_name);
+    pair<EMMCHealthData, bool> get_health(const char* device_name);
+
+private:
+    void _sample_device(const string& device, double now);
+
+    IStorageUtility *m_storageUtil;
+    size_t m_capacity;
+    int m_sampleCount;
+    vector<string> m_devices;
+    map<string, BlockDeviceStat> m_lastStats;
+    map<string, double> m_lastTimes;
+    map<string, StorageTelemetryRing> m_rings;
+    map<string, pair<EMMCHealthData, bool>> m_healths;
+};
+
+#endif // STORAGE_TELEMETRY_H
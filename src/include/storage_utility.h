@@ -6,9 +6,28 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 #define STORAGE_LABEL        "userdata"
 
+#define STORAGE_NAME_SD_CARD "mmcblk1"
+#define STORAGE_NAME_EMMC    "mmcblk2"
+
+#define SYS_BLOCK_FOLDER     "/sys/block"
+#define PROC_MOUNTINFO_FILE  "/proc/self/mountinfo"
+#define DEV_DISK_FOLDER      "/dev/disk"
+#define SECTOR_SIZE          512
+
+// eMMC 5.0 EXT_CSD DEVICE_LIFE_TIME_EST_TYP_A/B, in 10% steps
+#define EMMC_LIFE_TIME_UNDEFINED  0x00
+#define EMMC_LIFE_TIME_WARNING    0x09
+#define EMMC_LIFE_TIME_EXCEEDED   0x0B
+// eMMC 5.0 EXT_CSD PRE_EOL_INFO, reserved blocks consumption
+#define EMMC_PRE_EOL_UNDEFINED    0x00
+#define EMMC_PRE_EOL_NORMAL       0x01
+#define EMMC_PRE_EOL_WARNING      0x02
+#define EMMC_PRE_EOL_URGENT       0x03
+
 using namespace std;
 
 class BlockDeviceData
@@ -16,38 +35,135 @@ class BlockDeviceData
 public:
     BlockDeviceData();
     void setName(const string& name);
-    void setSize(const string& size);
+    void setDevNumber(const string& devNumber);
+    void setSizeBytes(unsigned long long sizeBytes);
+    void setStartSector(unsigned long long startSector);
+    void setReadOnly(bool readOnly);
     void setFSType(const string& fstype);
     void setLabel(const string& label);
     void setUUID(const string& uuid);
     void setMountPoint(const string& mountpoint);
     string getName();
+    string getDevNumber();
+    unsigned long long getSizeBytes();
+    unsigned long long getStartSector();
+    bool getReadOnly();
     string getSize();
     string getFSType();
     string getLabel();
     string getUUID();
     string getMountPoint();
 
-    // usage
-    void setAvailable(const string& avail);
-    void setUsed(const string& used);
-    void setUsedPercent(const string& used_percent);
+    // usage, only valid for mounted partition
+    void setTotalBytes(unsigned long long totalBytes);
+    void setAvailableBytes(unsigned long long availBytes);
+    void setUsedBytes(unsigned long long usedBytes);
+    unsigned long long getTotalBytes();
+    unsigned long long getAvailableBytes();
+    unsigned long long getUsedBytes();
+    int getUsedPercentValue();
     string getAvailable();
     string getUsed();
     string getUsedPercent();
 
 private:
     string m_name;
-    string m_size;
+    string m_dev_number;
+    unsigned long long m_size_bytes;
+    unsigned long long m_start_sector;
+    bool m_read_only;
     string m_fstype;
     string m_label;
     string m_uuid;
     string m_mount_point;
 
     // usage
-    string m_avail;
-    string m_used;
-    string m_used_percent;
+    unsigned long long m_total_bytes;
+    unsigned long long m_avail_bytes;
+    unsigned long long m_used_bytes;
+};
+
+// counters of /sys/block/<device>/stat, sectors are always 512 bytes
+class BlockDeviceStat
+{
+public:
+    BlockDeviceStat();
+    void setReadIOs(unsigned long long readIOs);
+    void setReadSectors(unsigned long long readSectors);
+    void setWriteIOs(unsigned long long writeIOs);
+    void setWriteSectors(unsigned long long writeSectors);
+    void setIOTicks(unsigned long long ioTicks);
+    unsigned long long getReadIOs();
+    unsigned long long getReadSectors();
+    unsigned long long getWriteIOs();
+    unsigned long long getWriteSectors();
+    // milliseconds the device had I/O in flight
+    unsigned long long getIOTicks();
+
+private:
+    unsigned long long m_read_ios;
+    unsigned long long m_read_sectors;
+    unsigned long long m_write_ios;
+    unsigned long long m_write_sectors;
+    unsigned long long m_io_ticks;
+};
+
+// eMMC health from device/life_time and device/pre_eol_info
+class EMMCHealthData
+{
+public:
+    EMMCHealthData();
+    void setLifeTimeA(int lifeTime);
+    void setLifeTimeB(int lifeTime);
+    void setPreEOL(int preEOL);
+    int getLifeTimeA();
+    int getLifeTimeB();
+    int getPreEOL();
+    // ex: 10%-20%
+    string getLifeTimeAString();
+    string getLifeTimeBString();
+    string getPreEOLString();
+    bool isWarning();
+    string toString();
+
+private:
+    string _life_time_to_string(int lifeTime);
+    int m_life_time_a;
+    int m_life_time_b;
+    int m_pre_eol;
+};
+
+// format bytes like lsblk/df -h, ex: 14.7G, 580M
+string format_size(unsigned long long bytes);
+
+// reads block devices from sysfs, mountinfo and statvfs without spawning processes
+// roots are injectable so it can run against a fake tree
+class BlockDeviceEnumerator
+{
+public:
+    BlockDeviceEnumerator(const char* sysBlockFolder = SYS_BLOCK_FOLDER,
+                          const char* mountInfoFile = PROC_MOUNTINFO_FILE,
+                          const char* devDiskFolder = DEV_DISK_FOLDER);
+    bool is_device_exist(const char* device_name);
+    pair<unsigned long long, bool> get_device_size(const char* device_name);
+    pair<vector<string>, bool> get_device_part_names(const char* device_name);
+    pair<vector<BlockDeviceData>, bool> get_device_parts(const char* device_name);
+    pair<BlockDeviceData, bool> get_device_part(const char* device_name, const char* partition_name);
+    pair<BlockDeviceStat, bool> get_device_stat(const char* device_name);
+    pair<EMMCHealthData, bool> get_emmc_health(const char* device_name);
+
+private:
+    bool _read_sysfs_value(const string& path, string &value);
+    unsigned long long _read_sysfs_number(const string& path);
+    map<string, pair<string, string>> _load_mount_info();
+    map<string, string> _load_disk_links(const char* type);
+    void _fill_partition(BlockDeviceData &deviceData, const string& folder,
+                         const map<string, pair<string, string>> &mounts,
+                         const map<string, string> &labels, const map<string, string> &uuids);
+
+    string m_sysBlockFolder;
+    string m_mountInfoFile;
+    string m_devDiskFolder;
 };
 
 class IStorageUtility {
@@ -57,30 +173,30 @@ public:
     virtual pair<string, bool> get_sd_card_size() = 0;
     virtual pair<vector<BlockDeviceData>, bool> get_emmc_parts() = 0;
     virtual pair<vector<BlockDeviceData>, bool> get_sd_card_parts() = 0;
-
-    pair<string, bool> get_partition_fs_all(const string& disk);
-    pair<string, bool> get_partition_block(const string& disk);
-
-    pair<string, bool> get_partition_size(const string& disk, const string& partition);
-    pair<string, bool> get_partition_fstype(const string& disk, const string& partition);
-    pair<string, bool> get_partition_label(const string& disk, const string& partition);
-    pair<string, bool> get_partition_uuid(const string& disk, const string& partition);
-    pair<string, bool> get_partition_mount_point(const string& disk, const string& partition);
-    pair<string, bool> get_partition_available(const string& disk, const string& partition);
-    pair<string, bool> get_partition_used_percent(const string& partition, const string& mount_point);
-    pair<string, bool> get_partition_used(const string& partition, const string& mount_point);
-
-    bool _is_device_exist(const char *device);
-    pair<vector<BlockDeviceData>, bool> _get_device_parts(const char* device_name);
-    pair<string, bool> _get_device_info(const char* cmd, const char* disk);
+    virtual pair<string, bool> get_device_size(const char* device_name) = 0;
+    virtual pair<vector<BlockDeviceData>, bool> get_device_parts(const char* device_name) = 0;
+    virtual pair<BlockDeviceData, bool> get_device_part(const char* device_name, const char* partition_name) = 0;
+    virtual pair<BlockDeviceStat, bool> get_device_stat(const char* device_name) = 0;
+    virtual pair<EMMCHealthData, bool> get_emmc_health(const char* device_name) = 0;
 };
 
 class TPCStorageUtility: public IStorageUtility {
 public:
+    TPCStorageUtility(const char* sysBlockFolder = SYS_BLOCK_FOLDER,
+                      const char* mountInfoFile = PROC_MOUNTINFO_FILE,
+                      const char* devDiskFolder = DEV_DISK_FOLDER);
     pair<string, bool> get_emmc_size() override;
     pair<string, bool> get_sd_card_size() override;
     pair<vector<BlockDeviceData>, bool> get_emmc_parts() override;
     pair<vector<BlockDeviceData>, bool> get_sd_card_parts() override;
+    pair<string, bool> get_device_size(const char* device_name) override;
+    pair<vector<BlockDeviceData>, bool> get_device_parts(const char* device_name) override;
+    pair<BlockDeviceData, bool> get_device_part(const char* device_name, const char* partition_name) override;
+    pair<BlockDeviceStat, bool> get_device_stat(const char* device_name) override;
+    pair<EMMCHealthData, bool> get_emmc_health(const char* device_name) override;
+
+private:
+    BlockDeviceEnumerator m_enumerator;
 };
 
 #endif // STORAGE_UTILITY_H
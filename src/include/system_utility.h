@@ -6,6 +6,11 @@
 
 #include <string>
 
+#include "serial_utility.h"
+#include "usb_policy.h"
+#include "reboot_schedule.h"
+#include "boot_environment.h"
+
 #define COM1_NAME "com1"
 #define COM2_NAME "com2"
 
@@ -13,6 +18,10 @@
 
 using namespace std;
 
+class IServiceManager;
+class IProcessUtility;
+class IUsbPolicyUtility;
+
 class ISystemUtility {
 public:
     virtual ~ISystemUtility() {}
@@ -25,13 +34,20 @@ public:
     virtual bool set_readonly_mode(const bool readonly) = 0;
     virtual bool set_system_user_login_desktop(bool isUserLogin, bool isReboot) = 0;
     virtual bool set_usb_enable(const bool enabled) = 0;
-    virtual bool set_reboot_system_crontab(bool enabled, const char* mode, 
-                                            int minute, int hour, int dayofweek) = 0;
-    virtual bool set_boot_logo_background_color(const char* color) = 0;
+    // hex class codes and port names separated by space, applied with the next set_usb_enable
+    virtual void set_usb_blocked_devices(const char* classes, const char* ports) = 0;
+    // crond is restarted only when the crontab file changed
+    virtual bool set_reboot_system_crontab(bool enabled, const RebootSchedule &schedule) = 0;
 
     virtual bool do_restart_crond_service() = 0;
     virtual bool do_init_ethernet() = 0;
     virtual bool do_init_com_port() = 0;
+    // usb uevent name of an added device or interface
+    virtual bool do_apply_usb_device_policy(const char* name) = 0;
+    virtual pair<SerialPortConfig, bool> get_com_port(const char* com) = 0;
+    virtual bool set_com_port(const char* com, const SerialPortConfig &config) = 0;
+    // needs RX and TX of the port wired together
+    virtual pair<SerialBenchmarkResult, bool> run_com_port_benchmark(const char* com, CancelCheckFunc isCancelled = nullptr) = 0;
     virtual bool do_reboot() = 0;
     virtual bool do_shutdown() = 0;
     virtual bool open_terminal() = 0;
@@ -40,6 +56,10 @@ public:
 
 class TPCSystemUtility: public ISystemUtility {
 public:
+    explicit TPCSystemUtility(IServiceManager *serviceManager = nullptr, IProcessUtility *processUtil = nullptr,
+                              const char* com1Device = COM1_DEVICE, const char* com2Device = COM2_DEVICE,
+                              IUsbPolicyUtility *usbPolicyUtil = nullptr);
+    ~TPCSystemUtility();
     bool is_boot_from_sd_card() override;
     bool get_readonly_mode() override;
     bool get_system_user_login_desktop() override;
@@ -49,22 +69,39 @@ public:
     bool set_readonly_mode(const bool readonly) override;
     bool set_system_user_login_desktop(bool isUserLogin, bool isReboot) override;
     bool set_usb_enable(const bool enabled) override;
-    bool set_reboot_system_crontab(bool enabled, const char* mode, 
-                                    int minute, int hour, int dayofweek) override;
-    bool set_boot_logo_background_color(const char* color) override;
+    void set_usb_blocked_devices(const char* classes, const char* ports) override;
+    bool set_reboot_system_crontab(bool enabled, const RebootSchedule &schedule) override;
 
     bool do_restart_crond_service() override;
     bool do_init_ethernet() override;
     bool do_init_com_port() override;
+    bool do_apply_usb_device_policy(const char* name) override;
+    pair<SerialPortConfig, bool> get_com_port(const char* com) override;
+    bool set_com_port(const char* com, const SerialPortConfig &config) override;
+    pair<SerialBenchmarkResult, bool> run_com_port_benchmark(const char* com, CancelCheckFunc isCancelled = nullptr) override;
     bool do_reboot() override;
     bool do_shutdown() override;
     bool open_terminal() override;
     bool open_license_page() override;
 
 private:
-    pair<string, bool> _get_com_mode(const char* com);
-    pair<string, bool> _get_com_baudrate(const char* com);
-    bool _set_com_mode(const char* com, const char* mode);
-    bool _set_com_baudrate(const char* com, const char* baudrate);
+    // opened for read and write without becoming the controlling tty, -1 on failure
+    int _open_com_port(const char* com);
+    bool _is_weston_running_as(const char* user);
+
+    // shared systemd1 client, created here when none is given
+    IServiceManager *m_serviceManager;
+    bool m_isServiceManagerOwned;
+    // shared process snapshot, created here when none is given
+    IProcessUtility *m_processUtil;
+    bool m_isProcessUtilOwned;
+    string m_com1Device;
+    string m_com2Device;
+    // sysfs authorization, created here when none is given
+    IUsbPolicyUtility *m_usbPolicyUtil;
+    bool m_isUsbPolicyUtilOwned;
+    UsbPolicy m_usbPolicy;
+    // cmdline and mountinfo parsed once, read-only mode set but not booted into yet
+    BootEnvironmentProbe m_bootEnvironment;
 };
 #endif // SYSTEM_UTILITY_H
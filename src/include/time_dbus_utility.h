@@ -0,0 +1,108 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef TIME_DBUS_UTILITY_H
+#define TIME_DBUS_UTILITY_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <QObject>
+#include <QVariantMap>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QDBusConnection>
+
+#include "time_utility.h"
+#include "time_sync_monitor.h"
+#include "service_manager.h"
+
+#define TIMEDATE1_SERVICE           "org.freedesktop.timedate1"
+#define TIMEDATE1_PATH              "/org/freedesktop/timedate1"
+#define TIMEDATE1_INTERFACE         "org.freedesktop.timedate1"
+#define TIMESYNC1_SERVICE           "org.freedesktop.timesync1"
+#define TIMESYNC1_PATH              "/org/freedesktop/timesync1"
+#define TIMESYNC1_INTERFACE         "org.freedesktop.timesync1.Manager"
+#define DBUS_PROPERTIES_INTERFACE   "org.freedesktop.DBus.Properties"
+#define TIMEDATE1_CALL_TIMEOUT_MS   5000
+// getters called back to back share one GetAll
+#define TIMEDATE1_CACHE_MS          1000
+
+using namespace std;
+
+// quits a local event loop once timedated reports NTP changed,
+// timedated emits it when the SetNTP unit job is finished
+class TimedatePropertiesWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TimedatePropertiesWatcher(QObject *parent = nullptr);
+
+public slots:
+    void propertiesChanged(QString interface, QVariantMap changed, QStringList invalidated);
+
+signals:
+    void ntpChanged();
+};
+
+// forwards every timesync1 NTPMessage to the monitor, timesyncd emits it after each poll
+class NTPMessageWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit NTPMessageWatcher(TimeSyncMonitor *monitor, const QDBusConnection &bus = QDBusConnection::systemBus(),
+                               QObject *parent = nullptr);
+    ~NTPMessageWatcher();
+    // subscribe and read the current message, false when timesyncd is not on the bus
+    bool start();
+    void stop();
+
+public slots:
+    void propertiesChanged(QString interface, QVariantMap changed, QStringList invalidated);
+
+signals:
+    void ntpMessageReceived();
+
+private:
+    bool _read_ntp_message();
+    bool _add_ntp_message(const QVariant &value);
+
+    TimeSyncMonitor *m_monitor;
+    QDBusConnection m_bus;
+    bool m_isStarted;
+};
+
+// ITimeUtility on org.freedesktop.timedate1, the bus is injectable so it can run against a mock service
+class TPCTimeDBusUtility: public ITimeUtility {
+public:
+    explicit TPCTimeDBusUtility(const QDBusConnection &bus = QDBusConnection::systemBus());
+    pair<vector<string>, bool> get_timezones() override;
+    pair<string, bool> get_current_timezone() override;
+    pair<string, bool> get_current_date() override;
+    pair<string, bool> get_current_time() override;
+    pair<string, bool> get_ntp_server() override;
+    pair<bool, bool> get_ntp_enabled() override;
+    pair<string, bool> set_timezone(const char* timezone) override;
+    pair<string, bool> set_manual_date_time(const char* datetime) override;
+    pair<string, bool> set_sync_with_ntp_server(bool enabled, const char* ntpServer) override;
+
+private:
+    pair<QVariantMap, bool> _get_properties();
+    void _invalidate_properties();
+    pair<QString, bool> _format_local_time(const char* format);
+    pair<string, bool> _call_timedate(const char* method, const QList<QVariant> &arguments);
+    pair<string, bool> _set_ntp(bool enabled);
+    bool _write_ntp_server(const char* ntpServer);
+
+    QDBusConnection m_bus;
+    // same bus, timesyncd restart goes through systemd1
+    TPCServiceManager m_serviceManager;
+    std::mutex m_propertiesMutex;
+    QVariantMap m_properties;
+    QElapsedTimer m_propertiesTimer;
+    // list-timezones fallback for timedated without ListTimezones
+    TPCTimeUtility m_commandUtil;
+};
+#endif // TIME_DBUS_UTILITY_H
@@ -0,0 +1,143 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef TIME_SYNC_MONITOR_H
+#define TIME_SYNC_MONITOR_H
+
+#include <string>
+#include <vector>
+#include <deque>
+
+#define TIME_SYNC_INTERVAL_MS       2000
+// 5 minutes history at 2 seconds interval
+#define TIME_SYNC_CAPACITY          150
+// successive offset differences in the jitter estimate
+#define TIME_SYNC_JITTER_WINDOW     8
+// twice the longest timesyncd poll interval, older measurements mean ntp has stopped
+#define TIME_SYNC_NTP_MAX_AGE       4096
+
+using namespace std;
+
+// kernel clock discipline state from adjtimex
+struct KernelClockState
+{
+    // remaining offset the kernel is slewing away
+    long long offsetNs;
+    double frequencyPpm;
+    long long maxErrorUs;
+    long long estErrorUs;
+    int status;
+    bool isSynchronized;
+};
+
+// timesync1 NTPMessage, timestamps are CLOCK_REALTIME microseconds
+struct NTPMessageData
+{
+    unsigned int leap;
+    unsigned int stratum;
+    unsigned long long rootDelayUs;
+    unsigned long long rootDispersionUs;
+    unsigned long long originUs;
+    unsigned long long receiveUs;
+    unsigned long long transmitUs;
+    unsigned long long destinationUs;
+    bool isSpike;
+    unsigned long long packetCount;
+    unsigned long long jitterUs;
+};
+
+// server clock minus local clock, ((t2 - t1) + (t3 - t4)) / 2
+double get_ntp_offset_ms(const NTPMessageData &message);
+// round trip without the server processing time
+double get_ntp_delay_ms(const NTPMessageData &message);
+
+class TimeSyncSample
+{
+public:
+    TimeSyncSample();
+    void setTime(double time);
+    void setOffset(double offset);
+    void setJitter(double jitter);
+    void setFrequency(double frequency);
+    void setMaxError(double maxError);
+    void setSynchronized(bool isSynchronized);
+    void setFromNTP(bool isFromNTP);
+    double getTime();
+    // milliseconds, measured against the server when isFromNTP else the kernel residual
+    double getOffset();
+    double getJitter();
+    // ppm
+    double getFrequency();
+    double getMaxError();
+    bool isSynchronized();
+    bool isFromNTP();
+
+private:
+    double m_time;
+    double m_offset;
+    double m_jitter;
+    double m_frequency;
+    double m_max_error;
+    bool m_synchronized;
+    bool m_from_ntp;
+};
+
+// fixed size history, oldest sample is overwritten
+class TimeSyncRing
+{
+public:
+    explicit TimeSyncRing(size_t capacity = TIME_SYNC_CAPACITY);
+    void push(const TimeSyncSample &sample);
+    void clear();
+    size_t size();
+    size_t capacity();
+    // index 0 is the oldest sample
+    TimeSyncSample at(size_t index);
+    TimeSyncSample latest();
+
+private:
+    vector<TimeSyncSample> m_samples;
+    size_t m_head;
+    size_t m_size;
+};
+
+class ITimeSyncClockSource {
+public:
+    virtual ~ITimeSyncClockSource() {}
+    virtual bool read_kernel_clock(KernelClockState &state) = 0;
+    // monotonic seconds
+    virtual double now() = 0;
+};
+
+class TPCTimeSyncClockSource: public ITimeSyncClockSource {
+public:
+    bool read_kernel_clock(KernelClockState &state) override;
+    double now() override;
+};
+
+// kernel clock is sampled on a timer, ntp measurements are pushed as timesyncd reports them
+class TimeSyncMonitor
+{
+public:
+    explicit TimeSyncMonitor(ITimeSyncClockSource *clockSource, size_t capacity = TIME_SYNC_CAPACITY);
+    void sample();
+    // same packet reported again is ignored
+    void add_ntp_message(const NTPMessageData &message);
+    TimeSyncRing get_samples();
+    pair<KernelClockState, bool> get_kernel_state();
+    pair<NTPMessageData, bool> get_ntp_message();
+    string get_summary();
+
+private:
+    double _get_jitter(const deque<double> &offsets);
+
+    ITimeSyncClockSource *m_clockSource;
+    TimeSyncRing m_ring;
+    pair<KernelClockState, bool> m_kernelState;
+    pair<NTPMessageData, bool> m_ntpMessage;
+    double m_ntpTime;
+    // latest offsets in milliseconds, oldest first
+    deque<double> m_kernelOffsets;
+    deque<double> m_ntpOffsets;
+};
+#endif // TIME_SYNC_MONITOR_H
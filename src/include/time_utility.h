@@ -8,6 +8,12 @@
 #include <vector>
 
 #define TIMESYNCD_SERVICE_TIMEOUT 20
+#define TIMESYNCD_SERVICE_NAME    "systemd-timesyncd.service"
+
+// Network Time Synchronization configuration files path
+#define NTP_CONF_PATH       "/etc/systemd/timesyncd.conf.d"
+#define NTP_CONF_FILENAME   "userntp.conf"
+#define NTP_CONF_TEMPLATE   "[Time]\nNTP=%s"
 
 using namespace std;
 
@@ -0,0 +1,81 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef TIMEZONE_INDEX_H
+#define TIMEZONE_INDEX_H
+
+#include <string>
+#include <vector>
+
+#define ZONEINFO_FOLDER         "/usr/share/zoneinfo"
+// largest zone in tzdata is a few kB, anything bigger is not a tzif file
+#define TZIF_MAX_FILE_SIZE      (256 * 1024)
+
+using namespace std;
+
+// local time type, offset is seconds east of UTC
+struct TimezoneType
+{
+    int offset;
+    bool isDst;
+    string abbreviation;
+};
+
+// rfc 8536 footer, ex: CST-8 or CET-1CEST,M3.5.0,M10.5.0/3
+struct PosixTimezoneRule
+{
+    // 'J' julian day 1-365 without Feb 29, 'D' zero based day of year, 'M' month.week.weekday
+    char kind;
+    int month;
+    int week;
+    int day;
+    // seconds after local midnight, may be negative or over 24 hours
+    int time;
+};
+
+struct PosixTimezone
+{
+    TimezoneType standard;
+    TimezoneType daylight;
+    bool hasDst;
+    PosixTimezoneRule start;
+    PosixTimezoneRule end;
+};
+
+struct TimezoneData
+{
+    vector<long long> transitions;
+    vector<unsigned char> transitionTypes;
+    vector<TimezoneType> types;
+    bool hasFooter;
+    PosixTimezone footer;
+};
+
+// tzif version 1 to 3, the 64 bit block is used when present
+bool parse_tzif(const string& content, TimezoneData &data);
+bool parse_posix_timezone(const string& text, PosixTimezone &timezone);
+// local time type at utc seconds since epoch
+TimezoneType get_posix_timezone_type(const PosixTimezone &timezone, long long utc);
+TimezoneType get_timezone_type(const TimezoneData &data, long long utc);
+// ex: +08:00, -03:30
+string format_utc_offset(int offset);
+
+// tzif of every zone read once, offsets are computed from memory afterwards
+class TimezoneIndex
+{
+public:
+    explicit TimezoneIndex(const char* zoneinfoFolder = ZONEINFO_FOLDER);
+    // unreadable or invalid zones are skipped, returns zones loaded
+    size_t load(const vector<string>& names);
+    size_t size() const;
+    const string& get_name(size_t index) const;
+    TimezoneType get_type(size_t index, long long utc) const;
+
+private:
+    bool _read_file(const string& path, string &content);
+
+    string m_zoneinfoFolder;
+    vector<string> m_names;
+    vector<TimezoneData> m_zones;
+};
+#endif // TIMEZONE_INDEX_H
@@ -0,0 +1,96 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef TIMEZONE_LIST_MODEL_H
+#define TIMEZONE_LIST_MODEL_H
+
+#include <string>
+#include <vector>
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+
+#include "timezone_index.h"
+#include "timezone_search_index.h"
+
+struct TimezoneListItem
+{
+    // index in TimezoneIndex
+    size_t zone;
+    TimezoneType type;
+};
+
+// timezones with their current offset for the timezone combo boxes,
+// tzdata is read once and offsets are recomputed on refresh
+class TimezoneListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum TimezoneRoles {
+        TextRole = Qt::UserRole + 1,
+        ValueRole,
+        OffsetRole,
+        IsDstRole,
+        AbbreviationRole,
+        // ex: GMT+08:00, for offset grouped sections
+        SectionRole
+    };
+    enum TimezoneSortColumn {
+        NameColumn = 0,
+        OffsetColumn
+    };
+
+    explicit TimezoneListModel(const char* zoneinfoFolder = ZONEINFO_FOLDER, QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+    // NameColumn or OffsetColumn, offset ties are ordered by name
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    bool isLoaded() const;
+    // read tzdata of names, rows keep the order of names until sorted
+    void load(const vector<string>& names);
+    // offsets at utc seconds since epoch
+    void refresh(long long utc);
+    // -1 when not found, Universal is listed as UTC
+    Q_INVOKABLE int indexOf(const QString &timezone) const;
+    Q_INVOKABLE QString valueAt(int row) const;
+
+private:
+    void _sort_items();
+
+    TimezoneIndex m_index;
+    bool m_isLoaded;
+    int m_sortColumn;
+    Qt::SortOrder m_sortOrder;
+    std::vector<TimezoneListItem> m_items;
+};
+
+// search results of TimezoneListModel ordered by offset, the filter text is
+// matched by TimezoneSearchIndex so each keystroke only flips the accepted rows
+class TimezoneFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+
+public:
+    explicit TimezoneFilterModel(const char* zoneinfoFolder = ZONEINFO_FOLDER, QObject *parent = nullptr);
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+    QString filterText() const;
+    void setFilterText(const QString &text);
+
+signals:
+    void filterTextChanged();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private slots:
+    void sourceRowsChanged();
+
+private:
+    TimezoneSearchIndex m_searchIndex;
+    QString m_filterText;
+    // by source row
+    std::vector<char> m_matched;
+};
+#endif // TIMEZONE_LIST_MODEL_H
@@ -0,0 +1,57 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef TIMEZONE_SEARCH_INDEX_H
+#define TIMEZONE_SEARCH_INDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include "timezone_index.h"
+
+// tzdata source with "L target link" lines, old names like Asia/Calcutta
+#define TZDATA_ZI_FILENAME      "tzdata.zi"
+#define ZONE_TAB_FILENAME       "zone.tab"
+#define ISO3166_TAB_FILENAME    "iso3166.tab"
+// shorter query words only match the start of a word
+#define TIMEZONE_TRIGRAM_SIZE   3
+
+using namespace std;
+
+// type-ahead search over timezone names, their link names and country names,
+// words are split at '/', '_' and '-' and compared case insensitive
+class TimezoneSearchIndex
+{
+public:
+    explicit TimezoneSearchIndex(const char* zoneinfoFolder = ZONEINFO_FOLDER);
+    // read links and countries once, missing files only mean fewer aliases
+    void load_aliases();
+    // documents are the names in the given order
+    void build(const vector<string>& names);
+    size_t size() const;
+    // every query word has to match, a short word as a word prefix and a longer one
+    // anywhere in a word. matched[i] is set for matching names, returns the count
+    size_t search(const string& query, vector<char> &matched) const;
+
+private:
+    void _load_links();
+    void _load_countries();
+    void _add_alias(const string& name, const string& alias);
+    bool _search_word(const string& word, vector<char> &matched) const;
+
+    string m_zoneinfoFolder;
+    bool m_isAliasesLoaded;
+    map<string, vector<string>> m_aliases;
+    // normalized names and aliases of each document, words separated by a space
+    vector<string> m_keys;
+    // sorted distinct (word, document) for prefix lookup
+    vector<pair<string, unsigned int>> m_words;
+    // packed trigram to sorted distinct documents
+    unordered_map<unsigned int, vector<unsigned int>> m_trigrams;
+};
+
+// lowercase ascii letters and digits, anything else becomes a single space
+string normalize_timezone_text(const string& text);
+#endif // TIMEZONE_SEARCH_INDEX_H
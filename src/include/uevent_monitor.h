@@ -0,0 +1,86 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef UEVENT_MONITOR_H
+#define UEVENT_MONITOR_H
+
+#include <QObject>
+#include <string>
+
+#define UEVENT_BUFF_SIZE        8192
+
+#define UEVENT_ACTION_ADD       "add"
+#define UEVENT_ACTION_REMOVE    "remove"
+#define UEVENT_ACTION_CHANGE    "change"
+
+#define UEVENT_SUBSYSTEM_BLOCK  "block"
+#define UEVENT_DEVTYPE_DISK     "disk"
+#define UEVENT_DEVTYPE_PARTITION "partition"
+
+#define UEVENT_SUBSYSTEM_USB    "usb"
+#define UEVENT_DEVTYPE_USB_DEVICE "usb_device"
+#define UEVENT_DEVTYPE_USB_INTERFACE "usb_interface"
+
+class QSocketNotifier;
+
+// kernel uevent message, ex:
+// add@/devices/platform/soc@0/30800000.bus/30b50000.mmc/mmc_host/mmc1/mmc1:aaaa/block/mmcblk1/mmcblk1p1\0
+// ACTION=add\0DEVPATH=/devices/.../block/mmcblk1/mmcblk1p1\0SUBSYSTEM=block\0
+// MAJOR=179\0MINOR=97\0DEVNAME=mmcblk1p1\0DEVTYPE=partition\0PARTN=1\0SEQNUM=2345\0
+class UEvent
+{
+public:
+    UEvent();
+    std::string getAction();
+    std::string getDevPath();
+    std::string getSubsystem();
+    std::string getDevName();
+    std::string getDevType();
+    // disk name of partition event, or device name itself for disk event
+    std::string getDiskName();
+    // last devpath folder, the /sys/bus/usb/devices name of usb events, ex: 1-1.2:1.0
+    std::string getKernelName();
+    bool isPartition();
+
+    static std::pair<UEvent, bool> parse(const char *buff, size_t len);
+
+private:
+    std::string m_action;
+    std::string m_devpath;
+    std::string m_subsystem;
+    std::string m_devname;
+    std::string m_devtype;
+};
+
+// listens to NETLINK_KOBJECT_UEVENT in gui thread, no udev dependency
+// also watches mount table because mount happens after add event
+class UEventMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UEventMonitor(QObject *parent = nullptr);
+    ~UEventMonitor();
+    bool start(const char *mountInfoFile);
+    void stop();
+    // handle raw message from socket, also used to inject synthetic message
+    bool handleMessage(const char *buff, size_t len);
+
+private slots:
+    void ueventSocketActivated();
+    void mountInfoActivated();
+
+private:
+    int m_ueventFd;
+    int m_mountInfoFd;
+    QSocketNotifier *m_ueventNotifier;
+    QSocketNotifier *m_mountInfoNotifier;
+
+signals:
+    // action, disk name, partition name (empty for disk event)
+    void blockDeviceChanged(QString, QString, QString);
+    // action, usb device or interface name
+    void usbDeviceChanged(QString, QString);
+    void mountTableChanged();
+};
+#endif // UEVENT_MONITOR_H
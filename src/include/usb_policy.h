@@ -0,0 +1,111 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef USB_POLICY_H
+#define USB_POLICY_H
+
+#include <string>
+#include <vector>
+#include <set>
+
+#define USB_SYSFS_FOLDER            "/sys/bus/usb/devices"
+// udev rereads its rules on change, they judge devices at boot and while this app is not running
+#define USB_POLICY_RULES_FILE       "/etc/udev/rules.d/70-settings-usb-policy.rules"
+
+// bDeviceClass 00 means every interface carries its own class
+#define USB_CLASS_PER_INTERFACE     0x00
+#define USB_CLASS_MASS_STORAGE      0x08
+#define USB_CLASS_HUB               0x09
+
+using namespace std;
+
+// one entry of /sys/bus/usb/devices, ex: usb1 (root hub), 1-1.2 (device), 1-1.2:1.0 (interface)
+struct UsbDeviceInfo
+{
+    string name;
+    bool isRootHub;
+    bool isInterface;
+    // device name for a device, the owning device name for an interface
+    string port;
+    // bDeviceClass of a device, bInterfaceClass of an interface
+    int usbClass;
+    string vendorId;
+    string productId;
+    string product;
+    bool authorized;
+};
+
+// parse "08 e0" or "08,e0", unknown words are skipped
+set<int> parse_usb_classes(const string& text);
+string format_usb_classes(const set<int> &classes);
+set<string> parse_usb_ports(const string& text);
+string format_usb_ports(const set<string> &ports);
+
+class UsbPolicy;
+
+// udev rules doing what apply_policy does, empty when the kernel defaults already allow everything
+string format_usb_udev_rules(const UsbPolicy &policy);
+
+class UsbPolicy
+{
+public:
+    UsbPolicy();
+    void setEnabled(bool enabled);
+    void setBlockedClasses(const set<int> &classes);
+    void setBlockedPorts(const set<string> &ports);
+    bool isEnabled() const;
+    set<int> getBlockedClasses() const;
+    set<string> getBlockedPorts() const;
+    // hubs are always allowed so the devices behind them can be judged,
+    // a blocked port also blocks everything behind it
+    bool isAllowed(const UsbDeviceInfo &info) const;
+    // root hub authorized_default, off whenever something may be blocked so a new
+    // device waits unauthorized until it is judged
+    bool isDeviceDefaultAuthorized() const;
+    // root hub interface_authorized_default, off when interfaces are judged by class
+    bool isInterfaceDefaultAuthorized() const;
+
+private:
+    bool m_enabled;
+    set<int> m_blocked_classes;
+    set<string> m_blocked_ports;
+};
+
+class IUsbPolicyUtility {
+public:
+    virtual ~IUsbPolicyUtility() {}
+    // devices and interfaces, root hubs first
+    virtual vector<UsbDeviceInfo> get_devices() = 0;
+    virtual pair<UsbDeviceInfo, bool> get_device(const char* name) = 0;
+    // false when any root hub does not authorize new devices
+    virtual bool get_authorized_default() = 0;
+    // root hub defaults, every present device and interface, and the udev rules that keep
+    // the policy after this app exits and across reboots
+    virtual bool apply_policy(const UsbPolicy &policy) = 0;
+    // one device or interface at hotplug, false when it is gone or could not be changed.
+    // the present interfaces of a device are judged with it
+    virtual bool apply_policy(const UsbPolicy &policy, const char* name) = 0;
+};
+
+// writes the sysfs authorized attributes and the udev rules, both are injectable for a fake tree
+class TPCUsbPolicyUtility: public IUsbPolicyUtility {
+public:
+    explicit TPCUsbPolicyUtility(const char* sysfsFolder = USB_SYSFS_FOLDER,
+                                 const char* rulesFile = USB_POLICY_RULES_FILE);
+    vector<UsbDeviceInfo> get_devices() override;
+    pair<UsbDeviceInfo, bool> get_device(const char* name) override;
+    bool get_authorized_default() override;
+    bool apply_policy(const UsbPolicy &policy) override;
+    bool apply_policy(const UsbPolicy &policy, const char* name) override;
+
+private:
+    pair<string, bool> _read_attribute(const string& name, const char* attribute);
+    bool _write_attribute(const string& name, const char* attribute, const char* value);
+    bool _set_authorized(const UsbDeviceInfo &info, bool authorized);
+    bool _set_interfaces_authorized(const UsbPolicy &policy, const string& port);
+    bool _write_rules(const UsbPolicy &policy);
+
+    string m_sysfsFolder;
+    string m_rulesFile;
+};
+#endif // USB_POLICY_H
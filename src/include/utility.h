@@ -7,6 +7,7 @@
 #include <cstdarg>
 #include <string>
 #include <vector>
+#include <functional>
 
 #define ROOT_USER "root"
 #define WESTON_USER "weston"
@@ -34,6 +35,9 @@
 #define GENERAL_SET_INI_EMPTY_VALUE_CMD "/usr/local/bin/atcc.ini -f %s -a write -s %s -k %s"
 #define GENERAL_GET_INI_VALUE_CMD "/usr/local/bin/atcc.ini -f %s -a read -s %s -k %s"
 
+// polled by long running calls between their iterations, true stops them early
+using CancelCheckFunc = std::function<bool()>;
+
 std::pair<std::string, int> execute_cmd(const char *cmd);
 std::pair<std::string, int> execute_cmd_without_read(const char *cmd);
 std::pair<std::vector<std::string>, bool> execute_cmd_get_vector(const char *cmd, ...);
@@ -46,6 +50,9 @@ bool untar_gz_to_folder(const char *gzFilename, const char *targetFolder);
 bool is_file_exist(const char *path);
 bool is_folder_exist(const char *path);
 bool write_file(const char *filename, const char *context);
+bool write_file_atomic(const char *filename, const char *context);
+// binary content, may contain '\0'
+bool write_file_atomic(const char *filename, const char *data, size_t length);
 void sys_mkdir(const char *path);
 bool sys_restore_system_user(const char *source, const char *target, const char *sysUser);
 std::pair<std::string, bool> sys_change_user_password(const char *username, const char *password);
@@ -0,0 +1,261 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/ini_document.h"
+
+#define INI_COMMENT_CHARS   "#;"
+#define INI_WHITESPACE      " \t\r"
+
+static string trim_string(const string& input)
+{
+    size_t start = input.find_first_not_of(INI_WHITESPACE);
+    if (start == string::npos)
+        return string();
+    size_t end = input.find_last_not_of(INI_WHITESPACE);
+    return input.substr(start, end - start + 1);
+}
+
+IniDocument::IniDocument()
+{
+    m_endsWithNewline = true;
+    m_loaded = false;
+    m_modified = false;
+}
+
+bool IniDocument::load(const char* path)
+{
+    // check input
+    if (!path) {
+        qDebug("missing parameter");
+        return false;
+    }
+    ifstream file(path, ios::in | ios::binary);
+    if (!file.good()) {
+        qDebug("Cannot open file for reading::%s", path);
+        m_lines.clear();
+        m_loaded = false;
+        return false;
+    }
+    stringstream content;
+    content << file.rdbuf();
+    load_from_string(content.str());
+    return true;
+}
+
+void IniDocument::load_from_string(const string& content)
+{
+    m_lines.clear();
+    // keep '\r' inside the line so crlf files round trip
+    size_t start = 0;
+    while (start < content.size())
+    {
+        size_t end = content.find('\n', start);
+        if (end == string::npos) {
+            m_lines.push_back(content.substr(start));
+            break;
+        }
+        m_lines.push_back(content.substr(start, end - start));
+        start = end + 1;
+    }
+    m_endsWithNewline = content.empty() || content.back() == '\n';
+    m_loaded = true;
+    m_modified = false;
+    m_savedContent = content;
+}
+
+string IniDocument::to_string()
+{
+    string content;
+    for (size_t i = 0; i < m_lines.size(); i++)
+    {
+        content.append(m_lines[i]);
+        if (i + 1 < m_lines.size() || m_endsWithNewline)
+            content.append("\n");
+    }
+    return content;
+}
+
+bool IniDocument::save(const char* path)
+{
+    // check input
+    if (!path) {
+        qDebug("missing parameter");
+        return false;
+    }
+    string content = to_string();
+    if (!write_file_atomic(path, content.c_str()))
+        return false;
+    m_modified = false;
+    m_savedContent = content;
+    return true;
+}
+
+bool IniDocument::is_loaded()
+{
+    return m_loaded;
+}
+
+bool IniDocument::is_modified()
+{
+    if (!m_modified)
+        return false;
+    // a value set and then set back is not a change
+    return to_string().compare(m_savedContent) != 0;
+}
+
+pair<string, bool> IniDocument::get_value(const char* section, const char* key)
+{
+    return get_value(section, nullptr, nullptr, key);
+}
+
+pair<string, bool> IniDocument::get_value(const char* section, const char* matchKey, const char* matchValue, const char* key)
+{
+    // check input
+    if (!section || !key) {
+        qDebug("missing parameter");
+        return make_pair(string(), false);
+    }
+    int sectionEnd = 0;
+    int sectionStart = _find_section(section, matchKey, matchValue, &sectionEnd);
+    if (sectionStart < 0)
+        return make_pair(string(), false);
+    int index = _find_key(sectionStart, sectionEnd, key);
+    if (index < 0)
+        return make_pair(string(), false);
+    string lineKey, lineValue;
+    _parse_key_value(m_lines[index], lineKey, lineValue);
+    return make_pair(lineValue, true);
+}
+
+bool IniDocument::set_value(const char* section, const char* key, const char* value)
+{
+    return set_value(section, nullptr, nullptr, key, value);
+}
+
+bool IniDocument::set_value(const char* section, const char* matchKey, const char* matchValue, const char* key, const char* value)
+{
+    // check input
+    if (!section || !key || !value) {
+        qDebug("missing parameter");
+        return false;
+    }
+    int sectionEnd = 0;
+    int sectionStart = _find_section(section, matchKey, matchValue, &sectionEnd);
+    if (sectionStart < 0)
+    {
+        // append new section at file end, separated by a blank line
+        if (!m_lines.empty() && !trim_string(m_lines.back()).empty())
+            m_lines.push_back("");
+        m_lines.push_back(string("[") + section + "]");
+        if (matchKey && matchValue)
+            m_lines.push_back(string(matchKey) + "=" + matchValue);
+        m_lines.push_back(string(key) + "=" + value);
+        m_endsWithNewline = true;
+        m_modified = true;
+        return true;
+    }
+    int index = _find_key(sectionStart, sectionEnd, key);
+    if (index >= 0)
+    {
+        string lineKey, lineValue;
+        _parse_key_value(m_lines[index], lineKey, lineValue);
+        if (lineValue.compare(value) == 0)
+            return true;
+        // replace value only, keep indent, spacing after '=' and line ending
+        string &line = m_lines[index];
+        size_t pos = line.find('=') + 1;
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+        {
+            pos++;
+        }
+        string lineEnding = (!line.empty() && line.back() == '\r') ? "\r" : "";
+        line = line.substr(0, pos) + value + lineEnding;
+        m_modified = true;
+        return true;
+    }
+    // insert after last non blank line of the section
+    int insertIndex = sectionEnd;
+    while (insertIndex > sectionStart + 1 && trim_string(m_lines[insertIndex - 1]).empty())
+    {
+        insertIndex--;
+    }
+    string lineEnding = (!m_lines[sectionStart].empty() && m_lines[sectionStart].back() == '\r') ? "\r" : "";
+    m_lines.insert(m_lines.begin() + insertIndex, string(key) + "=" + value + lineEnding);
+    m_modified = true;
+    return true;
+}
+
+// returns index of section header line, sectionEnd is the next header or line count
+int IniDocument::_find_section(const char* section, const char* matchKey, const char* matchValue, int *sectionEnd)
+{
+    int count = (int)m_lines.size();
+    for (int i = 0; i < count; i++)
+    {
+        string name;
+        if (!_parse_section(m_lines[i], name) || name.compare(section) != 0)
+            continue;
+        int end = i + 1;
+        while (end < count && !_parse_section(m_lines[end], name))
+        {
+            end++;
+        }
+        if (matchKey && matchValue)
+        {
+            int index = _find_key(i, end, matchKey);
+            string lineKey, lineValue;
+            if (index < 0 || !_parse_key_value(m_lines[index], lineKey, lineValue) ||
+                lineValue.compare(matchValue) != 0)
+            {
+                i = end - 1;
+                continue;
+            }
+        }
+        *sectionEnd = end;
+        return i;
+    }
+    return -1;
+}
+
+int IniDocument::_find_key(int sectionStart, int sectionEnd, const char* key)
+{
+    // last one wins when a key repeats
+    int found = -1;
+    for (int i = sectionStart + 1; i < sectionEnd; i++)
+    {
+        string lineKey, lineValue;
+        if (_parse_key_value(m_lines[i], lineKey, lineValue) && lineKey.compare(key) == 0)
+            found = i;
+    }
+    return found;
+}
+
+bool IniDocument::_parse_section(const string& line, string &section)
+{
+    string trimmed = trim_string(line);
+    if (trimmed.size() < 2 || trimmed.front() != '[')
+        return false;
+    size_t end = trimmed.find(']');
+    if (end == string::npos)
+        return false;
+    section = trim_string(trimmed.substr(1, end - 1));
+    return true;
+}
+
+bool IniDocument::_parse_key_value(const string& line, string &key, string &value)
+{
+    string trimmed = trim_string(line);
+    if (trimmed.empty() || strchr(INI_COMMENT_CHARS, trimmed.front()) || trimmed.front() == '[')
+        return false;
+    size_t pos = trimmed.find('=');
+    if (pos == string::npos)
+        return false;
+    key = trim_string(trimmed.substr(0, pos));
+    value = trim_string(trimmed.substr(pos + 1));
+    return true;
+}
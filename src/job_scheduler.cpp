@@ -0,0 +1,208 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <chrono>
+#include <algorithm>
+#include <QDebug>
+
+#include "./include/job_scheduler.h"
+
+JobToken::JobToken()
+{
+    m_isCancelled = false;
+    m_isFinished = false;
+}
+
+void JobToken::cancel()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isCancelled = true;
+    m_condition.notify_all();
+}
+
+bool JobToken::is_cancelled()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_isCancelled;
+}
+
+bool JobToken::wait_for(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return m_isCancelled; });
+    return !m_isCancelled;
+}
+
+void JobToken::set_progress(int percent, const string& text)
+{
+    PProgressFunc handler;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        handler = m_progressHandler;
+    }
+    if (handler)
+        handler(std::max(0, std::min(percent, 100)), text);
+}
+
+void JobToken::set_progress_handler(PProgressFunc handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_progressHandler = handler;
+}
+
+void JobToken::set_finished()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isFinished = true;
+    m_condition.notify_all();
+}
+
+void JobToken::wait_finished()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_isFinished; });
+}
+
+Job::Job(PBoolFunc pWorkFunction, JobPriority priority, shared_ptr<JobToken> token)
+    : m_pWorkFunction(pWorkFunction), m_priority(priority), m_token(token)
+{
+    // emitted on the worker thread, delivered on the thread of the receiver
+    m_token->set_progress_handler([this](int percent, const string& text) {
+        emit progressChanged(percent, QString::fromStdString(text));
+    });
+}
+
+Job::Job(PPairFunc pWorkFunction, JobPriority priority, shared_ptr<JobToken> token)
+    : m_pWorkPairFunction(pWorkFunction), m_priority(priority), m_token(token)
+{
+    m_token->set_progress_handler([this](int percent, const string& text) {
+        emit progressChanged(percent, QString::fromStdString(text));
+    });
+}
+
+JobPriority Job::get_priority()
+{
+    return m_priority;
+}
+
+shared_ptr<JobToken> Job::get_token()
+{
+    return m_token;
+}
+
+void Job::run()
+{
+    const bool isCancelled = m_token->is_cancelled();
+    if (m_pWorkFunction) {
+        bool result = isCancelled ? false : m_pWorkFunction();
+        emit workFinished(result);
+    }
+    else if (m_pWorkPairFunction) {
+        const auto ret = isCancelled ? make_pair(string(JOB_CANCELLED_MESSAGE), false) : m_pWorkPairFunction();
+        emit workFinishedWithResult(QString::fromStdString(ret.first), ret.second);
+    }
+    // the token may outlive the job
+    m_token->set_progress_handler(nullptr);
+    m_token->set_finished();
+}
+
+JobScheduler::JobScheduler(int workerCount)
+{
+    // one worker is kept for ui critical jobs, a single worker would have none left for background jobs
+    if (workerCount < JOB_SCHEDULER_MIN_WORKER_COUNT) {
+        qDebug("job scheduler needs %d workers at least, got %d", JOB_SCHEDULER_MIN_WORKER_COUNT, workerCount);
+        workerCount = JOB_SCHEDULER_MIN_WORKER_COUNT;
+    }
+    m_backgroundLimit = workerCount - 1;
+    m_backgroundRunning = 0;
+    m_isStopping = false;
+    for (int i = 0; i < workerCount; i++)
+    {
+        m_workers.emplace_back(&JobScheduler::_work, this);
+    }
+}
+
+JobScheduler::~JobScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+        for (auto &token : m_runningTokens)
+            token->cancel();
+        m_condition.notify_all();
+    }
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+    for (auto job : m_uiQueue)
+        delete job;
+    for (auto job : m_backgroundQueue)
+        delete job;
+}
+
+void JobScheduler::start(Job *job)
+{
+    // check input
+    if (!job) {
+        qDebug("missing parameter");
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (job->get_priority() == JobPriority::UI_CRITICAL)
+        m_uiQueue.push_back(job);
+    else
+        m_backgroundQueue.push_back(job);
+    m_condition.notify_all();
+}
+
+size_t JobScheduler::get_pending_count()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_uiQueue.size() + m_backgroundQueue.size();
+}
+
+// called with m_mutex held
+bool JobScheduler::_has_runnable_job()
+{
+    return !m_uiQueue.empty() || (!m_backgroundQueue.empty() && m_backgroundRunning < m_backgroundLimit);
+}
+
+void JobScheduler::_work()
+{
+    while (true)
+    {
+        Job *job = nullptr;
+        bool isBackground = false;
+        shared_ptr<JobToken> token;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_isStopping || _has_runnable_job(); });
+            if (m_isStopping)
+                return;
+            if (!m_uiQueue.empty()) {
+                job = m_uiQueue.front();
+                m_uiQueue.pop_front();
+            } else {
+                job = m_backgroundQueue.front();
+                m_backgroundQueue.pop_front();
+                isBackground = true;
+                m_backgroundRunning++;
+            }
+            token = job->get_token();
+            m_runningTokens.push_back(token);
+        }
+
+        job->run();
+        // queued after the finished signals, so receivers get those first
+        job->deleteLater();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runningTokens.erase(std::find(m_runningTokens.begin(), m_runningTokens.end(), token));
+        if (isBackground) {
+            m_backgroundRunning--;
+            // a background job may have waited for this slot
+            m_condition.notify_all();
+        }
+    }
+}
@@ -18,7 +18,11 @@
 #include "./include/qmlwindow.h"
 #include "./include/config_utility.h"
 #include "./include/log_utility.h"
+#include "./include/screenshot_gallery_model.h"
+#include "./include/service_manager.h"
+#include "./include/startup_launcher.h"
 
+#include <cstring>
 #include <QApplication>
 #include <QQmlApplicationEngine>
 #include <QQuickView>
@@ -33,6 +37,16 @@ int main(int argc, char *argv[])
     // install log handler
     qInstallMessageHandler(logMessageHandler);
 
+    // after boot launcher, no window and no single instance lock
+    if (argc > 1 && strcmp(argv[1], STARTUP_LAUNCHER_OPTION) == 0) {
+        // event loop for the systemd signals
+        QCoreApplication launcherApp(argc, argv);
+        ConfigUtility configUtil;
+        TPCServiceManager serviceManager;
+        StartupLauncher launcher(&configUtil, &serviceManager);
+        return launcher.run();
+    }
+
     // enables the virtual keyboard by setting the QT_IM_MODULE environment variable before loading the .qml file
     qputenv("QT_IM_MODULE", QByteArray("qtvirtualkeyboard"));
 
@@ -65,6 +79,8 @@ int main(int argc, char *argv[])
 #endif
     // set path for QQmlFileSelector
     fs.setExtraSelectors(selectors);
+    // engine takes ownership
+    engine.addImageProvider(SCREENSHOT_THUMBNAIL_PROVIDER, new ScreenshotThumbnailProvider());
     engine.load(QUrl(QStringLiteral("qrc:/qml/content/App.qml")));
     QObject *rootObject = engine.rootObjects().value(0);
 
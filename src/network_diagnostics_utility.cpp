@@ -0,0 +1,643 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <dirent.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/ip_icmp.h>
+#include <sys/socket.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/network_diagnostics_utility.h"
+
+const char* STATISTICS_RX_BYTES =   "rx_bytes";
+const char* STATISTICS_TX_BYTES =   "tx_bytes";
+const char* STATISTICS_RX_PACKETS = "rx_packets";
+const char* STATISTICS_TX_PACKETS = "tx_packets";
+const char* STATISTICS_RX_ERRORS =  "rx_errors";
+const char* STATISTICS_TX_ERRORS =  "tx_errors";
+const char* STATISTICS_RX_DROPPED = "rx_dropped";
+const char* STATISTICS_TX_DROPPED = "tx_dropped";
+
+#ifdef _WIN32
+#else
+// resolve host name or ip string to ipv4 address
+static bool resolve_ipv4(const char* host, struct sockaddr_in *sin)
+{
+    memset(sin, 0, sizeof(struct sockaddr_in));
+    sin->sin_family = AF_INET;
+    if (inet_pton(AF_INET, host, &sin->sin_addr) == 1)
+        return true;
+
+    struct addrinfo hints;
+    struct addrinfo *result = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    int ret = getaddrinfo(host, nullptr, &hints, &result);
+    if (ret != 0 || result == nullptr) {
+        qDebug("resolve %s failed: %s", host, gai_strerror(ret));
+        return false;
+    }
+    sin->sin_addr = ((struct sockaddr_in *)result->ai_addr)->sin_addr;
+    freeaddrinfo(result);
+    return true;
+}
+
+// connect of a non blocking socket, waits in slices so a cancel does not wait for the timeout
+static bool connect_cancellable(int fd, const struct sockaddr_in &target, int timeoutMs, const CancelCheckFunc &isCancelled)
+{
+    if (connect(fd, (const struct sockaddr *)&target, sizeof(target)) == 0)
+        return true;
+    if (errno != EINPROGRESS)
+        return false;
+    for (int waitMs = 0; waitMs < timeoutMs; waitMs += DIAGNOSTICS_CANCEL_INTERVAL_MS)
+    {
+        if (isCancelled && isCancelled()) {
+            errno = ECANCELED;
+            return false;
+        }
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        int ret = poll(&pfd, 1, std::min(DIAGNOSTICS_CANCEL_INTERVAL_MS, timeoutMs - waitMs));
+        if (ret < 0 && errno != EINTR)
+            return false;
+        if (ret > 0) {
+            int error = 0;
+            socklen_t len = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            errno = error;
+            return error == 0;
+        }
+    }
+    errno = ETIMEDOUT;
+    return false;
+}
+#endif
+
+static double elapsed_ms(const std::chrono::steady_clock::time_point &start)
+{
+    auto diff = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(diff).count();
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    m_sent = 0;
+    m_received = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0;
+    m_bounds = LATENCY_BUCKET_BOUNDS;
+    m_buckets.assign(m_bounds.size() + 1, 0);
+}
+
+void LatencyHistogram::addSample(double latencyMs)
+{
+    if (m_received == 0 || latencyMs < m_min)
+        m_min = latencyMs;
+    if (m_received == 0 || latencyMs > m_max)
+        m_max = latencyMs;
+    m_sent++;
+    m_received++;
+    m_sum += latencyMs;
+    size_t index = std::upper_bound(m_bounds.begin(), m_bounds.end(), latencyMs) - m_bounds.begin();
+    m_buckets[index]++;
+}
+
+void LatencyHistogram::addLost()
+{
+    m_sent++;
+}
+
+int LatencyHistogram::getSent()
+{
+    return m_sent;
+}
+
+int LatencyHistogram::getReceived()
+{
+    return m_received;
+}
+
+int LatencyHistogram::getLost()
+{
+    return m_sent - m_received;
+}
+
+double LatencyHistogram::getMin()
+{
+    return m_min;
+}
+
+double LatencyHistogram::getMax()
+{
+    return m_max;
+}
+
+double LatencyHistogram::getAverage()
+{
+    if (m_received == 0)
+        return 0;
+    return m_sum / m_received;
+}
+
+vector<int> LatencyHistogram::getBuckets()
+{
+    return m_buckets;
+}
+
+vector<string> LatencyHistogram::getBucketLabels()
+{
+    vector<string> labels;
+    vector<double> bounds = LATENCY_BUCKET_BOUNDS;
+    char buff[BUFF_SIZE] = {0};
+    for (size_t i = 0; i < bounds.size(); i++) {
+        snprintf(buff, BUFF_SIZE, "<%gms", bounds[i]);
+        labels.push_back(buff);
+    }
+    snprintf(buff, BUFF_SIZE, ">=%gms", bounds.back());
+    labels.push_back(buff);
+    return labels;
+}
+
+string LatencyHistogram::toString()
+{
+    string result;
+    char buff[BUFF_SIZE] = {0};
+    snprintf(buff, BUFF_SIZE, "sent=%d received=%d lost=%d min=%.3fms avg=%.3fms max=%.3fms\n",
+        getSent(), getReceived(), getLost(), getMin(), getAverage(), getMax());
+    result.append(buff);
+    vector<string> labels = getBucketLabels();
+    for (size_t i = 0; i < m_buckets.size(); i++) {
+        if (m_buckets[i] == 0)
+            continue;
+        snprintf(buff, BUFF_SIZE, "%8s: %d\n", labels[i].c_str(), m_buckets[i]);
+        result.append(buff);
+    }
+    return result;
+}
+
+InterfaceStatistics::InterfaceStatistics()
+{
+    m_rx_bytes = 0;
+    m_tx_bytes = 0;
+    m_rx_packets = 0;
+    m_tx_packets = 0;
+    m_rx_errors = 0;
+    m_tx_errors = 0;
+    m_rx_dropped = 0;
+    m_tx_dropped = 0;
+}
+
+void InterfaceStatistics::setName(const string& name)
+{
+    m_name = name;
+}
+
+void InterfaceStatistics::setOperState(const string& operstate)
+{
+    m_operstate = operstate;
+}
+
+void InterfaceStatistics::setRxBytes(unsigned long long value)
+{
+    m_rx_bytes = value;
+}
+
+void InterfaceStatistics::setTxBytes(unsigned long long value)
+{
+    m_tx_bytes = value;
+}
+
+void InterfaceStatistics::setRxPackets(unsigned long long value)
+{
+    m_rx_packets = value;
+}
+
+void InterfaceStatistics::setTxPackets(unsigned long long value)
+{
+    m_tx_packets = value;
+}
+
+void InterfaceStatistics::setRxErrors(unsigned long long value)
+{
+    m_rx_errors = value;
+}
+
+void InterfaceStatistics::setTxErrors(unsigned long long value)
+{
+    m_tx_errors = value;
+}
+
+void InterfaceStatistics::setRxDropped(unsigned long long value)
+{
+    m_rx_dropped = value;
+}
+
+void InterfaceStatistics::setTxDropped(unsigned long long value)
+{
+    m_tx_dropped = value;
+}
+
+string InterfaceStatistics::getName()
+{
+    return m_name;
+}
+
+string InterfaceStatistics::getOperState()
+{
+    return m_operstate;
+}
+
+unsigned long long InterfaceStatistics::getRxBytes()
+{
+    return m_rx_bytes;
+}
+
+unsigned long long InterfaceStatistics::getTxBytes()
+{
+    return m_tx_bytes;
+}
+
+unsigned long long InterfaceStatistics::getRxPackets()
+{
+    return m_rx_packets;
+}
+
+unsigned long long InterfaceStatistics::getTxPackets()
+{
+    return m_tx_packets;
+}
+
+unsigned long long InterfaceStatistics::getRxErrors()
+{
+    return m_rx_errors;
+}
+
+unsigned long long InterfaceStatistics::getTxErrors()
+{
+    return m_tx_errors;
+}
+
+unsigned long long InterfaceStatistics::getRxDropped()
+{
+    return m_rx_dropped;
+}
+
+unsigned long long InterfaceStatistics::getTxDropped()
+{
+    return m_tx_dropped;
+}
+
+string InterfaceStatistics::toString()
+{
+    char buff[BUFF_SIZE] = {0};
+    snprintf(buff, BUFF_SIZE,
+        "%s (%s)\n  RX: %llu bytes, %llu packets, %llu errors, %llu dropped\n"
+        "  TX: %llu bytes, %llu packets, %llu errors, %llu dropped\n",
+        m_name.c_str(), m_operstate.c_str(),
+        m_rx_bytes, m_rx_packets, m_rx_errors, m_rx_dropped,
+        m_tx_bytes, m_tx_packets, m_tx_errors, m_tx_dropped);
+    return buff;
+}
+
+TPCNetworkDiagnosticsUtility::TPCNetworkDiagnosticsUtility(const char* sysClassNetFolder)
+{
+    m_sysClassNetFolder = sysClassNetFolder;
+}
+
+pair<LatencyHistogram, bool> TPCNetworkDiagnosticsUtility::icmp_latency(const char* host, int count, int timeoutMs,
+                                                                        CancelCheckFunc isCancelled)
+{
+    LatencyHistogram histogram;
+    // check input
+    if (!host || count <= 0) {
+        qDebug("missing parameter");
+        return make_pair(histogram, false);
+    }
+#ifdef _WIN32
+    return make_pair(histogram, false);
+#else
+    struct sockaddr_in target;
+    if (!resolve_ipv4(host, &target))
+        return make_pair(histogram, false);
+
+    // unprivileged ping socket needs net.ipv4.ping_group_range, fallback to raw socket for root
+    bool isRaw = false;
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_ICMP);
+    if (fd < 0) {
+        fd = socket(AF_INET, SOCK_RAW | SOCK_CLOEXEC, IPPROTO_ICMP);
+        isRaw = true;
+    }
+    if (fd < 0) {
+        qDebug("create icmp socket failed: %s", strerror(errno));
+        return make_pair(histogram, false);
+    }
+
+    uint16_t identifier = (uint16_t)getpid();
+    char packet[64] = {0};
+    char reply[BUFF_SIZE] = {0};
+    count = std::min(count, DIAGNOSTICS_MAX_COUNT);
+    for (int seq = 1; seq <= count; seq++) {
+        if (isCancelled && isCancelled()) {
+            qDebug("icmp latency cancelled");
+            break;
+        }
+        struct icmphdr *request = (struct icmphdr *)packet;
+        memset(packet, 0, sizeof(packet));
+        request->type = ICMP_ECHO;
+        request->un.echo.id = htons(identifier);
+        request->un.echo.sequence = htons(seq);
+        if (isRaw) {
+            // kernel fills checksum for datagram socket only
+            uint32_t sum = 0;
+            uint16_t *words = (uint16_t *)packet;
+            for (size_t i = 0; i < sizeof(packet) / 2; i++)
+                sum += words[i];
+            sum = (sum >> 16) + (sum & 0xffff);
+            sum += (sum >> 16);
+            request->checksum = (uint16_t)~sum;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (sendto(fd, packet, sizeof(packet), 0, (struct sockaddr *)&target, sizeof(target)) < 0) {
+            qDebug("send icmp echo failed: %s", strerror(errno));
+            histogram.addLost();
+            continue;
+        }
+        bool isReceived = false;
+        double remainMs = timeoutMs;
+        while (remainMs > 0 && !isReceived) {
+            struct pollfd pfd = {fd, POLLIN, 0};
+            if (poll(&pfd, 1, (int)remainMs) <= 0)
+                break;
+            ssize_t len = recv(fd, reply, sizeof(reply), 0);
+            remainMs = timeoutMs - elapsed_ms(start);
+            if (len <= 0)
+                continue;
+            // raw socket receives ip header
+            size_t offset = 0;
+            if (isRaw)
+                offset = (reply[0] & 0x0f) * 4;
+            if ((size_t)len < offset + sizeof(struct icmphdr))
+                continue;
+            struct icmphdr *response = (struct icmphdr *)(reply + offset);
+            if (response->type != ICMP_ECHOREPLY || ntohs(response->un.echo.sequence) != seq)
+                continue;
+            if (isRaw && ntohs(response->un.echo.id) != identifier)
+                continue;
+            histogram.addSample(elapsed_ms(start));
+            isReceived = true;
+        }
+        if (!isReceived)
+            histogram.addLost();
+    }
+    close(fd);
+
+    return make_pair(histogram, histogram.getReceived() > 0);
+#endif
+}
+
+pair<LatencyHistogram, bool> TPCNetworkDiagnosticsUtility::tcp_connect_latency(const char* host, int port, int count, int timeoutMs,
+                                                                               CancelCheckFunc isCancelled)
+{
+    LatencyHistogram histogram;
+    // check input
+    if (!host || port <= 0 || count <= 0) {
+        qDebug("missing parameter");
+        return make_pair(histogram, false);
+    }
+#ifdef _WIN32
+    return make_pair(histogram, false);
+#else
+    struct sockaddr_in target;
+    if (!resolve_ipv4(host, &target))
+        return make_pair(histogram, false);
+    target.sin_port = htons(port);
+
+    count = std::min(count, DIAGNOSTICS_MAX_COUNT);
+    for (int i = 0; i < count; i++) {
+        if (isCancelled && isCancelled()) {
+            qDebug("tcp connect latency cancelled");
+            break;
+        }
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            qDebug("create tcp socket failed: %s", strerror(errno));
+            histogram.addLost();
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        bool isConnected = connect_cancellable(fd, target, timeoutMs, isCancelled);
+        if (isConnected) {
+            histogram.addSample(elapsed_ms(start));
+        } else if (errno == ECANCELED) {
+            // pending probe is not a lost one
+            qDebug("tcp connect latency cancelled");
+            close(fd);
+            break;
+        } else {
+            histogram.addLost();
+        }
+        close(fd);
+    }
+
+    return make_pair(histogram, histogram.getReceived() > 0);
+#endif
+}
+
+pair<double, bool> TPCNetworkDiagnosticsUtility::tcp_throughput(const char* host, int port, int seconds,
+                                                                CancelCheckFunc isCancelled)
+{
+    // check input
+    if (!host || port <= 0 || seconds <= 0) {
+        qDebug("missing parameter");
+        return make_pair(0, false);
+    }
+#ifdef _WIN32
+    return make_pair(0, false);
+#else
+    struct sockaddr_in target;
+    if (!resolve_ipv4(host, &target))
+        return make_pair(0, false);
+    target.sin_port = htons(port);
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        qDebug("create tcp socket failed: %s", strerror(errno));
+        return make_pair(0, false);
+    }
+    if (!connect_cancellable(fd, target, DIAGNOSTICS_CONNECT_TIMEOUT_MS, isCancelled)) {
+        qDebug("connect %s:%d failed: %s", host, port, strerror(errno));
+        close(fd);
+        return make_pair(0, false);
+    }
+    // blocking sends from here, a stalled receiver ends the test instead of hanging it
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    struct timeval sendTimeout = {DIAGNOSTICS_DEFAULT_TIMEOUT_MS / 1000, (DIAGNOSTICS_DEFAULT_TIMEOUT_MS % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+    vector<char> buff(DIAGNOSTICS_THROUGHPUT_BUFF, 0x5a);
+    unsigned long long totalBytes = 0;
+    double durationMs = seconds * 1000.0;
+    auto start = std::chrono::steady_clock::now();
+    while (elapsed_ms(start) < durationMs) {
+        if (isCancelled && isCancelled()) {
+            qDebug("tcp throughput cancelled");
+            break;
+        }
+        ssize_t len = send(fd, buff.data(), buff.size(), MSG_NOSIGNAL);
+        if (len <= 0) {
+            qDebug("send failed: %s", strerror(errno));
+            break;
+        }
+        totalBytes += len;
+    }
+    double elapsedMs = elapsed_ms(start);
+    close(fd);
+    if (totalBytes == 0 || elapsedMs <= 0)
+        return make_pair(0, false);
+
+    // megabits per second
+    double mbps = (totalBytes * 8.0) / (elapsedMs * 1000.0);
+    return make_pair(mbps, true);
+#endif
+}
+
+pair<double, bool> TPCNetworkDiagnosticsUtility::tcp_loopback_throughput(int seconds, CancelCheckFunc isCancelled)
+{
+    int port = 0;
+    int listenFd = _start_sink_server(&port);
+    if (listenFd < 0)
+        return make_pair(0, false);
+
+    std::thread sink(&TPCNetworkDiagnosticsUtility::_run_sink_server, listenFd);
+    auto result = tcp_throughput(LOOPBACK_ADDRESS, port, seconds, isCancelled);
+    // sink exits on eof, shutdown unblocks accept if client never connected
+#ifdef _WIN32
+#else
+    shutdown(listenFd, SHUT_RDWR);
+#endif
+    sink.join();
+#ifdef _WIN32
+#else
+    close(listenFd);
+#endif
+    return result;
+}
+
+pair<vector<InterfaceStatistics>, bool> TPCNetworkDiagnosticsUtility::get_interface_statistics()
+{
+    vector<InterfaceStatistics> interfaces;
+#ifdef _WIN32
+    return make_pair(interfaces, false);
+#else
+    DIR *dir = opendir(m_sysClassNetFolder.c_str());
+    if (!dir) {
+        qDebug("open %s failed: %s", m_sysClassNetFolder.c_str(), strerror(errno));
+        return make_pair(interfaces, false);
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.')
+            continue;
+        string ethernet = entry->d_name;
+        InterfaceStatistics statistics;
+        statistics.setName(ethernet);
+        char path[BUFF_SIZE] = {0};
+        char state[BUFF_SIZE] = {0};
+        snprintf(path, BUFF_SIZE, "%s/%s/operstate", m_sysClassNetFolder.c_str(), ethernet.c_str());
+        FILE *fp = fopen(path, "r");
+        if (fp) {
+            if (fscanf(fp, "%63s", state) == 1)
+                statistics.setOperState(state);
+            fclose(fp);
+        }
+        statistics.setRxBytes(_read_statistics_value(ethernet, STATISTICS_RX_BYTES));
+        statistics.setTxBytes(_read_statistics_value(ethernet, STATISTICS_TX_BYTES));
+        statistics.setRxPackets(_read_statistics_value(ethernet, STATISTICS_RX_PACKETS));
+        statistics.setTxPackets(_read_statistics_value(ethernet, STATISTICS_TX_PACKETS));
+        statistics.setRxErrors(_read_statistics_value(ethernet, STATISTICS_RX_ERRORS));
+        statistics.setTxErrors(_read_statistics_value(ethernet, STATISTICS_TX_ERRORS));
+        statistics.setRxDropped(_read_statistics_value(ethernet, STATISTICS_RX_DROPPED));
+        statistics.setTxDropped(_read_statistics_value(ethernet, STATISTICS_TX_DROPPED));
+        interfaces.push_back(statistics);
+    }
+    closedir(dir);
+    std::sort(interfaces.begin(), interfaces.end(), [](InterfaceStatistics &a, InterfaceStatistics &b) {
+        return a.getName() < b.getName();
+    });
+
+    return make_pair(interfaces, true);
+#endif
+}
+
+int TPCNetworkDiagnosticsUtility::_start_sink_server(int *port)
+{
+#ifdef _WIN32
+    return -1;
+#else
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        qDebug("create sink socket failed: %s", strerror(errno));
+        return -1;
+    }
+    // bind to ephemeral port on loopback
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(fd, 1) < 0 ||
+        getsockname(fd, (struct sockaddr *)&addr, &len) < 0) {
+        qDebug("start sink server failed: %s", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    *port = ntohs(addr.sin_port);
+    return fd;
+#endif
+}
+
+void TPCNetworkDiagnosticsUtility::_run_sink_server(int listenFd)
+{
+#ifdef _WIN32
+#else
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd >= 0) {
+        vector<char> buff(DIAGNOSTICS_THROUGHPUT_BUFF);
+        while (recv(fd, buff.data(), buff.size(), 0) > 0) {
+        }
+        close(fd);
+    }
+#endif
+}
+
+unsigned long long TPCNetworkDiagnosticsUtility::_read_statistics_value(const string& ethernet, const char* name)
+{
+    unsigned long long value = 0;
+    char path[BUFF_SIZE] = {0};
+    snprintf(path, BUFF_SIZE, "%s/%s/statistics/%s", m_sysClassNetFolder.c_str(), ethernet.c_str(), name);
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return value;
+    if (fscanf(fp, "%llu", &value) != 1)
+        value = 0;
+    fclose(fp);
+    return value;
+}
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <array>
 #include <sstream>
+#include <csignal>
 #ifdef _WIN32
 #else
 #include <unistd.h>
@@ -13,6 +14,8 @@
 
 #include "./include/utility.h"
 #include "./include/network_utility.h"
+#include "./include/service_manager.h"
+#include "./include/process_utility.h"
 
 const char* TYPE_IPV4 = "ipv4";
 const char* TYPE_IPV6 = "ipv6";
@@ -63,7 +66,6 @@ const char* SET_IP_ADDRESS_CMD =             "connmanctl config %s --%s manual %
 const char* SET_DNS_SERVER_CMD =             "connmanctl config %s --nameservers %s %s";
 const char* SET_DHCP_CMD =                   "connmanctl config %s --%s dhcp";
 const char* OPERATE_CONNMAN_ETHERNET_CMD =   "connmanctl %s ethernet > /dev/null 2>&1";
-const char *OPERATE_CONNMAN_SERVICE_CMD =    "systemctl %s connman 2>&1";
 
 const char* GET_ETH0_MAC_CMD =               "cat /sys/class/net/eth0/address | tr -d '\\n'";
 const char* GET_ETH1_MAC_CMD =               "cat /sys/class/net/eth1/address | tr -d '\\n'";
@@ -94,7 +96,7 @@ const char* PROVISIONING_SECTION_DEVICE_NAME_KEY = "DeviceName";
 
 // monitor the link state of device
 const char* IP_MONITOR_CMD =                 "/sbin/ip monitor link > %s &";
-const char* KILL_IP_MONITOR_CMD =            "ps ax | grep 'ip monitor link' | awk -F ' ' '{print $1}' | head -n -1 | xargs -r kill";
+const char* IP_MONITOR_CMDLINE =             "ip monitor link";
 const char* GET_UP_ETHERNET_CMD =            "cat %s | tail -n 2 | grep -a 'state UP' | awk -F ': ' '{print $2}' | tr -d '\\n'";
 
 // firewall related
@@ -150,6 +152,20 @@ pair<string, bool> INetworkUtility::_get_network_info(const char* cmd, const cha
         return execute_cmd_get_single_info(cmd, network, TYPE_IPV6);
 }
 
+TPCNetworkUtility::TPCNetworkUtility(IServiceManager *serviceManager, IProcessUtility *processUtil) {
+    m_isServiceManagerOwned = (serviceManager == nullptr);
+    m_serviceManager = serviceManager ? serviceManager : new TPCServiceManager();
+    m_isProcessUtilOwned = (processUtil == nullptr);
+    m_processUtil = processUtil ? processUtil : new TPCProcessUtility();
+}
+
+TPCNetworkUtility::~TPCNetworkUtility() {
+    if (m_isServiceManagerOwned)
+        delete m_serviceManager;
+    if (m_isProcessUtilOwned)
+        delete m_processUtil;
+}
+
 pair<vector<string>, bool> TPCNetworkUtility::get_available_networks() {
     return execute_cmd_get_vector(LIST_AVAILABLE_NETWORK_CMD);
 }
@@ -436,7 +452,7 @@ bool TPCNetworkUtility::disable_connman_technology_ethernet() {
 }
 
 bool TPCNetworkUtility::restart_connman_service() {
-    return execute_cmd_set_info(OPERATE_CONNMAN_SERVICE_CMD, STRING_RESTART);
+    return m_serviceManager->restart_units({CONNMAN_SERVICE_NAME});
 }
 
 bool TPCNetworkUtility::set_static_ip_address_offline(const char* ethernet, const char* ipv4, const char* ipv6, const char* subnetMask, const char* gateway) {
@@ -498,7 +514,10 @@ bool TPCNetworkUtility::start_ip_monitor() {
 }
 
 bool TPCNetworkUtility::stop_ip_monitor() {
-    return execute_cmd_set_info(KILL_IP_MONITOR_CMD);
+    const auto snapshot = m_processUtil->get_snapshot();
+    m_processUtil->signal_processes(snapshot->find_by_cmdline(IP_MONITOR_CMDLINE), SIGTERM);
+    // nothing running is fine, as xargs -r was
+    return true;
 }
 
 pair<string, bool> TPCNetworkUtility::get_up_ethernet_from_monitor_file(const char* monitorFile) {
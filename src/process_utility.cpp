@@ -0,0 +1,334 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cctype>
+#include <sstream>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pwd.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/process_utility.h"
+
+#ifdef _WIN32
+#else
+// same number on every architecture, older libc headers lack them
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#endif
+
+// fields after "(comm)", state is field 3 and starttime field 22 of proc(5)
+#define PROC_STAT_PPID_INDEX        1
+#define PROC_STAT_START_TIME_INDEX  19
+#define PROC_FILE_BUFF_SIZE         4096
+
+static bool read_proc_file(const string& path, string &text)
+{
+    text.clear();
+#ifdef _WIN32
+    return false;
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    char buff[PROC_FILE_BUFF_SIZE] = {0};
+    ssize_t count = 0;
+    while ((count = read(fd, buff, sizeof(buff))) > 0)
+        text.append(buff, count);
+    close(fd);
+    return count == 0;
+#endif
+}
+
+// ex: 1234 (ip) S 1 1234 1234 0 -1 4194560 ...
+bool parse_proc_stat(const string& text, ProcessInfo &info)
+{
+    // comm may contain spaces and ')', it ends at the last ')'
+    size_t begin = text.find('(');
+    size_t end = text.rfind(')');
+    if (begin == string::npos || end == string::npos || end < begin)
+        return false;
+    info.pid = atoi(text.c_str());
+    info.name = text.substr(begin + 1, end - begin - 1);
+
+    stringstream stream(text.substr(end + 1));
+    string state;
+    if (!(stream >> state) || state.empty())
+        return false;
+    info.state = state[0];
+    string field;
+    for (int i = 1; i <= PROC_STAT_START_TIME_INDEX; i++)
+    {
+        if (!(stream >> field))
+            return false;
+        if (i == PROC_STAT_PPID_INDEX)
+            info.ppid = atoi(field.c_str());
+    }
+    info.startTime = strtoull(field.c_str(), nullptr, 10);
+    return true;
+}
+
+pair<unsigned int, bool> get_user_id(const char* user)
+{
+    // check input
+    if (!user || strlen(user) == 0) {
+        qDebug("missing parameter");
+        return make_pair(0, false);
+    }
+#ifdef _WIN32
+    return make_pair(0, false);
+#else
+    struct passwd pwd;
+    struct passwd *result = nullptr;
+    char buff[BUFF_SIZE * 4] = {0};
+    if (getpwnam_r(user, &pwd, buff, sizeof(buff), &result) != 0 || !result)
+        return make_pair(0, false);
+    return make_pair((unsigned int)pwd.pw_uid, true);
+#endif
+}
+
+ProcessSnapshot::ProcessSnapshot(const char* procFolder)
+{
+    m_procFolder = procFolder ? procFolder : PROC_FOLDER;
+}
+
+bool ProcessSnapshot::scan()
+{
+    m_processes.clear();
+    m_pidIndex.clear();
+    m_nameIndex.clear();
+    m_userIndex.clear();
+    m_parentIndex.clear();
+#ifdef _WIN32
+    return false;
+#else
+    DIR *dir = opendir(m_procFolder.c_str());
+    if (!dir) {
+        qDebug("open %s failed:%s", m_procFolder.c_str(), strerror(errno));
+        return false;
+    }
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (!isdigit((unsigned char)entry->d_name[0]))
+            continue;
+        ProcessInfo info;
+        // exited between readdir and read, not an error
+        if (!_read_process(entry->d_name, info))
+            continue;
+        size_t index = m_processes.size();
+        m_processes.push_back(info);
+        m_pidIndex[info.pid] = index;
+        m_nameIndex.insert(make_pair(info.name, index));
+        m_userIndex.insert(make_pair(info.uid, index));
+        m_parentIndex.insert(make_pair(info.ppid, index));
+    }
+    closedir(dir);
+    return true;
+#endif
+}
+
+size_t ProcessSnapshot::size() const
+{
+    return m_processes.size();
+}
+
+pair<ProcessInfo, bool> ProcessSnapshot::get_process(int pid) const
+{
+    auto itr = m_pidIndex.find(pid);
+    if (itr == m_pidIndex.end())
+        return make_pair(ProcessInfo(), false);
+    return make_pair(m_processes[itr->second], true);
+}
+
+vector<ProcessInfo> ProcessSnapshot::find_by_name(const char* name) const
+{
+    vector<ProcessInfo> processes;
+    // check input
+    if (!name) {
+        qDebug("missing parameter");
+        return processes;
+    }
+    auto range = m_nameIndex.equal_range(name);
+    for (auto itr = range.first; itr != range.second; ++itr)
+        processes.push_back(m_processes[itr->second]);
+    return processes;
+}
+
+vector<ProcessInfo> ProcessSnapshot::find_by_user(unsigned int uid) const
+{
+    vector<ProcessInfo> processes;
+    auto range = m_userIndex.equal_range(uid);
+    for (auto itr = range.first; itr != range.second; ++itr)
+        processes.push_back(m_processes[itr->second]);
+    return processes;
+}
+
+vector<ProcessInfo> ProcessSnapshot::find_by_name_and_user(const char* name, unsigned int uid) const
+{
+    vector<ProcessInfo> processes;
+    for (auto &process : find_by_name(name))
+    {
+        if (process.uid == uid)
+            processes.push_back(process);
+    }
+    return processes;
+}
+
+vector<ProcessInfo> ProcessSnapshot::find_children(int ppid) const
+{
+    vector<ProcessInfo> processes;
+    auto range = m_parentIndex.equal_range(ppid);
+    for (auto itr = range.first; itr != range.second; ++itr)
+        processes.push_back(m_processes[itr->second]);
+    return processes;
+}
+
+vector<ProcessInfo> ProcessSnapshot::find_by_cmdline(const char* pattern) const
+{
+    vector<ProcessInfo> processes;
+    // check input
+    if (!pattern || strlen(pattern) == 0) {
+        qDebug("missing parameter");
+        return processes;
+    }
+    for (auto &process : m_processes)
+    {
+        if (process.cmdline.find(pattern) != string::npos)
+            processes.push_back(process);
+    }
+    return processes;
+}
+
+bool ProcessSnapshot::_read_process(const string& pidName, ProcessInfo &info)
+{
+    string folder = m_procFolder + "/" + pidName;
+    string text;
+    if (!read_proc_file(folder + "/stat", text) || !parse_proc_stat(text, info))
+        return false;
+
+    // Uid: real effective saved filesystem
+    info.uid = 0;
+    if (!read_proc_file(folder + "/status", text))
+        return false;
+    size_t position = text.find("\nUid:");
+    if (position == string::npos)
+        return false;
+    stringstream stream(text.substr(position + 5));
+    unsigned int realUid = 0;
+    if (!(stream >> realUid >> info.uid))
+        return false;
+
+    // arguments are separated by '\0'
+    read_proc_file(folder + "/cmdline", text);
+    while (!text.empty() && text.back() == '\0')
+        text.pop_back();
+    for (auto &c : text)
+    {
+        if (c == '\0')
+            c = ' ';
+    }
+    info.cmdline = text;
+    return true;
+}
+
+TPCProcessUtility::TPCProcessUtility(const char* procFolder)
+{
+    m_procFolder = procFolder ? procFolder : PROC_FOLDER;
+}
+
+shared_ptr<const ProcessSnapshot> TPCProcessUtility::get_snapshot()
+{
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    auto now = chrono::steady_clock::now();
+    if (m_snapshot &&
+        chrono::duration_cast<chrono::milliseconds>(now - m_snapshotTime).count() < PROCESS_SNAPSHOT_MAX_AGE_MS)
+        return m_snapshot;
+    auto snapshot = make_shared<ProcessSnapshot>(m_procFolder.c_str());
+    snapshot->scan();
+    m_snapshot = snapshot;
+    m_snapshotTime = now;
+    return m_snapshot;
+}
+
+void TPCProcessUtility::invalidate_snapshot()
+{
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    m_snapshot.reset();
+}
+
+bool TPCProcessUtility::signal_process(const ProcessInfo &process, int signal)
+{
+#ifdef _WIN32
+    return false;
+#else
+    // check input
+    if (process.pid <= 0) {
+        qDebug("missing parameter");
+        return false;
+    }
+    int fd = (int)syscall(SYS_pidfd_open, process.pid, 0);
+    if (fd < 0 && errno != ENOSYS) {
+        // ESRCH, already exited
+        return false;
+    }
+    // the fd pins the pid, so a start time still matching means it is the process of the snapshot
+    const auto startTime = _get_start_time(process.pid);
+    if (!startTime.second || startTime.first != process.startTime) {
+        qDebug("pid %d is no longer %s", process.pid, process.name.c_str());
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    int ret = 0;
+    if (fd >= 0) {
+        ret = (int)syscall(SYS_pidfd_send_signal, fd, signal, nullptr, 0);
+        close(fd);
+    } else {
+        // kernel older than 5.3, only the start time check above guards the pid
+        ret = kill(process.pid, signal);
+    }
+    if (ret != 0) {
+        qDebug("signal %d to %s(%d) failed:%s", signal, process.name.c_str(), process.pid, strerror(errno));
+        return false;
+    }
+    return true;
+#endif
+}
+
+size_t TPCProcessUtility::signal_processes(const vector<ProcessInfo> &processes, int signal)
+{
+    size_t count = 0;
+    for (auto &process : processes)
+    {
+        if (signal_process(process, signal))
+            count++;
+    }
+    // processes signaled are about to exit, next caller sees a new scan
+    if (count > 0)
+        invalidate_snapshot();
+    return count;
+}
+
+pair<unsigned long long, bool> TPCProcessUtility::_get_start_time(int pid)
+{
+    string text;
+    ProcessInfo info;
+    if (!read_proc_file(m_procFolder + "/" + to_string(pid) + "/stat", text) || !parse_proc_stat(text, info))
+        return make_pair(0, false);
+    return make_pair(info.startTime, true);
+}
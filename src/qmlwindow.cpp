@@ -5,11 +5,23 @@
 #include "./include/utility.h"
 #include "./include/log_utility.h"
 #include "./include/config_utility.h"
+#include "./include/service_manager.h"
+#include "./include/process_utility.h"
 #include "./include/network_utility.h"
+#include "./include/network_diagnostics_utility.h"
 #include "./include/screen_utility.h"
 #include "./include/system_utility.h"
+#include "./include/reboot_schedule.h"
+#include "./include/boot_logo_utility.h"
 #include "./include/storage_utility.h"
+#include "./include/storage_benchmark_utility.h"
+#include "./include/screenshot_utility.h"
+#include "./include/screenshot_gallery_model.h"
+#include "./include/storage_telemetry.h"
 #include "./include/time_utility.h"
+#include "./include/time_dbus_utility.h"
+#include "./include/timezone_list_model.h"
+#include "./include/time_sync_monitor.h"
 #include "./include/startup_utility.h"
 #include "./include/update_utility.h"
 #include "./include/info_utility.h"
@@ -17,10 +29,14 @@
 #include "./include/ftp_utility.h"
 #include "./include/restore_utility.h"
 #include "./include/pam_utility.h"
-#include "./include/polling_thread.h"
+#include "./include/job_scheduler.h"
+#include "./include/uevent_monitor.h"
+#include "./include/brightness_controller.h"
 
+#include <cmath>
 #include <QVariant>
 #include <QFileSystemWatcher>
+#include <QTimer>
 #include <QQuickItem>
 #include <QMessageBox>
 #include <QScreen>
@@ -29,6 +45,7 @@
 #include <QStringList>
 #include <QFile>
 #include <QFileInfo>
+#include <QDateTime>
 #include <QDebug>
 
 #define NONE_HANDLER_INDEX 0
@@ -43,6 +60,10 @@
 #define SHOW_LOGIN_HANDLER_INDEX 10
 #define NEXT_PAGE_HANDLER_INDEX 11
 
+#define DIAGNOSTICS_ICMP_LATENCY 0
+#define DIAGNOSTICS_TCP_CONNECT_LATENCY 1
+#define DIAGNOSTICS_TCP_THROUGHPUT 2
+
 using namespace std;
 
 QMLWindow::QMLWindow(QObject *parent)
@@ -50,16 +71,43 @@ QMLWindow::QMLWindow(QObject *parent)
 {
     this->m_rootObject = nullptr;
     this->m_watcher = nullptr;
-    this->m_pollingThread = nullptr;
-    this->m_workThread = nullptr;
+    this->m_ueventMonitor = nullptr;
+    this->m_storageTelemetryTimer = nullptr;
+    this->m_timeSyncTimer = nullptr;
+    this->m_jobScheduler = new JobScheduler();
+    this->m_screenshotJob = nullptr;
     this->m_restoreUtility = new RestoreUtility();
     this->m_configUtil = new ConfigUtility();
+    this->m_serviceManager = new TPCServiceManager();
+    this->m_processUtil = new TPCProcessUtility();
     this->m_deviceInfoUtil = new TPCDeviceInfoUtility();
-    this->m_networkUtil = new TPCNetworkUtility();
-    this->m_screenUtil = new TPCScreenUtility();
-    this->m_systemUtil = new TPCSystemUtility();
+    this->m_networkUtil = new TPCNetworkUtility(this->m_serviceManager, this->m_processUtil);
+    this->m_networkDiagnosticsUtil = new TPCNetworkDiagnosticsUtility();
+    this->m_screenUtil = new TPCScreenUtility(WESTON_CONFIG_FILE, BACKLIGHT_FOLDER, GESTURE_CONFIG_FILE,
+                                              this->m_serviceManager);
+    // slider changes are written at most once per display frame
+    QScreen *screen = QGuiApplication::primaryScreen();
+    this->m_brightnessController = new BrightnessController(this->m_screenUtil,
+        screen ? screen->refreshRate() : BRIGHTNESS_DEFAULT_REFRESH_RATE, this);
+    QObject::connect(this->m_brightnessController, SIGNAL(brightnessSettled(int)),
+                     this, SLOT(brightnessSettledEvent(int)));
+    this->m_systemUtil = new TPCSystemUtility(this->m_serviceManager, this->m_processUtil);
+    this->m_bootLogoUtil = new TPCBootLogoUtility();
     this->m_storageUtil = new TPCStorageUtility();
-    this->m_timeUtil = new TPCTimeUtility();
+    this->m_storageBenchmarkUtil = new TPCStorageBenchmarkUtility();
+    this->m_screenshotUtil = new TPCScreenshotUtility();
+    this->m_screenshotGalleryModel = new ScreenshotGalleryModel(this->m_screenshotUtil, SCREENSHOTS_FOLDER,
+        SCREENSHOT_THUMBNAIL_FOLDER, this);
+    this->m_storageTelemetry = new StorageTelemetrySampler(this->m_storageUtil);
+    this->m_storageTelemetry->add_device(STORAGE_NAME_EMMC);
+    this->m_storageTelemetry->add_device(STORAGE_NAME_SD_CARD);
+    this->m_timeUtil = new TPCTimeDBusUtility();
+    this->m_timezoneModel = new TimezoneListModel(ZONEINFO_FOLDER, this);
+    this->m_timezoneFilterModel = new TimezoneFilterModel(ZONEINFO_FOLDER, this);
+    this->m_timezoneFilterModel->setSourceModel(this->m_timezoneModel);
+    this->m_timeSyncClockSource = new TPCTimeSyncClockSource();
+    this->m_timeSyncMonitor = new TimeSyncMonitor(this->m_timeSyncClockSource);
+    this->m_ntpMessageWatcher = new NTPMessageWatcher(this->m_timeSyncMonitor);
     this->m_updateUtil = new TPCUpdateUtility();
     this->m_versionUtil = new TPCVersionUtility();
     this->m_ftpUtil = new TPCFTPUtility();
@@ -92,18 +140,36 @@ QMLWindow::QMLWindow(QObject *parent)
 QMLWindow::~QMLWindow()
 {
     this->stopNetworkMonitor();
+    this->stopStorageMonitor();
+    this->stopStorageTelemetry();
+    this->stopTimeSyncMonitor();
+    // persist brightness of an unfinished drag
+    this->m_brightnessController->flush();
+    delete this->m_brightnessController;
+    // running jobs use the utilities, they are cancelled and stop at their next token check
+    delete this->m_jobScheduler;
 
     delete this->m_restoreUtility;
     delete this->m_configUtil;
     delete this->m_deviceInfoUtil;
     delete this->m_networkUtil;
+    delete this->m_networkDiagnosticsUtil;
     delete this->m_screenUtil;
     delete this->m_systemUtil;
+    delete this->m_bootLogoUtil;
     delete this->m_storageUtil;
+    delete this->m_storageBenchmarkUtil;
+    delete this->m_screenshotUtil;
+    delete this->m_storageTelemetry;
     delete this->m_timeUtil;
+    delete this->m_ntpMessageWatcher;
+    delete this->m_timeSyncMonitor;
+    delete this->m_timeSyncClockSource;
     delete this->m_updateUtil;
     delete this->m_versionUtil;
     delete this->m_ftpUtil;
+    delete this->m_serviceManager;
+    delete this->m_processUtil;
 }
 
 void QMLWindow::initWindow(QObject *rootObject)
@@ -119,16 +185,18 @@ void QMLWindow::initWindow(QObject *rootObject)
     this->initSecurityWindowHandler(rootObject);
     this->initFTPWindowHandler(rootObject);
     this->initLogoWindowHandler(rootObject);
+    this->initStorageWindowHandler(rootObject);
     this->initUpdateWindowHandler(rootObject);
     this->initOperateWindowHandler(rootObject);
     this->initPasswordWindowHandler(rootObject);
+    this->initDiagnosticsWindowHandler(rootObject);
     this->initAboutWindowHandler(rootObject);
 
     if (this->m_appMode.compare(APP_MODE_INIT) == 0)
     {
         this->initCredentialsWindowHandler(rootObject);
         this->initWizardNetworkWindowHandler(rootObject);
-        this->initWizardTimeWindowHandler(rootObject, this->m_timezones);
+        this->initWizardTimeWindowHandler(rootObject);
         this->initWizardScreenWindowHandler(rootObject);
         this->initWizardStartupWindowHandler(rootObject);
     } 
@@ -141,17 +209,25 @@ void QMLWindow::initWindow(QObject *rootObject)
     }
 }
 
-void QMLWindow::initTimezones(QStringList &timezones)
+void QMLWindow::initTimezoneComboBox(QObject *form, const std::string &timezone)
 {
-    // initialize timezone model when first time
-    if (timezones.size() == 0)
+    QObject *timezoneComboBox = form->findChild<QObject *>("timezoneComboBox");
+    QObject *timezoneTextField = form->findChild<QObject *>("timezoneTextField");
+
+    // read tzdata when first time, offsets follow the current date on every page open
+    if (!this->m_timezoneModel->isLoaded())
     {
         const auto retTimezones = this->m_timeUtil->get_timezones();
-        for (auto &itr : retTimezones.first)
-        {
-            timezones << itr.c_str();
-        }
+        this->m_timezoneModel->load(retTimezones.first);
     }
+    this->m_timezoneModel->refresh(QDateTime::currentSecsSinceEpoch());
+    timezoneComboBox->setProperty("model", QVariant::fromValue(static_cast<QObject *>(this->m_timezoneModel)));
+
+    int index = this->m_timezoneModel->indexOf(QString::fromStdString(timezone));
+    timezoneComboBox->setProperty("currentIndex", QVariant(index));
+    // keep the configured timezone when tzdata does not have it
+    timezoneTextField->setProperty("text", QVariant(index >= 0 ? this->m_timezoneModel->valueAt(index)
+                                                               : QString::fromStdString(timezone)));
 }
 
 void QMLWindow::initLoginFlow(QObject *rootObject)
@@ -176,6 +252,9 @@ void QMLWindow::initLoginFlow(QObject *rootObject)
 void QMLWindow::startWorker()
 {
     this->startNetworkMonitor();
+    this->startStorageMonitor();
+    this->startStorageTelemetry();
+    this->startTimeSyncMonitor();
 }
 
 void QMLWindow::initGlobalHandler(QObject *rootObject)
@@ -189,6 +268,10 @@ void QMLWindow::initGlobalHandler(QObject *rootObject)
     QObject *questionPopupCancelButton = msgbox->findChild<QObject *>("questionPopupCancelButton");
     QObject::connect(questionPopupCancelButton, SIGNAL(clicked()),
                      this, SLOT(on_questionDialog_cancelButton_clicked()));
+    QObject *loadingIndicator = rootObject->findChild<QObject *>("loadingIndicator");
+    QObject *loadingCancelButton = loadingIndicator->findChild<QObject *>("loadingCancelButton");
+    QObject::connect(loadingCancelButton, SIGNAL(clicked()),
+                     this, SLOT(on_loadingIndicator_cancelButton_clicked()));
 }
 
 void QMLWindow::initGlobalWindow(QObject *rootObject)
@@ -219,6 +302,7 @@ void QMLWindow::initGlobalWindow(QObject *rootObject)
     QObject *updateButton = sideBar->findChild<QObject *>("updateButton");
     QObject *operateButton = sideBar->findChild<QObject *>("operateButton");
     QObject *passwordButton = sideBar->findChild<QObject *>("passwordButton");
+    QObject *diagnosticsButton = sideBar->findChild<QObject *>("diagnosticsButton");
     QObject *aboutButton = sideBar->findChild<QObject *>("aboutButton");
     QObject *exitButton = sideBar->findChild<QObject *>("exitButton");
     bool credentialsPageShowed = this->m_configUtil->get_credentials_page_is_showed();
@@ -237,6 +321,7 @@ void QMLWindow::initGlobalWindow(QObject *rootObject)
     bool updatePageShowed = this->m_configUtil->get_update_page_is_showed();
     bool operatePageShowed = this->m_configUtil->get_operate_page_is_showed();
     bool passwordPageShowed = this->m_configUtil->get_password_page_is_showed();
+    bool diagnosticsPageShowed = this->m_configUtil->get_diagnostics_page_is_showed();
     bool aboutPageShowed = this->m_configUtil->get_about_page_is_showed();
     bool exitPageShowed = this->m_configUtil->get_exit_page_is_showed();
     const char* backupFile = ConfigUtility::get_backup_config_path();
@@ -345,6 +430,10 @@ void QMLWindow::initGlobalWindow(QObject *rootObject)
     {
         passwordButton->setProperty("visible", QVariant(passwordPageShowed));
     }
+    if (!diagnosticsPageShowed)
+    {
+        diagnosticsButton->setProperty("visible", QVariant(diagnosticsPageShowed));
+    }
     if (!aboutPageShowed)
     {
         aboutButton->setProperty("visible", QVariant(aboutPageShowed));
@@ -378,6 +467,7 @@ void QMLWindow::initSideBarHandler(QObject *rootObject)
     QObject *updateButton = sideBar->findChild<QObject *>("updateButton");
     QObject *operateButton = sideBar->findChild<QObject *>("operateButton");
     QObject *passwordButton = sideBar->findChild<QObject *>("passwordButton");
+    QObject *diagnosticsButton = sideBar->findChild<QObject *>("diagnosticsButton");
     QObject *aboutButton = sideBar->findChild<QObject *>("aboutButton");
     QObject::connect(screenButton, SIGNAL(pressed()),
                      this, SLOT(on_screen_toggled()));
@@ -401,6 +491,8 @@ void QMLWindow::initSideBarHandler(QObject *rootObject)
                      this, SLOT(on_operate_toggled()));
     QObject::connect(passwordButton, SIGNAL(pressed()),
                      this, SLOT(on_password_toggled()));
+    QObject::connect(diagnosticsButton, SIGNAL(pressed()),
+                     this, SLOT(on_diagnostics_toggled()));
     QObject::connect(aboutButton, SIGNAL(pressed()),
                      this, SLOT(on_about_toggled()));
 }
@@ -435,7 +527,7 @@ void QMLWindow::initWizardNetworkWindowHandler(QObject *rootObject)
                      this, SLOT(on_wizardNetworkWindow_nextButton2_clicked()));
 }
 
-void QMLWindow::initWizardTimeWindowHandler(QObject *rootObject, QStringList &timezones)
+void QMLWindow::initWizardTimeWindowHandler(QObject *rootObject)
 {
     const auto retCurrentTimezone = this->m_timeUtil->get_current_timezone();
     QObject *wiztimeForm = rootObject->findChild<QObject *>("wiztimeForm");
@@ -443,15 +535,7 @@ void QMLWindow::initWizardTimeWindowHandler(QObject *rootObject, QStringList &ti
     QObject::connect(nextButton, SIGNAL(clicked()),
                      this, SLOT(on_wizardTimeWindow_nextButton_clicked()));
 
-    // initialize timezone model when first time
-    if (timezones.size() == 0)
-    {
-        this->initTimezones(timezones);
-        QMetaObject::invokeMethod(wiztimeForm, "initTimezoneModel",
-                                  Q_ARG(QVariant, QVariant::fromValue(timezones)));
-    }
-    QMetaObject::invokeMethod(wiztimeForm, "initTimezoneComboBox",
-                              Q_ARG(QVariant, QVariant(QString::fromStdString(retCurrentTimezone.first))));
+    this->initTimezoneComboBox(wiztimeForm, retCurrentTimezone.first);
     QMetaObject::invokeMethod(wiztimeForm, "initTimeComboBox");
 }
 
@@ -538,6 +622,9 @@ void QMLWindow::initUpdateWindowHandler(QObject *rootObject)
 
 void QMLWindow::initScreenWindowValue(QObject *rootObject)
 {
+    // pick up weston.ini and gester.conf changes made outside settings
+    this->m_screenUtil->reload_weston_config();
+    this->m_screenUtil->reload_gesture_config();
     int brightValue = this->m_screenUtil->get_brightness();
     int idleTimeMinute = this->m_screenUtil->get_screensaver_idle_time() / MINUTE_OF_SECONDS;
     bool isHideCursor = this->m_screenUtil->get_hide_cursor();
@@ -647,62 +734,123 @@ void QMLWindow::initLogoWindowHandler(QObject *rootObject)
 void QMLWindow::initStorageWindowValue(QObject *rootObject)
 {
     QObject *storageForm = rootObject->findChild<QObject *>("storageForm");
-    QObject *emmcSizeLabel = storageForm->findChild<QObject *>("emmcSizeLabel");
-    QObject *sdSizeLabel = storageForm->findChild<QObject *>("sdSizeLabel");
     // clear old data
     QMetaObject::invokeMethod(storageForm, "clearPratitionModelList");
     QMetaObject::invokeMethod(storageForm, "reset");
 
     // set emmc data
-    const auto reteMMCSize = this->m_storageUtil->get_emmc_size();
-    if (!reteMMCSize.first.empty())
-    {
-        emmcSizeLabel->setProperty("text", QVariant(QString::fromStdString(reteMMCSize.first)));
-        const auto reteMMCParts = this->m_storageUtil->get_emmc_parts();
-        for (int i = 0; i < (int)reteMMCParts.first.size(); i++)
-        {
-            BlockDeviceData retPart = reteMMCParts.first.at(i);
-            QMetaObject::invokeMethod(storageForm, "addToEMMCPratitionModelList",
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getLabel()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getMountPoint()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getUUID()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getFSType()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getSize()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getUsedPercent()))));
-        }
-    }
-    else
-    {
-        emmcSizeLabel->setProperty("text", QVariant(QString::fromStdString("0G")));
-    }
+    this->initStorageDeviceValue(rootObject, STORAGE_NAME_EMMC);
     // init partition UI
     QMetaObject::invokeMethod(storageForm, "initEMMCStoragePratitionUI");
 
     // set sd data
-    const auto retSDSize = this->m_storageUtil->get_sd_card_size();
-    if (!retSDSize.first.empty())
+    this->initStorageDeviceValue(rootObject, STORAGE_NAME_SD_CARD);
+    // init partition UI
+    QMetaObject::invokeMethod(storageForm, "initSDStoragePratitionUI");
+}
+
+void QMLWindow::initStorageDeviceValue(QObject *rootObject, const char* deviceName)
+{
+    bool isEMMC = (strcmp(deviceName, STORAGE_NAME_EMMC) == 0);
+    QObject *storageForm = rootObject->findChild<QObject *>("storageForm");
+    QObject *sizeLabel = storageForm->findChild<QObject *>(isEMMC ? "emmcSizeLabel" : "sdSizeLabel");
+    const char *addFunction = isEMMC ? "addToEMMCPratitionModelList" : "addToSDPratitionModelList";
+    // clear old data of this device only
+    QMetaObject::invokeMethod(storageForm, "clearDevicePratitionModelList",
+                              Q_ARG(QVariant, QVariant(isEMMC)));
+
+    const auto retSize = this->m_storageUtil->get_device_size(deviceName);
+    if (retSize.first.empty())
     {
-        sdSizeLabel->setProperty("text", QVariant(QString::fromStdString(retSDSize.first)));
-        const auto retSDParts = this->m_storageUtil->get_sd_card_parts();
-        for (int i = 0; i < (int)retSDParts.first.size(); i++)
-        {
-            BlockDeviceData retPart = retSDParts.first.at(i);
-            QMetaObject::invokeMethod(storageForm, "addToSDPratitionModelList",
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getLabel()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getMountPoint()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getUUID()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getFSType()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getSize()))),
-                                      Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getUsedPercent()))));
-        }
+        sizeLabel->setProperty("text", QVariant(QString::fromStdString("0G")));
+        return;
     }
-    else
+    sizeLabel->setProperty("text", QVariant(QString::fromStdString(retSize.first)));
+    const auto retParts = this->m_storageUtil->get_device_parts(deviceName);
+    for (int i = 0; i < (int)retParts.first.size(); i++)
     {
-        sdSizeLabel->setProperty("text", QVariant(QString::fromStdString("0G")));
+        BlockDeviceData retPart = retParts.first.at(i);
+        QMetaObject::invokeMethod(storageForm, addFunction,
+                                  Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getName()))),
+                                  Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getLabel()))),
+                                  Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getMountPoint()))),
+                                  Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getUUID()))),
+                                  Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getFSType()))),
+                                  Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getSize()))),
+                                  Q_ARG(QVariant, QVariant(QString::fromStdString(retPart.getUsedPercent()))));
     }
+}
 
-    // init partition UI
-    QMetaObject::invokeMethod(storageForm, "initSDStoragePratitionUI");
+void QMLWindow::updateStoragePartitionValue(QObject *rootObject, const char* deviceName, BlockDeviceData &partition)
+{
+    bool isEMMC = (strcmp(deviceName, STORAGE_NAME_EMMC) == 0);
+    QObject *storageForm = rootObject->findChild<QObject *>("storageForm");
+    QMetaObject::invokeMethod(storageForm, "updatePratition",
+                              Q_ARG(QVariant, QVariant(isEMMC)),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(partition.getName()))),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(partition.getLabel()))),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(partition.getMountPoint()))),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(partition.getUUID()))),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(partition.getFSType()))),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(partition.getSize()))),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(partition.getUsedPercent()))));
+}
+
+void QMLWindow::initStorageWindowHandler(QObject *rootObject)
+{
+    QObject *storageForm = rootObject->findChild<QObject *>("storageForm");
+    QObject *benchmarkButton = storageForm->findChild<QObject *>("benchmarkButton");
+    QObject *benchmarkExportButton = storageForm->findChild<QObject *>("benchmarkExportButton");
+    QObject::connect(benchmarkButton, SIGNAL(clicked()),
+                     this, SLOT(on_storageWindow_benchmarkButton_clicked()));
+    QObject::connect(benchmarkExportButton, SIGNAL(clicked()),
+                     this, SLOT(on_storageWindow_benchmarkExportButton_clicked()));
+    QObject *storageSwipeView = storageForm->findChild<QObject *>("storageSwipeView");
+    QObject::connect(storageSwipeView, SIGNAL(currentIndexChanged()),
+                     this, SLOT(on_storageWindow_swipeView_changed()));
+    QObject *telemetryDeviceComboBox = storageForm->findChild<QObject *>("telemetryDeviceComboBox");
+    QObject::connect(telemetryDeviceComboBox, SIGNAL(currentIndexChanged()),
+                     this, SLOT(on_storageWindow_telemetryDeviceComboBox_changed()));
+}
+
+void QMLWindow::initStorageTelemetryValue(QObject *rootObject)
+{
+    QObject *storageForm = rootObject->findChild<QObject *>("storageForm");
+    QVariant device;
+    QMetaObject::invokeMethod(storageForm, "getCurrentTelemetryDevice",
+                              Q_RETURN_ARG(QVariant, device));
+    string deviceName = device.toString().toStdString();
+    auto retSamples = this->m_storageTelemetry->get_samples(deviceName.c_str());
+    StorageTelemetryRing samples = retSamples.first;
+    QVariantList readSeries;
+    QVariantList writeSeries;
+    QVariantList utilizationSeries;
+    double maxThroughput = 0;
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        StorageTelemetrySample sample = samples.at(i);
+        readSeries.append(sample.getReadBytesPerSecond());
+        writeSeries.append(sample.getWriteBytesPerSecond());
+        utilizationSeries.append(sample.getUtilization());
+        maxThroughput = std::max(maxThroughput, sample.getReadBytesPerSecond());
+        maxThroughput = std::max(maxThroughput, sample.getWriteBytesPerSecond());
+    }
+    string summary = (samples.size() > 0) ? samples.latest().toString() : "Not exists";
+    string maxLabel = format_size((unsigned long long)maxThroughput) + "/s";
+    QMetaObject::invokeMethod(storageForm, "updateTelemetry",
+                              Q_ARG(QVariant, QVariant(readSeries)),
+                              Q_ARG(QVariant, QVariant(writeSeries)),
+                              Q_ARG(QVariant, QVariant(utilizationSeries)),
+                              Q_ARG(QVariant, QVariant((int)samples.capacity())),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(maxLabel))),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(summary))));
+
+    // sd cards do not report health
+    auto retHealth = this->m_storageTelemetry->get_health(deviceName.c_str());
+    string health = retHealth.second ? retHealth.first.toString() : "Not supported";
+    QMetaObject::invokeMethod(storageForm, "showHealth",
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(health))),
+                              Q_ARG(QVariant, QVariant(retHealth.second && retHealth.first.isWarning())));
 }
 
 void QMLWindow::initNetworkWindowValue(QObject *rootObject)
@@ -924,7 +1072,7 @@ void QMLWindow::initNetworkWindowHandler(QObject *rootObject)
                      
 }
 
-void QMLWindow::initTimeWindowValue(QObject *rootObject, QStringList &timezones)
+void QMLWindow::initTimeWindowValue(QObject *rootObject)
 {
     const auto retCurrentTimezone = this->m_timeUtil->get_current_timezone();
     const auto retNTPServer = this->m_timeUtil->get_ntp_server();
@@ -953,17 +1101,35 @@ void QMLWindow::initTimeWindowValue(QObject *rootObject, QStringList &timezones)
     minuteComboBox->setProperty("enabled", QVariant(!retNTPEnabled.first));
     secondComboBox->setProperty("enabled", QVariant(!retNTPEnabled.first));
 
-    // initialize timezone model when first time
-    if (timezones.size() == 0)
-    {
-        this->initTimezones(timezones);
-        QMetaObject::invokeMethod(timeForm, "initTimezoneModel",
-                                  Q_ARG(QVariant, QVariant::fromValue(timezones)));
-    }
-
-    QMetaObject::invokeMethod(timeForm, "initTimezoneComboBox",
-                              Q_ARG(QVariant, QVariant(QString::fromStdString(retCurrentTimezone.first))));
+    this->initTimezoneComboBox(timeForm, retCurrentTimezone.first);
     QMetaObject::invokeMethod(timeForm, "initTimeComboBox");
+    this->initTimeSyncValue(rootObject);
+}
+
+void QMLWindow::initTimeSyncValue(QObject *rootObject)
+{
+    QObject *timeForm = rootObject->findChild<QObject *>("timeForm");
+    TimeSyncRing samples = this->m_timeSyncMonitor->get_samples();
+    QVariantList offsetSeries;
+    QVariantList jitterSeries;
+    double maxValue = 0;
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        TimeSyncSample sample = samples.at(i);
+        // chart has no negative side, the summary keeps the sign
+        offsetSeries.append(std::fabs(sample.getOffset()));
+        jitterSeries.append(sample.getJitter());
+        maxValue = std::max(maxValue, std::fabs(sample.getOffset()));
+        maxValue = std::max(maxValue, sample.getJitter());
+    }
+    char maxLabel[BUFF_SIZE] = {0};
+    snprintf(maxLabel, BUFF_SIZE, "%.3f ms", maxValue);
+    QMetaObject::invokeMethod(timeForm, "updateTimeSync",
+                              Q_ARG(QVariant, QVariant(offsetSeries)),
+                              Q_ARG(QVariant, QVariant(jitterSeries)),
+                              Q_ARG(QVariant, QVariant((int)samples.capacity())),
+                              Q_ARG(QVariant, QVariant(QString(maxLabel))),
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(this->m_timeSyncMonitor->get_summary()))));
 }
 
 void QMLWindow::initTimeWindowHandler(QObject *rootObject)
@@ -972,6 +1138,10 @@ void QMLWindow::initTimeWindowHandler(QObject *rootObject)
     QObject *applyButton = timeForm->findChild<QObject *>("applyButton");
     QObject::connect(applyButton, SIGNAL(clicked()),
                      this, SLOT(on_timeWindow_applyButton_clicked()));
+
+    // search popup is shared by time and wizard time pages
+    QObject *timezoneSearchView = rootObject->findChild<QObject *>("timezoneSearchView");
+    timezoneSearchView->setProperty("model", QVariant::fromValue(static_cast<QObject *>(this->m_timezoneFilterModel)));
 }
 
 void QMLWindow::initSystemWindowValue(QObject *rootObject)
@@ -1085,6 +1255,28 @@ void QMLWindow::initSystemWindowValue(QObject *rootObject)
                               Q_ARG(QVariant, QVariant(retHour)));
     QMetaObject::invokeMethod(systemForm, "initCronDayofweekComboBox",
                               Q_ARG(QVariant, QVariant(retDayofweek)));
+    this->updateNextRebootLabel(systemForm, retIsRSCronEnable, this->getRebootSchedule());
+}
+
+RebootSchedule QMLWindow::getRebootSchedule()
+{
+    const auto mode = this->m_configUtil->get_reboot_system_crontab_mode();
+    return make_reboot_schedule(mode.c_str(),
+                                this->m_configUtil->get_reboot_system_crontab_minute(),
+                                this->m_configUtil->get_reboot_system_crontab_hour(),
+                                this->m_configUtil->get_reboot_system_crontab_dayofweek(),
+                                this->m_configUtil->get_reboot_system_crontab_windows(),
+                                this->m_configUtil->get_reboot_system_crontab_blackouts());
+}
+
+void QMLWindow::updateNextRebootLabel(QObject *systemForm, bool enabled, const RebootSchedule &schedule)
+{
+    QObject *nextRebootLabel = systemForm->findChild<QObject *>("nextRebootLabel");
+    QString text = "-";
+    time_t nextTime = enabled ? schedule.getNextFireTime(time(nullptr)) : -1;
+    if (nextTime >= 0)
+        text = QDateTime::fromSecsSinceEpoch(nextTime).toString("yyyy-MM-dd HH:mm ddd");
+    nextRebootLabel->setProperty("text", QVariant(text));
 }
 
 void QMLWindow::initSystemWindowHandler(QObject *rootObject)
@@ -1093,6 +1285,7 @@ void QMLWindow::initSystemWindowHandler(QObject *rootObject)
     QObject *startupApplyButton = systemForm->findChild<QObject *>("startupPageApplyButton");
     QObject *generalApplyButton = systemForm->findChild<QObject *>("generalPageApplyButton");
     QObject *comApplyButton = systemForm->findChild<QObject *>("comPageApplyButton");
+    QObject *comBenchmarkButton = systemForm->findChild<QObject *>("comBenchmarkButton");
     QObject *systemSwipeView = systemForm->findChild<QObject *>("systemSwipeView");
     QObject::connect(systemSwipeView, SIGNAL(currentIndexChanged()),
                      this, SLOT(on_systemWindow_swipeView_changed()));
@@ -1102,6 +1295,8 @@ void QMLWindow::initSystemWindowHandler(QObject *rootObject)
                      this, SLOT(on_systemWindow_generalApplyButton_clicked()));
     QObject::connect(comApplyButton, SIGNAL(clicked()),
                      this, SLOT(on_systemWindow_comApplyButton_clicked()));
+    QObject::connect(comBenchmarkButton, SIGNAL(clicked()),
+                     this, SLOT(on_systemWindow_comBenchmarkButton_clicked()));
 }
 
 void QMLWindow::initSecurityWindowValue(QObject *rootObject)
@@ -1185,6 +1380,10 @@ void QMLWindow::initOperateWindowHandler(QObject *rootObject)
     QObject *openTerminalButton = operateForm->findChild<QObject *>("openTerminalButton");
     QObject *factoryResetButton = operateForm->findChild<QObject *>("factoryResetButton");
     QObject *exportScreenshotsButton = operateForm->findChild<QObject *>("exportScreenshotsButton");
+    QObject *cancelScreenshotsButton = operateForm->findChild<QObject *>("cancelScreenshotsButton");
+    QObject *viewScreenshotsButton = operateForm->findChild<QObject *>("viewScreenshotsButton");
+    QObject *screenshotGalleryView = operateForm->findChild<QObject *>("screenshotGalleryView");
+    screenshotGalleryView->setProperty("model", QVariant::fromValue(static_cast<QObject *>(this->m_screenshotGalleryModel)));
     QObject::connect(fileDialog, SIGNAL(accepted()),
                      this, SLOT(on_operateWindow_importFileDialog_accepted()));
     QObject::connect(folderDialog, SIGNAL(accepted()),
@@ -1199,6 +1398,10 @@ void QMLWindow::initOperateWindowHandler(QObject *rootObject)
                      this, SLOT(on_operateWindow_factoryResetButton_clicked()));
     QObject::connect(exportScreenshotsButton, SIGNAL(clicked()),
                      this, SLOT(on_operateWindow_exportScreenshotsButton_clicked()));
+    QObject::connect(cancelScreenshotsButton, SIGNAL(clicked()),
+                     this, SLOT(on_operateWindow_cancelScreenshotsButton_clicked()));
+    QObject::connect(viewScreenshotsButton, SIGNAL(clicked()),
+                     this, SLOT(on_operateWindow_viewScreenshotsButton_clicked()));
 }
 
 void QMLWindow::initPasswordWindowValue(QObject *rootObject)
@@ -1220,20 +1423,51 @@ void QMLWindow::initPasswordWindowHandler(QObject *rootObject)
                      this, SLOT(on_passwordWindow_applyButton_clicked()));
 }
 
+void QMLWindow::initDiagnosticsWindowValue(QObject *rootObject)
+{
+    QObject *diagnosticsForm = rootObject->findChild<QObject *>("diagnosticsForm");
+    string statistics;
+    const auto retStatistics = this->m_networkDiagnosticsUtil->get_interface_statistics();
+    for (auto &itr : retStatistics.first)
+    {
+        statistics.append(itr.toString());
+    }
+    QMetaObject::invokeMethod(diagnosticsForm, "showStatistics",
+                              Q_ARG(QVariant, QVariant(QString::fromStdString(statistics))));
+}
+
+void QMLWindow::initDiagnosticsWindowHandler(QObject *rootObject)
+{
+    QObject *diagnosticsForm = rootObject->findChild<QObject *>("diagnosticsForm");
+    QObject *pingButton = diagnosticsForm->findChild<QObject *>("pingButton");
+    QObject *connectButton = diagnosticsForm->findChild<QObject *>("connectButton");
+    QObject *throughputButton = diagnosticsForm->findChild<QObject *>("throughputButton");
+    QObject *refreshButton = diagnosticsForm->findChild<QObject *>("refreshButton");
+    QObject::connect(pingButton, SIGNAL(clicked()),
+                     this, SLOT(on_diagnosticsWindow_pingButton_clicked()));
+    QObject::connect(connectButton, SIGNAL(clicked()),
+                     this, SLOT(on_diagnosticsWindow_connectButton_clicked()));
+    QObject::connect(throughputButton, SIGNAL(clicked()),
+                     this, SLOT(on_diagnosticsWindow_throughputButton_clicked()));
+    QObject::connect(refreshButton, SIGNAL(clicked()),
+                     this, SLOT(on_diagnosticsWindow_refreshButton_clicked()));
+}
+
 void QMLWindow::waitNetworkSettingIsReady(QObject *rootObject, const char* ethernet)
 {
     // start loading
     this->showLoadingIndicator(rootObject, true);
-    // start polling thread
-    this->m_pollingThread = new PollingThread(ethernet, DHCP_TIMEOUT, this->m_networkUtil);
-    connect(this->m_pollingThread, SIGNAL(pollingFinishedSignal(bool, bool)),
-            this, SLOT(pollingNetworkSettingIsReady(bool, bool)));
-    connect(this->m_pollingThread, &PollingThread::finished,
-            this->m_pollingThread, &QObject::deleteLater);
-    this->m_pollingThread->start();
+    // wait for dhcp in a job
+    auto token = std::make_shared<JobToken>();
+    auto pWaitFunction = std::bind(&QMLWindow::bg_waitNetworkIP, this,
+        this->m_networkUtil, string(ethernet), DHCP_TIMEOUT, token);
+    Job *job = new Job(pWaitFunction, JobPriority::UI_CRITICAL, token);
+    connect(job, SIGNAL(workFinishedWithResult(QString, bool)),
+            this, SLOT(pollingNetworkSettingIsReady(QString, bool)));
+    this->m_jobScheduler->start(job);
 }
 
-void QMLWindow::pollingNetworkSettingIsReady(bool isSuccess, bool isWiredOnline)
+void QMLWindow::pollingNetworkSettingIsReady(QString customMessage, bool isSuccess)
 {
     this->showLoadingIndicator(this->m_rootObject, false);
     if (isSuccess)
@@ -1243,31 +1477,65 @@ void QMLWindow::pollingNetworkSettingIsReady(bool isSuccess, bool isWiredOnline)
     }
     else
     {
-        string msg;
-        if (isWiredOnline)
-            msg = "Please check that your DHCP server is accessible and properly configured.";
-        else
-            msg = "Please check that your wired is connected.";
+        string msg = customMessage.toStdString();
         this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
     }
 }
 
 void QMLWindow::waitNetworkIPIsReady(QObject *rootObject, const char* ethernet)
 {
-    // start polling thread
-    this->m_pollingThread = new PollingThread(ethernet, DHCP_TIMEOUT, this->m_networkUtil);
-    connect(this->m_pollingThread, SIGNAL(pollingFinishedSignal(bool, bool)),
-            this, SLOT(pollingNetworkIPIsReady(bool, bool)));
-    connect(this->m_pollingThread, &PollingThread::finished,
-            this->m_pollingThread, &QObject::deleteLater);
-    this->m_pollingThread->start();
+    // nobody waits on it, refreshes the page once the address is there
+    auto token = std::make_shared<JobToken>();
+    auto pWaitFunction = std::bind(&QMLWindow::bg_waitNetworkIP, this,
+        this->m_networkUtil, string(ethernet), DHCP_TIMEOUT, token);
+    Job *job = new Job(pWaitFunction, JobPriority::BACKGROUND, token);
+    connect(job, SIGNAL(workFinishedWithResult(QString, bool)),
+            this, SLOT(pollingNetworkIPIsReady(QString, bool)));
+    this->m_jobScheduler->start(job);
+}
+
+pair<string, bool> QMLWindow::bg_waitNetworkIP(INetworkUtility *pNetworkUtil, string ethernet, int timeout,
+    shared_ptr<JobToken> token)
+{
+    bool isWiredOnline = false;
+    int waitTimeout = timeout;
+    auto retIPv4 = pNetworkUtil->get_ip_address(ethernet.c_str(), true);
+    string ip = retIPv4.first;
+    // wait setting get ready
+    while (ip.length() == 0 && waitTimeout > 0) {
+        if (!token->wait_for(1000))
+            return make_pair(string(JOB_CANCELLED_MESSAGE), false);
+        waitTimeout--;
+        // get ip
+        retIPv4 = pNetworkUtil->get_ip_address(ethernet.c_str(), true);
+        ip = retIPv4.first;
+
+        // check still online
+        isWiredOnline = pNetworkUtil->is_network_available(ethernet);
+        if (!isWiredOnline) {
+            qDebug("%s is not connected!", ethernet.c_str());
+            break;
+        }
+    }
+    if (ip.length() > 0)
+        return make_pair(string(), true);
+    if (waitTimeout == 0)
+        qDebug("Cannot get %s ip address! Timeout!", ethernet.c_str());
+    if (isWiredOnline)
+        return make_pair(string("Please check that your DHCP server is accessible and properly configured."), false);
+    return make_pair(string("Please check that your wired is connected."), false);
 }
 
-void QMLWindow::pollingNetworkIPIsReady(bool isSuccess, bool isWiredOnline)
+void QMLWindow::pollingNetworkIPIsReady(QString customMessage, bool isSuccess)
 {
     this->initNetworkWindowValue(this->m_rootObject);
 }
 
+pair<string, bool> QMLWindow::bg_importConfig(RestoreUtility *pRestoreUtil, string filePath, ConfigUtility *pConfigUtil)
+{
+    return pRestoreUtil->import_config(filePath.c_str(), pConfigUtil);
+}
+
 void QMLWindow::importConfigIsFinished(QString customMessage, bool isSuccess)
 {
     string msg = customMessage.toStdString();
@@ -1430,12 +1698,10 @@ void QMLWindow::applyTimeSetting(QObject *rootObject)
     auto pApplyTimeSettingFunction = std::bind(&QMLWindow::bg_applyTimeSetting, this, 
         this->m_rootObject, this->m_timeUtil, this->m_configUtil);
     // run in worker thread prevent block UI thread
-    this->m_workThread = new WorkerThread(pApplyTimeSettingFunction, 1);
-    connect(this->m_workThread, SIGNAL(workFinishedWithResult(QString, bool)),
+    Job *job = new Job(pApplyTimeSettingFunction, JobPriority::UI_CRITICAL);
+    connect(job, SIGNAL(workFinishedWithResult(QString, bool)),
             this, SLOT(applyTimeSettingIsFinished(QString, bool)));
-    connect(this->m_workThread, &WorkerThread::finished,
-            this->m_workThread, &QObject::deleteLater);
-    this->m_workThread->start();
+    this->m_jobScheduler->start(job);
 }
 
 pair<string, bool> QMLWindow::bg_applyTimeSetting(QObject *rootObject, ITimeUtility *pTimeUtil, 
@@ -1543,11 +1809,16 @@ void QMLWindow::applyScreenSetting(QObject *rootObject)
         msg = "If you want to take top bar position effect immediately, click OK to restart desktop service. Do you want to continue?";
     }
     // rotate screen changes
-    if (currentRotateScreen.compare(setRotateScreen.toString().toStdString()) != 0)
+    bool isRotateScreenChanged = (currentRotateScreen.compare(setRotateScreen.toString().toStdString()) != 0);
+    if (isRotateScreenChanged)
     {
         isSuccess &= this->m_screenUtil->set_rotate_screen(setRotateScreen.toString().toStdString().c_str());
         msg = "If you want to take rotate screen effect immediately, click OK to restart desktop service. Do you want to continue?";
     }
+    // write all weston.ini changes at once
+    auto retSave = this->m_screenUtil->save_weston_config();
+    bool isWestonChanged = retSave.first;
+    isSuccess &= retSave.second;
     // gesture changes
     if (IsGeneralGesture)
     {
@@ -1556,8 +1827,11 @@ void QMLWindow::applyScreenSetting(QObject *rootObject)
         isSuccess &= this->m_screenUtil->set_2_finger_gesture_swipe_up_enabled(setIsGestureSwipeUpEnable);
         isSuccess &= this->m_screenUtil->set_2_finger_gesture_swipe_right_enabled(setIsGestureSwipeRightEnable);
     }
+    // write all gester.conf changes at once
+    auto retGestureSave = this->m_screenUtil->save_gesture_config();
+    isSuccess &= retGestureSave.second;
     // restart gesture service if rotate screen or gesture changed
-    isSuccess &= this->m_screenUtil->restart_gesture_service();
+    bool isGestureRestart = (isRotateScreenChanged || retGestureSave.first);
     // save to config
     this->m_configUtil->set_screensaver_enable(setIsScreenSaver);
     this->m_configUtil->set_blank_after(setMinutes);
@@ -1570,7 +1844,32 @@ void QMLWindow::applyScreenSetting(QObject *rootObject)
     this->m_configUtil->set_gesture_swipe_up_enable(setIsGestureSwipeUpEnable);
     this->m_configUtil->set_gesture_swipe_right_enable(setIsGestureSwipeRightEnable);
 
-    if (isSuccess)
+    if (!isGestureRestart)
+    {
+        this->showScreenSettingResult(rootObject, isSuccess, isWestonChanged, msg);
+        return;
+    }
+    // start loading
+    this->showLoadingIndicator(rootObject, true);
+    // the restart waits for the systemd job, run in worker thread
+    auto pRestartFunction = std::bind(&QMLWindow::bg_restartGestureService, this, this->m_screenUtil);
+    Job *job = new Job(pRestartFunction, JobPriority::UI_CRITICAL);
+    connect(job, &Job::workFinished, this, [this, isSuccess, isWestonChanged, msg](bool isRestarted) {
+        this->showLoadingIndicator(this->m_rootObject, false);
+        this->showScreenSettingResult(this->m_rootObject, isSuccess && isRestarted, isWestonChanged, msg);
+    });
+    this->m_jobScheduler->start(job);
+}
+
+bool QMLWindow::bg_restartGestureService(IScreenUtility *pScreenUtil)
+{
+    return pScreenUtil->restart_gesture_service();
+}
+
+void QMLWindow::showScreenSettingResult(QObject *rootObject, bool isSuccess, bool isWestonChanged, const string &msg)
+{
+    // desktop service only needs restart when weston.ini changed
+    if (isSuccess && isWestonChanged)
     {
         this->showQuestionDialog(rootObject, msg, SCREEN_HANDLER_INDEX);
     }
@@ -1735,6 +2034,7 @@ void QMLWindow::applySystemGeneralSetting(QObject *rootObject)
         // NOTE: user can not use gesture to close/switch application
         this->m_screenUtil->set_2_finger_gesture_swipe_up_enabled(false);
         this->m_screenUtil->set_2_finger_gesture_swipe_right_enabled(false);
+        this->m_screenUtil->save_gesture_config();
         this->m_configUtil->set_gesture_swipe_up_enable(false);
         this->m_configUtil->set_gesture_swipe_right_enable(false);
     }
@@ -1750,15 +2050,18 @@ void QMLWindow::applySystemGeneralSetting(QObject *rootObject)
     this->m_configUtil->set_reboot_system_crontab_hour(hour.toInt());
     this->m_configUtil->set_reboot_system_crontab_dayofweek(dayofweek.toInt());
     // set usb
+    this->m_systemUtil->set_usb_blocked_devices(this->m_configUtil->get_usb_blocked_classes().c_str(),
+                                                this->m_configUtil->get_usb_blocked_ports().c_str());
     this->m_systemUtil->set_usb_enable(setUSBEnable);
     // set ethernet
     this->m_systemUtil->do_init_ethernet();
     
-    // set restart system crontab
-    this->m_systemUtil->set_reboot_system_crontab(setIsRestartSystemCronJob, retCronMode.toString().toStdString().c_str(),
-                                                   minute.toInt(), hour.toInt(), dayofweek.toInt());
-    // restart crond service
-    this->m_systemUtil->do_restart_crond_service();
+    // set restart system crontab, crond is restarted when it changed and waited for in worker thread
+    RebootSchedule rebootSchedule = this->getRebootSchedule();
+    auto pCrontabFunction = std::bind(&QMLWindow::bg_setRebootSystemCrontab, this, this->m_systemUtil,
+        setIsRestartSystemCronJob, rebootSchedule);
+    this->m_jobScheduler->start(new Job(pCrontabFunction, JobPriority::BACKGROUND));
+    this->updateNextRebootLabel(systemForm, setIsRestartSystemCronJob, rebootSchedule);
 
     // readonly mode is changed
     if (setIsReadonly != currentIsReadonly) 
@@ -1776,6 +2079,11 @@ void QMLWindow::applySystemGeneralSetting(QObject *rootObject)
     }
 }
 
+bool QMLWindow::bg_setRebootSystemCrontab(ISystemUtility *pSystemUtil, bool enabled, RebootSchedule schedule)
+{
+    return pSystemUtil->set_reboot_system_crontab(enabled, schedule);
+}
+
 void QMLWindow::applySystemCOMSetting(QObject *rootObject)
 {
     bool isSuccess = true;
@@ -1796,6 +2104,46 @@ void QMLWindow::applySystemCOMSetting(QObject *rootObject)
     this->showMessageDialog(rootObject, isSuccess, nullptr, NONE_HANDLER_INDEX);
 }
 
+void QMLWindow::runComBenchmark(QObject *rootObject)
+{
+    QObject *systemForm = rootObject->findChild<QObject *>("systemForm");
+    QVariant com;
+    QMetaObject::invokeMethod(systemForm, "getCurrentComBenchmarkPort",
+                              Q_RETURN_ARG(QVariant, com));
+    // start loading
+    auto token = std::make_shared<JobToken>();
+    this->showLoadingIndicator(rootObject, true, token);
+
+    auto pBenchmarkFunction = std::bind(&QMLWindow::bg_runComBenchmark, this,
+        this->m_systemUtil, com.toString().toStdString(), token);
+    Job *job = new Job(pBenchmarkFunction, JobPriority::UI_CRITICAL, token);
+    connect(job, SIGNAL(workFinishedWithResult(QString, bool)),
+            this, SLOT(comBenchmarkIsFinished(QString, bool)));
+    this->m_jobScheduler->start(job);
+}
+
+pair<string, bool> QMLWindow::bg_runComBenchmark(ISystemUtility *pSystemUtil, string com, shared_ptr<JobToken> token)
+{
+    auto ret = pSystemUtil->run_com_port_benchmark(com.c_str(), [token] { return token->is_cancelled(); });
+    if (token->is_cancelled())
+        return make_pair(string(JOB_CANCELLED_MESSAGE), false);
+    return make_pair(ret.first.toString(), ret.second);
+}
+
+void QMLWindow::comBenchmarkIsFinished(QString result, bool isSuccess)
+{
+    QObject *systemForm = this->m_rootObject->findChild<QObject *>("systemForm");
+    bool isCancelled = this->isLoadingCancelled();
+    this->showLoadingIndicator(this->m_rootObject, false);
+    QMetaObject::invokeMethod(systemForm, "showComBenchmarkResult",
+                              Q_ARG(QVariant, QVariant(result)));
+    if (!isSuccess && !isCancelled)
+    {
+        string msg = "Loopback test failed, please check the loopback plug on RX and TX.";
+        this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+    }
+}
+
 void QMLWindow::on_systemWindow_questionDialog_readonly_okButton_clicked()
 {
     this->on_questionDialog_cancelButton_clicked();
@@ -1808,10 +2156,8 @@ void QMLWindow::on_systemWindow_questionDialog_readonly_okButton_clicked()
     // get binded function pointer
     auto pSetReadonlyMode = std::bind(&ISystemUtility::set_readonly_mode, this->m_systemUtil, !currentIsReadonly);
     // run in worker thread prevent block UI thread
-    this->m_workThread = new WorkerThread(pSetReadonlyMode, 1);
-    connect(this->m_workThread, &WorkerThread::workFinished,
-            this->m_workThread, &QObject::deleteLater);
-    this->m_workThread->start();
+    Job *job = new Job(pSetReadonlyMode, JobPriority::UI_CRITICAL);
+    this->m_jobScheduler->start(job);
 }
 
 void QMLWindow::on_systemWindow_questionDialog_user_login_okButton_clicked()
@@ -1826,10 +2172,8 @@ void QMLWindow::on_systemWindow_questionDialog_user_login_okButton_clicked()
     // get binded function pointer
     auto pSetUserLogin = std::bind(&ISystemUtility::set_system_user_login_desktop, this->m_systemUtil, !currentIsUserLogin, true);
     // run in worker thread prevent block UI thread
-    this->m_workThread = new WorkerThread(pSetUserLogin, 1);
-    connect(this->m_workThread, &WorkerThread::workFinished,
-            this->m_workThread, &QObject::deleteLater);
-    this->m_workThread->start();
+    Job *job = new Job(pSetUserLogin, JobPriority::UI_CRITICAL);
+    this->m_jobScheduler->start(job);
 }
 
 void QMLWindow::applySecuritySetting(QObject *rootObject)
@@ -1881,38 +2225,297 @@ void QMLWindow::applyLogoSetting(QObject *rootObject)
         msg = QString("Boot logo path is empty, please select boot logo file path.")
                         .toStdString();
     }
-    else
+    else if (!bgColor.isEmpty() && !is_hex_color(bgColor.toStdString().c_str()))
     {
-        isSuccess = cp_file(logoPath.toStdString().c_str(), BOOT_LOGO_PATH);
+        isSuccess = false;
+        msg = QString("Background color format is incorrect.")
+                        .toStdString();
     }
-    if (!bgColor.isEmpty())
+    else if (bgColor.toStdString().compare(PRESERVE_COLOR_HEX) == 0)
     {
-        if (!is_hex_color(bgColor.toStdString().c_str()))
-        {
-            isSuccess = false;
-            msg = QString("Background color format is incorrect.")
-                            .toStdString();
-        }
-        else if (bgColor.toStdString().compare(PRESERVE_COLOR_HEX) == 0)
-        {
-            isSuccess = false;
-            msg = QString("Please set another background color.")
-                            .toStdString();
-        }
-        else
-        {
-            isSuccess &= this->m_systemUtil->set_boot_logo_background_color(bgColor.toStdString().c_str());
-        }
+        isSuccess = false;
+        msg = QString("Please set another background color.")
+                        .toStdString();
+    }
+    if (!isSuccess)
+    {
+        this->showMessageDialog(rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+        return;
     }
+    // start loading
+    this->showLoadingIndicator(rootObject, true);
+    // decode, resample and fsync take seconds for a large image, run in worker thread
+    auto pApplyFunction = std::bind(&QMLWindow::bg_applyBootLogo, this,
+        this->m_bootLogoUtil, logoPath.toStdString(), bgColor.toStdString());
+    Job *job = new Job(pApplyFunction, JobPriority::UI_CRITICAL);
+    connect(job, SIGNAL(workFinishedWithResult(QString, bool)),
+            this, SLOT(applyLogoSettingIsFinished(QString, bool)));
+    this->m_jobScheduler->start(job);
+}
+
+pair<string, bool> QMLWindow::bg_applyBootLogo(IBootLogoUtility *pBootLogoUtil, string logoPath, string bgColor)
+{
+    // fitted to panel resolution, logo and color are replaced together
+    return pBootLogoUtil->apply_boot_logo(logoPath.c_str(), bgColor.c_str());
+}
+
+void QMLWindow::applyLogoSettingIsFinished(QString customMessage, bool isSuccess)
+{
+    this->showLoadingIndicator(this->m_rootObject, false);
     if (isSuccess)
     {
-        msg = "Boot logo has changed. Do you want to reboot?";
-        this->showQuestionDialog(rootObject, msg, OPERATE_REBOOT_HANDLER_INDEX);
+        string msg = "Boot logo has changed. Do you want to reboot?";
+        this->showQuestionDialog(this->m_rootObject, msg, OPERATE_REBOOT_HANDLER_INDEX);
+        return;
+    }
+    string msg = customMessage.toStdString();
+    this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+}
+
+void QMLWindow::runDiagnostics(QObject *rootObject, int diagnosticsType)
+{
+    QObject *diagnosticsForm = rootObject->findChild<QObject *>("diagnosticsForm");
+    QObject *hostTextField = diagnosticsForm->findChild<QObject *>("hostTextField");
+    QObject *portTextField = diagnosticsForm->findChild<QObject *>("portTextField");
+    QObject *countTextField = diagnosticsForm->findChild<QObject *>("countTextField");
+    string host = hostTextField->property("text").toString().trimmed().toStdString();
+    int port = portTextField->property("text").toInt();
+    int count = countTextField->property("text").toInt();
+    if (!host.empty() &&
+        !(is_valid_domain(host.c_str()) || is_valid_ip_address(host.c_str())))
+    {
+        string msg = "Please check that host is valid domain/ip format.";
+        this->showMessageDialog(rootObject, false, &msg, NONE_HANDLER_INDEX);
+        return;
+    }
+    // start loading
+    auto token = std::make_shared<JobToken>();
+    this->showLoadingIndicator(rootObject, true, token);
+
+    // read ui values in gui thread and pass them to worker thread
+    auto pDiagnosticsFunction = std::bind(&QMLWindow::bg_runDiagnostics, this,
+        this->m_networkDiagnosticsUtil, diagnosticsType, host, port, count, token);
+    Job *job = new Job(pDiagnosticsFunction, JobPriority::UI_CRITICAL, token);
+    connect(job, SIGNAL(workFinishedWithResult(QString, bool)),
+            this, SLOT(diagnosticsIsFinished(QString, bool)));
+    this->m_jobScheduler->start(job);
+}
+
+pair<string, bool> QMLWindow::bg_runDiagnostics(INetworkDiagnosticsUtility *pDiagnosticsUtil, int diagnosticsType,
+    string host, int port, int count, shared_ptr<JobToken> token)
+{
+    string result;
+    auto isCancelled = [token] { return token->is_cancelled(); };
+    char buff[BUFF_SIZE] = {0};
+    // empty host means testing against loopback
+    if (host.empty())
+        host = LOOPBACK_ADDRESS;
+    if (count <= 0)
+        count = DIAGNOSTICS_DEFAULT_COUNT;
+    if (port <= 0)
+        port = DIAGNOSTICS_DEFAULT_PORT;
+
+    if (diagnosticsType == DIAGNOSTICS_ICMP_LATENCY)
+    {
+        auto ret = pDiagnosticsUtil->icmp_latency(host.c_str(), count, DIAGNOSTICS_DEFAULT_TIMEOUT_MS, isCancelled);
+        if (isCancelled())
+            return make_pair(string(JOB_CANCELLED_MESSAGE), false);
+        snprintf(buff, BUFF_SIZE, "ICMP %s\n", host.c_str());
+        result = buff + ret.first.toString();
+        return make_pair(result, ret.second);
+    }
+    else if (diagnosticsType == DIAGNOSTICS_TCP_CONNECT_LATENCY)
+    {
+        auto ret = pDiagnosticsUtil->tcp_connect_latency(host.c_str(), port, count, DIAGNOSTICS_DEFAULT_TIMEOUT_MS, isCancelled);
+        if (isCancelled())
+            return make_pair(string(JOB_CANCELLED_MESSAGE), false);
+        snprintf(buff, BUFF_SIZE, "TCP connect %s:%d\n", host.c_str(), port);
+        result = buff + ret.first.toString();
+        return make_pair(result, ret.second);
+    }
+    // loopback uses built-in sink server, remote host needs a discard service on the port
+    pair<double, bool> ret;
+    if (host.compare(LOOPBACK_ADDRESS) == 0)
+    {
+        ret = pDiagnosticsUtil->tcp_loopback_throughput(DIAGNOSTICS_THROUGHPUT_SECONDS, isCancelled);
+        snprintf(buff, BUFF_SIZE, "TCP throughput %s (built-in sink)\n%.2f Mbit/s\n", host.c_str(), ret.first);
     }
     else
     {
-        this->showMessageDialog(rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+        ret = pDiagnosticsUtil->tcp_throughput(host.c_str(), port, DIAGNOSTICS_THROUGHPUT_SECONDS, isCancelled);
+        snprintf(buff, BUFF_SIZE, "TCP throughput %s:%d\n%.2f Mbit/s\n", host.c_str(), port, ret.first);
+    }
+    if (isCancelled())
+        return make_pair(string(JOB_CANCELLED_MESSAGE), false);
+    result = buff;
+    return make_pair(result, ret.second);
+}
+
+void QMLWindow::diagnosticsIsFinished(QString result, bool isSuccess)
+{
+    QObject *diagnosticsForm = this->m_rootObject->findChild<QObject *>("diagnosticsForm");
+    bool isCancelled = this->isLoadingCancelled();
+    this->showLoadingIndicator(this->m_rootObject, false);
+    QMetaObject::invokeMethod(diagnosticsForm, "showResult",
+                              Q_ARG(QVariant, QVariant(result)));
+    if (!isSuccess && !isCancelled)
+    {
+        string msg = "Diagnostics failed, please check the host and port.";
+        this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+    }
+    // counters changed after test
+    this->initDiagnosticsWindowValue(this->m_rootObject);
+}
+
+void QMLWindow::runStorageBenchmark(QObject *rootObject)
+{
+    QObject *storageForm = rootObject->findChild<QObject *>("storageForm");
+    QObject *benchmarkSizeTextField = storageForm->findChild<QObject *>("benchmarkSizeTextField");
+    QObject *benchmarkQueueDepthTextField = storageForm->findChild<QObject *>("benchmarkQueueDepthTextField");
+    QVariant partition;
+    QVariant mountPoint;
+    QMetaObject::invokeMethod(storageForm, "getCurrentBenchmarkPartition",
+                              Q_RETURN_ARG(QVariant, partition));
+    QMetaObject::invokeMethod(storageForm, "getCurrentBenchmarkMountPoint",
+                              Q_RETURN_ARG(QVariant, mountPoint));
+    string folder = mountPoint.toString().toStdString();
+    int fileSizeMB = benchmarkSizeTextField->property("text").toInt();
+    int queueDepth = benchmarkQueueDepthTextField->property("text").toInt();
+    if (folder.empty())
+    {
+        string msg = "Please select a mounted volume.";
+        this->showMessageDialog(rootObject, false, &msg, NONE_HANDLER_INDEX);
+        return;
+    }
+    if (fileSizeMB > BENCHMARK_MAX_FILE_SIZE_MB || queueDepth > BENCHMARK_MAX_QUEUE_DEPTH)
+    {
+        char buff[BUFF_SIZE] = {0};
+        snprintf(buff, BUFF_SIZE, "File size cannot exceed %d MB and queue depth cannot exceed %d.",
+                 BENCHMARK_MAX_FILE_SIZE_MB, BENCHMARK_MAX_QUEUE_DEPTH);
+        string msg = buff;
+        this->showMessageDialog(rootObject, false, &msg, NONE_HANDLER_INDEX);
+        return;
+    }
+    this->m_storageBenchmarkDevice = partition.toString().toStdString();
+    this->m_storageBenchmarkResults.clear();
+    // start loading
+    auto token = std::make_shared<JobToken>();
+    this->showLoadingIndicator(rootObject, true, token);
+
+    // the worker fills the results, they are handed to gui thread by the finished slot
+    auto results = std::make_shared<vector<BenchmarkResult>>();
+    auto pBenchmarkFunction = std::bind(&QMLWindow::bg_runStorageBenchmark, this,
+        this->m_storageBenchmarkUtil, folder, fileSizeMB, queueDepth, results, token);
+    Job *job = new Job(pBenchmarkFunction, JobPriority::UI_CRITICAL, token);
+    connect(job, &Job::workFinishedWithResult, this, [this, results](QString result, bool isSuccess) {
+        this->m_storageBenchmarkResults = *results;
+        this->storageBenchmarkIsFinished(result, isSuccess);
+    });
+    this->m_jobScheduler->start(job);
+}
+
+pair<string, bool> QMLWindow::bg_runStorageBenchmark(IStorageBenchmarkUtility *pBenchmarkUtil,
+    string folder, int fileSizeMB, int queueDepth, shared_ptr<vector<BenchmarkResult>> results,
+    shared_ptr<JobToken> token)
+{
+    string result;
+    auto ret = pBenchmarkUtil->run_benchmark(folder.c_str(), fileSizeMB, queueDepth,
+        [token] { return token->is_cancelled(); });
+    if (token->is_cancelled())
+        return make_pair(string(JOB_CANCELLED_MESSAGE), false);
+    for (auto &itr : ret.first)
+    {
+        result.append(itr.toString());
+    }
+    if (!ret.first.empty())
+    {
+        result.append(ret.first.front().getDirect() ? "O_DIRECT" : "buffered");
+        result.append(", ");
+        result.append(ret.first.front().getEngine());
+        result.append("\n");
+    }
+    // only touched by gui thread once the work finished signal is delivered
+    *results = ret.first;
+    return make_pair(result, ret.second);
+}
+
+void QMLWindow::storageBenchmarkIsFinished(QString result, bool isSuccess)
+{
+    QObject *storageForm = this->m_rootObject->findChild<QObject *>("storageForm");
+    bool isCancelled = this->isLoadingCancelled();
+    this->showLoadingIndicator(this->m_rootObject, false);
+    QMetaObject::invokeMethod(storageForm, "showBenchmarkResult",
+                              Q_ARG(QVariant, QVariant(result)));
+    if (!isSuccess && !isCancelled)
+    {
+        string msg = "Benchmark failed, please check the free space of the volume.";
+        this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+    }
+    // usage of the volume changed during test
+    this->storageMountChangedEvent();
+}
+
+void QMLWindow::exportScreenshots(QObject *rootObject, QString folderPath, bool isArchive)
+{
+    if (this->m_screenshotJob)
+        return;
+    QObject *operateForm = rootObject->findChild<QObject *>("operateForm");
+    QMetaObject::invokeMethod(operateForm, "showScreenshotProgress",
+                              Q_ARG(QVariant, QVariant(true)));
+    this->m_screenshotExportFolder = folderPath.toStdString();
+
+    auto token = std::make_shared<JobToken>();
+    auto pExportFunction = std::bind(&QMLWindow::bg_exportScreenshots, this,
+        this->m_screenshotUtil, folderPath.toStdString(), isArchive, token);
+    // the gui stays usable while exporting
+    this->m_screenshotJob = new Job(pExportFunction, JobPriority::BACKGROUND, token);
+    connect(this->m_screenshotJob, SIGNAL(progressChanged(int, QString)),
+            this, SLOT(screenshotExportProgressChanged(int, QString)));
+    connect(this->m_screenshotJob, SIGNAL(workFinishedWithResult(QString, bool)),
+            this, SLOT(screenshotExportIsFinished(QString, bool)));
+    this->m_jobScheduler->start(this->m_screenshotJob);
+}
+
+pair<string, bool> QMLWindow::bg_exportScreenshots(IScreenshotUtility *pScreenshotUtil, string folder, bool isArchive,
+    shared_ptr<JobToken> token)
+{
+    // progress is reported from copy workers, the job hands it over to gui thread
+    auto progress = [token](int doneFiles, int totalFiles, const string& fileName, double bytesPerSecond) {
+        int percentage = totalFiles > 0 ? doneFiles * 100 / totalFiles : 0;
+        string progressText = std::to_string(doneFiles) + "/" + std::to_string(totalFiles) + " " + fileName +
+            "\n" + format_size((unsigned long long)bytesPerSecond) + "/s";
+        token->set_progress(percentage, progressText);
+    };
+    auto isCancelled = [token] { return token->is_cancelled(); };
+    if (isArchive)
+        return pScreenshotUtil->export_screenshots_archive(folder.c_str(), progress, isCancelled);
+    return pScreenshotUtil->export_screenshots(folder.c_str(), progress, isCancelled);
+}
+
+void QMLWindow::screenshotExportProgressChanged(int percentage, QString progressText)
+{
+    QObject *operateForm = this->m_rootObject->findChild<QObject *>("operateForm");
+    QMetaObject::invokeMethod(operateForm, "updateScreenshotProgress",
+                              Q_ARG(QVariant, QVariant(percentage)),
+                              Q_ARG(QVariant, QVariant(progressText)));
+}
+
+void QMLWindow::screenshotExportIsFinished(QString customMessage, bool isSuccess)
+{
+    this->m_screenshotJob = nullptr;
+    QObject *operateForm = this->m_rootObject->findChild<QObject *>("operateForm");
+    QMetaObject::invokeMethod(operateForm, "showScreenshotProgress",
+                              Q_ARG(QVariant, QVariant(false)));
+    string msg = customMessage.toStdString();
+    if (isSuccess)
+    {
+        // archive mode reports the archive file
+        QString exportPath = customMessage.isEmpty() ? QString(this->m_screenshotExportFolder.c_str()) : customMessage;
+        msg = QString("Export screenshots to %1 is success. Do you want to delete screenshots?").arg(exportPath).toStdString();
+        this->showQuestionDialog(this->m_rootObject, msg, OPERATE_DELETE_SCREENSHOTS_HANDLER_INDEX);
+        return;
     }
+    this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
 }
 
 void QMLWindow::applyPasswordSetting(QObject *rootObject)
@@ -2341,13 +2944,14 @@ bool QMLWindow::checkWizardEthernetNetworkFields(QObject *rootObject, const char
     return isSuccess;
 }
 
-bool QMLWindow::applyWizardTimeSetting(QObject *rootObject)
+void QMLWindow::applyWizardTimeSetting(QObject *rootObject)
 {
-    bool isSuccess = true;
     // skip if not showed
     if (!this->m_wizardPageShowedMap[WIZARD_TIME])
-        return isSuccess;
-    string msg;
+    {
+        this->applyWizardRemainingSettings(rootObject);
+        return;
+    }
     QObject *wiztimeForm = rootObject->findChild<QObject *>("wiztimeForm");
     QObject *timezoneTextField = wiztimeForm->findChild<QObject *>("timezoneTextField");
     QObject *ntpRadioButton = wiztimeForm->findChild<QObject *>("ntpRadioButton");
@@ -2367,39 +2971,60 @@ bool QMLWindow::applyWizardTimeSetting(QObject *rootObject)
     if (!ntpServer.isEmpty() && 
         !(is_valid_domain(ntpServer.toStdString().c_str()) || is_valid_ip_address(ntpServer.toStdString().c_str())) )
     {
-        isSuccess = false;
-        msg = "Please check that ntp server is valid domain/ip format.";
+        string msg = "Please check that ntp server is valid domain/ip format.";
+        this->m_wizardStatusMap[WIZARD_TIME] = false;
+        this->showMessageDialog(rootObject, false, &msg, NONE_HANDLER_INDEX);
+        return;
     }
-    else
+    // save to config
+    this->m_configUtil->set_timezone(timezone.toStdString().c_str());
+    this->m_configUtil->set_ntp_enable(setIsNTP);
+    this->m_configUtil->set_ntp_server(ntpServer.toStdString().c_str());
+    this->m_configUtil->set_date(date.toStdString().c_str());
+    this->m_configUtil->set_hour(hour.toInt());
+    this->m_configUtil->set_minute(minute.toInt());
+    this->m_configUtil->set_second(second.toInt());
+    // start loading
+    this->showLoadingIndicator(rootObject, true);
+    // disabling ntp waits for timesyncd to stop, run in worker thread prevent block UI thread
+    auto pApplyFunction = std::bind(&QMLWindow::bg_applyWizardTimeSetting, this, this->m_timeUtil,
+        timezone.toStdString(), setIsNTP, ntpServer.toStdString(), datetime.toStdString());
+    Job *job = new Job(pApplyFunction, JobPriority::UI_CRITICAL);
+    connect(job, SIGNAL(workFinishedWithResult(QString, bool)),
+            this, SLOT(applyWizardTimeSettingIsFinished(QString, bool)));
+    this->m_jobScheduler->start(job);
+}
+
+pair<string, bool> QMLWindow::bg_applyWizardTimeSetting(ITimeUtility *pTimeUtil, string timezone, bool setIsNTP,
+    string ntpServer, string datetime)
+{
+    bool isSuccess = true;
+    // set timezone
+    auto result = pTimeUtil->set_timezone(timezone.c_str());
+    isSuccess &= result.second;
+    // set sync with ntp
+    result = pTimeUtil->set_sync_with_ntp_server(setIsNTP, ntpServer.c_str());
+    isSuccess &= result.second;
+    if (!setIsNTP)
     {
-        // set timezone
-        auto result = this->m_timeUtil->set_timezone(timezone.toStdString().c_str());
+        // set manual time
+        result = pTimeUtil->set_manual_date_time(datetime.c_str());
         isSuccess &= result.second;
-        // set sync with ntp
-        result = this->m_timeUtil->set_sync_with_ntp_server(setIsNTP, ntpServer.toStdString().c_str());
-        isSuccess &= result.second;
-        if (!setIsNTP)
-        {
-            // set manual time
-            result = this->m_timeUtil->set_manual_date_time(datetime.toStdString().c_str());
-            isSuccess &= result.second;
-        }
-        msg = result.first;
-        // save to config
-        this->m_configUtil->set_timezone(timezone.toStdString().c_str());
-        this->m_configUtil->set_ntp_enable(setIsNTP);
-        this->m_configUtil->set_ntp_server(ntpServer.toStdString().c_str());
-        this->m_configUtil->set_date(date.toStdString().c_str());
-        this->m_configUtil->set_hour(hour.toInt());
-        this->m_configUtil->set_minute(minute.toInt());
-        this->m_configUtil->set_second(second.toInt());
     }
+    return make_pair(result.first, isSuccess);
+}
+
+void QMLWindow::applyWizardTimeSettingIsFinished(QString customMessage, bool isSuccess)
+{
+    this->showLoadingIndicator(this->m_rootObject, false);
+    this->m_wizardStatusMap[WIZARD_TIME] = isSuccess;
     if (!isSuccess)
     {
-        this->showMessageDialog(rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+        string msg = customMessage.toStdString();
+        this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+        return;
     }
-    this->m_wizardStatusMap[WIZARD_TIME] = isSuccess;
-    return isSuccess;
+    this->applyWizardRemainingSettings(this->m_rootObject);
 }
 
 bool QMLWindow::applyWizardScreenSetting(QObject *rootObject)
@@ -2524,25 +3149,28 @@ bool QMLWindow::applyWizardStartupSetting(QObject *rootObject)
     return isSuccess;
 }
 
-bool QMLWindow::applyWizard(QObject *rootObject)
+void QMLWindow::applyWizard(QObject *rootObject)
+{
+    if (!this->applyWizardNetworkSetting(rootObject))
+        return;
+    // time setting runs in a job, the remaining pages are applied once it finished
+    this->applyWizardTimeSetting(rootObject);
+}
+
+void QMLWindow::applyWizardRemainingSettings(QObject *rootObject)
 {
     bool isSuccess = false;
-    isSuccess = this->applyWizardNetworkSetting(this->m_rootObject);
-    if (!isSuccess)
-        return isSuccess;
-    isSuccess = this->applyWizardTimeSetting(this->m_rootObject);
+    isSuccess = this->applyWizardScreenSetting(rootObject);
     if (!isSuccess)
-        return isSuccess;
-    isSuccess = this->applyWizardScreenSetting(this->m_rootObject);
-    if (!isSuccess)
-        return isSuccess;
-    isSuccess = this->applyWizardStartupSetting(this->m_rootObject);
+        return;
+    isSuccess = this->applyWizardStartupSetting(rootObject);
     if (!isSuccess)
-        return isSuccess;
-    isSuccess = this->applyCredentialsSetting(this->m_rootObject);
+        return;
+    isSuccess = this->applyCredentialsSetting(rootObject);
     if (!isSuccess)
-        return isSuccess;
-    return isSuccess;
+        return;
+    // finished
+    emit closeWindow();
 }
 
 void QMLWindow::moveToNextPage(QObject *rootObject, const string &currentPageName)
@@ -2564,11 +3192,8 @@ void QMLWindow::moveToNextPage(QObject *rootObject, const string &currentPageNam
     }
     // empty means last page
     if (pageName.empty()) {
-        bool isSuccess = this->applyWizard(rootObject);
-        // finished
-        if (isSuccess) {
-            emit closeWindow();
-        }
+        // window is closed when all pages are applied
+        this->applyWizard(rootObject);
         return;
     }
     // press page button
@@ -2581,9 +3206,8 @@ void QMLWindow::moveToNextPage(QObject *rootObject, const string &currentPageNam
     QMetaObject::invokeMethod(sideBar, "showPage");
 }
 
-bool QMLWindow::downloadFTPFile(QObject *rootObject)
+void QMLWindow::downloadFTPFile(QObject *rootObject)
 {
-    bool isSuccess = true;
     QObject *ftpForm = rootObject->findChild<QObject *>("ftpForm");
     QObject *serverTextField = ftpForm->findChild<QObject *>("serverTextField");
     QObject *portTextField = ftpForm->findChild<QObject *>("portTextField");
@@ -2604,22 +3228,34 @@ bool QMLWindow::downloadFTPFile(QObject *rootObject)
     this->m_configUtil->set_ftp_server_password(password.toStdString().c_str());
     this->m_configUtil->set_ftp_server_remote_path(remotePath.toStdString().c_str());
     this->m_configUtil->set_ftp_server_local_path(localPath.toStdString().c_str());
-    isSuccess = this->m_ftpUtil->download_from_remote(
-        address.toStdString().c_str(),
-        port.toStdString().c_str(),
-        username.toStdString().c_str(),
-        password.toStdString().c_str(),
-        remotePath.toStdString().c_str(),
-        localPath.toStdString().c_str()
-    );
 
-    return isSuccess;
+    // start loading
+    auto token = std::make_shared<JobToken>();
+    this->showLoadingIndicator(rootObject, true, token);
+
+    // read ui values in gui thread and pass them to worker thread
+    auto pDownloadFunction = std::bind(&QMLWindow::bg_downloadFTPFile, this, this->m_ftpUtil,
+        address.toStdString(), port.toStdString(), username.toStdString(), password.toStdString(),
+        remotePath.toStdString(), localPath.toStdString(), token);
+    Job *job = new Job(pDownloadFunction, JobPriority::UI_CRITICAL, token);
+    connect(job, SIGNAL(workFinished(bool)),
+            this, SLOT(downloadIsFinished(bool)));
+    this->m_jobScheduler->start(job);
+}
+
+bool QMLWindow::bg_downloadFTPFile(IFTPUtility *pFTPUtil, string server, string port, string username,
+    string password, string remotePath, string localPath, shared_ptr<JobToken> token)
+{
+    return pFTPUtil->download_from_remote(server.c_str(), port.c_str(), username.c_str(), password.c_str(),
+        remotePath.c_str(), localPath.c_str(), [token] { return token->is_cancelled(); });
 }
 
 void QMLWindow::downloadIsFinished(bool isSuccess)
 {
+    bool isCancelled = this->isLoadingCancelled();
     this->showLoadingIndicator(this->m_rootObject, false);
-    this->showMessageDialog(this->m_rootObject, isSuccess, nullptr, NONE_HANDLER_INDEX);
+    if (!isCancelled)
+        this->showMessageDialog(this->m_rootObject, isSuccess, nullptr, NONE_HANDLER_INDEX);
 }
 
 void QMLWindow::on_screen_toggled()
@@ -2634,7 +3270,7 @@ void QMLWindow::on_network_toggled()
 
 void QMLWindow::on_time_toggled()
 {
-    this->initTimeWindowValue(this->m_rootObject, this->m_timezones);
+    this->initTimeWindowValue(this->m_rootObject);
 }
 
 void QMLWindow::on_storage_toggled()
@@ -2676,6 +3312,11 @@ void QMLWindow::on_password_toggled()
     this->initPasswordWindowValue(this->m_rootObject);
 }
 
+void QMLWindow::on_diagnostics_toggled()
+{
+    this->initDiagnosticsWindowValue(this->m_rootObject);
+}
+
 void QMLWindow::on_about_toggled()
 {
     this->initAboutWindowValue(this->m_rootObject);
@@ -2726,6 +3367,11 @@ void QMLWindow::on_systemWindow_comApplyButton_clicked()
     this->applySystemCOMSetting(this->m_rootObject);
 }
 
+void QMLWindow::on_systemWindow_comBenchmarkButton_clicked()
+{
+    this->runComBenchmark(this->m_rootObject);
+}
+
 void QMLWindow::on_securityWindow_applyButton_clicked()
 {
     this->applySecuritySetting(this->m_rootObject);
@@ -2733,18 +3379,7 @@ void QMLWindow::on_securityWindow_applyButton_clicked()
 
 void QMLWindow::on_ftpWindow_downloadButton_clicked()
 {
-    // start loading
-    this->showLoadingIndicator(this->m_rootObject, true);
-    
-    // get binded function pointer
-    auto pDownloadFunction = std::bind(&QMLWindow::downloadFTPFile, this, this->m_rootObject);
-    // run in worker thread prevent block UI thread
-    this->m_workThread = new WorkerThread(pDownloadFunction, 1);
-    connect(this->m_workThread, SIGNAL(workFinished(bool)),
-            this, SLOT(downloadIsFinished(bool)));
-    connect(this->m_workThread, &WorkerThread::finished,
-            this->m_workThread, &QObject::deleteLater);
-    this->m_workThread->start();
+    this->downloadFTPFile(this->m_rootObject);
 }
 
 void QMLWindow::on_logoWindow_applyButton_clicked()
@@ -2816,7 +3451,11 @@ void QMLWindow::on_wizardStartupWindow_nextButton_clicked()
 
 void QMLWindow::on_screenWindow_brightChanged_signal(int value)
 {
-    this->m_screenUtil->set_brightness(value);
+    this->m_brightnessController->requestBrightness(value);
+}
+
+void QMLWindow::brightnessSettledEvent(int value)
+{
     this->m_configUtil->set_brightness(value);
 }
 
@@ -3072,6 +3711,17 @@ void QMLWindow::on_loginDialog_cancelButton_clicked()
     emit closeWindow();
 }
 
+void QMLWindow::on_loadingIndicator_cancelButton_clicked()
+{
+    if (!this->m_loadingToken)
+        return;
+    // the finished slot of the job closes the indicator
+    this->m_loadingToken->cancel();
+    QObject *msgbox = this->m_rootObject->findChild<QObject *>("loadingIndicator");
+    QObject *loadingCancelButton = msgbox->findChild<QObject *>("loadingCancelButton");
+    loadingCancelButton->setProperty("enabled", QVariant(false));
+}
+
 void QMLWindow::on_questionDialog_cancelButton_clicked()
 {
     // disconnect ok button handler
@@ -3105,21 +3755,18 @@ void QMLWindow::on_operateWindow_importFileDialog_accepted()
     if (filePath.isEmpty()) {
         filePath = fileDialog->property("selectedFile").toString().replace(strFilePrefix, "");
     }
-    m_threadParameter = filePath.toStdString();
     QMetaObject::invokeMethod(fileDialog, "close");
     // start loading
     this->showLoadingIndicator(this->m_rootObject, true);
     
-    // get binded function pointer
-    auto pImportFunction = std::bind(
-        &RestoreUtility::import_config, this->m_restoreUtility, m_threadParameter.c_str(), this->m_configUtil);
+    // the job owns a copy of the path, a later dialog cannot change it while importing
+    auto pImportFunction = std::bind(&QMLWindow::bg_importConfig, this,
+        this->m_restoreUtility, filePath.toStdString(), this->m_configUtil);
     // run in worker thread prevent block UI thread
-    this->m_workThread = new WorkerThread(pImportFunction, 1);
-    connect(this->m_workThread, SIGNAL(workFinishedWithResult(QString, bool)),
+    Job *job = new Job(pImportFunction, JobPriority::UI_CRITICAL);
+    connect(job, SIGNAL(workFinishedWithResult(QString, bool)),
             this, SLOT(importConfigIsFinished(QString, bool)));
-    connect(this->m_workThread, &WorkerThread::finished,
-            this->m_workThread, &QObject::deleteLater);
-    this->m_workThread->start();
+    this->m_jobScheduler->start(job);
 }
 
 void QMLWindow::on_operateWindow_exportFolderDialog_accepted()
@@ -3151,14 +3798,10 @@ void QMLWindow::on_operateWindow_exportFolderDialog_accepted()
             msg = QString("Export settings to %1 is success.").arg(result.first.c_str()).toStdString();
         }
     } else {
-        auto result = this->m_screenUtil->export_screenshots(folderPath.toStdString().c_str());
-        isSuccess = result.second;
-        msg = result.first;
-        if (isSuccess) {
-            msg = QString("Export screenshots to %1 is success. Do you want to delete screenshots?").arg(folderPath).toStdString();
-            this->showQuestionDialog(this->m_rootObject, msg, OPERATE_DELETE_SCREENSHOTS_HANDLER_INDEX);
-            return;
-        }
+        QObject *screenshotArchiveSwitch = this->m_rootObject->findChild<QObject *>("screenshotArchiveSwitch");
+        bool isArchive = screenshotArchiveSwitch && screenshotArchiveSwitch->property("checked").toBool();
+        this->exportScreenshots(this->m_rootObject, folderPath, isArchive);
+        return;
     }
     this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
 }
@@ -3209,7 +3852,7 @@ void QMLWindow::on_operateWindow_factoryResetButton_clicked()
 void QMLWindow::on_operateWindow_exportScreenshotsButton_clicked()
 {
     string msg;
-    int count = this->m_screenUtil->get_screenshots_count();
+    int count = this->m_screenshotUtil->get_screenshots_count();
     if (count == 0)
     {
         msg = "No screenshot. Unable to export screenshots.";
@@ -3226,6 +3869,26 @@ void QMLWindow::on_operateWindow_exportScreenshotsButton_clicked()
     }
 }
 
+void QMLWindow::on_operateWindow_viewScreenshotsButton_clicked()
+{
+    this->m_screenshotGalleryModel->refresh();
+    if (this->m_screenshotGalleryModel->rowCount() == 0)
+    {
+        string msg = "No screenshot.";
+        this->showMessageDialog(this->m_rootObject, false, &msg, NONE_HANDLER_INDEX);
+        return;
+    }
+    QObject *operateForm = this->m_rootObject->findChild<QObject *>("operateForm");
+    QMetaObject::invokeMethod(operateForm, "openScreenshotGallery");
+}
+
+void QMLWindow::on_operateWindow_cancelScreenshotsButton_clicked()
+{
+    // workers stop after current chunk, partial files are removed. a job still queued never starts
+    if (this->m_screenshotJob)
+        this->m_screenshotJob->get_token()->cancel();
+}
+
 void QMLWindow::on_operateWindow_questionDialog_reboot_okButton_clicked()
 {
     this->on_questionDialog_cancelButton_clicked();
@@ -3248,7 +3911,9 @@ void QMLWindow::on_operateWindow_questionDialog_deleteScreenshots_okButton_click
 {
     this->on_questionDialog_cancelButton_clicked();
     
-    this->m_screenUtil->delete_screenshots();
+    this->m_screenshotUtil->delete_screenshots();
+    // drops thumbnails of deleted screenshots
+    this->m_screenshotGalleryModel->refresh();
 }
 
 void QMLWindow::on_operateWindow_questionDialog_factoryReset_okButton_clicked()
@@ -3282,10 +3947,64 @@ void QMLWindow::on_operateWindow_questionDialog_factoryReset_okButton_clicked()
     // get binded function pointer
     auto pFactoryResetFunction = std::bind(&IUpdateUtility::start_factory_reset, this->m_updateUtil);
     // run in worker thread prevent block UI thread
-    this->m_workThread = new WorkerThread(pFactoryResetFunction, 1);
-    connect(this->m_workThread, &WorkerThread::finished,
-            this->m_workThread, &QObject::deleteLater);
-    this->m_workThread->start();
+    Job *job = new Job(pFactoryResetFunction, JobPriority::UI_CRITICAL);
+    this->m_jobScheduler->start(job);
+}
+
+void QMLWindow::on_storageWindow_benchmarkButton_clicked()
+{
+    this->runStorageBenchmark(this->m_rootObject);
+}
+
+void QMLWindow::on_storageWindow_benchmarkExportButton_clicked()
+{
+    QObject *storageForm = this->m_rootObject->findChild<QObject *>("storageForm");
+    QVariant mountPoint;
+    QMetaObject::invokeMethod(storageForm, "getCurrentBenchmarkMountPoint",
+                              Q_RETURN_ARG(QVariant, mountPoint));
+    string folder = mountPoint.toString().toStdString();
+    if (this->m_storageBenchmarkResults.empty() || folder.empty())
+    {
+        string msg = "Please run benchmark on a mounted volume first.";
+        this->showMessageDialog(this->m_rootObject, false, &msg, NONE_HANDLER_INDEX);
+        return;
+    }
+    // export to the selected volume, ex: an sd card taken back for analysis
+    string filePath = folder + "/" + BENCHMARK_JSON_FILE_NAME;
+    bool isSuccess = this->m_storageBenchmarkUtil->export_json(this->m_storageBenchmarkResults,
+        this->m_storageBenchmarkDevice.c_str(), filePath.c_str());
+    string msg = isSuccess ? "Exported to " + filePath : "Export failed.";
+    this->showMessageDialog(this->m_rootObject, isSuccess, &msg, NONE_HANDLER_INDEX);
+}
+
+void QMLWindow::on_storageWindow_swipeView_changed()
+{
+    this->initStorageTelemetryValue(this->m_rootObject);
+}
+
+void QMLWindow::on_storageWindow_telemetryDeviceComboBox_changed()
+{
+    this->initStorageTelemetryValue(this->m_rootObject);
+}
+
+void QMLWindow::on_diagnosticsWindow_pingButton_clicked()
+{
+    this->runDiagnostics(this->m_rootObject, DIAGNOSTICS_ICMP_LATENCY);
+}
+
+void QMLWindow::on_diagnosticsWindow_connectButton_clicked()
+{
+    this->runDiagnostics(this->m_rootObject, DIAGNOSTICS_TCP_CONNECT_LATENCY);
+}
+
+void QMLWindow::on_diagnosticsWindow_throughputButton_clicked()
+{
+    this->runDiagnostics(this->m_rootObject, DIAGNOSTICS_TCP_THROUGHPUT);
+}
+
+void QMLWindow::on_diagnosticsWindow_refreshButton_clicked()
+{
+    this->initDiagnosticsWindowValue(this->m_rootObject);
 }
 
 void QMLWindow::on_aboutWindow_licenseButton_clicked()
@@ -3393,15 +4112,24 @@ void QMLWindow::showQuestionDialog(QObject *rootObject, string message, int hand
     QMetaObject::invokeMethod(msgbox, "open");
 }
 
-void QMLWindow::showLoadingIndicator(QObject *rootObject, bool isShow)
+void QMLWindow::showLoadingIndicator(QObject *rootObject, bool isShow, shared_ptr<JobToken> token)
 {
     QObject *msgbox = rootObject->findChild<QObject *>("loadingIndicator");
+    QObject *loadingCancelButton = msgbox->findChild<QObject *>("loadingCancelButton");
+    this->m_loadingToken = isShow ? token : nullptr;
+    loadingCancelButton->setProperty("visible", QVariant(this->m_loadingToken != nullptr));
+    loadingCancelButton->setProperty("enabled", QVariant(true));
     if (isShow)
         QMetaObject::invokeMethod(msgbox, "open");
     else
         QMetaObject::invokeMethod(msgbox, "close");
 }
 
+bool QMLWindow::isLoadingCancelled()
+{
+    return this->m_loadingToken && this->m_loadingToken->is_cancelled();
+}
+
 void QMLWindow::showLoginDialog(QObject *rootObject, bool isLogin)
 {
     QObject *loginPopup = rootObject->findChild<QObject *>("loginPopup");
@@ -3445,6 +4173,164 @@ void QMLWindow::stopNetworkMonitor()
     }
 }
 
+void QMLWindow::startStorageMonitor()
+{
+    // stop previous
+    this->stopStorageMonitor();
+
+    this->m_ueventMonitor = new UEventMonitor(this);
+    QObject::connect(this->m_ueventMonitor, SIGNAL(blockDeviceChanged(QString, QString, QString)),
+                     this, SLOT(storageDeviceChangedEvent(QString, QString, QString)));
+    QObject::connect(this->m_ueventMonitor, SIGNAL(mountTableChanged()),
+                     this, SLOT(storageMountChangedEvent()));
+    QObject::connect(this->m_ueventMonitor, SIGNAL(usbDeviceChanged(QString, QString)),
+                     this, SLOT(usbDeviceChangedEvent(QString, QString)));
+    this->m_ueventMonitor->start(PROC_MOUNTINFO_FILE);
+
+    // devices plugged before the monitor started are judged once here
+    string usbBlockedClasses = this->m_configUtil->get_usb_blocked_classes();
+    string usbBlockedPorts = this->m_configUtil->get_usb_blocked_ports();
+    this->m_systemUtil->set_usb_blocked_devices(usbBlockedClasses.c_str(), usbBlockedPorts.c_str());
+    // the saved switch wins, sysfs defaults are off with a block list even when usb is on
+    bool isUSBEnabled = this->m_configUtil->get_usb_enable_string().empty() ?
+        this->m_systemUtil->get_usb_enable() : this->m_configUtil->get_usb_enable();
+    if (!usbBlockedClasses.empty() || !usbBlockedPorts.empty() || isUSBEnabled != this->m_systemUtil->get_usb_enable())
+        this->m_systemUtil->set_usb_enable(isUSBEnabled);
+}
+
+void QMLWindow::startStorageTelemetry()
+{
+    // stop previous
+    this->stopStorageTelemetry();
+
+    // sample in background so history is there when the page is opened
+    this->m_storageTelemetry->sample();
+    this->m_storageTelemetryTimer = new QTimer(this);
+    QObject::connect(this->m_storageTelemetryTimer, SIGNAL(timeout()),
+                     this, SLOT(storageTelemetryTimeout()));
+    this->m_storageTelemetryTimer->start(STORAGE_TELEMETRY_INTERVAL_MS);
+}
+
+void QMLWindow::stopStorageTelemetry()
+{
+    if (this->m_storageTelemetryTimer) {
+        this->m_storageTelemetryTimer->stop();
+        delete this->m_storageTelemetryTimer;
+        this->m_storageTelemetryTimer = nullptr;
+    }
+}
+
+void QMLWindow::storageTelemetryTimeout()
+{
+    const static int TELEMETRY_INDEX = 3;
+    this->m_storageTelemetry->sample();
+    // only redraw when telemetry tab is visible
+    QObject *storageForm = this->m_rootObject->findChild<QObject *>("storageForm");
+    QObject *storageSwipeView = storageForm->findChild<QObject *>("storageSwipeView");
+    if (!storageForm->property("visible").toBool() ||
+        storageSwipeView->property("currentIndex").toInt() != TELEMETRY_INDEX)
+        return;
+    this->initStorageTelemetryValue(this->m_rootObject);
+}
+
+void QMLWindow::startTimeSyncMonitor()
+{
+    // stop previous
+    this->stopTimeSyncMonitor();
+
+    // ntp measurements arrive as timesyncd reports them, the kernel clock is sampled
+    this->m_ntpMessageWatcher->start();
+    this->m_timeSyncMonitor->sample();
+    this->m_timeSyncTimer = new QTimer(this);
+    QObject::connect(this->m_timeSyncTimer, SIGNAL(timeout()),
+                     this, SLOT(timeSyncTimeout()));
+    this->m_timeSyncTimer->start(TIME_SYNC_INTERVAL_MS);
+}
+
+void QMLWindow::stopTimeSyncMonitor()
+{
+    if (this->m_timeSyncTimer) {
+        this->m_timeSyncTimer->stop();
+        delete this->m_timeSyncTimer;
+        this->m_timeSyncTimer = nullptr;
+    }
+    this->m_ntpMessageWatcher->stop();
+}
+
+void QMLWindow::timeSyncTimeout()
+{
+    this->m_timeSyncMonitor->sample();
+    // only redraw when time page is visible
+    QObject *timeForm = this->m_rootObject->findChild<QObject *>("timeForm");
+    if (!timeForm->property("visible").toBool())
+        return;
+    this->initTimeSyncValue(this->m_rootObject);
+}
+
+void QMLWindow::stopStorageMonitor()
+{
+    if (this->m_ueventMonitor) {
+        QObject::disconnect(this->m_ueventMonitor, 0, 0, 0);
+        delete this->m_ueventMonitor;
+        this->m_ueventMonitor = nullptr;
+    }
+}
+
+void QMLWindow::storageDeviceChangedEvent(QString action, QString deviceName, QString partitionName)
+{
+    string device = deviceName.toStdString();
+    string partition = partitionName.toStdString();
+    bool isEMMC = (device.compare(STORAGE_NAME_EMMC) == 0);
+    // storage page only shows emmc and sd card
+    if (!isEMMC && device.compare(STORAGE_NAME_SD_CARD) != 0) {
+        return;
+    }
+    QObject *storageForm = this->m_rootObject->findChild<QObject *>("storageForm");
+    if (partition.empty())
+    {
+        // whole disk inserted or removed, re-query this disk only
+        this->initStorageDeviceValue(this->m_rootObject, device.c_str());
+    }
+    else if (action.compare(UEVENT_ACTION_REMOVE) == 0)
+    {
+        QMetaObject::invokeMethod(storageForm, "removePratition",
+                                  Q_ARG(QVariant, QVariant(isEMMC)),
+                                  Q_ARG(QVariant, QVariant(partitionName)));
+    }
+    else
+    {
+        auto retPart = this->m_storageUtil->get_device_part(device.c_str(), partition.c_str());
+        if (retPart.second) {
+            this->updateStoragePartitionValue(this->m_rootObject, device.c_str(), retPart.first);
+        }
+    }
+    if (!isEMMC) {
+        QMetaObject::invokeMethod(storageForm, "refreshSDStoragePratitionUI");
+    }
+}
+
+void QMLWindow::usbDeviceChangedEvent(QString action, QString name)
+{
+    // judged as soon as the kernel announces it, before a driver is busy with it
+    if (action.compare(UEVENT_ACTION_ADD) != 0)
+        return;
+    this->m_systemUtil->do_apply_usb_device_policy(name.toStdString().c_str());
+}
+
+void QMLWindow::storageMountChangedEvent()
+{
+    // mount only changes mount point, fstype and usage of existing partitions
+    const char* devices[] = {STORAGE_NAME_EMMC, STORAGE_NAME_SD_CARD};
+    for (const char* device : devices)
+    {
+        auto retParts = this->m_storageUtil->get_device_parts(device);
+        for (auto &itr : retParts.first)
+        {
+            this->updateStoragePartitionValue(this->m_rootObject, device, itr);
+        }
+    }
+}
+
 void QMLWindow::ipMonitorFileChangedEvent(const QString &path)
 {
     const auto retUPeth = this->m_networkUtil->get_up_ethernet_from_monitor_file(path.toStdString().c_str());
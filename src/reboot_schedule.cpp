@@ -0,0 +1,233 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/reboot_schedule.h"
+
+// "[D ]HH:MM", returns false when invalid
+static bool parse_day_and_time(const string& text, int &dayofweek, int &minuteOfDay)
+{
+    int day = 0, hour = 0, minute = 0;
+    char rest = 0;
+    if (sscanf(text.c_str(), "%d %d:%d %c", &day, &hour, &minute, &rest) == 3) {
+        dayofweek = day % DAYS_PER_WEEK;
+        if (day < 0 || day > DAYS_PER_WEEK)
+            return false;
+    } else if (sscanf(text.c_str(), "%d:%d %c", &hour, &minute, &rest) == 2) {
+        dayofweek = REBOOT_SCHEDULE_EVERY_DAY;
+    } else {
+        return false;
+    }
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59)
+        return false;
+    minuteOfDay = hour * 60 + minute;
+    return true;
+}
+
+// earliest time of a local wall clock, so the hour repeated when daylight saving time ends fires once.
+// a time skipped when it starts is left to mktime, which moves it past the gap
+static time_t make_local_time(struct tm &wallClock)
+{
+    time_t result = -1;
+    struct tm resultTime = wallClock;
+    for (int isdst = 0; isdst <= 1; isdst++)
+    {
+        struct tm candidate = wallClock;
+        candidate.tm_isdst = isdst;
+        time_t localTime = mktime(&candidate);
+        // no such offset at that time, mktime moved the clock
+        if (localTime == -1 || candidate.tm_hour != wallClock.tm_hour || candidate.tm_min != wallClock.tm_min)
+            continue;
+        if (result == -1 || localTime < result) {
+            result = localTime;
+            resultTime = candidate;
+        }
+    }
+    if (result == -1) {
+        resultTime.tm_isdst = -1;
+        result = mktime(&resultTime);
+    }
+    wallClock = resultTime;
+    return result;
+}
+
+vector<RebootWindow> parse_reboot_windows(const string& text)
+{
+    vector<RebootWindow> windows;
+    for (auto &entry : split_string_to_vector(text.c_str(), ","))
+    {
+        int dayofweek = 0, minuteOfDay = 0;
+        if (!parse_day_and_time(entry, dayofweek, minuteOfDay)) {
+            qDebug("invalid reboot window:%s", entry.c_str());
+            continue;
+        }
+        windows.push_back({dayofweek, minuteOfDay / 60, minuteOfDay % 60});
+    }
+    return windows;
+}
+
+vector<RebootBlackout> parse_reboot_blackouts(const string& text)
+{
+    vector<RebootBlackout> blackouts;
+    for (auto &entry : split_string_to_vector(text.c_str(), ","))
+    {
+        size_t dash = entry.find('-');
+        int dayofweek = 0, startMinute = 0, endDayofweek = 0, endMinute = 0;
+        if (dash == string::npos || !parse_day_and_time(entry.substr(0, dash), dayofweek, startMinute) ||
+            !parse_day_and_time(entry.substr(dash + 1), endDayofweek, endMinute) ||
+            endDayofweek != REBOOT_SCHEDULE_EVERY_DAY) {
+            qDebug("invalid reboot blackout:%s", entry.c_str());
+            continue;
+        }
+        blackouts.push_back({dayofweek, startMinute, endMinute});
+    }
+    return blackouts;
+}
+
+RebootSchedule::RebootSchedule()
+{
+}
+
+void RebootSchedule::addWindow(const RebootWindow &window)
+{
+    m_windows.push_back(window);
+}
+
+void RebootSchedule::addBlackout(const RebootBlackout &blackout)
+{
+    m_blackouts.push_back(blackout);
+}
+
+vector<RebootWindow> RebootSchedule::getWindows() const
+{
+    return m_windows;
+}
+
+vector<RebootBlackout> RebootSchedule::getBlackouts() const
+{
+    return m_blackouts;
+}
+
+bool RebootSchedule::isBlackedOut(int dayofweek, int minuteOfDay) const
+{
+    for (auto &blackout : m_blackouts)
+    {
+        bool isEveryDay = (blackout.dayofweek == REBOOT_SCHEDULE_EVERY_DAY);
+        bool isToday = isEveryDay || blackout.dayofweek == dayofweek;
+        if (blackout.startMinute <= blackout.endMinute) {
+            if (isToday && minuteOfDay >= blackout.startMinute && minuteOfDay < blackout.endMinute)
+                return true;
+            continue;
+        }
+        // crosses midnight, the part after it belongs to the day before
+        bool isYesterday = isEveryDay || (blackout.dayofweek + 1) % DAYS_PER_WEEK == dayofweek;
+        if ((isToday && minuteOfDay >= blackout.startMinute) || (isYesterday && minuteOfDay < blackout.endMinute))
+            return true;
+    }
+    return false;
+}
+
+bool RebootSchedule::hasFireTime() const
+{
+    return !_get_fire_points().empty();
+}
+
+time_t RebootSchedule::getNextFireTime(time_t now) const
+{
+    const set<pair<int, int>> points = _get_fire_points();
+    if (points.empty())
+        return -1;
+    struct tm today;
+    localtime_r(&now, &today);
+    // a week ahead covers every weekday, one more day for a window earlier today
+    for (int offset = 0; offset <= DAYS_PER_WEEK; offset++)
+    {
+        for (auto &point : points)
+        {
+            struct tm candidate = today;
+            candidate.tm_mday = today.tm_mday + offset;
+            candidate.tm_hour = point.first / 60;
+            candidate.tm_min = point.first % 60;
+            candidate.tm_sec = 0;
+            time_t fireTime = make_local_time(candidate);
+            // normalized weekday, a skipped dst hour may have moved it
+            if (fireTime > now && candidate.tm_wday == point.second)
+                return fireTime;
+        }
+    }
+    return -1;
+}
+
+string RebootSchedule::toCrontab(const char* user, const char* command) const
+{
+    string crontab;
+    // check input
+    if (!user || !command) {
+        qDebug("missing parameter");
+        return crontab;
+    }
+    map<int, string> weekdays;
+    map<int, int> weekdayCount;
+    for (auto &point : _get_fire_points())
+    {
+        string &field = weekdays[point.first];
+        if (!field.empty())
+            field += ",";
+        field += std::to_string(point.second);
+        weekdayCount[point.first]++;
+    }
+    char buff[BUFF_SIZE] = {0};
+    for (auto &item : weekdays)
+    {
+        const string field = (weekdayCount[item.first] == DAYS_PER_WEEK) ? "*" : item.second;
+        snprintf(buff, sizeof(buff), "%d %d * * %s %s %s\n", item.first % 60, item.first / 60,
+                 field.c_str(), user, command);
+        crontab += buff;
+    }
+    return crontab;
+}
+
+set<pair<int, int>> RebootSchedule::_get_fire_points() const
+{
+    set<pair<int, int>> points;
+    for (auto &window : m_windows)
+    {
+        int minuteOfDay = window.hour * 60 + window.minute;
+        for (int day = 0; day < DAYS_PER_WEEK; day++)
+        {
+            if (window.dayofweek != REBOOT_SCHEDULE_EVERY_DAY && window.dayofweek != day)
+                continue;
+            if (!isBlackedOut(day, minuteOfDay))
+                points.insert(make_pair(minuteOfDay, day));
+        }
+    }
+    return points;
+}
+
+RebootSchedule make_reboot_schedule(const char* mode, int minute, int hour, int dayofweek,
+                                    const string& windows, const string& blackouts)
+{
+    RebootSchedule schedule;
+    // check input
+    if (!mode) {
+        qDebug("missing parameter");
+        return schedule;
+    }
+    if (strcmp(mode, REBOOT_SCHEDULE_MODE_DAILY) == 0) {
+        schedule.addWindow({REBOOT_SCHEDULE_EVERY_DAY, hour, minute});
+    } else if (strcmp(mode, REBOOT_SCHEDULE_MODE_WEEKLY) == 0) {
+        schedule.addWindow({dayofweek % DAYS_PER_WEEK, hour, minute});
+    } else {
+        qDebug("unknown mode:%s", mode);
+    }
+    for (auto &window : parse_reboot_windows(windows))
+        schedule.addWindow(window);
+    for (auto &blackout : parse_reboot_blackouts(blackouts))
+        schedule.addBlackout(blackout);
+    return schedule;
+}
@@ -17,6 +17,7 @@
 #include "./include/screen_utility.h"
 #include "./include/network_utility.h"
 #include "./include/time_utility.h"
+#include "./include/time_dbus_utility.h"
 #include "./include/system_utility.h"
 #include "./include/log_utility.h"
 
@@ -77,6 +78,7 @@ bool RestoreUtility::_restore_screen(ConfigUtility* pConfigUtil) {
         setMinutes = blankAfter;
     }
     pScreenUtil->set_brightness(brightness);
+    pScreenUtil->save_brightness();
     pScreenUtil->set_screensaver_idle_time(setMinutes * MINUTE_OF_SECONDS);
     pScreenUtil->set_hide_cursor(isHideCursor);
     // when config is old verion then gesture enable/top bar position string are empty
@@ -95,8 +97,12 @@ bool RestoreUtility::_restore_screen(ConfigUtility* pConfigUtil) {
     if (!rotateScreenString.empty()) {
         pScreenUtil->set_rotate_screen(rotateScreenString.c_str());
     }
+    // write all weston.ini and gester.conf changes at once
+    pScreenUtil->save_weston_config();
+    auto retGestureSave = pScreenUtil->save_gesture_config();
     // restart gesture service if rotate screen or gesture changed
-    pScreenUtil->restart_gesture_service();
+    if (retGestureSave.first || (!rotateScreenString.empty() && currentRotateScreen.compare(rotateScreenString) != 0))
+        pScreenUtil->restart_gesture_service();
 
     delete pScreenUtil;
     
@@ -260,7 +266,7 @@ void RestoreUtility::_restore_network(ConfigUtility* pConfigUtil) {
 }
 
 void RestoreUtility::_restore_time(ConfigUtility* pConfigUtil) {
-    ITimeUtility* pTimeUtil = new TPCTimeUtility();
+    ITimeUtility* pTimeUtil = new TPCTimeDBusUtility();
     string timezone = pConfigUtil->get_timezone();
     bool isNTP = pConfigUtil->get_ntp_enable();
     string ntpServer = pConfigUtil->get_ntp_server();
@@ -316,10 +322,13 @@ bool RestoreUtility::_restore_system(ConfigUtility* pConfigUtil) {
     }
     pSystemUtil->do_init_com_port();
     // set restart system crontab
-    pSystemUtil->set_reboot_system_crontab(isRSCronEnable, cronMode.c_str(),
-                                            cronMinute, cronHour, cronDayofweek);
+    pSystemUtil->set_reboot_system_crontab(isRSCronEnable, make_reboot_schedule(cronMode.c_str(),
+        cronMinute, cronHour, cronDayofweek, pConfigUtil->get_reboot_system_crontab_windows(),
+        pConfigUtil->get_reboot_system_crontab_blackouts()));
     // set usb if value exists
     if (!usbEnableString.empty()) {
+        pSystemUtil->set_usb_blocked_devices(pConfigUtil->get_usb_blocked_classes().c_str(),
+                                             pConfigUtil->get_usb_blocked_ports().c_str());
         pSystemUtil->set_usb_enable(isUSBEnabled);
     }
     // set ethernet if value exists
@@ -2,69 +2,49 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
 #include <string>
 #include <array>
 #ifdef _WIN32
 #else
 #include <unistd.h>
+#include <fcntl.h>
 #endif
 #include <QDebug>
 
 #include "./include/utility.h"
 #include "./include/screen_utility.h"
+#include "./include/service_manager.h"
 
 #define STRING_TOP  "top"
 #define STRING_NONE "none"
 
-const char *WESTON_CONFIG_FILE = "/etc/xdg/weston/weston.ini";
 // core related
 const char *WESTON_SECTION_CORE = "core";
 const char *KEY_IDLE_TIME = "idle-time";
 // libinput related
 const char *WESTON_SECTION_LIBINPUT = "libinput";
-const char *KEY_TOUCH_CALIBRATOR = "touchscreen_calibrator";
 const char *KEY_HIDE_CURSOR = "hide-cursor";
 // shell related
 const char *WESTON_SECTION_SHELL = "shell";
 // sets the position of the panel (string). Can be top, bottom, left, right, none.
 const char *KEY_PANEL_POSITION = "panel-position";
-const char *INSERT_SHELL_SETTING_TMPLATE="\n[%s]\n%s=%s\n";
 // output related
 const char *WESTON_SECTION_OUTPUT = "output";
 const char *KEY_OUTPUT_NAME = "name";
 const char *KEY_TRANSFORM = "transform";
 const char *IMX_DISPLAY_NAME = "DSI-1";
-const char *INSERT_OUTPUT_SETTING_TMPLATE="\n[%s]\n%s=%s\n%s=%s\n";
 
-const char* GET_STRING_CMD = "cat %s | grep %s=%s";
-
-const char *SET_INI_INT_VALUE_CMD = "sed -i '/^%s=/s/=.*/=%d/' %s";
-const char *SET_INI_STRING_VALUE_CMD = "sed -i '/^%s=/s/=.*/=%s/' %s";
-// save the value in a variable and then print it after processing the whole file
-const char *GET_INI_VALUE_CMD = "awk -F '=' '/^%s/ {val=$2} END{print val}' %s | tr -d '\\n'";
-// insert key/value after math property key (argument 1.match key 2.insert key 3.insert value 4.file)
-const char *INSERT_INI_KEY_VALUE_CMD = "sed -i -r '/^[#]*\\s*%s=.*/a %s=%s' %s";
-// insert section and key/value at file end
-const char *INSERT_INI_SECTION_KEY_VALUE_CMD = "echo -en '%s' >>%s";
 
 const char *RESTART_WESTON_CMD = "/usr/bin/start_weston.sh restart";
 
-const char *DISPLAY_DEVICE_0 = "lvds_backlight@0";
-const char *DISPLAY_DEVICE_TMPLATE = "/sys/class/backlight/%s/brightness";
-// ex: cat /sys/class/backlight/lvds_backlight@0/brightness
-const char *GET_BRIGHTNESS_CMD = "cat /sys/class/backlight/%s/brightness";
-const char *SET_BRIGHTNESS_CMD = "echo %d >> /sys/class/backlight/%s/brightness";
-const char *SAVE_BRIGHTNESS_CMD = "/lib/systemd/systemd-backlight save backlight:lvds_backlight@0; sync";
-
-const char *GET_GESTURE_SERVICE_ENABLED_CMD = "systemctl is-enabled gester | grep enabled";
-const char *OPERATE_GESTURE_SERVICE_CMD = "systemctl %s gester 2>&1";
+const char *BRIGHTNESS_ATTRIBUTE = "brightness";
+// ex: /lib/systemd/systemd-backlight save backlight:lvds_backlight@0
+const char *SAVE_BRIGHTNESS_CMD = "/lib/systemd/systemd-backlight save backlight:%s; sync";
 
-const char *SCREENSHOTS_FOLDER = "/userdata";
-const char *COUNT_SCREENSHOTS_CMD = "ls /userdata/wayland-screenshot-* 2>/dev/null | wc -l";
-const char *COPY_SCREENSHOTS_CMD = "cp /userdata/wayland-screenshot-* %s 2>&1";
-const char *RM_SCREENSHOTS_CMD = "rm -rf /userdata/wayland-screenshot-* 2>&1";
 
-const char *GESTURE_CONFIG_FILE = "/etc/gester/gester.conf";
 const char *GESTURE_SECTION = "gesture";
 const char *KEY_GESTURE_TYPE = "type";
 const char *KEY_GESTURE_LIST = "gesture_list";
@@ -88,8 +68,15 @@ const char *DELIMITER_STRING = " ";
 
 using namespace std;
 
-TPCScreenUtility::TPCScreenUtility()
+TPCScreenUtility::TPCScreenUtility(const char* westonConfigFile, const char* backlightFolder, const char* gestureConfigFile,
+                                   IServiceManager *serviceManager)
 {
+    m_isServiceManagerOwned = (serviceManager == nullptr);
+    m_serviceManager = serviceManager ? serviceManager : new TPCServiceManager();
+    m_westonConfigFile = westonConfigFile ? westonConfigFile : WESTON_CONFIG_FILE;
+    m_backlightFolder = backlightFolder ? backlightFolder : BACKLIGHT_FOLDER;
+    m_backlightFd = -1;
+    m_gestureConfigFile = gestureConfigFile ? gestureConfigFile : GESTURE_CONFIG_FILE;
     char value_buff[BUFF_SIZE]= {0};
     snprintf(value_buff, BUFF_SIZE, "%s.%s", TWO_FINGER_GESTURE_SECTION, KEY_GESTURE_SWIPE_UP);
     m_gestureActionMap[value_buff] = ACTION_CLOSE_WINDOW;
@@ -104,46 +91,115 @@ TPCScreenUtility::TPCScreenUtility()
     m_gestureActionMap[value_buff] = ACTION_TAKE_SCREENSHOT;
 }
 
-bool TPCScreenUtility::_is_display_device_exist(const char *device)
+TPCScreenUtility::~TPCScreenUtility()
 {
-    char path_buff[CMD_SIZE] = {0};
-    snprintf(path_buff, CMD_SIZE, DISPLAY_DEVICE_TMPLATE, device);
-    return is_file_exist(path_buff);
+#ifdef _WIN32
+#else
+    if (m_backlightFd >= 0)
+        close(m_backlightFd);
+#endif
+    if (m_isServiceManagerOwned)
+        delete m_serviceManager;
+}
+
+int TPCScreenUtility::_open_backlight()
+{
+#ifdef _WIN32
+#else
+    if (m_backlightFd >= 0)
+        return m_backlightFd;
+    string path = m_backlightFolder + "/" + BRIGHTNESS_ATTRIBUTE;
+    if (!is_file_exist(path.c_str()))
+        return m_backlightFd;
+    m_backlightFd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (m_backlightFd < 0) {
+        qDebug("Cannot open file::%s", path.c_str());
+    }
+#endif
+    return m_backlightFd;
 }
 
 int TPCScreenUtility::get_brightness()
 {
     int brightness = 0;
-    if (!_is_display_device_exist(DISPLAY_DEVICE_0))
+#ifdef _WIN32
+#else
+    int fd = _open_backlight();
+    if (fd < 0)
         return brightness;
-    // execute command to get brightness
-    const auto ret = execute_cmd_get_single_info(GET_BRIGHTNESS_CMD, DISPLAY_DEVICE_0);
-    if (ret.first.empty())
+    // sysfs attribute is re-read from offset 0
+    char buff[BUFF_SIZE] = {0};
+    ssize_t size = pread(fd, buff, BUFF_SIZE - 1, 0);
+    if (size <= 0)
         return brightness;
-    brightness = std::stoi(ret.first);
+    brightness = atoi(buff);
+#endif
     return brightness;
 }
 
 bool TPCScreenUtility::set_brightness(const int brightness)
 {
     bool result = false;
-    if (!_is_display_device_exist(DISPLAY_DEVICE_0))
-        return result;
     if (brightness < SCREEN_BRIGHTNESS_MIN || brightness > SCREEN_BRIGHTNESS_MAX) {
         qDebug("brightness overflow:%d", brightness);
         return result;
     }
-    result = execute_cmd_set_info(SET_BRIGHTNESS_CMD, brightness, DISPLAY_DEVICE_0);
-    result &= execute_cmd_set_info(SAVE_BRIGHTNESS_CMD);
+#ifdef _WIN32
+#else
+    int fd = _open_backlight();
+    if (fd < 0)
+        return result;
+    char buff[BUFF_SIZE] = {0};
+    int len = snprintf(buff, BUFF_SIZE, "%d\n", brightness);
+    result = (pwrite(fd, buff, len, 0) == len);
+    if (!result) {
+        qDebug("write brightness failed:%s", strerror(errno));
+    }
+#endif
     return result;
 }
 
+bool TPCScreenUtility::save_brightness()
+{
+    if (_open_backlight() < 0)
+        return false;
+    string deviceName = get_filename_from_fullpath(m_backlightFolder.c_str());
+    return execute_cmd_set_info(SAVE_BRIGHTNESS_CMD, deviceName.c_str());
+}
+
+bool TPCScreenUtility::_load_weston_config()
+{
+    if (m_westonConfig.is_loaded())
+        return true;
+    return reload_weston_config();
+}
+
+bool TPCScreenUtility::reload_weston_config()
+{
+    if (!is_file_exist(m_westonConfigFile.c_str()))
+        return false;
+    return m_westonConfig.load(m_westonConfigFile.c_str());
+}
+
+pair<bool, bool> TPCScreenUtility::save_weston_config()
+{
+    // nothing staged, no write and no restart needed
+    if (!m_westonConfig.is_loaded() || !m_westonConfig.is_modified())
+        return make_pair(false, true);
+    bool result = m_westonConfig.save(m_westonConfigFile.c_str());
+    if (!result) {
+        // drop staged changes so the model matches the file again
+        reload_weston_config();
+    }
+    return make_pair(result, result);
+}
+
 int TPCScreenUtility::get_screensaver_idle_time()
 {
     int idleTime = 0;
-    if (!is_file_exist(WESTON_CONFIG_FILE))
+    if (!_load_weston_config())
         return idleTime;
-    const auto ret = execute_cmd_get_single_info(GET_INI_VALUE_CMD, KEY_IDLE_TIME, WESTON_CONFIG_FILE);
+    const auto ret = m_westonConfig.get_value(WESTON_SECTION_CORE, KEY_IDLE_TIME);
     if (ret.first.empty())
         return idleTime;
     idleTime = std::stoi(ret.first);
@@ -152,100 +208,112 @@ int TPCScreenUtility::get_screensaver_idle_time()
 
 bool TPCScreenUtility::set_screensaver_idle_time(const int seconds)
 {
-    if (!is_file_exist(WESTON_CONFIG_FILE))
+    if (!_load_weston_config())
         return false;
-
-    return execute_cmd_set_info(SET_INI_INT_VALUE_CMD, KEY_IDLE_TIME, seconds, WESTON_CONFIG_FILE);
+    return m_westonConfig.set_value(WESTON_SECTION_CORE, KEY_IDLE_TIME, std::to_string(seconds).c_str());
 }
 
 bool TPCScreenUtility::get_hide_cursor()
 {
     bool hideCursor = false;
-    if (!is_file_exist(WESTON_CONFIG_FILE))
+    if (!_load_weston_config())
         return hideCursor;
-    const auto ret = execute_cmd_get_single_info(GET_INI_VALUE_CMD, KEY_HIDE_CURSOR, WESTON_CONFIG_FILE);
+    const auto ret = m_westonConfig.get_value(WESTON_SECTION_LIBINPUT, KEY_HIDE_CURSOR);
     hideCursor = (ret.first.compare(0, strlen(STRING_BOOL_TRUE), STRING_BOOL_TRUE) == 0);
     return hideCursor;
 }
 
 bool TPCScreenUtility::set_hide_cursor(const bool hide)
 {
-    if (!is_file_exist(WESTON_CONFIG_FILE))
+    if (!_load_weston_config())
         return false;
-    const auto ret = execute_cmd_get_single_info(GET_INI_VALUE_CMD, KEY_HIDE_CURSOR, WESTON_CONFIG_FILE);
-    if (!ret.first.empty()) {
-        // update current value
-        return execute_cmd_set_info(SET_INI_STRING_VALUE_CMD, KEY_HIDE_CURSOR, bool_cast(hide), WESTON_CONFIG_FILE);
-    } else {
-        // insert hide-cursor/value after idle-time
-        return execute_cmd_set_info(INSERT_INI_KEY_VALUE_CMD, KEY_TOUCH_CALIBRATOR, KEY_HIDE_CURSOR, bool_cast(hide), WESTON_CONFIG_FILE);
-    }
+    return m_westonConfig.set_value(WESTON_SECTION_LIBINPUT, KEY_HIDE_CURSOR, bool_cast(hide));
 }
 
 string TPCScreenUtility::get_top_bar_position()
 {
-    if (!is_file_exist(WESTON_CONFIG_FILE))
+    if (!_load_weston_config())
         return STRING_TOP;
-    const auto ret = execute_cmd_get_single_info(GET_INI_VALUE_CMD, KEY_PANEL_POSITION, WESTON_CONFIG_FILE);
+    const auto ret = m_westonConfig.get_value(WESTON_SECTION_SHELL, KEY_PANEL_POSITION);
     return ret.first;
 }
 
 bool TPCScreenUtility::set_top_bar_position(const char* position)
 {
-    if (!is_file_exist(WESTON_CONFIG_FILE))
+    if (!_load_weston_config())
         return false;
-    const auto ret = execute_cmd_get_single_info(GET_INI_VALUE_CMD, KEY_PANEL_POSITION, WESTON_CONFIG_FILE);
-    if (ret.first.empty()) {
-        char value_buff[BUFF_SIZE]= {0};
-        snprintf(value_buff, BUFF_SIZE, INSERT_SHELL_SETTING_TMPLATE, WESTON_SECTION_SHELL, KEY_PANEL_POSITION, position);
-        return execute_cmd_set_info(INSERT_INI_SECTION_KEY_VALUE_CMD, value_buff, WESTON_CONFIG_FILE);
-    } else {
-        return execute_cmd_set_info(SET_INI_STRING_VALUE_CMD, KEY_PANEL_POSITION, position, WESTON_CONFIG_FILE);
-    }
+    return m_westonConfig.set_value(WESTON_SECTION_SHELL, KEY_PANEL_POSITION, position);
 }
 
 string TPCScreenUtility::get_rotate_screen()
 {
-    if (!is_file_exist(WESTON_CONFIG_FILE))
+    if (!_load_weston_config())
         return STRING_TOP;
-    const auto ret = execute_cmd_get_single_info(GET_INI_VALUE_CMD, KEY_TRANSFORM, WESTON_CONFIG_FILE);
+    const auto ret = m_westonConfig.get_value(WESTON_SECTION_OUTPUT, KEY_OUTPUT_NAME, IMX_DISPLAY_NAME, KEY_TRANSFORM);
     return ret.first;
 }
 
 bool TPCScreenUtility::set_rotate_screen(const char* rotateDegree)
 {
-    if (!is_file_exist(WESTON_CONFIG_FILE))
+    if (!_load_weston_config())
         return false;
-    const auto ret = execute_cmd_get_single_info(GET_STRING_CMD, WESTON_CONFIG_FILE, KEY_OUTPUT_NAME, IMX_DISPLAY_NAME);
-    if (ret.first.empty()) {
-        char value_buff[BUFF_SIZE]= {0};
-        snprintf(value_buff, BUFF_SIZE, INSERT_OUTPUT_SETTING_TMPLATE, WESTON_SECTION_OUTPUT, KEY_OUTPUT_NAME, IMX_DISPLAY_NAME, KEY_TRANSFORM, rotateDegree);
-        return execute_cmd_set_info(INSERT_INI_SECTION_KEY_VALUE_CMD, value_buff, WESTON_CONFIG_FILE);
-    } else {
-        return execute_cmd_set_info(SET_INI_STRING_VALUE_CMD, KEY_TRANSFORM, rotateDegree, WESTON_CONFIG_FILE);
+    return m_westonConfig.set_value(WESTON_SECTION_OUTPUT, KEY_OUTPUT_NAME, IMX_DISPLAY_NAME, KEY_TRANSFORM, rotateDegree);
+}
+
+bool TPCScreenUtility::_load_gesture_config()
+{
+    if (m_gestureConfig.is_loaded())
+        return true;
+    return reload_gesture_config();
+}
+
+bool TPCScreenUtility::reload_gesture_config()
+{
+    m_gestureList.clear();
+    m_gestureActionList.clear();
+    if (!is_file_exist(m_gestureConfigFile.c_str()))
+        return false;
+    if (!m_gestureConfig.load(m_gestureConfigFile.c_str()))
+        return false;
+    // lists never change at runtime, parse them once
+    const auto retList = m_gestureConfig.get_value(GESTURE_SECTION, KEY_GESTURE_LIST);
+    m_gestureList = split_string_to_vector(retList.first.c_str(), DELIMITER_STRING);
+    const auto retActionList = m_gestureConfig.get_value(GESTURE_ACTION_SECTION, KEY_GESTURE_ACTION_LIST);
+    m_gestureActionList = split_string_to_vector(retActionList.first.c_str(), DELIMITER_STRING);
+    return true;
+}
+
+pair<bool, bool> TPCScreenUtility::save_gesture_config()
+{
+    // nothing staged, no write and no service restart needed
+    if (!m_gestureConfig.is_loaded() || !m_gestureConfig.is_modified())
+        return make_pair(false, true);
+    bool result = m_gestureConfig.save(m_gestureConfigFile.c_str());
+    if (!result) {
+        // drop staged changes so the model matches the file again
+        reload_gesture_config();
     }
+    return make_pair(result, result);
 }
 
 string TPCScreenUtility::get_gesture_type()
 {
-    if (!is_file_exist(GESTURE_CONFIG_FILE))
+    if (!_load_gesture_config())
         return GESTURE_TYPE_GENERAL;
-    const auto ret = execute_cmd_get_single_info(GET_INI_VALUE_CMD, KEY_GESTURE_TYPE, GESTURE_CONFIG_FILE);
+    const auto ret = m_gestureConfig.get_value(GESTURE_SECTION, KEY_GESTURE_TYPE);
     return ret.first;
 }
 
 pair<vector<string>, bool> TPCScreenUtility::get_gesture_list()
 {
-    const auto ret = execute_cmd_get_single_info(GENERAL_GET_INI_VALUE_CMD, GESTURE_CONFIG_FILE, GESTURE_SECTION, KEY_GESTURE_LIST);
-    m_gestureList = split_string_to_vector(ret.first.c_str(), DELIMITER_STRING);
-    return make_pair(m_gestureList, ret.second);
+    bool result = _load_gesture_config();
+    return make_pair(m_gestureList, result);
 }
 
 pair<vector<string>, bool> TPCScreenUtility::get_gesture_action_list()
 {
-    const auto ret = execute_cmd_get_single_info(GENERAL_GET_INI_VALUE_CMD, GESTURE_CONFIG_FILE, GESTURE_ACTION_SECTION, KEY_GESTURE_ACTION_LIST);
-    m_gestureActionList = split_string_to_vector(ret.first.c_str(), DELIMITER_STRING);
-    return make_pair(m_gestureActionList, ret.second);
+    bool result = _load_gesture_config();
+    return make_pair(m_gestureActionList, result);
 }
 
 string TPCScreenUtility::_get_gesture_action(const char *gestureType, const char *actionKey)
@@ -256,7 +324,9 @@ string TPCScreenUtility::_get_gesture_action(const char *gestureType, const char
 }
 bool TPCScreenUtility::_get_gesture_action_enabled(const char *gestureType, const char *actionKey)
 {
-    const auto ret = execute_cmd_get_single_info(GENERAL_GET_INI_VALUE_CMD, GESTURE_CONFIG_FILE, gestureType, actionKey);
+    if (!_load_gesture_config())
+        return false;
+    const auto ret = m_gestureConfig.get_value(gestureType, actionKey);
     if (ret.first.empty())
         return false;
     else
@@ -264,12 +334,14 @@ bool TPCScreenUtility::_get_gesture_action_enabled(const char *gestureType, cons
 }
 bool TPCScreenUtility::_set_gesture_action_enabled(const char *gestureType, const char *actionKey, bool enabled)
 {
+    if (!_load_gesture_config())
+        return false;
     if (enabled) {
         string actionValue = _get_gesture_action(gestureType, actionKey);
-        return execute_cmd_set_info(GENERAL_SET_INI_VALUE_CMD, GESTURE_CONFIG_FILE, gestureType, actionKey, actionValue.c_str());
+        return m_gestureConfig.set_value(gestureType, actionKey, actionValue.c_str());
     }
     else {
-        return execute_cmd_set_info(GENERAL_SET_INI_EMPTY_VALUE_CMD, GESTURE_CONFIG_FILE, gestureType, actionKey);
+        return m_gestureConfig.set_value(gestureType, actionKey, "");
     }
 }
 
@@ -316,24 +388,15 @@ bool TPCScreenUtility::set_all_finger_gesture_enabled(const bool enabled)
 
 bool TPCScreenUtility::get_gesture_service_enabled()
 {
-    bool enabled = true;
-    const auto ret = execute_cmd_get_single_info(GET_GESTURE_SERVICE_ENABLED_CMD);
-    enabled = !ret.first.empty();
-    return enabled;
+    const auto ret = m_serviceManager->get_unit_enabled(GESTURE_SERVICE_NAME);
+    return ret.first;
 }
 
 bool TPCScreenUtility::set_gesture_service_enabled(const bool enabled)
 {
-    bool result = true;
-    if (enabled) {
-        result &= enable_gesture_service();
-        result &= restart_gesture_service();
-    }
-    else {
-        result &= stop_gesture_service();
-        result &= disable_gesture_service();
-    }
-    return result;
+    if (enabled)
+        return m_serviceManager->enable_and_start_units({GESTURE_SERVICE_NAME});
+    return m_serviceManager->stop_and_disable_units({GESTURE_SERVICE_NAME});
 }
 
 void TPCScreenUtility::restart_desktop_service()
@@ -343,42 +406,21 @@ void TPCScreenUtility::restart_desktop_service()
 
 bool TPCScreenUtility::start_gesture_service()
 {
-    return execute_cmd_set_info(OPERATE_GESTURE_SERVICE_CMD, STRING_START);
+    return m_serviceManager->start_units({GESTURE_SERVICE_NAME});
 }
 bool TPCScreenUtility::stop_gesture_service()
 {
-    return execute_cmd_set_info(OPERATE_GESTURE_SERVICE_CMD, STRING_STOP);
+    return m_serviceManager->stop_units({GESTURE_SERVICE_NAME});
 }
 bool TPCScreenUtility::enable_gesture_service()
 {
-    return execute_cmd_set_info(OPERATE_GESTURE_SERVICE_CMD, STRING_ENABLE);
+    return m_serviceManager->enable_units({GESTURE_SERVICE_NAME});
 }
 bool TPCScreenUtility::disable_gesture_service()
 {
-    return execute_cmd_set_info(OPERATE_GESTURE_SERVICE_CMD, STRING_DISABLE);
+    return m_serviceManager->disable_units({GESTURE_SERVICE_NAME});
 }
 bool TPCScreenUtility::restart_gesture_service()
 {
-    return execute_cmd_set_info(OPERATE_GESTURE_SERVICE_CMD, STRING_RESTART);
-}
-int TPCScreenUtility::get_screenshots_count()
-{
-    const auto ret = execute_cmd_get_single_info(COUNT_SCREENSHOTS_CMD);
-    return std::stoi(ret.first);
-}
-pair<string, bool> TPCScreenUtility::export_screenshots(const char* exportFolder)
-{
-    bool result = false;
-    string screenshotFolder = SCREENSHOTS_FOLDER;
-    if (screenshotFolder.rfind(exportFolder, 0) == 0) {
-        return make_pair("Screenshots are under /userdata. Please select another folder.", result);
-    }
-    result = execute_cmd_set_info(COPY_SCREENSHOTS_CMD, exportFolder);
-    // make sure file flush to disk
-    sync();
-    return make_pair("", result);
-}
-bool TPCScreenUtility::delete_screenshots()
-{
-    return execute_cmd_set_info(RM_SCREENSHOTS_CMD);
+    return m_serviceManager->restart_units({GESTURE_SERVICE_NAME});
 }
@@ -0,0 +1,123 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstring>
+#include <sys/stat.h>
+#include <QDateTime>
+#include <QImage>
+#include <QDebug>
+
+#include "./include/storage_utility.h"
+#include "./include/screenshot_utility.h"
+#include "./include/screenshot_gallery_model.h"
+
+ScreenshotGalleryModel::ScreenshotGalleryModel(IScreenshotUtility *screenshotUtil, const char* screenshotFolder,
+                                               const char* cacheFolder, QObject *parent)
+    : QAbstractListModel(parent), m_thumbnailer(screenshotFolder, cacheFolder)
+{
+    this->m_screenshotUtil = screenshotUtil;
+    this->m_screenshotFolder = screenshotFolder ? screenshotFolder : SCREENSHOTS_FOLDER;
+}
+
+int ScreenshotGalleryModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return (int)this->m_items.size();
+}
+
+QVariant ScreenshotGalleryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= (int)this->m_items.size())
+        return QVariant();
+    const ScreenshotGalleryItem &item = this->m_items[index.row()];
+    switch (role)
+    {
+        case NameRole:
+            return QString::fromStdString(item.name);
+        case PathRole:
+            return QString::fromStdString(this->m_screenshotFolder + "/" + item.name);
+        case ThumbnailRole:
+            // mtime in url so qml pixmap cache does not keep an overwritten screenshot
+            return QString("image://%1/%2?%3").arg(SCREENSHOT_THUMBNAIL_PROVIDER)
+                .arg(QString::fromStdString(item.name)).arg(item.modified);
+        case ModifiedRole:
+            return QDateTime::fromSecsSinceEpoch(item.modified).toString("yyyy/MM/dd hh:mm:ss");
+        case SizeRole:
+            return QString::fromStdString(format_size(item.size));
+        default:
+            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ScreenshotGalleryModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[PathRole] = "path";
+    roles[ThumbnailRole] = "thumbnail";
+    roles[ModifiedRole] = "modified";
+    roles[SizeRole] = "size";
+    return roles;
+}
+
+void ScreenshotGalleryModel::refresh()
+{
+    auto retScreenshots = this->m_screenshotUtil->get_screenshots();
+    std::vector<ScreenshotGalleryItem> items;
+    for (auto &name : retScreenshots.first)
+    {
+        string path = this->m_screenshotFolder + "/" + name;
+        struct stat fileStat;
+        if (stat(path.c_str(), &fileStat) != 0)
+            continue;
+        ScreenshotGalleryItem item;
+        item.name = name;
+        item.modified = fileStat.st_mtime;
+        item.size = fileStat.st_size;
+        items.push_back(item);
+    }
+    beginResetModel();
+    this->m_items.swap(items);
+    endResetModel();
+    // only prune against a complete listing
+    if (retScreenshots.second)
+        this->m_thumbnailer.prune(retScreenshots.first);
+}
+
+ScreenshotThumbnailProvider::ScreenshotThumbnailProvider(const char* screenshotFolder, const char* cacheFolder)
+    : QQuickImageProvider(QQuickImageProvider::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading),
+      m_thumbnailer(screenshotFolder, cacheFolder)
+{
+}
+
+QImage ScreenshotThumbnailProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    Q_UNUSED(requestedSize);
+    // id is <name>?<mtime>
+    QString name = id.section('?', 0, 0);
+    auto decode = [](const string& path, ThumbnailImage &image) {
+        QImage source(QString::fromStdString(path));
+        if (source.isNull())
+            return false;
+        // rgb32 and argb32 share one 4 byte layout, no conversion for png screenshots
+        if (source.format() != QImage::Format_RGB32 && source.format() != QImage::Format_ARGB32)
+            source = source.convertToFormat(QImage::Format_ARGB32);
+        image = ThumbnailImage(source.width(), source.height());
+        for (int y = 0; y < source.height(); y++)
+        {
+            memcpy(image.getPixels() + (size_t)y * image.getStride(), source.constScanLine(y), image.getStride());
+        }
+        return true;
+    };
+    auto retThumbnail = this->m_thumbnailer.get_thumbnail(name.toStdString().c_str(), decode);
+    if (!retThumbnail.second)
+        return QImage();
+    const ThumbnailImage &thumbnail = retThumbnail.first;
+    // copy, the thumbnail buffer goes away with this function
+    QImage image = QImage(thumbnail.getPixels(), thumbnail.getWidth(), thumbnail.getHeight(),
+                          thumbnail.getStride(), QImage::Format_ARGB32).copy();
+    if (size)
+        *size = image.size();
+    return image;
+}
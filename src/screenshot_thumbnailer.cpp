@@ -0,0 +1,305 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <algorithm>
+#include <set>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/screenshot_thumbnailer.h"
+
+#define THUMBNAIL_BYTES_PER_PIXEL   4
+#define THUMBNAIL_CACHE_MAGIC       "STH1"
+#define THUMBNAIL_CACHE_TEMP_SUFFIX ".tmp"
+
+// on-disk cache header, followed by width * height * 4 pixel bytes
+struct ThumbnailCacheHeader
+{
+    char magic[4];
+    int32_t width;
+    int32_t height;
+    int64_t mtimeSec;
+    int64_t mtimeNsec;
+    int64_t size;
+};
+
+ThumbnailImage::ThumbnailImage()
+{
+    m_width = 0;
+    m_height = 0;
+}
+
+ThumbnailImage::ThumbnailImage(int width, int height)
+    : m_pixels((size_t)max(width, 0) * max(height, 0) * THUMBNAIL_BYTES_PER_PIXEL)
+{
+    m_width = max(width, 0);
+    m_height = max(height, 0);
+}
+
+int ThumbnailImage::getWidth() const
+{
+    return m_width;
+}
+
+int ThumbnailImage::getHeight() const
+{
+    return m_height;
+}
+
+int ThumbnailImage::getStride() const
+{
+    return m_width * THUMBNAIL_BYTES_PER_PIXEL;
+}
+
+unsigned char* ThumbnailImage::getPixels()
+{
+    return m_pixels.data();
+}
+
+const unsigned char* ThumbnailImage::getPixels() const
+{
+    return m_pixels.data();
+}
+
+int get_thumbnail_factor(int width, int height, int maxWidth, int maxHeight)
+{
+    if (width <= 0 || height <= 0 || maxWidth <= 0 || maxHeight <= 0)
+        return 1;
+    int factor = max((width + maxWidth - 1) / maxWidth, (height + maxHeight - 1) / maxHeight);
+    return min(max(factor, 1), SCREENSHOT_THUMBNAIL_MAX_FACTOR);
+}
+
+// adds one source row into the column sums, this is where nearly all the work is
+static void accumulate_row(uint16_t *sums, const unsigned char *row, int count)
+{
+    int i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16_t pixels = vld1q_u8(row + i);
+        vst1q_u16(sums + i, vaddw_u8(vld1q_u16(sums + i), vget_low_u8(pixels)));
+        vst1q_u16(sums + i + 8, vaddw_u8(vld1q_u16(sums + i + 8), vget_high_u8(pixels)));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i low = _mm_loadu_si128((const __m128i *)(sums + i));
+        __m128i high = _mm_loadu_si128((const __m128i *)(sums + i + 8));
+        _mm_storeu_si128((__m128i *)(sums + i), _mm_add_epi16(low, _mm_unpacklo_epi8(pixels, zero)));
+        _mm_storeu_si128((__m128i *)(sums + i + 8), _mm_add_epi16(high, _mm_unpackhi_epi8(pixels, zero)));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        sums[i] += row[i];
+    }
+}
+
+bool box_downscale(const ThumbnailImage &source, int factor, ThumbnailImage &thumbnail)
+{
+    // check input
+    if (factor < 1 || factor > SCREENSHOT_THUMBNAIL_MAX_FACTOR) {
+        qDebug("invalid parameter");
+        return false;
+    }
+    int width = source.getWidth() / factor;
+    int height = source.getHeight() / factor;
+    if (width <= 0 || height <= 0) {
+        qDebug("image is smaller than downscale factor");
+        return false;
+    }
+    thumbnail = ThumbnailImage(width, height);
+    // only the columns that end up in the thumbnail
+    int count = width * factor * THUMBNAIL_BYTES_PER_PIXEL;
+    uint32_t area = (uint32_t)factor * factor;
+    vector<uint16_t> sums(count);
+    for (int y = 0; y < height; y++)
+    {
+        fill(sums.begin(), sums.end(), 0);
+        for (int row = 0; row < factor; row++)
+        {
+            accumulate_row(sums.data(), source.getPixels() + (size_t)(y * factor + row) * source.getStride(), count);
+        }
+        unsigned char *target = thumbnail.getPixels() + (size_t)y * thumbnail.getStride();
+        const uint16_t *column = sums.data();
+        for (int x = 0; x < width; x++)
+        {
+            uint32_t total[THUMBNAIL_BYTES_PER_PIXEL] = {0};
+            for (int i = 0; i < factor; i++)
+            {
+                for (int channel = 0; channel < THUMBNAIL_BYTES_PER_PIXEL; channel++)
+                {
+                    total[channel] += column[channel];
+                }
+                column += THUMBNAIL_BYTES_PER_PIXEL;
+            }
+            for (int channel = 0; channel < THUMBNAIL_BYTES_PER_PIXEL; channel++)
+            {
+                *target++ = (unsigned char)((total[channel] + area / 2) / area);
+            }
+        }
+    }
+    return true;
+}
+
+ScreenshotThumbnailer::ScreenshotThumbnailer(const char* screenshotFolder, const char* cacheFolder)
+{
+    m_screenshotFolder = screenshotFolder ? screenshotFolder : SCREENSHOTS_FOLDER;
+    m_cacheFolder = cacheFolder ? cacheFolder : SCREENSHOT_THUMBNAIL_FOLDER;
+}
+
+pair<ThumbnailImage, bool> ScreenshotThumbnailer::get_thumbnail(const char* name, ThumbnailDecodeFunc decode)
+{
+    ThumbnailImage thumbnail;
+    // check input
+    if (!name || !decode) {
+        qDebug("missing parameter");
+        return make_pair(thumbnail, false);
+    }
+    // name comes from qml, never leave the screenshot folder
+    if (strchr(name, '/') || strncmp(name, SCREENSHOT_FILE_PREFIX, strlen(SCREENSHOT_FILE_PREFIX)) != 0) {
+        qDebug("Invalid screenshot name::%s", name);
+        return make_pair(thumbnail, false);
+    }
+    string sourcePath = m_screenshotFolder + "/" + name;
+    // stat before decoding, a screenshot replaced meanwhile gets a fresh thumbnail next time
+    struct stat sourceStat;
+    if (stat(sourcePath.c_str(), &sourceStat) != 0) {
+        qDebug("Cannot stat file::%s", sourcePath.c_str());
+        return make_pair(thumbnail, false);
+    }
+    string cachePath = _get_cache_path(name);
+    if (_read_cache(cachePath, sourceStat, thumbnail))
+        return make_pair(thumbnail, true);
+
+    ThumbnailImage source;
+    if (!decode(sourcePath, source)) {
+        qDebug("Cannot decode file::%s", sourcePath.c_str());
+        return make_pair(thumbnail, false);
+    }
+    int factor = get_thumbnail_factor(source.getWidth(), source.getHeight());
+    if (!box_downscale(source, factor, thumbnail))
+        return make_pair(thumbnail, false);
+    // thumbnail is still usable when the cache cannot be written
+    _write_cache(cachePath, sourceStat, thumbnail);
+    return make_pair(thumbnail, true);
+}
+
+void ScreenshotThumbnailer::prune(const vector<string>& names)
+{
+#ifdef _WIN32
+#else
+    DIR *dir = opendir(m_cacheFolder.c_str());
+    if (!dir)
+        return;
+    set<string> cacheNames;
+    for (auto &name : names)
+    {
+        cacheNames.insert(name + SCREENSHOT_THUMBNAIL_EXTENSION);
+    }
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (entry->d_type != DT_REG && entry->d_type != DT_UNKNOWN)
+            continue;
+        // leftover temp files are stale as well
+        if (strncmp(entry->d_name, SCREENSHOT_FILE_PREFIX, strlen(SCREENSHOT_FILE_PREFIX)) != 0 ||
+            cacheNames.count(entry->d_name) > 0)
+            continue;
+        string path = m_cacheFolder + "/" + entry->d_name;
+        if (unlink(path.c_str()) != 0) {
+            qDebug("Cannot delete file::%s", path.c_str());
+        }
+    }
+    closedir(dir);
+#endif
+}
+
+string ScreenshotThumbnailer::_get_cache_path(const string& name)
+{
+    return m_cacheFolder + "/" + name + SCREENSHOT_THUMBNAIL_EXTENSION;
+}
+
+bool ScreenshotThumbnailer::_read_cache(const string& path, const struct stat &sourceStat, ThumbnailImage &thumbnail)
+{
+#ifdef _WIN32
+    return false;
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    ThumbnailCacheHeader header;
+    bool isValid = (read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header)) &&
+        memcmp(header.magic, THUMBNAIL_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+        header.mtimeSec == (int64_t)sourceStat.st_mtim.tv_sec &&
+        header.mtimeNsec == (int64_t)sourceStat.st_mtim.tv_nsec &&
+        header.size == (int64_t)sourceStat.st_size &&
+        header.width > 0 && header.width <= SCREENSHOT_THUMBNAIL_MAX_WIDTH &&
+        header.height > 0 && header.height <= SCREENSHOT_THUMBNAIL_MAX_HEIGHT;
+    if (isValid)
+    {
+        thumbnail = ThumbnailImage(header.width, header.height);
+        ssize_t length = (ssize_t)thumbnail.getStride() * thumbnail.getHeight();
+        isValid = (read(fd, thumbnail.getPixels(), length) == length);
+    }
+    close(fd);
+    return isValid;
+#endif
+}
+
+bool ScreenshotThumbnailer::_write_cache(const string& path, const struct stat &sourceStat, const ThumbnailImage &thumbnail)
+{
+#ifdef _WIN32
+    return false;
+#else
+    if (mkdir(m_cacheFolder.c_str(), 0755) != 0 && errno != EEXIST) {
+        qDebug("Cannot create folder::%s", m_cacheFolder.c_str());
+        return false;
+    }
+    ThumbnailCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, THUMBNAIL_CACHE_MAGIC, sizeof(header.magic));
+    header.width = thumbnail.getWidth();
+    header.height = thumbnail.getHeight();
+    header.mtimeSec = sourceStat.st_mtim.tv_sec;
+    header.mtimeNsec = sourceStat.st_mtim.tv_nsec;
+    header.size = sourceStat.st_size;
+    // write then rename, a reader never sees half a thumbnail.
+    // no fsync, a lost cache entry is only regenerated
+    string tempPath = path + THUMBNAIL_CACHE_TEMP_SUFFIX;
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        qDebug("Cannot open file for writing::%s", tempPath.c_str());
+        return false;
+    }
+    ssize_t length = (ssize_t)thumbnail.getStride() * thumbnail.getHeight();
+    bool isSuccess = (write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header)) &&
+        (write(fd, thumbnail.getPixels(), length) == length);
+    if (close(fd) != 0)
+        isSuccess = false;
+    if (isSuccess && rename(tempPath.c_str(), path.c_str()) != 0)
+        isSuccess = false;
+    if (!isSuccess) {
+        qDebug("Cannot write file::%s", path.c_str());
+        unlink(tempPath.c_str());
+    }
+    return isSuccess;
+#endif
+}
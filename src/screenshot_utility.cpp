@@ -0,0 +1,674 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#endif
+#ifdef SCREENSHOT_ARCHIVE_ZSTD
+#include <zstd.h>
+#define SCREENSHOT_ARCHIVE_EXTENSION ".tar.zst"
+#else
+#include <zlib.h>
+#define SCREENSHOT_ARCHIVE_EXTENSION ".tar.gz"
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/storage_utility.h"
+#include "./include/screenshot_utility.h"
+
+#define STRING_ONE "1"
+
+static const char *SYSFS_PARTITION = "partition";
+static const char *SYSFS_QUEUE_ROTATIONAL = "queue/rotational";
+static const char *SYSFS_REMOVABLE = "removable";
+
+#define TAR_BLOCK_SIZE  512
+
+// realpath of an existing folder, else the path as given
+static string get_canonical_path(const char* path)
+{
+#ifdef _WIN32
+    return path;
+#else
+    char *resolved = realpath(path, nullptr);
+    if (!resolved)
+        return path;
+    string result = resolved;
+    free(resolved);
+    return result;
+#endif
+}
+
+// whole path components only, a prefix must end at a '/' of the path
+static bool is_same_or_parent_folder(const string& folder, const string& path)
+{
+    if (folder.empty() || path.compare(0, folder.size(), folder) != 0)
+        return false;
+    return path.size() == folder.size() || folder.back() == '/' || path[folder.size()] == '/';
+}
+#define TAR_RECORD_SIZE (20 * TAR_BLOCK_SIZE)
+// screenshots are png, already compressed, favor speed
+#define SCREENSHOT_ARCHIVE_LEVEL 1
+#define SCREENSHOT_ARCHIVE_MAX_RETRY 100
+
+#ifdef _WIN32
+#else
+static bool write_all(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t ret = write(fd, data, len);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        data += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+// ustar stream compressed on the fly, compression is chosen at build time
+class ScreenshotArchiveWriter
+{
+public:
+    explicit ScreenshotArchiveWriter(int fd)
+        : m_output(SCREENSHOT_ARCHIVE_BUFF_SIZE)
+    {
+        m_fd = fd;
+        m_isOpened = false;
+        m_tarBytes = 0;
+        m_compressedBytes = 0;
+#ifdef SCREENSHOT_ARCHIVE_ZSTD
+        m_stream = ZSTD_createCCtx();
+        m_isOpened = m_stream &&
+            !ZSTD_isError(ZSTD_CCtx_setParameter(m_stream, ZSTD_c_compressionLevel, SCREENSHOT_ARCHIVE_LEVEL));
+#else
+        memset(&m_stream, 0, sizeof(m_stream));
+        // 16 + window bits writes gzip header and trailer
+        m_isOpened = (deflateInit2(&m_stream, SCREENSHOT_ARCHIVE_LEVEL, Z_DEFLATED, 16 + MAX_WBITS,
+                                   8, Z_DEFAULT_STRATEGY) == Z_OK);
+#endif
+    }
+
+    ~ScreenshotArchiveWriter()
+    {
+#ifdef SCREENSHOT_ARCHIVE_ZSTD
+        ZSTD_freeCCtx(m_stream);
+#else
+        if (m_isOpened)
+            deflateEnd(&m_stream);
+#endif
+    }
+
+    bool isOpened()
+    {
+        return m_isOpened;
+    }
+
+    unsigned long long getCompressedBytes()
+    {
+        return m_compressedBytes;
+    }
+
+    bool addHeader(const string& name, unsigned long long size, time_t mtime)
+    {
+        // ustar name field holds 99 characters
+        if (name.size() >= 100) {
+            qDebug("file name too long for archive:%s", name.c_str());
+            return false;
+        }
+        char header[TAR_BLOCK_SIZE] = {0};
+        memcpy(header, name.c_str(), name.size());
+        snprintf(header + 100, 8, "%07o", 0644);
+        snprintf(header + 108, 8, "%07o", 0);
+        snprintf(header + 116, 8, "%07o", 0);
+        snprintf(header + 124, 12, "%011llo", size);
+        snprintf(header + 136, 12, "%011llo", (unsigned long long)mtime);
+        header[156] = '0';
+        memcpy(header + 257, "ustar", 6);
+        memcpy(header + 263, "00", 2);
+        memcpy(header + 265, "root", 4);
+        memcpy(header + 297, "root", 4);
+        // checksum is calculated with its own field filled with spaces
+        memset(header + 148, ' ', 8);
+        unsigned int checksum = 0;
+        for (int i = 0; i < TAR_BLOCK_SIZE; i++)
+        {
+            checksum += (unsigned char)header[i];
+        }
+        snprintf(header + 148, 8, "%06o", checksum);
+        return write(header, TAR_BLOCK_SIZE);
+    }
+
+    // entries are padded to tar block size
+    bool padEntry(unsigned long long size)
+    {
+        static const char zeros[TAR_BLOCK_SIZE] = {0};
+        size_t remain = size % TAR_BLOCK_SIZE;
+        if (remain == 0)
+            return true;
+        return write(zeros, TAR_BLOCK_SIZE - remain);
+    }
+
+    bool write(const char *data, size_t len)
+    {
+        m_tarBytes += len;
+        return _compress(data, len, false);
+    }
+
+    bool finish()
+    {
+        // two zero blocks end the archive, then pad to a full record
+        static const char zeros[TAR_BLOCK_SIZE] = {0};
+        if (!write(zeros, TAR_BLOCK_SIZE) || !write(zeros, TAR_BLOCK_SIZE))
+            return false;
+        while (m_tarBytes % TAR_RECORD_SIZE != 0)
+        {
+            if (!write(zeros, TAR_BLOCK_SIZE))
+                return false;
+        }
+        return _compress(nullptr, 0, true);
+    }
+
+private:
+    bool _compress(const char *data, size_t len, bool isFinish)
+    {
+#ifdef SCREENSHOT_ARCHIVE_ZSTD
+        ZSTD_inBuffer input = {data, len, 0};
+        ZSTD_EndDirective mode = isFinish ? ZSTD_e_end : ZSTD_e_continue;
+        while (true)
+        {
+            ZSTD_outBuffer output = {m_output.data(), m_output.size(), 0};
+            size_t remaining = ZSTD_compressStream2(m_stream, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                qDebug("compress failed:%s", ZSTD_getErrorName(remaining));
+                return false;
+            }
+            if (!_write_output(output.pos))
+                return false;
+            if (isFinish ? remaining == 0 : input.pos == input.size)
+                return true;
+        }
+#else
+        m_stream.next_in = (Bytef *)data;
+        m_stream.avail_in = (uInt)len;
+        while (true)
+        {
+            m_stream.next_out = (Bytef *)m_output.data();
+            m_stream.avail_out = (uInt)m_output.size();
+            int ret = deflate(&m_stream, isFinish ? Z_FINISH : Z_NO_FLUSH);
+            if (ret == Z_STREAM_ERROR) {
+                qDebug("compress failed:%d", ret);
+                return false;
+            }
+            if (!_write_output(m_output.size() - m_stream.avail_out))
+                return false;
+            if (isFinish ? ret == Z_STREAM_END : m_stream.avail_out != 0)
+                return true;
+        }
+#endif
+    }
+
+    bool _write_output(size_t len)
+    {
+        if (!write_all(m_fd, m_output.data(), len)) {
+            qDebug("write archive failed:%s", strerror(errno));
+            return false;
+        }
+        m_compressedBytes += len;
+        return true;
+    }
+
+    int m_fd;
+    bool m_isOpened;
+    unsigned long long m_tarBytes;
+    unsigned long long m_compressedBytes;
+    vector<char> m_output;
+#ifdef SCREENSHOT_ARCHIVE_ZSTD
+    ZSTD_CCtx *m_stream;
+#else
+    z_stream m_stream;
+#endif
+};
+#endif
+
+TPCScreenshotUtility::TPCScreenshotUtility(const char* screenshotFolder, const char* sysDevBlockFolder)
+{
+    m_screenshotFolder = screenshotFolder ? screenshotFolder : SCREENSHOTS_FOLDER;
+    m_sysDevBlockFolder = sysDevBlockFolder ? sysDevBlockFolder : SCREENSHOT_SYS_DEV_BLOCK;
+}
+
+pair<vector<string>, bool> TPCScreenshotUtility::get_screenshots()
+{
+    vector<string> screenshots;
+#ifdef _WIN32
+    return make_pair(screenshots, false);
+#else
+    DIR *dir = opendir(m_screenshotFolder.c_str());
+    if (!dir) {
+        qDebug("Cannot open folder::%s", m_screenshotFolder.c_str());
+        return make_pair(screenshots, false);
+    }
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (entry->d_type != DT_REG && entry->d_type != DT_UNKNOWN)
+            continue;
+        if (strncmp(entry->d_name, SCREENSHOT_FILE_PREFIX, strlen(SCREENSHOT_FILE_PREFIX)) != 0)
+            continue;
+        screenshots.push_back(entry->d_name);
+    }
+    closedir(dir);
+    // file name contains timestamp, keep export order stable
+    sort(screenshots.begin(), screenshots.end());
+    return make_pair(screenshots, true);
+#endif
+}
+
+int TPCScreenshotUtility::get_screenshots_count()
+{
+    return (int)get_screenshots().first.size();
+}
+
+pair<string, bool> TPCScreenshotUtility::export_screenshots(const char* exportFolder, ScreenshotProgressFunc progress,
+                                                            CancelCheckFunc isCancelled)
+{
+    vector<string> screenshots;
+    auto retPrepare = _prepare_export(exportFolder, screenshots);
+    if (!retPrepare.second)
+        return retPrepare;
+#ifdef _WIN32
+    return make_pair("", false);
+#else
+    string folder = exportFolder;
+    int totalFiles = (int)screenshots.size();
+    int workers = min(get_export_workers(exportFolder), totalFiles);
+    std::atomic<size_t> nextIndex(0);
+    std::atomic<bool> isFailed(false);
+    std::mutex progressMutex;
+    int doneFiles = 0;
+    unsigned long long totalBytes = 0;
+    string failedFile;
+    std::atomic<bool> isStopped(false);
+    // workers poll the job, a cancel seen by one stops all of them
+    auto checkCancelled = [&isCancelled, &isStopped]() {
+        if (!isStopped && isCancelled && isCancelled())
+            isStopped = true;
+        return (bool)isStopped;
+    };
+    auto start = std::chrono::steady_clock::now();
+    auto work = [&]() {
+        while (!checkCancelled() && !isFailed)
+        {
+            size_t index = nextIndex++;
+            if (index >= screenshots.size())
+                return;
+            const string &fileName = screenshots[index];
+            unsigned long long copiedBytes = 0;
+            bool result = _copy_file(m_screenshotFolder + "/" + fileName, folder + "/" + fileName, &copiedBytes,
+                                     checkCancelled);
+            std::lock_guard<std::mutex> lock(progressMutex);
+            if (!result) {
+                // ex: usb stick is full or removed, stop other workers too
+                if (!isStopped && failedFile.empty()) {
+                    failedFile = fileName;
+                    isFailed = true;
+                }
+                return;
+            }
+            doneFiles++;
+            totalBytes += copiedBytes;
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (progress)
+                progress(doneFiles, totalFiles, fileName, seconds > 0 ? totalBytes / seconds : 0);
+        }
+    };
+    vector<std::thread> threads;
+    for (int i = 1; i < workers; i++)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    // make sure new directory entries reach the media
+    int dirFd = open(folder.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    qDebug("export %d/%d screenshots with %d workers, %s in %.1f seconds",
+        doneFiles, totalFiles, workers, format_size(totalBytes).c_str(), seconds);
+    if (isStopped)
+        return make_pair("Export screenshots is cancelled.", false);
+    if (isFailed)
+        return make_pair("Export " + failedFile + " failed. Please check free space of the selected folder.", false);
+    return make_pair("", true);
+#endif
+}
+
+pair<string, bool> TPCScreenshotUtility::export_screenshots_archive(const char* exportFolder, ScreenshotProgressFunc progress,
+                                                                    CancelCheckFunc isCancelled)
+{
+    vector<string> screenshots;
+    auto retPrepare = _prepare_export(exportFolder, screenshots);
+    if (!retPrepare.second)
+        return retPrepare;
+#ifdef _WIN32
+    return make_pair("", false);
+#else
+    // manifest goes first, so sizes and times are collected before streaming
+    string manifest = "# name\tsize\tmodified\n";
+    vector<struct stat> stats(screenshots.size());
+    for (size_t i = 0; i < screenshots.size(); i++)
+    {
+        string path = m_screenshotFolder + "/" + screenshots[i];
+        if (stat(path.c_str(), &stats[i]) != 0) {
+            qDebug("stat %s failed:%s", path.c_str(), strerror(errno));
+            return make_pair("Export " + screenshots[i] + " failed.", false);
+        }
+        char timeBuff[64] = {0};
+        struct tm timeInfo;
+        strftime(timeBuff, sizeof(timeBuff), "%Y-%m-%d %H:%M:%S", localtime_r(&stats[i].st_mtime, &timeInfo));
+        char line_buff[BUFF_SIZE] = {0};
+        snprintf(line_buff, BUFF_SIZE, "%s\t%lld\t%s\n", screenshots[i].c_str(), (long long)stats[i].st_size, timeBuff);
+        manifest.append(line_buff);
+    }
+    char name_buff[BUFF_SIZE] = {0};
+    time_t now = time(nullptr);
+    struct tm nowInfo;
+    strftime(name_buff, BUFF_SIZE, SCREENSHOT_ARCHIVE_PREFIX "%Y%m%d-%H%M%S", localtime_r(&now, &nowInfo));
+    string archivePath;
+    int archiveFd = -1;
+    // never overwrite an earlier archive, ex: two exports within one second
+    for (int i = 0; archiveFd < 0 && i < SCREENSHOT_ARCHIVE_MAX_RETRY; i++)
+    {
+        archivePath = string(exportFolder) + "/" + name_buff;
+        if (i > 0)
+            archivePath += "-" + to_string(i);
+        archivePath += SCREENSHOT_ARCHIVE_EXTENSION;
+        archiveFd = open(archivePath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (archiveFd < 0 && errno != EEXIST)
+            break;
+    }
+    if (archiveFd < 0) {
+        qDebug("Cannot open file::%s %s", archivePath.c_str(), strerror(errno));
+        return make_pair("Export screenshots failed. Please check the selected folder.", false);
+    }
+
+    int totalFiles = (int)screenshots.size();
+    int doneFiles = 0;
+    unsigned long long totalBytes = 0;
+    string failedFile;
+    bool isStopped = false;
+    auto checkCancelled = [&isCancelled, &isStopped]() {
+        if (!isStopped && isCancelled && isCancelled())
+            isStopped = true;
+        return isStopped;
+    };
+    vector<char> buff(SCREENSHOT_ARCHIVE_BUFF_SIZE);
+    auto start = std::chrono::steady_clock::now();
+    ScreenshotArchiveWriter writer(archiveFd);
+    bool result = writer.isOpened() &&
+        writer.addHeader(SCREENSHOT_MANIFEST_NAME, manifest.size(), now) &&
+        writer.write(manifest.c_str(), manifest.size()) &&
+        writer.padEntry(manifest.size());
+    for (int i = 0; result && i < totalFiles && !checkCancelled(); i++)
+    {
+        const string &fileName = screenshots[i];
+        string path = m_screenshotFolder + "/" + fileName;
+        unsigned long long size = stats[i].st_size;
+        int sourceFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        result = (sourceFd >= 0) && writer.addHeader(fileName, size, stats[i].st_mtime);
+        unsigned long long remain = size;
+        while (result && remain > 0 && !checkCancelled())
+        {
+            ssize_t len = read(sourceFd, buff.data(), min<unsigned long long>(remain, buff.size()));
+            if (len < 0 && errno == EINTR)
+                continue;
+            // 0 means file changed after manifest was written
+            if (len <= 0) {
+                result = false;
+                break;
+            }
+            result = writer.write(buff.data(), len);
+            remain -= len;
+        }
+        if (sourceFd >= 0)
+            close(sourceFd);
+        if (!result) {
+            failedFile = fileName;
+            break;
+        }
+        if (isStopped)
+            break;
+        result = writer.padEntry(size);
+        doneFiles++;
+        totalBytes += size;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (progress)
+            progress(doneFiles, totalFiles, fileName, seconds > 0 ? totalBytes / seconds : 0);
+    }
+    if (result && !isStopped)
+        result = writer.finish();
+    // verify what reached the media has the written size
+    if (result && !isStopped && fsync(archiveFd) != 0) {
+        qDebug("sync %s failed:%s", archivePath.c_str(), strerror(errno));
+        result = false;
+    }
+    struct stat archiveStat;
+    if (result && !isStopped &&
+        (fstat(archiveFd, &archiveStat) != 0 || (unsigned long long)archiveStat.st_size != writer.getCompressedBytes())) {
+        qDebug("verify %s failed, size mismatch", archivePath.c_str());
+        result = false;
+    }
+    close(archiveFd);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    qDebug("archive %d/%d screenshots, %s to %s in %.1f seconds", doneFiles, totalFiles,
+        format_size(totalBytes).c_str(), format_size(writer.getCompressedBytes()).c_str(), seconds);
+    if (isStopped || !result)
+        unlink(archivePath.c_str());
+    if (isStopped)
+        return make_pair("Export screenshots is cancelled.", false);
+    if (!failedFile.empty())
+        return make_pair("Export " + failedFile + " failed. Please check free space of the selected folder.", false);
+    if (!result)
+        return make_pair("Export screenshots failed. Please check free space of the selected folder.", false);
+    // directory entry of the archive
+    int dirFd = open(exportFolder, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return make_pair(archivePath, true);
+#endif
+}
+
+pair<string, bool> TPCScreenshotUtility::_prepare_export(const char* exportFolder, vector<string> &screenshots)
+{
+    // check input
+    if (!exportFolder) {
+        qDebug("missing parameter");
+        return make_pair("", false);
+    }
+    // ex: /media/usb is not a parent of /media/usb2, symlinks and trailing slashes are resolved
+    if (is_same_or_parent_folder(get_canonical_path(exportFolder), get_canonical_path(m_screenshotFolder.c_str()))) {
+        return make_pair("Screenshots are under " + m_screenshotFolder + ". Please select another folder.", false);
+    }
+    screenshots = get_screenshots().first;
+    if (screenshots.empty()) {
+        return make_pair("No screenshot. Unable to export screenshots.", false);
+    }
+    return make_pair("", true);
+}
+
+bool TPCScreenshotUtility::delete_screenshots()
+{
+    bool result = true;
+#ifdef _WIN32
+#else
+    auto retScreenshots = get_screenshots();
+    result = retScreenshots.second;
+    for (auto &fileName : retScreenshots.first)
+    {
+        string path = m_screenshotFolder + "/" + fileName;
+        if (unlink(path.c_str()) != 0) {
+            qDebug("delete %s failed:%s", path.c_str(), strerror(errno));
+            result = false;
+        }
+    }
+#endif
+    return result;
+}
+
+int TPCScreenshotUtility::get_export_workers(const char* exportFolder)
+{
+    int workers = 1;
+#ifdef _WIN32
+#else
+    // check input
+    if (!exportFolder) {
+        qDebug("missing parameter");
+        return workers;
+    }
+    struct stat folderStat;
+    if (stat(exportFolder, &folderStat) != 0)
+        return workers;
+    char path_buff[BUFF_SIZE] = {0};
+    snprintf(path_buff, BUFF_SIZE, "%s/%u:%u", m_sysDevBlockFolder.c_str(),
+        major(folderStat.st_dev), minor(folderStat.st_dev));
+    string deviceFolder = path_buff;
+    // queue attributes only exist on the disk, not on its partitions
+    if (is_file_exist((deviceFolder + "/" + SYSFS_PARTITION).c_str()))
+        deviceFolder += "/..";
+    string value;
+    if (!_read_sysfs_value(deviceFolder + "/" + SYSFS_QUEUE_ROTATIONAL, value))
+        return workers;
+    // spinning disk, parallel writers only add seeks
+    if (value.compare(STRING_ONE) == 0)
+        return workers;
+    if (_read_sysfs_value(deviceFolder + "/" + SYSFS_REMOVABLE, value) && value.compare(STRING_ONE) == 0)
+        return SCREENSHOT_EXPORT_REMOVABLE_WORKERS;
+    workers = (int)std::thread::hardware_concurrency();
+    workers = max(1, min(workers, SCREENSHOT_EXPORT_MAX_WORKERS));
+#endif
+    return workers;
+}
+
+bool TPCScreenshotUtility::_copy_file(const string& source, const string& target, unsigned long long *copiedBytes,
+                                      const CancelCheckFunc &isCancelled)
+{
+    *copiedBytes = 0;
+#ifdef _WIN32
+    return false;
+#else
+    int sourceFd = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        qDebug("Cannot open file::%s", source.c_str());
+        return false;
+    }
+    struct stat sourceStat;
+    if (fstat(sourceFd, &sourceStat) != 0) {
+        close(sourceFd);
+        return false;
+    }
+    int targetFd = open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (targetFd < 0) {
+        qDebug("Cannot open file::%s %s", target.c_str(), strerror(errno));
+        close(sourceFd);
+        return false;
+    }
+    bool result = true;
+    bool isCopyRange = true;
+    vector<char> buff;
+    off_t remain = sourceStat.st_size;
+    while (remain > 0)
+    {
+        if (isCancelled && isCancelled()) {
+            result = false;
+            break;
+        }
+        size_t chunk = (size_t)min<off_t>(remain, SCREENSHOT_COPY_CHUNK_SIZE);
+        ssize_t size = 0;
+        if (isCopyRange) {
+            // in kernel copy, no user space buffer
+            size = copy_file_range(sourceFd, nullptr, targetFd, nullptr, chunk, 0);
+            if (size < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+                // ex: cross filesystem copy on older kernel, fall back to read/write
+                isCopyRange = false;
+                buff.resize(SCREENSHOT_COPY_CHUNK_SIZE);
+                continue;
+            }
+        } else {
+            size = read(sourceFd, buff.data(), chunk);
+            ssize_t written = 0;
+            while (size > 0 && written < size)
+            {
+                ssize_t ret = write(targetFd, buff.data() + written, size - written);
+                if (ret < 0 && errno == EINTR)
+                    continue;
+                if (ret <= 0) {
+                    size = -1;
+                    break;
+                }
+                written += ret;
+            }
+        }
+        if (size < 0 && errno == EINTR)
+            continue;
+        // 0 means source was truncated while copying
+        if (size <= 0) {
+            qDebug("copy %s failed:%s", source.c_str(), size < 0 ? strerror(errno) : "short read");
+            result = false;
+            break;
+        }
+        remain -= size;
+        *copiedBytes += size;
+    }
+    // verify what reached the media has the source size
+    if (result && fsync(targetFd) != 0) {
+        qDebug("sync %s failed:%s", target.c_str(), strerror(errno));
+        result = false;
+    }
+    struct stat targetStat;
+    if (result && (fstat(targetFd, &targetStat) != 0 || targetStat.st_size != sourceStat.st_size)) {
+        qDebug("verify %s failed, size mismatch", target.c_str());
+        result = false;
+    }
+    close(targetFd);
+    close(sourceFd);
+    if (!result)
+        unlink(target.c_str());
+    return result;
+#endif
+}
+
+bool TPCScreenshotUtility::_read_sysfs_value(const string& path, string &value)
+{
+    ifstream file(path);
+    if (!file.good())
+        return false;
+    getline(file, value);
+    return true;
+}
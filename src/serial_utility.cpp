@@ -0,0 +1,418 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/serial_utility.h"
+
+// start, 8 data and stop bit
+#define SERIAL_BITS_PER_BYTE    10
+#define SERIAL_IO_CHUNK_SIZE    512
+
+#ifdef _WIN32
+#else
+static const struct {
+    int baudrate;
+    speed_t speed;
+} BAUDRATE_TABLE[] = {
+    {1200, B1200}, {2400, B2400}, {4800, B4800}, {9600, B9600}, {19200, B19200},
+    {38400, B38400}, {57600, B57600}, {115200, B115200}, {230400, B230400},
+    {460800, B460800}, {921600, B921600},
+};
+
+static speed_t get_speed(int baudrate)
+{
+    for (auto &itr : BAUDRATE_TABLE)
+    {
+        if (itr.baudrate == baudrate)
+            return itr.speed;
+    }
+    return B0;
+}
+
+static int get_baudrate(speed_t speed)
+{
+    for (auto &itr : BAUDRATE_TABLE)
+    {
+        if (itr.speed == speed)
+            return itr.baudrate;
+    }
+    return 0;
+}
+
+static double elapsed_us(const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// waits for any of events on fd, false on timeout or error
+static bool wait_fd(int fd, short events, int timeoutMs)
+{
+    struct pollfd pfd = {fd, events, 0};
+    int ret = 0;
+    do {
+        ret = poll(&pfd, 1, timeoutMs);
+    } while (ret < 0 && errno == EINTR);
+    return ret > 0 && (pfd.revents & events);
+}
+#endif
+
+SerialPortConfig make_serial_config(int baudrate, const char* mode)
+{
+    SerialPortConfig config;
+    config.baudrate = baudrate > 0 ? baudrate : SERIAL_DEFAULT_BAUDRATE;
+    config.dataBits = 8;
+    config.parity = 'N';
+    config.stopBits = 1;
+    config.mode = (mode && strlen(mode) > 0) ? mode : SERIAL_MODE_RS232;
+    config.lowLatency = true;
+    return config;
+}
+
+bool configure_serial_port(int fd, const SerialPortConfig &config)
+{
+#ifdef _WIN32
+    return false;
+#else
+    // check input
+    if (fd < 0 || config.dataBits < 5 || config.dataBits > 8 || config.stopBits < 1 || config.stopBits > 2) {
+        qDebug("missing parameter");
+        return false;
+    }
+    speed_t speed = get_speed(config.baudrate);
+    if (speed == B0) {
+        qDebug("unsupported baud rate:%d", config.baudrate);
+        return false;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        qDebug("tcgetattr failed:%s", strerror(errno));
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB | CRTSCTS);
+    tio.c_cflag |= CLOCAL | CREAD;
+    const tcflag_t sizes[] = {CS5, CS6, CS7, CS8};
+    tio.c_cflag |= sizes[config.dataBits - 5];
+    if (config.parity == 'E' || config.parity == 'O') {
+        tio.c_cflag |= PARENB | (config.parity == 'O' ? PARODD : 0);
+        tio.c_iflag |= INPCK;
+    }
+    if (config.stopBits == 2)
+        tio.c_cflag |= CSTOPB;
+    // reads return what is there, callers poll
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        qDebug("tcsetattr failed:%s", strerror(errno));
+        return false;
+    }
+
+    bool isRS485 = (config.mode.compare(SERIAL_MODE_RS485) == 0);
+    struct serial_rs485 rs485;
+    memset(&rs485, 0, sizeof(rs485));
+    if (isRS485)
+        rs485.flags = SER_RS485_ENABLED | SER_RS485_RTS_ON_SEND;
+    // a driver without rs485 support is only an error when rs485 is asked for
+    if (ioctl(fd, TIOCSRS485, &rs485) != 0 && isRS485) {
+        qDebug("TIOCSRS485 failed:%s", strerror(errno));
+        return false;
+    }
+
+    struct serial_struct serial;
+    if (ioctl(fd, TIOCGSERIAL, &serial) == 0) {
+        if (config.lowLatency)
+            serial.flags |= ASYNC_LOW_LATENCY;
+        else
+            serial.flags &= ~ASYNC_LOW_LATENCY;
+        if (ioctl(fd, TIOCSSERIAL, &serial) != 0)
+            qDebug("TIOCSSERIAL failed:%s", strerror(errno));
+    }
+    tcflush(fd, TCIOFLUSH);
+    return true;
+#endif
+}
+
+pair<SerialPortConfig, bool> read_serial_port_config(int fd)
+{
+    SerialPortConfig config = make_serial_config(SERIAL_DEFAULT_BAUDRATE, SERIAL_MODE_RS232);
+#ifdef _WIN32
+    return make_pair(config, false);
+#else
+    struct termios tio;
+    if (fd < 0 || tcgetattr(fd, &tio) != 0)
+        return make_pair(config, false);
+    config.baudrate = get_baudrate(cfgetospeed(&tio));
+    switch (tio.c_cflag & CSIZE)
+    {
+    case CS5: config.dataBits = 5; break;
+    case CS6: config.dataBits = 6; break;
+    case CS7: config.dataBits = 7; break;
+    default: config.dataBits = 8; break;
+    }
+    config.parity = (tio.c_cflag & PARENB) ? ((tio.c_cflag & PARODD) ? 'O' : 'E') : 'N';
+    config.stopBits = (tio.c_cflag & CSTOPB) ? 2 : 1;
+    // rs422 is not visible to the driver, it reads as rs232
+    struct serial_rs485 rs485;
+    memset(&rs485, 0, sizeof(rs485));
+    if (ioctl(fd, TIOCGRS485, &rs485) == 0 && (rs485.flags & SER_RS485_ENABLED))
+        config.mode = SERIAL_MODE_RS485;
+    struct serial_struct serial;
+    config.lowLatency = (ioctl(fd, TIOCGSERIAL, &serial) == 0 && (serial.flags & ASYNC_LOW_LATENCY));
+    return make_pair(config, true);
+#endif
+}
+
+SerialBenchmarkResult::SerialBenchmarkResult()
+{
+    m_baudrate = 0;
+    m_bytes = 0;
+    m_seconds = 0;
+    m_errors = 0;
+}
+
+void SerialBenchmarkResult::setBaudrate(int baudrate)
+{
+    m_baudrate = baudrate;
+}
+
+void SerialBenchmarkResult::setBytes(unsigned long long bytes)
+{
+    m_bytes = bytes;
+}
+
+void SerialBenchmarkResult::setSeconds(double seconds)
+{
+    m_seconds = seconds;
+}
+
+void SerialBenchmarkResult::setErrors(int errors)
+{
+    m_errors = errors;
+}
+
+void SerialBenchmarkResult::setLatencies(vector<double> &latencies)
+{
+    m_latencies = latencies;
+    std::sort(m_latencies.begin(), m_latencies.end());
+}
+
+int SerialBenchmarkResult::getBaudrate()
+{
+    return m_baudrate;
+}
+
+unsigned long long SerialBenchmarkResult::getBytes()
+{
+    return m_bytes;
+}
+
+double SerialBenchmarkResult::getSeconds()
+{
+    return m_seconds;
+}
+
+int SerialBenchmarkResult::getErrors()
+{
+    return m_errors;
+}
+
+double SerialBenchmarkResult::getThroughput()
+{
+    if (m_seconds <= 0)
+        return 0;
+    return m_bytes / m_seconds;
+}
+
+double SerialBenchmarkResult::getEfficiency()
+{
+    // a pty has no line rate
+    if (m_baudrate <= 0)
+        return 0;
+    return getThroughput() * SERIAL_BITS_PER_BYTE / m_baudrate * 100.0;
+}
+
+double SerialBenchmarkResult::getLatencyAverage()
+{
+    if (m_latencies.empty())
+        return 0;
+    double sum = 0;
+    for (auto latency : m_latencies)
+        sum += latency;
+    return sum / m_latencies.size();
+}
+
+double SerialBenchmarkResult::getLatencyPercentile(double percentile)
+{
+    if (m_latencies.empty())
+        return 0;
+    size_t rank = (size_t)ceil(percentile / 100.0 * m_latencies.size());
+    if (rank < 1)
+        rank = 1;
+    if (rank > m_latencies.size())
+        rank = m_latencies.size();
+    return m_latencies[rank - 1];
+}
+
+double SerialBenchmarkResult::getLatencyMax()
+{
+    if (m_latencies.empty())
+        return 0;
+    return m_latencies.back();
+}
+
+string SerialBenchmarkResult::toString()
+{
+    char buff[BUFF_SIZE] = {0};
+    snprintf(buff, BUFF_SIZE,
+        "%d baud %.1fKB/s (%.0f%%) errors=%d\nrtt(us) %dB avg=%.0f p50=%.0f p99=%.0f max=%.0f\n",
+        m_baudrate, getThroughput() / 1024.0, getEfficiency(), m_errors, SERIAL_BENCHMARK_PACKET_SIZE,
+        getLatencyAverage(), getLatencyPercentile(50), getLatencyPercentile(99), getLatencyMax());
+    return buff;
+}
+
+pair<SerialBenchmarkResult, bool> run_serial_benchmark(int writeFd, int readFd, size_t bytes, int rounds,
+                                                       CancelCheckFunc isCancelled)
+{
+    SerialBenchmarkResult result;
+#ifdef _WIN32
+    return make_pair(result, false);
+#else
+    // check input
+    if (writeFd < 0 || readFd < 0 || bytes == 0 || rounds < 0) {
+        qDebug("missing parameter");
+        return make_pair(result, false);
+    }
+    const auto config = read_serial_port_config(writeFd);
+    if (config.second)
+        result.setBaudrate(config.first.baudrate);
+
+    // pattern without a short period, a dropped byte shows up as a mismatch
+    vector<unsigned char> sent(bytes);
+    unsigned int seed = 1;
+    for (auto &c : sent)
+    {
+        seed = seed * 1103515245 + 12345;
+        c = (unsigned char)(seed >> 16);
+    }
+    tcflush(readFd, TCIFLUSH);
+    int writeFlags = fcntl(writeFd, F_GETFL);
+    int readFlags = fcntl(readFd, F_GETFL);
+    fcntl(writeFd, F_SETFL, writeFlags | O_NONBLOCK);
+    fcntl(readFd, F_SETFL, readFlags | O_NONBLOCK);
+
+    // throughput, writing and reading interleaved so a full output queue never stalls the reader
+    unsigned char buff[SERIAL_IO_CHUNK_SIZE] = {0};
+    size_t written = 0;
+    size_t received = 0;
+    int errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    bool isStopped = false;
+    while (received < bytes)
+    {
+        if (isCancelled && isCancelled()) {
+            isStopped = true;
+            break;
+        }
+        struct pollfd fds[2];
+        nfds_t count = 0;
+        fds[count++] = {readFd, POLLIN, 0};
+        if (written < bytes) {
+            if (writeFd == readFd)
+                fds[0].events |= POLLOUT;
+            else
+                fds[count++] = {writeFd, POLLOUT, 0};
+        }
+        int ret = poll(fds, count, SERIAL_BENCHMARK_IDLE_MS);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            break;
+        for (nfds_t i = 0; i < count; i++)
+        {
+            if ((fds[i].revents & POLLOUT) && written < bytes) {
+                ssize_t size = write(writeFd, sent.data() + written, std::min(bytes - written, sizeof(buff)));
+                if (size > 0)
+                    written += size;
+            }
+            if (fds[i].revents & POLLIN) {
+                ssize_t size = read(readFd, buff, std::min(bytes - received, sizeof(buff)));
+                for (ssize_t j = 0; j < size; j++)
+                {
+                    if (buff[j] != sent[received + j])
+                        errors++;
+                }
+                if (size > 0)
+                    received += size;
+            }
+        }
+    }
+    result.setSeconds(elapsed_us(start) / 1000000.0);
+    result.setBytes(received);
+    bool isSuccess = (received == bytes);
+    if (isStopped)
+        qDebug("serial benchmark cancelled");
+    else if (!isSuccess)
+        qDebug("received %zu of %zu bytes, no loopback?", received, bytes);
+
+    // round trip of a small packet, the request/response case of a PLC poll
+    vector<double> latencies;
+    for (int round = 0; isSuccess && round < rounds; round++)
+    {
+        if (isCancelled && isCancelled()) {
+            qDebug("serial benchmark cancelled");
+            isSuccess = false;
+            break;
+        }
+        const unsigned char *packet = sent.data() + (round * SERIAL_BENCHMARK_PACKET_SIZE) % bytes;
+        size_t packetSize = std::min((size_t)SERIAL_BENCHMARK_PACKET_SIZE, bytes - (packet - sent.data()));
+        start = std::chrono::steady_clock::now();
+        if (write(writeFd, packet, packetSize) != (ssize_t)packetSize) {
+            isSuccess = false;
+            break;
+        }
+        size_t packetReceived = 0;
+        while (packetReceived < packetSize && wait_fd(readFd, POLLIN, SERIAL_BENCHMARK_IDLE_MS))
+        {
+            ssize_t size = read(readFd, buff, packetSize - packetReceived);
+            for (ssize_t j = 0; j < size; j++)
+            {
+                if (buff[j] != packet[packetReceived + j])
+                    errors++;
+            }
+            if (size > 0)
+                packetReceived += size;
+        }
+        if (packetReceived < packetSize) {
+            qDebug("round %d received %zu of %zu bytes", round, packetReceived, packetSize);
+            isSuccess = false;
+            break;
+        }
+        latencies.push_back(elapsed_us(start));
+    }
+    result.setLatencies(latencies);
+    result.setErrors(errors);
+
+    fcntl(writeFd, F_SETFL, writeFlags);
+    fcntl(readFd, F_SETFL, readFlags);
+    return make_pair(result, isSuccess && errors == 0);
+#endif
+}
@@ -0,0 +1,323 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstring>
+#include <QTimer>
+#include <QEventLoop>
+#include <QStringList>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QDBusPendingReply>
+#include <QDBusArgument>
+#include <QDBusVariant>
+#include <QDebug>
+
+#include "./include/service_manager.h"
+
+SystemdJobWatcher::SystemdJobWatcher(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void SystemdJobWatcher::add_job(const QString &job)
+{
+    m_jobs.insert(job);
+    if (m_results.find(job) != m_results.end())
+        return;
+    m_pendingJobs.insert(job);
+}
+
+bool SystemdJobWatcher::is_finished() const
+{
+    return m_pendingJobs.empty();
+}
+
+vector<string> SystemdJobWatcher::get_failed_units() const
+{
+    vector<string> units;
+    for (auto &itr : m_results)
+    {
+        // a failed job of another client is none of ours
+        if (m_jobs.find(itr.first) == m_jobs.end())
+            continue;
+        if (itr.second.second.compare("done") != 0)
+            units.push_back(itr.second.first.toStdString() + " " + itr.second.second.toStdString());
+    }
+    return units;
+}
+
+void SystemdJobWatcher::jobRemoved(uint id, QDBusObjectPath job, QString unit, QString result)
+{
+    Q_UNUSED(id);
+    // other clients' jobs are reported too, keep them all, one may be ours with the reply still on the way
+    // and get_failed_units only looks at added ones
+    m_results[job.path()] = make_pair(unit, result);
+    if (m_pendingJobs.erase(job.path()) > 0 && m_pendingJobs.empty())
+        emit allFinished();
+}
+
+SystemdUnitWatcher::SystemdUnitWatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_active = false;
+}
+
+void SystemdUnitWatcher::set_active_state(const QString &state)
+{
+    bool isActive = (state.compare("active") == 0);
+    if (isActive && !m_active) {
+        m_active = true;
+        emit becameActive();
+    }
+    m_active = isActive;
+}
+
+bool SystemdUnitWatcher::is_active() const
+{
+    return m_active;
+}
+
+void SystemdUnitWatcher::propertiesChanged(QString interface, QVariantMap changed, QStringList invalidated)
+{
+    Q_UNUSED(invalidated);
+    if (interface.compare(SYSTEMD1_UNIT_INTERFACE) != 0 || !changed.contains("ActiveState"))
+        return;
+    set_active_state(changed.value("ActiveState").toString());
+}
+
+TPCServiceManager::TPCServiceManager(const QDBusConnection &bus)
+    : m_bus(bus)
+{
+    if (!m_bus.isConnected()) {
+        qDebug("D-Bus is not connected::%s", m_bus.lastError().message().toStdString().c_str());
+        return;
+    }
+    // systemd only emits manager signals once a client subscribed
+    QDBusMessage message = QDBusMessage::createMethodCall(SYSTEMD1_SERVICE, SYSTEMD1_PATH,
+                                                          SYSTEMD1_MANAGER_INTERFACE, "Subscribe");
+    m_bus.asyncCall(message, SYSTEMD1_CALL_TIMEOUT_MS);
+}
+
+bool TPCServiceManager::start_units(const vector<string>& units)
+{
+    return _run_jobs("StartUnit", units);
+}
+
+bool TPCServiceManager::stop_units(const vector<string>& units)
+{
+    return _run_jobs("StopUnit", units);
+}
+
+bool TPCServiceManager::restart_units(const vector<string>& units)
+{
+    return _run_jobs("RestartUnit", units);
+}
+
+bool TPCServiceManager::enable_units(const vector<string>& units)
+{
+    if (units.empty())
+        return true;
+    QStringList files;
+    for (auto &unit : units)
+    {
+        files << QString::fromStdString(unit);
+    }
+    // runtime false, force true, same as systemctl enable
+    bool result = _call_manager("EnableUnitFiles", QList<QVariant>() << files << false << true);
+    // reload so the new links are seen, as systemctl enable does
+    result &= _call_manager("Reload", QList<QVariant>(), SYSTEMD1_JOB_TIMEOUT * 1000);
+    return result;
+}
+
+bool TPCServiceManager::disable_units(const vector<string>& units)
+{
+    if (units.empty())
+        return true;
+    QStringList files;
+    for (auto &unit : units)
+    {
+        files << QString::fromStdString(unit);
+    }
+    bool result = _call_manager("DisableUnitFiles", QList<QVariant>() << files << false);
+    result &= _call_manager("Reload", QList<QVariant>(), SYSTEMD1_JOB_TIMEOUT * 1000);
+    return result;
+}
+
+bool TPCServiceManager::enable_and_start_units(const vector<string>& units)
+{
+    bool result = enable_units(units);
+    // a stopped unit is started by RestartUnit as well
+    result &= _run_jobs("RestartUnit", units);
+    return result;
+}
+
+bool TPCServiceManager::stop_and_disable_units(const vector<string>& units)
+{
+    bool result = _run_jobs("StopUnit", units);
+    result &= disable_units(units);
+    return result;
+}
+
+pair<bool, bool> TPCServiceManager::get_unit_enabled(const char* unit)
+{
+    // check input
+    if (!unit || strlen(unit) == 0) {
+        qDebug("missing parameter");
+        return make_pair(false, false);
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(SYSTEMD1_SERVICE, SYSTEMD1_PATH,
+                                                          SYSTEMD1_MANAGER_INTERFACE, "GetUnitFileState");
+    message << QString(unit);
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, SYSTEMD1_CALL_TIMEOUT_MS);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qDebug("GetUnitFileState failed::%s", reply.errorMessage().toStdString().c_str());
+        return make_pair(false, false);
+    }
+    // enabled or enabled-runtime
+    QString state = reply.arguments().at(0).toString();
+    return make_pair(state.startsWith("enabled"), true);
+}
+
+pair<string, bool> TPCServiceManager::find_unit(const char* pattern)
+{
+    // check input
+    if (!pattern || strlen(pattern) == 0) {
+        qDebug("missing parameter");
+        return make_pair(string(), false);
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(SYSTEMD1_SERVICE, SYSTEMD1_PATH,
+                                                          SYSTEMD1_MANAGER_INTERFACE, "ListUnitsByPatterns");
+    message << QStringList() << (QStringList() << QString(pattern));
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, SYSTEMD1_CALL_TIMEOUT_MS);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qDebug("ListUnitsByPatterns failed::%s", reply.errorMessage().toStdString().c_str());
+        return make_pair(string(), false);
+    }
+    pair<string, bool> result = make_pair(string(), false);
+    // a(ssssssouso), name is the first field
+    const QDBusArgument units = reply.arguments().at(0).value<QDBusArgument>();
+    units.beginArray();
+    while (!units.atEnd())
+    {
+        QString name, description, loadState, activeState, subState, following, jobType;
+        QDBusObjectPath path, jobPath;
+        uint jobId = 0;
+        units.beginStructure();
+        units >> name >> description >> loadState >> activeState >> subState >> following
+              >> path >> jobId >> jobType >> jobPath;
+        units.endStructure();
+        if (!result.second && loadState.compare("loaded") == 0)
+            result = make_pair(name.toStdString(), true);
+    }
+    units.endArray();
+    return result;
+}
+
+bool TPCServiceManager::wait_unit_active(const char* unit, int timeoutMs)
+{
+    // check input
+    if (!unit || strlen(unit) == 0) {
+        qDebug("missing parameter");
+        return false;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(SYSTEMD1_SERVICE, SYSTEMD1_PATH,
+                                                          SYSTEMD1_MANAGER_INTERFACE, "LoadUnit");
+    message << QString(unit);
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, SYSTEMD1_CALL_TIMEOUT_MS);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qDebug("LoadUnit %s failed::%s", unit, reply.errorMessage().toStdString().c_str());
+        return false;
+    }
+    const QString path = reply.arguments().at(0).value<QDBusObjectPath>().path();
+
+    // subscribe before reading the state so no change is missed in between
+    SystemdUnitWatcher watcher;
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&watcher, SIGNAL(becameActive()), &loop, SLOT(quit()));
+    QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+    m_bus.connect(SYSTEMD1_SERVICE, path, DBUS_PROPERTIES_INTERFACE, "PropertiesChanged",
+                  &watcher, SLOT(propertiesChanged(QString, QVariantMap, QStringList)));
+    QDBusMessage getMessage = QDBusMessage::createMethodCall(SYSTEMD1_SERVICE, path, DBUS_PROPERTIES_INTERFACE, "Get");
+    getMessage << QString(SYSTEMD1_UNIT_INTERFACE) << QString("ActiveState");
+    QDBusMessage getReply = m_bus.call(getMessage, QDBus::Block, SYSTEMD1_CALL_TIMEOUT_MS);
+    if (getReply.type() == QDBusMessage::ReplyMessage && !getReply.arguments().isEmpty())
+        watcher.set_active_state(getReply.arguments().at(0).value<QDBusVariant>().variant().toString());
+    if (!watcher.is_active()) {
+        timer.start(timeoutMs);
+        loop.exec();
+    }
+    m_bus.disconnect(SYSTEMD1_SERVICE, path, DBUS_PROPERTIES_INTERFACE, "PropertiesChanged",
+                     &watcher, SLOT(propertiesChanged(QString, QVariantMap, QStringList)));
+    if (!watcher.is_active())
+        qDebug("%s is not active after %d ms", unit, timeoutMs);
+    return watcher.is_active();
+}
+
+bool TPCServiceManager::_run_jobs(const char* method, const vector<string>& units)
+{
+    if (units.empty())
+        return true;
+    // subscribe before queueing so no JobRemoved is missed
+    SystemdJobWatcher watcher;
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&watcher, SIGNAL(allFinished()), &loop, SLOT(quit()));
+    QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+    m_bus.connect(SYSTEMD1_SERVICE, SYSTEMD1_PATH, SYSTEMD1_MANAGER_INTERFACE, "JobRemoved",
+                  &watcher, SLOT(jobRemoved(uint, QDBusObjectPath, QString, QString)));
+
+    // all calls go out before the first reply is read, the jobs run in parallel
+    QList<QDBusPendingCall> calls;
+    for (auto &unit : units)
+    {
+        QDBusMessage message = QDBusMessage::createMethodCall(SYSTEMD1_SERVICE, SYSTEMD1_PATH,
+                                                              SYSTEMD1_MANAGER_INTERFACE, method);
+        message << QString::fromStdString(unit) << QString("replace");
+        calls << m_bus.asyncCall(message, SYSTEMD1_CALL_TIMEOUT_MS);
+    }
+    bool result = true;
+    for (int i = 0; i < calls.size(); i++)
+    {
+        QDBusPendingReply<QDBusObjectPath> reply = calls.at(i);
+        reply.waitForFinished();
+        if (reply.isError()) {
+            qDebug("%s %s failed::%s", method, units[i].c_str(), reply.error().message().toStdString().c_str());
+            result = false;
+            continue;
+        }
+        watcher.add_job(reply.value().path());
+    }
+    if (!watcher.is_finished())
+    {
+        timer.start(SYSTEMD1_JOB_TIMEOUT * 1000);
+        loop.exec();
+        if (!watcher.is_finished()) {
+            qDebug("%s jobs did not finish in %d seconds", method, SYSTEMD1_JOB_TIMEOUT);
+            result = false;
+        }
+    }
+    m_bus.disconnect(SYSTEMD1_SERVICE, SYSTEMD1_PATH, SYSTEMD1_MANAGER_INTERFACE, "JobRemoved",
+                     &watcher, SLOT(jobRemoved(uint, QDBusObjectPath, QString, QString)));
+    for (auto &failed : watcher.get_failed_units())
+    {
+        qDebug("%s job failed:%s", method, failed.c_str());
+        result = false;
+    }
+    return result;
+}
+
+bool TPCServiceManager::_call_manager(const char* method, const QList<QVariant> &arguments, int timeout)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(SYSTEMD1_SERVICE, SYSTEMD1_PATH,
+                                                          SYSTEMD1_MANAGER_INTERFACE, method);
+    message.setArguments(arguments);
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, timeout);
+    if (reply.type() != QDBusMessage::ReplyMessage) {
+        qDebug("%s failed::%s", method, reply.errorMessage().toStdString().c_str());
+        return false;
+    }
+    return true;
+}
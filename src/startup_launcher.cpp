@@ -0,0 +1,210 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/config_utility.h"
+#include "./include/service_manager.h"
+#include "./include/startup_utility.h"
+#include "./include/startup_launcher.h"
+#include "./include/startup_supervisor.h"
+
+// sockets are not regular files, is_file_exist does not see them
+static bool is_path_exist(const string& path)
+{
+#ifdef _WIN32
+    return true;
+#else
+    struct stat pathStat;
+    return stat(path.c_str(), &pathStat) == 0;
+#endif
+}
+
+static double get_monotonic_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+// what is left until the deadline, 0 once it passed
+static int get_remaining_ms(double deadlineMs)
+{
+    double remainingMs = deadlineMs - get_monotonic_ms();
+    return remainingMs > 0 ? (int)remainingMs : 0;
+}
+
+bool wait_for_file(const string& folder, const char* name, int timeoutMs)
+{
+    // check input
+    if (!name || folder.empty()) {
+        qDebug("missing parameter");
+        return false;
+    }
+    const string path = folder + "/" + name;
+#ifdef _WIN32
+    return is_path_exist(path);
+#else
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        qDebug("inotify_init1 failed:%s", strerror(errno));
+        return is_path_exist(path);
+    }
+    const string parent = folder.substr(0, folder.find_last_of('/'));
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool isFound = false;
+    while (true)
+    {
+        // watch first and look after, a file created in between is not missed
+        if (is_folder_exist(folder.c_str())) {
+            inotify_add_watch(fd, folder.c_str(), IN_CREATE | IN_MOVED_TO);
+            if (is_path_exist(path)) {
+                isFound = true;
+                break;
+            }
+        } else {
+            inotify_add_watch(fd, parent.empty() ? "/" : parent.c_str(), IN_CREATE | IN_MOVED_TO);
+            if (is_folder_exist(folder.c_str()))
+                continue;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int elapsedMs = (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+        if (elapsedMs >= timeoutMs)
+            break;
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ret = poll(&pfd, 1, timeoutMs - elapsedMs);
+        if (ret < 0 && errno != EINTR) {
+            qDebug("poll inotify failed:%s", strerror(errno));
+            break;
+        }
+        // drain, what was created is looked up again above
+        char buff[BUFF_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+        while (read(fd, buff, sizeof(buff)) > 0) {
+        }
+    }
+    close(fd);
+    return isFound;
+#endif
+}
+
+BootPhaseTimer::BootPhaseTimer()
+{
+    m_startMs = _get_time_ms(CLOCK_MONOTONIC);
+    m_lastMs = m_startMs;
+}
+
+void BootPhaseTimer::mark(const char* phase)
+{
+    double nowMs = _get_time_ms(CLOCK_MONOTONIC);
+    char buff[BUFF_SIZE] = {0};
+    // boottime includes suspend, the same clock as the kernel log
+    snprintf(buff, sizeof(buff), "%s %.0f ms (launcher %.0f ms, boot %.0f ms)", phase ? phase : "",
+             nowMs - m_lastMs, nowMs - m_startMs, _get_time_ms(CLOCK_BOOTTIME));
+    qDebug("startup launcher: %s", buff);
+    if (!m_summary.empty())
+        m_summary += ", ";
+    m_summary += buff;
+    m_lastMs = nowMs;
+}
+
+string BootPhaseTimer::get_summary()
+{
+    return m_summary;
+}
+
+double BootPhaseTimer::_get_time_ms(clockid_t clock)
+{
+    struct timespec time;
+    clock_gettime(clock, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+StartupLauncher::StartupLauncher(ConfigUtility *configUtil, IServiceManager *serviceManager,
+                                 const char* x11SocketFolder)
+{
+    m_configUtil = configUtil;
+    m_serviceManager = serviceManager;
+    m_x11SocketFolder = x11SocketFolder ? x11SocketFolder : X11_SOCKET_FOLDER;
+}
+
+int StartupLauncher::run(int timeoutMs)
+{
+    // check input
+    if (!m_configUtil || !m_serviceManager) {
+        qDebug("missing parameter");
+        return EXIT_FAILURE;
+    }
+    string name = m_configUtil->get_startup();
+    StartupApplication *app = create_startup_application(name.c_str());
+    string command = app->get_startup_command();
+    delete app;
+    m_timer.mark("read config");
+    if (command.empty()) {
+        qDebug("startup launcher: no startup application for \"%s\"", name.c_str());
+        return EXIT_SUCCESS;
+    }
+
+    // one deadline for all the waits, a missing weston does not cost the timeout twice
+    const double deadlineMs = get_monotonic_ms() + timeoutMs;
+    string runtimeFolder = _prepare_runtime_folder();
+    const string waylandSocket = runtimeFolder + "/" + WAYLAND_DISPLAY_NAME;
+    const auto weston = m_serviceManager->find_unit(WESTON_SERVICE_PATTERN);
+    if (!weston.second) {
+        qDebug("startup launcher: no %s, waiting for the display only", WESTON_SERVICE_PATTERN);
+    } else if (!is_path_exist(waylandSocket)) {
+        m_serviceManager->wait_unit_active(weston.first.c_str(), get_remaining_ms(deadlineMs));
+        m_timer.mark(weston.first.c_str());
+    }
+    if (!wait_for_file(runtimeFolder, WAYLAND_DISPLAY_NAME, get_remaining_ms(deadlineMs)))
+        qDebug("startup launcher: no %s after %d ms", waylandSocket.c_str(), timeoutMs);
+    m_timer.mark(WAYLAND_DISPLAY_NAME);
+    // weston creates the xwayland socket right after its own, xwayland is not loaded on every image
+    // so the application is started after a short grace period regardless
+    int graceMs = std::min(STARTUP_LAUNCHER_X11_GRACE_MS, get_remaining_ms(deadlineMs));
+    if (!wait_for_file(m_x11SocketFolder, X11_SOCKET_NAME, graceMs))
+        qDebug("startup launcher: no %s/%s after %d ms", m_x11SocketFolder.c_str(), X11_SOCKET_NAME, graceMs);
+    m_timer.mark("xwayland");
+
+#ifdef _WIN32
+    return EXIT_FAILURE;
+#else
+    // the profile may reset the display variables, they are exported after it
+    char shellCommand[CMD_SIZE] = {0};
+    snprintf(shellCommand, sizeof(shellCommand), ". %s; export DISPLAY=%s WAYLAND_DISPLAY=%s XDG_RUNTIME_DIR=%s; exec %s",
+             PROFILE_FILE, X11_DISPLAY_NAME, WAYLAND_DISPLAY_NAME, runtimeFolder.c_str(), command.c_str());
+    vector<string> displaySockets = {runtimeFolder + "/" + WAYLAND_DISPLAY_NAME, m_x11SocketFolder + "/" + X11_SOCKET_NAME};
+    StartupSupervisor supervisor(shellCommand, make_restart_policy(m_configUtil->get_startup_auto_restart()), displaySockets);
+    m_timer.mark(name.c_str());
+    return supervisor.run();
+#endif
+}
+
+string StartupLauncher::_prepare_runtime_folder()
+{
+    const char *env = getenv("XDG_RUNTIME_DIR");
+    if (env && strlen(env) > 0)
+        return string(env);
+#ifdef _WIN32
+    return string(TMP_FOLDER);
+#else
+    string folder = string(RUNTIME_FOLDER_PREFIX) + std::to_string(getuid());
+    if (!is_folder_exist(folder.c_str()) && mkdir(folder.c_str(), 0700) != 0)
+        qDebug("create %s failed:%s", folder.c_str(), strerror(errno));
+    return folder;
+#endif
+}
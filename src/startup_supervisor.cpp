@@ -0,0 +1,312 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/startup_supervisor.h"
+
+#ifdef _WIN32
+#else
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#endif
+
+#define SHELL_SIGNAL_STATUS_BASE    128
+#define SHELL_EXEC_FAILED_STATUS    127
+// st column of /proc/net/unix
+#define UNIX_SOCKET_CONNECTED       "03"
+#define NET_UNIX_STATE_INDEX        5
+#define NET_UNIX_PATH_INDEX         7
+
+static double get_monotonic_ms()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+RestartPolicy make_restart_policy(bool isAutoRestart)
+{
+    RestartPolicy policy;
+    policy.isAutoRestart = isAutoRestart;
+    policy.initialBackoffMs = SUPERVISOR_BACKOFF_INITIAL_MS;
+    policy.maxBackoffMs = SUPERVISOR_BACKOFF_MAX_MS;
+    policy.stableRunMs = SUPERVISOR_STABLE_RUN_MS;
+    policy.crashLoopCount = SUPERVISOR_CRASH_LOOP_COUNT;
+    policy.crashLoopWindowMs = SUPERVISOR_CRASH_LOOP_WINDOW_MS;
+    return policy;
+}
+
+RestartTracker::RestartTracker(const RestartPolicy &policy)
+{
+    m_policy = policy;
+    m_backoffMs = policy.initialBackoffMs;
+    m_isCrashLoop = false;
+}
+
+int RestartTracker::on_exit(double nowMs, double runMs)
+{
+    if (!m_policy.isAutoRestart || m_isCrashLoop)
+        return -1;
+    if (runMs >= m_policy.stableRunMs)
+        m_backoffMs = m_policy.initialBackoffMs;
+    m_exitTimes.push_back(nowMs);
+    while (!m_exitTimes.empty() && m_exitTimes.front() < nowMs - m_policy.crashLoopWindowMs)
+        m_exitTimes.pop_front();
+    if ((int)m_exitTimes.size() >= m_policy.crashLoopCount) {
+        m_isCrashLoop = true;
+        return -1;
+    }
+    int delay = m_backoffMs;
+    m_backoffMs = std::min(m_backoffMs * 2, m_policy.maxBackoffMs);
+    return delay;
+}
+
+bool RestartTracker::is_crash_loop()
+{
+    return m_isCrashLoop;
+}
+
+string format_launch_record(const LaunchRecord &record)
+{
+    char buff[BUFF_SIZE] = {0};
+    char firstWindow[32] = "-";
+    char memory[32] = "-";
+    char cpu[32] = "-";
+    if (record.firstWindowMs >= 0)
+        snprintf(firstWindow, sizeof(firstWindow), "%.0f ms", record.firstWindowMs);
+    if (record.memoryPeakBytes >= 0)
+        snprintf(memory, sizeof(memory), "%.1f MB", record.memoryPeakBytes / 1048576.0);
+    if (record.cpuUsec >= 0)
+        snprintf(cpu, sizeof(cpu), "%.2f s", record.cpuUsec / 1000000.0);
+    snprintf(buff, sizeof(buff), "attempt %d pid %d first window %s run %.0f ms exit %d memory peak %s cpu %s",
+             record.attempt, record.pid, firstWindow, record.runMs, record.exitStatus, memory, cpu);
+    return string(buff);
+}
+
+StartupSupervisor::StartupSupervisor(const string& command, const RestartPolicy &policy,
+                                     const vector<string>& displaySockets,
+                                     const char* cgroupFolder, const char* netUnixFile)
+{
+    m_command = command;
+    m_policy = policy;
+    m_displaySockets = displaySockets;
+    m_cgroupFolder = cgroupFolder ? cgroupFolder : CGROUP2_FOLDER;
+    m_cgroup = m_cgroupFolder + "/" + STARTUP_CGROUP_NAME;
+    m_netUnixFile = netUnixFile ? netUnixFile : PROC_NET_UNIX_FILE;
+    m_hasCgroup = false;
+}
+
+int StartupSupervisor::run()
+{
+    m_hasCgroup = _prepare_cgroup();
+    RestartTracker tracker(m_policy);
+    int status = 0;
+    for (int attempt = 1; ; attempt++)
+    {
+        // a start script may have left the application running in the background
+        if (m_hasCgroup && _is_cgroup_populated())
+            _kill_cgroup();
+        LaunchRecord record = _launch(attempt);
+        m_records.push_back(record);
+        qDebug("startup launch: %s", format_launch_record(record).c_str());
+        status = record.exitStatus;
+        int delay = tracker.on_exit(get_monotonic_ms(), record.runMs);
+        if (delay < 0) {
+            if (tracker.is_crash_loop())
+                qDebug("startup crash loop: %d exits within %d ms, not restarting",
+                       m_policy.crashLoopCount, m_policy.crashLoopWindowMs);
+            break;
+        }
+        qDebug("startup restart in %d ms", delay);
+        usleep((useconds_t)delay * 1000);
+    }
+    return status;
+}
+
+vector<LaunchRecord> StartupSupervisor::get_records()
+{
+    return m_records;
+}
+
+LaunchRecord StartupSupervisor::_launch(int attempt)
+{
+    LaunchRecord record = {attempt, -1, -1, 0, SHELL_EXEC_FAILED_STATUS, -1, -1};
+#ifdef _WIN32
+    return record;
+#else
+    const int baseConnections = _count_display_connections();
+    const long long baseCpuUsec = m_hasCgroup ? _read_cgroup_value("cpu.stat", "usage_usec") : -1;
+    // opened here, the child only writes to it
+    int procsFd = m_hasCgroup ? open((m_cgroup + "/cgroup.procs").c_str(), O_WRONLY | O_CLOEXEC) : -1;
+    const double startMs = get_monotonic_ms();
+    pid_t pid = fork();
+    if (pid == 0) {
+        // into the cgroup before exec, nothing of the application runs outside it
+        if (procsFd >= 0 && write(procsFd, "0", 1) < 0)
+            _exit(SHELL_EXEC_FAILED_STATUS);
+        execl(STARTUP_SHELL, STARTUP_SHELL, "-c", m_command.c_str(), (char *)nullptr);
+        _exit(SHELL_EXEC_FAILED_STATUS);
+    }
+    if (procsFd >= 0)
+        close(procsFd);
+    if (pid < 0) {
+        qDebug("fork failed:%s", strerror(errno));
+        return record;
+    }
+    record.pid = pid;
+    // without pidfd the exit is noticed on the next poll interval
+    int pidFd = (int)syscall(SYS_pidfd_open, pid, 0);
+    int eventsFd = m_hasCgroup ? open((m_cgroup + "/cgroup.events").c_str(), O_RDONLY | O_CLOEXEC) : -1;
+    bool isMainExited = false;
+    bool isFirstWindowPending = (baseConnections >= 0);
+    while (true)
+    {
+        int timeout = (isFirstWindowPending || pidFd < 0) ? SUPERVISOR_FIRST_WINDOW_INTERVAL_MS : SUPERVISOR_SAMPLE_INTERVAL_MS;
+        struct pollfd fds[1];
+        int count = 0;
+        if (!isMainExited && pidFd >= 0)
+            fds[count++] = {pidFd, POLLIN, 0};
+        else if (isMainExited && eventsFd >= 0)
+            fds[count++] = {eventsFd, POLLPRI, 0};
+        poll(fds, count, timeout);
+        const double elapsedMs = get_monotonic_ms() - startMs;
+
+        int status = 0;
+        if (!isMainExited && waitpid(pid, &status, WNOHANG) == pid) {
+            isMainExited = true;
+            record.exitStatus = WIFSIGNALED(status) ? SHELL_SIGNAL_STATUS_BASE + WTERMSIG(status) : WEXITSTATUS(status);
+        }
+        if (isFirstWindowPending) {
+            if (_count_display_connections() > baseConnections) {
+                record.firstWindowMs = elapsedMs;
+                isFirstWindowPending = false;
+            } else if (elapsedMs >= SUPERVISOR_FIRST_WINDOW_TIMEOUT_MS) {
+                isFirstWindowPending = false;
+            }
+        }
+        if (m_hasCgroup)
+            record.memoryPeakBytes = std::max(record.memoryPeakBytes, _read_cgroup_value("memory.current", nullptr));
+        // the shell is done, what it started in the background is still the application
+        if (isMainExited && (!m_hasCgroup || !_is_cgroup_populated()))
+            break;
+    }
+    record.runMs = get_monotonic_ms() - startMs;
+    if (m_hasCgroup && baseCpuUsec >= 0)
+        record.cpuUsec = _read_cgroup_value("cpu.stat", "usage_usec") - baseCpuUsec;
+    if (pidFd >= 0)
+        close(pidFd);
+    if (eventsFd >= 0)
+        close(eventsFd);
+    return record;
+#endif
+}
+
+bool StartupSupervisor::_prepare_cgroup()
+{
+#ifdef _WIN32
+    return false;
+#else
+    if (!is_file_exist((m_cgroupFolder + "/cgroup.controllers").c_str())) {
+        qDebug("no cgroup v2 at %s, running without accounting", m_cgroupFolder.c_str());
+        return false;
+    }
+    if (mkdir(m_cgroup.c_str(), 0755) != 0 && errno != EEXIST) {
+        qDebug("create %s failed:%s", m_cgroup.c_str(), strerror(errno));
+        return false;
+    }
+    return true;
+#endif
+}
+
+void StartupSupervisor::_kill_cgroup()
+{
+#ifdef _WIN32
+#else
+    // cgroup.kill needs 5.14, older kernels get each process killed
+    int fd = open((m_cgroup + "/cgroup.kill").c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        bool result = (write(fd, "1", 1) == 1);
+        close(fd);
+        if (result)
+            return;
+    }
+    ifstream file(m_cgroup + "/cgroup.procs");
+    pid_t pid = 0;
+    while (file >> pid)
+        kill(pid, SIGKILL);
+#endif
+}
+
+bool StartupSupervisor::_is_cgroup_populated()
+{
+    return _read_cgroup_value("cgroup.events", "populated") > 0;
+}
+
+long long StartupSupervisor::_read_cgroup_value(const char* file, const char* key)
+{
+    ifstream stream(m_cgroup + "/" + file);
+    if (!stream.good())
+        return -1;
+    // a single value, or "key value" lines
+    string name;
+    long long value = 0;
+    if (!key)
+        return (stream >> value) ? value : -1;
+    while (stream >> name >> value)
+    {
+        if (name.compare(key) == 0)
+            return value;
+    }
+    return -1;
+}
+
+int StartupSupervisor::_count_display_connections()
+{
+    if (m_displaySockets.empty())
+        return -1;
+    ifstream file(m_netUnixFile);
+    if (!file.good())
+        return -1;
+    int count = 0;
+    string line;
+    // header line
+    getline(file, line);
+    while (getline(file, line))
+    {
+        istringstream stream(line);
+        vector<string> fields;
+        string field;
+        while (stream >> field)
+            fields.push_back(field);
+        if ((int)fields.size() <= NET_UNIX_PATH_INDEX || fields[NET_UNIX_STATE_INDEX].compare(UNIX_SOCKET_CONNECTED) != 0)
+            continue;
+        // accepted sockets carry the path of the listener, xwayland also listens on the abstract name
+        string path = fields[NET_UNIX_PATH_INDEX];
+        if (!path.empty() && path[0] == '@')
+            path = path.substr(1);
+        if (std::find(m_displaySockets.begin(), m_displaySockets.end(), path) != m_displaySockets.end())
+            count++;
+    }
+    return count;
+}
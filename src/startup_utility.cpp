@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <array>
 
@@ -80,3 +81,22 @@ StartupNone::StartupNone() {
 
 StartupNone::~StartupNone() {
 }
+
+StartupApplication* create_startup_application(const char* name) {
+    // check input
+    if (!name)
+        return new StartupNone();
+    if (strcmp(name, STARTUP_NAME_SETTINGS) == 0)
+        return new StartupSettings();
+    else if (strcmp(name, STARTUP_NAME_CHROMIUM) == 0)
+        return new StartupChromium();
+    else if (strcmp(name, STARTUP_NAME_CHROMIUM_KIOSK) == 0)
+        return new StartupKioskChromium();
+    else if (strcmp(name, STARTUP_NAME_STATIC_PAGE) == 0)
+        return new StartupStaticPage();
+    else if (strcmp(name, STARTUP_NAME_STATIC_PAGE_CUSTOM) == 0)
+        return new StartupStaticPageCustom();
+    else if (strcmp(name, STARTUP_NAME_VNC_VIEWER) == 0)
+        return new StartupVNC();
+    return new StartupNone();
+}
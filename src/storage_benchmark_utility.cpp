@@ -0,0 +1,527 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
+#include <linux/aio_abi.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/storage_benchmark_utility.h"
+
+// fixed seed, every run touches the same random offsets
+#define BENCHMARK_RANDOM_SEED 20220101
+
+static double elapsed_us(const std::chrono::steady_clock::time_point &start)
+{
+    auto diff = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(diff).count();
+}
+
+#ifdef _WIN32
+#else
+// kernel native aio through raw syscalls, no libaio dependency
+static int sys_io_setup(unsigned nr, aio_context_t *ctx)
+{
+    return syscall(__NR_io_setup, nr, ctx);
+}
+
+static int sys_io_destroy(aio_context_t ctx)
+{
+    return syscall(__NR_io_destroy, ctx);
+}
+
+static int sys_io_submit(aio_context_t ctx, long nr, struct iocb **iocbpp)
+{
+    return syscall(__NR_io_submit, ctx, nr, iocbpp);
+}
+
+static int sys_io_getevents(aio_context_t ctx, long min_nr, long max_nr, struct io_event *events)
+{
+    return syscall(__NR_io_getevents, ctx, min_nr, max_nr, events, nullptr);
+}
+#endif
+
+BenchmarkResult::BenchmarkResult()
+{
+    m_type = BenchmarkType::SEQ_WRITE;
+    m_block_size = 0;
+    m_queue_depth = 0;
+    m_direct = false;
+    m_seconds = 0;
+}
+
+void BenchmarkResult::setType(BenchmarkType type)
+{
+    m_type = type;
+}
+
+void BenchmarkResult::setBlockSize(int blockSize)
+{
+    m_block_size = blockSize;
+}
+
+void BenchmarkResult::setQueueDepth(int queueDepth)
+{
+    m_queue_depth = queueDepth;
+}
+
+void BenchmarkResult::setEngine(const string& engine)
+{
+    m_engine = engine;
+}
+
+void BenchmarkResult::setDirect(bool isDirect)
+{
+    m_direct = isDirect;
+}
+
+void BenchmarkResult::setSeconds(double seconds)
+{
+    m_seconds = seconds;
+}
+
+void BenchmarkResult::setLatencies(vector<double> &latencies)
+{
+    m_latencies = latencies;
+    std::sort(m_latencies.begin(), m_latencies.end());
+}
+
+BenchmarkType BenchmarkResult::getType()
+{
+    return m_type;
+}
+
+string BenchmarkResult::getName()
+{
+    switch (m_type) {
+    case BenchmarkType::SEQ_WRITE:
+        return "seq_write";
+    case BenchmarkType::SEQ_READ:
+        return "seq_read";
+    case BenchmarkType::RANDOM_WRITE:
+        return "rand_write";
+    case BenchmarkType::RANDOM_READ:
+        return "rand_read";
+    }
+    return "";
+}
+
+int BenchmarkResult::getBlockSize()
+{
+    return m_block_size;
+}
+
+int BenchmarkResult::getQueueDepth()
+{
+    return m_queue_depth;
+}
+
+string BenchmarkResult::getEngine()
+{
+    return m_engine;
+}
+
+bool BenchmarkResult::getDirect()
+{
+    return m_direct;
+}
+
+int BenchmarkResult::getOps()
+{
+    return (int)m_latencies.size();
+}
+
+unsigned long long BenchmarkResult::getBytes()
+{
+    return (unsigned long long)m_block_size * m_latencies.size();
+}
+
+double BenchmarkResult::getSeconds()
+{
+    return m_seconds;
+}
+
+// MB/s
+double BenchmarkResult::getThroughput()
+{
+    if (m_seconds <= 0)
+        return 0;
+    return getBytes() / m_seconds / (1024 * 1024);
+}
+
+double BenchmarkResult::getIOPS()
+{
+    if (m_seconds <= 0)
+        return 0;
+    return m_latencies.size() / m_seconds;
+}
+
+// nearest-rank percentile, ex: 99.9
+double BenchmarkResult::getLatencyPercentile(double percentile)
+{
+    if (m_latencies.empty())
+        return 0;
+    size_t rank = (size_t)ceil(percentile / 100.0 * m_latencies.size());
+    if (rank < 1)
+        rank = 1;
+    if (rank > m_latencies.size())
+        rank = m_latencies.size();
+    return m_latencies[rank - 1];
+}
+
+double BenchmarkResult::getLatencyMax()
+{
+    if (m_latencies.empty())
+        return 0;
+    return m_latencies.back();
+}
+
+string BenchmarkResult::toString()
+{
+    char buff[BUFF_SIZE] = {0};
+    snprintf(buff, BUFF_SIZE,
+        "%-10s bs=%dK qd=%d %.2fMB/s %.0fIOPS lat(us) p50=%.0f p99=%.0f p99.9=%.0f max=%.0f\n",
+        getName().c_str(), m_block_size / 1024, m_queue_depth, getThroughput(), getIOPS(),
+        getLatencyPercentile(50), getLatencyPercentile(99), getLatencyPercentile(99.9), getLatencyMax());
+    return buff;
+}
+
+string BenchmarkResult::toJson()
+{
+    char buff[BUFF_SIZE] = {0};
+    snprintf(buff, BUFF_SIZE,
+        "{\"test\": \"%s\", \"block_size\": %d, \"queue_depth\": %d, \"engine\": \"%s\", "
+        "\"direct\": %s, \"ops\": %d, \"bytes\": %llu, \"seconds\": %.6f, "
+        "\"throughput_mb_s\": %.3f, \"iops\": %.1f, "
+        "\"latency_us\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"p99.9\": %.1f, \"max\": %.1f}}",
+        getName().c_str(), m_block_size, m_queue_depth, m_engine.c_str(),
+        bool_cast(m_direct), getOps(), getBytes(), m_seconds,
+        getThroughput(), getIOPS(),
+        getLatencyPercentile(50), getLatencyPercentile(90), getLatencyPercentile(99),
+        getLatencyPercentile(99.9), getLatencyMax());
+    return buff;
+}
+
+pair<vector<BenchmarkResult>, bool> TPCStorageBenchmarkUtility::run_benchmark(const char* folder, int fileSizeMB, int queueDepth,
+                                                                              CancelCheckFunc isCancelled)
+{
+    vector<BenchmarkResult> results;
+    // check input
+    if (!folder || strlen(folder) == 0) {
+        qDebug("missing parameter");
+        return make_pair(results, false);
+    }
+    if (fileSizeMB <= 0)
+        fileSizeMB = BENCHMARK_DEFAULT_FILE_SIZE_MB;
+    fileSizeMB = std::min(fileSizeMB, BENCHMARK_MAX_FILE_SIZE_MB);
+    if (queueDepth <= 0)
+        queueDepth = BENCHMARK_DEFAULT_QUEUE_DEPTH;
+    queueDepth = std::min(queueDepth, BENCHMARK_MAX_QUEUE_DEPTH);
+    unsigned long long fileSize = (unsigned long long)fileSizeMB * 1024 * 1024;
+#ifdef _WIN32
+    return make_pair(results, false);
+#else
+    // keep the partition from filling up
+    struct statvfs fsStat;
+    if (statvfs(folder, &fsStat) != 0) {
+        qDebug("statvfs %s failed: %s", folder, strerror(errno));
+        return make_pair(results, false);
+    }
+    if ((unsigned long long)fsStat.f_bavail * fsStat.f_frsize < fileSize * 2) {
+        qDebug("not enough space in %s", folder);
+        return make_pair(results, false);
+    }
+    bool isDirect = false;
+    int fd = _open_temp_file(folder, &isDirect);
+    if (fd < 0)
+        return make_pair(results, false);
+
+    // write first, read tests need the file content
+    BenchmarkType types[] = {BenchmarkType::SEQ_WRITE, BenchmarkType::SEQ_READ,
+                             BenchmarkType::RANDOM_WRITE, BenchmarkType::RANDOM_READ};
+    bool isSuccess = true;
+    for (BenchmarkType type : types)
+    {
+        auto ret = _run_test(fd, type, fileSize, queueDepth, isDirect, isCancelled);
+        if (!ret.second) {
+            isSuccess = false;
+            break;
+        }
+        results.push_back(ret.first);
+    }
+    close(fd);
+    return make_pair(results, isSuccess);
+#endif
+}
+
+bool TPCStorageBenchmarkUtility::export_json(vector<BenchmarkResult> &results, const char* device, const char* filePath)
+{
+    // check input
+    if (!device || !filePath) {
+        qDebug("missing parameter");
+        return false;
+    }
+    char buff[BUFF_SIZE] = {0};
+    char timeBuff[64] = {0};
+    time_t now = time(nullptr);
+    strftime(timeBuff, sizeof(timeBuff), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+    snprintf(buff, BUFF_SIZE, "{\n  \"device\": \"%s\",\n  \"time\": \"%s\",\n  \"results\": [\n", device, timeBuff);
+    string json = buff;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        json.append("    ");
+        json.append(results[i].toJson());
+        json.append(i + 1 < results.size() ? ",\n" : "\n");
+    }
+    json.append("  ]\n}\n");
+    return write_file(filePath, json.c_str());
+}
+
+int TPCStorageBenchmarkUtility::_open_temp_file(const char* folder, bool *isDirect)
+{
+#ifdef _WIN32
+    return -1;
+#else
+    char path[BUFF_SIZE] = {0};
+    snprintf(path, BUFF_SIZE, "%s/%s%d", folder, BENCHMARK_FILE_PREFIX, getpid());
+    *isDirect = true;
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0600);
+    if (fd < 0 && errno == EINVAL) {
+        // tmpfs and some fuse file systems reject O_DIRECT, fallback to page cache
+        qDebug("%s not support O_DIRECT, using buffered io", folder);
+        *isDirect = false;
+        fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    }
+    if (fd < 0) {
+        qDebug("open %s failed: %s", path, strerror(errno));
+        return -1;
+    }
+    // unlink right away, blocks are released on close even if we crash
+    unlink(path);
+    return fd;
+#endif
+}
+
+vector<unsigned long long> TPCStorageBenchmarkUtility::_make_offsets(BenchmarkType type, unsigned long long fileSize)
+{
+    vector<unsigned long long> offsets;
+    if (type == BenchmarkType::SEQ_WRITE || type == BenchmarkType::SEQ_READ)
+    {
+        for (unsigned long long offset = 0; offset + BENCHMARK_SEQ_BLOCK_SIZE <= fileSize;
+             offset += BENCHMARK_SEQ_BLOCK_SIZE)
+        {
+            offsets.push_back(offset);
+        }
+        return offsets;
+    }
+    std::mt19937_64 generator(BENCHMARK_RANDOM_SEED);
+    std::uniform_int_distribution<unsigned long long> distribution(0, fileSize / BENCHMARK_RANDOM_BLOCK_SIZE - 1);
+    for (int i = 0; i < BENCHMARK_RANDOM_MAX_OPS; i++)
+    {
+        offsets.push_back(distribution(generator) * BENCHMARK_RANDOM_BLOCK_SIZE);
+    }
+    return offsets;
+}
+
+pair<BenchmarkResult, bool> TPCStorageBenchmarkUtility::_run_test(int fd, BenchmarkType type, unsigned long long fileSize,
+                                                                  int queueDepth, bool isDirect,
+                                                                  const CancelCheckFunc &isCancelled)
+{
+    BenchmarkResult result;
+#ifdef _WIN32
+    return make_pair(result, false);
+#else
+    bool isWrite = (type == BenchmarkType::SEQ_WRITE || type == BenchmarkType::RANDOM_WRITE);
+    bool isRandom = (type == BenchmarkType::RANDOM_WRITE || type == BenchmarkType::RANDOM_READ);
+    int blockSize = isRandom ? BENCHMARK_RANDOM_BLOCK_SIZE : BENCHMARK_SEQ_BLOCK_SIZE;
+    int maxSeconds = isRandom ? BENCHMARK_RANDOM_MAX_SECONDS : 0;
+    vector<unsigned long long> offsets = _make_offsets(type, fileSize);
+
+    // one aligned buffer per in-flight request
+    char *buffers = nullptr;
+    if (posix_memalign((void **)&buffers, BENCHMARK_ALIGNMENT, (size_t)blockSize * queueDepth) != 0) {
+        qDebug("allocate benchmark buffer failed");
+        return make_pair(result, false);
+    }
+    // random content, some cards compress or skip zero blocks
+    std::mt19937 generator(BENCHMARK_RANDOM_SEED);
+    for (size_t i = 0; i < (size_t)blockSize * queueDepth; i++)
+    {
+        buffers[i] = (char)generator();
+    }
+    if (!isWrite && !isDirect) {
+        // drop cached pages so reads hit the device
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+
+    vector<double> latencies;
+    string engine = BENCHMARK_ENGINE_AIO;
+    auto start = std::chrono::steady_clock::now();
+    // kernel aio is only asynchronous with O_DIRECT, queue depth 1 needs no queue
+    bool isSuccess = false;
+    if (isDirect && queueDepth > 1)
+        isSuccess = _run_aio(fd, isWrite, blockSize, queueDepth, offsets, buffers, maxSeconds, latencies, isCancelled);
+    if (!isSuccess && latencies.empty() && !(isCancelled && isCancelled()))
+    {
+        engine = BENCHMARK_ENGINE_SYNC;
+        queueDepth = 1;
+        start = std::chrono::steady_clock::now();
+        isSuccess = _run_sync(fd, isWrite, blockSize, offsets, buffers, maxSeconds, latencies, isCancelled);
+    }
+    // written data counts only after it reached the device
+    if (isSuccess && isWrite && fdatasync(fd) != 0) {
+        qDebug("fdatasync failed: %s", strerror(errno));
+        isSuccess = false;
+    }
+    double seconds = elapsed_us(start) / 1000000;
+    free(buffers);
+
+    result.setType(type);
+    result.setBlockSize(blockSize);
+    result.setQueueDepth(queueDepth);
+    result.setEngine(engine);
+    result.setDirect(isDirect);
+    result.setSeconds(seconds);
+    result.setLatencies(latencies);
+    return make_pair(result, isSuccess);
+#endif
+}
+
+bool TPCStorageBenchmarkUtility::_run_sync(int fd, bool isWrite, int blockSize, vector<unsigned long long> &offsets,
+                                           char *buffer, int maxSeconds, vector<double> &latencies,
+                                           const CancelCheckFunc &isCancelled)
+{
+#ifdef _WIN32
+    return false;
+#else
+    auto begin = std::chrono::steady_clock::now();
+    for (unsigned long long offset : offsets)
+    {
+        if (maxSeconds > 0 && elapsed_us(begin) > maxSeconds * 1000000.0)
+            break;
+        if (isCancelled && isCancelled()) {
+            qDebug("storage benchmark cancelled");
+            return false;
+        }
+        auto start = std::chrono::steady_clock::now();
+        ssize_t len = isWrite ? pwrite(fd, buffer, blockSize, offset) : pread(fd, buffer, blockSize, offset);
+        if (len != blockSize) {
+            qDebug("%s at %llu failed: %s", isWrite ? "pwrite" : "pread", offset, strerror(errno));
+            return false;
+        }
+        latencies.push_back(elapsed_us(start));
+    }
+    return true;
+#endif
+}
+
+bool TPCStorageBenchmarkUtility::_run_aio(int fd, bool isWrite, int blockSize, int queueDepth, vector<unsigned long long> &offsets,
+                                          char *buffers, int maxSeconds, vector<double> &latencies,
+                                          const CancelCheckFunc &isCancelled)
+{
+#ifdef _WIN32
+    return false;
+#else
+    aio_context_t ctx = 0;
+    if (sys_io_setup(queueDepth, &ctx) != 0) {
+        qDebug("io_setup failed: %s, using %s", strerror(errno), BENCHMARK_ENGINE_SYNC);
+        return false;
+    }
+    vector<struct iocb> iocbs(queueDepth);
+    vector<struct iocb *> pending;
+    vector<struct io_event> events(queueDepth);
+    vector<std::chrono::steady_clock::time_point> startTimes(queueDepth);
+    vector<int> freeSlots;
+    for (int i = queueDepth - 1; i >= 0; i--)
+    {
+        freeSlots.push_back(i);
+    }
+    size_t submitted = 0;
+    size_t completed = 0;
+    bool isSuccess = true;
+    auto begin = std::chrono::steady_clock::now();
+    while (true)
+    {
+        // stop submitting on timeout or cancel, but reap what is in flight
+        bool isTimeout = (maxSeconds > 0 && elapsed_us(begin) > maxSeconds * 1000000.0);
+        if (isSuccess && isCancelled && isCancelled()) {
+            qDebug("storage benchmark cancelled");
+            isSuccess = false;
+        }
+        pending.clear();
+        while (isSuccess && !isTimeout && !freeSlots.empty() && submitted + pending.size() < offsets.size())
+        {
+            int slot = freeSlots.back();
+            freeSlots.pop_back();
+            struct iocb *cb = &iocbs[slot];
+            memset(cb, 0, sizeof(struct iocb));
+            cb->aio_fildes = fd;
+            cb->aio_lio_opcode = isWrite ? IOCB_CMD_PWRITE : IOCB_CMD_PREAD;
+            cb->aio_buf = (unsigned long long)(buffers + (size_t)slot * blockSize);
+            cb->aio_nbytes = blockSize;
+            cb->aio_offset = offsets[submitted + pending.size()];
+            cb->aio_data = slot;
+            startTimes[slot] = std::chrono::steady_clock::now();
+            pending.push_back(cb);
+        }
+        if (!pending.empty()) {
+            int ret = sys_io_submit(ctx, pending.size(), pending.data());
+            if (ret < 0) {
+                qDebug("io_submit failed: %s", strerror(errno));
+                ret = 0;
+                isSuccess = false;
+            } else if (ret == 0) {
+                // nothing accepted, the remaining offsets would never be tested
+                qDebug("io_submit accepted no request");
+                isSuccess = false;
+            }
+            // return slots which are not accepted
+            for (size_t i = ret; i < pending.size(); i++)
+            {
+                freeSlots.push_back((int)pending[i]->aio_data);
+            }
+            submitted += ret;
+        }
+        if (completed == submitted)
+            break;
+        int count = sys_io_getevents(ctx, 1, queueDepth, events.data());
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            qDebug("io_getevents failed: %s", strerror(errno));
+            isSuccess = false;
+            break;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            int slot = (int)events[i].data;
+            if (events[i].res != blockSize) {
+                qDebug("aio %s failed: %lld", isWrite ? "write" : "read", (long long)events[i].res);
+                isSuccess = false;
+            } else {
+                latencies.push_back(elapsed_us(startTimes[slot]));
+            }
+            freeSlots.push_back(slot);
+            completed++;
+        }
+    }
+    sys_io_destroy(ctx);
+    return isSuccess;
+#endif
+}
@@ -0,0 +1,245 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <chrono>
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/storage_utility.h"
+#include "./include/storage_telemetry.h"
+
+StorageTelemetrySample::StorageTelemetrySample()
+{
+    m_time = 0;
+    m_read_iops = 0;
+    m_write_iops = 0;
+    m_read_bytes = 0;
+    m_write_bytes = 0;
+    m_utilization = 0;
+}
+
+void StorageTelemetrySample::setTime(double time)
+{
+    m_time = time;
+}
+
+void StorageTelemetrySample::setReadIOPS(double readIOPS)
+{
+    m_read_iops = readIOPS;
+}
+
+void StorageTelemetrySample::setWriteIOPS(double writeIOPS)
+{
+    m_write_iops = writeIOPS;
+}
+
+void StorageTelemetrySample::setReadBytesPerSecond(double readBytes)
+{
+    m_read_bytes = readBytes;
+}
+
+void StorageTelemetrySample::setWriteBytesPerSecond(double writeBytes)
+{
+    m_write_bytes = writeBytes;
+}
+
+void StorageTelemetrySample::setUtilization(double utilization)
+{
+    m_utilization = utilization;
+}
+
+double StorageTelemetrySample::getTime()
+{
+    return m_time;
+}
+
+double StorageTelemetrySample::getReadIOPS()
+{
+    return m_read_iops;
+}
+
+double StorageTelemetrySample::getWriteIOPS()
+{
+    return m_write_iops;
+}
+
+double StorageTelemetrySample::getReadBytesPerSecond()
+{
+    return m_read_bytes;
+}
+
+double StorageTelemetrySample::getWriteBytesPerSecond()
+{
+    return m_write_bytes;
+}
+
+double StorageTelemetrySample::getUtilization()
+{
+    return m_utilization;
+}
+
+string StorageTelemetrySample::toString()
+{
+    char buff[BUFF_SIZE] = {0};
+    snprintf(buff, BUFF_SIZE, "Read: %.0f IOPS %s/s\nWrite: %.0f IOPS %s/s\nUtilization: %.1f%%",
+        m_read_iops, format_size((unsigned long long)m_read_bytes).c_str(),
+        m_write_iops, format_size((unsigned long long)m_write_bytes).c_str(), m_utilization);
+    return buff;
+}
+
+StorageTelemetryRing::StorageTelemetryRing(size_t capacity)
+    : m_samples(capacity > 0 ? capacity : 1)
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+void StorageTelemetryRing::push(const StorageTelemetrySample &sample)
+{
+    m_samples[m_head] = sample;
+    m_head = (m_head + 1) % m_samples.size();
+    if (m_size < m_samples.size())
+        m_size++;
+}
+
+void StorageTelemetryRing::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+size_t StorageTelemetryRing::size()
+{
+    return m_size;
+}
+
+size_t StorageTelemetryRing::capacity()
+{
+    return m_samples.size();
+}
+
+StorageTelemetrySample StorageTelemetryRing::at(size_t index)
+{
+    if (index >= m_size)
+        return StorageTelemetrySample();
+    size_t oldest = (m_head + m_samples.size() - m_size) % m_samples.size();
+    return m_samples[(oldest + index) % m_samples.size()];
+}
+
+StorageTelemetrySample StorageTelemetryRing::latest()
+{
+    if (m_size == 0)
+        return StorageTelemetrySample();
+    return at(m_size - 1);
+}
+
+StorageTelemetrySampler::StorageTelemetrySampler(IStorageUtility *storageUtil, size_t capacity)
+{
+    m_storageUtil = storageUtil;
+    m_capacity = capacity;
+    m_sampleCount = 0;
+}
+
+void StorageTelemetrySampler::add_device(const char* device_name)
+{
+    // check input
+    if (!device_name) {
+        qDebug("missing parameter");
+        return;
+    }
+    if (m_rings.find(device_name) != m_rings.end())
+        return;
+    m_devices.push_back(device_name);
+    m_rings.emplace(device_name, StorageTelemetryRing(m_capacity));
+}
+
+void StorageTelemetrySampler::sample()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    sample(std::chrono::duration<double>(now).count());
+}
+
+void StorageTelemetrySampler::sample(double now)
+{
+    bool isHealthSample = (m_sampleCount % STORAGE_HEALTH_SAMPLE_INTERVAL == 0);
+    m_sampleCount++;
+    for (auto &device : m_devices)
+    {
+        _sample_device(device, now);
+        if (!isHealthSample)
+            continue;
+        auto retHealth = m_storageUtil->get_emmc_health(device.c_str());
+        if (retHealth.second && retHealth.first.isWarning()) {
+            qDebug("%s is wearing out, %s", device.c_str(), retHealth.first.toString().c_str());
+        }
+        m_healths[device] = retHealth;
+    }
+}
+
+pair<StorageTelemetryRing, bool> StorageTelemetrySampler::get_samples(const char* device_name)
+{
+    // check input
+    if (!device_name) {
+        qDebug("missing parameter");
+        return make_pair(StorageTelemetryRing(m_capacity), false);
+    }
+    auto itr = m_rings.find(device_name);
+    if (itr == m_rings.end())
+        return make_pair(StorageTelemetryRing(m_capacity), false);
+    return make_pair(itr->second, true);
+}
+
+pair<EMMCHealthData, bool> StorageTelemetrySampler::get_health(const char* device_name)
+{
+    // check input
+    if (!device_name) {
+        qDebug("missing parameter");
+        return make_pair(EMMCHealthData(), false);
+    }
+    auto itr = m_healths.find(device_name);
+    if (itr == m_healths.end())
+        return make_pair(EMMCHealthData(), false);
+    return itr->second;
+}
+
+void StorageTelemetrySampler::_sample_device(const string& device, double now)
+{
+    auto retStat = m_storageUtil->get_device_stat(device.c_str());
+    auto itrStat = m_lastStats.find(device);
+    if (!retStat.second) {
+        // card removed, start over on next insertion
+        if (itrStat != m_lastStats.end()) {
+            m_lastStats.erase(itrStat);
+            m_rings.at(device).clear();
+        }
+        return;
+    }
+    BlockDeviceStat current = retStat.first;
+    if (itrStat == m_lastStats.end()) {
+        // first sample is only the base for rates
+        m_lastStats[device] = current;
+        m_lastTimes[device] = now;
+        return;
+    }
+    BlockDeviceStat last = itrStat->second;
+    double seconds = now - m_lastTimes[device];
+    m_lastStats[device] = current;
+    m_lastTimes[device] = now;
+    if (seconds <= 0)
+        return;
+    // counters went back when the device was re-created between samples
+    if (current.getReadIOs() < last.getReadIOs() || current.getWriteIOs() < last.getWriteIOs() ||
+        current.getIOTicks() < last.getIOTicks())
+        return;
+
+    StorageTelemetrySample sample;
+    sample.setTime(now);
+    sample.setReadIOPS((current.getReadIOs() - last.getReadIOs()) / seconds);
+    sample.setWriteIOPS((current.getWriteIOs() - last.getWriteIOs()) / seconds);
+    sample.setReadBytesPerSecond((current.getReadSectors() - last.getReadSectors()) * SECTOR_SIZE / seconds);
+    sample.setWriteBytesPerSecond((current.getWriteSectors() - last.getWriteSectors()) * SECTOR_SIZE / seconds);
+    double utilization = (current.getIOTicks() - last.getIOTicks()) / (seconds * 1000) * 100;
+    sample.setUtilization(utilization > 100 ? 100 : utilization);
+    m_rings.at(device).push(sample);
+}
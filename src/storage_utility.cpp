@@ -3,103 +3,102 @@
 
 #include <cstdio>
 #include <cstring>
-#include <array>
-#include <sstream>
+#include <cerrno>
+#include <algorithm>
 #include <fstream>
+#include <sstream>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#endif
 #include <QDebug>
 
 #include "./include/utility.h"
 #include "./include/storage_utility.h"
 
-#define STORAGE_TYPE_DISK    "disk"
-#define STORAGE_TYPE_PART    "part"
-
-#define STORAGE_NAME_SD_CARD "mmcblk1"
-#define STORAGE_NAME_EMMC    "mmcblk2"
-#define STORAGE_SD_CARD      "/dev/mmcblk1"
-#define STORAGE_EMMC         "/dev/mmcblk2"
+#define DISK_BY_LABEL        "by-label"
+#define DISK_BY_UUID         "by-uuid"
 
-#define ROOT_MOUNT_POINT     "/"
-#define ROOT_FILE_SYSTEM     "/dev/root"
-
-// ex: lsblk
+// sysfs layout for a disk and its partitions
 /*
-NAME         MAJ:MIN RM  SIZE RO TYPE MOUNTPOINT
-mtdblock0     31:0    0    8M  0 disk
-mmcblk2      179:0    0 14.7G  0 disk
-|-mmcblk2p1  179:1    0  580M  0 part /run/media/mmcblk2p1
-|-mmcblk2p2  179:2    0  400M  0 part /run/media/mmcblk2p2
-|-mmcblk2p3  179:3    0    8G  0 part /
-`-mmcblk2p4  179:4    0  5.7G  0 part /userdata
-mmcblk2boot0 179:32   0    4M  1 disk
-mmcblk2boot1 179:64   0    4M  1 disk
+/sys/block/mmcblk2/dev          179:0
+/sys/block/mmcblk2/size         30777344 (512 bytes sectors)
+/sys/block/mmcblk2/ro           0
+/sys/block/mmcblk2/mmcblk2p1/dev    179:1
+/sys/block/mmcblk2/mmcblk2p1/start  16384
+/sys/block/mmcblk2/mmcblk2p1/size   1187840
+/sys/block/mmcblk2/mmcblk2p1/ro     0
 */
-const char* GET_DISK_SIZE_CMD =            "lsblk /dev/%s | grep disk | awk -F ' ' '{print $4}' | tr -d '\\n'";
-
-// NR variable contains the line number of the file when awk command parses the file
-// NR > 2 is skip two first lines
-// ex: lsblk -p /dev/mmcblk2
+const char* SYSFS_DEV =       "dev";
+const char* SYSFS_SIZE =      "size";
+const char* SYSFS_START =     "start";
+const char* SYSFS_RO =        "ro";
+const char* SYSFS_PARTITION = "partition";
+
+// ex: /sys/block/mmcblk2/stat
+// read I/Os, read merges, read sectors, read ticks, write I/Os, write merges, write sectors, write ticks,
+// in flight, io ticks, time in queue, (discard and flush fields on newer kernels)
 /*
-NAME             MAJ:MIN RM  SIZE RO TYPE MOUNTPOINT
-/dev/mmcblk2     179:0    0 14.7G  0 disk
-|-/dev/mmcblk2p1 179:1    0  580M  0 part /run/media/mmcblk2p1
-|-/dev/mmcblk2p2 179:2    0  400M  0 part /run/media/mmcblk2p2
-|-/dev/mmcblk2p3 179:3    0    8G  0 part /
-`-/dev/mmcblk2p4 179:4    0  5.7G  0 part /userdata
+   23415     4411  1719994    10562    18021    14744   739130    45297        0    32460    56834
 */
-const char* GET_PARTITION_BLOCK_CMD =      "lsblk -p /dev/%s > /tmp/.%s_blk";
-const char* GET_DISK_PARTIONS_CMD =        "cat /tmp/.%s_blk | awk 'NR>2 {print $1}' | awk -F '-' '{print $2}'";
-const char* GET_PARTITION_SIZE_CMD =       "cat /tmp/.%s_blk | grep %s | awk -F ' ' '{print $4}' | tr -d '\\n'";
-
-// ex: lsblk -fp /dev/mmcblk2
+const char* SYSFS_STAT =      "stat";
+#define STAT_READ_IOS_INDEX       0
+#define STAT_READ_SECTORS_INDEX   2
+#define STAT_WRITE_IOS_INDEX      4
+#define STAT_WRITE_SECTORS_INDEX  6
+#define STAT_IO_TICKS_INDEX       9
+
+// /sys/block/mmcblk2/device links to /sys/class/mmc_host/mmc2/mmc2:0001
 /*
-NAME             FSTYPE LABEL    UUID                                 FSAVAIL FSUSE% MOUNTPOINT
-/dev/mmcblk2
-|-/dev/mmcblk2p1 vfat   boot     1EEE-477A                             551.4M     5% /run/media/mmcblk2p1
-|-/dev/mmcblk2p2 vfat   recovery 1EF0-6C50                               367M     8% /run/media/mmcblk2p2
-|-/dev/mmcblk2p3 ext4   rootfs   c7938351-ac5a-4ff0-ab46-6eb9426d7fc5    4.1G    43% /
-`-/dev/mmcblk2p4 ext4   userdata f87194b6-dd6a-4f3d-962c-f59b78aa1cc6    5.3G     0% /userdata
+/sys/block/mmcblk2/device/life_time     0x01 0x02
+/sys/block/mmcblk2/device/pre_eol_info  0x01
 */
-const char* GET_PARTITION_FS_ALL_CMD =     "lsblk -fp /dev/%s > /tmp/.%s_fs_all";
-const char* GET_PARTITION_FSTYPE_CMD =     "cat /tmp/.%s_fs_all | grep %s | awk -F ' ' '{print $2}' | tr -d '\\n'";
-const char* GET_PARTITION_LABEL_CMD =      "cat /tmp/.%s_fs_all | grep %s | awk -F ' ' '{print $3}' | tr -d '\\n'";
-const char* GET_PARTITION_UUID_CMD =       "cat /tmp/.%s_fs_all | grep %s | awk -F ' ' '{print $4}' | tr -d '\\n'";
-const char* GET_PARTITION_FSAVAIL_CMD =    "cat /tmp/.%s_fs_all | grep %s | awk -F ' ' '{print $5}' | tr -d '\\n'";
-const char* GET_PARTITION_FSUSE_CMD =      "cat /tmp/.%s_fs_all | grep %s | awk -F ' ' '{print $6}' | tr -d '\\n'";
-const char* GET_PARTITION_MOUNTPOINT_CMD = "cat /tmp/.%s_fs_all | grep %s | awk -F ' ' '{print $7}' | tr -d '\\n'";
-
-// ex: df -h
+const char* SYSFS_DEVICE_LIFE_TIME =    "device/life_time";
+const char* SYSFS_DEVICE_PRE_EOL_INFO = "device/pre_eol_info";
+
+// ex: /proc/self/mountinfo
+// mount id, parent id, major:minor, root, mount point, options, optional fields, -, fstype, source, super options
 /*
-Filesystem      Size  Used Avail Use% Mounted on
-/dev/root       7.9G  3.4G  4.1G  46% /
-devtmpfs        669M  4.0K  669M   1% /dev
-tmpfs           990M  8.0K  990M   1% /tmp
-/dev/mmcblk2p1  579M   28M  552M   5% /run/media/mmcblk2p1
-/dev/mmcblk2p2  400M   33M  367M   9% /run/media/mmcblk2p2
-/dev/mmcblk2p4  5.6G   23M  5.3G   1% /userdata
-tmpfs           198M  8.0K  198M   1% /run/user/0
+22 1 179:3 / / rw,relatime shared:1 - ext4 /dev/root rw
+31 22 179:1 / /run/media/mmcblk2p1 rw,relatime shared:15 - vfat /dev/mmcblk2p1 rw,fmask=0022
+33 22 179:4 / /userdata rw,relatime shared:17 - ext4 /dev/mmcblk2p4 rw
 */
-const char* GET_PARTITION_USED_CMD =         "df -h | grep %s | awk -F ' ' '{print $3}' | tr -d '\\n'";
-const char* GET_PARTITION_USED_PERCENT_CMD = "df -h | grep %s | awk -F ' ' '{print $5}' | tr -d '\\n'";
+#define MOUNTINFO_DEV_INDEX         2
+#define MOUNTINFO_MOUNT_POINT_INDEX 4
 
 BlockDeviceData::BlockDeviceData() {
     this->m_name = "";
-    this->m_size = "";
+    this->m_dev_number = "";
+    this->m_size_bytes = 0;
+    this->m_start_sector = 0;
+    this->m_read_only = false;
     this->m_fstype = "";
     this->m_label = "";
     this->m_uuid = "";
     this->m_mount_point = "";
 
     // usage
-    this->m_avail = "";
-    this->m_used = "";
-    this->m_used_percent = "";
+    this->m_total_bytes = 0;
+    this->m_avail_bytes = 0;
+    this->m_used_bytes = 0;
 }
 void BlockDeviceData::setName(const string& name) {
     this->m_name = name;
 }
-void BlockDeviceData::setSize(const string& size) {
-    this->m_size = size;
+void BlockDeviceData::setDevNumber(const string& devNumber) {
+    this->m_dev_number = devNumber;
+}
+void BlockDeviceData::setSizeBytes(unsigned long long sizeBytes) {
+    this->m_size_bytes = sizeBytes;
+}
+void BlockDeviceData::setStartSector(unsigned long long startSector) {
+    this->m_start_sector = startSector;
+}
+void BlockDeviceData::setReadOnly(bool readOnly) {
+    this->m_read_only = readOnly;
 }
 void BlockDeviceData::setFSType(const string& fstype) {
     this->m_fstype = fstype;
@@ -116,8 +115,20 @@ void BlockDeviceData::setMountPoint(const string& mountpoint) {
 string BlockDeviceData::getName() {
     return this->m_name;
 }
+string BlockDeviceData::getDevNumber() {
+    return this->m_dev_number;
+}
+unsigned long long BlockDeviceData::getSizeBytes() {
+    return this->m_size_bytes;
+}
+unsigned long long BlockDeviceData::getStartSector() {
+    return this->m_start_sector;
+}
+bool BlockDeviceData::getReadOnly() {
+    return this->m_read_only;
+}
 string BlockDeviceData::getSize() {
-    return this->m_size;
+    return format_size(this->m_size_bytes);
 }
 string BlockDeviceData::getFSType() {
     return this->m_fstype;
@@ -131,151 +142,500 @@ string BlockDeviceData::getUUID() {
 string BlockDeviceData::getMountPoint() {
     return this->m_mount_point;
 }
-void BlockDeviceData::setAvailable(const string& avail) {
-    this->m_avail = avail;
+void BlockDeviceData::setTotalBytes(unsigned long long totalBytes) {
+    this->m_total_bytes = totalBytes;
+}
+void BlockDeviceData::setAvailableBytes(unsigned long long availBytes) {
+    this->m_avail_bytes = availBytes;
 }
-void BlockDeviceData::setUsed(const string& used) {
-    this->m_used = used;
+void BlockDeviceData::setUsedBytes(unsigned long long usedBytes) {
+    this->m_used_bytes = usedBytes;
 }
-void BlockDeviceData::setUsedPercent(const string& used_percent) {
-    this->m_used_percent = used_percent;
+unsigned long long BlockDeviceData::getTotalBytes() {
+    return this->m_total_bytes;
+}
+unsigned long long BlockDeviceData::getAvailableBytes() {
+    return this->m_avail_bytes;
+}
+unsigned long long BlockDeviceData::getUsedBytes() {
+    return this->m_used_bytes;
+}
+int BlockDeviceData::getUsedPercentValue() {
+    // same as df, used / (used + available) and round up
+    unsigned long long total = this->m_used_bytes + this->m_avail_bytes;
+    if (total == 0)
+        return 0;
+    return (int)((this->m_used_bytes * 100 + total - 1) / total);
 }
 string BlockDeviceData::getAvailable() {
-    return this->m_avail;
+    if (this->m_mount_point.empty())
+        return string();
+    return format_size(this->m_avail_bytes);
 }
 string BlockDeviceData::getUsed() {
-    return this->m_used;
+    if (this->m_mount_point.empty())
+        return string();
+    return format_size(this->m_used_bytes);
 }
 string BlockDeviceData::getUsedPercent() {
-    return this->m_used_percent;
+    if (this->m_mount_point.empty())
+        return string();
+    return to_string(getUsedPercentValue()) + "%";
 }
 
-pair<string, bool> IStorageUtility::_get_device_info(const char* cmd, const char* disk) {
-    bool result = false;
-    char cmd_buff[CMD_SIZE]= {0};
-    // check input
-    if (!disk)
-        return make_pair("Missing disk", result);
+BlockDeviceStat::BlockDeviceStat() {
+    this->m_read_ios = 0;
+    this->m_read_sectors = 0;
+    this->m_write_ios = 0;
+    this->m_write_sectors = 0;
+    this->m_io_ticks = 0;
+}
 
-    snprintf(cmd_buff, CMD_SIZE, cmd, disk, disk);
-    const auto ret = execute_cmd_without_read(cmd_buff);
-    result = (ret.second == EXIT_SUCCESS);
-    return make_pair(ret.first, result);
+void BlockDeviceStat::setReadIOs(unsigned long long readIOs) {
+    this->m_read_ios = readIOs;
+}
+void BlockDeviceStat::setReadSectors(unsigned long long readSectors) {
+    this->m_read_sectors = readSectors;
+}
+void BlockDeviceStat::setWriteIOs(unsigned long long writeIOs) {
+    this->m_write_ios = writeIOs;
+}
+void BlockDeviceStat::setWriteSectors(unsigned long long writeSectors) {
+    this->m_write_sectors = writeSectors;
+}
+void BlockDeviceStat::setIOTicks(unsigned long long ioTicks) {
+    this->m_io_ticks = ioTicks;
+}
+unsigned long long BlockDeviceStat::getReadIOs() {
+    return this->m_read_ios;
+}
+unsigned long long BlockDeviceStat::getReadSectors() {
+    return this->m_read_sectors;
+}
+unsigned long long BlockDeviceStat::getWriteIOs() {
+    return this->m_write_ios;
+}
+unsigned long long BlockDeviceStat::getWriteSectors() {
+    return this->m_write_sectors;
+}
+unsigned long long BlockDeviceStat::getIOTicks() {
+    return this->m_io_ticks;
 }
 
-pair<string, bool> IStorageUtility::get_partition_fs_all(const string& disk) {
-    return _get_device_info(GET_PARTITION_FS_ALL_CMD, disk.c_str());
+EMMCHealthData::EMMCHealthData() {
+    this->m_life_time_a = EMMC_LIFE_TIME_UNDEFINED;
+    this->m_life_time_b = EMMC_LIFE_TIME_UNDEFINED;
+    this->m_pre_eol = EMMC_PRE_EOL_UNDEFINED;
 }
 
-pair<string, bool> IStorageUtility::get_partition_block(const string& disk) {
-    return _get_device_info(GET_PARTITION_BLOCK_CMD, disk.c_str());
+void EMMCHealthData::setLifeTimeA(int lifeTime) {
+    this->m_life_time_a = lifeTime;
+}
+void EMMCHealthData::setLifeTimeB(int lifeTime) {
+    this->m_life_time_b = lifeTime;
+}
+void EMMCHealthData::setPreEOL(int preEOL) {
+    this->m_pre_eol = preEOL;
+}
+int EMMCHealthData::getLifeTimeA() {
+    return this->m_life_time_a;
+}
+int EMMCHealthData::getLifeTimeB() {
+    return this->m_life_time_b;
+}
+int EMMCHealthData::getPreEOL() {
+    return this->m_pre_eol;
+}
+string EMMCHealthData::getLifeTimeAString() {
+    return _life_time_to_string(this->m_life_time_a);
+}
+string EMMCHealthData::getLifeTimeBString() {
+    return _life_time_to_string(this->m_life_time_b);
+}
+string EMMCHealthData::getPreEOLString() {
+    switch (this->m_pre_eol) {
+    case EMMC_PRE_EOL_NORMAL:
+        return "Normal";
+    case EMMC_PRE_EOL_WARNING:
+        return "Warning";
+    case EMMC_PRE_EOL_URGENT:
+        return "Urgent";
+    }
+    return "Unknown";
 }
 
-pair<string, bool> IStorageUtility::get_partition_size(const string& disk, const string& partition) {
-    return execute_cmd_get_single_info(GET_PARTITION_SIZE_CMD, disk.c_str(), partition.c_str());
+bool EMMCHealthData::isWarning() {
+    return this->m_pre_eol >= EMMC_PRE_EOL_WARNING ||
+           this->m_life_time_a >= EMMC_LIFE_TIME_WARNING ||
+           this->m_life_time_b >= EMMC_LIFE_TIME_WARNING;
 }
 
-pair<string, bool> IStorageUtility::get_partition_fstype(const string& disk, const string& partition) {
-    return execute_cmd_get_single_info(GET_PARTITION_FSTYPE_CMD, disk.c_str(), partition.c_str());
+string EMMCHealthData::toString() {
+    char buff[BUFF_SIZE] = {0};
+    snprintf(buff, BUFF_SIZE, "Life Time (SLC): %s\nLife Time (MLC): %s\nPre-EOL: %s",
+             getLifeTimeAString().c_str(), getLifeTimeBString().c_str(), getPreEOLString().c_str());
+    return buff;
 }
 
-pair<string, bool> IStorageUtility::get_partition_label(const string& disk, const string& partition) {
-    return execute_cmd_get_single_info(GET_PARTITION_LABEL_CMD, disk.c_str(), partition.c_str());
+string EMMCHealthData::_life_time_to_string(int lifeTime) {
+    char buff[BUFF_SIZE] = {0};
+    if (lifeTime <= EMMC_LIFE_TIME_UNDEFINED || lifeTime > EMMC_LIFE_TIME_EXCEEDED)
+        return "Unknown";
+    if (lifeTime == EMMC_LIFE_TIME_EXCEEDED)
+        return "Exceeded";
+    snprintf(buff, BUFF_SIZE, "%d%%-%d%%", (lifeTime - 1) * 10, lifeTime * 10);
+    return buff;
 }
 
-pair<string, bool> IStorageUtility::get_partition_uuid(const string& disk, const string& partition) {
-    return execute_cmd_get_single_info(GET_PARTITION_UUID_CMD, disk.c_str(), partition.c_str());
+string format_size(unsigned long long bytes) {
+    const char units[] = {'B', 'K', 'M', 'G', 'T', 'P'};
+    char buff[BUFF_SIZE] = {0};
+    double value = bytes;
+    int index = 0;
+    while (value >= 1024 && index < (int)sizeof(units) - 1) {
+        value /= 1024;
+        index++;
+    }
+    // one decimal like lsblk, drop it when value is integer
+    if (index == 0 || (unsigned long long)(value * 10 + 0.5) % 10 == 0)
+        snprintf(buff, BUFF_SIZE, "%.0f%c", value, units[index]);
+    else
+        snprintf(buff, BUFF_SIZE, "%.1f%c", value, units[index]);
+    return buff;
+}
+
+// udev escapes special characters in by-label links, ex: My\x20Disk
+static string unescape_disk_link(const string& name) {
+    string result;
+    for (size_t i = 0; i < name.size(); i++) {
+        if (name[i] == '\\' && i + 3 < name.size() && name[i + 1] == 'x') {
+            result += (char)strtol(name.substr(i + 2, 2).c_str(), nullptr, 16);
+            i += 3;
+        } else {
+            result += name[i];
+        }
+    }
+    return result;
+}
+
+// mountinfo escapes space, tab, newline and backslash as octal, ex: \040
+static string unescape_mount_point(const string& path) {
+    string result;
+    for (size_t i = 0; i < path.size(); i++) {
+        if (path[i] == '\\' && i + 3 < path.size() && isdigit(path[i + 1])) {
+            result += (char)strtol(path.substr(i + 1, 3).c_str(), nullptr, 8);
+            i += 3;
+        } else {
+            result += path[i];
+        }
+    }
+    return result;
 }
 
-pair<string, bool> IStorageUtility::get_partition_mount_point(const string& disk, const string& partition) {
-    return execute_cmd_get_single_info(GET_PARTITION_MOUNTPOINT_CMD, disk.c_str(), partition.c_str());
+BlockDeviceEnumerator::BlockDeviceEnumerator(const char* sysBlockFolder, const char* mountInfoFile, const char* devDiskFolder) {
+    this->m_sysBlockFolder = sysBlockFolder;
+    this->m_mountInfoFile = mountInfoFile;
+    this->m_devDiskFolder = devDiskFolder;
 }
 
-pair<string, bool> IStorageUtility::get_partition_available(const string& disk, const string& partition) {
-    return execute_cmd_get_single_info(GET_PARTITION_FSAVAIL_CMD, disk.c_str(), partition.c_str());
+bool BlockDeviceEnumerator::is_device_exist(const char* device_name) {
+    // check input
+    if (!device_name) {
+        qDebug("missing parameter");
+        return false;
+    }
+    string path = m_sysBlockFolder + "/" + device_name + "/" + SYSFS_DEV;
+    return is_file_exist(path.c_str());
 }
 
-pair<string, bool> IStorageUtility::get_partition_used_percent(const string& partition, const string& mount_point) {
-    string rootMountPoint(ROOT_MOUNT_POINT);
-    if (rootMountPoint.compare(mount_point) == 0) {
-        // if mount point is root, change partition (/dev/mmcblk2p3) to /dev/root for df
-        return execute_cmd_get_single_info(GET_PARTITION_USED_PERCENT_CMD, ROOT_FILE_SYSTEM);
-    } else {
-        return execute_cmd_get_single_info(GET_PARTITION_USED_PERCENT_CMD, partition.c_str());
+pair<unsigned long long, bool> BlockDeviceEnumerator::get_device_size(const char* device_name) {
+    // check input
+    if (!device_name) {
+        qDebug("missing parameter");
+        return make_pair(0, false);
     }
+    string value;
+    string path = m_sysBlockFolder + "/" + device_name + "/" + SYSFS_SIZE;
+    if (!_read_sysfs_value(path, value))
+        return make_pair(0, false);
+    return make_pair(strtoull(value.c_str(), nullptr, 10) * SECTOR_SIZE, true);
 }
 
-pair<string, bool> IStorageUtility::get_partition_used(const string& partition, const string& mount_point) {
-    string rootMountPoint(ROOT_MOUNT_POINT);
-    if (rootMountPoint.compare(mount_point) == 0) {
-        // if mount point is root, change partition (/dev/mmcblk2p3) to /dev/root for df
-        return execute_cmd_get_single_info(GET_PARTITION_USED_CMD, ROOT_FILE_SYSTEM);
-    } else {
-        return execute_cmd_get_single_info(GET_PARTITION_USED_CMD, partition.c_str());
+pair<vector<string>, bool> BlockDeviceEnumerator::get_device_part_names(const char* device_name) {
+    vector<string> names;
+    // check input
+    if (!device_name) {
+        qDebug("missing parameter");
+        return make_pair(names, false);
+    }
+#ifdef _WIN32
+    return make_pair(names, false);
+#else
+    string folder = m_sysBlockFolder + "/" + device_name;
+    DIR *dir = opendir(folder.c_str());
+    if (!dir) {
+        qDebug("open %s failed: %s", folder.c_str(), strerror(errno));
+        return make_pair(names, false);
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.')
+            continue;
+        // partition folder has a partition file, skip other attributes
+        string partitionFile = folder + "/" + entry->d_name + "/" + SYSFS_PARTITION;
+        if (is_file_exist(partitionFile.c_str()))
+            names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    // sort by partition number, mmcblk2p10 after mmcblk2p9
+    std::sort(names.begin(), names.end(), [](const string &a, const string &b) {
+        if (a.size() != b.size())
+            return a.size() < b.size();
+        return a < b;
+    });
+    return make_pair(names, true);
+#endif
+}
+
+pair<vector<BlockDeviceData>, bool> BlockDeviceEnumerator::get_device_parts(const char* device_name) {
+    vector<BlockDeviceData> values;
+    const auto retNames = get_device_part_names(device_name);
+    if (!retNames.second) {
+        qDebug("get device parts failed");
+        return make_pair(values, false);
     }
+    // load once for all partitions
+    const auto mounts = _load_mount_info();
+    const auto labels = _load_disk_links(DISK_BY_LABEL);
+    const auto uuids = _load_disk_links(DISK_BY_UUID);
+    for (const auto &name : retNames.first) {
+        BlockDeviceData deviceData;
+        deviceData.setName(name);
+        _fill_partition(deviceData, m_sysBlockFolder + "/" + device_name + "/" + name, mounts, labels, uuids);
+        values.push_back(deviceData);
+    }
+    return make_pair(values, true);
 }
 
-bool IStorageUtility::_is_device_exist(const char *device) {
-    ifstream indev(device);
-    return indev.good();
+pair<BlockDeviceData, bool> BlockDeviceEnumerator::get_device_part(const char* device_name, const char* partition_name) {
+    BlockDeviceData deviceData;
+    // check input
+    if (!device_name || !partition_name) {
+        qDebug("missing parameter");
+        return make_pair(deviceData, false);
+    }
+    string folder = m_sysBlockFolder + "/" + device_name + "/" + partition_name;
+    string partitionFile = folder + "/" + SYSFS_PARTITION;
+    if (!is_file_exist(partitionFile.c_str()))
+        return make_pair(deviceData, false);
+    deviceData.setName(partition_name);
+    _fill_partition(deviceData, folder, _load_mount_info(), _load_disk_links(DISK_BY_LABEL), _load_disk_links(DISK_BY_UUID));
+    return make_pair(deviceData, true);
 }
 
-pair<vector<BlockDeviceData>, bool> IStorageUtility::_get_device_parts(const char* device_name) {
-    vector<BlockDeviceData> values;
-    const auto retFSAll = get_partition_fs_all(device_name);
-    const auto retBlock = get_partition_block(device_name);
-    if (!retFSAll.second) {
-        qDebug("get partition fs all failed");
-        return make_pair(values, retFSAll.second);
+pair<BlockDeviceStat, bool> BlockDeviceEnumerator::get_device_stat(const char* device_name) {
+    BlockDeviceStat deviceStat;
+    // check input
+    if (!device_name) {
+        qDebug("missing parameter");
+        return make_pair(deviceStat, false);
     }
-    if (!retBlock.second) {
-        qDebug("get partition block failed");
-        return make_pair(values, retBlock.second);
+    string value;
+    string path = m_sysBlockFolder + "/" + device_name + "/" + SYSFS_STAT;
+    if (!_read_sysfs_value(path, value))
+        return make_pair(deviceStat, false);
+    vector<unsigned long long> fields;
+    istringstream stream(value);
+    unsigned long long field = 0;
+    while (stream >> field) {
+        fields.push_back(field);
     }
-    const auto retParts = execute_cmd_get_vector(GET_DISK_PARTIONS_CMD, device_name);
-    for (int i = 0; i < (int)retParts.first.size(); i ++) {
-        const auto retSize = get_partition_size(device_name, retParts.first.at(i));
-        const auto retFSType = get_partition_fstype(device_name, retParts.first.at(i));
-        const auto retLabel = get_partition_label(device_name, retParts.first.at(i));
-        const auto retUUID = get_partition_uuid(device_name, retParts.first.at(i));
-        const auto retMountPoint = get_partition_mount_point(device_name, retParts.first.at(i));
-        const auto retAvailable = get_partition_available(device_name, retParts.first.at(i));
-        const auto retUsedPercent = get_partition_used_percent(retParts.first.at(i), retMountPoint.first);
-        const auto retUsed = get_partition_used(retParts.first.at(i), retMountPoint.first);
-        BlockDeviceData deviceData;
-        deviceData.setName(retParts.first.at(i));
-        deviceData.setSize(retSize.first);
-        deviceData.setFSType(retFSType.first);
-        deviceData.setLabel(retLabel.first);
-        deviceData.setUUID(retUUID.first);
-        deviceData.setMountPoint(retMountPoint.first);
-        deviceData.setAvailable(retAvailable.first);
-        deviceData.setUsedPercent(retUsedPercent.first);
-        deviceData.setUsed(retUsed.first);
-
-        values.push_back(deviceData);
+    if (fields.size() <= STAT_IO_TICKS_INDEX)
+        return make_pair(deviceStat, false);
+    deviceStat.setReadIOs(fields[STAT_READ_IOS_INDEX]);
+    deviceStat.setReadSectors(fields[STAT_READ_SECTORS_INDEX]);
+    deviceStat.setWriteIOs(fields[STAT_WRITE_IOS_INDEX]);
+    deviceStat.setWriteSectors(fields[STAT_WRITE_SECTORS_INDEX]);
+    deviceStat.setIOTicks(fields[STAT_IO_TICKS_INDEX]);
+    return make_pair(deviceStat, true);
+}
+
+pair<EMMCHealthData, bool> BlockDeviceEnumerator::get_emmc_health(const char* device_name) {
+    EMMCHealthData healthData;
+    // check input
+    if (!device_name) {
+        qDebug("missing parameter");
+        return make_pair(healthData, false);
+    }
+    // attributes exist since eMMC 5.0, sd cards do not have them
+    string value;
+    string folder = m_sysBlockFolder + "/" + device_name + "/";
+    if (!_read_sysfs_value(folder + SYSFS_DEVICE_LIFE_TIME, value))
+        return make_pair(healthData, false);
+    unsigned int lifeTimeA = 0;
+    unsigned int lifeTimeB = 0;
+    if (sscanf(value.c_str(), "%x %x", &lifeTimeA, &lifeTimeB) != 2)
+        return make_pair(healthData, false);
+    healthData.setLifeTimeA(lifeTimeA);
+    healthData.setLifeTimeB(lifeTimeB);
+    if (_read_sysfs_value(folder + SYSFS_DEVICE_PRE_EOL_INFO, value))
+        healthData.setPreEOL(strtol(value.c_str(), nullptr, 16));
+    return make_pair(healthData, true);
+}
+
+bool BlockDeviceEnumerator::_read_sysfs_value(const string& path, string &value) {
+    ifstream file(path);
+    if (!file.good())
+        return false;
+    getline(file, value);
+    return true;
+}
+
+unsigned long long BlockDeviceEnumerator::_read_sysfs_number(const string& path) {
+    string value;
+    if (!_read_sysfs_value(path, value))
+        return 0;
+    return strtoull(value.c_str(), nullptr, 10);
+}
+
+map<string, pair<string, string>> BlockDeviceEnumerator::_load_mount_info() {
+    // major:minor -> (mount point, fstype), first mount wins
+    map<string, pair<string, string>> mounts;
+    ifstream file(m_mountInfoFile);
+    if (!file.good()) {
+        qDebug("open %s failed", m_mountInfoFile.c_str());
+        return mounts;
+    }
+    string line;
+    while (getline(file, line)) {
+        istringstream stream(line);
+        vector<string> fields;
+        string field;
+        string fstype;
+        while (stream >> field) {
+            if (field.compare("-") == 0) {
+                stream >> fstype;
+                break;
+            }
+            fields.push_back(field);
+        }
+        if ((int)fields.size() <= MOUNTINFO_MOUNT_POINT_INDEX)
+            continue;
+        const string &devNumber = fields[MOUNTINFO_DEV_INDEX];
+        if (mounts.find(devNumber) != mounts.end())
+            continue;
+        mounts[devNumber] = make_pair(unescape_mount_point(fields[MOUNTINFO_MOUNT_POINT_INDEX]), fstype);
+    }
+    return mounts;
+}
+
+map<string, string> BlockDeviceEnumerator::_load_disk_links(const char* type) {
+    // partition name -> link name, ex: mmcblk2p4 -> userdata
+    map<string, string> links;
+#ifdef _WIN32
+#else
+    string folder = m_devDiskFolder + "/" + type;
+    DIR *dir = opendir(folder.c_str());
+    if (!dir)
+        return links;
+    struct dirent *entry;
+    char target[BUFF_SIZE] = {0};
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.')
+            continue;
+        string path = folder + "/" + entry->d_name;
+        ssize_t len = readlink(path.c_str(), target, BUFF_SIZE - 1);
+        if (len <= 0)
+            continue;
+        target[len] = '\0';
+        // ex: ../../mmcblk2p4
+        string devName = get_filename_from_fullpath(target);
+        links[devName] = unescape_disk_link(entry->d_name);
+    }
+    closedir(dir);
+#endif
+    return links;
+}
+
+void BlockDeviceEnumerator::_fill_partition(BlockDeviceData &deviceData, const string& folder,
+                                            const map<string, pair<string, string>> &mounts,
+                                            const map<string, string> &labels, const map<string, string> &uuids) {
+    string partitionName = deviceData.getName();
+    string devNumber;
+    _read_sysfs_value(folder + "/" + SYSFS_DEV, devNumber);
+    deviceData.setDevNumber(devNumber);
+    deviceData.setSizeBytes(_read_sysfs_number(folder + "/" + SYSFS_SIZE) * SECTOR_SIZE);
+    deviceData.setStartSector(_read_sysfs_number(folder + "/" + SYSFS_START));
+    deviceData.setReadOnly(_read_sysfs_number(folder + "/" + SYSFS_RO) != 0);
+
+    auto itrLabel = labels.find(partitionName);
+    if (itrLabel != labels.end())
+        deviceData.setLabel(itrLabel->second);
+    auto itrUUID = uuids.find(partitionName);
+    if (itrUUID != uuids.end())
+        deviceData.setUUID(itrUUID->second);
+
+    // match by major:minor, root is mounted as /dev/root
+    auto itrMount = mounts.find(devNumber);
+    if (itrMount == mounts.end())
+        return;
+    deviceData.setMountPoint(itrMount->second.first);
+    deviceData.setFSType(itrMount->second.second);
+#ifdef _WIN32
+#else
+    struct statvfs fsStat;
+    if (statvfs(itrMount->second.first.c_str(), &fsStat) != 0) {
+        qDebug("statvfs %s failed: %s", itrMount->second.first.c_str(), strerror(errno));
+        return;
     }
-    return make_pair(values, retParts.second);
+    unsigned long long blockSize = fsStat.f_frsize;
+    deviceData.setTotalBytes(fsStat.f_blocks * blockSize);
+    deviceData.setAvailableBytes(fsStat.f_bavail * blockSize);
+    deviceData.setUsedBytes((fsStat.f_blocks - fsStat.f_bfree) * blockSize);
+#endif
 }
 
-pair<string, bool> TPCStorageUtility::get_emmc_size() {
-    if (!_is_device_exist(STORAGE_EMMC))
+TPCStorageUtility::TPCStorageUtility(const char* sysBlockFolder, const char* mountInfoFile, const char* devDiskFolder)
+    : m_enumerator(sysBlockFolder, mountInfoFile, devDiskFolder) {
+}
+
+pair<string, bool> TPCStorageUtility::get_device_size(const char* device_name) {
+    if (!m_enumerator.is_device_exist(device_name))
         return make_pair(string(), false);
-    return execute_cmd_get_single_info(GET_DISK_SIZE_CMD, STORAGE_NAME_EMMC);
+    const auto ret = m_enumerator.get_device_size(device_name);
+    if (!ret.second)
+        return make_pair(string(), false);
+    return make_pair(format_size(ret.first), true);
+}
+
+pair<string, bool> TPCStorageUtility::get_emmc_size() {
+    return get_device_size(STORAGE_NAME_EMMC);
 }
 
 pair<string, bool> TPCStorageUtility::get_sd_card_size() {
-    if (!_is_device_exist(STORAGE_SD_CARD))
-        return make_pair(string(), false);
-    return execute_cmd_get_single_info(GET_DISK_SIZE_CMD, STORAGE_NAME_SD_CARD);
+    return get_device_size(STORAGE_NAME_SD_CARD);
 }
 
 pair<vector<BlockDeviceData>, bool> TPCStorageUtility::get_emmc_parts() {
-    return _get_device_parts(STORAGE_NAME_EMMC);
+    return get_device_parts(STORAGE_NAME_EMMC);
 }
 
 pair<vector<BlockDeviceData>, bool> TPCStorageUtility::get_sd_card_parts() {
-    return _get_device_parts(STORAGE_NAME_SD_CARD);
+    return get_device_parts(STORAGE_NAME_SD_CARD);
 }
 
+pair<vector<BlockDeviceData>, bool> TPCStorageUtility::get_device_parts(const char* device_name) {
+    return m_enumerator.get_device_parts(device_name);
+}
 
+pair<BlockDeviceData, bool> TPCStorageUtility::get_device_part(const char* device_name, const char* partition_name) {
+    return m_enumerator.get_device_part(device_name, partition_name);
+}
+
+pair<BlockDeviceStat, bool> TPCStorageUtility::get_device_stat(const char* device_name) {
+    return m_enumerator.get_device_stat(device_name);
+}
+
+pair<EMMCHealthData, bool> TPCStorageUtility::get_emmc_health(const char* device_name) {
+    return m_enumerator.get_emmc_health(device_name);
+}
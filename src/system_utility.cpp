@@ -2,81 +2,117 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
 #include <string>
 #include <array>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
 #include <QDebug>
 
 #include "./include/utility.h"
 #include "./include/system_utility.h"
+#include "./include/service_manager.h"
+#include "./include/process_utility.h"
+#include "./include/config_utility.h"
+#include "./include/usb_policy.h"
+#include "./include/reboot_schedule.h"
+#include "./include/boot_environment.h"
 
 #define READONLY_ON_OPTION "-install"
 #define READONLY_OFF_OPTION "-uninstall"
-#define APP_RS_CRON_MODE_DAILY "daily"
-#define APP_RS_CRON_MODE_WEEKLY "weekly"
 
 #define SETTINGS_CRONTAB_FILE "/etc/cron.d/settings"
 
-const char *BOOT_FROM_SD_CARD_CMD = "cat /proc/cmdline | grep 'root=/dev/mmcblk1'";
-const char *GET_READONLY_MODE_CMD = "atcc.rofs -show | grep 'ReadOnly enable'";
+#define SD_CARD_DISK_NAME "mmcblk1"
+
+#define WESTON_PROCESS_NAME "weston"
+#define ROOT_USER_NAME "root"
+#define WESTON_USER_NAME "weston"
+
 const char *SET_READONLY_MODE_CMD = "atcc.rofs %s";
-const char *GET_ROOT_USER_LOGIN_WESTON_CMD = "pgrep -u root weston";
-const char *GET_WESTON_USER_LOGIN_WESTON_CMD = "pgrep -u weston weston";
 const char *SET_USER_LOGIN_WESTON_CMD = "/usr/bin/adv_run_weston_as_user.sh %s";
-const char *GET_USB_STATE_CMD = "/usr/bin/adv_usb_device.sh | tr -d '\\n'";
-const char *SET_USB_STATE_CMD = "/usr/bin/adv_usb_device.sh %s";
-const char *SET_REBOOT_SYSTEM_CRON_DAILY_CMD = 
-    "echo $'%d %d * * * root /sbin/reboot\n' > %s";
-const char *SET_REBOOT_SYSTEM_CRON_WEEKLY_CMD = 
-    "echo $'%d %d * * %d root /sbin/reboot\n' > %s";
-const char *RESTART_CROND_SERVICE_CMD = "systemctl restart crond.service";
 const char *INIT_COM_PORT_CMD = "/usr/bin/init_com_port.sh";
 const char *INIT_ETHERNET_CMD = "/usr/bin/init_ethernet.sh";
 const char *REBOOT_CMD = "( /bin/sleep 1; /sbin/reboot ) &";
 const char *SHUTDOWN_CMD = "( /bin/sleep 1; /sbin/shutdown -h now ) &";
 const char *OPEN_TERMINAL_CMD = "/usr/bin/weston-terminal --maximized --shell=/bin/sh &";
 const char *OPEN_LICENSE_PAGE_CMD = "/usr/bin/chromium --no-sandbox --test-type --start-maximized --hide-crash-restore-bubble /usr/share/html/license_page.html &";
-const char *SET_PSPLASH_BG_COLOR_CMD = "sed -i '/^BACKGROUND_COLOR=/s/=.*/=%s/' /etc/psplash.conf";
+
+TPCSystemUtility::TPCSystemUtility(IServiceManager *serviceManager, IProcessUtility *processUtil,
+                                   const char* com1Device, const char* com2Device,
+                                   IUsbPolicyUtility *usbPolicyUtil)
+{
+    m_com1Device = com1Device ? com1Device : COM1_DEVICE;
+    m_com2Device = com2Device ? com2Device : COM2_DEVICE;
+    m_isServiceManagerOwned = (serviceManager == nullptr);
+    m_serviceManager = serviceManager ? serviceManager : new TPCServiceManager();
+    m_isProcessUtilOwned = (processUtil == nullptr);
+    m_processUtil = processUtil ? processUtil : new TPCProcessUtility();
+    m_isUsbPolicyUtilOwned = (usbPolicyUtil == nullptr);
+    m_usbPolicyUtil = usbPolicyUtil ? usbPolicyUtil : new TPCUsbPolicyUtility();
+    // without block lists the root hub default is the on/off state, set_usb_enable replaces it
+    m_usbPolicy.setEnabled(m_usbPolicyUtil->get_authorized_default());
+}
+
+TPCSystemUtility::~TPCSystemUtility()
+{
+    if (m_isServiceManagerOwned)
+        delete m_serviceManager;
+    if (m_isProcessUtilOwned)
+        delete m_processUtil;
+    if (m_isUsbPolicyUtilOwned)
+        delete m_usbPolicyUtil;
+}
 
 bool TPCSystemUtility::is_boot_from_sd_card()
 {
-    bool isBootFromSD = false;
-    // execute command to get boot from sd card
-    const auto ret = execute_cmd_get_single_info(BOOT_FROM_SD_CARD_CMD);
-    isBootFromSD = (!ret.first.empty());
-    return isBootFromSD;
+    return m_bootEnvironment.is_root_on_disk(SD_CARD_DISK_NAME);
 }
 
 bool TPCSystemUtility::get_readonly_mode()
 {
-    bool isReadonly = false;
-    const auto ret = execute_cmd_get_single_info(GET_READONLY_MODE_CMD);
-    isReadonly = (!ret.first.empty());
-    return isReadonly;
+    // the mounts only change at the next boot, until then the mode last set is reported,
+    // also to a restarted settings or another process
+    const auto pending = m_bootEnvironment.get_pending_readonly_mode();
+    if (pending.second)
+        return pending.first;
+    const auto ret = m_bootEnvironment.get();
+    return ret.first.isRootOverlay || ret.first.isRootReadOnly;
 }
 
 bool TPCSystemUtility::set_readonly_mode(const bool readonly)
 {
     const char *option = readonly ? READONLY_ON_OPTION : READONLY_OFF_OPTION;
-    return execute_cmd_set_info(SET_READONLY_MODE_CMD, option);
+    bool result = execute_cmd_set_info(SET_READONLY_MODE_CMD, option);
+    if (result) {
+        m_bootEnvironment.invalidate();
+        // the mode is applied anyway, without the file only the current mounts are reported
+        m_bootEnvironment.set_pending_readonly_mode(readonly);
+    }
+    return result;
 }
 
 bool TPCSystemUtility::get_system_user_login_desktop()
 {
-    bool isRootUserLogin = false;
-    const auto ret = execute_cmd_get_single_info(GET_ROOT_USER_LOGIN_WESTON_CMD);
-    isRootUserLogin = (!ret.first.empty());
+    bool isRootUserLogin = _is_weston_running_as(ROOT_USER_NAME);
     return !isRootUserLogin;
 }
 
 bool TPCSystemUtility::get_system_custom_user_login_desktop()
 {
     bool isCustomUserLogin = false;
-    const auto retRoot = execute_cmd_get_single_info(GET_ROOT_USER_LOGIN_WESTON_CMD);
-    bool isRootUserLogin = (retRoot.first.length() > 0);
+    bool isRootUserLogin = _is_weston_running_as(ROOT_USER_NAME);
     if (isRootUserLogin)
         return isCustomUserLogin;
-    const auto retWeston = execute_cmd_get_single_info(GET_WESTON_USER_LOGIN_WESTON_CMD);
-    bool isWestonUserLogin = (retWeston.first.length() > 0);
+    bool isWestonUserLogin = _is_weston_running_as(WESTON_USER_NAME);
     if (isWestonUserLogin)
         return isCustomUserLogin;
     // not root and weston means custom user
@@ -86,10 +122,8 @@ bool TPCSystemUtility::get_system_custom_user_login_desktop()
 
 bool TPCSystemUtility::get_usb_enable()
 {
-    bool isDisabled = false;
-    const auto ret = execute_cmd_get_single_info(GET_USB_STATE_CMD);
-    isDisabled = (ret.first.compare(STRING_DISABLE) == 0);
-    return !isDisabled;
+    // a block list keeps the root hub default off while usb is on, so sysfs can not tell
+    return m_usbPolicy.isEnabled();
 }
 
 bool TPCSystemUtility::set_system_user_login_desktop(bool isUserLogin, bool isReboot)
@@ -104,61 +138,116 @@ bool TPCSystemUtility::set_system_user_login_desktop(bool isUserLogin, bool isRe
 
 bool TPCSystemUtility::set_usb_enable(const bool enabled)
 {
-    if (enabled)
-        return execute_cmd_set_info(SET_USB_STATE_CMD, STRING_ENABLE);
-    else
-        return execute_cmd_set_info(SET_USB_STATE_CMD, STRING_DISABLE);
+    m_usbPolicy.setEnabled(enabled);
+    return m_usbPolicyUtil->apply_policy(m_usbPolicy);
 }
 
-bool TPCSystemUtility::set_reboot_system_crontab(bool enabled, const char* mode, 
-                                                  int minute, int hour, int dayofweek)
+void TPCSystemUtility::set_usb_blocked_devices(const char* classes, const char* ports)
+{
+    m_usbPolicy.setBlockedClasses(parse_usb_classes(classes ? classes : ""));
+    m_usbPolicy.setBlockedPorts(parse_usb_ports(ports ? ports : ""));
+}
+
+bool TPCSystemUtility::do_apply_usb_device_policy(const char* name)
 {
-    bool result = false;
     // check input
-    if (!mode) {
+    if (!name) {
         qDebug("missing parameter");
-        return result;
-    }
-    if (strlen(mode) == 0) {
-        qDebug("empty mode:%s", mode);
-        return result;
-    }
-    // remove last crontab file
-    if (is_file_exist(SETTINGS_CRONTAB_FILE)) {
-        remove(SETTINGS_CRONTAB_FILE);
+        return false;
     }
+    // new devices wait unauthorized whenever anything is blocked, allowed ones are authorized here
+    return m_usbPolicyUtil->apply_policy(m_usbPolicy, name);
+}
+
+bool TPCSystemUtility::set_reboot_system_crontab(bool enabled, const RebootSchedule &schedule)
+{
+    bool result = false;
+    string crontab;
     if (enabled) {
-        if (strcmp(mode, APP_RS_CRON_MODE_DAILY) == 0) {
-            result = execute_cmd_set_info(SET_REBOOT_SYSTEM_CRON_DAILY_CMD, minute, hour, SETTINGS_CRONTAB_FILE);
-        } else if (strcmp(mode, APP_RS_CRON_MODE_WEEKLY) == 0) {
-            result = execute_cmd_set_info(SET_REBOOT_SYSTEM_CRON_WEEKLY_CMD, minute, hour, dayofweek, SETTINGS_CRONTAB_FILE);
-        } else {
-            qDebug("unknown mode:%s", mode);
-        }
+        if (!schedule.hasFireTime())
+            qDebug("every reboot window is blacked out");
+        crontab = schedule.toCrontab(ROOT_USER_NAME, REBOOT_SCHEDULE_COMMAND);
+    }
+    // cron would pick up the file anyway, an unchanged one is not worth a restart
+    ifstream file(SETTINGS_CRONTAB_FILE);
+    stringstream current;
+    current << file.rdbuf();
+    if (current.str().compare(crontab) == 0)
+        return true;
+    if (crontab.empty()) {
+        result = (remove(SETTINGS_CRONTAB_FILE) == 0);
     } else {
-        result = true;
+        result = write_file_atomic(SETTINGS_CRONTAB_FILE, crontab.c_str());
     }
+    if (result)
+        result = do_restart_crond_service();
     return result;
 }
 
-bool TPCSystemUtility::set_boot_logo_background_color(const char* color)
+bool TPCSystemUtility::do_restart_crond_service()
 {
-    // check input
-    if (!color || strlen(color) == 0) {
-        qDebug("missing parameter");
-        return false;
-    }
-    return execute_cmd_set_info(SET_PSPLASH_BG_COLOR_CMD, color);
+    return m_serviceManager->restart_units({CROND_SERVICE_NAME});
 }
 
-bool TPCSystemUtility::do_restart_crond_service()
+bool TPCSystemUtility::do_init_com_port()
 {
-    return execute_cmd_set_info(RESTART_CROND_SERVICE_CMD);
+    bool result = true;
+    // board script selects the transceivers, line settings are applied here
+    if (is_file_exist(INIT_COM_PORT_CMD))
+        result &= execute_cmd_set_info(INIT_COM_PORT_CMD);
+    ConfigUtility configUtil;
+    string com1Mode = configUtil.get_com1_mode();
+    string com2Mode = configUtil.get_com2_mode();
+    // com2 is rs485 only
+    if (com2Mode.empty())
+        com2Mode = SERIAL_MODE_RS485;
+    result &= set_com_port(COM1_NAME, make_serial_config(atoi(configUtil.get_com1_baudrate().c_str()), com1Mode.c_str()));
+    result &= set_com_port(COM2_NAME, make_serial_config(atoi(configUtil.get_com2_baudrate().c_str()), com2Mode.c_str()));
+    return result;
 }
 
-bool TPCSystemUtility::do_init_com_port()
+pair<SerialPortConfig, bool> TPCSystemUtility::get_com_port(const char* com)
 {
-    return execute_cmd_set_info(INIT_COM_PORT_CMD);
+    int fd = _open_com_port(com);
+    if (fd < 0)
+        return make_pair(make_serial_config(SERIAL_DEFAULT_BAUDRATE, SERIAL_MODE_RS232), false);
+    const auto ret = read_serial_port_config(fd);
+#ifdef _WIN32
+#else
+    close(fd);
+#endif
+    return ret;
+}
+
+bool TPCSystemUtility::set_com_port(const char* com, const SerialPortConfig &config)
+{
+    int fd = _open_com_port(com);
+    if (fd < 0)
+        return false;
+    // termios and rs485 settings stay with the port after close
+    bool result = configure_serial_port(fd, config);
+#ifdef _WIN32
+#else
+    close(fd);
+#endif
+    return result;
+}
+
+pair<SerialBenchmarkResult, bool> TPCSystemUtility::run_com_port_benchmark(const char* com, CancelCheckFunc isCancelled)
+{
+    int fd = _open_com_port(com);
+    if (fd < 0)
+        return make_pair(SerialBenchmarkResult(), false);
+    // keeps the test near SERIAL_BENCHMARK_SECONDS at any baud rate
+    const auto config = read_serial_port_config(fd);
+    size_t bytes = (size_t)config.first.baudrate / 10 * SERIAL_BENCHMARK_SECONDS;
+    bytes = std::max((size_t)SERIAL_BENCHMARK_MIN_BYTES, std::min((size_t)SERIAL_BENCHMARK_MAX_BYTES, bytes));
+    const auto ret = run_serial_benchmark(fd, fd, bytes, SERIAL_BENCHMARK_ROUNDS, isCancelled);
+#ifdef _WIN32
+#else
+    close(fd);
+#endif
+    return ret;
 }
 
 bool TPCSystemUtility::do_init_ethernet()
@@ -185,3 +274,40 @@ bool TPCSystemUtility::open_license_page()
 {
     return execute_cmd_set_info(OPEN_LICENSE_PAGE_CMD);
 }
+
+bool TPCSystemUtility::_is_weston_running_as(const char* user)
+{
+    const auto uid = get_user_id(user);
+    if (!uid.second)
+        return false;
+    // both checks of one query read the same scan
+    const auto snapshot = m_processUtil->get_snapshot();
+    return !snapshot->find_by_name_and_user(WESTON_PROCESS_NAME, uid.first).empty();
+}
+
+int TPCSystemUtility::_open_com_port(const char* com)
+{
+    // check input
+    if (!com) {
+        qDebug("missing parameter");
+        return -1;
+    }
+    string device;
+    if (strcmp(com, COM1_NAME) == 0)
+        device = m_com1Device;
+    else if (strcmp(com, COM2_NAME) == 0)
+        device = m_com2Device;
+    else {
+        qDebug("unknown com port:%s", com);
+        return -1;
+    }
+#ifdef _WIN32
+    return -1;
+#else
+    // O_NONBLOCK so a port without carrier does not block the open
+    int fd = open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        qDebug("open %s failed:%s", device.c_str(), strerror(errno));
+    return fd;
+#endif
+}
@@ -0,0 +1,344 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <QDateTime>
+#include <QTimeZone>
+#include <QTimer>
+#include <QEventLoop>
+#include <QDBusMessage>
+#include <QDBusArgument>
+#include <QDBusVariant>
+#include <QDBusMetaType>
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/time_dbus_utility.h"
+
+TimedatePropertiesWatcher::TimedatePropertiesWatcher(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void TimedatePropertiesWatcher::propertiesChanged(QString interface, QVariantMap changed, QStringList invalidated)
+{
+    if (interface.compare(TIMEDATE1_INTERFACE) != 0)
+        return;
+    if (changed.contains("NTP") || invalidated.contains("NTP"))
+        emit ntpChanged();
+}
+
+NTPMessageWatcher::NTPMessageWatcher(TimeSyncMonitor *monitor, const QDBusConnection &bus, QObject *parent)
+    : QObject(parent), m_bus(bus)
+{
+    m_monitor = monitor;
+    m_isStarted = false;
+}
+
+NTPMessageWatcher::~NTPMessageWatcher()
+{
+    stop();
+}
+
+bool NTPMessageWatcher::start()
+{
+    if (!m_isStarted) {
+        m_isStarted = m_bus.connect(TIMESYNC1_SERVICE, TIMESYNC1_PATH, DBUS_PROPERTIES_INTERFACE, "PropertiesChanged",
+                                    this, SLOT(propertiesChanged(QString, QVariantMap, QStringList)));
+    }
+    return m_isStarted && _read_ntp_message();
+}
+
+void NTPMessageWatcher::stop()
+{
+    if (!m_isStarted)
+        return;
+    m_bus.disconnect(TIMESYNC1_SERVICE, TIMESYNC1_PATH, DBUS_PROPERTIES_INTERFACE, "PropertiesChanged",
+                     this, SLOT(propertiesChanged(QString, QVariantMap, QStringList)));
+    m_isStarted = false;
+}
+
+void NTPMessageWatcher::propertiesChanged(QString interface, QVariantMap changed, QStringList invalidated)
+{
+    if (interface.compare(TIMESYNC1_INTERFACE) != 0)
+        return;
+    bool isAdded = false;
+    if (changed.contains("NTPMessage"))
+        isAdded = _add_ntp_message(changed.value("NTPMessage"));
+    else if (invalidated.contains("NTPMessage"))
+        isAdded = _read_ntp_message();
+    if (isAdded)
+        emit ntpMessageReceived();
+}
+
+bool NTPMessageWatcher::_read_ntp_message()
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(TIMESYNC1_SERVICE, TIMESYNC1_PATH,
+                                                          DBUS_PROPERTIES_INTERFACE, "Get");
+    message << QString(TIMESYNC1_INTERFACE) << QString("NTPMessage");
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, TIMEDATE1_CALL_TIMEOUT_MS);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qDebug("Get NTPMessage failed::%s", reply.errorMessage().toStdString().c_str());
+        return false;
+    }
+    return _add_ntp_message(reply.arguments().at(0).value<QDBusVariant>().variant());
+}
+
+bool NTPMessageWatcher::_add_ntp_message(const QVariant &value)
+{
+    // (uuuuittayttttbtt)
+    if (!value.canConvert<QDBusArgument>())
+        return false;
+    const QDBusArgument argument = value.value<QDBusArgument>();
+    uint leap = 0, version = 0, mode = 0, stratum = 0;
+    int precision = 0;
+    qulonglong rootDelay = 0, rootDispersion = 0;
+    QByteArray reference;
+    qulonglong origin = 0, receive = 0, transmit = 0, destination = 0;
+    bool isSpike = false;
+    qulonglong packetCount = 0, jitter = 0;
+    argument.beginStructure();
+    argument >> leap >> version >> mode >> stratum >> precision >> rootDelay >> rootDispersion >> reference
+             >> origin >> receive >> transmit >> destination >> isSpike >> packetCount >> jitter;
+    argument.endStructure();
+    // all zero until the first reply from a server
+    if (packetCount == 0 || destination == 0)
+        return false;
+
+    NTPMessageData data;
+    data.leap = leap;
+    data.stratum = stratum;
+    data.rootDelayUs = rootDelay;
+    data.rootDispersionUs = rootDispersion;
+    data.originUs = origin;
+    data.receiveUs = receive;
+    data.transmitUs = transmit;
+    data.destinationUs = destination;
+    data.isSpike = isSpike;
+    data.packetCount = packetCount;
+    data.jitterUs = jitter;
+    m_monitor->add_ntp_message(data);
+    return true;
+}
+
+TPCTimeDBusUtility::TPCTimeDBusUtility(const QDBusConnection &bus)
+    : m_bus(bus), m_serviceManager(bus)
+{
+    if (!m_bus.isConnected()) {
+        qDebug("D-Bus is not connected::%s", m_bus.lastError().message().toStdString().c_str());
+    }
+}
+
+pair<vector<string>, bool> TPCTimeDBusUtility::get_timezones()
+{
+    vector<string> timezones;
+    QDBusMessage message = QDBusMessage::createMethodCall(TIMEDATE1_SERVICE, TIMEDATE1_PATH,
+                                                          TIMEDATE1_INTERFACE, "ListTimezones");
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, TIMEDATE1_CALL_TIMEOUT_MS);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        // ListTimezones came with systemd 246
+        qDebug("ListTimezones failed::%s", reply.errorMessage().toStdString().c_str());
+        return m_commandUtil.get_timezones();
+    }
+    for (auto &timezone : reply.arguments().at(0).toStringList())
+    {
+        timezones.push_back(timezone.toStdString());
+    }
+    return make_pair(timezones, true);
+}
+
+pair<string, bool> TPCTimeDBusUtility::get_current_timezone()
+{
+    auto retProperties = _get_properties();
+    return make_pair(retProperties.first.value("Timezone").toString().toStdString(), retProperties.second);
+}
+
+pair<string, bool> TPCTimeDBusUtility::get_current_date()
+{
+    auto retDate = _format_local_time("yyyy-MM-dd");
+    return make_pair(retDate.first.toStdString(), retDate.second);
+}
+
+pair<string, bool> TPCTimeDBusUtility::get_current_time()
+{
+    auto retTime = _format_local_time("hh:mm:ss");
+    return make_pair(retTime.first.toStdString(), retTime.second);
+}
+
+pair<string, bool> TPCTimeDBusUtility::get_ntp_server()
+{
+    const auto ret = get_ntp_enabled();
+    if (!ret.first)
+        return make_pair(string(), ret.second);
+    QDBusMessage message = QDBusMessage::createMethodCall(TIMESYNC1_SERVICE, TIMESYNC1_PATH,
+                                                          DBUS_PROPERTIES_INTERFACE, "Get");
+    message << QString(TIMESYNC1_INTERFACE) << QString("ServerName");
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, TIMEDATE1_CALL_TIMEOUT_MS);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qDebug("Get ServerName failed::%s", reply.errorMessage().toStdString().c_str());
+        return make_pair(string(), false);
+    }
+    QString serverName = reply.arguments().at(0).value<QDBusVariant>().variant().toString();
+    return make_pair(serverName.toStdString(), true);
+}
+
+pair<bool, bool> TPCTimeDBusUtility::get_ntp_enabled()
+{
+    auto retProperties = _get_properties();
+    return make_pair(retProperties.first.value("NTP").toBool(), retProperties.second);
+}
+
+pair<string, bool> TPCTimeDBusUtility::set_timezone(const char* timezone)
+{
+    // check input
+    if (!timezone || strlen(timezone) == 0) {
+        qDebug("missing timezone");
+        return make_pair("Missing timezone", false);
+    }
+    if (get_current_timezone().first.compare(timezone) == 0)
+        return make_pair("", true);
+    return _call_timedate("SetTimezone", QList<QVariant>() << QString(timezone) << false);
+}
+
+pair<string, bool> TPCTimeDBusUtility::set_manual_date_time(const char* datetime)
+{
+    // check input
+    if (!datetime || strlen(datetime) == 0) {
+        qDebug("missing datetime");
+        return make_pair("Missing datetime", false);
+    }
+    // ex: 2022-01-14 7:55:44, local time of the configured timezone
+    QDateTime localTime = QDateTime::fromString(datetime, "yyyy-MM-dd H:m:s");
+    if (!localTime.isValid()) {
+        qDebug("invalid datetime:%s", datetime);
+        return make_pair("Invalid datetime", false);
+    }
+    // timezone may have changed just before, the process local timezone is not reloaded
+    QTimeZone timezone(get_current_timezone().first.c_str());
+    if (timezone.isValid())
+        localTime.setTimeZone(timezone);
+    qlonglong usecUTC = localTime.toMSecsSinceEpoch() * 1000;
+    return _call_timedate("SetTime", QList<QVariant>() << usecUTC << false << false);
+}
+
+pair<string, bool> TPCTimeDBusUtility::set_sync_with_ntp_server(bool enabled, const char* ntpServer)
+{
+    if (!enabled)
+        return _set_ntp(false);
+    // check input
+    if (!ntpServer)
+        return make_pair("Missing ntp server", false);
+    if (strlen(ntpServer) > 0 && _write_ntp_server(ntpServer) && get_ntp_enabled().first)
+    {
+        // running daemon only reads the server at start
+        m_serviceManager.restart_units({TIMESYNCD_SERVICE_NAME});
+    }
+    return _set_ntp(true);
+}
+
+pair<QVariantMap, bool> TPCTimeDBusUtility::_get_properties()
+{
+    std::lock_guard<std::mutex> lock(m_propertiesMutex);
+    if (m_propertiesTimer.isValid() && m_propertiesTimer.elapsed() < TIMEDATE1_CACHE_MS)
+        return make_pair(m_properties, true);
+    QDBusMessage message = QDBusMessage::createMethodCall(TIMEDATE1_SERVICE, TIMEDATE1_PATH,
+                                                          DBUS_PROPERTIES_INTERFACE, "GetAll");
+    message << QString(TIMEDATE1_INTERFACE);
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, TIMEDATE1_CALL_TIMEOUT_MS);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qDebug("GetAll failed::%s", reply.errorMessage().toStdString().c_str());
+        m_propertiesTimer.invalidate();
+        return make_pair(QVariantMap(), false);
+    }
+    m_properties = qdbus_cast<QVariantMap>(reply.arguments().at(0));
+    m_propertiesTimer.start();
+    return make_pair(m_properties, true);
+}
+
+void TPCTimeDBusUtility::_invalidate_properties()
+{
+    std::lock_guard<std::mutex> lock(m_propertiesMutex);
+    m_propertiesTimer.invalidate();
+}
+
+pair<QString, bool> TPCTimeDBusUtility::_format_local_time(const char* format)
+{
+    auto retProperties = _get_properties();
+    if (!retProperties.second)
+        return make_pair(QString(), false);
+    // TimeUSec is the clock when properties were read, add the cache age
+    qint64 msecs = retProperties.first.value("TimeUSec").toULongLong() / 1000;
+    {
+        std::lock_guard<std::mutex> lock(m_propertiesMutex);
+        if (m_propertiesTimer.isValid())
+            msecs += m_propertiesTimer.elapsed();
+    }
+    QTimeZone timezone(retProperties.first.value("Timezone").toString().toUtf8());
+    QDateTime localTime = timezone.isValid() ? QDateTime::fromMSecsSinceEpoch(msecs, timezone)
+                                             : QDateTime::fromMSecsSinceEpoch(msecs);
+    return make_pair(localTime.toString(format), true);
+}
+
+pair<string, bool> TPCTimeDBusUtility::_call_timedate(const char* method, const QList<QVariant> &arguments)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(TIMEDATE1_SERVICE, TIMEDATE1_PATH,
+                                                          TIMEDATE1_INTERFACE, method);
+    message.setArguments(arguments);
+    QDBusMessage reply = m_bus.call(message, QDBus::Block, TIMEDATE1_CALL_TIMEOUT_MS);
+    _invalidate_properties();
+    if (reply.type() != QDBusMessage::ReplyMessage) {
+        qDebug("%s failed::%s", method, reply.errorMessage().toStdString().c_str());
+        return make_pair(reply.errorMessage().toStdString(), false);
+    }
+    return make_pair("", true);
+}
+
+pair<string, bool> TPCTimeDBusUtility::_set_ntp(bool enabled)
+{
+    auto retEnabled = get_ntp_enabled();
+    if (retEnabled.second && retEnabled.first == enabled)
+        return make_pair("", true);
+    // subscribe before the call so the job finished signal cannot be missed
+    TimedatePropertiesWatcher watcher;
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&watcher, SIGNAL(ntpChanged()), &loop, SLOT(quit()));
+    QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+    m_bus.connect(TIMEDATE1_SERVICE, TIMEDATE1_PATH, DBUS_PROPERTIES_INTERFACE, "PropertiesChanged",
+                  &watcher, SLOT(propertiesChanged(QString, QVariantMap, QStringList)));
+    auto ret = _call_timedate("SetNTP", QList<QVariant>() << enabled << false);
+    if (ret.second && !enabled)
+    {
+        // SetTime is refused with "Previous request is not finished" until timesyncd is stopped
+        timer.start(TIMESYNCD_SERVICE_TIMEOUT * 1000);
+        loop.exec();
+        if (!timer.isActive()) {
+            qDebug("timesyncd did not stop in %d seconds", TIMESYNCD_SERVICE_TIMEOUT);
+        }
+    }
+    m_bus.disconnect(TIMEDATE1_SERVICE, TIMEDATE1_PATH, DBUS_PROPERTIES_INTERFACE, "PropertiesChanged",
+                     &watcher, SLOT(propertiesChanged(QString, QVariantMap, QStringList)));
+    return ret;
+}
+
+// returns true when the file changed
+bool TPCTimeDBusUtility::_write_ntp_server(const char* ntpServer)
+{
+    char file_buff[CMD_SIZE] = {0};
+    char context_buff[CMD_SIZE] = {0};
+    snprintf(file_buff, CMD_SIZE, "%s/%s", NTP_CONF_PATH, NTP_CONF_FILENAME);
+    snprintf(context_buff, CMD_SIZE, NTP_CONF_TEMPLATE, ntpServer);
+    ifstream file(file_buff);
+    if (file.good()) {
+        stringstream content;
+        content << file.rdbuf();
+        if (content.str().compare(context_buff) == 0)
+            return false;
+    }
+    sys_mkdir(NTP_CONF_PATH);
+    return write_file_atomic(file_buff, context_buff);
+}
@@ -0,0 +1,293 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#ifdef _WIN32
+#else
+#include <sys/timex.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/time_sync_monitor.h"
+
+double get_ntp_offset_ms(const NTPMessageData &message)
+{
+    double t1 = (double)message.originUs;
+    double t2 = (double)message.receiveUs;
+    double t3 = (double)message.transmitUs;
+    double t4 = (double)message.destinationUs;
+    return ((t2 - t1) + (t3 - t4)) / 2 / 1000;
+}
+
+double get_ntp_delay_ms(const NTPMessageData &message)
+{
+    double t1 = (double)message.originUs;
+    double t2 = (double)message.receiveUs;
+    double t3 = (double)message.transmitUs;
+    double t4 = (double)message.destinationUs;
+    return ((t4 - t1) - (t3 - t2)) / 1000;
+}
+
+TimeSyncSample::TimeSyncSample()
+{
+    m_time = 0;
+    m_offset = 0;
+    m_jitter = 0;
+    m_frequency = 0;
+    m_max_error = 0;
+    m_synchronized = false;
+    m_from_ntp = false;
+}
+
+void TimeSyncSample::setTime(double time)
+{
+    m_time = time;
+}
+
+void TimeSyncSample::setOffset(double offset)
+{
+    m_offset = offset;
+}
+
+void TimeSyncSample::setJitter(double jitter)
+{
+    m_jitter = jitter;
+}
+
+void TimeSyncSample::setFrequency(double frequency)
+{
+    m_frequency = frequency;
+}
+
+void TimeSyncSample::setMaxError(double maxError)
+{
+    m_max_error = maxError;
+}
+
+void TimeSyncSample::setSynchronized(bool isSynchronized)
+{
+    m_synchronized = isSynchronized;
+}
+
+void TimeSyncSample::setFromNTP(bool isFromNTP)
+{
+    m_from_ntp = isFromNTP;
+}
+
+double TimeSyncSample::getTime()
+{
+    return m_time;
+}
+
+double TimeSyncSample::getOffset()
+{
+    return m_offset;
+}
+
+double TimeSyncSample::getJitter()
+{
+    return m_jitter;
+}
+
+double TimeSyncSample::getFrequency()
+{
+    return m_frequency;
+}
+
+double TimeSyncSample::getMaxError()
+{
+    return m_max_error;
+}
+
+bool TimeSyncSample::isSynchronized()
+{
+    return m_synchronized;
+}
+
+bool TimeSyncSample::isFromNTP()
+{
+    return m_from_ntp;
+}
+
+TimeSyncRing::TimeSyncRing(size_t capacity)
+    : m_samples(capacity > 0 ? capacity : 1)
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+void TimeSyncRing::push(const TimeSyncSample &sample)
+{
+    m_samples[m_head] = sample;
+    m_head = (m_head + 1) % m_samples.size();
+    if (m_size < m_samples.size())
+        m_size++;
+}
+
+void TimeSyncRing::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+size_t TimeSyncRing::size()
+{
+    return m_size;
+}
+
+size_t TimeSyncRing::capacity()
+{
+    return m_samples.size();
+}
+
+TimeSyncSample TimeSyncRing::at(size_t index)
+{
+    if (index >= m_size)
+        return TimeSyncSample();
+    size_t oldest = (m_head + m_samples.size() - m_size) % m_samples.size();
+    return m_samples[(oldest + index) % m_samples.size()];
+}
+
+TimeSyncSample TimeSyncRing::latest()
+{
+    if (m_size == 0)
+        return TimeSyncSample();
+    return at(m_size - 1);
+}
+
+bool TPCTimeSyncClockSource::read_kernel_clock(KernelClockState &state)
+{
+#ifdef _WIN32
+    return false;
+#else
+    struct timex tx;
+    memset(&tx, 0, sizeof(tx));
+    // modes 0 only reads
+    int clockState = adjtimex(&tx);
+    if (clockState < 0) {
+        qDebug("adjtimex failed: %s", strerror(errno));
+        return false;
+    }
+    state.offsetNs = (tx.status & STA_NANO) ? tx.offset : (long long)tx.offset * 1000;
+    // 16 bit fraction
+    state.frequencyPpm = tx.freq / 65536.0;
+    state.maxErrorUs = tx.maxerror;
+    state.estErrorUs = tx.esterror;
+    state.status = tx.status;
+    state.isSynchronized = clockState != TIME_ERROR && !(tx.status & STA_UNSYNC);
+    return true;
+#endif
+}
+
+double TPCTimeSyncClockSource::now()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double>(now).count();
+}
+
+TimeSyncMonitor::TimeSyncMonitor(ITimeSyncClockSource *clockSource, size_t capacity)
+    : m_ring(capacity)
+{
+    m_clockSource = clockSource;
+    m_kernelState.second = false;
+    m_ntpMessage.second = false;
+    m_ntpTime = 0;
+}
+
+void TimeSyncMonitor::sample()
+{
+    KernelClockState state;
+    m_kernelState.second = m_clockSource->read_kernel_clock(state);
+    if (!m_kernelState.second)
+        return;
+    m_kernelState.first = state;
+    double now = m_clockSource->now();
+    m_kernelOffsets.push_back(state.offsetNs / 1e6);
+    if (m_kernelOffsets.size() > TIME_SYNC_JITTER_WINDOW + 1)
+        m_kernelOffsets.pop_front();
+
+    TimeSyncSample sample;
+    sample.setTime(now);
+    sample.setFrequency(state.frequencyPpm);
+    sample.setMaxError(state.maxErrorUs / 1000.0);
+    sample.setSynchronized(state.isSynchronized);
+    if (m_ntpMessage.second && now - m_ntpTime < TIME_SYNC_NTP_MAX_AGE && !m_ntpOffsets.empty()) {
+        sample.setOffset(m_ntpOffsets.back());
+        sample.setJitter(_get_jitter(m_ntpOffsets));
+        sample.setFromNTP(true);
+    } else {
+        sample.setOffset(m_kernelOffsets.back());
+        sample.setJitter(_get_jitter(m_kernelOffsets));
+        sample.setFromNTP(false);
+    }
+    m_ring.push(sample);
+}
+
+void TimeSyncMonitor::add_ntp_message(const NTPMessageData &message)
+{
+    if (m_ntpMessage.second && m_ntpMessage.first.packetCount == message.packetCount &&
+        m_ntpMessage.first.transmitUs == message.transmitUs)
+        return;
+    m_ntpMessage = make_pair(message, true);
+    m_ntpTime = m_clockSource->now();
+    // a spike is not applied to the clock, keep it out of the jitter
+    if (message.isSpike)
+        return;
+    m_ntpOffsets.push_back(get_ntp_offset_ms(message));
+    if (m_ntpOffsets.size() > TIME_SYNC_JITTER_WINDOW + 1)
+        m_ntpOffsets.pop_front();
+}
+
+TimeSyncRing TimeSyncMonitor::get_samples()
+{
+    return m_ring;
+}
+
+pair<KernelClockState, bool> TimeSyncMonitor::get_kernel_state()
+{
+    return m_kernelState;
+}
+
+pair<NTPMessageData, bool> TimeSyncMonitor::get_ntp_message()
+{
+    return m_ntpMessage;
+}
+
+string TimeSyncMonitor::get_summary()
+{
+    char buff[BUFF_SIZE] = {0};
+    if (!m_kernelState.second)
+        return "Not supported";
+    const KernelClockState &state = m_kernelState.first;
+    TimeSyncSample sample = m_ring.latest();
+    int length = snprintf(buff, BUFF_SIZE, "%s, offset %+.3f ms (%s), jitter %.3f ms\n"
+        "Frequency %+.3f ppm, max error %.3f ms",
+        state.isSynchronized ? "Synchronized" : "Not synchronized", sample.getOffset(),
+        sample.isFromNTP() ? "server" : "kernel", sample.getJitter(),
+        state.frequencyPpm, state.maxErrorUs / 1000.0);
+    if (sample.isFromNTP() && length > 0 && length < BUFF_SIZE) {
+        const NTPMessageData &message = m_ntpMessage.first;
+        snprintf(buff + length, BUFF_SIZE - length, ", stratum %u, delay %.3f ms",
+            message.stratum, get_ntp_delay_ms(message));
+    }
+    return buff;
+}
+
+// rms of successive offset differences, as ntp estimates jitter
+double TimeSyncMonitor::_get_jitter(const deque<double> &offsets)
+{
+    if (offsets.size() < 2)
+        return 0;
+    double sum = 0;
+    for (size_t i = 1; i < offsets.size(); i++)
+    {
+        double diff = offsets[i] - offsets[i - 1];
+        sum += diff * diff;
+    }
+    return sqrt(sum / (offsets.size() - 1));
+}
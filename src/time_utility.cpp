@@ -17,10 +17,6 @@
 const char* TYPE_ACTIVE = "active";
 const char* TYPE_INACTIVE = "inactive";
 
-// Network Time Synchronization configuration files path
-const char* NTP_CONF_PATH =            "/etc/systemd/timesyncd.conf.d";
-const char* NTP_CONF_FILENAME =        "userntp.conf";
-const char* NTP_CONF_TEMPLATE =        "[Time]\nNTP=%s";
 const char* RESTART_TIMESYNCD_CMD =    "systemctl restart systemd-timesyncd";
 const char* GET_TIMESYNCD_STATUS_CMD = "systemctl is-active systemd-timesyncd | tr -d '\\n'";
 
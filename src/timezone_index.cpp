@@ -0,0 +1,373 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <QDebug>
+
+#include "./include/timezone_index.h"
+
+#define TZIF_HEADER_SIZE        44
+#define TZIF_TYPE_SIZE          6
+#define SECONDS_PER_DAY         86400LL
+#define SECONDS_PER_HOUR        3600
+// glibc default when the dst part has no rule
+#define POSIX_DEFAULT_RULES     ",M3.2.0,M11.1.0"
+
+static unsigned int read_be32(const unsigned char *p)
+{
+    return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | p[3];
+}
+
+static long long read_be64(const unsigned char *p)
+{
+    return (long long)(((unsigned long long)read_be32(p) << 32) | read_be32(p + 4));
+}
+
+// days since 1970-01-01 of a proleptic gregorian date
+static long long days_from_civil(long long year, int month, int day)
+{
+    year -= month <= 2;
+    const long long era = (year >= 0 ? year : year - 399) / 400;
+    const long long yoe = year - era * 400;
+    const long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static long long year_from_days(long long days)
+{
+    days += 719468;
+    const long long era = (days >= 0 ? days : days - 146096) / 146097;
+    const long long doe = days - era * 146097;
+    const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const long long mp = (5 * doy + 2) / 153;
+    return yoe + era * 400 + (mp >= 10 ? 1 : 0);
+}
+
+static bool is_leap_year(long long year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static long long floor_div(long long value, long long divisor)
+{
+    return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+bool parse_tzif(const string& content, TimezoneData &data)
+{
+    const unsigned char *buffer = (const unsigned char *)content.data();
+    const unsigned long long size = content.size();
+    unsigned long long offset = 0;
+    bool is64 = false;
+    while (true)
+    {
+        if (size - offset < TZIF_HEADER_SIZE || memcmp(buffer + offset, "TZif", 4) != 0)
+            return false;
+        const unsigned char version = buffer[offset + 4];
+        const unsigned long long isutcnt = read_be32(buffer + offset + 20);
+        const unsigned long long isstdcnt = read_be32(buffer + offset + 24);
+        const unsigned long long leapcnt = read_be32(buffer + offset + 28);
+        const unsigned long long timecnt = read_be32(buffer + offset + 32);
+        const unsigned long long typecnt = read_be32(buffer + offset + 36);
+        const unsigned long long charcnt = read_be32(buffer + offset + 40);
+        // counts are 32 bit and the file is bounded, products cannot overflow
+        if (isutcnt > size || isstdcnt > size || leapcnt > size || timecnt > size || typecnt > size || charcnt > size)
+            return false;
+        const unsigned long long timeSize = is64 ? 8 : 4;
+        const unsigned long long blockSize = timecnt * timeSize + timecnt + typecnt * TZIF_TYPE_SIZE + charcnt
+            + leapcnt * (timeSize + 4) + isstdcnt + isutcnt;
+        offset += TZIF_HEADER_SIZE;
+        if (size - offset < blockSize)
+            return false;
+        // version 1 data is only skipped when the 64 bit block follows
+        if (!is64 && version >= '2') {
+            offset += blockSize;
+            is64 = true;
+            continue;
+        }
+        if (typecnt == 0 || charcnt == 0)
+            return false;
+
+        const unsigned char *p = buffer + offset;
+        data.transitions.resize(timecnt);
+        data.transitionTypes.resize(timecnt);
+        data.types.resize(typecnt);
+        for (unsigned long long i = 0; i < timecnt; i++, p += timeSize)
+        {
+            data.transitions[i] = is64 ? read_be64(p) : (long long)(int)read_be32(p);
+        }
+        for (unsigned long long i = 0; i < timecnt; i++, p++)
+        {
+            if (*p >= typecnt)
+                return false;
+            data.transitionTypes[i] = *p;
+        }
+        const char *chars = (const char *)p + typecnt * TZIF_TYPE_SIZE;
+        for (unsigned long long i = 0; i < typecnt; i++, p += TZIF_TYPE_SIZE)
+        {
+            if (p[5] >= charcnt)
+                return false;
+            data.types[i].offset = (int)read_be32(p);
+            data.types[i].isDst = p[4] != 0;
+            data.types[i].abbreviation = string(chars + p[5], strnlen(chars + p[5], charcnt - p[5]));
+        }
+        offset += blockSize;
+        break;
+    }
+
+    // footer is newline enclosed, empty when the zone has no rule past the last transition
+    data.hasFooter = false;
+    if (is64 && offset < size && buffer[offset] == '\n') {
+        size_t end = content.find('\n', offset + 1);
+        if (end != string::npos && end > offset + 1) {
+            data.hasFooter = parse_posix_timezone(content.substr(offset + 1, end - offset - 1), data.footer);
+        }
+    }
+    return true;
+}
+
+static bool parse_posix_name(const string& text, size_t &pos, string &name)
+{
+    size_t start = pos;
+    if (pos < text.size() && text[pos] == '<') {
+        size_t end = text.find('>', pos);
+        if (end == string::npos)
+            return false;
+        name = text.substr(pos + 1, end - pos - 1);
+        pos = end + 1;
+        return name.size() >= 3;
+    }
+    while (pos < text.size() && isalpha((unsigned char)text[pos]))
+        pos++;
+    name = text.substr(start, pos - start);
+    return name.size() >= 3;
+}
+
+// [+-]hh[:mm[:ss]], hours up to 167 for rule times
+static bool parse_posix_time(const string& text, size_t &pos, int &seconds)
+{
+    int sign = 1;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+        sign = text[pos] == '-' ? -1 : 1;
+        pos++;
+    }
+    int parts[3] = {0};
+    for (int i = 0; i < 3; i++)
+    {
+        if (i > 0) {
+            if (pos >= text.size() || text[pos] != ':')
+                break;
+            pos++;
+        }
+        size_t start = pos;
+        while (pos < text.size() && isdigit((unsigned char)text[pos]) && pos - start < 3)
+            pos++;
+        if (pos == start)
+            return false;
+        parts[i] = atoi(text.substr(start, pos - start).c_str());
+    }
+    if (parts[0] > 167 || parts[1] > 59 || parts[2] > 59)
+        return false;
+    seconds = sign * (parts[0] * SECONDS_PER_HOUR + parts[1] * 60 + parts[2]);
+    return true;
+}
+
+static bool parse_posix_number(const string& text, size_t &pos, int &value)
+{
+    size_t start = pos;
+    while (pos < text.size() && isdigit((unsigned char)text[pos]) && pos - start < 3)
+        pos++;
+    if (pos == start)
+        return false;
+    value = atoi(text.substr(start, pos - start).c_str());
+    return true;
+}
+
+static bool parse_posix_rule(const string& text, size_t &pos, PosixTimezoneRule &rule)
+{
+    memset(&rule, 0, sizeof(rule));
+    if (pos >= text.size())
+        return false;
+    if (text[pos] == 'M') {
+        pos++;
+        rule.kind = 'M';
+        if (!parse_posix_number(text, pos, rule.month) || pos >= text.size() || text[pos++] != '.' ||
+            !parse_posix_number(text, pos, rule.week) || pos >= text.size() || text[pos++] != '.' ||
+            !parse_posix_number(text, pos, rule.day))
+            return false;
+        if (rule.month < 1 || rule.month > 12 || rule.week < 1 || rule.week > 5 || rule.day > 6)
+            return false;
+    } else if (text[pos] == 'J') {
+        pos++;
+        rule.kind = 'J';
+        if (!parse_posix_number(text, pos, rule.day) || rule.day < 1 || rule.day > 365)
+            return false;
+    } else {
+        rule.kind = 'D';
+        if (!parse_posix_number(text, pos, rule.day) || rule.day > 365)
+            return false;
+    }
+    rule.time = 2 * SECONDS_PER_HOUR;
+    if (pos < text.size() && text[pos] == '/') {
+        pos++;
+        return parse_posix_time(text, pos, rule.time);
+    }
+    return true;
+}
+
+bool parse_posix_timezone(const string& text, PosixTimezone &timezone)
+{
+    size_t pos = 0;
+    int seconds = 0;
+    timezone.hasDst = false;
+    timezone.standard.isDst = false;
+    timezone.daylight.isDst = true;
+    if (!parse_posix_name(text, pos, timezone.standard.abbreviation) || !parse_posix_time(text, pos, seconds))
+        return false;
+    // posix offsets are west of UTC
+    timezone.standard.offset = -seconds;
+    if (pos == text.size())
+        return true;
+
+    if (!parse_posix_name(text, pos, timezone.daylight.abbreviation))
+        return false;
+    timezone.daylight.offset = timezone.standard.offset + SECONDS_PER_HOUR;
+    if (pos < text.size() && text[pos] != ',') {
+        if (!parse_posix_time(text, pos, seconds))
+            return false;
+        timezone.daylight.offset = -seconds;
+    }
+    string rules = pos < text.size() ? text.substr(pos) : string(POSIX_DEFAULT_RULES);
+    pos = 0;
+    if (rules[pos++] != ',' || !parse_posix_rule(rules, pos, timezone.start) ||
+        pos >= rules.size() || rules[pos++] != ',' || !parse_posix_rule(rules, pos, timezone.end) ||
+        pos != rules.size())
+        return false;
+    timezone.hasDst = true;
+    return true;
+}
+
+// local seconds since epoch the rule takes effect in year
+static long long get_rule_local_time(const PosixTimezoneRule &rule, long long year)
+{
+    long long days = days_from_civil(year, 1, 1);
+    if (rule.kind == 'J') {
+        // Feb 29 is never counted
+        days += rule.day - 1 + (is_leap_year(year) && rule.day >= 60 ? 1 : 0);
+    } else if (rule.kind == 'D') {
+        days += rule.day;
+    } else {
+        const long long first = days_from_civil(year, rule.month, 1);
+        const long long next = rule.month == 12 ? days_from_civil(year + 1, 1, 1)
+                                                : days_from_civil(year, rule.month + 1, 1);
+        // 1970-01-01 was a thursday
+        const long long firstWeekday = ((first + 4) % 7 + 7) % 7;
+        days = first + (rule.day - firstWeekday + 7) % 7 + (rule.week - 1) * 7;
+        // week 5 is the last one of the month
+        if (days >= next)
+            days -= 7;
+    }
+    return days * SECONDS_PER_DAY + rule.time;
+}
+
+TimezoneType get_posix_timezone_type(const PosixTimezone &timezone, long long utc)
+{
+    if (!timezone.hasDst)
+        return timezone.standard;
+    const long long year = year_from_days(floor_div(utc + timezone.standard.offset, SECONDS_PER_DAY));
+    // start is given in standard time and end in daylight time
+    const long long start = get_rule_local_time(timezone.start, year) - timezone.standard.offset;
+    const long long end = get_rule_local_time(timezone.end, year) - timezone.daylight.offset;
+    bool isDst;
+    if (start < end)
+        isDst = utc >= start && utc < end;
+    else
+        // southern hemisphere, dst spans the new year
+        isDst = !(utc >= end && utc < start);
+    return isDst ? timezone.daylight : timezone.standard;
+}
+
+TimezoneType get_timezone_type(const TimezoneData &data, long long utc)
+{
+    if (data.transitions.empty() || utc >= data.transitions.back()) {
+        if (data.hasFooter)
+            return get_posix_timezone_type(data.footer, utc);
+        if (data.transitions.empty())
+            return data.types[0];
+    }
+    // type 0 applies before the first transition
+    if (utc < data.transitions.front())
+        return data.types[0];
+    auto itr = std::upper_bound(data.transitions.begin(), data.transitions.end(), utc);
+    return data.types[data.transitionTypes[itr - data.transitions.begin() - 1]];
+}
+
+string format_utc_offset(int offset)
+{
+    char buff[16] = {0};
+    const int minutes = abs(offset) / 60;
+    snprintf(buff, sizeof(buff), "%c%02d:%02d", offset < 0 ? '-' : '+', minutes / 60, minutes % 60);
+    return buff;
+}
+
+TimezoneIndex::TimezoneIndex(const char* zoneinfoFolder)
+{
+    m_zoneinfoFolder = zoneinfoFolder ? zoneinfoFolder : ZONEINFO_FOLDER;
+}
+
+size_t TimezoneIndex::load(const vector<string>& names)
+{
+    m_names.clear();
+    m_zones.clear();
+    m_names.reserve(names.size());
+    m_zones.reserve(names.size());
+    string content;
+    for (auto &name : names)
+    {
+        // names come from timedated, still never leave the zoneinfo folder
+        if (name.empty() || name[0] == '/' || name.find("..") != string::npos)
+            continue;
+        TimezoneData data;
+        if (!_read_file(m_zoneinfoFolder + "/" + name, content) || !parse_tzif(content, data)) {
+            qDebug("invalid timezone:%s", name.c_str());
+            continue;
+        }
+        m_names.push_back(name);
+        m_zones.push_back(std::move(data));
+    }
+    return m_zones.size();
+}
+
+size_t TimezoneIndex::size() const
+{
+    return m_zones.size();
+}
+
+const string& TimezoneIndex::get_name(size_t index) const
+{
+    return m_names[index];
+}
+
+TimezoneType TimezoneIndex::get_type(size_t index, long long utc) const
+{
+    return get_timezone_type(m_zones[index], utc);
+}
+
+bool TimezoneIndex::_read_file(const string& path, string &content)
+{
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file.good())
+        return false;
+    const streamoff size = file.tellg();
+    if (size <= 0 || size > TZIF_MAX_FILE_SIZE)
+        return false;
+    content.resize((size_t)size);
+    file.seekg(0);
+    return (bool)file.read(&content[0], size);
+}
@@ -0,0 +1,214 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+
+#include "./include/timezone_list_model.h"
+
+TimezoneListModel::TimezoneListModel(const char* zoneinfoFolder, QObject *parent)
+    : QAbstractListModel(parent), m_index(zoneinfoFolder)
+{
+    this->m_isLoaded = false;
+    this->m_sortColumn = -1;
+    this->m_sortOrder = Qt::AscendingOrder;
+}
+
+int TimezoneListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return (int)this->m_items.size();
+}
+
+QVariant TimezoneListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= (int)this->m_items.size())
+        return QVariant();
+    const TimezoneListItem &item = this->m_items[index.row()];
+    const string &name = this->m_index.get_name(item.zone);
+    switch (role)
+    {
+        case TextRole:
+            // ex: " (GMT+08:00) Asia/Taipei"
+            return QString::fromStdString(" (GMT" + format_utc_offset(item.type.offset) + ") " + name);
+        case ValueRole:
+            return QString::fromStdString(name);
+        case OffsetRole:
+            return item.type.offset;
+        case IsDstRole:
+            return item.type.isDst;
+        case AbbreviationRole:
+            return QString::fromStdString(item.type.abbreviation);
+        case SectionRole:
+            return QString::fromStdString("GMT" + format_utc_offset(item.type.offset));
+        default:
+            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TimezoneListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[TextRole] = "text";
+    roles[ValueRole] = "value";
+    roles[OffsetRole] = "offset";
+    roles[IsDstRole] = "isDst";
+    roles[AbbreviationRole] = "abbreviation";
+    roles[SectionRole] = "section";
+    return roles;
+}
+
+void TimezoneListModel::sort(int column, Qt::SortOrder order)
+{
+    if (column != NameColumn && column != OffsetColumn)
+        return;
+    this->m_sortColumn = column;
+    this->m_sortOrder = order;
+    beginResetModel();
+    _sort_items();
+    endResetModel();
+}
+
+bool TimezoneListModel::isLoaded() const
+{
+    return this->m_isLoaded;
+}
+
+void TimezoneListModel::load(const vector<string>& names)
+{
+    beginResetModel();
+    this->m_index.load(names);
+    this->m_items.clear();
+    this->m_items.reserve(this->m_index.size());
+    for (size_t i = 0; i < this->m_index.size(); i++)
+    {
+        TimezoneListItem item;
+        item.zone = i;
+        item.type.offset = 0;
+        item.type.isDst = false;
+        this->m_items.push_back(item);
+    }
+    this->m_isLoaded = true;
+    endResetModel();
+}
+
+void TimezoneListModel::refresh(long long utc)
+{
+    if (this->m_items.empty())
+        return;
+    bool isChanged = false;
+    for (auto &item : this->m_items)
+    {
+        TimezoneType type = this->m_index.get_type(item.zone, utc);
+        if (type.offset != item.type.offset || type.isDst != item.type.isDst)
+            isChanged = true;
+        item.type = type;
+    }
+    if (!isChanged)
+        return;
+    if (this->m_sortColumn == OffsetColumn) {
+        // dst changes move rows
+        beginResetModel();
+        _sort_items();
+        endResetModel();
+    } else {
+        emit dataChanged(index(0), index((int)this->m_items.size() - 1));
+    }
+}
+
+int TimezoneListModel::indexOf(const QString &timezone) const
+{
+    const string name = timezone.compare("Universal") == 0 ? string("UTC") : timezone.toStdString();
+    for (size_t i = 0; i < this->m_items.size(); i++)
+    {
+        if (this->m_index.get_name(this->m_items[i].zone).compare(name) == 0)
+            return (int)i;
+    }
+    return -1;
+}
+
+QString TimezoneListModel::valueAt(int row) const
+{
+    if (row < 0 || row >= (int)this->m_items.size())
+        return QString();
+    return QString::fromStdString(this->m_index.get_name(this->m_items[row].zone));
+}
+
+void TimezoneListModel::_sort_items()
+{
+    const TimezoneIndex &zones = this->m_index;
+    const bool isByOffset = this->m_sortColumn == OffsetColumn;
+    std::stable_sort(this->m_items.begin(), this->m_items.end(),
+        [&zones, isByOffset](const TimezoneListItem &a, const TimezoneListItem &b) {
+            if (isByOffset && a.type.offset != b.type.offset)
+                return a.type.offset < b.type.offset;
+            return zones.get_name(a.zone) < zones.get_name(b.zone);
+        });
+    if (this->m_sortOrder == Qt::DescendingOrder)
+        std::reverse(this->m_items.begin(), this->m_items.end());
+}
+
+TimezoneFilterModel::TimezoneFilterModel(const char* zoneinfoFolder, QObject *parent)
+    : QSortFilterProxyModel(parent), m_searchIndex(zoneinfoFolder)
+{
+    // source keeps name order, so a stable sort groups by offset with names sorted inside
+    setSortRole(TimezoneListModel::OffsetRole);
+    sort(0);
+}
+
+void TimezoneFilterModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (this->sourceModel())
+        QObject::disconnect(this->sourceModel(), nullptr, this, nullptr);
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    if (sourceModel)
+    {
+        // connected after the proxy's own handlers, the filter is invalidated again once the index is rebuilt
+        QObject::connect(sourceModel, SIGNAL(modelReset()), this, SLOT(sourceRowsChanged()));
+        QObject::connect(sourceModel, SIGNAL(rowsInserted(QModelIndex, int, int)), this, SLOT(sourceRowsChanged()));
+        QObject::connect(sourceModel, SIGNAL(rowsRemoved(QModelIndex, int, int)), this, SLOT(sourceRowsChanged()));
+        QObject::connect(sourceModel, SIGNAL(layoutChanged()), this, SLOT(sourceRowsChanged()));
+    }
+    sourceRowsChanged();
+}
+
+QString TimezoneFilterModel::filterText() const
+{
+    return this->m_filterText;
+}
+
+void TimezoneFilterModel::setFilterText(const QString &text)
+{
+    if (this->m_filterText == text)
+        return;
+    this->m_filterText = text;
+    this->m_searchIndex.search(text.toStdString(), this->m_matched);
+    invalidateFilter();
+    emit filterTextChanged();
+}
+
+bool TimezoneFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+    if (this->m_filterText.isEmpty())
+        return true;
+    return sourceRow >= 0 && sourceRow < (int)this->m_matched.size() && this->m_matched[sourceRow];
+}
+
+void TimezoneFilterModel::sourceRowsChanged()
+{
+    QAbstractItemModel *model = sourceModel();
+    vector<string> names;
+    if (model && model->rowCount() > 0)
+    {
+        // tzdata aliases are only read when there is something to search
+        this->m_searchIndex.load_aliases();
+        for (int row = 0; row < model->rowCount(); row++)
+        {
+            names.push_back(model->data(model->index(row, 0), TimezoneListModel::ValueRole).toString().toStdString());
+        }
+    }
+    this->m_searchIndex.build(names);
+    this->m_searchIndex.search(this->m_filterText.toStdString(), this->m_matched);
+    invalidateFilter();
+}
@@ -0,0 +1,215 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cctype>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <QDebug>
+
+#include "./include/timezone_search_index.h"
+
+static unsigned int pack_trigram(const char *p)
+{
+    return ((unsigned int)(unsigned char)p[0] << 16) | ((unsigned int)(unsigned char)p[1] << 8) |
+        (unsigned char)p[2];
+}
+
+static vector<string> split_words(const string& text)
+{
+    vector<string> words;
+    stringstream stream(text);
+    string word;
+    while (stream >> word)
+        words.push_back(word);
+    return words;
+}
+
+string normalize_timezone_text(const string& text)
+{
+    string result;
+    result.reserve(text.size());
+    for (char c : text)
+    {
+        if (isalnum((unsigned char)c)) {
+            result += (char)tolower((unsigned char)c);
+        } else if (!result.empty() && result.back() != ' ') {
+            result += ' ';
+        }
+    }
+    if (!result.empty() && result.back() == ' ')
+        result.pop_back();
+    return result;
+}
+
+TimezoneSearchIndex::TimezoneSearchIndex(const char* zoneinfoFolder)
+{
+    m_zoneinfoFolder = zoneinfoFolder ? zoneinfoFolder : ZONEINFO_FOLDER;
+    m_isAliasesLoaded = false;
+}
+
+void TimezoneSearchIndex::load_aliases()
+{
+    if (m_isAliasesLoaded)
+        return;
+    m_isAliasesLoaded = true;
+    _load_links();
+    _load_countries();
+}
+
+void TimezoneSearchIndex::build(const vector<string>& names)
+{
+    m_keys.clear();
+    m_words.clear();
+    m_trigrams.clear();
+    m_keys.reserve(names.size());
+    for (unsigned int doc = 0; doc < names.size(); doc++)
+    {
+        string key = normalize_timezone_text(names[doc]);
+        auto itr = m_aliases.find(names[doc]);
+        if (itr != m_aliases.end()) {
+            for (auto &alias : itr->second)
+                key += " " + normalize_timezone_text(alias);
+        }
+        m_keys.push_back(key);
+
+        for (auto &word : split_words(key))
+        {
+            m_words.push_back(make_pair(word, doc));
+            for (size_t i = 0; i + TIMEZONE_TRIGRAM_SIZE <= word.size(); i++)
+            {
+                vector<unsigned int> &docs = m_trigrams[pack_trigram(word.data() + i)];
+                // documents are added in order, a repeat can only be the last one
+                if (docs.empty() || docs.back() != doc)
+                    docs.push_back(doc);
+            }
+        }
+    }
+    std::sort(m_words.begin(), m_words.end());
+    m_words.erase(std::unique(m_words.begin(), m_words.end()), m_words.end());
+}
+
+size_t TimezoneSearchIndex::size() const
+{
+    return m_keys.size();
+}
+
+size_t TimezoneSearchIndex::search(const string& query, vector<char> &matched) const
+{
+    const vector<string> words = split_words(normalize_timezone_text(query));
+    matched.assign(m_keys.size(), words.empty() ? 1 : 0);
+    if (words.empty())
+        return m_keys.size();
+
+    vector<char> wordMatched;
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        if (!_search_word(words[i], i == 0 ? matched : wordMatched))
+        {
+            // earlier words may have marked documents already
+            matched.assign(m_keys.size(), 0);
+            return 0;
+        }
+        if (i == 0)
+            continue;
+        for (size_t doc = 0; doc < matched.size(); doc++)
+            matched[doc] &= wordMatched[doc];
+    }
+    return (size_t)std::count(matched.begin(), matched.end(), 1);
+}
+
+// returns false when nothing matched
+bool TimezoneSearchIndex::_search_word(const string& word, vector<char> &matched) const
+{
+    matched.assign(m_keys.size(), 0);
+    bool isFound = false;
+    if (word.size() < TIMEZONE_TRIGRAM_SIZE) {
+        // prefix range in the sorted words
+        auto itr = std::lower_bound(m_words.begin(), m_words.end(), make_pair(word, 0u));
+        for (; itr != m_words.end() && itr->first.compare(0, word.size(), word) == 0; ++itr)
+        {
+            matched[itr->second] = 1;
+            isFound = true;
+        }
+        return isFound;
+    }
+
+    // candidates of the rarest trigram, then confirm the whole word
+    const vector<unsigned int> *candidates = nullptr;
+    for (size_t i = 0; i + TIMEZONE_TRIGRAM_SIZE <= word.size(); i++)
+    {
+        auto itr = m_trigrams.find(pack_trigram(word.data() + i));
+        if (itr == m_trigrams.end())
+            return false;
+        if (!candidates || itr->second.size() < candidates->size())
+            candidates = &itr->second;
+    }
+    for (auto doc : *candidates)
+    {
+        if (m_keys[doc].find(word) != string::npos) {
+            matched[doc] = 1;
+            isFound = true;
+        }
+    }
+    return isFound;
+}
+
+void TimezoneSearchIndex::_load_links()
+{
+    ifstream file(m_zoneinfoFolder + "/" + TZDATA_ZI_FILENAME);
+    if (!file.good()) {
+        qDebug("no %s, timezone links are not searchable", TZDATA_ZI_FILENAME);
+        return;
+    }
+    string line;
+    while (getline(file, line))
+    {
+        // L <target> <link>
+        if (line.size() < 2 || line[0] != 'L' || line[1] != ' ')
+            continue;
+        stringstream stream(line.substr(2));
+        string target, link;
+        if (stream >> target >> link) {
+            // either name may be the one listed, each is found by the other
+            _add_alias(target, link);
+            _add_alias(link, target);
+        }
+    }
+}
+
+void TimezoneSearchIndex::_load_countries()
+{
+    map<string, string> countries;
+    ifstream isoFile(m_zoneinfoFolder + "/" + ISO3166_TAB_FILENAME);
+    string line;
+    while (getline(isoFile, line))
+    {
+        // <code>\t<country name>
+        size_t tab = line.find('\t');
+        if (line.empty() || line[0] == '#' || tab == string::npos)
+            continue;
+        countries[line.substr(0, tab)] = line.substr(tab + 1);
+    }
+    if (countries.empty())
+        return;
+
+    ifstream zoneFile(m_zoneinfoFolder + "/" + ZONE_TAB_FILENAME);
+    while (getline(zoneFile, line))
+    {
+        // <code>\t<coordinates>\t<timezone>[\t<comments>]
+        if (line.empty() || line[0] == '#')
+            continue;
+        stringstream stream(line);
+        string code, coordinates, name;
+        if (!getline(stream, code, '\t') || !getline(stream, coordinates, '\t') || !getline(stream, name, '\t'))
+            continue;
+        auto itr = countries.find(code);
+        if (itr != countries.end())
+            _add_alias(name, itr->second);
+    }
+}
+
+void TimezoneSearchIndex::_add_alias(const string& name, const string& alias)
+{
+    m_aliases[name].push_back(alias);
+}
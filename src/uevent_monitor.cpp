@@ -0,0 +1,241 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstring>
+#include <cerrno>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#endif
+#include <QSocketNotifier>
+#include <QDebug>
+
+#include "./include/uevent_monitor.h"
+
+const char* UEVENT_KEY_ACTION =    "ACTION=";
+const char* UEVENT_KEY_DEVPATH =   "DEVPATH=";
+const char* UEVENT_KEY_SUBSYSTEM = "SUBSYSTEM=";
+const char* UEVENT_KEY_DEVNAME =   "DEVNAME=";
+const char* UEVENT_KEY_DEVTYPE =   "DEVTYPE=";
+// udev re-broadcasts on same family with this header, only kernel messages are handled
+const char* UDEV_MONITOR_HEADER =  "libudev";
+
+UEvent::UEvent() {
+}
+
+std::string UEvent::getAction() {
+    return this->m_action;
+}
+
+std::string UEvent::getDevPath() {
+    return this->m_devpath;
+}
+
+std::string UEvent::getSubsystem() {
+    return this->m_subsystem;
+}
+
+std::string UEvent::getDevName() {
+    return this->m_devname;
+}
+
+std::string UEvent::getDevType() {
+    return this->m_devtype;
+}
+
+bool UEvent::isPartition() {
+    return this->m_devtype.compare(UEVENT_DEVTYPE_PARTITION) == 0;
+}
+
+std::string UEvent::getDiskName() {
+    if (!isPartition())
+        return this->m_devname;
+    // parent folder of partition in devpath is the disk
+    std::string parent = this->m_devpath.substr(0, this->m_devpath.find_last_of('/'));
+    return parent.substr(parent.find_last_of('/') + 1);
+}
+
+std::string UEvent::getKernelName() {
+    return this->m_devpath.substr(this->m_devpath.find_last_of('/') + 1);
+}
+
+std::pair<UEvent, bool> UEvent::parse(const char *buff, size_t len) {
+    UEvent event;
+    // check input
+    if (!buff || len == 0) {
+        qDebug("missing parameter");
+        return std::make_pair(event, false);
+    }
+    // first string is "action@devpath" header
+    size_t headerLen = strnlen(buff, len);
+    if (headerLen == len || strchr(buff, '@') == nullptr)
+        return std::make_pair(event, false);
+    size_t offset = headerLen + 1;
+    while (offset < len) {
+        const char *field = buff + offset;
+        size_t fieldLen = strnlen(field, len - offset);
+        std::string value(field, fieldLen);
+        if (value.rfind(UEVENT_KEY_ACTION, 0) == 0)
+            event.m_action = value.substr(strlen(UEVENT_KEY_ACTION));
+        else if (value.rfind(UEVENT_KEY_DEVPATH, 0) == 0)
+            event.m_devpath = value.substr(strlen(UEVENT_KEY_DEVPATH));
+        else if (value.rfind(UEVENT_KEY_SUBSYSTEM, 0) == 0)
+            event.m_subsystem = value.substr(strlen(UEVENT_KEY_SUBSYSTEM));
+        else if (value.rfind(UEVENT_KEY_DEVNAME, 0) == 0)
+            event.m_devname = value.substr(strlen(UEVENT_KEY_DEVNAME));
+        else if (value.rfind(UEVENT_KEY_DEVTYPE, 0) == 0)
+            event.m_devtype = value.substr(strlen(UEVENT_KEY_DEVTYPE));
+        offset += fieldLen + 1;
+    }
+    // DEVNAME might be full path on some kernels
+    size_t pos = event.m_devname.find_last_of('/');
+    if (pos != std::string::npos)
+        event.m_devname = event.m_devname.substr(pos + 1);
+    bool isValid = !event.m_action.empty() && !event.m_devpath.empty();
+    return std::make_pair(event, isValid);
+}
+
+UEventMonitor::UEventMonitor(QObject *parent)
+    : QObject(parent)
+{
+    this->m_ueventFd = -1;
+    this->m_mountInfoFd = -1;
+    this->m_ueventNotifier = nullptr;
+    this->m_mountInfoNotifier = nullptr;
+}
+
+UEventMonitor::~UEventMonitor()
+{
+    this->stop();
+}
+
+bool UEventMonitor::start(const char *mountInfoFile)
+{
+#ifdef _WIN32
+    return false;
+#else
+    // stop previous
+    this->stop();
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_pid = 0;
+    // kernel broadcast group
+    addr.nl_groups = 1;
+    this->m_ueventFd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (this->m_ueventFd < 0) {
+        qDebug("create uevent socket failed: %s", strerror(errno));
+        return false;
+    }
+    if (bind(this->m_ueventFd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        qDebug("bind uevent socket failed: %s", strerror(errno));
+        close(this->m_ueventFd);
+        this->m_ueventFd = -1;
+        return false;
+    }
+    this->m_ueventNotifier = new QSocketNotifier(this->m_ueventFd, QSocketNotifier::Read, this);
+    QObject::connect(this->m_ueventNotifier, SIGNAL(activated(QSocketDescriptor, QSocketNotifier::Type)),
+                     this, SLOT(ueventSocketActivated()));
+
+    // mountinfo raises exception event when mount table changed
+    if (mountInfoFile) {
+        this->m_mountInfoFd = open(mountInfoFile, O_RDONLY | O_CLOEXEC);
+        if (this->m_mountInfoFd >= 0) {
+            this->m_mountInfoNotifier = new QSocketNotifier(this->m_mountInfoFd, QSocketNotifier::Exception, this);
+            QObject::connect(this->m_mountInfoNotifier, SIGNAL(activated(QSocketDescriptor, QSocketNotifier::Type)),
+                             this, SLOT(mountInfoActivated()));
+        } else {
+            qDebug("open %s failed: %s", mountInfoFile, strerror(errno));
+        }
+    }
+    return true;
+#endif
+}
+
+void UEventMonitor::stop()
+{
+#ifdef _WIN32
+#else
+    if (this->m_ueventNotifier) {
+        delete this->m_ueventNotifier;
+        this->m_ueventNotifier = nullptr;
+    }
+    if (this->m_mountInfoNotifier) {
+        delete this->m_mountInfoNotifier;
+        this->m_mountInfoNotifier = nullptr;
+    }
+    if (this->m_ueventFd >= 0) {
+        close(this->m_ueventFd);
+        this->m_ueventFd = -1;
+    }
+    if (this->m_mountInfoFd >= 0) {
+        close(this->m_mountInfoFd);
+        this->m_mountInfoFd = -1;
+    }
+#endif
+}
+
+bool UEventMonitor::handleMessage(const char *buff, size_t len)
+{
+    // check input
+    if (!buff || len == 0) {
+        qDebug("missing parameter");
+        return false;
+    }
+    if (strncmp(buff, UDEV_MONITOR_HEADER, strlen(UDEV_MONITOR_HEADER)) == 0)
+        return false;
+    auto ret = UEvent::parse(buff, len);
+    if (!ret.second)
+        return false;
+    UEvent event = ret.first;
+    if (event.getSubsystem().compare(UEVENT_SUBSYSTEM_USB) == 0) {
+        qDebug("uevent %s usb:%s", event.getAction().c_str(), event.getKernelName().c_str());
+        emit usbDeviceChanged(QString::fromStdString(event.getAction()),
+                              QString::fromStdString(event.getKernelName()));
+        return true;
+    }
+    if (event.getSubsystem().compare(UEVENT_SUBSYSTEM_BLOCK) != 0)
+        return false;
+    QString partition;
+    if (event.isPartition())
+        partition = QString::fromStdString(event.getDevName());
+    qDebug("uevent %s disk:%s partition:%s", event.getAction().c_str(),
+           event.getDiskName().c_str(), partition.toStdString().c_str());
+    emit blockDeviceChanged(QString::fromStdString(event.getAction()),
+                            QString::fromStdString(event.getDiskName()),
+                            partition);
+    return true;
+}
+
+void UEventMonitor::ueventSocketActivated()
+{
+#ifdef _WIN32
+#else
+    char buff[UEVENT_BUFF_SIZE];
+    // drain socket, several events arrive at once on insertion
+    while (true) {
+        ssize_t len = recv(this->m_ueventFd, buff, sizeof(buff) - 1, 0);
+        if (len <= 0)
+            break;
+        buff[len] = '\0';
+        this->handleMessage(buff, len);
+    }
+#endif
+}
+
+void UEventMonitor::mountInfoActivated()
+{
+#ifdef _WIN32
+#else
+    // read to end for clearing the event
+    char buff[UEVENT_BUFF_SIZE];
+    lseek(this->m_mountInfoFd, 0, SEEK_SET);
+    while (read(this->m_mountInfoFd, buff, sizeof(buff)) > 0) {
+    }
+#endif
+    emit mountTableChanged();
+}
@@ -0,0 +1,406 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <sstream>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#endif
+#include <QDebug>
+
+#include "./include/utility.h"
+#include "./include/usb_policy.h"
+
+#define USB_ROOT_HUB_PREFIX             "usb"
+#define USB_ATTRIBUTE_AUTHORIZED        "authorized"
+#define USB_ATTRIBUTE_AUTHORIZED_DEFAULT "authorized_default"
+#define USB_ATTRIBUTE_INTERFACE_AUTHORIZED_DEFAULT "interface_authorized_default"
+#define USB_ATTRIBUTE_DEVICE_CLASS      "bDeviceClass"
+#define USB_ATTRIBUTE_INTERFACE_CLASS   "bInterfaceClass"
+#define USB_ATTRIBUTE_VENDOR_ID         "idVendor"
+#define USB_ATTRIBUTE_PRODUCT_ID        "idProduct"
+#define USB_ATTRIBUTE_PRODUCT           "product"
+#define USB_RULES_END_LABEL             "settings_usb_policy_end"
+#define USB_RULES_GOTO_END              ", GOTO=\"" USB_RULES_END_LABEL "\"\n"
+
+static vector<string> split_usb_words(const string& text)
+{
+    string words = text;
+    std::replace(words.begin(), words.end(), ',', ' ');
+    vector<string> result;
+    stringstream stream(words);
+    string word;
+    while (stream >> word)
+        result.push_back(word);
+    return result;
+}
+
+set<int> parse_usb_classes(const string& text)
+{
+    set<int> classes;
+    for (auto &word : split_usb_words(text))
+    {
+        char *end = nullptr;
+        long value = strtol(word.c_str(), &end, 16);
+        if (end && *end == '\0' && value >= 0 && value <= 0xff)
+            classes.insert((int)value);
+    }
+    return classes;
+}
+
+string format_usb_classes(const set<int> &classes)
+{
+    string text;
+    char buff[8] = {0};
+    for (auto usbClass : classes)
+    {
+        snprintf(buff, sizeof(buff), "%02x", usbClass);
+        if (!text.empty())
+            text += " ";
+        text += buff;
+    }
+    return text;
+}
+
+set<string> parse_usb_ports(const string& text)
+{
+    vector<string> words = split_usb_words(text);
+    return set<string>(words.begin(), words.end());
+}
+
+string format_usb_ports(const set<string> &ports)
+{
+    string text;
+    for (auto &port : ports)
+    {
+        if (!text.empty())
+            text += " ";
+        text += port;
+    }
+    return text;
+}
+
+string format_usb_udev_rules(const UsbPolicy &policy)
+{
+    if (policy.isDeviceDefaultAuthorized() && policy.isInterfaceDefaultAuthorized())
+        return string();
+    const set<int> blockedClasses = policy.getBlockedClasses();
+    string classes = format_usb_classes(blockedClasses);
+    std::replace(classes.begin(), classes.end(), ' ', '|');
+    char hubClass[8] = {0};
+    snprintf(hubClass, sizeof(hubClass), "%02x", USB_CLASS_HUB);
+
+    string rules = "# generated by settings, do not edit\n";
+    rules += "ACTION!=\"add\"" USB_RULES_GOTO_END;
+    rules += "SUBSYSTEM!=\"usb\"" USB_RULES_GOTO_END;
+    // root hubs come first at boot, what is plugged later waits unauthorized for the rules below
+    rules += string("KERNEL==\"" USB_ROOT_HUB_PREFIX "[0-9]*\", ATTR{" USB_ATTRIBUTE_AUTHORIZED_DEFAULT "}=\"") +
+             (policy.isDeviceDefaultAuthorized() ? "1" : "0") + "\"\n";
+    rules += string("KERNEL==\"" USB_ROOT_HUB_PREFIX "[0-9]*\", TEST==\"" USB_ATTRIBUTE_INTERFACE_AUTHORIZED_DEFAULT
+                    "\", ATTR{" USB_ATTRIBUTE_INTERFACE_AUTHORIZED_DEFAULT "}=\"") +
+             (policy.isInterfaceDefaultAuthorized() ? "1" : "0") + "\"\n";
+    rules += "KERNEL==\"" USB_ROOT_HUB_PREFIX "[0-9]*\"" USB_RULES_GOTO_END;
+    // interfaces of kernels before 4.4 have no authorized
+    rules += "TEST!=\"" USB_ATTRIBUTE_AUTHORIZED "\"" USB_RULES_GOTO_END;
+    // same order as isAllowed, the first matching rule decides
+    for (auto &port : policy.getBlockedPorts())
+        rules += "KERNEL==\"" + port + "|" + port + ".*|" + port + ":*\", ATTR{" USB_ATTRIBUTE_AUTHORIZED "}=\"0\""
+                 USB_RULES_GOTO_END;
+    rules += string("ENV{DEVTYPE}==\"usb_device\", ATTR{" USB_ATTRIBUTE_DEVICE_CLASS "}==\"") + hubClass +
+             "\", ATTR{" USB_ATTRIBUTE_AUTHORIZED "}=\"1\"" USB_RULES_GOTO_END;
+    rules += string("ENV{DEVTYPE}==\"usb_interface\", ATTR{" USB_ATTRIBUTE_INTERFACE_CLASS "}==\"") + hubClass +
+             "\", ATTR{" USB_ATTRIBUTE_AUTHORIZED "}=\"1\"" USB_RULES_GOTO_END;
+    if (!policy.isEnabled()) {
+        rules += "ATTR{" USB_ATTRIBUTE_AUTHORIZED "}=\"0\"" USB_RULES_GOTO_END;
+    } else if (!classes.empty()) {
+        rules += "ENV{DEVTYPE}==\"usb_device\", ATTR{" USB_ATTRIBUTE_DEVICE_CLASS "}==\"" + classes +
+                 "\", ATTR{" USB_ATTRIBUTE_AUTHORIZED "}=\"0\"" USB_RULES_GOTO_END;
+        rules += "ENV{DEVTYPE}==\"usb_interface\", ATTR{" USB_ATTRIBUTE_INTERFACE_CLASS "}==\"" + classes +
+                 "\", ATTR{" USB_ATTRIBUTE_AUTHORIZED "}=\"0\"" USB_RULES_GOTO_END;
+    }
+    if (policy.isEnabled())
+        rules += "ATTR{" USB_ATTRIBUTE_AUTHORIZED "}=\"1\"\n";
+    rules += "LABEL=\"" USB_RULES_END_LABEL "\"\n";
+    return rules;
+}
+
+UsbPolicy::UsbPolicy()
+{
+    m_enabled = true;
+}
+
+void UsbPolicy::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+void UsbPolicy::setBlockedClasses(const set<int> &classes)
+{
+    m_blocked_classes = classes;
+}
+
+void UsbPolicy::setBlockedPorts(const set<string> &ports)
+{
+    m_blocked_ports = ports;
+}
+
+bool UsbPolicy::isEnabled() const
+{
+    return m_enabled;
+}
+
+set<int> UsbPolicy::getBlockedClasses() const
+{
+    return m_blocked_classes;
+}
+
+set<string> UsbPolicy::getBlockedPorts() const
+{
+    return m_blocked_ports;
+}
+
+bool UsbPolicy::isAllowed(const UsbDeviceInfo &info) const
+{
+    if (info.isRootHub)
+        return true;
+    // 1-1 covers 1-1 itself and 1-1.x behind a hub on it
+    for (auto &port : m_blocked_ports)
+    {
+        if (info.port.compare(port) == 0 || info.port.rfind(port + ".", 0) == 0)
+            return false;
+    }
+    if (info.usbClass == USB_CLASS_HUB)
+        return true;
+    if (!m_enabled)
+        return false;
+    return m_blocked_classes.find(info.usbClass) == m_blocked_classes.end();
+}
+
+bool UsbPolicy::isDeviceDefaultAuthorized() const
+{
+    return m_enabled && m_blocked_classes.empty() && m_blocked_ports.empty();
+}
+
+bool UsbPolicy::isInterfaceDefaultAuthorized() const
+{
+    // a blocked port never gets its device authorized, so only classes matter here
+    return m_enabled && m_blocked_classes.empty();
+}
+
+TPCUsbPolicyUtility::TPCUsbPolicyUtility(const char* sysfsFolder, const char* rulesFile)
+{
+    m_sysfsFolder = sysfsFolder ? sysfsFolder : USB_SYSFS_FOLDER;
+    m_rulesFile = rulesFile ? rulesFile : USB_POLICY_RULES_FILE;
+}
+
+vector<UsbDeviceInfo> TPCUsbPolicyUtility::get_devices()
+{
+    vector<UsbDeviceInfo> devices;
+#ifdef _WIN32
+#else
+    DIR *dir = opendir(m_sysfsFolder.c_str());
+    if (!dir) {
+        qDebug("open %s failed:%s", m_sysfsFolder.c_str(), strerror(errno));
+        return devices;
+    }
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+        const auto ret = get_device(entry->d_name);
+        if (ret.second)
+            devices.push_back(ret.first);
+    }
+    closedir(dir);
+#endif
+    // parents before children, so a device is authorized before its interfaces and hubs before what is behind
+    std::sort(devices.begin(), devices.end(), [](const UsbDeviceInfo &a, const UsbDeviceInfo &b) {
+        if (a.isRootHub != b.isRootHub)
+            return a.isRootHub;
+        if (a.isInterface != b.isInterface)
+            return !a.isInterface;
+        if (a.name.size() != b.name.size())
+            return a.name.size() < b.name.size();
+        return a.name < b.name;
+    });
+    return devices;
+}
+
+pair<UsbDeviceInfo, bool> TPCUsbPolicyUtility::get_device(const char* name)
+{
+    UsbDeviceInfo info;
+    // check input
+    if (!name || strlen(name) == 0) {
+        qDebug("missing parameter");
+        return make_pair(info, false);
+    }
+    info.name = name;
+    size_t colon = info.name.find(':');
+    info.isInterface = (colon != string::npos);
+    info.isRootHub = (info.name.rfind(USB_ROOT_HUB_PREFIX, 0) == 0);
+    info.port = info.isInterface ? info.name.substr(0, colon) : info.name;
+
+    const auto usbClass = _read_attribute(info.name, info.isInterface ? USB_ATTRIBUTE_INTERFACE_CLASS : USB_ATTRIBUTE_DEVICE_CLASS);
+    // removed meanwhile
+    if (!usbClass.second)
+        return make_pair(info, false);
+    info.usbClass = (int)strtol(usbClass.first.c_str(), nullptr, 16);
+    // interfaces of kernels before 4.4 have no authorized, treated as authorized
+    const auto authorized = _read_attribute(info.name, USB_ATTRIBUTE_AUTHORIZED);
+    info.authorized = !authorized.second || authorized.first.compare("0") != 0;
+    if (!info.isInterface) {
+        info.vendorId = _read_attribute(info.name, USB_ATTRIBUTE_VENDOR_ID).first;
+        info.productId = _read_attribute(info.name, USB_ATTRIBUTE_PRODUCT_ID).first;
+        info.product = _read_attribute(info.name, USB_ATTRIBUTE_PRODUCT).first;
+    }
+    return make_pair(info, true);
+}
+
+bool TPCUsbPolicyUtility::get_authorized_default()
+{
+    bool isAuthorized = true;
+    for (auto &device : get_devices())
+    {
+        if (!device.isRootHub || device.isInterface)
+            continue;
+        const auto ret = _read_attribute(device.name, USB_ATTRIBUTE_AUTHORIZED_DEFAULT);
+        if (ret.second && ret.first.compare("0") == 0)
+            isAuthorized = false;
+    }
+    return isAuthorized;
+}
+
+bool TPCUsbPolicyUtility::apply_policy(const UsbPolicy &policy)
+{
+    // new devices stay unauthorized until judged at the add uevent, so a blocked one never reaches a
+    // driver. udev judges them the same way while this app is not running and at the next boot
+    bool result = _write_rules(policy);
+    for (auto &device : get_devices())
+    {
+        if (!device.isRootHub || device.isInterface)
+            continue;
+        result &= _write_attribute(device.name, USB_ATTRIBUTE_AUTHORIZED_DEFAULT,
+                                   policy.isDeviceDefaultAuthorized() ? "1" : "0");
+        // kernels before 4.4 have no interface authorization
+        if (_read_attribute(device.name, USB_ATTRIBUTE_INTERFACE_AUTHORIZED_DEFAULT).second)
+            result &= _write_attribute(device.name, USB_ATTRIBUTE_INTERFACE_AUTHORIZED_DEFAULT,
+                                       policy.isInterfaceDefaultAuthorized() ? "1" : "0");
+    }
+    for (auto &device : get_devices())
+    {
+        if (!device.isInterface)
+            result &= _set_authorized(device, policy.isAllowed(device));
+    }
+    // interfaces of devices authorized above only exist now
+    for (auto &device : get_devices())
+    {
+        if (device.isInterface)
+            result &= _set_authorized(device, policy.isAllowed(device));
+    }
+    return result;
+}
+
+bool TPCUsbPolicyUtility::apply_policy(const UsbPolicy &policy, const char* name)
+{
+    const auto ret = get_device(name);
+    if (!ret.second)
+        return false;
+    const UsbDeviceInfo &info = ret.first;
+    bool isAllowed = policy.isAllowed(info);
+    bool result = _set_authorized(info, isAllowed);
+    // the kernel creates the interfaces while authorized is written, their own add
+    // uevents come later and find them judged already
+    if (result && isAllowed && !info.isInterface && !info.isRootHub)
+        result &= _set_interfaces_authorized(policy, info.name);
+    return result;
+}
+
+pair<string, bool> TPCUsbPolicyUtility::_read_attribute(const string& name, const char* attribute)
+{
+    string value;
+#ifdef _WIN32
+    return make_pair(value, false);
+#else
+    string path = m_sysfsFolder + "/" + name + "/" + attribute;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return make_pair(value, false);
+    char buff[BUFF_SIZE] = {0};
+    ssize_t size = read(fd, buff, sizeof(buff) - 1);
+    close(fd);
+    if (size < 0)
+        return make_pair(value, false);
+    value.assign(buff, size);
+    while (!value.empty() && (value.back() == '\n' || value.back() == ' '))
+        value.pop_back();
+    return make_pair(value, true);
+#endif
+}
+
+bool TPCUsbPolicyUtility::_write_attribute(const string& name, const char* attribute, const char* value)
+{
+#ifdef _WIN32
+    return false;
+#else
+    string path = m_sysfsFolder + "/" + name + "/" + attribute;
+    int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        qDebug("open %s failed:%s", path.c_str(), strerror(errno));
+        return false;
+    }
+    ssize_t size = write(fd, value, strlen(value));
+    int error = errno;
+    close(fd);
+    if (size != (ssize_t)strlen(value)) {
+        qDebug("write %s to %s failed:%s", value, path.c_str(), strerror(error));
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool TPCUsbPolicyUtility::_set_interfaces_authorized(const UsbPolicy &policy, const string& port)
+{
+    bool result = true;
+    for (auto &device : get_devices())
+    {
+        if (device.isInterface && device.port.compare(port) == 0)
+            result &= _set_authorized(device, policy.isAllowed(device));
+    }
+    return result;
+}
+
+bool TPCUsbPolicyUtility::_write_rules(const UsbPolicy &policy)
+{
+    const string rules = format_usb_udev_rules(policy);
+    if (!rules.empty())
+        return write_file_atomic(m_rulesFile.c_str(), rules.c_str());
+#ifdef _WIN32
+    return false;
+#else
+    // kernel defaults are enough, nothing left to keep
+    if (unlink(m_rulesFile.c_str()) != 0 && errno != ENOENT) {
+        qDebug("remove %s failed:%s", m_rulesFile.c_str(), strerror(errno));
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool TPCUsbPolicyUtility::_set_authorized(const UsbDeviceInfo &info, bool authorized)
+{
+    if (info.authorized == authorized)
+        return true;
+    qDebug("usb %s %s:%s class %02x %s", info.name.c_str(), info.vendorId.c_str(), info.productId.c_str(),
+           info.usbClass, authorized ? "authorized" : "blocked");
+    // the driver is unbound as soon as this is written
+    return _write_attribute(info.name, USB_ATTRIBUTE_AUTHORIZED, authorized ? "1" : "0");
+}
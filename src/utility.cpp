@@ -3,11 +3,19 @@
 
 #include <array>
 #include <set>
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <cstdlib>
 #include <sstream>
 #include <regex>
 #ifdef _WIN32
 #else
 #include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <sys/stat.h>
 #endif
 #include <QFileInfo>
 #include <QDir>
@@ -296,6 +304,77 @@ bool write_file(const char *filename, const char *context)
 #endif
 }
 
+// write to a temp file in the same folder then rename, readers never see a partial file
+bool write_file_atomic(const char *filename, const char *context)
+{
+    // check input
+    if (!context)
+        return false;
+    return write_file_atomic(filename, context, strlen(context));
+}
+
+bool write_file_atomic(const char *filename, const char *data, size_t length)
+{
+#ifdef _WIN32
+    return true;
+#else
+    // check input
+    if (!filename || (!data && length > 0))
+        return false;
+    if (strlen(filename) == 0)
+        return false;
+
+    // replace the symlink target instead of the symlink, ex: /etc/localtime style links
+    string targetFilename = filename;
+    char resolved[PATH_MAX] = {0};
+    if (realpath(filename, resolved))
+        targetFilename = resolved;
+    // unique temp name, concurrent writers must not share one temp file
+    string tmpFilename = targetFilename + ".XXXXXX";
+    // keep permission of the original file
+    mode_t mode = 0644;
+    struct stat fileStat;
+    if (stat(targetFilename.c_str(), &fileStat) == 0)
+        mode = fileStat.st_mode & 07777;
+    int fd = mkostemp(&tmpFilename[0], O_CLOEXEC);
+    if (fd < 0)
+    {
+        qDebug("Cannot open file for writing::%s", tmpFilename.c_str());
+        return false;
+    }
+    fchmod(fd, mode);
+    size_t written = 0;
+    while (written < length)
+    {
+        ssize_t ret = write(fd, data + written, length - written);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        written += ret;
+    }
+    bool result = (written == length) && (fsync(fd) == 0);
+    close(fd);
+    if (!result || rename(tmpFilename.c_str(), targetFilename.c_str()) != 0)
+    {
+        qDebug("Cannot write file::%s", filename);
+        unlink(tmpFilename.c_str());
+        return false;
+    }
+    // persist the rename itself
+    string folder = targetFilename;
+    int dirFd = open(dirname(&folder[0]), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return true;
+#endif
+}
+
 void sys_mkdir(const char *path)
 {
 #ifdef _WIN32
@@ -0,0 +1,6 @@
+include(../tests.pri)
+TARGET = tst_boot_environment
+
+SOURCES += tst_boot_environment.cpp \
+    $$SRC_FOLDER/boot_environment.cpp \
+    $$SRC_FOLDER/utility.cpp
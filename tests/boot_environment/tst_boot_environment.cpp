@@ -0,0 +1,267 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "test_utility.h"
+#include "boot_environment.h"
+
+using namespace std;
+
+#define CMDLINE_SD_CARD         "console=ttymxc0,115200 root=/dev/mmcblk1p2 rootwait rw\n"
+#define CMDLINE_EMMC            "console=ttymxc0,115200 root=/dev/mmcblk2p3 rootfstype=ext4 rootwait ro\n"
+// read-only mode: the ext4 root stays read-only below an overlay on /
+#define MOUNTINFO_READ_ONLY     "22 1 179:3 / / ro,relatime shared:1 - ext4 /dev/mmcblk2p3 ro\n" \
+                                "23 22 0:5 / /dev rw,relatime shared:2 - devtmpfs devtmpfs rw,size=500000k\n" \
+                                "30 22 0:26 / /media/rw rw,relatime shared:9 - tmpfs tmpfs rw\n" \
+                                "31 1 0:27 / / rw,relatime shared:10 - overlay overlay rw,lowerdir=/,upperdir=/media/rw/upper,workdir=/media/rw/work\n"
+#define MOUNTINFO_READ_WRITE    "22 1 179:26 / / rw,noatime - ext4 /dev/mmcblk1p2 rw\n" \
+                                "23 22 0:5 / /dev rw,relatime shared:2 - devtmpfs devtmpfs rw\n"
+#define MOUNTINFO_NO_ROOT       "23 22 0:5 / /dev rw,relatime shared:2 - devtmpfs devtmpfs rw\n"
+
+// fixture /proc/cmdline and /proc/self/mountinfo files
+class TestBootEnvironment : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testCmdlineValue();
+    void testCmdlineValueLastWins();
+    void testCmdlineValueMissing();
+    void testReadWriteRoot();
+    void testReadOnlyOverlayRoot();
+    void testReadOnlyRootWithoutOverlay();
+    void testPartUuidRoot();
+    void testNoRootMount();
+    void testMissingCmdline();
+    void testMissingMountInfo();
+    void testCachedUntilInvalidate();
+    void testIsRootOnDisk();
+    void testPendingReadonlyMode();
+    void testPendingReadonlyModeAcrossProbes();
+    void testPendingReadonlyModeInvalid();
+
+private:
+    void _write(const char* cmdline, const char* mountInfo);
+
+    QTemporaryDir m_folder;
+    string m_cmdlineFile;
+    string m_mountInfoFile;
+    string m_runFolder;
+    string m_readonlyPendingFile;
+};
+
+void TestBootEnvironment::init()
+{
+    QVERIFY(m_folder.isValid());
+    const string folder = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    m_cmdlineFile = folder + "/proc/cmdline";
+    m_mountInfoFile = folder + "/proc/self/mountinfo";
+    m_runFolder = folder + "/run";
+    m_readonlyPendingFile = m_runFolder + "/settings-readonly-pending";
+}
+
+void TestBootEnvironment::_write(const char* cmdline, const char* mountInfo)
+{
+    if (cmdline)
+        QVERIFY(write_test_file(m_cmdlineFile, cmdline));
+    if (mountInfo)
+        QVERIFY(write_test_file(m_mountInfoFile, mountInfo));
+}
+
+void TestBootEnvironment::testCmdlineValue()
+{
+    QCOMPARE(get_cmdline_value(CMDLINE_EMMC, CMDLINE_KEY_ROOT), make_pair(string("/dev/mmcblk2p3"), true));
+    QCOMPARE(get_cmdline_value(CMDLINE_EMMC, "rootfstype"), make_pair(string("ext4"), true));
+    QCOMPARE(get_cmdline_value(CMDLINE_EMMC, "console"), make_pair(string("ttymxc0,115200"), true));
+    // the value keeps later '='
+    QCOMPARE(get_cmdline_value("root=PARTUUID=0e3f-02 rootwait", CMDLINE_KEY_ROOT),
+             make_pair(string("PARTUUID=0e3f-02"), true));
+    QCOMPARE(get_cmdline_value("quiet root= rootwait", CMDLINE_KEY_ROOT), make_pair(string(), true));
+}
+
+void TestBootEnvironment::testCmdlineValueLastWins()
+{
+    QCOMPARE(get_cmdline_value("root=/dev/mmcblk2p2 quiet root=/dev/mmcblk2p3", CMDLINE_KEY_ROOT),
+             make_pair(string("/dev/mmcblk2p3"), true));
+}
+
+void TestBootEnvironment::testCmdlineValueMissing()
+{
+    // rootwait and rootfstype= only start with the key
+    QCOMPARE(get_cmdline_value("rootwait rootfstype=ext4 ro", CMDLINE_KEY_ROOT).second, false);
+    QCOMPARE(get_cmdline_value("", CMDLINE_KEY_ROOT).second, false);
+    QCOMPARE(get_cmdline_value(CMDLINE_EMMC, nullptr).second, false);
+}
+
+void TestBootEnvironment::testReadWriteRoot()
+{
+    _write(CMDLINE_SD_CARD, MOUNTINFO_READ_WRITE);
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    auto ret = probe.get();
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.rootDevice, string("mmcblk1p2"));
+    QCOMPARE(ret.first.rootFsType, string("ext4"));
+    QCOMPARE(ret.first.rootSource, string("/dev/mmcblk1p2"));
+    QVERIFY(!ret.first.isRootOverlay);
+    QVERIFY(!ret.first.isRootReadOnly);
+}
+
+void TestBootEnvironment::testReadOnlyOverlayRoot()
+{
+    _write(CMDLINE_EMMC, MOUNTINFO_READ_ONLY);
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    auto ret = probe.get();
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.rootDevice, string("mmcblk2p3"));
+    // the overlay is mounted last and covers the ext4 root
+    QCOMPARE(ret.first.rootFsType, string(ROOT_FSTYPE_OVERLAY));
+    QCOMPARE(ret.first.rootSource, string("overlay"));
+    QVERIFY(ret.first.isRootOverlay);
+    QVERIFY(!ret.first.isRootReadOnly);
+}
+
+void TestBootEnvironment::testReadOnlyRootWithoutOverlay()
+{
+    // mount options only, no optional fields before the separator
+    _write(CMDLINE_EMMC, "22 1 179:3 / / ro - ext4 /dev/mmcblk2p3 ro\n");
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    auto ret = probe.get();
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.rootFsType, string("ext4"));
+    QVERIFY(!ret.first.isRootOverlay);
+    QVERIFY(ret.first.isRootReadOnly);
+
+    _write(nullptr, "22 1 179:3 / / ro,relatime - ext4 /dev/mmcblk2p3 ro\n");
+    probe.invalidate();
+    QVERIFY(probe.get().first.isRootReadOnly);
+}
+
+void TestBootEnvironment::testPartUuidRoot()
+{
+    _write("root=PARTUUID=0e3f-02 rootwait\n", MOUNTINFO_READ_WRITE);
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    auto ret = probe.get();
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.rootDevice, string("PARTUUID=0e3f-02"));
+    QVERIFY(!probe.is_root_on_disk("mmcblk1"));
+}
+
+void TestBootEnvironment::testNoRootMount()
+{
+    _write(CMDLINE_SD_CARD, MOUNTINFO_NO_ROOT);
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    auto ret = probe.get();
+    QVERIFY(!ret.second);
+    // the command line part is still filled
+    QCOMPARE(ret.first.rootDevice, string("mmcblk1p2"));
+    QVERIFY(!ret.first.isRootReadOnly);
+}
+
+void TestBootEnvironment::testMissingCmdline()
+{
+    _write(nullptr, MOUNTINFO_READ_WRITE);
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    QVERIFY(!probe.get().second);
+    QVERIFY(!probe.is_root_on_disk("mmcblk1"));
+}
+
+void TestBootEnvironment::testMissingMountInfo()
+{
+    _write(CMDLINE_SD_CARD, nullptr);
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    QVERIFY(!probe.get().second);
+}
+
+void TestBootEnvironment::testCachedUntilInvalidate()
+{
+    _write(CMDLINE_SD_CARD, MOUNTINFO_READ_WRITE);
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    QCOMPARE(probe.get().first.rootDevice, string("mmcblk1p2"));
+    _write(CMDLINE_EMMC, MOUNTINFO_READ_ONLY);
+    QCOMPARE(probe.get().first.rootDevice, string("mmcblk1p2"));
+    QVERIFY(!probe.get().first.isRootOverlay);
+    probe.invalidate();
+    QCOMPARE(probe.get().first.rootDevice, string("mmcblk2p3"));
+    QVERIFY(probe.get().first.isRootOverlay);
+}
+
+void TestBootEnvironment::testIsRootOnDisk()
+{
+    _write(CMDLINE_SD_CARD, MOUNTINFO_READ_WRITE);
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str());
+    QVERIFY(probe.is_root_on_disk("mmcblk1"));
+    QVERIFY(!probe.is_root_on_disk("mmcblk2"));
+    QVERIFY(!probe.is_root_on_disk(""));
+    QVERIFY(!probe.is_root_on_disk(nullptr));
+
+    _write("root=/dev/mmcblk10p2\n", nullptr);
+    probe.invalidate();
+    QVERIFY(!probe.is_root_on_disk("mmcblk1"));
+    QVERIFY(probe.is_root_on_disk("mmcblk10"));
+
+    _write("root=/dev/sda1\n", nullptr);
+    probe.invalidate();
+    QVERIFY(probe.is_root_on_disk("sda"));
+    QVERIFY(!probe.is_root_on_disk("sd"));
+
+    // the whole disk as root
+    _write("root=/dev/nvme0n1\n", nullptr);
+    probe.invalidate();
+    QVERIFY(probe.is_root_on_disk("nvme0n1"));
+    QVERIFY(!probe.is_root_on_disk("nvme0"));
+}
+
+void TestBootEnvironment::testPendingReadonlyMode()
+{
+    _write(CMDLINE_EMMC, MOUNTINFO_READ_WRITE);
+    QVERIFY(QDir().mkpath(QString::fromStdString(m_runFolder)));
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str(), m_readonlyPendingFile.c_str());
+    // nothing set since the boot
+    QCOMPARE(probe.get_pending_readonly_mode(), make_pair(false, false));
+
+    QVERIFY(probe.set_pending_readonly_mode(true));
+    QCOMPARE(probe.get_pending_readonly_mode(), make_pair(true, true));
+    QCOMPARE(read_test_file(m_readonlyPendingFile), string("1\n"));
+    // the mounts are untouched until the reboot
+    QVERIFY(!probe.get().first.isRootReadOnly);
+
+    QVERIFY(probe.set_pending_readonly_mode(false));
+    QCOMPARE(probe.get_pending_readonly_mode(), make_pair(false, true));
+}
+
+void TestBootEnvironment::testPendingReadonlyModeAcrossProbes()
+{
+    // a restarted settings sees what the previous one set
+    QVERIFY(QDir().mkpath(QString::fromStdString(m_runFolder)));
+    {
+        BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str(), m_readonlyPendingFile.c_str());
+        QVERIFY(probe.set_pending_readonly_mode(true));
+    }
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str(), m_readonlyPendingFile.c_str());
+    QCOMPARE(probe.get_pending_readonly_mode(), make_pair(true, true));
+
+    // the tmpfs is empty again after the reboot
+    QVERIFY(QFile::remove(QString::fromStdString(m_readonlyPendingFile)));
+    QCOMPARE(probe.get_pending_readonly_mode(), make_pair(false, false));
+}
+
+void TestBootEnvironment::testPendingReadonlyModeInvalid()
+{
+    BootEnvironmentProbe probe(m_cmdlineFile.c_str(), m_mountInfoFile.c_str(), m_readonlyPendingFile.c_str());
+    QVERIFY(write_test_file(m_readonlyPendingFile, "yes\n"));
+    QCOMPARE(probe.get_pending_readonly_mode(), make_pair(false, false));
+    QVERIFY(write_test_file(m_readonlyPendingFile, ""));
+    QCOMPARE(probe.get_pending_readonly_mode(), make_pair(false, false));
+
+    // the folder is missing
+    BootEnvironmentProbe missing(m_cmdlineFile.c_str(), m_mountInfoFile.c_str(),
+                                 (m_readonlyPendingFile + ".d/pending").c_str());
+    QVERIFY(!missing.set_pending_readonly_mode(true));
+    QCOMPARE(missing.get_pending_readonly_mode(), make_pair(false, false));
+}
+
+QTEST_GUILESS_MAIN(TestBootEnvironment)
+#include "tst_boot_environment.moc"
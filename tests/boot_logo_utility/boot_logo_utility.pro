@@ -0,0 +1,8 @@
+include(../tests.pri)
+# QImage decodes the selected logo
+QT += gui
+TARGET = tst_boot_logo_utility
+
+SOURCES += tst_boot_logo_utility.cpp \
+    $$SRC_FOLDER/boot_logo_utility.cpp \
+    $$SRC_FOLDER/utility.cpp
@@ -0,0 +1,400 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "test_utility.h"
+#include "boot_logo_utility.h"
+
+// golden files in data/, rewritten when this is set after an intended change
+#define UPDATE_GOLDEN_ENV           "BOOT_LOGO_UPDATE_GOLDEN"
+#define GOLDEN_FIT_FILE             "golden_fit_64x48.bmp"
+#define GOLDEN_APPLY_RGB565_FILE    "golden_apply_rgb565_64x48.bmp"
+#define TEST_PANEL_WIDTH            64
+#define TEST_PANEL_HEIGHT           48
+#define TEST_BG_COLOR               "0x2050a0"
+#define TEST_BG_COLOR_VALUE         0x2050a0
+
+class TestBootLogoUtility : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testResampleUniform();
+    void testResampleMatchesReference();
+    void testResampleRejectsUpscale();
+    void testFitKeepsSmallLogo();
+    void testFitBlendsAlpha();
+    void testQuantizeRGB565Levels();
+    void testEncodeBmp24();
+    void testFramebufferModes();
+    void testFramebufferVirtualSize();
+    void testGoldenFit();
+    void testGoldenApplyRGB565();
+    void testApplyKeepsColor();
+    void testApplyInvalidColor();
+    void testApplyMissingImage();
+    void testApplyReplacesExisting();
+
+private:
+    // gradient with a checker in red, alpha is a soft edged disc when isAlpha
+    BootLogoImage _create_pattern(int width, int height, bool isAlpha);
+    bool _decode_bmp24(const string& content, BootLogoImage &image);
+    // largest channel difference, -1 on size mismatch
+    int _max_difference(const BootLogoImage &first, const BootLogoImage &second);
+    void _compare_golden(const string& fileName, const string& content, int tolerance);
+    int _count_entries(const string& folder);
+
+    string m_root;
+    string m_logoPath;
+    string m_psplashConfigFile;
+    string m_framebufferFolder;
+    QTemporaryDir m_folder;
+};
+
+void TestBootLogoUtility::init()
+{
+    QVERIFY(m_folder.isValid());
+    m_root = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    m_logoPath = m_root + "/etc/boot_logo.bmp";
+    m_psplashConfigFile = m_root + "/etc/psplash.conf";
+    m_framebufferFolder = m_root + "/sys/class/graphics/fb0";
+    QVERIFY(write_test_file(m_psplashConfigFile, "# psplash\nBACKGROUND_COLOR=0x000000\nPROGRESS=1\n"));
+    // virtual_size is doubled for panning, the mode is the panel
+    QVERIFY(write_test_file(m_framebufferFolder + "/modes", "U:64x48p-60\n"));
+    QVERIFY(write_test_file(m_framebufferFolder + "/virtual_size", "64,96\n"));
+    QVERIFY(write_test_file(m_framebufferFolder + "/bits_per_pixel", "16\n"));
+}
+
+BootLogoImage TestBootLogoUtility::_create_pattern(int width, int height, bool isAlpha)
+{
+    BootLogoImage image(width, height);
+    double radius = min(width, height) / 2.0;
+    for (int y = 0; y < height; y++)
+    {
+        unsigned char *pixel = image.getPixels() + (size_t)y * image.getStride();
+        for (int x = 0; x < width; x++)
+        {
+            pixel[0] = (unsigned char)(x * 255 / max(1, width - 1));
+            pixel[1] = (unsigned char)(y * 255 / max(1, height - 1));
+            pixel[2] = ((x / 8 + y / 8) & 1) ? 230 : 20;
+            pixel[3] = 255;
+            if (isAlpha)
+            {
+                double distance = hypot(x - width / 2.0, y - height / 2.0);
+                double alpha = min(max((radius - distance) / 8.0, 0.0), 1.0);
+                pixel[3] = (unsigned char)lround(alpha * 255);
+            }
+            pixel += 4;
+        }
+    }
+    return image;
+}
+
+bool TestBootLogoUtility::_decode_bmp24(const string& content, BootLogoImage &image)
+{
+    auto le32 = [&content](size_t offset) {
+        return (int)((unsigned char)content[offset] | (unsigned char)content[offset + 1] << 8 |
+                     (unsigned char)content[offset + 2] << 16 | (unsigned char)content[offset + 3] << 24);
+    };
+    if (content.size() < 54 || content.compare(0, 2, "BM") != 0)
+        return false;
+    int offset = le32(10);
+    int width = le32(18);
+    int height = le32(22);
+    int rowSize = (width * 3 + 3) & ~3;
+    if (width <= 0 || height <= 0 || content.size() < (size_t)offset + (size_t)rowSize * height)
+        return false;
+    image = BootLogoImage(width, height);
+    for (int y = 0; y < height; y++)
+    {
+        const char *from = content.data() + offset + (size_t)(height - 1 - y) * rowSize;
+        unsigned char *to = image.getPixels() + (size_t)y * image.getStride();
+        for (int x = 0; x < width; x++)
+        {
+            memcpy(to, from, 3);
+            to[3] = 0xff;
+            from += 3;
+            to += 4;
+        }
+    }
+    return true;
+}
+
+int TestBootLogoUtility::_max_difference(const BootLogoImage &first, const BootLogoImage &second)
+{
+    if (first.getWidth() != second.getWidth() || first.getHeight() != second.getHeight())
+        return -1;
+    int difference = 0;
+    for (size_t i = 0; i < (size_t)first.getStride() * first.getHeight(); i++)
+    {
+        difference = max(difference, abs((int)first.getPixels()[i] - (int)second.getPixels()[i]));
+    }
+    return difference;
+}
+
+void TestBootLogoUtility::_compare_golden(const string& fileName, const string& content, int tolerance)
+{
+    QString dataFolder = QFINDTESTDATA("data");
+    QVERIFY(!dataFolder.isEmpty());
+    string goldenPath = dataFolder.toStdString() + "/" + fileName;
+    if (getenv(UPDATE_GOLDEN_ENV))
+    {
+        QVERIFY(write_test_file(goldenPath, content));
+        qDebug("golden file updated:%s", goldenPath.c_str());
+    }
+    BootLogoImage golden, actual;
+    QVERIFY(_decode_bmp24(read_test_file(goldenPath), golden));
+    QVERIFY(_decode_bmp24(content, actual));
+    int difference = _max_difference(golden, actual);
+    QVERIFY(difference >= 0);
+    QVERIFY(difference <= tolerance);
+}
+
+void TestBootLogoUtility::testResampleUniform()
+{
+    BootLogoImage source(101, 67);
+    for (size_t i = 0; i < (size_t)source.getStride() * source.getHeight(); i += 4)
+    {
+        memcpy(source.getPixels() + i, "\x30\x90\xe0\xff", 4);
+    }
+    BootLogoImage target(33, 20);
+    QVERIFY(resample_area(source, target));
+    for (size_t i = 0; i < (size_t)target.getStride() * target.getHeight(); i += 4)
+    {
+        QCOMPARE(memcmp(target.getPixels() + i, "\x30\x90\xe0\xff", 4), 0);
+    }
+}
+
+void TestBootLogoUtility::testResampleMatchesReference()
+{
+    // wide enough for the simd path and a scalar tail
+    BootLogoImage source = _create_pattern(203, 131, true);
+    BootLogoImage target(61, 40);
+    QVERIFY(resample_area(source, target));
+    // plain double precision box filter
+    double scaleX = (double)source.getWidth() / target.getWidth();
+    double scaleY = (double)source.getHeight() / target.getHeight();
+    BootLogoImage reference(target.getWidth(), target.getHeight());
+    for (int y = 0; y < target.getHeight(); y++)
+    {
+        for (int x = 0; x < target.getWidth(); x++)
+        {
+            double total[4] = {0};
+            for (int sy = (int)floor(y * scaleY); sy < min((int)ceil((y + 1) * scaleY), source.getHeight()); sy++)
+            {
+                double coverY = min((y + 1) * scaleY, sy + 1.0) - max(y * scaleY, (double)sy);
+                for (int sx = (int)floor(x * scaleX); sx < min((int)ceil((x + 1) * scaleX), source.getWidth()); sx++)
+                {
+                    double coverX = min((x + 1) * scaleX, sx + 1.0) - max(x * scaleX, (double)sx);
+                    const unsigned char *pixel = source.getPixels() + (size_t)sy * source.getStride() + sx * 4;
+                    for (int channel = 0; channel < 4; channel++)
+                    {
+                        total[channel] += pixel[channel] * coverX * coverY;
+                    }
+                }
+            }
+            unsigned char *pixel = reference.getPixels() + (size_t)y * reference.getStride() + x * 4;
+            for (int channel = 0; channel < 4; channel++)
+            {
+                pixel[channel] = (unsigned char)lround(total[channel] / (scaleX * scaleY));
+            }
+        }
+    }
+    QVERIFY(_max_difference(target, reference) <= 1);
+}
+
+void TestBootLogoUtility::testResampleRejectsUpscale()
+{
+    BootLogoImage source(10, 10);
+    BootLogoImage target(20, 5);
+    QVERIFY(!resample_area(source, target));
+}
+
+void TestBootLogoUtility::testFitKeepsSmallLogo()
+{
+    BootLogoImage source = _create_pattern(20, 10, false);
+    BootLogoImage canvas;
+    QVERIFY(fit_on_canvas(source, TEST_BG_COLOR_VALUE, TEST_PANEL_WIDTH, TEST_PANEL_HEIGHT, canvas));
+    QCOMPARE(canvas.getWidth(), TEST_PANEL_WIDTH);
+    QCOMPARE(canvas.getHeight(), TEST_PANEL_HEIGHT);
+    // centered without scaling
+    int left = (TEST_PANEL_WIDTH - 20) / 2;
+    int top = (TEST_PANEL_HEIGHT - 10) / 2;
+    for (int y = 0; y < 10; y++)
+    {
+        QCOMPARE(memcmp(canvas.getPixels() + (size_t)(top + y) * canvas.getStride() + left * 4,
+                        source.getPixels() + (size_t)y * source.getStride(), source.getStride()), 0);
+    }
+    // b, g, r of the background in the corners
+    QCOMPARE(memcmp(canvas.getPixels(), "\xa0\x50\x20\xff", 4), 0);
+    QCOMPARE(memcmp(canvas.getPixels() + (size_t)canvas.getStride() * TEST_PANEL_HEIGHT - 4, "\xa0\x50\x20\xff", 4), 0);
+}
+
+void TestBootLogoUtility::testFitBlendsAlpha()
+{
+    BootLogoImage source(1, 1);
+    // white at half alpha over black
+    memcpy(source.getPixels(), "\xff\xff\xff\x80", 4);
+    BootLogoImage canvas;
+    QVERIFY(fit_on_canvas(source, 0x000000, 1, 1, canvas));
+    QCOMPARE((int)canvas.getPixels()[0], 128);
+    QCOMPARE((int)canvas.getPixels()[1], 128);
+    QCOMPARE((int)canvas.getPixels()[2], 128);
+    QCOMPARE((int)canvas.getPixels()[3], 255);
+}
+
+void TestBootLogoUtility::testQuantizeRGB565Levels()
+{
+    BootLogoImage image = _create_pattern(37, 23, false);
+    quantize_rgb565(image);
+    const int levels[3] = { 31, 63, 31 };
+    for (size_t i = 0; i < (size_t)image.getStride() * image.getHeight(); i += 4)
+    {
+        for (int channel = 0; channel < 3; channel++)
+        {
+            int value = image.getPixels()[i + channel];
+            int level = (value * levels[channel] + 127) / 255;
+            // every channel is exactly one of the panel levels
+            QCOMPARE(value, (level * 255 + levels[channel] / 2) / levels[channel]);
+        }
+    }
+}
+
+void TestBootLogoUtility::testEncodeBmp24()
+{
+    BootLogoImage image = _create_pattern(5, 3, false);
+    string bmp = encode_bmp24(image);
+    // rows are padded to 4 bytes, 5 * 3 -> 16
+    QCOMPARE(bmp.size(), (size_t)(54 + 16 * 3));
+    QCOMPARE(bmp.substr(0, 2), string("BM"));
+    BootLogoImage decoded;
+    QVERIFY(_decode_bmp24(bmp, decoded));
+    QCOMPARE(_max_difference(image, decoded), 0);
+}
+
+void TestBootLogoUtility::testFramebufferModes()
+{
+    TPCBootLogoUtility bootLogoUtil(m_logoPath.c_str(), m_psplashConfigFile.c_str(), m_framebufferFolder.c_str());
+    int width = 0, height = 0, bitsPerPixel = 0;
+    QVERIFY(bootLogoUtil.get_framebuffer_info(width, height, bitsPerPixel));
+    QCOMPARE(width, TEST_PANEL_WIDTH);
+    QCOMPARE(height, TEST_PANEL_HEIGHT);
+    QCOMPARE(bitsPerPixel, FRAMEBUFFER_RGB565_BPP);
+}
+
+void TestBootLogoUtility::testFramebufferVirtualSize()
+{
+    unlink((m_framebufferFolder + "/modes").c_str());
+    TPCBootLogoUtility bootLogoUtil(m_logoPath.c_str(), m_psplashConfigFile.c_str(), m_framebufferFolder.c_str());
+    int width = 0, height = 0, bitsPerPixel = 0;
+    QVERIFY(bootLogoUtil.get_framebuffer_info(width, height, bitsPerPixel));
+    QCOMPARE(width, 64);
+    QCOMPARE(height, 96);
+}
+
+void TestBootLogoUtility::testGoldenFit()
+{
+    // scaled down with alpha, float sums may round one step apart between simd and scalar builds
+    BootLogoImage canvas;
+    QVERIFY(fit_on_canvas(_create_pattern(300, 200, true), TEST_BG_COLOR_VALUE,
+                          TEST_PANEL_WIDTH, TEST_PANEL_HEIGHT, canvas));
+    _compare_golden(GOLDEN_FIT_FILE, encode_bmp24(canvas), 1);
+}
+
+void TestBootLogoUtility::testGoldenApplyRGB565()
+{
+    // not scaled, so the dithered result is exact on every architecture
+    string imagePath = m_root + "/logo.bmp";
+    QVERIFY(write_test_file(imagePath, encode_bmp24(_create_pattern(40, 24, false))));
+    TPCBootLogoUtility bootLogoUtil(m_logoPath.c_str(), m_psplashConfigFile.c_str(), m_framebufferFolder.c_str());
+    auto ret = bootLogoUtil.apply_boot_logo(imagePath.c_str(), TEST_BG_COLOR);
+    QVERIFY(ret.second);
+    _compare_golden(GOLDEN_APPLY_RGB565_FILE, read_test_file(m_logoPath), 0);
+    QCOMPARE(read_test_file(m_psplashConfigFile),
+             string("# psplash\nBACKGROUND_COLOR=" TEST_BG_COLOR "\nPROGRESS=1\n"));
+    QCOMPARE(bootLogoUtil.get_background_color().first, string(TEST_BG_COLOR));
+    // no temp file is left next to the logo and the config
+    QCOMPARE(_count_entries(m_root + "/etc"), 2);
+}
+
+void TestBootLogoUtility::testApplyKeepsColor()
+{
+    string imagePath = m_root + "/logo.bmp";
+    QVERIFY(write_test_file(imagePath, encode_bmp24(_create_pattern(8, 8, false))));
+    TPCBootLogoUtility bootLogoUtil(m_logoPath.c_str(), m_psplashConfigFile.c_str(), m_framebufferFolder.c_str());
+    QVERIFY(bootLogoUtil.apply_boot_logo(imagePath.c_str(), "").second);
+    QCOMPARE(bootLogoUtil.get_background_color().first, string("0x000000"));
+    BootLogoImage logo;
+    QVERIFY(_decode_bmp24(read_test_file(m_logoPath), logo));
+    QCOMPARE(logo.getWidth(), TEST_PANEL_WIDTH);
+    QCOMPARE(memcmp(logo.getPixels(), "\x00\x00\x00\xff", 4), 0);
+}
+
+void TestBootLogoUtility::testApplyInvalidColor()
+{
+    string imagePath = m_root + "/logo.bmp";
+    QVERIFY(write_test_file(imagePath, encode_bmp24(_create_pattern(8, 8, false))));
+    TPCBootLogoUtility bootLogoUtil(m_logoPath.c_str(), m_psplashConfigFile.c_str(), m_framebufferFolder.c_str());
+    QVERIFY(!bootLogoUtil.apply_boot_logo(imagePath.c_str(), "#2050a0").second);
+    QVERIFY(read_test_file(m_logoPath).empty());
+    QCOMPARE(bootLogoUtil.get_background_color().first, string("0x000000"));
+}
+
+void TestBootLogoUtility::testApplyMissingImage()
+{
+    string missing = m_root + "/missing.png";
+    TPCBootLogoUtility bootLogoUtil(m_logoPath.c_str(), m_psplashConfigFile.c_str(), m_framebufferFolder.c_str());
+    auto ret = bootLogoUtil.apply_boot_logo(missing.c_str(), TEST_BG_COLOR);
+    QVERIFY(!ret.second);
+    QVERIFY(!ret.first.empty());
+    QVERIFY(read_test_file(m_logoPath).empty());
+    QCOMPARE(bootLogoUtil.get_background_color().first, string("0x000000"));
+}
+
+void TestBootLogoUtility::testApplyReplacesExisting()
+{
+    // a read only logo keeps its mode, a missing color key is appended to the config
+    QVERIFY(write_test_file(m_logoPath, "old logo"));
+    QVERIFY(chmod(m_logoPath.c_str(), 0444) == 0);
+    QVERIFY(write_test_file(m_psplashConfigFile, "PROGRESS=1"));
+    string imagePath = m_root + "/logo.bmp";
+    QVERIFY(write_test_file(imagePath, encode_bmp24(_create_pattern(8, 8, false))));
+    TPCBootLogoUtility bootLogoUtil(m_logoPath.c_str(), m_psplashConfigFile.c_str(), m_framebufferFolder.c_str());
+    QVERIFY(bootLogoUtil.apply_boot_logo(imagePath.c_str(), TEST_BG_COLOR).second);
+    BootLogoImage logo;
+    QVERIFY(_decode_bmp24(read_test_file(m_logoPath), logo));
+    QCOMPARE(logo.getWidth(), TEST_PANEL_WIDTH);
+    struct stat logoStat;
+    QVERIFY(stat(m_logoPath.c_str(), &logoStat) == 0);
+    QCOMPARE((int)(logoStat.st_mode & 07777), 0444);
+    QCOMPARE(read_test_file(m_psplashConfigFile), string("PROGRESS=1\nBACKGROUND_COLOR=" TEST_BG_COLOR "\n"));
+    QCOMPARE(_count_entries(m_root + "/etc"), 2);
+}
+
+int TestBootLogoUtility::_count_entries(const string& folder)
+{
+    int count = 0;
+    DIR *dir = opendir(folder.c_str());
+    if (!dir)
+        return count;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+            count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+QTEST_GUILESS_MAIN(TestBootLogoUtility)
+#include "tst_boot_logo_utility.moc"
@@ -0,0 +1,13 @@
+include(../tests.pri)
+QT += dbus
+TARGET = tst_brightness_controller
+
+HEADERS += $$SRC_FOLDER/include/brightness_controller.h \
+    $$SRC_FOLDER/include/service_manager.h
+
+SOURCES += tst_brightness_controller.cpp \
+    $$SRC_FOLDER/brightness_controller.cpp \
+    $$SRC_FOLDER/screen_utility.cpp \
+    $$SRC_FOLDER/service_manager.cpp \
+    $$SRC_FOLDER/ini_document.cpp \
+    $$SRC_FOLDER/utility.cpp
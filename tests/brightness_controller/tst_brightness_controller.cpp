@@ -0,0 +1,191 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "test_utility.h"
+#include "service_manager.h"
+#include "screen_utility.h"
+#include "brightness_controller.h"
+
+// 10 Hz frames keep the coalescing window wide enough for a loaded builder
+#define TEST_REFRESH_RATE   10
+
+// no systemd in unit tests
+class FakeServiceManager : public IServiceManager {
+public:
+    bool start_units(const vector<string>&) override { return true; }
+    bool stop_units(const vector<string>&) override { return true; }
+    bool restart_units(const vector<string>&) override { return true; }
+    bool enable_units(const vector<string>&) override { return true; }
+    bool disable_units(const vector<string>&) override { return true; }
+    bool enable_and_start_units(const vector<string>&) override { return true; }
+    bool stop_and_disable_units(const vector<string>&) override { return true; }
+    pair<bool, bool> get_unit_enabled(const char*) override { return make_pair(false, true); }
+    pair<string, bool> find_unit(const char*) override { return make_pair(string(), false); }
+    bool wait_unit_active(const char*, int) override { return true; }
+};
+
+// backlight attribute in a temp folder, counts writes and systemd-backlight saves
+class FakeBacklightUtility : public TPCScreenUtility {
+public:
+    FakeBacklightUtility(const char* backlightFolder, IServiceManager *serviceManager)
+        : TPCScreenUtility(nullptr, backlightFolder, nullptr, serviceManager) {}
+    bool set_brightness(const int brightness) override
+    {
+        m_writes.push_back(brightness);
+        return TPCScreenUtility::set_brightness(brightness);
+    }
+    bool save_brightness() override
+    {
+        m_saveCount++;
+        return true;
+    }
+
+    vector<int> m_writes;
+    int m_saveCount = 0;
+};
+
+class TestBrightnessController : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testReadBacklight();
+    void testWriteBacklight();
+    void testWriteOutOfRange();
+    void testMissingBacklight();
+    void testFirstChangeWrittenAtOnce();
+    void testDragCoalesced();
+    void testPersistOnceAfterSettle();
+    void testFlushPersistsPending();
+    void testFlushWithoutChange();
+
+private:
+    string m_backlightFolder;
+    FakeServiceManager m_serviceManager;
+    FakeBacklightUtility *m_screenUtil = nullptr;
+    QTemporaryDir m_folder;
+};
+
+void TestBrightnessController::init()
+{
+    QVERIFY(m_folder.isValid());
+    m_backlightFolder = m_folder.path().toStdString() + "/" + QTest::currentTestFunction() + "/lvds_backlight@0";
+    QVERIFY(write_test_file(m_backlightFolder + "/brightness", "50\n"));
+    QVERIFY(write_test_file(m_backlightFolder + "/max_brightness", "100\n"));
+    m_screenUtil = new FakeBacklightUtility(m_backlightFolder.c_str(), &m_serviceManager);
+}
+
+void TestBrightnessController::cleanup()
+{
+    delete m_screenUtil;
+    m_screenUtil = nullptr;
+}
+
+void TestBrightnessController::testReadBacklight()
+{
+    QCOMPARE(m_screenUtil->get_brightness(), 50);
+    // attribute changed by someone else is read again from offset 0
+    QVERIFY(write_test_file(m_backlightFolder + "/brightness", "75\n"));
+    QCOMPARE(m_screenUtil->get_brightness(), 75);
+}
+
+void TestBrightnessController::testWriteBacklight()
+{
+    QVERIFY(m_screenUtil->set_brightness(100));
+    QCOMPARE(m_screenUtil->get_brightness(), 100);
+    QVERIFY(m_screenUtil->set_brightness(80));
+    QCOMPARE(m_screenUtil->get_brightness(), 80);
+    QCOMPARE(read_test_file(m_backlightFolder + "/brightness").substr(0, 3), string("80\n"));
+}
+
+void TestBrightnessController::testWriteOutOfRange()
+{
+    QVERIFY(!m_screenUtil->set_brightness(SCREEN_BRIGHTNESS_MIN - 1));
+    QVERIFY(!m_screenUtil->set_brightness(SCREEN_BRIGHTNESS_MAX + 1));
+    QCOMPARE(m_screenUtil->get_brightness(), 50);
+}
+
+void TestBrightnessController::testMissingBacklight()
+{
+    const string missing = m_folder.path().toStdString() + "/missing_backlight";
+    FakeBacklightUtility screenUtil(missing.c_str(), &m_serviceManager);
+    QCOMPARE(screenUtil.get_brightness(), 0);
+    QVERIFY(!screenUtil.set_brightness(50));
+}
+
+void TestBrightnessController::testFirstChangeWrittenAtOnce()
+{
+    BrightnessController controller(m_screenUtil, TEST_REFRESH_RATE);
+    controller.requestBrightness(60);
+    QCOMPARE(m_screenUtil->m_writes, vector<int>({60}));
+    QCOMPARE(m_screenUtil->get_brightness(), 60);
+    QCOMPARE(m_screenUtil->m_saveCount, 0);
+}
+
+void TestBrightnessController::testDragCoalesced()
+{
+    BrightnessController controller(m_screenUtil, TEST_REFRESH_RATE);
+    for (int brightness = 10; brightness <= 40; brightness++)
+    {
+        controller.requestBrightness(brightness);
+    }
+    // one write for the whole burst, the last value follows on the next frame
+    QCOMPARE(m_screenUtil->m_writes, vector<int>({10}));
+    QTRY_COMPARE(m_screenUtil->get_brightness(), 40);
+    QCOMPARE(m_screenUtil->m_writes, vector<int>({10, 40}));
+    // no more writes once the slider stopped
+    QTest::qWait(3 * 1000 / TEST_REFRESH_RATE);
+    QCOMPARE(m_screenUtil->m_writes, vector<int>({10, 40}));
+}
+
+void TestBrightnessController::testPersistOnceAfterSettle()
+{
+    BrightnessController controller(m_screenUtil, TEST_REFRESH_RATE);
+    QSignalSpy spy(&controller, &BrightnessController::brightnessSettled);
+    controller.requestBrightness(20);
+    controller.requestBrightness(30);
+    QCOMPARE(m_screenUtil->m_saveCount, 0);
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.takeFirst().at(0).toInt(), 30);
+    QCOMPARE(m_screenUtil->m_saveCount, 1);
+    QTest::qWait(BRIGHTNESS_SETTLE_MS + 100);
+    QCOMPARE(m_screenUtil->m_saveCount, 1);
+    QCOMPARE(spy.count(), 0);
+}
+
+void TestBrightnessController::testFlushPersistsPending()
+{
+    BrightnessController controller(m_screenUtil, TEST_REFRESH_RATE);
+    QSignalSpy spy(&controller, &BrightnessController::brightnessSettled);
+    controller.requestBrightness(20);
+    controller.requestBrightness(90);
+    // ex: window closed during a drag
+    controller.flush();
+    QCOMPARE(m_screenUtil->get_brightness(), 90);
+    QCOMPARE(m_screenUtil->m_saveCount, 1);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.takeFirst().at(0).toInt(), 90);
+    // timers were stopped by the flush
+    QTest::qWait(BRIGHTNESS_SETTLE_MS + 100);
+    QCOMPARE(m_screenUtil->m_writes, vector<int>({20, 90}));
+    QCOMPARE(m_screenUtil->m_saveCount, 1);
+}
+
+void TestBrightnessController::testFlushWithoutChange()
+{
+    BrightnessController controller(m_screenUtil, TEST_REFRESH_RATE);
+    QSignalSpy spy(&controller, &BrightnessController::brightnessSettled);
+    controller.flush();
+    QVERIFY(m_screenUtil->m_writes.empty());
+    QCOMPARE(m_screenUtil->m_saveCount, 0);
+    QCOMPARE(spy.count(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestBrightnessController)
+#include "tst_brightness_controller.moc"
@@ -0,0 +1,42 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <QDir>
+#include <QFileInfo>
+#include <QString>
+
+#include "test_utility.h"
+
+static bool create_parent_folder(const string& path)
+{
+    QString folder = QString::fromStdString(path.substr(0, path.rfind('/')));
+    return QDir().mkpath(folder);
+}
+
+bool write_test_file(const string& path, const string& content)
+{
+    if (!create_parent_folder(path))
+        return false;
+    ofstream file(path, ios::trunc);
+    file << content;
+    return file.good();
+}
+
+bool create_test_symlink(const string& target, const string& path)
+{
+    if (!create_parent_folder(path))
+        return false;
+    unlink(path.c_str());
+    return symlink(target.c_str(), path.c_str()) == 0;
+}
+
+string read_test_file(const string& path)
+{
+    ifstream file(path);
+    stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
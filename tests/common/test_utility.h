@@ -0,0 +1,15 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef TEST_UTILITY_H
+#define TEST_UTILITY_H
+
+#include <string>
+
+using namespace std;
+
+// fake sysfs and proc trees, parent folders are created as needed
+bool write_test_file(const string& path, const string& content);
+bool create_test_symlink(const string& target, const string& path);
+string read_test_file(const string& path);
+#endif // TEST_UTILITY_H
@@ -0,0 +1,6 @@
+include(../tests.pri)
+TARGET = tst_ini_document
+
+SOURCES += tst_ini_document.cpp \
+    $$SRC_FOLDER/ini_document.cpp \
+    $$SRC_FOLDER/utility.cpp
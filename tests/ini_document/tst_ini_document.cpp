@@ -0,0 +1,189 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <cstring>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "test_utility.h"
+#include "utility.h"
+#include "ini_document.h"
+
+// weston.ini like content with comments, repeated sections and odd spacing
+#define TEST_INI_CONTENT \
+    "# comment at top\n" \
+    "[core]\n" \
+    "idle-time=0\n" \
+    "\n" \
+    "; gesture off\n" \
+    "[output]\n" \
+    "name=DSI-1\n" \
+    "transform  =   rotate-90\n" \
+    "\n" \
+    "[output]\n" \
+    "name=HDMI-A-1\n" \
+    "mode=1920x1080\n"
+
+class TestIniDocument : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testUnmodifiedRoundTrip();
+    void testCRLFRoundTrip();
+    void testNoTrailingNewline();
+    void testSetValueKeepsLayout();
+    void testRepeatedSection();
+    void testSetBackIsNotModified();
+    void testAppendSection();
+    void testSaveKeepsSymlink();
+    void testSaveKeepsPermission();
+    void testSaveLeavesNoTempFile();
+
+private:
+    int _count_files(const string& folder);
+
+    string m_root;
+    QTemporaryDir m_folder;
+};
+
+void TestIniDocument::init()
+{
+    QVERIFY(m_folder.isValid());
+    m_root = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    QVERIFY(write_test_file(m_root + "/weston.ini", TEST_INI_CONTENT));
+}
+
+int TestIniDocument::_count_files(const string& folder)
+{
+    int count = 0;
+    DIR *dir = opendir(folder.c_str());
+    if (!dir)
+        return -1;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+            count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+void TestIniDocument::testUnmodifiedRoundTrip()
+{
+    const string path = m_root + "/weston.ini";
+    const string copyPath = m_root + "/copy.ini";
+    IniDocument doc;
+    QVERIFY(doc.load(path.c_str()));
+    QVERIFY(doc.is_loaded());
+    QVERIFY(!doc.is_modified());
+    QVERIFY(doc.save(copyPath.c_str()));
+    QCOMPARE(read_test_file(copyPath), string(TEST_INI_CONTENT));
+}
+
+void TestIniDocument::testCRLFRoundTrip()
+{
+    IniDocument doc;
+    doc.load_from_string("[core]\r\nidle-time=0\r\n");
+    QVERIFY(doc.set_value("core", "repaint-window", "16"));
+    QCOMPARE(doc.to_string(), string("[core]\r\nidle-time=0\r\nrepaint-window=16\r\n"));
+    QCOMPARE(doc.get_value("core", "idle-time").first, string("0"));
+}
+
+void TestIniDocument::testNoTrailingNewline()
+{
+    IniDocument doc;
+    doc.load_from_string("[core]\nidle-time=0");
+    QCOMPARE(doc.to_string(), string("[core]\nidle-time=0"));
+}
+
+void TestIniDocument::testSetValueKeepsLayout()
+{
+    IniDocument doc;
+    doc.load_from_string(TEST_INI_CONTENT);
+    QVERIFY(doc.set_value("output", "name", "DSI-1", "transform", "normal"));
+    QVERIFY(doc.is_modified());
+    string expected = TEST_INI_CONTENT;
+    size_t pos = expected.find("rotate-90");
+    expected.replace(pos, strlen("rotate-90"), "normal");
+    QCOMPARE(doc.to_string(), expected);
+}
+
+void TestIniDocument::testRepeatedSection()
+{
+    IniDocument doc;
+    doc.load_from_string(TEST_INI_CONTENT);
+    QCOMPARE(doc.get_value("output", "name", "HDMI-A-1", "mode").first, string("1920x1080"));
+    QVERIFY(!doc.get_value("output", "name", "DSI-1", "mode").second);
+    QVERIFY(!doc.get_value("output", "name", "LVDS-1", "mode").second);
+    // the first matching section without a match key
+    QCOMPARE(doc.get_value("output", "name").first, string("DSI-1"));
+}
+
+void TestIniDocument::testSetBackIsNotModified()
+{
+    IniDocument doc;
+    doc.load_from_string(TEST_INI_CONTENT);
+    QVERIFY(doc.set_value("core", "idle-time", "600"));
+    QVERIFY(doc.is_modified());
+    QVERIFY(doc.set_value("core", "idle-time", "0"));
+    QVERIFY(!doc.is_modified());
+}
+
+void TestIniDocument::testAppendSection()
+{
+    IniDocument doc;
+    doc.load_from_string(TEST_INI_CONTENT);
+    QVERIFY(doc.set_value("shell", "panel-position", "none"));
+    QCOMPARE(doc.to_string(), string(TEST_INI_CONTENT) + "\n[shell]\npanel-position=none\n");
+}
+
+void TestIniDocument::testSaveKeepsSymlink()
+{
+    // ex: /etc/xdg/weston/weston.ini linked to a file on a writable partition
+    const string target = m_root + "/weston.ini";
+    const string link = m_root + "/link.ini";
+    QVERIFY(create_test_symlink(target, link));
+    IniDocument doc;
+    QVERIFY(doc.load(link.c_str()));
+    QVERIFY(doc.set_value("core", "idle-time", "600"));
+    QVERIFY(doc.save(link.c_str()));
+    struct stat linkStat;
+    QVERIFY(lstat(link.c_str(), &linkStat) == 0);
+    QVERIFY(S_ISLNK(linkStat.st_mode));
+    IniDocument saved;
+    QVERIFY(saved.load(target.c_str()));
+    QCOMPARE(saved.get_value("core", "idle-time").first, string("600"));
+}
+
+void TestIniDocument::testSaveKeepsPermission()
+{
+    const string path = m_root + "/weston.ini";
+    QVERIFY(chmod(path.c_str(), 0640) == 0);
+    QVERIFY(write_file_atomic(path.c_str(), "[core]\n"));
+    struct stat fileStat;
+    QVERIFY(stat(path.c_str(), &fileStat) == 0);
+    QCOMPARE((int)(fileStat.st_mode & 07777), 0640);
+    QCOMPARE(read_test_file(path), string("[core]\n"));
+}
+
+void TestIniDocument::testSaveLeavesNoTempFile()
+{
+    const string path = m_root + "/weston.ini";
+    QCOMPARE(_count_files(m_root), 1);
+    QVERIFY(write_file_atomic(path.c_str(), "[core]\n"));
+    QVERIFY(write_file_atomic(path.c_str(), "[shell]\n"));
+    QCOMPARE(_count_files(m_root), 1);
+    // a missing folder fails without leaving anything behind
+    const string missing = m_root + "/missing/weston.ini";
+    QVERIFY(!write_file_atomic(missing.c_str(), "[core]\n"));
+    QCOMPARE(_count_files(m_root), 1);
+}
+
+QTEST_GUILESS_MAIN(TestIniDocument)
+#include "tst_ini_document.moc"
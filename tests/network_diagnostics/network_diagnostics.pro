@@ -0,0 +1,5 @@
+include(../tests.pri)
+TARGET = tst_network_diagnostics
+
+SOURCES += tst_network_diagnostics.cpp \
+    $$SRC_FOLDER/network_diagnostics_utility.cpp
@@ -0,0 +1,264 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include "test_utility.h"
+#include "network_diagnostics_utility.h"
+
+// histogram math, a fake /sys/class/net tree and tcp probes against loopback listeners
+class TestNetworkDiagnostics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void testHistogramEmpty();
+    void testHistogramBuckets();
+    void testHistogramLost();
+    void testBucketLabels();
+    void testInterfaceStatistics();
+    void testInterfaceStatisticsMissingFolder();
+    void testConnectLatencyLoopback();
+    void testConnectLatencyRefused();
+    void testConnectLatencyCancelled();
+    void testConnectLatencyInvalid();
+    void testLoopbackThroughput();
+    void testLoopbackThroughputCancelled();
+    void testThroughputRefused();
+
+private:
+    int startListener();
+
+    int m_listenFd = -1;
+    QTemporaryDir m_folder;
+};
+
+// listening socket on an ephemeral loopback port, the kernel completes connects from the backlog
+int TestNetworkDiagnostics::startListener()
+{
+    m_listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0)
+        return -1;
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(m_listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(m_listenFd, DIAGNOSTICS_MAX_COUNT) < 0 ||
+        getsockname(m_listenFd, (struct sockaddr *)&addr, &len) < 0)
+        return -1;
+    return ntohs(addr.sin_port);
+}
+
+void TestNetworkDiagnostics::cleanup()
+{
+    if (m_listenFd >= 0)
+        close(m_listenFd);
+    m_listenFd = -1;
+}
+
+void TestNetworkDiagnostics::testHistogramEmpty()
+{
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.getSent(), 0);
+    QCOMPARE(histogram.getLost(), 0);
+    QCOMPARE(histogram.getAverage(), 0.0);
+    QCOMPARE(histogram.getBuckets().size(), LatencyHistogram::getBucketLabels().size());
+}
+
+void TestNetworkDiagnostics::testHistogramBuckets()
+{
+    LatencyHistogram histogram;
+    // bounds are upper exclusive: 1ms falls in "<2ms", 500ms and above in the last bucket
+    histogram.addSample(0.4);
+    histogram.addSample(1.0);
+    histogram.addSample(4.9);
+    histogram.addSample(500.0);
+    histogram.addSample(3000.0);
+    vector<int> buckets = histogram.getBuckets();
+    QCOMPARE(buckets.size(), (size_t)10);
+    QCOMPARE(buckets[0], 1);
+    QCOMPARE(buckets[1], 1);
+    QCOMPARE(buckets[2], 1);
+    QCOMPARE(buckets[9], 2);
+    QCOMPARE(histogram.getMin(), 0.4);
+    QCOMPARE(histogram.getMax(), 3000.0);
+    QCOMPARE(histogram.getAverage(), (0.4 + 1.0 + 4.9 + 500.0 + 3000.0) / 5);
+}
+
+void TestNetworkDiagnostics::testHistogramLost()
+{
+    LatencyHistogram histogram;
+    histogram.addLost();
+    histogram.addSample(7.0);
+    histogram.addLost();
+    QCOMPARE(histogram.getSent(), 3);
+    QCOMPARE(histogram.getReceived(), 1);
+    QCOMPARE(histogram.getLost(), 2);
+    // lost probes do not count toward min and average
+    QCOMPARE(histogram.getMin(), 7.0);
+    QCOMPARE(histogram.getAverage(), 7.0);
+    int total = 0;
+    for (int count : histogram.getBuckets())
+        total += count;
+    QCOMPARE(total, 1);
+    QVERIFY(histogram.toString().find("sent=3 received=1 lost=2") == 0);
+}
+
+void TestNetworkDiagnostics::testBucketLabels()
+{
+    vector<string> labels = LatencyHistogram::getBucketLabels();
+    QCOMPARE(labels.size(), (size_t)10);
+    QCOMPARE(labels.front(), string("<1ms"));
+    QCOMPARE(labels[8], string("<500ms"));
+    QCOMPARE(labels.back(), string(">=500ms"));
+}
+
+void TestNetworkDiagnostics::testInterfaceStatistics()
+{
+    QVERIFY(m_folder.isValid());
+    const string net = m_folder.path().toStdString() + "/sys/class/net";
+    QVERIFY(write_test_file(net + "/eth0/operstate", "up\n"));
+    QVERIFY(write_test_file(net + "/eth0/statistics/rx_bytes", "123456789012\n"));
+    QVERIFY(write_test_file(net + "/eth0/statistics/tx_bytes", "2048\n"));
+    QVERIFY(write_test_file(net + "/eth0/statistics/rx_packets", "1000\n"));
+    QVERIFY(write_test_file(net + "/eth0/statistics/tx_packets", "20\n"));
+    QVERIFY(write_test_file(net + "/eth0/statistics/rx_errors", "3\n"));
+    QVERIFY(write_test_file(net + "/eth0/statistics/tx_errors", "0\n"));
+    QVERIFY(write_test_file(net + "/eth0/statistics/rx_dropped", "4\n"));
+    QVERIFY(write_test_file(net + "/eth0/statistics/tx_dropped", "1\n"));
+    // veth without statistics files reads as zero
+    QVERIFY(write_test_file(net + "/veth0/operstate", "lowerlayerdown\n"));
+    QVERIFY(write_test_file(net + "/veth0/statistics/rx_bytes", "garbage\n"));
+    QVERIFY(write_test_file(net + "/lo/operstate", "unknown\n"));
+
+    TPCNetworkDiagnosticsUtility diagnosticsUtil(net.c_str());
+    auto ret = diagnosticsUtil.get_interface_statistics();
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.size(), (size_t)3);
+    // sorted by name
+    QCOMPARE(ret.first[0].getName(), string("eth0"));
+    QCOMPARE(ret.first[1].getName(), string("lo"));
+    QCOMPARE(ret.first[2].getName(), string("veth0"));
+    InterfaceStatistics eth0 = ret.first[0];
+    QCOMPARE(eth0.getOperState(), string("up"));
+    QCOMPARE(eth0.getRxBytes(), 123456789012ULL);
+    QCOMPARE(eth0.getTxBytes(), 2048ULL);
+    QCOMPARE(eth0.getRxPackets(), 1000ULL);
+    QCOMPARE(eth0.getTxPackets(), 20ULL);
+    QCOMPARE(eth0.getRxErrors(), 3ULL);
+    QCOMPARE(eth0.getRxDropped(), 4ULL);
+    QCOMPARE(eth0.getTxDropped(), 1ULL);
+    InterfaceStatistics veth0 = ret.first[2];
+    QCOMPARE(veth0.getOperState(), string("lowerlayerdown"));
+    QCOMPARE(veth0.getRxBytes(), 0ULL);
+    QCOMPARE(veth0.getTxPackets(), 0ULL);
+}
+
+void TestNetworkDiagnostics::testInterfaceStatisticsMissingFolder()
+{
+    QVERIFY(m_folder.isValid());
+    const string net = m_folder.path().toStdString() + "/missing";
+    TPCNetworkDiagnosticsUtility diagnosticsUtil(net.c_str());
+    QCOMPARE(diagnosticsUtil.get_interface_statistics().second, false);
+}
+
+void TestNetworkDiagnostics::testConnectLatencyLoopback()
+{
+    int port = startListener();
+    QVERIFY(port > 0);
+    TPCNetworkDiagnosticsUtility diagnosticsUtil;
+    auto ret = diagnosticsUtil.tcp_connect_latency(LOOPBACK_ADDRESS, port, 5, DIAGNOSTICS_DEFAULT_TIMEOUT_MS);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.getSent(), 5);
+    QCOMPARE(ret.first.getLost(), 0);
+    QVERIFY(ret.first.getMax() < DIAGNOSTICS_DEFAULT_TIMEOUT_MS);
+}
+
+void TestNetworkDiagnostics::testConnectLatencyRefused()
+{
+    // bound but not listening, connects are refused right away
+    int port = startListener();
+    QVERIFY(port > 0);
+    close(m_listenFd);
+    m_listenFd = -1;
+    TPCNetworkDiagnosticsUtility diagnosticsUtil;
+    auto ret = diagnosticsUtil.tcp_connect_latency(LOOPBACK_ADDRESS, port, 3, DIAGNOSTICS_DEFAULT_TIMEOUT_MS);
+    QCOMPARE(ret.second, false);
+    QCOMPARE(ret.first.getSent(), 3);
+    QCOMPARE(ret.first.getLost(), 3);
+}
+
+void TestNetworkDiagnostics::testConnectLatencyCancelled()
+{
+    int port = startListener();
+    QVERIFY(port > 0);
+    TPCNetworkDiagnosticsUtility diagnosticsUtil;
+    int checks = 0;
+    auto ret = diagnosticsUtil.tcp_connect_latency(LOOPBACK_ADDRESS, port, DIAGNOSTICS_MAX_COUNT, DIAGNOSTICS_DEFAULT_TIMEOUT_MS,
+        [&checks] { return ++checks > 2; });
+    QVERIFY(ret.first.getSent() < DIAGNOSTICS_MAX_COUNT);
+    QCOMPARE(ret.first.getLost(), 0);
+
+    auto retNone = diagnosticsUtil.tcp_connect_latency(LOOPBACK_ADDRESS, port, 3, DIAGNOSTICS_DEFAULT_TIMEOUT_MS,
+        [] { return true; });
+    QCOMPARE(retNone.second, false);
+    QCOMPARE(retNone.first.getSent(), 0);
+}
+
+void TestNetworkDiagnostics::testConnectLatencyInvalid()
+{
+    TPCNetworkDiagnosticsUtility diagnosticsUtil;
+    QCOMPARE(diagnosticsUtil.tcp_connect_latency(nullptr, 80, 1, 100).second, false);
+    QCOMPARE(diagnosticsUtil.tcp_connect_latency(LOOPBACK_ADDRESS, 0, 1, 100).second, false);
+    QCOMPARE(diagnosticsUtil.tcp_connect_latency(LOOPBACK_ADDRESS, 80, 0, 100).second, false);
+    QCOMPARE(diagnosticsUtil.icmp_latency(LOOPBACK_ADDRESS, 0, 100).second, false);
+}
+
+void TestNetworkDiagnostics::testLoopbackThroughput()
+{
+    TPCNetworkDiagnosticsUtility diagnosticsUtil;
+    QElapsedTimer timer;
+    timer.start();
+    auto ret = diagnosticsUtil.tcp_loopback_throughput(1);
+    QVERIFY(ret.second);
+    QVERIFY(ret.first > 0);
+    QVERIFY(timer.elapsed() >= 1000);
+    QVERIFY(timer.elapsed() < 1000 + DIAGNOSTICS_CONNECT_TIMEOUT_MS);
+}
+
+void TestNetworkDiagnostics::testLoopbackThroughputCancelled()
+{
+    TPCNetworkDiagnosticsUtility diagnosticsUtil;
+    QElapsedTimer timer;
+    timer.start();
+    int checks = 0;
+    auto ret = diagnosticsUtil.tcp_loopback_throughput(DIAGNOSTICS_THROUGHPUT_SECONDS, [&checks] { return ++checks > 10; });
+    // ten sends went out before the cancel
+    QVERIFY(ret.second);
+    QVERIFY(timer.elapsed() < DIAGNOSTICS_THROUGHPUT_SECONDS * 1000);
+}
+
+void TestNetworkDiagnostics::testThroughputRefused()
+{
+    int port = startListener();
+    QVERIFY(port > 0);
+    close(m_listenFd);
+    m_listenFd = -1;
+    TPCNetworkDiagnosticsUtility diagnosticsUtil;
+    QCOMPARE(diagnosticsUtil.tcp_throughput(LOOPBACK_ADDRESS, port, 1).second, false);
+}
+
+QTEST_GUILESS_MAIN(TestNetworkDiagnostics)
+#include "tst_network_diagnostics.moc"
@@ -0,0 +1,6 @@
+include(../tests.pri)
+TARGET = tst_reboot_schedule
+
+SOURCES += tst_reboot_schedule.cpp \
+    $$SRC_FOLDER/reboot_schedule.cpp \
+    $$SRC_FOLDER/utility.cpp
@@ -0,0 +1,325 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdlib>
+#include <ctime>
+#include <QtTest>
+
+#include "reboot_schedule.h"
+
+using namespace std;
+
+// posix rules, no tzdata needed. central europe changes on the last sunday of march and october
+#define TZ_UTC                  "UTC0"
+#define TZ_CENTRAL_EUROPE       "CET-1CEST,M3.5.0,M10.5.0/3"
+// 2022-10-30 02:15 CET, the second time the clock shows 02:15 that night
+#define FALL_BACK_SECOND_0215   1667092500
+
+// the clock is simulated by passing now to getNextFireTime, local time follows TZ
+class TestRebootSchedule : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+    void testParseWindows();
+    void testParseBlackouts();
+    void testBlackoutSameDay();
+    void testBlackoutCrossingMidnight();
+    void testBlackoutCrossingMidnightEveryDay();
+    void testBlackoutWeekdayFolding();
+    void testHasFireTime();
+    void testMakeScheduleWeekdayFolding();
+    void testCrontab();
+    void testNextFireTimeDaily();
+    void testNextFireTimeWeekly();
+    void testNextFireTimeSkipsBlackout();
+    void testNextFireTimeMultipleWindows();
+    void testNextFireTimeNone();
+    void testNextFireTimeDSTStart();
+    void testNextFireTimeDSTEnd();
+    void testNextFireTimeDSTEndSecondPass();
+
+private:
+    void _set_timezone(const char* timezone);
+    // local wall clock of the current TZ
+    time_t _local_time(int year, int month, int day, int hour, int minute);
+    string _format_local(time_t time);
+
+    string m_timezone;
+    bool m_hasTimezone = false;
+};
+
+void TestRebootSchedule::initTestCase()
+{
+    const char* timezone = getenv("TZ");
+    m_hasTimezone = (timezone != nullptr);
+    if (m_hasTimezone)
+        m_timezone = timezone;
+}
+
+void TestRebootSchedule::init()
+{
+    _set_timezone(TZ_UTC);
+}
+
+void TestRebootSchedule::cleanupTestCase()
+{
+    if (m_hasTimezone)
+        setenv("TZ", m_timezone.c_str(), 1);
+    else
+        unsetenv("TZ");
+    tzset();
+}
+
+void TestRebootSchedule::_set_timezone(const char* timezone)
+{
+    setenv("TZ", timezone, 1);
+    tzset();
+}
+
+time_t TestRebootSchedule::_local_time(int year, int month, int day, int hour, int minute)
+{
+    struct tm local;
+    memset(&local, 0, sizeof(local));
+    local.tm_year = year - 1900;
+    local.tm_mon = month - 1;
+    local.tm_mday = day;
+    local.tm_hour = hour;
+    local.tm_min = minute;
+    local.tm_isdst = -1;
+    return mktime(&local);
+}
+
+string TestRebootSchedule::_format_local(time_t time)
+{
+    if (time < 0)
+        return "none";
+    struct tm local;
+    localtime_r(&time, &local);
+    char buff[64] = {0};
+    strftime(buff, sizeof(buff), "%Y-%m-%d %H:%M %a %Z", &local);
+    return buff;
+}
+
+void TestRebootSchedule::testParseWindows()
+{
+    vector<RebootWindow> windows = parse_reboot_windows("03:00, 6 04:30,7 23:59, 25:00, 8 01:00, x");
+    QCOMPARE(windows.size(), (size_t)3);
+    QCOMPARE(windows[0].dayofweek, REBOOT_SCHEDULE_EVERY_DAY);
+    QCOMPARE(windows[0].hour, 3);
+    QCOMPARE(windows[1].dayofweek, 6);
+    QCOMPARE(windows[1].minute, 30);
+    // 7 is sunday like cron
+    QCOMPARE(windows[2].dayofweek, 0);
+    QCOMPARE(windows[2].hour, 23);
+    QVERIFY(parse_reboot_windows("").empty());
+}
+
+void TestRebootSchedule::testParseBlackouts()
+{
+    vector<RebootBlackout> blackouts = parse_reboot_blackouts("08:00-18:00, 0 22:00-02:00, 1 10:00-2 11:00, 12:00");
+    QCOMPARE(blackouts.size(), (size_t)2);
+    QCOMPARE(blackouts[0].dayofweek, REBOOT_SCHEDULE_EVERY_DAY);
+    QCOMPARE(blackouts[0].startMinute, 8 * 60);
+    QCOMPARE(blackouts[0].endMinute, 18 * 60);
+    QCOMPARE(blackouts[1].dayofweek, 0);
+    QCOMPARE(blackouts[1].startMinute, 22 * 60);
+    QCOMPARE(blackouts[1].endMinute, 2 * 60);
+}
+
+void TestRebootSchedule::testBlackoutSameDay()
+{
+    RebootSchedule schedule;
+    schedule.addBlackout({3, 8 * 60, 18 * 60});
+    QVERIFY(!schedule.isBlackedOut(3, 8 * 60 - 1));
+    QVERIFY(schedule.isBlackedOut(3, 8 * 60));
+    QVERIFY(schedule.isBlackedOut(3, 18 * 60 - 1));
+    // end is exclusive
+    QVERIFY(!schedule.isBlackedOut(3, 18 * 60));
+    QVERIFY(!schedule.isBlackedOut(4, 12 * 60));
+}
+
+void TestRebootSchedule::testBlackoutCrossingMidnight()
+{
+    // friday night into saturday morning
+    RebootSchedule schedule;
+    schedule.addBlackout({5, 22 * 60, 2 * 60});
+    QVERIFY(!schedule.isBlackedOut(5, 21 * 60 + 59));
+    QVERIFY(schedule.isBlackedOut(5, 22 * 60));
+    QVERIFY(schedule.isBlackedOut(5, MINUTES_PER_DAY - 1));
+    QVERIFY(schedule.isBlackedOut(6, 0));
+    QVERIFY(schedule.isBlackedOut(6, 2 * 60 - 1));
+    QVERIFY(!schedule.isBlackedOut(6, 2 * 60));
+    // the morning part belongs to friday only
+    QVERIFY(!schedule.isBlackedOut(5, 60));
+    QVERIFY(!schedule.isBlackedOut(6, 23 * 60));
+}
+
+void TestRebootSchedule::testBlackoutCrossingMidnightEveryDay()
+{
+    RebootSchedule schedule;
+    schedule.addBlackout({REBOOT_SCHEDULE_EVERY_DAY, 23 * 60, 60});
+    for (int day = 0; day < DAYS_PER_WEEK; day++)
+    {
+        QVERIFY(schedule.isBlackedOut(day, 23 * 60 + 30));
+        QVERIFY(schedule.isBlackedOut(day, 30));
+        QVERIFY(!schedule.isBlackedOut(day, 60));
+        QVERIFY(!schedule.isBlackedOut(day, 12 * 60));
+    }
+}
+
+void TestRebootSchedule::testBlackoutWeekdayFolding()
+{
+    // saturday night continues into sunday, day 6 + 1 folds to 0
+    RebootSchedule schedule;
+    schedule.addBlackout({6, 22 * 60, 3 * 60});
+    QVERIFY(schedule.isBlackedOut(0, 60));
+    QVERIFY(!schedule.isBlackedOut(0, 3 * 60));
+    QVERIFY(!schedule.isBlackedOut(1, 60));
+
+    // sunday given as 7 in the text folds the same way
+    RebootSchedule parsed = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 30, 1, 0, "", "7 23:00-02:00");
+    QVERIFY(parsed.isBlackedOut(0, 23 * 60 + 30));
+    QVERIFY(parsed.isBlackedOut(1, 30));
+    QVERIFY(!parsed.isBlackedOut(0, 30));
+}
+
+void TestRebootSchedule::testHasFireTime()
+{
+    RebootSchedule schedule;
+    QVERIFY(!schedule.hasFireTime());
+    schedule.addWindow({REBOOT_SCHEDULE_EVERY_DAY, 3, 0});
+    QVERIFY(schedule.hasFireTime());
+    schedule.addBlackout({REBOOT_SCHEDULE_EVERY_DAY, 2 * 60, 4 * 60});
+    QVERIFY(!schedule.hasFireTime());
+}
+
+void TestRebootSchedule::testMakeScheduleWeekdayFolding()
+{
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_WEEKLY, 15, 4, 7);
+    QCOMPARE(schedule.getWindows().size(), (size_t)1);
+    QCOMPARE(schedule.getWindows()[0].dayofweek, 0);
+    QCOMPARE(schedule.toCrontab("root", REBOOT_SCHEDULE_COMMAND), string("15 4 * * 0 root /sbin/reboot\n"));
+
+    QVERIFY(make_reboot_schedule("monthly", 0, 0, 0).getWindows().empty());
+    QVERIFY(make_reboot_schedule(nullptr, 0, 0, 0).getWindows().empty());
+}
+
+void TestRebootSchedule::testCrontab()
+{
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 0, 3, 0, "6 04:30", "0 02:00-04:00");
+    // sunday is blacked out of the daily window, the weekday field lists the others
+    QCOMPARE(schedule.toCrontab("root", REBOOT_SCHEDULE_COMMAND),
+             string("0 3 * * 1,2,3,4,5,6 root /sbin/reboot\n30 4 * * 6 root /sbin/reboot\n"));
+    QCOMPARE(make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 0, 3, 0).toCrontab("root", REBOOT_SCHEDULE_COMMAND),
+             string("0 3 * * * root /sbin/reboot\n"));
+    QCOMPARE(schedule.toCrontab(nullptr, REBOOT_SCHEDULE_COMMAND), string());
+    QCOMPARE(RebootSchedule().toCrontab("root", REBOOT_SCHEDULE_COMMAND), string());
+}
+
+void TestRebootSchedule::testNextFireTimeDaily()
+{
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 0, 3, 0);
+    // wednesday morning before and after the window
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 1, 12, 2, 59))),
+             string("2022-01-12 03:00 Wed UTC"));
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 1, 12, 10, 0))),
+             string("2022-01-13 03:00 Thu UTC"));
+    // at the fire time the next one is a day later
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 1, 12, 3, 0))),
+             string("2022-01-13 03:00 Thu UTC"));
+    // over the end of a month and a year
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 12, 31, 12, 0))),
+             string("2023-01-01 03:00 Sun UTC"));
+}
+
+void TestRebootSchedule::testNextFireTimeWeekly()
+{
+    // saturday 04:30
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_WEEKLY, 30, 4, 6);
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 1, 12, 10, 0))),
+             string("2022-01-15 04:30 Sat UTC"));
+    // saturday after the window is a full week ahead
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 1, 15, 5, 0))),
+             string("2022-01-22 04:30 Sat UTC"));
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 1, 15, 4, 29))),
+             string("2022-01-15 04:30 Sat UTC"));
+}
+
+void TestRebootSchedule::testNextFireTimeSkipsBlackout()
+{
+    // daily 01:00, friday night into saturday is blacked out
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 0, 1, 0, "", "5 22:00-02:00");
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 1, 14, 12, 0))),
+             string("2022-01-16 01:00 Sun UTC"));
+    // friday 01:00 is before the blackout starts
+    QCOMPARE(_format_local(schedule.getNextFireTime(_local_time(2022, 1, 13, 12, 0))),
+             string("2022-01-14 01:00 Fri UTC"));
+}
+
+void TestRebootSchedule::testNextFireTimeMultipleWindows()
+{
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 0, 3, 0, "6 01:00, 23:30");
+    time_t now = _local_time(2022, 1, 14, 23, 45);
+    vector<string> fireTimes;
+    for (int i = 0; i < 5; i++)
+    {
+        now = schedule.getNextFireTime(now);
+        fireTimes.push_back(_format_local(now));
+    }
+    QCOMPARE(fireTimes, vector<string>({"2022-01-15 01:00 Sat UTC", "2022-01-15 03:00 Sat UTC",
+                                        "2022-01-15 23:30 Sat UTC", "2022-01-16 03:00 Sun UTC",
+                                        "2022-01-16 23:30 Sun UTC"}));
+}
+
+void TestRebootSchedule::testNextFireTimeNone()
+{
+    QCOMPARE(RebootSchedule().getNextFireTime(_local_time(2022, 1, 12, 10, 0)), (time_t)-1);
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_WEEKLY, 0, 3, 2, "", "2 00:00-23:59");
+    QCOMPARE(schedule.getNextFireTime(_local_time(2022, 1, 12, 10, 0)), (time_t)-1);
+}
+
+void TestRebootSchedule::testNextFireTimeDSTStart()
+{
+    _set_timezone(TZ_CENTRAL_EUROPE);
+    // 2022-03-27 02:00 CET jumps to 03:00 CEST, 02:30 does not exist that night
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 30, 2, 0);
+    time_t now = _local_time(2022, 3, 26, 12, 0);
+    time_t fireTime = schedule.getNextFireTime(now);
+    // still on that sunday, right after the gap like cron does
+    QCOMPARE(_format_local(fireTime), string("2022-03-27 03:30 Sun CEST"));
+    QCOMPARE(_format_local(schedule.getNextFireTime(fireTime)), string("2022-03-28 02:30 Mon CEST"));
+    // a window outside the gap keeps its wall clock on both sides
+    RebootSchedule later = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 0, 4, 0);
+    QCOMPARE(_format_local(later.getNextFireTime(now)), string("2022-03-27 04:00 Sun CEST"));
+    QCOMPARE(later.getNextFireTime(now) - now, (time_t)(15 * 3600));
+}
+
+void TestRebootSchedule::testNextFireTimeDSTEnd()
+{
+    _set_timezone(TZ_CENTRAL_EUROPE);
+    // 2022-10-30 03:00 CEST goes back to 02:00 CET, 02:30 happens twice
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 30, 2, 0);
+    time_t fireTime = schedule.getNextFireTime(_local_time(2022, 10, 29, 12, 0));
+    QCOMPARE(_format_local(fireTime), string("2022-10-30 02:30 Sun CEST"));
+    // once per night, the repeated hour does not fire again
+    time_t nextTime = schedule.getNextFireTime(fireTime);
+    QCOMPARE(_format_local(nextTime), string("2022-10-31 02:30 Mon CET"));
+    // the day is 25 hours long
+    QCOMPARE(nextTime - fireTime, (time_t)(25 * 3600));
+}
+
+void TestRebootSchedule::testNextFireTimeDSTEndSecondPass()
+{
+    _set_timezone(TZ_CENTRAL_EUROPE);
+    // rebooted at 02:30 CEST, the clock then shows 02:15 again after going back
+    RebootSchedule schedule = make_reboot_schedule(REBOOT_SCHEDULE_MODE_DAILY, 30, 2, 0);
+    QCOMPARE(_format_local(FALL_BACK_SECOND_0215), string("2022-10-30 02:15 Sun CET"));
+    QCOMPARE(_format_local(schedule.getNextFireTime(FALL_BACK_SECOND_0215)), string("2022-10-31 02:30 Mon CET"));
+}
+
+QTEST_GUILESS_MAIN(TestRebootSchedule)
+#include "tst_reboot_schedule.moc"
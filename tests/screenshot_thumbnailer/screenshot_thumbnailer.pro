@@ -0,0 +1,6 @@
+include(../tests.pri)
+TARGET = tst_screenshot_thumbnailer
+
+SOURCES += tst_screenshot_thumbnailer.cpp \
+    $$SRC_FOLDER/screenshot_thumbnailer.cpp \
+    $$SRC_FOLDER/utility.cpp
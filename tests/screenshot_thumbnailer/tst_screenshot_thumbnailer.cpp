@@ -0,0 +1,288 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "test_utility.h"
+#include "screenshot_thumbnailer.h"
+
+#define TEST_SCREENSHOT_NAME    SCREENSHOT_FILE_PREFIX "20221001-000000.png"
+
+// box filter against a plain 32 bit reference, and the mtime/size keyed disk cache
+class TestScreenshotThumbnailer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testThumbnailFactor();
+    void testDownscaleMatchesReference_data();
+    void testDownscaleMatchesReference();
+    void testDownscaleMaxIntensity();
+    void testDownscaleInvalid();
+    void testCacheHit();
+    void testCacheStaleMtimeNsec();
+    void testCacheStaleSize();
+    void testCacheCorrupted();
+    void testInvalidName();
+    void testPrune();
+
+private:
+    ThumbnailImage _create_image(int width, int height, unsigned int seed);
+    // what every simd path must match, no 16 bit accumulator
+    ThumbnailImage _reference_downscale(const ThumbnailImage &source, int factor);
+    bool _set_mtime(const string& path, time_t seconds, long nanoseconds);
+
+    string m_screenshotFolder;
+    string m_cacheFolder;
+    int m_decodeCount;
+    ThumbnailDecodeFunc m_decode;
+    QTemporaryDir m_folder;
+};
+
+void TestScreenshotThumbnailer::init()
+{
+    QVERIFY(m_folder.isValid());
+    string root = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    m_screenshotFolder = root + "/userdata";
+    m_cacheFolder = m_screenshotFolder + "/.screenshot-thumbnails";
+    QVERIFY(write_test_file(m_screenshotFolder + "/" TEST_SCREENSHOT_NAME, "png data"));
+    m_decodeCount = 0;
+    // stands in for the png decoder, 480x320 gives a 240x160 thumbnail
+    m_decode = [this](const string&, ThumbnailImage &image) {
+        m_decodeCount++;
+        image = _create_image(480, 320, 2022 + m_decodeCount);
+        return true;
+    };
+}
+
+ThumbnailImage TestScreenshotThumbnailer::_create_image(int width, int height, unsigned int seed)
+{
+    ThumbnailImage image(width, height);
+    unsigned char *pixels = image.getPixels();
+    for (size_t i = 0; i < (size_t)image.getStride() * height; i++)
+    {
+        // xorshift, same image on every run
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        pixels[i] = (unsigned char)(seed & 0xff);
+    }
+    return image;
+}
+
+ThumbnailImage TestScreenshotThumbnailer::_reference_downscale(const ThumbnailImage &source, int factor)
+{
+    int width = source.getWidth() / factor;
+    int height = source.getHeight() / factor;
+    ThumbnailImage thumbnail(width, height);
+    uint32_t area = (uint32_t)factor * factor;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            for (int channel = 0; channel < 4; channel++)
+            {
+                uint32_t total = 0;
+                for (int row = 0; row < factor; row++)
+                {
+                    const unsigned char *line = source.getPixels() + (size_t)(y * factor + row) * source.getStride();
+                    for (int column = 0; column < factor; column++)
+                    {
+                        total += line[(x * factor + column) * 4 + channel];
+                    }
+                }
+                thumbnail.getPixels()[(size_t)y * thumbnail.getStride() + x * 4 + channel] =
+                    (unsigned char)((total + area / 2) / area);
+            }
+        }
+    }
+    return thumbnail;
+}
+
+bool TestScreenshotThumbnailer::_set_mtime(const string& path, time_t seconds, long nanoseconds)
+{
+    struct timespec times[2];
+    times[0].tv_sec = seconds;
+    times[0].tv_nsec = nanoseconds;
+    times[1] = times[0];
+    return utimensat(AT_FDCWD, path.c_str(), times, 0) == 0;
+}
+
+void TestScreenshotThumbnailer::testThumbnailFactor()
+{
+    QCOMPARE(get_thumbnail_factor(1920, 1080), 8);
+    QCOMPARE(get_thumbnail_factor(240, 160), 1);
+    QCOMPARE(get_thumbnail_factor(241, 160), 2);
+    QCOMPARE(get_thumbnail_factor(100, 50), 1);
+    QCOMPARE(get_thumbnail_factor(0, 1080), 1);
+    // never more than the 16 bit accumulator holds
+    QCOMPARE(get_thumbnail_factor(1000000, 10), SCREENSHOT_THUMBNAIL_MAX_FACTOR);
+}
+
+void TestScreenshotThumbnailer::testDownscaleMatchesReference_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("factor");
+    // row byte counts that are not a multiple of 16 run the scalar tail after the simd loop
+    QTest::newRow("identity") << 5 << 3 << 1;
+    QTest::newRow("odd 3") << 1001 << 333 << 3;
+    QTest::newRow("odd 7 remainder") << 97 << 59 << 7;
+    QTest::newRow("one column") << 13 << 13 << 13;
+    QTest::newRow("1080p") << 1920 << 1080 << 8;
+    QTest::newRow("portrait 17") << 301 << 1283 << 17;
+    QTest::newRow("max factor") << 517 << 263 << SCREENSHOT_THUMBNAIL_MAX_FACTOR;
+}
+
+void TestScreenshotThumbnailer::testDownscaleMatchesReference()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, factor);
+    ThumbnailImage source = _create_image(width, height, (unsigned int)(width * 31 + height));
+    ThumbnailImage thumbnail;
+    QVERIFY(box_downscale(source, factor, thumbnail));
+    ThumbnailImage expected = _reference_downscale(source, factor);
+    QCOMPARE(thumbnail.getWidth(), width / factor);
+    QCOMPARE(thumbnail.getHeight(), height / factor);
+    QVERIFY(memcmp(thumbnail.getPixels(), expected.getPixels(), (size_t)expected.getStride() * expected.getHeight()) == 0);
+}
+
+void TestScreenshotThumbnailer::testDownscaleMaxIntensity()
+{
+    // 255 rows of 255 per column sum to 65025, a 16 bit overflow would wrap and darken the result
+    int factor = SCREENSHOT_THUMBNAIL_MAX_FACTOR;
+    ThumbnailImage source(factor * 2 + 3, factor + 1);
+    memset(source.getPixels(), 0xff, (size_t)source.getStride() * source.getHeight());
+    ThumbnailImage thumbnail;
+    QVERIFY(box_downscale(source, factor, thumbnail));
+    QCOMPARE(thumbnail.getWidth(), 2);
+    QCOMPARE(thumbnail.getHeight(), 1);
+    for (int i = 0; i < thumbnail.getStride() * thumbnail.getHeight(); i++)
+    {
+        QCOMPARE((int)thumbnail.getPixels()[i], 0xff);
+    }
+    // one channel bright, the others dark, channels must not bleed into each other
+    for (int i = 0; i < source.getStride() * source.getHeight(); i++)
+    {
+        source.getPixels()[i] = (i % 4 == 1) ? 0xff : 0;
+    }
+    QVERIFY(box_downscale(source, factor, thumbnail));
+    ThumbnailImage expected = _reference_downscale(source, factor);
+    QVERIFY(memcmp(thumbnail.getPixels(), expected.getPixels(), (size_t)expected.getStride() * expected.getHeight()) == 0);
+    QCOMPARE((int)thumbnail.getPixels()[0], 0);
+    QCOMPARE((int)thumbnail.getPixels()[1], 0xff);
+}
+
+void TestScreenshotThumbnailer::testDownscaleInvalid()
+{
+    ThumbnailImage source(10, 10);
+    ThumbnailImage thumbnail;
+    QVERIFY(!box_downscale(source, 0, thumbnail));
+    QVERIFY(!box_downscale(source, SCREENSHOT_THUMBNAIL_MAX_FACTOR + 1, thumbnail));
+    QVERIFY(!box_downscale(source, 11, thumbnail));
+}
+
+void TestScreenshotThumbnailer::testCacheHit()
+{
+    ScreenshotThumbnailer thumbnailer(m_screenshotFolder.c_str(), m_cacheFolder.c_str());
+    auto first = thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode);
+    QVERIFY(first.second);
+    QCOMPARE(first.first.getWidth(), SCREENSHOT_THUMBNAIL_MAX_WIDTH);
+    QCOMPARE(first.first.getHeight(), SCREENSHOT_THUMBNAIL_MAX_HEIGHT);
+    QCOMPARE(m_decodeCount, 1);
+    // a new thumbnailer reads what the first one cached
+    ScreenshotThumbnailer other(m_screenshotFolder.c_str(), m_cacheFolder.c_str());
+    auto second = other.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode);
+    QVERIFY(second.second);
+    QCOMPARE(m_decodeCount, 1);
+    QVERIFY(memcmp(first.first.getPixels(), second.first.getPixels(),
+        (size_t)first.first.getStride() * first.first.getHeight()) == 0);
+}
+
+void TestScreenshotThumbnailer::testCacheStaleMtimeNsec()
+{
+    string path = m_screenshotFolder + "/" TEST_SCREENSHOT_NAME;
+    QVERIFY(_set_mtime(path, 1664582400, 100));
+    ScreenshotThumbnailer thumbnailer(m_screenshotFolder.c_str(), m_cacheFolder.c_str());
+    auto first = thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode);
+    QVERIFY(first.second);
+    QCOMPARE(m_decodeCount, 1);
+    // overwritten within the same second, same size
+    QVERIFY(write_test_file(path, "PNG DATA"));
+    QVERIFY(_set_mtime(path, 1664582400, 200));
+    auto second = thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode);
+    QVERIFY(second.second);
+    QCOMPARE(m_decodeCount, 2);
+    // the decoder returned another image this time
+    QVERIFY(memcmp(first.first.getPixels(), second.first.getPixels(),
+        (size_t)first.first.getStride() * first.first.getHeight()) != 0);
+    // and that one is cached now
+    QVERIFY(thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode).second);
+    QCOMPARE(m_decodeCount, 2);
+}
+
+void TestScreenshotThumbnailer::testCacheStaleSize()
+{
+    string path = m_screenshotFolder + "/" TEST_SCREENSHOT_NAME;
+    QVERIFY(_set_mtime(path, 1664582400, 0));
+    ScreenshotThumbnailer thumbnailer(m_screenshotFolder.c_str(), m_cacheFolder.c_str());
+    QVERIFY(thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode).second);
+    // same mtime, other size
+    QVERIFY(write_test_file(path, "longer png data"));
+    QVERIFY(_set_mtime(path, 1664582400, 0));
+    QVERIFY(thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode).second);
+    QCOMPARE(m_decodeCount, 2);
+}
+
+void TestScreenshotThumbnailer::testCacheCorrupted()
+{
+    ScreenshotThumbnailer thumbnailer(m_screenshotFolder.c_str(), m_cacheFolder.c_str());
+    QVERIFY(thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode).second);
+    string cachePath = m_cacheFolder + "/" TEST_SCREENSHOT_NAME SCREENSHOT_THUMBNAIL_EXTENSION;
+    string cache = read_test_file(cachePath);
+    QVERIFY(!cache.empty());
+    // cut pixel data
+    QVERIFY(write_test_file(cachePath, cache.substr(0, cache.size() / 2)));
+    QVERIFY(thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode).second);
+    QCOMPARE(m_decodeCount, 2);
+    // wrong magic
+    cache = read_test_file(cachePath);
+    cache[0] = 'X';
+    QVERIFY(write_test_file(cachePath, cache));
+    QVERIFY(thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode).second);
+    QCOMPARE(m_decodeCount, 3);
+}
+
+void TestScreenshotThumbnailer::testInvalidName()
+{
+    ScreenshotThumbnailer thumbnailer(m_screenshotFolder.c_str(), m_cacheFolder.c_str());
+    QVERIFY(!thumbnailer.get_thumbnail("../" TEST_SCREENSHOT_NAME, m_decode).second);
+    QVERIFY(!thumbnailer.get_thumbnail("settings.ini", m_decode).second);
+    QVERIFY(!thumbnailer.get_thumbnail(SCREENSHOT_FILE_PREFIX "missing.png", m_decode).second);
+    QVERIFY(!thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, nullptr).second);
+    QCOMPARE(m_decodeCount, 0);
+}
+
+void TestScreenshotThumbnailer::testPrune()
+{
+    ScreenshotThumbnailer thumbnailer(m_screenshotFolder.c_str(), m_cacheFolder.c_str());
+    QVERIFY(thumbnailer.get_thumbnail(TEST_SCREENSHOT_NAME, m_decode).second);
+    string keptPath = m_cacheFolder + "/" TEST_SCREENSHOT_NAME SCREENSHOT_THUMBNAIL_EXTENSION;
+    string deletedPath = m_cacheFolder + "/" SCREENSHOT_FILE_PREFIX "deleted.png" SCREENSHOT_THUMBNAIL_EXTENSION;
+    QVERIFY(write_test_file(deletedPath, "old"));
+    QVERIFY(write_test_file(m_cacheFolder + "/.keep", ""));
+    thumbnailer.prune(vector<string>({TEST_SCREENSHOT_NAME}));
+    QVERIFY(is_file_exist(keptPath.c_str()));
+    QVERIFY(!is_file_exist(deletedPath.c_str()));
+    QVERIFY(is_file_exist((m_cacheFolder + "/.keep").c_str()));
+}
+
+QTEST_GUILESS_MAIN(TestScreenshotThumbnailer)
+#include "tst_screenshot_thumbnailer.moc"
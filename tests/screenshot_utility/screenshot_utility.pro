@@ -0,0 +1,15 @@
+include(../tests.pri)
+TARGET = tst_screenshot_utility
+
+# same compression as the application, CONFIG+=screenshot_zstd for zstd
+screenshot_zstd {
+    DEFINES += SCREENSHOT_ARCHIVE_ZSTD
+    LIBS += -lzstd
+} else {
+    LIBS += -lz
+}
+
+SOURCES += tst_screenshot_utility.cpp \
+    $$SRC_FOLDER/screenshot_utility.cpp \
+    $$SRC_FOLDER/storage_utility.cpp \
+    $$SRC_FOLDER/utility.cpp
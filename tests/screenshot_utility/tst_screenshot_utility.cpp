@@ -0,0 +1,383 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <cstring>
+#include <memory>
+#include <atomic>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/statvfs.h>
+#ifdef SCREENSHOT_ARCHIVE_ZSTD
+#include <zstd.h>
+#else
+#include <zlib.h>
+#endif
+
+#include "test_utility.h"
+#include "screenshot_utility.h"
+
+// unit tests use a few small files
+#define TEST_SCREENSHOT_COUNT       5
+#define TEST_SCREENSHOT_SIZE        (100 * 1024 + 7)
+// benchmark set, about what a day of screenshots on a panel adds up to
+#define BENCHMARK_SCREENSHOT_COUNT  300
+#define BENCHMARK_SCREENSHOT_SIZE   (150 * 1024)
+#define BENCHMARK_TMPFS_FOLDER      "/dev/shm"
+#define TAR_BLOCK_SIZE              512
+
+// tar entry name and content
+using ArchiveEntry = pair<string, string>;
+
+class TestScreenshotUtility : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void testGetScreenshots();
+    void testExportPerFile();
+    void testExportIntoScreenshotFolder();
+    void testExportIntoParentFolder();
+    void testExportIntoPrefixSibling();
+    void testExportPerFileCancelled();
+    void testExportCancelledBeforeStart();
+    void testExportWithoutScreenshots();
+    void testArchiveContent();
+    void testArchiveNotOverwritten();
+    void testArchiveMissingFolder();
+    void testArchiveCancelled();
+    void benchmarkPerFileCopy();
+    void benchmarkArchive();
+
+private:
+    // png data is already compressed, random bytes behave the same
+    bool _create_screenshots(const string& folder, int count, int size);
+    string _create_export_folder(const string& name);
+    vector<ArchiveEntry> _read_archive(const string& path);
+    void _remove_folder(const string& folder);
+    int _count_files(const string& folder, const char* prefix);
+
+    string m_screenshotFolder;
+    string m_exportFolder;
+    string m_benchmarkFolder;
+    string m_benchmarkExportRoot;
+    QTemporaryDir m_folder;
+    unique_ptr<QTemporaryDir> m_tmpfsFolder;
+};
+
+void TestScreenshotUtility::initTestCase()
+{
+    QVERIFY(m_folder.isValid());
+    m_benchmarkFolder = m_folder.path().toStdString() + "/benchmark";
+    QVERIFY(_create_screenshots(m_benchmarkFolder, BENCHMARK_SCREENSHOT_COUNT, BENCHMARK_SCREENSHOT_SIZE));
+    // target on tmpfs measures the cpu cost without the media, else fall back to the temp folder
+    m_benchmarkExportRoot = m_folder.path().toStdString() + "/benchmark_export";
+    struct statvfs fsStat;
+    unsigned long long needed = 2ULL * BENCHMARK_SCREENSHOT_COUNT * BENCHMARK_SCREENSHOT_SIZE;
+    if (statvfs(BENCHMARK_TMPFS_FOLDER, &fsStat) == 0 && (unsigned long long)fsStat.f_bavail * fsStat.f_frsize > needed)
+    {
+        m_tmpfsFolder.reset(new QTemporaryDir(QString(BENCHMARK_TMPFS_FOLDER) + "/tst_screenshot_XXXXXX"));
+        if (m_tmpfsFolder->isValid())
+            m_benchmarkExportRoot = m_tmpfsFolder->path().toStdString();
+    }
+    qDebug("benchmark export folder:%s", m_benchmarkExportRoot.c_str());
+}
+
+void TestScreenshotUtility::init()
+{
+    string root = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    m_screenshotFolder = root + "/userdata";
+    m_exportFolder = root + "/usb";
+    QVERIFY(_create_screenshots(m_screenshotFolder, TEST_SCREENSHOT_COUNT, TEST_SCREENSHOT_SIZE));
+    // not a screenshot, never exported
+    QVERIFY(write_test_file(m_screenshotFolder + "/settings.ini", "[core]\n"));
+    QVERIFY(write_test_file(m_exportFolder + "/.keep", ""));
+}
+
+bool TestScreenshotUtility::_create_screenshots(const string& folder, int count, int size)
+{
+    unsigned int seed = 2022;
+    for (int i = 0; i < count; i++)
+    {
+        string content(size, 0);
+        for (auto &c : content)
+        {
+            // xorshift, same files on every run
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            c = (char)(seed & 0xff);
+        }
+        char name_buff[64] = {0};
+        snprintf(name_buff, sizeof(name_buff), SCREENSHOT_FILE_PREFIX "20221001-%06d.png", i);
+        if (!write_test_file(folder + "/" + name_buff, content))
+            return false;
+    }
+    return true;
+}
+
+string TestScreenshotUtility::_create_export_folder(const string& name)
+{
+    string folder = m_benchmarkExportRoot + "/" + name;
+    write_test_file(folder + "/.keep", "");
+    return folder;
+}
+
+void TestScreenshotUtility::_remove_folder(const string& folder)
+{
+    DIR *dir = opendir(folder.c_str());
+    if (!dir)
+        return;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+            unlink((folder + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+    rmdir(folder.c_str());
+}
+
+int TestScreenshotUtility::_count_files(const string& folder, const char* prefix)
+{
+    int count = 0;
+    DIR *dir = opendir(folder.c_str());
+    if (!dir)
+        return count;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strncmp(entry->d_name, prefix, strlen(prefix)) == 0)
+            count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+vector<ArchiveEntry> TestScreenshotUtility::_read_archive(const string& path)
+{
+    vector<ArchiveEntry> entries;
+    string tar;
+#ifdef SCREENSHOT_ARCHIVE_ZSTD
+    string compressed = read_test_file(path);
+    ZSTD_DStream *stream = ZSTD_createDStream();
+    ZSTD_initDStream(stream);
+    ZSTD_inBuffer input = {compressed.data(), compressed.size(), 0};
+    vector<char> buff(ZSTD_DStreamOutSize());
+    while (input.pos < input.size)
+    {
+        ZSTD_outBuffer output = {buff.data(), buff.size(), 0};
+        if (ZSTD_isError(ZSTD_decompressStream(stream, &output, &input)))
+            break;
+        tar.append(buff.data(), output.pos);
+    }
+    ZSTD_freeDStream(stream);
+#else
+    gzFile file = gzopen(path.c_str(), "rb");
+    if (!file)
+        return entries;
+    char buff[64 * 1024];
+    int len = 0;
+    while ((len = gzread(file, buff, sizeof(buff))) > 0)
+    {
+        tar.append(buff, len);
+    }
+    gzclose(file);
+#endif
+    // ustar headers, two zero blocks end the archive
+    size_t pos = 0;
+    while (pos + TAR_BLOCK_SIZE <= tar.size() && tar[pos] != 0)
+    {
+        string name(tar.c_str() + pos);
+        unsigned long long size = strtoull(tar.substr(pos + 124, 12).c_str(), nullptr, 8);
+        if (tar.compare(pos + 257, 5, "ustar") != 0)
+            break;
+        pos += TAR_BLOCK_SIZE;
+        entries.push_back(make_pair(name, tar.substr(pos, size)));
+        pos += (size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+    }
+    return entries;
+}
+
+void TestScreenshotUtility::testGetScreenshots()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    auto ret = screenshotUtil.get_screenshots();
+    QVERIFY(ret.second);
+    QCOMPARE((int)ret.first.size(), TEST_SCREENSHOT_COUNT);
+    QCOMPARE(ret.first.front(), string(SCREENSHOT_FILE_PREFIX "20221001-000000.png"));
+    QCOMPARE(screenshotUtil.get_screenshots_count(), TEST_SCREENSHOT_COUNT);
+}
+
+void TestScreenshotUtility::testExportPerFile()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    int lastDone = 0;
+    auto ret = screenshotUtil.export_screenshots(m_exportFolder.c_str(),
+        [&lastDone](int doneFiles, int totalFiles, const string&, double) {
+            QCOMPARE(totalFiles, TEST_SCREENSHOT_COUNT);
+            lastDone = max(lastDone, doneFiles);
+        });
+    QVERIFY(ret.second);
+    QCOMPARE(lastDone, TEST_SCREENSHOT_COUNT);
+    for (auto &fileName : screenshotUtil.get_screenshots().first)
+    {
+        QVERIFY(read_test_file(m_exportFolder + "/" + fileName) == read_test_file(m_screenshotFolder + "/" + fileName));
+    }
+    QVERIFY(read_test_file(m_exportFolder + "/settings.ini").empty());
+}
+
+void TestScreenshotUtility::testExportIntoScreenshotFolder()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    QVERIFY(!screenshotUtil.export_screenshots(m_screenshotFolder.c_str(), nullptr).second);
+    QVERIFY(!screenshotUtil.export_screenshots_archive(m_screenshotFolder.c_str(), nullptr).second);
+}
+
+void TestScreenshotUtility::testExportIntoParentFolder()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    string parent = m_screenshotFolder.substr(0, m_screenshotFolder.rfind('/'));
+    QVERIFY(!screenshotUtil.export_screenshots(parent.c_str(), nullptr).second);
+    // trailing slash and a symlink name the same folder
+    string slash = m_screenshotFolder + "/";
+    QVERIFY(!screenshotUtil.export_screenshots_archive(slash.c_str(), nullptr).second);
+    string link = m_exportFolder + "/userdata_link";
+    QVERIFY(create_test_symlink(m_screenshotFolder, link));
+    QVERIFY(!screenshotUtil.export_screenshots(link.c_str(), nullptr).second);
+}
+
+void TestScreenshotUtility::testExportIntoPrefixSibling()
+{
+    // userdata2 starts with the same characters but is another folder
+    string sibling = m_screenshotFolder + "2";
+    QVERIFY(write_test_file(sibling + "/.keep", ""));
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    QVERIFY(screenshotUtil.export_screenshots(sibling.c_str(), nullptr).second);
+    QCOMPARE(_count_files(sibling, SCREENSHOT_FILE_PREFIX), TEST_SCREENSHOT_COUNT);
+    // and the reverse, screenshots in userdata2 may go to userdata
+    TPCScreenshotUtility siblingUtil(sibling.c_str());
+    QVERIFY(siblingUtil.export_screenshots_archive(m_exportFolder.c_str(), nullptr).second);
+}
+
+void TestScreenshotUtility::testExportPerFileCancelled()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    std::atomic<int> checks(0);
+    // a few chunks go through before the cancel
+    auto ret = screenshotUtil.export_screenshots(m_exportFolder.c_str(), nullptr,
+        [&checks] { return ++checks > 3; });
+    QVERIFY(!ret.second);
+    QCOMPARE(ret.first, string("Export screenshots is cancelled."));
+    QVERIFY(_count_files(m_exportFolder, SCREENSHOT_FILE_PREFIX) < TEST_SCREENSHOT_COUNT);
+}
+
+void TestScreenshotUtility::testExportCancelledBeforeStart()
+{
+    // ex: cancel pressed while the job still waits in the scheduler queue
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    int progressCount = 0;
+    auto progress = [&progressCount](int, int, const string&, double) { progressCount++; };
+    auto ret = screenshotUtil.export_screenshots(m_exportFolder.c_str(), progress, [] { return true; });
+    QVERIFY(!ret.second);
+    auto retArchive = screenshotUtil.export_screenshots_archive(m_exportFolder.c_str(), progress, [] { return true; });
+    QVERIFY(!retArchive.second);
+    QCOMPARE(progressCount, 0);
+    QCOMPARE(_count_files(m_exportFolder, SCREENSHOT_FILE_PREFIX), 0);
+    QCOMPARE(_count_files(m_exportFolder, SCREENSHOT_ARCHIVE_PREFIX), 0);
+    // a later export is not affected
+    QVERIFY(screenshotUtil.export_screenshots(m_exportFolder.c_str(), nullptr).second);
+}
+
+void TestScreenshotUtility::testExportWithoutScreenshots()
+{
+    TPCScreenshotUtility screenshotUtil(m_exportFolder.c_str());
+    auto ret = screenshotUtil.export_screenshots_archive(m_screenshotFolder.c_str(), nullptr);
+    QVERIFY(!ret.second);
+    QVERIFY(!ret.first.empty());
+}
+
+void TestScreenshotUtility::testArchiveContent()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    auto ret = screenshotUtil.export_screenshots_archive(m_exportFolder.c_str(), nullptr);
+    QVERIFY(ret.second);
+    QVERIFY(ret.first.rfind(m_exportFolder + "/" SCREENSHOT_ARCHIVE_PREFIX, 0) == 0);
+    auto entries = _read_archive(ret.first);
+    QCOMPARE((int)entries.size(), TEST_SCREENSHOT_COUNT + 1);
+    // manifest first, one line per screenshot in export order
+    QCOMPARE(entries[0].first, string(SCREENSHOT_MANIFEST_NAME));
+    auto screenshots = screenshotUtil.get_screenshots().first;
+    for (int i = 0; i < TEST_SCREENSHOT_COUNT; i++)
+    {
+        const string &fileName = screenshots[i];
+        QCOMPARE(entries[i + 1].first, fileName);
+        QVERIFY(entries[i + 1].second == read_test_file(m_screenshotFolder + "/" + fileName));
+        string line = fileName + "\t" + to_string(TEST_SCREENSHOT_SIZE) + "\t";
+        QVERIFY(entries[0].second.find(line) != string::npos);
+    }
+}
+
+void TestScreenshotUtility::testArchiveNotOverwritten()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    auto first = screenshotUtil.export_screenshots_archive(m_exportFolder.c_str(), nullptr);
+    auto second = screenshotUtil.export_screenshots_archive(m_exportFolder.c_str(), nullptr);
+    QVERIFY(first.second);
+    QVERIFY(second.second);
+    QVERIFY(first.first != second.first);
+    QCOMPARE((int)_read_archive(first.first).size(), TEST_SCREENSHOT_COUNT + 1);
+}
+
+void TestScreenshotUtility::testArchiveMissingFolder()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    string missing = m_exportFolder + "/missing";
+    QVERIFY(!screenshotUtil.export_screenshots_archive(missing.c_str(), nullptr).second);
+}
+
+void TestScreenshotUtility::testArchiveCancelled()
+{
+    TPCScreenshotUtility screenshotUtil(m_screenshotFolder.c_str());
+    // cancel from the progress callback, like the cancel button during export
+    bool isCancelled = false;
+    auto ret = screenshotUtil.export_screenshots_archive(m_exportFolder.c_str(),
+        [&isCancelled](int doneFiles, int, const string&, double) {
+            if (doneFiles == 2)
+                isCancelled = true;
+        },
+        [&isCancelled] { return isCancelled; });
+    QVERIFY(!ret.second);
+    // partial archive is removed
+    QCOMPARE(_count_files(m_exportFolder, SCREENSHOT_ARCHIVE_PREFIX), 0);
+}
+
+void TestScreenshotUtility::benchmarkPerFileCopy()
+{
+    TPCScreenshotUtility screenshotUtil(m_benchmarkFolder.c_str());
+    string folder = _create_export_folder("per_file");
+    bool result = false;
+    QBENCHMARK_ONCE {
+        result = screenshotUtil.export_screenshots(folder.c_str(), nullptr).second;
+    }
+    _remove_folder(folder);
+    QVERIFY(result);
+}
+
+void TestScreenshotUtility::benchmarkArchive()
+{
+    TPCScreenshotUtility screenshotUtil(m_benchmarkFolder.c_str());
+    string folder = _create_export_folder("archive");
+    bool result = false;
+    QBENCHMARK_ONCE {
+        result = screenshotUtil.export_screenshots_archive(folder.c_str(), nullptr).second;
+    }
+    _remove_folder(folder);
+    QVERIFY(result);
+}
+
+QTEST_GUILESS_MAIN(TestScreenshotUtility)
+#include "tst_screenshot_utility.moc"
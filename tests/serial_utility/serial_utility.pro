@@ -0,0 +1,5 @@
+include(../tests.pri)
+TARGET = tst_serial_utility
+
+SOURCES += tst_serial_utility.cpp \
+    $$SRC_FOLDER/serial_utility.cpp
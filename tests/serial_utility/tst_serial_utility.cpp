@@ -0,0 +1,236 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdlib>
+#include <QtTest>
+#include <QElapsedTimer>
+#ifdef _WIN32
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#include "serial_utility.h"
+
+using namespace std;
+
+// pty pair standing in for a COM port with a loopback plug: bytes written to
+// the master come out of the slave, which is configured like a real port
+class TestSerialUtility : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testMakeConfig();
+    void testConfigureReadBack_data();
+    void testConfigureReadBack();
+    void testConfigureInvalid();
+    void testRS485NotSupported();
+    void testBenchmarkPtyPair();
+    void testBenchmarkRestoresFlags();
+    void testBenchmarkNoLoopback();
+    void testBenchmarkCancelled();
+    void testBenchmarkInvalid();
+    void testLatencyStatistics();
+    void testEfficiency();
+
+private:
+    int m_masterFd = -1;
+    int m_slaveFd = -1;
+};
+
+void TestSerialUtility::init()
+{
+    m_masterFd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (m_masterFd < 0)
+        QSKIP("no pty");
+    QVERIFY(grantpt(m_masterFd) == 0);
+    QVERIFY(unlockpt(m_masterFd) == 0);
+    const char *slaveName = ptsname(m_masterFd);
+    QVERIFY(slaveName);
+    m_slaveFd = open(slaveName, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    QVERIFY(m_slaveFd >= 0);
+}
+
+void TestSerialUtility::cleanup()
+{
+    if (m_slaveFd >= 0)
+        close(m_slaveFd);
+    if (m_masterFd >= 0)
+        close(m_masterFd);
+    m_slaveFd = -1;
+    m_masterFd = -1;
+}
+
+void TestSerialUtility::testMakeConfig()
+{
+    SerialPortConfig config = make_serial_config(115200, SERIAL_MODE_RS485);
+    QCOMPARE(config.baudrate, 115200);
+    QCOMPARE(config.dataBits, 8);
+    QCOMPARE(config.parity, 'N');
+    QCOMPARE(config.stopBits, 1);
+    QCOMPARE(config.mode, string(SERIAL_MODE_RS485));
+    QVERIFY(config.lowLatency);
+
+    config = make_serial_config(0, nullptr);
+    QCOMPARE(config.baudrate, SERIAL_DEFAULT_BAUDRATE);
+    QCOMPARE(config.mode, string(SERIAL_MODE_RS232));
+}
+
+void TestSerialUtility::testConfigureReadBack_data()
+{
+    QTest::addColumn<int>("baudrate");
+    QTest::addColumn<int>("stopBits");
+
+    QTest::newRow("1200 1") << 1200 << 1;
+    QTest::newRow("9600 1") << 9600 << 1;
+    QTest::newRow("19200 2") << 19200 << 2;
+    QTest::newRow("115200 1") << 115200 << 1;
+    QTest::newRow("921600 2") << 921600 << 2;
+}
+
+void TestSerialUtility::testConfigureReadBack()
+{
+    QFETCH(int, baudrate);
+    QFETCH(int, stopBits);
+
+    SerialPortConfig config = make_serial_config(baudrate, SERIAL_MODE_RS232);
+    config.stopBits = stopBits;
+    QVERIFY(configure_serial_port(m_slaveFd, config));
+
+    const auto ret = read_serial_port_config(m_slaveFd);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.baudrate, baudrate);
+    QCOMPARE(ret.first.stopBits, stopBits);
+    // the pty driver always keeps 8 data bits without parity
+    QCOMPARE(ret.first.dataBits, 8);
+    QCOMPARE(ret.first.parity, 'N');
+    QCOMPARE(ret.first.mode, string(SERIAL_MODE_RS232));
+    // a pty has no serial_struct
+    QVERIFY(!ret.first.lowLatency);
+}
+
+void TestSerialUtility::testConfigureInvalid()
+{
+    SerialPortConfig config = make_serial_config(12345, SERIAL_MODE_RS232);
+    QVERIFY(!configure_serial_port(m_slaveFd, config));
+    config = make_serial_config(9600, SERIAL_MODE_RS232);
+    config.dataBits = 9;
+    QVERIFY(!configure_serial_port(m_slaveFd, config));
+    config.dataBits = 8;
+    config.stopBits = 3;
+    QVERIFY(!configure_serial_port(m_slaveFd, config));
+    QVERIFY(!configure_serial_port(-1, make_serial_config(9600, SERIAL_MODE_RS232)));
+    QVERIFY(!read_serial_port_config(-1).second);
+}
+
+void TestSerialUtility::testRS485NotSupported()
+{
+    // the driver is asked for rs485 and refuses
+    QVERIFY(!configure_serial_port(m_slaveFd, make_serial_config(9600, SERIAL_MODE_RS485)));
+    // rs422 is only a transceiver setting, termios is enough
+    QVERIFY(configure_serial_port(m_slaveFd, make_serial_config(9600, SERIAL_MODE_RS422)));
+}
+
+void TestSerialUtility::testBenchmarkPtyPair()
+{
+    QVERIFY(configure_serial_port(m_slaveFd, make_serial_config(115200, SERIAL_MODE_RS232)));
+    const size_t bytes = 8192;
+    const auto ret = run_serial_benchmark(m_masterFd, m_slaveFd, bytes, SERIAL_BENCHMARK_ROUNDS);
+    QVERIFY(ret.second);
+    SerialBenchmarkResult result = ret.first;
+    QCOMPARE(result.getBytes(), (unsigned long long)bytes);
+    QCOMPARE(result.getErrors(), 0);
+    QVERIFY(result.getSeconds() > 0);
+    QVERIFY(result.getThroughput() > 0);
+    QVERIFY(result.getLatencyAverage() > 0);
+    QVERIFY(result.getLatencyPercentile(50) <= result.getLatencyMax());
+    QVERIFY(!result.toString().empty());
+}
+
+void TestSerialUtility::testBenchmarkRestoresFlags()
+{
+    QVERIFY(configure_serial_port(m_slaveFd, make_serial_config(9600, SERIAL_MODE_RS232)));
+    int masterFlags = fcntl(m_masterFd, F_GETFL);
+    int slaveFlags = fcntl(m_slaveFd, F_GETFL);
+    QVERIFY(run_serial_benchmark(m_masterFd, m_slaveFd, SERIAL_BENCHMARK_MIN_BYTES, 1).second);
+    QCOMPARE(fcntl(m_masterFd, F_GETFL), masterFlags);
+    QCOMPARE(fcntl(m_slaveFd, F_GETFL), slaveFlags);
+}
+
+void TestSerialUtility::testBenchmarkCancelled()
+{
+    QVERIFY(configure_serial_port(m_slaveFd, make_serial_config(115200, SERIAL_MODE_RS232)));
+    int masterFlags = fcntl(m_masterFd, F_GETFL);
+    // cancelled after a few chunks of the throughput part
+    int checks = 0;
+    auto ret = run_serial_benchmark(m_masterFd, m_slaveFd, SERIAL_BENCHMARK_MAX_BYTES, SERIAL_BENCHMARK_ROUNDS,
+                                    [&checks] { return ++checks > 3; });
+    QVERIFY(!ret.second);
+    QVERIFY(ret.first.getBytes() < (unsigned long long)SERIAL_BENCHMARK_MAX_BYTES);
+    QCOMPARE(fcntl(m_masterFd, F_GETFL), masterFlags);
+    // and between the latency rounds
+    checks = 0;
+    ret = run_serial_benchmark(m_masterFd, m_slaveFd, SERIAL_BENCHMARK_MIN_BYTES, SERIAL_BENCHMARK_ROUNDS,
+                               [&checks] { return ++checks > 10; });
+    QVERIFY(!ret.second);
+    QCOMPARE(ret.first.getBytes(), (unsigned long long)SERIAL_BENCHMARK_MIN_BYTES);
+}
+
+void TestSerialUtility::testBenchmarkNoLoopback()
+{
+    QVERIFY(configure_serial_port(m_slaveFd, make_serial_config(9600, SERIAL_MODE_RS232)));
+    // written to the slave input, nothing comes back on the master
+    QElapsedTimer timer;
+    timer.start();
+    auto ret = run_serial_benchmark(m_masterFd, m_masterFd, SERIAL_BENCHMARK_MIN_BYTES, 1);
+    QVERIFY(!ret.second);
+    QCOMPARE(ret.first.getBytes(), 0ULL);
+    QVERIFY(timer.elapsed() >= SERIAL_BENCHMARK_IDLE_MS - 100);
+    QVERIFY(timer.elapsed() < SERIAL_BENCHMARK_IDLE_MS * 3);
+}
+
+void TestSerialUtility::testBenchmarkInvalid()
+{
+    QVERIFY(!run_serial_benchmark(-1, m_slaveFd, SERIAL_BENCHMARK_MIN_BYTES, 1).second);
+    QVERIFY(!run_serial_benchmark(m_masterFd, m_slaveFd, 0, 1).second);
+    QVERIFY(!run_serial_benchmark(m_masterFd, m_slaveFd, SERIAL_BENCHMARK_MIN_BYTES, -1).second);
+}
+
+void TestSerialUtility::testLatencyStatistics()
+{
+    SerialBenchmarkResult result;
+    QCOMPARE(result.getLatencyAverage(), 0.0);
+    QCOMPARE(result.getLatencyPercentile(50), 0.0);
+    vector<double> latencies;
+    // 100 down to 1 us, sorted on set
+    for (int i = 100; i >= 1; i--)
+        latencies.push_back(i);
+    result.setLatencies(latencies);
+    QCOMPARE(result.getLatencyAverage(), 50.5);
+    QCOMPARE(result.getLatencyPercentile(50), 50.0);
+    QCOMPARE(result.getLatencyPercentile(99), 99.0);
+    QCOMPARE(result.getLatencyPercentile(0), 1.0);
+    QCOMPARE(result.getLatencyPercentile(100), 100.0);
+    QCOMPARE(result.getLatencyMax(), 100.0);
+}
+
+void TestSerialUtility::testEfficiency()
+{
+    SerialBenchmarkResult result;
+    // 960 bytes per second fill a 9600 baud 8N1 line
+    result.setBaudrate(9600);
+    result.setBytes(1920);
+    result.setSeconds(2);
+    QCOMPARE(result.getThroughput(), 960.0);
+    QCOMPARE(result.getEfficiency(), 100.0);
+    result.setBaudrate(0);
+    QCOMPARE(result.getEfficiency(), 0.0);
+    result.setSeconds(0);
+    QCOMPARE(result.getThroughput(), 0.0);
+}
+
+QTEST_GUILESS_MAIN(TestSerialUtility)
+#include "tst_serial_utility.moc"
@@ -0,0 +1,10 @@
+include(../tests.pri)
+QT += dbus
+TARGET = tst_service_manager
+
+HEADERS += $$SRC_FOLDER/include/service_manager.h \
+    $$SRC_FOLDER/include/job_scheduler.h
+
+SOURCES += tst_service_manager.cpp \
+    $$SRC_FOLDER/service_manager.cpp \
+    $$SRC_FOLDER/job_scheduler.cpp
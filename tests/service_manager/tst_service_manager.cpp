@@ -0,0 +1,548 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <mutex>
+#include <functional>
+#include <QtTest>
+#include <QThread>
+#include <QTimer>
+#include <QMap>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QSignalSpy>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QDBusMessage>
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+
+#include "service_manager.h"
+#include "job_scheduler.h"
+
+// run under dbus-run-session, the mock owns org.freedesktop.systemd1 on the session bus
+#define MOCK_CONNECTION_NAME    "tst_service_manager_mock"
+#define CLIENT_CONNECTION_NAME  "tst_service_manager_client"
+// time a unit job takes before JobRemoved
+#define MOCK_JOB_MS             200
+#define MOCK_JOB_PATH_PREFIX    "/org/freedesktop/systemd1/job/"
+#define MOCK_UNIT_PATH_PREFIX   "/org/freedesktop/systemd1/unit/"
+#define MOCK_NO_SUCH_UNIT_ERROR "org.freedesktop.systemd1.NoSuchUnit"
+
+// one row of ListUnitsByPatterns, (ssssssouso)
+struct MockUnitInfo
+{
+    QString name;
+    QString description;
+    QString loadState;
+    QString activeState;
+    QString subState;
+    QString following;
+    QDBusObjectPath path;
+    uint jobId;
+    QString jobType;
+    QDBusObjectPath jobPath;
+};
+Q_DECLARE_METATYPE(MockUnitInfo)
+
+QDBusArgument &operator<<(QDBusArgument &argument, const MockUnitInfo &unit)
+{
+    argument.beginStructure();
+    argument << unit.name << unit.description << unit.loadState << unit.activeState << unit.subState
+             << unit.following << unit.path << unit.jobId << unit.jobType << unit.jobPath;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, MockUnitInfo &unit)
+{
+    argument.beginStructure();
+    argument >> unit.name >> unit.description >> unit.loadState >> unit.activeState >> unit.subState
+             >> unit.following >> unit.path >> unit.jobId >> unit.jobType >> unit.jobPath;
+    argument.endStructure();
+    return argument;
+}
+
+// object path of a unit, escaped like systemd does, ex: gester_2eservice
+static QString mock_unit_path(const QString &unit)
+{
+    QString path = MOCK_UNIT_PATH_PREFIX;
+    for (const QChar &c : unit)
+    {
+        if (c.isLetterOrNumber() && c.unicode() < 0x80)
+            path += c;
+        else
+            path += QString("_%1").arg(c.unicode(), 2, 16, QChar('0'));
+    }
+    return path;
+}
+
+// org.freedesktop.systemd1.Unit with the state the manager waits for
+class MockSystemdUnit : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.systemd1.Unit")
+    Q_PROPERTY(QString ActiveState READ getActiveState)
+
+public:
+    MockSystemdUnit(const QDBusConnection &bus, const QString &unit, const QString &state)
+        : m_bus(bus), m_path(mock_unit_path(unit)), m_state(state) {}
+    QString getPath() { return m_path; }
+    QString getActiveState() { std::lock_guard<std::mutex> lock(m_mutex); return m_state; }
+
+public slots:
+    void setActiveState(const QString &state)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_state = state;
+        }
+        QDBusMessage signal = QDBusMessage::createSignal(m_path, DBUS_PROPERTIES_INTERFACE, "PropertiesChanged");
+        QVariantMap changed;
+        changed.insert("ActiveState", state);
+        signal << QString(SYSTEMD1_UNIT_INTERFACE) << changed << QStringList();
+        m_bus.send(signal);
+    }
+
+private:
+    QDBusConnection m_bus;
+    QString m_path;
+    std::mutex m_mutex;
+    QString m_state;
+};
+
+// org.freedesktop.systemd1.Manager with the calls the settings use, lives in its own thread
+// because the manager blocks its caller until the jobs are removed
+class MockSystemdManager : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.systemd1.Manager")
+
+public:
+    explicit MockSystemdManager(const QDBusConnection &bus) : m_bus(bus) {}
+    void addUnit(const QString &unit, const QString &fileState, const QString &loadState = "loaded")
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fileStates[unit] = fileState;
+        m_loadStates[unit] = loadState;
+    }
+    void setJobResult(const QString &unit, const QString &result)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobResults[unit] = result;
+    }
+    void setSignalBeforeReply(bool isBefore) { std::lock_guard<std::mutex> lock(m_mutex); m_isSignalBeforeReply = isBefore; }
+    // another client's job fails while ours are queued
+    void setForeignJobResult(const QString &result) { std::lock_guard<std::mutex> lock(m_mutex); m_foreignJobResult = result; }
+    QStringList getCalls() { std::lock_guard<std::mutex> lock(m_mutex); return m_calls; }
+    int getMaxRunningJobs() { std::lock_guard<std::mutex> lock(m_mutex); return m_maxRunningJobs; }
+
+public slots:
+    void Subscribe()
+    {
+    }
+    QDBusObjectPath StartUnit(const QString &name, const QString &mode)
+    {
+        return _queue_job("StartUnit", name, mode);
+    }
+    QDBusObjectPath StopUnit(const QString &name, const QString &mode)
+    {
+        return _queue_job("StopUnit", name, mode);
+    }
+    QDBusObjectPath RestartUnit(const QString &name, const QString &mode)
+    {
+        return _queue_job("RestartUnit", name, mode);
+    }
+    bool EnableUnitFiles(const QStringList &files, bool, bool)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_calls << "EnableUnitFiles " + files.join(" ");
+        return true;
+    }
+    void DisableUnitFiles(const QStringList &files, bool)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_calls << "DisableUnitFiles " + files.join(" ");
+    }
+    void Reload()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_calls << "Reload";
+    }
+    QString GetUnitFileState(const QString &file)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_fileStates.contains(file)) {
+            sendErrorReply(MOCK_NO_SUCH_UNIT_ERROR, "No such file or directory");
+            return QString();
+        }
+        return m_fileStates.value(file);
+    }
+    QList<MockUnitInfo> ListUnitsByPatterns(const QStringList &, const QStringList &patterns)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        QList<MockUnitInfo> units;
+        for (auto itr = m_loadStates.begin(); itr != m_loadStates.end(); ++itr)
+        {
+            bool isMatched = patterns.isEmpty();
+            for (auto &pattern : patterns)
+            {
+                QRegularExpression expression(QRegularExpression::wildcardToRegularExpression(pattern));
+                isMatched |= expression.match(itr.key()).hasMatch();
+            }
+            if (!isMatched)
+                continue;
+            MockUnitInfo unit;
+            unit.name = itr.key();
+            unit.loadState = itr.value();
+            unit.activeState = "active";
+            unit.subState = "running";
+            unit.path = QDBusObjectPath(mock_unit_path(itr.key()));
+            unit.jobId = 0;
+            unit.jobPath = QDBusObjectPath("/");
+            units << unit;
+        }
+        return units;
+    }
+    QDBusObjectPath LoadUnit(const QString &name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_fileStates.contains(name)) {
+            sendErrorReply(MOCK_NO_SUCH_UNIT_ERROR, "Unit " + name + " not found.");
+            return QDBusObjectPath();
+        }
+        return QDBusObjectPath(mock_unit_path(name));
+    }
+
+private:
+    QDBusObjectPath _queue_job(const char* method, const QString &unit, const QString &mode)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_calls << QString(method) + " " + unit;
+        if (!m_fileStates.contains(unit) || mode.compare("replace") != 0) {
+            sendErrorReply(MOCK_NO_SUCH_UNIT_ERROR, "Unit " + unit + " not found.");
+            return QDBusObjectPath();
+        }
+        const uint id = ++m_jobId;
+        const QString job = MOCK_JOB_PATH_PREFIX + QString::number(id);
+        const QString result = m_jobResults.value(unit, "done");
+        if (!m_foreignJobResult.isEmpty()) {
+            const uint foreignId = ++m_jobId;
+            _send_job_removed(foreignId, MOCK_JOB_PATH_PREFIX + QString::number(foreignId), "other.service",
+                              m_foreignJobResult);
+        }
+        if (m_isSignalBeforeReply) {
+            // a fast job ends before the caller has read the reply
+            _send_job_removed(id, job, unit, result);
+            return QDBusObjectPath(job);
+        }
+        m_runningJobs++;
+        m_maxRunningJobs = qMax(m_maxRunningJobs, m_runningJobs);
+        QTimer::singleShot(MOCK_JOB_MS, this, [this, id, job, unit, result]() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_runningJobs--;
+            }
+            _send_job_removed(id, job, unit, result);
+        });
+        return QDBusObjectPath(job);
+    }
+    void _send_job_removed(uint id, const QString &job, const QString &unit, const QString &result)
+    {
+        QDBusMessage signal = QDBusMessage::createSignal(SYSTEMD1_PATH, SYSTEMD1_MANAGER_INTERFACE, "JobRemoved");
+        signal << id << QVariant::fromValue(QDBusObjectPath(job)) << unit << result;
+        m_bus.send(signal);
+    }
+
+    QDBusConnection m_bus;
+    std::mutex m_mutex;
+    QMap<QString, QString> m_fileStates;
+    QMap<QString, QString> m_loadStates;
+    QMap<QString, QString> m_jobResults;
+    bool m_isSignalBeforeReply = false;
+    QString m_foreignJobResult;
+    uint m_jobId = 0;
+    int m_runningJobs = 0;
+    int m_maxRunningJobs = 0;
+    QStringList m_calls;
+};
+
+class TestServiceManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void cleanupTestCase();
+    void testStartWaitsForJob();
+    void testJobsRunInParallel();
+    void testJobRemovedBeforeReply();
+    void testJobFailed();
+    void testForeignJobFailed();
+    void testWatcherIgnoresForeignJobs();
+    void testNoSuchUnit();
+    void testEmptyUnits();
+    void testEnableAndStart();
+    void testStopAndDisable();
+    void testGetUnitEnabled();
+    void testFindUnit();
+    void testWaitUnitActive();
+    void testWaitUnitAlreadyActive();
+    void testWaitUnitTimeout();
+    void testRunJobsInScheduler();
+
+private:
+    MockSystemdUnit *_add_unit(const QString &unit, const QString &state);
+
+    QThread m_mockThread;
+    MockSystemdManager *m_mock = nullptr;
+    QList<MockSystemdUnit *> m_units;
+    TPCServiceManager *m_serviceManager = nullptr;
+};
+
+void TestServiceManager::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected())
+        QSKIP("no session bus, run with dbus-run-session");
+    qDBusRegisterMetaType<MockUnitInfo>();
+    qDBusRegisterMetaType<QList<MockUnitInfo>>();
+    QDBusConnection mockBus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, MOCK_CONNECTION_NAME);
+    QVERIFY(mockBus.isConnected());
+    QVERIFY(mockBus.registerService(SYSTEMD1_SERVICE));
+    m_mockThread.start();
+}
+
+void TestServiceManager::init()
+{
+    QDBusConnection mockBus(MOCK_CONNECTION_NAME);
+    m_mock = new MockSystemdManager(mockBus);
+    m_mock->addUnit(GESTURE_SERVICE_NAME, "enabled");
+    m_mock->addUnit(CROND_SERVICE_NAME, "disabled");
+    m_mock->addUnit(CONNMAN_SERVICE_NAME, "enabled-runtime");
+    m_mock->addUnit("weston-old.service", "", "not-found");
+    m_mock->addUnit("weston@root.service", "static");
+    m_mock->moveToThread(&m_mockThread);
+    QVERIFY(mockBus.registerObject(SYSTEMD1_PATH, m_mock, QDBusConnection::ExportAllSlots));
+    m_serviceManager = new TPCServiceManager(QDBusConnection::connectToBus(QDBusConnection::SessionBus,
+                                                                           CLIENT_CONNECTION_NAME));
+}
+
+void TestServiceManager::cleanup()
+{
+    delete m_serviceManager;
+    m_serviceManager = nullptr;
+    QDBusConnection mockBus(MOCK_CONNECTION_NAME);
+    for (auto unit : m_units)
+    {
+        mockBus.unregisterObject(unit->getPath());
+        unit->deleteLater();
+    }
+    m_units.clear();
+    mockBus.unregisterObject(SYSTEMD1_PATH);
+    if (m_mock)
+        m_mock->deleteLater();
+    m_mock = nullptr;
+}
+
+void TestServiceManager::cleanupTestCase()
+{
+    m_mockThread.quit();
+    m_mockThread.wait();
+    QDBusConnection::disconnectFromBus(CLIENT_CONNECTION_NAME);
+    QDBusConnection::disconnectFromBus(MOCK_CONNECTION_NAME);
+}
+
+MockSystemdUnit *TestServiceManager::_add_unit(const QString &unit, const QString &state)
+{
+    QDBusConnection mockBus(MOCK_CONNECTION_NAME);
+    MockSystemdUnit *mockUnit = new MockSystemdUnit(mockBus, unit, state);
+    mockUnit->moveToThread(&m_mockThread);
+    if (!mockBus.registerObject(mockUnit->getPath(), mockUnit, QDBusConnection::ExportAllProperties)) {
+        delete mockUnit;
+        return nullptr;
+    }
+    m_units << mockUnit;
+    return mockUnit;
+}
+
+void TestServiceManager::testStartWaitsForJob()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(m_serviceManager->start_units({GESTURE_SERVICE_NAME}));
+    // returned on JobRemoved, not on the reply
+    QVERIFY(timer.elapsed() >= MOCK_JOB_MS - 50);
+    QVERIFY(timer.elapsed() < SYSTEMD1_JOB_TIMEOUT * 1000 / 2);
+    QCOMPARE(m_mock->getCalls(), QStringList() << "StartUnit " GESTURE_SERVICE_NAME);
+}
+
+void TestServiceManager::testJobsRunInParallel()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(m_serviceManager->restart_units({GESTURE_SERVICE_NAME, CROND_SERVICE_NAME, CONNMAN_SERVICE_NAME}));
+    QVERIFY(timer.elapsed() < MOCK_JOB_MS * 2);
+    QCOMPARE(m_mock->getMaxRunningJobs(), 3);
+    QCOMPARE(m_mock->getCalls(), QStringList() << "RestartUnit " GESTURE_SERVICE_NAME
+                                               << "RestartUnit " CROND_SERVICE_NAME
+                                               << "RestartUnit " CONNMAN_SERVICE_NAME);
+}
+
+void TestServiceManager::testJobRemovedBeforeReply()
+{
+    m_mock->setSignalBeforeReply(true);
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(m_serviceManager->stop_units({GESTURE_SERVICE_NAME, CROND_SERVICE_NAME}));
+    // the early results are kept, no wait for the timeout
+    QVERIFY(timer.elapsed() < MOCK_JOB_MS);
+}
+
+void TestServiceManager::testJobFailed()
+{
+    m_mock->setJobResult(CROND_SERVICE_NAME, "failed");
+    QVERIFY(!m_serviceManager->start_units({GESTURE_SERVICE_NAME, CROND_SERVICE_NAME}));
+    QCOMPARE(m_mock->getCalls().size(), 2);
+}
+
+void TestServiceManager::testForeignJobFailed()
+{
+    // systemd broadcasts JobRemoved of every client
+    m_mock->setForeignJobResult("failed");
+    QVERIFY(m_serviceManager->start_units({GESTURE_SERVICE_NAME, CROND_SERVICE_NAME}));
+    m_mock->setSignalBeforeReply(true);
+    QVERIFY(m_serviceManager->restart_units({GESTURE_SERVICE_NAME}));
+    // ours still fail
+    m_mock->setJobResult(CROND_SERVICE_NAME, "dependency");
+    QVERIFY(!m_serviceManager->stop_units({CROND_SERVICE_NAME}));
+}
+
+void TestServiceManager::testWatcherIgnoresForeignJobs()
+{
+    SystemdJobWatcher watcher;
+    QSignalSpy spy(&watcher, SIGNAL(allFinished()));
+    // ours ended before the reply with its path came back
+    watcher.jobRemoved(1, QDBusObjectPath(MOCK_JOB_PATH_PREFIX "1"), GESTURE_SERVICE_NAME, "done");
+    watcher.jobRemoved(2, QDBusObjectPath(MOCK_JOB_PATH_PREFIX "2"), "other.service", "failed");
+    watcher.add_job(MOCK_JOB_PATH_PREFIX "1");
+    watcher.add_job(MOCK_JOB_PATH_PREFIX "3");
+    QVERIFY(!watcher.is_finished());
+    watcher.jobRemoved(4, QDBusObjectPath(MOCK_JOB_PATH_PREFIX "4"), "another.service", "timeout");
+    QCOMPARE(spy.count(), 0);
+    watcher.jobRemoved(3, QDBusObjectPath(MOCK_JOB_PATH_PREFIX "3"), CROND_SERVICE_NAME, "done");
+    QVERIFY(watcher.is_finished());
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(watcher.get_failed_units().empty());
+    // a failed one of ours is reported, also when it ended before add_job
+    watcher.jobRemoved(5, QDBusObjectPath(MOCK_JOB_PATH_PREFIX "5"), CONNMAN_SERVICE_NAME, "failed");
+    watcher.add_job(MOCK_JOB_PATH_PREFIX "5");
+    QCOMPARE(watcher.get_failed_units(), vector<string>({CONNMAN_SERVICE_NAME " failed"}));
+}
+
+void TestServiceManager::testNoSuchUnit()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!m_serviceManager->start_units({"missing.service"}));
+    QVERIFY(timer.elapsed() < MOCK_JOB_MS);
+    // the other jobs are still waited for
+    QVERIFY(!m_serviceManager->start_units({"missing.service", GESTURE_SERVICE_NAME}));
+    QVERIFY(timer.elapsed() >= MOCK_JOB_MS - 50);
+}
+
+void TestServiceManager::testEmptyUnits()
+{
+    QVERIFY(m_serviceManager->start_units({}));
+    QVERIFY(m_serviceManager->enable_units({}));
+    QVERIFY(m_serviceManager->disable_units({}));
+    QVERIFY(m_mock->getCalls().isEmpty());
+}
+
+void TestServiceManager::testEnableAndStart()
+{
+    QVERIFY(m_serviceManager->enable_and_start_units({GESTURE_SERVICE_NAME}));
+    QCOMPARE(m_mock->getCalls(), QStringList() << "EnableUnitFiles " GESTURE_SERVICE_NAME << "Reload"
+                                               << "RestartUnit " GESTURE_SERVICE_NAME);
+}
+
+void TestServiceManager::testStopAndDisable()
+{
+    QVERIFY(m_serviceManager->stop_and_disable_units({GESTURE_SERVICE_NAME}));
+    QCOMPARE(m_mock->getCalls(), QStringList() << "StopUnit " GESTURE_SERVICE_NAME
+                                               << "DisableUnitFiles " GESTURE_SERVICE_NAME << "Reload");
+}
+
+void TestServiceManager::testGetUnitEnabled()
+{
+    QCOMPARE(m_serviceManager->get_unit_enabled(GESTURE_SERVICE_NAME), make_pair(true, true));
+    QCOMPARE(m_serviceManager->get_unit_enabled(CONNMAN_SERVICE_NAME), make_pair(true, true));
+    QCOMPARE(m_serviceManager->get_unit_enabled(CROND_SERVICE_NAME), make_pair(false, true));
+    QCOMPARE(m_serviceManager->get_unit_enabled("missing.service"), make_pair(false, false));
+    QCOMPARE(m_serviceManager->get_unit_enabled(nullptr), make_pair(false, false));
+}
+
+void TestServiceManager::testFindUnit()
+{
+    // weston-old.service matches first but is not loaded
+    QCOMPARE(m_serviceManager->find_unit(WESTON_SERVICE_PATTERN), make_pair(string("weston@root.service"), true));
+    QCOMPARE(m_serviceManager->find_unit("missing*.service"), make_pair(string(), false));
+    QCOMPARE(m_serviceManager->find_unit(""), make_pair(string(), false));
+}
+
+void TestServiceManager::testWaitUnitActive()
+{
+    MockSystemdUnit *unit = _add_unit("weston@root.service", "activating");
+    QVERIFY(unit);
+    QTimer::singleShot(MOCK_JOB_MS, unit, [unit]() { unit->setActiveState("active"); });
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(m_serviceManager->wait_unit_active("weston@root.service", SYSTEMD1_JOB_TIMEOUT * 1000));
+    QVERIFY(timer.elapsed() >= MOCK_JOB_MS - 50);
+    QVERIFY(timer.elapsed() < SYSTEMD1_JOB_TIMEOUT * 1000 / 2);
+}
+
+void TestServiceManager::testWaitUnitAlreadyActive()
+{
+    QVERIFY(_add_unit(GESTURE_SERVICE_NAME, "active"));
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(m_serviceManager->wait_unit_active(GESTURE_SERVICE_NAME, SYSTEMD1_JOB_TIMEOUT * 1000));
+    QVERIFY(timer.elapsed() < MOCK_JOB_MS);
+    QVERIFY(!m_serviceManager->wait_unit_active("missing.service", MOCK_JOB_MS));
+}
+
+void TestServiceManager::testWaitUnitTimeout()
+{
+    MockSystemdUnit *unit = _add_unit(GESTURE_SERVICE_NAME, "activating");
+    QVERIFY(unit);
+    // a change to another state does not end the wait
+    QTimer::singleShot(MOCK_JOB_MS / 2, unit, [unit]() { unit->setActiveState("failed"); });
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!m_serviceManager->wait_unit_active(GESTURE_SERVICE_NAME, MOCK_JOB_MS * 2));
+    QVERIFY(timer.elapsed() >= MOCK_JOB_MS * 2 - 50);
+}
+
+void TestServiceManager::testRunJobsInScheduler()
+{
+    // how the settings run it, the systemd jobs are waited for in a worker thread
+    JobScheduler scheduler(2);
+    IServiceManager *serviceManager = m_serviceManager;
+    Job *job = new Job(std::bind(&IServiceManager::restart_units, serviceManager,
+                                 vector<string>({GESTURE_SERVICE_NAME})), JobPriority::UI_CRITICAL);
+    QSignalSpy spy(job, SIGNAL(workFinished(bool)));
+    QElapsedTimer timer;
+    timer.start();
+    scheduler.start(job);
+    // the caller is free at once
+    QVERIFY(timer.elapsed() < MOCK_JOB_MS / 2);
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, SYSTEMD1_JOB_TIMEOUT * 1000 / 2);
+    QCOMPARE(spy.at(0).at(0).toBool(), true);
+    QVERIFY(timer.elapsed() >= MOCK_JOB_MS - 50);
+    QCOMPARE(m_mock->getCalls(), QStringList() << "RestartUnit " GESTURE_SERVICE_NAME);
+}
+
+QTEST_GUILESS_MAIN(TestServiceManager)
+#include "tst_service_manager.moc"
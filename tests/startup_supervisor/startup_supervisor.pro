@@ -0,0 +1,6 @@
+include(../tests.pri)
+TARGET = tst_startup_supervisor
+
+SOURCES += tst_startup_supervisor.cpp \
+    $$SRC_FOLDER/startup_supervisor.cpp \
+    $$SRC_FOLDER/utility.cpp
@@ -0,0 +1,276 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "test_utility.h"
+#include "startup_supervisor.h"
+
+using namespace std;
+
+#define WAYLAND_SOCKET          "/run/user/0/wayland-0"
+#define NET_UNIX_HEADER         "Num       RefCount Protocol Flags    Type St Inode Path\n"
+#define NET_UNIX_LISTENING      "0000000000000000: 00000002 00000000 00010000 0001 01 20001 " WAYLAND_SOCKET "\n"
+#define NET_UNIX_CONNECTED      "0000000000000000: 00000003 00000000 00000000 0001 03 20002 " WAYLAND_SOCKET "\n"
+
+// RestartTracker gets a simulated clock. StartupSupervisor runs real /bin/sh children against a fake
+// cgroup v2 folder, the files the kernel would update are written by the test and the commands
+class TestStartupSupervisor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testBackoffDoubling();
+    void testBackoffResetAfterStableRun();
+    void testCrashLoopCutoff();
+    void testCrashLoopWindow();
+    void testNoAutoRestart();
+    void testFormatLaunchRecord();
+    void testRunOnce();
+    void testExitStatus();
+    void testRestartUntilCrashLoop();
+    void testStableRunCountsInWindow();
+    void testBackgroundLeftoverKilled();
+    void testBackgroundLeftoverCgroupKill();
+    void testWaitForBackgroundChild();
+    void testFirstWindow();
+
+private:
+    RestartPolicy _make_policy(bool isAutoRestart);
+    string _cgroup_file(const char* name);
+
+    QTemporaryDir m_folder;
+    string m_cgroupFolder;
+    string m_netUnixFile;
+};
+
+void TestStartupSupervisor::init()
+{
+    QVERIFY(m_folder.isValid());
+    const string folder = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    m_cgroupFolder = folder + "/cgroup";
+    m_netUnixFile = folder + "/net_unix";
+    QVERIFY(write_test_file(m_cgroupFolder + "/cgroup.controllers", "cpu io memory pids\n"));
+    QVERIFY(write_test_file(_cgroup_file("cgroup.events"), "populated 0\nfrozen 0\n"));
+    QVERIFY(write_test_file(_cgroup_file("cgroup.procs"), ""));
+    QVERIFY(write_test_file(_cgroup_file("memory.current"), "2097152\n"));
+    QVERIFY(write_test_file(_cgroup_file("cpu.stat"), "usage_usec 1000\nuser_usec 600\nsystem_usec 400\n"));
+    QVERIFY(write_test_file(m_netUnixFile, NET_UNIX_HEADER NET_UNIX_LISTENING));
+}
+
+RestartPolicy TestStartupSupervisor::_make_policy(bool isAutoRestart)
+{
+    // short delays for real children
+    RestartPolicy policy = make_restart_policy(isAutoRestart);
+    policy.initialBackoffMs = 10;
+    policy.maxBackoffMs = 40;
+    policy.stableRunMs = 500;
+    policy.crashLoopCount = 4;
+    policy.crashLoopWindowMs = 10000;
+    return policy;
+}
+
+string TestStartupSupervisor::_cgroup_file(const char* name)
+{
+    return m_cgroupFolder + "/" STARTUP_CGROUP_NAME "/" + name;
+}
+
+void TestStartupSupervisor::testBackoffDoubling()
+{
+    RestartPolicy policy = make_restart_policy(true);
+    policy.crashLoopCount = 100;
+    RestartTracker tracker(policy);
+    vector<int> delays;
+    double nowMs = 0;
+    for (int i = 0; i < 9; i++)
+    {
+        // quick exits spread out so they never make a crash loop
+        nowMs += SUPERVISOR_CRASH_LOOP_WINDOW_MS;
+        delays.push_back(tracker.on_exit(nowMs, 100));
+    }
+    QCOMPARE(delays, vector<int>({1000, 2000, 4000, 8000, 16000, 32000, 60000, 60000, 60000}));
+    QVERIFY(!tracker.is_crash_loop());
+}
+
+void TestStartupSupervisor::testBackoffResetAfterStableRun()
+{
+    RestartTracker tracker(make_restart_policy(true));
+    QCOMPARE(tracker.on_exit(0, 100), 1000);
+    QCOMPARE(tracker.on_exit(1000, 100), 2000);
+    QCOMPARE(tracker.on_exit(3000, 100), 4000);
+    // ran long enough to count as healthy
+    QCOMPARE(tracker.on_exit(200000, SUPERVISOR_STABLE_RUN_MS), 1000);
+    QCOMPARE(tracker.on_exit(201000, SUPERVISOR_STABLE_RUN_MS - 1), 2000);
+}
+
+void TestStartupSupervisor::testCrashLoopCutoff()
+{
+    RestartTracker tracker(make_restart_policy(true));
+    double nowMs = 0;
+    for (int i = 1; i < SUPERVISOR_CRASH_LOOP_COUNT; i++)
+    {
+        nowMs += 1000;
+        QVERIFY(tracker.on_exit(nowMs, 100) > 0);
+    }
+    QVERIFY(!tracker.is_crash_loop());
+    QCOMPARE(tracker.on_exit(nowMs + 1000, 100), -1);
+    QVERIFY(tracker.is_crash_loop());
+    // stays stopped, even after a healthy run
+    QCOMPARE(tracker.on_exit(nowMs + 1000000, SUPERVISOR_STABLE_RUN_MS), -1);
+}
+
+void TestStartupSupervisor::testCrashLoopWindow()
+{
+    RestartTracker tracker(make_restart_policy(true));
+    // one exit less than the count per window, older exits fall out of it
+    double nowMs = 0;
+    for (int i = 0; i < SUPERVISOR_CRASH_LOOP_COUNT * 3; i++)
+    {
+        nowMs += SUPERVISOR_CRASH_LOOP_WINDOW_MS / (SUPERVISOR_CRASH_LOOP_COUNT - 1) + 1;
+        QVERIFY(tracker.on_exit(nowMs, SUPERVISOR_STABLE_RUN_MS) > 0);
+    }
+    QVERIFY(!tracker.is_crash_loop());
+}
+
+void TestStartupSupervisor::testNoAutoRestart()
+{
+    RestartTracker tracker(make_restart_policy(false));
+    QCOMPARE(tracker.on_exit(0, 100), -1);
+    QVERIFY(!tracker.is_crash_loop());
+}
+
+void TestStartupSupervisor::testFormatLaunchRecord()
+{
+    LaunchRecord record = {2, 1234, 350.4, 5000.2, 0, 3 * 1048576, 1500000};
+    QCOMPARE(format_launch_record(record),
+             string("attempt 2 pid 1234 first window 350 ms run 5000 ms exit 0 memory peak 3.0 MB cpu 1.50 s"));
+    record = {1, -1, -1, 0, 127, -1, -1};
+    QCOMPARE(format_launch_record(record),
+             string("attempt 1 pid -1 first window - run 0 ms exit 127 memory peak - cpu -"));
+}
+
+void TestStartupSupervisor::testRunOnce()
+{
+    StartupSupervisor supervisor("/bin/true", _make_policy(false), {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(supervisor.run(), 0);
+    auto records = supervisor.get_records();
+    QCOMPARE(records.size(), (size_t)1);
+    QCOMPARE(records[0].attempt, 1);
+    QVERIFY(records[0].pid > 0);
+    QCOMPARE(records[0].exitStatus, 0);
+    QCOMPARE(records[0].firstWindowMs, -1.0);
+    // the fake cgroup counters do not move
+    QCOMPARE(records[0].memoryPeakBytes, 2097152LL);
+    QCOMPARE(records[0].cpuUsec, 0LL);
+    // the child joined the cgroup before exec
+    QCOMPARE(read_test_file(_cgroup_file("cgroup.procs")), string("0"));
+}
+
+void TestStartupSupervisor::testExitStatus()
+{
+    StartupSupervisor falseSupervisor("/bin/false", _make_policy(false), {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(falseSupervisor.run(), 1);
+    // killed by a signal is 128 + signal like the shell
+    StartupSupervisor killedSupervisor("kill -9 $$", _make_policy(false), {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(killedSupervisor.run(), 128 + SIGKILL);
+    StartupSupervisor missingSupervisor("/nonexistent/startup", _make_policy(false), {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(missingSupervisor.run(), 127);
+    // no cgroup v2, no accounting
+    const string plainFolder = m_folder.path().toStdString();
+    StartupSupervisor plainSupervisor("/bin/true", _make_policy(false), {}, plainFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(plainSupervisor.run(), 0);
+    QCOMPARE(plainSupervisor.get_records()[0].memoryPeakBytes, -1LL);
+    QCOMPARE(plainSupervisor.get_records()[0].cpuUsec, -1LL);
+}
+
+void TestStartupSupervisor::testRestartUntilCrashLoop()
+{
+    RestartPolicy policy = _make_policy(true);
+    StartupSupervisor supervisor("/bin/false", policy, {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(supervisor.run(), 1);
+    auto records = supervisor.get_records();
+    QCOMPARE((int)records.size(), policy.crashLoopCount);
+    for (int i = 0; i < (int)records.size(); i++)
+    {
+        QCOMPARE(records[i].attempt, i + 1);
+        QCOMPARE(records[i].exitStatus, 1);
+    }
+    // 10 + 20 + 40 ms of backoff between the runs
+    QVERIFY(timer.elapsed() >= 70);
+}
+
+void TestStartupSupervisor::testStableRunCountsInWindow()
+{
+    // a run longer than stableRunMs resets the backoff but still counts in the window
+    RestartPolicy policy = _make_policy(true);
+    policy.stableRunMs = 100;
+    policy.crashLoopCount = 2;
+    StartupSupervisor supervisor("sleep 0.15", policy, {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(supervisor.run(), 0);
+    auto records = supervisor.get_records();
+    QCOMPARE(records.size(), (size_t)2);
+    QVERIFY(records[0].runMs >= 150);
+    QVERIFY(records[1].runMs >= 150);
+}
+
+void TestStartupSupervisor::testBackgroundLeftoverKilled()
+{
+    // an earlier start script left a child running in the cgroup
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/bin/sleep", "sleep", "30", (char *)nullptr);
+        _exit(127);
+    }
+    QVERIFY(pid > 0);
+    QVERIFY(write_test_file(_cgroup_file("cgroup.events"), "populated 1\nfrozen 0\n"));
+    QVERIFY(write_test_file(_cgroup_file("cgroup.procs"), std::to_string(pid) + "\n"));
+    // without cgroup.kill each process gets killed, the kernel would then update cgroup.events
+    const string command = "echo 'populated 0' > " + _cgroup_file("cgroup.events");
+    StartupSupervisor supervisor(command, _make_policy(false), {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(supervisor.run(), 0);
+    int status = 0;
+    QCOMPARE(waitpid(pid, &status, 0), pid);
+    QVERIFY(WIFSIGNALED(status));
+    QCOMPARE(WTERMSIG(status), SIGKILL);
+}
+
+void TestStartupSupervisor::testBackgroundLeftoverCgroupKill()
+{
+    QVERIFY(write_test_file(_cgroup_file("cgroup.events"), "populated 1\nfrozen 0\n"));
+    QVERIFY(write_test_file(_cgroup_file("cgroup.kill"), ""));
+    const string command = "echo 'populated 0' > " + _cgroup_file("cgroup.events");
+    StartupSupervisor supervisor(command, _make_policy(false), {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(supervisor.run(), 0);
+    QCOMPARE(read_test_file(_cgroup_file("cgroup.kill")), string("1"));
+}
+
+void TestStartupSupervisor::testWaitForBackgroundChild()
+{
+    // the start script exits at once, the application it started keeps the cgroup populated
+    const string events = _cgroup_file("cgroup.events");
+    const string command = "echo 'populated 1' > " + events + "; (sleep 0.3; echo 'populated 0' > " + events + ") & exit 3";
+    StartupSupervisor supervisor(command, _make_policy(false), {}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(supervisor.run(), 3);
+    QVERIFY(supervisor.get_records()[0].runMs >= 300);
+}
+
+void TestStartupSupervisor::testFirstWindow()
+{
+    // connecting to the compositor shows up as a connected socket with its path
+    const string command = "sleep 0.1; echo '" NET_UNIX_CONNECTED "' >> " + m_netUnixFile + "; sleep 0.2";
+    StartupSupervisor supervisor(command, _make_policy(false), {WAYLAND_SOCKET}, m_cgroupFolder.c_str(), m_netUnixFile.c_str());
+    QCOMPARE(supervisor.run(), 0);
+    auto record = supervisor.get_records()[0];
+    QVERIFY(record.firstWindowMs >= 100);
+    QVERIFY(record.firstWindowMs < record.runMs);
+}
+
+QTEST_GUILESS_MAIN(TestStartupSupervisor)
+#include "tst_startup_supervisor.moc"
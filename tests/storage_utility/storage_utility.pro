@@ -0,0 +1,7 @@
+include(../tests.pri)
+TARGET = tst_storage_utility
+
+SOURCES += tst_storage_utility.cpp \
+    $$SRC_FOLDER/storage_utility.cpp \
+    $$SRC_FOLDER/storage_telemetry.cpp \
+    $$SRC_FOLDER/utility.cpp
@@ -0,0 +1,347 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "test_utility.h"
+#include "storage_utility.h"
+#include "storage_telemetry.h"
+
+// sysfs, mountinfo and /dev/disk of an eMMC with a mounted and an unmounted partition
+class TestStorageUtility : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testFormatSize();
+    void testDeviceSize();
+    void testPartNamesSkipAttributes();
+    void testPartNamesNumericOrder();
+    void testMountedPartition();
+    void testUnmountedPartition();
+    void testMissingDevice();
+    void testDeviceStat();
+    void testDeviceStatTooShort();
+    void testEMMCHealth();
+    void testSDCardWithoutHealth();
+    void testTelemetryFirstSampleIsBase();
+    void testTelemetryRates();
+    void testTelemetryCounterReset();
+    void testTelemetryDeviceRemoved();
+    void testTelemetryRingOverwrite();
+    void testTelemetryHealthInterval();
+
+private:
+    void writeStat(unsigned long long readIOs, unsigned long long readSectors,
+        unsigned long long writeIOs, unsigned long long writeSectors, unsigned long long ioTicks);
+
+    string m_root;
+    string m_sysBlock;
+    string m_mountInfo;
+    string m_devDisk;
+    QTemporaryDir m_folder;
+};
+
+void TestStorageUtility::init()
+{
+    QVERIFY(m_folder.isValid());
+    m_root = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    m_sysBlock = m_root + "/sys/block";
+    m_mountInfo = m_root + "/proc/mountinfo";
+    m_devDisk = m_root + "/dev/disk";
+    const string disk = m_sysBlock + "/mmcblk2";
+    QVERIFY(write_test_file(disk + "/dev", "179:0\n"));
+    QVERIFY(write_test_file(disk + "/size", "30777344\n"));
+    QVERIFY(write_test_file(disk + "/ro", "0\n"));
+    QVERIFY(write_test_file(disk + "/stat",
+        "   23415     4411  1719994    10562    18021    14744   739130    45297        0    32460    56834\n"));
+    QVERIFY(write_test_file(disk + "/device/life_time", "0x02 0x01\n"));
+    QVERIFY(write_test_file(disk + "/device/pre_eol_info", "0x01\n"));
+    // queue and power are attribute folders without a partition file
+    QVERIFY(write_test_file(disk + "/queue/rotational", "0\n"));
+    QVERIFY(write_test_file(disk + "/power/control", "auto\n"));
+    const char *parts[][4] = {
+        // name, dev, start, size
+        {"mmcblk2p1", "179:1", "16384", "1187840"},
+        {"mmcblk2p2", "179:2", "1204224", "204800"},
+        {"mmcblk2p10", "179:10", "1409024", "2048"},
+    };
+    for (auto &part : parts)
+    {
+        const string folder = disk + "/" + part[0];
+        QVERIFY(write_test_file(folder + "/partition", "1\n"));
+        QVERIFY(write_test_file(folder + "/dev", string(part[1]) + "\n"));
+        QVERIFY(write_test_file(folder + "/start", string(part[2]) + "\n"));
+        QVERIFY(write_test_file(folder + "/size", string(part[3]) + "\n"));
+        QVERIFY(write_test_file(folder + "/ro", "0\n"));
+    }
+    QVERIFY(write_test_file(disk + "/mmcblk2p2/ro", "1\n"));
+
+    // the mount point has a space, escaped as \040, and must exist for statvfs
+    QVERIFY(write_test_file(m_root + "/media/My Disk/.keep", ""));
+    QVERIFY(write_test_file(m_mountInfo,
+        "22 1 179:3 / / rw,relatime shared:1 - ext4 /dev/root rw\n"
+        "31 22 179:1 / " + m_root + "/media/My\\040Disk rw,relatime shared:15 - vfat /dev/mmcblk2p1 rw\n"
+        "32 22 179:1 / /second/mount rw,relatime shared:16 - vfat /dev/mmcblk2p1 rw\n"));
+    QVERIFY(create_test_symlink("../../mmcblk2p1", m_devDisk + "/by-label/My\\x20Disk"));
+    QVERIFY(create_test_symlink("../../mmcblk2p1", m_devDisk + "/by-uuid/1234-ABCD"));
+}
+
+// fields 1, 3, 5, 7 and 10 of the stat file, the others stay 0
+void TestStorageUtility::writeStat(unsigned long long readIOs, unsigned long long readSectors,
+    unsigned long long writeIOs, unsigned long long writeSectors, unsigned long long ioTicks)
+{
+    char buff[256] = {0};
+    snprintf(buff, sizeof(buff), "%llu 0 %llu 0 %llu 0 %llu 0 0 %llu 0\n",
+        readIOs, readSectors, writeIOs, writeSectors, ioTicks);
+    QVERIFY(write_test_file(m_sysBlock + "/mmcblk2/stat", buff));
+}
+
+void TestStorageUtility::testFormatSize()
+{
+    QCOMPARE(format_size(512), string("512B"));
+    QCOMPARE(format_size(1024), string("1K"));
+    QCOMPARE(format_size(1536), string("1.5K"));
+    QCOMPARE(format_size(30777344ULL * 512), string("14.7G"));
+}
+
+void TestStorageUtility::testDeviceSize()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    const auto ret = storageUtil.get_emmc_size();
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first, string("14.7G"));
+}
+
+void TestStorageUtility::testPartNamesSkipAttributes()
+{
+    BlockDeviceEnumerator enumerator(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    const auto ret = enumerator.get_device_part_names(STORAGE_NAME_EMMC);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.size(), (size_t)3);
+    QVERIFY(std::find(ret.first.begin(), ret.first.end(), "queue") == ret.first.end());
+}
+
+void TestStorageUtility::testPartNamesNumericOrder()
+{
+    BlockDeviceEnumerator enumerator(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    const auto ret = enumerator.get_device_part_names(STORAGE_NAME_EMMC);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first, vector<string>({"mmcblk2p1", "mmcblk2p2", "mmcblk2p10"}));
+}
+
+void TestStorageUtility::testMountedPartition()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    auto ret = storageUtil.get_device_part(STORAGE_NAME_EMMC, "mmcblk2p1");
+    QVERIFY(ret.second);
+    BlockDeviceData &part = ret.first;
+    QCOMPARE(part.getDevNumber(), string("179:1"));
+    QCOMPARE(part.getStartSector(), 16384ULL);
+    QCOMPARE(part.getSizeBytes(), 1187840ULL * 512);
+    QCOMPARE(part.getReadOnly(), false);
+    QCOMPARE(part.getLabel(), string("My Disk"));
+    QCOMPARE(part.getUUID(), string("1234-ABCD"));
+    // first mount of the device wins
+    QCOMPARE(part.getMountPoint(), m_root + "/media/My Disk");
+    QCOMPARE(part.getFSType(), string("vfat"));
+    // usage comes from statvfs of the real folder
+    QVERIFY(part.getTotalBytes() > 0);
+    QVERIFY(part.getUsedBytes() <= part.getTotalBytes());
+}
+
+void TestStorageUtility::testUnmountedPartition()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    const auto ret = storageUtil.get_emmc_parts();
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.size(), (size_t)3);
+    BlockDeviceData part = ret.first[1];
+    QCOMPARE(part.getName(), string("mmcblk2p2"));
+    QCOMPARE(part.getReadOnly(), true);
+    QCOMPARE(part.getMountPoint(), string());
+    QCOMPARE(part.getLabel(), string());
+    QCOMPARE(part.getTotalBytes(), 0ULL);
+}
+
+void TestStorageUtility::testMissingDevice()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    QCOMPARE(storageUtil.get_sd_card_size().second, false);
+    QCOMPARE(storageUtil.get_sd_card_parts().second, false);
+    QCOMPARE(storageUtil.get_device_part(STORAGE_NAME_EMMC, "queue").second, false);
+}
+
+void TestStorageUtility::testDeviceStat()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    auto ret = storageUtil.get_device_stat(STORAGE_NAME_EMMC);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.getReadIOs(), 23415ULL);
+    QCOMPARE(ret.first.getReadSectors(), 1719994ULL);
+    QCOMPARE(ret.first.getWriteIOs(), 18021ULL);
+    QCOMPARE(ret.first.getWriteSectors(), 739130ULL);
+    QCOMPARE(ret.first.getIOTicks(), 32460ULL);
+}
+
+void TestStorageUtility::testDeviceStatTooShort()
+{
+    QVERIFY(write_test_file(m_sysBlock + "/mmcblk2/stat", "1 2 3 4\n"));
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    QCOMPARE(storageUtil.get_device_stat(STORAGE_NAME_EMMC).second, false);
+}
+
+void TestStorageUtility::testEMMCHealth()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    auto ret = storageUtil.get_emmc_health(STORAGE_NAME_EMMC);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.getLifeTimeA(), 2);
+    QCOMPARE(ret.first.getLifeTimeB(), 1);
+    QCOMPARE(ret.first.getPreEOL(), EMMC_PRE_EOL_NORMAL);
+    QCOMPARE(ret.first.getLifeTimeAString(), string("10%-20%"));
+    QCOMPARE(ret.first.isWarning(), false);
+}
+
+void TestStorageUtility::testSDCardWithoutHealth()
+{
+    QVERIFY(write_test_file(m_sysBlock + "/mmcblk1/dev", "179:96\n"));
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    QCOMPARE(storageUtil.get_emmc_health(STORAGE_NAME_SD_CARD).second, false);
+}
+
+void TestStorageUtility::testTelemetryFirstSampleIsBase()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    StorageTelemetrySampler sampler(&storageUtil);
+    sampler.add_device(STORAGE_NAME_EMMC);
+    sampler.sample(100.0);
+    auto ret = sampler.get_samples(STORAGE_NAME_EMMC);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.size(), (size_t)0);
+    // same time again gives no rate either
+    sampler.sample(100.0);
+    QCOMPARE(sampler.get_samples(STORAGE_NAME_EMMC).first.size(), (size_t)0);
+    QCOMPARE(sampler.get_samples(STORAGE_NAME_SD_CARD).second, false);
+}
+
+void TestStorageUtility::testTelemetryRates()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    StorageTelemetrySampler sampler(&storageUtil);
+    sampler.add_device(STORAGE_NAME_EMMC);
+    writeStat(1000, 8000, 500, 4000, 10000);
+    sampler.sample(100.0);
+    // 2 seconds later: 400 reads of 3200 sectors, 100 writes of 2048 sectors, busy 500 of 2000 ms
+    writeStat(1400, 11200, 600, 6048, 10500);
+    sampler.sample(102.0);
+    auto ret = sampler.get_samples(STORAGE_NAME_EMMC);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.size(), (size_t)1);
+    StorageTelemetrySample sample = ret.first.latest();
+    QCOMPARE(sample.getTime(), 102.0);
+    QCOMPARE(sample.getReadIOPS(), 200.0);
+    QCOMPARE(sample.getWriteIOPS(), 50.0);
+    QCOMPARE(sample.getReadBytesPerSecond(), 3200.0 * SECTOR_SIZE / 2);
+    QCOMPARE(sample.getWriteBytesPerSecond(), 2048.0 * SECTOR_SIZE / 2);
+    QCOMPARE(sample.getUtilization(), 25.0);
+
+    // io ticks grow faster than the wall clock when requests overlap, clamped to 100%
+    writeStat(1400, 11200, 600, 6048, 12000);
+    sampler.sample(103.0);
+    QCOMPARE(sampler.get_samples(STORAGE_NAME_EMMC).first.latest().getUtilization(), 100.0);
+}
+
+void TestStorageUtility::testTelemetryCounterReset()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    StorageTelemetrySampler sampler(&storageUtil);
+    sampler.add_device(STORAGE_NAME_EMMC);
+    writeStat(1000, 8000, 500, 4000, 10000);
+    sampler.sample(100.0);
+    // device re-created, counters start over
+    writeStat(10, 80, 5, 40, 100);
+    sampler.sample(101.0);
+    QCOMPARE(sampler.get_samples(STORAGE_NAME_EMMC).first.size(), (size_t)0);
+    // the new counters are the base for the next rate
+    writeStat(20, 160, 5, 40, 200);
+    sampler.sample(102.0);
+    auto ret = sampler.get_samples(STORAGE_NAME_EMMC);
+    QCOMPARE(ret.first.size(), (size_t)1);
+    QCOMPARE(ret.first.latest().getReadIOPS(), 10.0);
+    QCOMPARE(ret.first.latest().getUtilization(), 10.0);
+}
+
+void TestStorageUtility::testTelemetryDeviceRemoved()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    StorageTelemetrySampler sampler(&storageUtil);
+    sampler.add_device(STORAGE_NAME_EMMC);
+    writeStat(1000, 8000, 500, 4000, 10000);
+    sampler.sample(100.0);
+    writeStat(1100, 8800, 500, 4000, 10100);
+    sampler.sample(101.0);
+    QCOMPARE(sampler.get_samples(STORAGE_NAME_EMMC).first.size(), (size_t)1);
+    // removed, the history is dropped
+    QVERIFY(write_test_file(m_sysBlock + "/mmcblk2/stat", "1 2 3\n"));
+    sampler.sample(102.0);
+    QCOMPARE(sampler.get_samples(STORAGE_NAME_EMMC).first.size(), (size_t)0);
+    // inserted again, the first sample is only the base
+    writeStat(50, 400, 0, 0, 0);
+    sampler.sample(200.0);
+    QCOMPARE(sampler.get_samples(STORAGE_NAME_EMMC).first.size(), (size_t)0);
+    writeStat(60, 480, 0, 0, 50);
+    sampler.sample(205.0);
+    auto ret = sampler.get_samples(STORAGE_NAME_EMMC);
+    QCOMPARE(ret.first.size(), (size_t)1);
+    QCOMPARE(ret.first.latest().getReadIOPS(), 2.0);
+    QCOMPARE(ret.first.latest().getUtilization(), 1.0);
+}
+
+void TestStorageUtility::testTelemetryRingOverwrite()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    StorageTelemetrySampler sampler(&storageUtil, 3);
+    sampler.add_device(STORAGE_NAME_EMMC);
+    // one more read per second each time, 1 to 5 IOPS
+    unsigned long long readIOs = 0;
+    for (int i = 0; i <= 5; i++)
+    {
+        readIOs += i;
+        writeStat(readIOs, readIOs * 8, 0, 0, 0);
+        sampler.sample(100.0 + i);
+    }
+    auto ret = sampler.get_samples(STORAGE_NAME_EMMC);
+    QCOMPARE(ret.first.capacity(), (size_t)3);
+    QCOMPARE(ret.first.size(), (size_t)3);
+    QCOMPARE(ret.first.at(0).getReadIOPS(), 3.0);
+    QCOMPARE(ret.first.at(0).getTime(), 103.0);
+    QCOMPARE(ret.first.at(2).getReadIOPS(), 5.0);
+    QCOMPARE(ret.first.latest().getTime(), 105.0);
+    QCOMPARE(ret.first.at(3).getTime(), 0.0);
+}
+
+void TestStorageUtility::testTelemetryHealthInterval()
+{
+    TPCStorageUtility storageUtil(m_sysBlock.c_str(), m_mountInfo.c_str(), m_devDisk.c_str());
+    StorageTelemetrySampler sampler(&storageUtil);
+    sampler.add_device(STORAGE_NAME_EMMC);
+    QCOMPARE(sampler.get_health(STORAGE_NAME_EMMC).second, false);
+    sampler.sample(0.0);
+    QCOMPARE(sampler.get_health(STORAGE_NAME_EMMC).first.getLifeTimeA(), 2);
+    // a worn out value is only picked up on the next health sample
+    QVERIFY(write_test_file(m_sysBlock + "/mmcblk2/device/life_time", "0x0a 0x01\n"));
+    for (int i = 1; i < STORAGE_HEALTH_SAMPLE_INTERVAL; i++)
+        sampler.sample(i);
+    QCOMPARE(sampler.get_health(STORAGE_NAME_EMMC).first.getLifeTimeA(), 2);
+    sampler.sample(STORAGE_HEALTH_SAMPLE_INTERVAL);
+    auto ret = sampler.get_health(STORAGE_NAME_EMMC);
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.getLifeTimeA(), 10);
+    QCOMPARE(ret.first.isWarning(), true);
+}
+
+QTEST_GUILESS_MAIN(TestStorageUtility)
+#include "tst_storage_utility.moc"
@@ -0,0 +1,13 @@
+# shared by the unit tests, each test builds the sources it covers
+QT += testlib
+QT -= gui
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+TEMPLATE = app
+
+SRC_FOLDER = $$PWD/../src
+INCLUDEPATH += $$SRC_FOLDER/include $$PWD/common
+DEFINES += QT_MESSAGELOGCONTEXT
+
+HEADERS += $$PWD/common/test_utility.h
+SOURCES += $$PWD/common/test_utility.cpp
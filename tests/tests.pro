@@ -0,0 +1,22 @@
+# unit tests, build and run with: qmake tests.pro && make && make check
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    boot_environment \
+    boot_logo_utility \
+    brightness_controller \
+    ini_document \
+    network_diagnostics \
+    reboot_schedule \
+    screenshot_thumbnailer \
+    screenshot_utility \
+    serial_utility \
+    service_manager \
+    startup_supervisor \
+    storage_utility \
+    time_dbus_utility \
+    time_sync_monitor \
+    timezone_index \
+    timezone_search_index \
+    uevent_monitor \
+    usb_policy
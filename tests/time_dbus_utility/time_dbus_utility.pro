@@ -0,0 +1,13 @@
+include(../tests.pri)
+QT += dbus
+TARGET = tst_time_dbus_utility
+
+HEADERS += $$SRC_FOLDER/include/time_dbus_utility.h \
+    $$SRC_FOLDER/include/service_manager.h
+
+SOURCES += tst_time_dbus_utility.cpp \
+    $$SRC_FOLDER/time_dbus_utility.cpp \
+    $$SRC_FOLDER/time_utility.cpp \
+    $$SRC_FOLDER/time_sync_monitor.cpp \
+    $$SRC_FOLDER/service_manager.cpp \
+    $$SRC_FOLDER/utility.cpp
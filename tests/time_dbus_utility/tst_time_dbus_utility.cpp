@@ -0,0 +1,260 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <mutex>
+#include <QtTest>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QDBusMessage>
+
+#include "time_dbus_utility.h"
+
+// run under dbus-run-session, the mock owns org.freedesktop.timedate1 on the session bus
+#define MOCK_CONNECTION_NAME    "tst_time_dbus_utility_mock"
+#define CLIENT_CONNECTION_NAME  "tst_time_dbus_utility_client"
+#define MOCK_TIMEZONE           "Asia/Taipei"
+// timedated reports NTP after the timesyncd unit job, SetTime is refused until then
+#define MOCK_NTP_JOB_MS         300
+#define MOCK_BUSY_ERROR         "org.freedesktop.timedate1.Busy"
+#define MOCK_BUSY_MESSAGE       "Previous request is not finished, refusing."
+
+// org.freedesktop.timedate1 with the calls the settings use, lives in its own thread
+// because the utility blocks its caller during a call
+class MockTimedate : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.timedate1")
+    Q_PROPERTY(QString Timezone READ getTimezone)
+    Q_PROPERTY(bool NTP READ getNTP)
+    Q_PROPERTY(qulonglong TimeUSec READ getTimeUSec)
+
+public:
+    explicit MockTimedate(const QDBusConnection &bus) : m_bus(bus) {}
+    QString getTimezone() { std::lock_guard<std::mutex> lock(m_mutex); return m_timezone; }
+    bool getNTP() { std::lock_guard<std::mutex> lock(m_mutex); return m_ntp; }
+    qulonglong getTimeUSec() { return (qulonglong)QDateTime::currentMSecsSinceEpoch() * 1000; }
+    void setNTP(bool enabled) { std::lock_guard<std::mutex> lock(m_mutex); m_ntp = enabled; }
+    void setTimeFailed(bool isFailed) { std::lock_guard<std::mutex> lock(m_mutex); m_isSetTimeFailed = isFailed; }
+    QStringList getCalls() { std::lock_guard<std::mutex> lock(m_mutex); return m_calls; }
+    qlonglong getLastTimeUSec() { std::lock_guard<std::mutex> lock(m_mutex); return m_lastTimeUSec; }
+
+public slots:
+    QStringList ListTimezones()
+    {
+        return QStringList() << "Asia/Taipei" << "Europe/Berlin" << "UTC";
+    }
+    void SetTimezone(const QString &timezone, bool)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_calls << "SetTimezone " + timezone;
+        m_timezone = timezone;
+    }
+    void SetTime(qlonglong usecUTC, bool, bool)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_calls << "SetTime";
+        if (m_isNTPPending || m_ntp) {
+            sendErrorReply(MOCK_BUSY_ERROR, MOCK_BUSY_MESSAGE);
+            return;
+        }
+        if (m_isSetTimeFailed) {
+            sendErrorReply(QDBusError::AccessDenied, "Permission denied");
+            return;
+        }
+        m_lastTimeUSec = usecUTC;
+    }
+    void SetNTP(bool enabled, bool)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_calls << QString("SetNTP ") + (enabled ? "true" : "false");
+        m_isNTPPending = true;
+        // reply first, the property follows when the unit job is done
+        QTimer::singleShot(MOCK_NTP_JOB_MS, this, [this, enabled]() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_ntp = enabled;
+                m_isNTPPending = false;
+            }
+            QDBusMessage signal = QDBusMessage::createSignal(TIMEDATE1_PATH, DBUS_PROPERTIES_INTERFACE,
+                                                             "PropertiesChanged");
+            QVariantMap changed;
+            changed.insert("NTP", enabled);
+            signal << QString(TIMEDATE1_INTERFACE) << changed << QStringList();
+            m_bus.send(signal);
+        });
+    }
+
+private:
+    QDBusConnection m_bus;
+    std::mutex m_mutex;
+    QString m_timezone = MOCK_TIMEZONE;
+    bool m_ntp = true;
+    bool m_isNTPPending = false;
+    bool m_isSetTimeFailed = false;
+    qlonglong m_lastTimeUSec = 0;
+    QStringList m_calls;
+};
+
+class TestTimeDBusUtility : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void cleanupTestCase();
+    void testProperties();
+    void testListTimezones();
+    void testSetTimezone();
+    void testSetSameTimezone();
+    void testSetManualTimeInTimezone();
+    void testSetManualTimeInvalid();
+    void testSetTimeError();
+    void testDisableNTPWaitsForJob();
+    void testEnableNTPDoesNotWait();
+    void testNTPUnchanged();
+
+private:
+    QThread m_mockThread;
+    MockTimedate *m_mock = nullptr;
+    TPCTimeDBusUtility *m_timeUtil = nullptr;
+};
+
+void TestTimeDBusUtility::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected())
+        QSKIP("no session bus, run with dbus-run-session");
+    QDBusConnection mockBus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, MOCK_CONNECTION_NAME);
+    QVERIFY(mockBus.isConnected());
+    QVERIFY(mockBus.registerService(TIMEDATE1_SERVICE));
+    m_mockThread.start();
+}
+
+void TestTimeDBusUtility::init()
+{
+    QDBusConnection mockBus(MOCK_CONNECTION_NAME);
+    m_mock = new MockTimedate(mockBus);
+    m_mock->moveToThread(&m_mockThread);
+    QVERIFY(mockBus.registerObject(TIMEDATE1_PATH, m_mock,
+        QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllProperties));
+    m_timeUtil = new TPCTimeDBusUtility(QDBusConnection::connectToBus(QDBusConnection::SessionBus,
+                                                                      CLIENT_CONNECTION_NAME));
+}
+
+void TestTimeDBusUtility::cleanup()
+{
+    delete m_timeUtil;
+    m_timeUtil = nullptr;
+    QDBusConnection(MOCK_CONNECTION_NAME).unregisterObject(TIMEDATE1_PATH);
+    if (m_mock)
+        m_mock->deleteLater();
+    m_mock = nullptr;
+}
+
+void TestTimeDBusUtility::cleanupTestCase()
+{
+    m_mockThread.quit();
+    m_mockThread.wait();
+    QDBusConnection::disconnectFromBus(CLIENT_CONNECTION_NAME);
+    QDBusConnection::disconnectFromBus(MOCK_CONNECTION_NAME);
+}
+
+void TestTimeDBusUtility::testProperties()
+{
+    QCOMPARE(m_timeUtil->get_current_timezone(), make_pair(string(MOCK_TIMEZONE), true));
+    QCOMPARE(m_timeUtil->get_ntp_enabled(), make_pair(true, true));
+    auto retDate = m_timeUtil->get_current_date();
+    QVERIFY(retDate.second);
+    QCOMPARE(retDate.first.size(), strlen("2022-01-14"));
+    auto retTime = m_timeUtil->get_current_time();
+    QVERIFY(retTime.second);
+    QCOMPARE(retTime.first.size(), strlen("07:55:44"));
+}
+
+void TestTimeDBusUtility::testListTimezones()
+{
+    auto ret = m_timeUtil->get_timezones();
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first, vector<string>({"Asia/Taipei", "Europe/Berlin", "UTC"}));
+}
+
+void TestTimeDBusUtility::testSetTimezone()
+{
+    QVERIFY(m_timeUtil->set_timezone("Europe/Berlin").second);
+    QCOMPARE(m_mock->getCalls(), QStringList() << "SetTimezone Europe/Berlin");
+    // cached properties are dropped after a call
+    QCOMPARE(m_timeUtil->get_current_timezone().first, string("Europe/Berlin"));
+    QVERIFY(!m_timeUtil->set_timezone("").second);
+}
+
+void TestTimeDBusUtility::testSetSameTimezone()
+{
+    QVERIFY(m_timeUtil->set_timezone(MOCK_TIMEZONE).second);
+    QVERIFY(m_mock->getCalls().isEmpty());
+}
+
+void TestTimeDBusUtility::testSetManualTimeInTimezone()
+{
+    m_mock->setNTP(false);
+    QVERIFY(m_timeUtil->set_manual_date_time("2022-01-14 7:55:44").second);
+    // local time of the configured timezone, not of the process, UTC+8
+    QDateTime expected(QDate(2022, 1, 13), QTime(23, 55, 44), Qt::UTC);
+    QCOMPARE(m_mock->getLastTimeUSec(), expected.toMSecsSinceEpoch() * 1000);
+}
+
+void TestTimeDBusUtility::testSetManualTimeInvalid()
+{
+    m_mock->setNTP(false);
+    QVERIFY(!m_timeUtil->set_manual_date_time("2022-13-40 7:55:44").second);
+    QVERIFY(!m_timeUtil->set_manual_date_time("").second);
+    QVERIFY(m_mock->getCalls().isEmpty());
+}
+
+void TestTimeDBusUtility::testSetTimeError()
+{
+    m_mock->setNTP(false);
+    m_mock->setTimeFailed(true);
+    auto ret = m_timeUtil->set_manual_date_time("2022-01-14 7:55:44");
+    QVERIFY(!ret.second);
+    QCOMPARE(ret.first, string("Permission denied"));
+}
+
+void TestTimeDBusUtility::testDisableNTPWaitsForJob()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(m_timeUtil->set_sync_with_ntp_server(false, "").second);
+    // returned on the property change, long before the timeout
+    QVERIFY(timer.elapsed() >= MOCK_NTP_JOB_MS - 50);
+    QVERIFY(timer.elapsed() < TIMESYNCD_SERVICE_TIMEOUT * 1000 / 2);
+    // manual time is accepted right after
+    QVERIFY(m_timeUtil->set_manual_date_time("2022-01-14 7:55:44").second);
+    QCOMPARE(m_mock->getCalls(), QStringList() << "SetNTP false" << "SetTime");
+    QCOMPARE(m_timeUtil->get_ntp_enabled().first, false);
+}
+
+void TestTimeDBusUtility::testEnableNTPDoesNotWait()
+{
+    m_mock->setNTP(false);
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(m_timeUtil->set_sync_with_ntp_server(true, "").second);
+    QVERIFY(timer.elapsed() < MOCK_NTP_JOB_MS);
+    QCOMPARE(m_mock->getCalls(), QStringList() << "SetNTP true");
+    QTRY_COMPARE(m_timeUtil->get_ntp_enabled().first, true);
+}
+
+void TestTimeDBusUtility::testNTPUnchanged()
+{
+    QVERIFY(m_timeUtil->set_sync_with_ntp_server(true, "").second);
+    QVERIFY(m_mock->getCalls().isEmpty());
+    QVERIFY(!m_timeUtil->set_sync_with_ntp_server(true, nullptr).second);
+}
+
+QTEST_GUILESS_MAIN(TestTimeDBusUtility)
+#include "tst_time_dbus_utility.moc"
@@ -0,0 +1,5 @@
+include(../tests.pri)
+TARGET = tst_time_sync_monitor
+
+SOURCES += tst_time_sync_monitor.cpp \
+    $$SRC_FOLDER/time_sync_monitor.cpp
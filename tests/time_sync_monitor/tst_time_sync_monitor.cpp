@@ -0,0 +1,319 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstring>
+#include <QtTest>
+
+#include "time_sync_monitor.h"
+
+using namespace std;
+
+// kernel state and monotonic clock set by the test
+class FakeClockSource: public ITimeSyncClockSource {
+public:
+    FakeClockSource()
+    {
+        state = {0, 0, 0, 0, 0, true};
+        time = 100;
+        isReadable = true;
+    }
+    bool read_kernel_clock(KernelClockState &clockState) override
+    {
+        if (!isReadable)
+            return false;
+        clockState = state;
+        return true;
+    }
+    double now() override
+    {
+        return time;
+    }
+
+    KernelClockState state;
+    double time;
+    bool isReadable;
+};
+
+// server ahead of the local clock by offsetUs, symmetric path of delayUs round trip
+static NTPMessageData make_message(unsigned long long originUs, long long offsetUs, unsigned long long delayUs,
+                                   unsigned long long packetCount)
+{
+    NTPMessageData message;
+    memset(&message, 0, sizeof(message));
+    message.stratum = 2;
+    message.originUs = originUs;
+    message.receiveUs = originUs + delayUs / 2 + offsetUs;
+    // 100 us spent in the server
+    message.transmitUs = message.receiveUs + 100;
+    message.destinationUs = message.transmitUs - offsetUs + delayUs / 2;
+    message.packetCount = packetCount;
+    return message;
+}
+
+class TestTimeSyncMonitor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testNTPOffsetAndDelay();
+    void testRingOrder();
+    void testRingWrap();
+    void testRingZeroCapacity();
+    void testKernelSample();
+    void testKernelReadFailure();
+    void testKernelJitter();
+    void testNTPSample();
+    void testNTPDuplicateIgnored();
+    void testNTPSpikeNotInJitter();
+    void testNTPStale();
+    void testJitterWindow();
+    void testSummary();
+    void testHostKernelClock();
+};
+
+void TestTimeSyncMonitor::testNTPOffsetAndDelay()
+{
+    NTPMessageData message = make_message(1000000, 2500, 8000, 1);
+    QCOMPARE(get_ntp_offset_ms(message), 2.5);
+    QCOMPARE(get_ntp_delay_ms(message), 8.0);
+
+    // server behind
+    message = make_message(1000000, -1200, 400, 1);
+    QCOMPARE(get_ntp_offset_ms(message), -1.2);
+    QCOMPARE(get_ntp_delay_ms(message), 0.4);
+}
+
+void TestTimeSyncMonitor::testRingOrder()
+{
+    TimeSyncRing ring(4);
+    QCOMPARE(ring.size(), (size_t)0);
+    QCOMPARE(ring.latest().getTime(), 0.0);
+    for (int i = 1; i <= 3; i++)
+    {
+        TimeSyncSample sample;
+        sample.setTime(i);
+        ring.push(sample);
+    }
+    QCOMPARE(ring.size(), (size_t)3);
+    QCOMPARE(ring.at(0).getTime(), 1.0);
+    QCOMPARE(ring.at(2).getTime(), 3.0);
+    QCOMPARE(ring.latest().getTime(), 3.0);
+    // out of range is an empty sample
+    QCOMPARE(ring.at(3).getTime(), 0.0);
+}
+
+void TestTimeSyncMonitor::testRingWrap()
+{
+    TimeSyncRing ring(4);
+    for (int i = 1; i <= 10; i++)
+    {
+        TimeSyncSample sample;
+        sample.setTime(i);
+        ring.push(sample);
+    }
+    QCOMPARE(ring.size(), (size_t)4);
+    QCOMPARE(ring.capacity(), (size_t)4);
+    for (size_t i = 0; i < 4; i++)
+        QCOMPARE(ring.at(i).getTime(), 7.0 + i);
+    QCOMPARE(ring.latest().getTime(), 10.0);
+
+    ring.clear();
+    QCOMPARE(ring.size(), (size_t)0);
+    TimeSyncSample sample;
+    sample.setTime(11);
+    ring.push(sample);
+    QCOMPARE(ring.at(0).getTime(), 11.0);
+}
+
+void TestTimeSyncMonitor::testRingZeroCapacity()
+{
+    TimeSyncRing ring(0);
+    QCOMPARE(ring.capacity(), (size_t)1);
+    TimeSyncSample sample;
+    sample.setTime(5);
+    ring.push(sample);
+    sample.setTime(6);
+    ring.push(sample);
+    QCOMPARE(ring.size(), (size_t)1);
+    QCOMPARE(ring.latest().getTime(), 6.0);
+}
+
+void TestTimeSyncMonitor::testKernelSample()
+{
+    FakeClockSource clock;
+    clock.state.offsetNs = 1500000;
+    clock.state.frequencyPpm = -12.5;
+    clock.state.maxErrorUs = 4000;
+    TimeSyncMonitor monitor(&clock);
+    monitor.sample();
+
+    QVERIFY(monitor.get_kernel_state().second);
+    TimeSyncRing ring = monitor.get_samples();
+    QCOMPARE(ring.size(), (size_t)1);
+    TimeSyncSample sample = ring.latest();
+    QCOMPARE(sample.getTime(), 100.0);
+    QCOMPARE(sample.getOffset(), 1.5);
+    QCOMPARE(sample.getFrequency(), -12.5);
+    QCOMPARE(sample.getMaxError(), 4.0);
+    QCOMPARE(sample.getJitter(), 0.0);
+    QVERIFY(sample.isSynchronized());
+    QVERIFY(!sample.isFromNTP());
+}
+
+void TestTimeSyncMonitor::testKernelReadFailure()
+{
+    FakeClockSource clock;
+    clock.isReadable = false;
+    TimeSyncMonitor monitor(&clock);
+    monitor.sample();
+    QVERIFY(!monitor.get_kernel_state().second);
+    QCOMPARE(monitor.get_samples().size(), (size_t)0);
+    QCOMPARE(monitor.get_summary(), string("Not supported"));
+
+    // recovers once adjtimex works again
+    clock.isReadable = true;
+    monitor.sample();
+    QVERIFY(monitor.get_kernel_state().second);
+    QCOMPARE(monitor.get_samples().size(), (size_t)1);
+}
+
+void TestTimeSyncMonitor::testKernelJitter()
+{
+    FakeClockSource clock;
+    TimeSyncMonitor monitor(&clock);
+    // offsets 0, 1, 0, 1 ms, every successive difference is 1 ms
+    for (int i = 0; i < 4; i++)
+    {
+        clock.state.offsetNs = (i % 2) * 1000000;
+        clock.time += 2;
+        monitor.sample();
+    }
+    QCOMPARE(monitor.get_samples().size(), (size_t)4);
+    QCOMPARE(monitor.get_samples().latest().getJitter(), 1.0);
+}
+
+void TestTimeSyncMonitor::testNTPSample()
+{
+    FakeClockSource clock;
+    clock.state.offsetNs = 300000;
+    TimeSyncMonitor monitor(&clock);
+    QVERIFY(!monitor.get_ntp_message().second);
+    monitor.add_ntp_message(make_message(1000000, 2000, 8000, 1));
+    QVERIFY(monitor.get_ntp_message().second);
+    monitor.sample();
+
+    // server measurement wins over the kernel residual
+    TimeSyncSample sample = monitor.get_samples().latest();
+    QVERIFY(sample.isFromNTP());
+    QCOMPARE(sample.getOffset(), 2.0);
+
+    monitor.add_ntp_message(make_message(2000000, 5000, 8000, 2));
+    monitor.sample();
+    sample = monitor.get_samples().latest();
+    QCOMPARE(sample.getOffset(), 5.0);
+    QCOMPARE(sample.getJitter(), 3.0);
+}
+
+void TestTimeSyncMonitor::testNTPDuplicateIgnored()
+{
+    FakeClockSource clock;
+    TimeSyncMonitor monitor(&clock);
+    NTPMessageData message = make_message(1000000, 2000, 8000, 1);
+    monitor.add_ntp_message(message);
+    // timesyncd reports the same packet on every property change
+    clock.time += 10;
+    monitor.add_ntp_message(message);
+    monitor.add_ntp_message(message);
+    monitor.sample();
+    TimeSyncSample sample = monitor.get_samples().latest();
+    QCOMPARE(sample.getOffset(), 2.0);
+    // a repeated packet must not refresh the age either
+    clock.time = 100 + TIME_SYNC_NTP_MAX_AGE + 1;
+    monitor.add_ntp_message(message);
+    monitor.sample();
+    QVERIFY(!monitor.get_samples().latest().isFromNTP());
+}
+
+void TestTimeSyncMonitor::testNTPSpikeNotInJitter()
+{
+    FakeClockSource clock;
+    TimeSyncMonitor monitor(&clock);
+    monitor.add_ntp_message(make_message(1000000, 1000, 8000, 1));
+    monitor.add_ntp_message(make_message(2000000, 1000, 8000, 2));
+    NTPMessageData spike = make_message(3000000, 900000, 8000, 3);
+    spike.isSpike = true;
+    monitor.add_ntp_message(spike);
+    QCOMPARE(monitor.get_ntp_message().first.packetCount, 3ULL);
+    monitor.sample();
+
+    TimeSyncSample sample = monitor.get_samples().latest();
+    QVERIFY(sample.isFromNTP());
+    QCOMPARE(sample.getOffset(), 1.0);
+    QCOMPARE(sample.getJitter(), 0.0);
+}
+
+void TestTimeSyncMonitor::testNTPStale()
+{
+    FakeClockSource clock;
+    clock.state.offsetNs = 250000;
+    TimeSyncMonitor monitor(&clock);
+    monitor.add_ntp_message(make_message(1000000, 2000, 8000, 1));
+    clock.time += TIME_SYNC_NTP_MAX_AGE - 1;
+    monitor.sample();
+    QVERIFY(monitor.get_samples().latest().isFromNTP());
+
+    // timesyncd stopped, fall back to the kernel
+    clock.time += 2;
+    monitor.sample();
+    TimeSyncSample sample = monitor.get_samples().latest();
+    QVERIFY(!sample.isFromNTP());
+    QCOMPARE(sample.getOffset(), 0.25);
+}
+
+void TestTimeSyncMonitor::testJitterWindow()
+{
+    FakeClockSource clock;
+    TimeSyncMonitor monitor(&clock);
+    // one large step, then a steady offset longer than the window
+    clock.state.offsetNs = 0;
+    monitor.sample();
+    clock.state.offsetNs = 8000000;
+    monitor.sample();
+    QCOMPARE(monitor.get_samples().latest().getJitter(), 8.0);
+    for (int i = 0; i < TIME_SYNC_JITTER_WINDOW; i++)
+        monitor.sample();
+    // the step has left the window
+    QCOMPARE(monitor.get_samples().latest().getJitter(), 0.0);
+}
+
+void TestTimeSyncMonitor::testSummary()
+{
+    FakeClockSource clock;
+    clock.state.offsetNs = -1250000;
+    clock.state.frequencyPpm = 3.5;
+    clock.state.maxErrorUs = 16000;
+    TimeSyncMonitor monitor(&clock);
+    monitor.sample();
+    QCOMPARE(monitor.get_summary(), string("Synchronized, offset -1.250 ms (kernel), jitter 0.000 ms\n"
+                                           "Frequency +3.500 ppm, max error 16.000 ms"));
+
+    clock.state.isSynchronized = false;
+    monitor.add_ntp_message(make_message(1000000, 2000, 8000, 1));
+    monitor.sample();
+    QCOMPARE(monitor.get_summary(), string("Not synchronized, offset +2.000 ms (server), jitter 0.000 ms\n"
+                                           "Frequency +3.500 ppm, max error 16.000 ms, stratum 2, delay 8.000 ms"));
+}
+
+void TestTimeSyncMonitor::testHostKernelClock()
+{
+    // adjtimex with no modes only reads, no privilege needed
+    TPCTimeSyncClockSource clock;
+    KernelClockState state;
+    QVERIFY(clock.read_kernel_clock(state));
+    QVERIFY(state.maxErrorUs >= 0);
+    double first = clock.now();
+    QVERIFY(clock.now() >= first);
+}
+
+QTEST_GUILESS_MAIN(TestTimeSyncMonitor)
+#include "tst_time_sync_monitor.moc"
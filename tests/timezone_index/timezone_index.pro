@@ -0,0 +1,5 @@
+include(../tests.pri)
+TARGET = tst_timezone_index
+
+SOURCES += tst_timezone_index.cpp \
+    $$SRC_FOLDER/timezone_index.cpp
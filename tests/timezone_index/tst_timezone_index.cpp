@@ -0,0 +1,380 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <cstdint>
+
+#include "test_utility.h"
+#include "timezone_index.h"
+
+// utc seconds of the transitions used below
+#define UTC_2023_01_15          1673740800LL
+#define UTC_2023_07_01          1688169600LL
+#define UTC_NY_DST_START_2023   1678604400LL
+#define UTC_NY_DST_END_2023     1699164000LL
+#define UTC_CET_DST_START_2040  2216250000LL
+#define UTC_CET_DST_END_2040    2234998800LL
+
+// one transition block, the v1 block has 32 bit times and v2+ blocks 64 bit
+struct TzifBlock
+{
+    vector<long long> transitions;
+    vector<unsigned char> transitionTypes;
+    vector<TimezoneType> types;
+};
+
+// fixture zones are written as tzif files under a fake zoneinfo root
+class TestTimezoneIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testTzifVersion1();
+    void testTzifVersion2Footer();
+    void testTzifVersion3();
+    void testTzifEmptyFooter();
+    void testTzifInvalid();
+    void testPosixNoDst();
+    void testPosixNegativeOffset();
+    void testPosixDefaultRules();
+    void testPosixSouthernHemisphere();
+    void testPosixMonthWeekDayTime();
+    void testPosixJulianDay();
+    void testPosixZeroBasedDay();
+    void testPosixInvalid();
+    void testFormatUtcOffset();
+    void testIndexLoad();
+
+private:
+    string _make_block(char version, const TzifBlock &block, bool is64);
+    string _make_tzif_v1(const TzifBlock &block);
+    string _make_tzif(char version, const TzifBlock &v1Block, const TzifBlock &block, const string& footer);
+    TzifBlock _make_new_york();
+    PosixTimezone _parse(const string& text);
+
+    string m_zoneinfoFolder;
+    QTemporaryDir m_folder;
+};
+
+static void append_be32(string &buffer, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8)
+        buffer.push_back((char)((value >> shift) & 0xff));
+}
+
+static void append_be64(string &buffer, long long value)
+{
+    append_be32(buffer, (uint32_t)((unsigned long long)value >> 32));
+    append_be32(buffer, (uint32_t)value);
+}
+
+void TestTimezoneIndex::init()
+{
+    QVERIFY(m_folder.isValid());
+    m_zoneinfoFolder = m_folder.path().toStdString() + "/" + QTest::currentTestFunction() + "/zoneinfo";
+}
+
+string TestTimezoneIndex::_make_block(char version, const TzifBlock &block, bool is64)
+{
+    string chars;
+    vector<unsigned char> indexes;
+    for (auto &type : block.types)
+    {
+        indexes.push_back((unsigned char)chars.size());
+        chars += type.abbreviation;
+        chars.push_back('\0');
+    }
+    string buffer = "TZif";
+    buffer.push_back(version);
+    buffer.append(15, '\0');
+    // isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt
+    append_be32(buffer, 0);
+    append_be32(buffer, 0);
+    append_be32(buffer, 0);
+    append_be32(buffer, (uint32_t)block.transitions.size());
+    append_be32(buffer, (uint32_t)block.types.size());
+    append_be32(buffer, (uint32_t)chars.size());
+    for (auto transition : block.transitions)
+    {
+        if (is64)
+            append_be64(buffer, transition);
+        else
+            append_be32(buffer, (uint32_t)(int32_t)transition);
+    }
+    for (auto type : block.transitionTypes)
+        buffer.push_back((char)type);
+    for (size_t i = 0; i < block.types.size(); i++)
+    {
+        append_be32(buffer, (uint32_t)block.types[i].offset);
+        buffer.push_back(block.types[i].isDst ? 1 : 0);
+        buffer.push_back((char)indexes[i]);
+    }
+    buffer += chars;
+    return buffer;
+}
+
+string TestTimezoneIndex::_make_tzif_v1(const TzifBlock &block)
+{
+    return _make_block('\0', block, false);
+}
+
+string TestTimezoneIndex::_make_tzif(char version, const TzifBlock &v1Block, const TzifBlock &block, const string& footer)
+{
+    return _make_block(version, v1Block, false) + _make_block(version, block, true) + "\n" + footer + "\n";
+}
+
+// the 2023 transitions of America/New_York
+TzifBlock TestTimezoneIndex::_make_new_york()
+{
+    TzifBlock block;
+    block.types = {{-18000, false, "EST"}, {-14400, true, "EDT"}};
+    block.transitions = {UTC_NY_DST_START_2023, UTC_NY_DST_END_2023};
+    block.transitionTypes = {1, 0};
+    return block;
+}
+
+PosixTimezone TestTimezoneIndex::_parse(const string& text)
+{
+    PosixTimezone timezone;
+    if (!parse_posix_timezone(text, timezone))
+        qWarning("parse %s failed", text.c_str());
+    return timezone;
+}
+
+void TestTimezoneIndex::testTzifVersion1()
+{
+    TimezoneData data;
+    QVERIFY(parse_tzif(_make_tzif_v1(_make_new_york()), data));
+    QCOMPARE(data.transitions.size(), (size_t)2);
+    QCOMPARE(data.types.size(), (size_t)2);
+    QCOMPARE(data.types[1].abbreviation, string("EDT"));
+    QCOMPARE(data.hasFooter, false);
+    // type 0 before the first transition
+    QCOMPARE(get_timezone_type(data, UTC_2023_01_15).offset, -18000);
+    QCOMPARE(get_timezone_type(data, UTC_NY_DST_START_2023 - 1).isDst, false);
+    QCOMPARE(get_timezone_type(data, UTC_NY_DST_START_2023).abbreviation, string("EDT"));
+    QCOMPARE(get_timezone_type(data, UTC_2023_07_01).offset, -14400);
+    // no footer, the last transition stays
+    QCOMPARE(get_timezone_type(data, UTC_NY_DST_END_2023).abbreviation, string("EST"));
+    QCOMPARE(get_timezone_type(data, UTC_CET_DST_START_2040).offset, -18000);
+}
+
+void TestTimezoneIndex::testTzifVersion2Footer()
+{
+    // the v1 block is outdated on purpose, only the 64 bit block may be used
+    TzifBlock v1Block;
+    v1Block.types = {{0, false, "LMT"}};
+    TzifBlock block;
+    block.types = {{3600, false, "CET"}, {7200, true, "CEST"}};
+    // past 2038, out of 32 bit range
+    block.transitions = {UTC_2023_01_15, UTC_CET_DST_START_2040};
+    block.transitionTypes = {0, 1};
+    TimezoneData data;
+    QVERIFY(parse_tzif(_make_tzif('2', v1Block, block, "CET-1CEST,M3.5.0,M10.5.0/3"), data));
+    QCOMPARE(data.types.size(), (size_t)2);
+    QCOMPARE(data.transitions.back(), UTC_CET_DST_START_2040);
+    QVERIFY(data.hasFooter);
+    QCOMPARE(data.footer.standard.offset, 3600);
+    QCOMPARE(data.footer.daylight.offset, 7200);
+    QCOMPARE(get_timezone_type(data, UTC_2023_07_01).abbreviation, string("CET"));
+    // from the last transition on, the footer rule decides
+    QCOMPARE(get_timezone_type(data, UTC_CET_DST_START_2040).abbreviation, string("CEST"));
+    QCOMPARE(get_timezone_type(data, UTC_CET_DST_END_2040 - 1).offset, 7200);
+    QCOMPARE(get_timezone_type(data, UTC_CET_DST_END_2040).offset, 3600);
+}
+
+void TestTimezoneIndex::testTzifVersion3()
+{
+    TimezoneData data;
+    QVERIFY(parse_tzif(_make_tzif('3', _make_new_york(), _make_new_york(), "EST5EDT,M3.2.0,M11.1.0"), data));
+    QVERIFY(data.hasFooter);
+    QCOMPARE(get_timezone_type(data, UTC_NY_DST_END_2023 - 1).abbreviation, string("EDT"));
+    QCOMPARE(get_timezone_type(data, UTC_NY_DST_END_2023).abbreviation, string("EST"));
+}
+
+void TestTimezoneIndex::testTzifEmptyFooter()
+{
+    TimezoneData data;
+    QVERIFY(parse_tzif(_make_tzif('2', _make_new_york(), _make_new_york(), ""), data));
+    QCOMPARE(data.hasFooter, false);
+    QCOMPARE(get_timezone_type(data, UTC_CET_DST_START_2040).abbreviation, string("EST"));
+}
+
+void TestTimezoneIndex::testTzifInvalid()
+{
+    TimezoneData data;
+    string valid = _make_tzif('2', _make_new_york(), _make_new_york(), "EST5EDT,M3.2.0,M11.1.0");
+    QVERIFY(!parse_tzif("", data));
+    QVERIFY(!parse_tzif("TZjf" + valid.substr(4), data));
+    // cut inside the 64 bit block
+    QVERIFY(!parse_tzif(valid.substr(0, valid.size() - 40), data));
+    // transition type past the type count
+    TzifBlock badType = _make_new_york();
+    badType.transitionTypes[1] = 2;
+    QVERIFY(!parse_tzif(_make_tzif_v1(badType), data));
+    // no local time type at all
+    TzifBlock noTypes;
+    QVERIFY(!parse_tzif(_make_tzif_v1(noTypes), data));
+    // abbreviation index past the characters
+    string badChars = _make_tzif_v1(_make_new_york());
+    // last type record ends right before "EST\0EDT\0"
+    badChars[badChars.size() - 8 - 1] = 100;
+    QVERIFY(!parse_tzif(badChars, data));
+}
+
+void TestTimezoneIndex::testPosixNoDst()
+{
+    PosixTimezone timezone = _parse("CST-8");
+    QCOMPARE(timezone.hasDst, false);
+    QCOMPARE(timezone.standard.abbreviation, string("CST"));
+    QCOMPARE(timezone.standard.offset, 8 * 3600);
+    QCOMPARE(get_posix_timezone_type(timezone, UTC_2023_07_01).offset, 8 * 3600);
+    // quoted names and minutes, ex: Asia/Kolkata and Asia/Kathmandu
+    QCOMPARE(_parse("IST-5:30").standard.offset, 5 * 3600 + 1800);
+    PosixTimezone quoted = _parse("<+0545>-5:45");
+    QCOMPARE(quoted.standard.abbreviation, string("+0545"));
+    QCOMPARE(quoted.standard.offset, 5 * 3600 + 45 * 60);
+}
+
+void TestTimezoneIndex::testPosixNegativeOffset()
+{
+    // west of utc is a positive posix offset
+    PosixTimezone timezone = _parse("<-03>3");
+    QCOMPARE(timezone.standard.abbreviation, string("-03"));
+    QCOMPARE(timezone.standard.offset, -3 * 3600);
+    QCOMPARE(_parse("NST3:30NDT,M3.2.0,M11.1.0").standard.offset, -(3 * 3600 + 1800));
+    QCOMPARE(_parse("HST10").standard.offset, -10 * 3600);
+    // explicit dst offset
+    PosixTimezone lordHowe = _parse("<+1030>-10:30<+11>-11,M10.1.0,M4.1.0");
+    QCOMPARE(lordHowe.daylight.offset, 11 * 3600);
+}
+
+void TestTimezoneIndex::testPosixDefaultRules()
+{
+    // no rule given, M3.2.0,M11.1.0
+    PosixTimezone timezone = _parse("EST5EDT");
+    QVERIFY(timezone.hasDst);
+    QCOMPARE(timezone.daylight.offset, -4 * 3600);
+    QCOMPARE(get_posix_timezone_type(timezone, UTC_NY_DST_START_2023 - 1).isDst, false);
+    QCOMPARE(get_posix_timezone_type(timezone, UTC_NY_DST_START_2023).isDst, true);
+    QCOMPARE(get_posix_timezone_type(timezone, UTC_NY_DST_END_2023 - 1).isDst, true);
+    QCOMPARE(get_posix_timezone_type(timezone, UTC_NY_DST_END_2023).isDst, false);
+}
+
+void TestTimezoneIndex::testPosixSouthernHemisphere()
+{
+    // Australia/Sydney, dst spans the new year
+    PosixTimezone timezone = _parse("AEST-10AEDT,M10.1.0,M4.1.0/3");
+    QVERIFY(timezone.hasDst);
+    QCOMPARE(get_posix_timezone_type(timezone, UTC_2023_01_15).abbreviation, string("AEDT"));
+    QCOMPARE(get_posix_timezone_type(timezone, UTC_2023_01_15).offset, 11 * 3600);
+    QCOMPARE(get_posix_timezone_type(timezone, UTC_2023_07_01).abbreviation, string("AEST"));
+    // 2023-04-02 03:00 AEDT and 2023-10-01 02:00 AEST
+    QCOMPARE(get_posix_timezone_type(timezone, 1680364800LL - 1).isDst, true);
+    QCOMPARE(get_posix_timezone_type(timezone, 1680364800LL).isDst, false);
+    QCOMPARE(get_posix_timezone_type(timezone, 1696089600LL - 1).isDst, false);
+    QCOMPARE(get_posix_timezone_type(timezone, 1696089600LL).isDst, true);
+}
+
+void TestTimezoneIndex::testPosixMonthWeekDayTime()
+{
+    // America/Nuuk, negative rule time is 23:00 of the day before
+    PosixTimezone nuuk = _parse("<-02>2<-01>,M3.5.0/-1,M10.5.0/0");
+    QCOMPARE(nuuk.start.kind, 'M');
+    QCOMPARE(nuuk.start.week, 5);
+    QCOMPARE(nuuk.start.time, -3600);
+    // 2023-03-25 23:00 -02 and 2023-10-29 00:00 -01
+    QCOMPARE(get_posix_timezone_type(nuuk, 1679792400LL - 1).isDst, false);
+    QCOMPARE(get_posix_timezone_type(nuuk, 1679792400LL).isDst, true);
+    QCOMPARE(get_posix_timezone_type(nuuk, 1698541200LL - 1).isDst, true);
+    QCOMPARE(get_posix_timezone_type(nuuk, 1698541200LL).isDst, false);
+    // Asia/Jerusalem, 26:00 of the fourth thursday is 02:00 on friday
+    PosixTimezone jerusalem = _parse("IST-2IDT,M3.4.4/26,M10.5.0");
+    QCOMPARE(jerusalem.start.time, 26 * 3600);
+    QCOMPARE(get_posix_timezone_type(jerusalem, 1679616000LL - 1).isDst, false);
+    QCOMPARE(get_posix_timezone_type(jerusalem, 1679616000LL).isDst, true);
+    // week 5 of a month with four sundays is the fourth one, 2040-10-28 03:00 CEST
+    PosixTimezone cet = _parse("CET-1CEST,M3.5.0,M10.5.0/3");
+    QCOMPARE(get_posix_timezone_type(cet, UTC_CET_DST_END_2040 - 1).isDst, true);
+    QCOMPARE(get_posix_timezone_type(cet, UTC_CET_DST_END_2040).isDst, false);
+    QCOMPARE(get_posix_timezone_type(cet, UTC_CET_DST_START_2040).isDst, true);
+}
+
+void TestTimezoneIndex::testPosixJulianDay()
+{
+    // J60 is March 1 in every year, Feb 29 is never counted
+    PosixTimezone timezone = _parse("<-03>3<-02>,J60,J300");
+    QCOMPARE(timezone.start.kind, 'J');
+    QCOMPARE(timezone.start.day, 60);
+    // 2023-03-01 and 2024-03-01 02:00 -03
+    QCOMPARE(get_posix_timezone_type(timezone, 1677646800LL - 1).isDst, false);
+    QCOMPARE(get_posix_timezone_type(timezone, 1677646800LL).isDst, true);
+    QCOMPARE(get_posix_timezone_type(timezone, 1709269200LL - 1).isDst, false);
+    QCOMPARE(get_posix_timezone_type(timezone, 1709269200LL).isDst, true);
+}
+
+void TestTimezoneIndex::testPosixZeroBasedDay()
+{
+    // day 59 counts Feb 29, it is Feb 29 in 2024 and March 1 in 2023
+    PosixTimezone timezone = _parse("<-03>3<-02>,59,300");
+    QCOMPARE(timezone.start.kind, 'D');
+    QCOMPARE(get_posix_timezone_type(timezone, 1709182800LL - 1).isDst, false);
+    QCOMPARE(get_posix_timezone_type(timezone, 1709182800LL).isDst, true);
+    QCOMPARE(get_posix_timezone_type(timezone, 1677646800LL - 1).isDst, false);
+    QCOMPARE(get_posix_timezone_type(timezone, 1677646800LL).isDst, true);
+}
+
+void TestTimezoneIndex::testPosixInvalid()
+{
+    PosixTimezone timezone;
+    QVERIFY(!parse_posix_timezone("", timezone));
+    QVERIFY(!parse_posix_timezone("AB5", timezone));
+    QVERIFY(!parse_posix_timezone("EST", timezone));
+    QVERIFY(!parse_posix_timezone("<+08-8", timezone));
+    QVERIFY(!parse_posix_timezone("EST5EDT,M13.1.0,M11.1.0", timezone));
+    QVERIFY(!parse_posix_timezone("EST5EDT,M3.6.0,M11.1.0", timezone));
+    QVERIFY(!parse_posix_timezone("EST5EDT,M3.2.7,M11.1.0", timezone));
+    QVERIFY(!parse_posix_timezone("EST5EDT,J0,J300", timezone));
+    QVERIFY(!parse_posix_timezone("EST5EDT,M3.2.0", timezone));
+    QVERIFY(!parse_posix_timezone("EST5EDT,M3.2.0,M11.1.0/168", timezone));
+    QVERIFY(!parse_posix_timezone("EST5EDT,M3.2.0,M11.1.0x", timezone));
+}
+
+void TestTimezoneIndex::testFormatUtcOffset()
+{
+    QCOMPARE(format_utc_offset(0), string("+00:00"));
+    QCOMPARE(format_utc_offset(8 * 3600), string("+08:00"));
+    QCOMPARE(format_utc_offset(5 * 3600 + 45 * 60), string("+05:45"));
+    QCOMPARE(format_utc_offset(-(3 * 3600 + 1800)), string("-03:30"));
+}
+
+void TestTimezoneIndex::testIndexLoad()
+{
+    TzifBlock utc;
+    utc.types = {{0, false, "UTC"}};
+    QVERIFY(write_test_file(m_zoneinfoFolder + "/America/New_York",
+        _make_tzif('2', _make_new_york(), _make_new_york(), "EST5EDT,M3.2.0,M11.1.0")));
+    QVERIFY(write_test_file(m_zoneinfoFolder + "/Etc/UTC", _make_tzif_v1(utc)));
+    QVERIFY(write_test_file(m_zoneinfoFolder + "/zone.tab", "# not a tzif file\n"));
+    QVERIFY(write_test_file(m_zoneinfoFolder + "/Empty", ""));
+    QVERIFY(write_test_file(m_zoneinfoFolder + "/../outside", _make_tzif_v1(utc)));
+
+    TimezoneIndex index(m_zoneinfoFolder.c_str());
+    QCOMPARE(index.load({"America/New_York", "zone.tab", "Missing/Zone", "Empty", "../outside", "/etc/localtime", "Etc/UTC"}),
+             (size_t)2);
+    QCOMPARE(index.size(), (size_t)2);
+    QCOMPARE(index.get_name(0), string("America/New_York"));
+    QCOMPARE(index.get_name(1), string("Etc/UTC"));
+    QCOMPARE(index.get_type(0, UTC_2023_07_01).abbreviation, string("EDT"));
+    // late March 2040 is past the last transition, the footer gives dst
+    QCOMPARE(index.get_type(0, UTC_CET_DST_START_2040).abbreviation, string("EDT"));
+    QCOMPARE(index.get_type(1, UTC_2023_07_01).offset, 0);
+    // a second load replaces the zones
+    QCOMPARE(index.load({"Etc/UTC"}), (size_t)1);
+    QCOMPARE(index.get_name(0), string("Etc/UTC"));
+}
+
+QTEST_GUILESS_MAIN(TestTimezoneIndex)
+#include "tst_timezone_index.moc"
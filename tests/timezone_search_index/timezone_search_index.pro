@@ -0,0 +1,5 @@
+include(../tests.pri)
+TARGET = tst_timezone_search_index
+
+SOURCES += tst_timezone_search_index.cpp \
+    $$SRC_FOLDER/timezone_search_index.cpp
@@ -0,0 +1,251 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "test_utility.h"
+#include "timezone_search_index.h"
+
+class TestTimezoneSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testNormalize();
+    void testEmptyQuery();
+    void testWordPrefix();
+    void testShortWordNotInside();
+    void testSubstring();
+    void testCaseAndSeparators();
+    void testMultiWord();
+    void testMultiWordLaterMiss();
+    void testMultiWordFirstMiss();
+    void testLinkAlias();
+    void testCountryAlias();
+    void testMissingAliasFiles();
+    void testRebuild();
+    void benchmarkTypeAhead();
+
+private:
+    // names of matched documents
+    vector<string> _search(const TimezoneSearchIndex &index, const string& query);
+
+    string m_zoneinfoFolder;
+    vector<string> m_names;
+    QTemporaryDir m_folder;
+};
+
+void TestTimezoneSearchIndex::init()
+{
+    QVERIFY(m_folder.isValid());
+    m_zoneinfoFolder = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    QVERIFY(write_test_file(m_zoneinfoFolder + "/" TZDATA_ZI_FILENAME,
+        "# version 2022a\n"
+        "Z Asia/Kolkata 5:53:28 - LMT 1854 Jun 28\n"
+        "L Asia/Kolkata Asia/Calcutta\n"
+        "L Europe/Berlin Arctic/Longyearbyen_Fake\n"
+        "L America/Argentina/Buenos_Aires America/Buenos_Aires\n"));
+    QVERIFY(write_test_file(m_zoneinfoFolder + "/" ZONE_TAB_FILENAME,
+        "# tz zone descriptions\n"
+        "IN\t+2232+08822\tAsia/Kolkata\n"
+        "DE\t+5230+01322\tEurope/Berlin\tmost of Germany\n"
+        "AR\t-3436-05827\tAmerica/Argentina/Buenos_Aires\tBuenos Aires (BA, CF)\n"
+        "TW\t+2503+12130\tAsia/Taipei\n"
+        "US\t+404251-0740023\tAmerica/New_York\tEastern (most areas)\n"));
+    QVERIFY(write_test_file(m_zoneinfoFolder + "/" ISO3166_TAB_FILENAME,
+        "# ISO 3166 alpha-2 country codes\n"
+        "AR\tArgentina\n"
+        "DE\tGermany\n"
+        "IN\tIndia\n"
+        "TW\tTaiwan\n"
+        "US\tUnited States\n"));
+    m_names = {"America/Argentina/Buenos_Aires", "America/New_York", "Asia/Kolkata", "Asia/Taipei",
+               "Europe/Berlin", "UTC"};
+}
+
+vector<string> TestTimezoneSearchIndex::_search(const TimezoneSearchIndex &index, const string& query)
+{
+    vector<char> matched;
+    size_t count = index.search(query, matched);
+    vector<string> names;
+    for (size_t i = 0; i < matched.size(); i++)
+    {
+        if (matched[i])
+            names.push_back(m_names[i]);
+    }
+    // the count agrees with the flags
+    if (count != names.size())
+        names.push_back("count mismatch");
+    return names;
+}
+
+void TestTimezoneSearchIndex::testNormalize()
+{
+    QCOMPARE(normalize_timezone_text("America/Argentina/Buenos_Aires"), string("america argentina buenos aires"));
+    QCOMPARE(normalize_timezone_text("  Etc/GMT-14 "), string("etc gmt 14"));
+    QCOMPARE(normalize_timezone_text("//"), string());
+}
+
+void TestTimezoneSearchIndex::testEmptyQuery()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    QCOMPARE(index.size(), m_names.size());
+    QCOMPARE(_search(index, ""), m_names);
+    QCOMPARE(_search(index, " / "), m_names);
+}
+
+void TestTimezoneSearchIndex::testWordPrefix()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    QCOMPARE(_search(index, "a"), vector<string>({"America/Argentina/Buenos_Aires", "America/New_York",
+                                                  "Asia/Kolkata", "Asia/Taipei"}));
+    QCOMPARE(_search(index, "ne"), vector<string>({"America/New_York"}));
+}
+
+void TestTimezoneSearchIndex::testShortWordNotInside()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    // "er" is inside america and berlin but starts no word
+    QVERIFY(_search(index, "er").empty());
+}
+
+void TestTimezoneSearchIndex::testSubstring()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    QCOMPARE(_search(index, "erl"), vector<string>({"Europe/Berlin"}));
+    QCOMPARE(_search(index, "aipe"), vector<string>({"Asia/Taipei"}));
+    QVERIFY(_search(index, "xyz").empty());
+}
+
+void TestTimezoneSearchIndex::testCaseAndSeparators()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    QCOMPARE(_search(index, "NEW_YORK"), vector<string>({"America/New_York"}));
+    QCOMPARE(_search(index, "new-york"), vector<string>({"America/New_York"}));
+}
+
+void TestTimezoneSearchIndex::testMultiWord()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    QCOMPARE(_search(index, "america york"), vector<string>({"America/New_York"}));
+    QCOMPARE(_search(index, "as ta"), vector<string>({"Asia/Taipei"}));
+}
+
+void TestTimezoneSearchIndex::testMultiWordLaterMiss()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    vector<char> matched;
+    // first word matches four zones, the second none
+    QCOMPARE(index.search("america xyz", matched), (size_t)0);
+    QCOMPARE(matched.size(), m_names.size());
+    QCOMPARE((size_t)std::count(matched.begin(), matched.end(), 1), (size_t)0);
+    QCOMPARE(index.search("a qq", matched), (size_t)0);
+    QCOMPARE((size_t)std::count(matched.begin(), matched.end(), 1), (size_t)0);
+}
+
+void TestTimezoneSearchIndex::testMultiWordFirstMiss()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    vector<char> matched;
+    QCOMPARE(index.search("xyz america", matched), (size_t)0);
+    QCOMPARE((size_t)std::count(matched.begin(), matched.end(), 1), (size_t)0);
+}
+
+void TestTimezoneSearchIndex::testLinkAlias()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.load_aliases();
+    index.build(m_names);
+    QCOMPARE(_search(index, "calcutta"), vector<string>({"Asia/Kolkata"}));
+    // link listed the other way around
+    QCOMPARE(_search(index, "america buenos"), vector<string>({"America/Argentina/Buenos_Aires"}));
+    QCOMPARE(_search(index, "longyearbyen"), vector<string>({"Europe/Berlin"}));
+}
+
+void TestTimezoneSearchIndex::testCountryAlias()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.load_aliases();
+    index.build(m_names);
+    QCOMPARE(_search(index, "taiwan"), vector<string>({"Asia/Taipei"}));
+    QCOMPARE(_search(index, "germ"), vector<string>({"Europe/Berlin"}));
+    QCOMPARE(_search(index, "united st"), vector<string>({"America/New_York"}));
+}
+
+void TestTimezoneSearchIndex::testMissingAliasFiles()
+{
+    string missing = m_zoneinfoFolder + "/missing";
+    TimezoneSearchIndex index(missing.c_str());
+    index.load_aliases();
+    index.build(m_names);
+    QVERIFY(_search(index, "calcutta").empty());
+    QCOMPARE(_search(index, "kolkata"), vector<string>({"Asia/Kolkata"}));
+}
+
+void TestTimezoneSearchIndex::testRebuild()
+{
+    TimezoneSearchIndex index(m_zoneinfoFolder.c_str());
+    index.build(m_names);
+    m_names = {"UTC", "Asia/Taipei"};
+    index.build(m_names);
+    QCOMPARE(index.size(), (size_t)2);
+    QCOMPARE(_search(index, "taipei"), vector<string>({"Asia/Taipei"}));
+    QVERIFY(_search(index, "berlin").empty());
+}
+
+void TestTimezoneSearchIndex::benchmarkTypeAhead()
+{
+    // host tzdata, every zone typed one letter at a time like the virtual keyboard does
+    ifstream zoneFile(ZONEINFO_FOLDER "/" ZONE_TAB_FILENAME);
+    if (!zoneFile.good())
+        QSKIP("no host tzdata");
+    vector<string> names;
+    string line;
+    while (getline(zoneFile, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        stringstream stream(line);
+        string code, coordinates, name;
+        if (getline(stream, code, '\t') && getline(stream, coordinates, '\t') && getline(stream, name, '\t'))
+            names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    TimezoneSearchIndex index;
+    index.load_aliases();
+    index.build(names);
+    vector<char> matched;
+    size_t queries = 0;
+    size_t missing = 0;
+    QBENCHMARK {
+        for (size_t doc = 0; doc < names.size(); doc++)
+        {
+            for (size_t length = 1; length <= names[doc].size(); length++)
+            {
+                index.search(names[doc].substr(0, length), matched);
+                // every prefix finds its own zone
+                if (!matched[doc])
+                    missing++;
+                queries++;
+            }
+        }
+    }
+    qDebug("%zu zones, %zu queries per iteration", names.size(), queries);
+    QCOMPARE(missing, (size_t)0);
+}
+
+QTEST_GUILESS_MAIN(TestTimezoneSearchIndex)
+#include "tst_timezone_search_index.moc"
@@ -0,0 +1,185 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <vector>
+#include <QtTest>
+#include <QSignalSpy>
+
+#include "uevent_monitor.h"
+
+using namespace std;
+
+#define MMC1_DEVPATH "/devices/platform/soc@0/30800000.bus/30b50000.mmc/mmc_host/mmc1/mmc1:aaaa/block/mmcblk1"
+#define USB_DEVPATH  "/devices/platform/soc@0/32f10108.usb/38200000.usb/xhci-hcd.1.auto/usb1/1-1/1-1.2"
+
+// kernel message, header and fields separated by nul like on the netlink socket
+static string make_uevent(const string& header, const vector<string>& fields)
+{
+    string message = header;
+    message.push_back('\0');
+    for (auto &field : fields)
+    {
+        message += field;
+        message.push_back('\0');
+    }
+    return message;
+}
+
+// synthetic uevents through handleMessage, no netlink socket involved
+class TestUEventMonitor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParsePartition();
+    void testParseDisk();
+    void testParseFullDevName();
+    void testParseWithoutHeader();
+    void testParseMissingAction();
+    void testPartitionAdd();
+    void testDiskRemove();
+    void testUsbInterface();
+    void testIgnoreOtherSubsystem();
+    void testIgnoreUdevMessage();
+    void testSeveralEvents();
+};
+
+void TestUEventMonitor::testParsePartition()
+{
+    const string message = make_uevent("add@" MMC1_DEVPATH "/mmcblk1p1", {
+        "ACTION=add", "DEVPATH=" MMC1_DEVPATH "/mmcblk1p1", "SUBSYSTEM=block",
+        "MAJOR=179", "MINOR=97", "DEVNAME=mmcblk1p1", "DEVTYPE=partition", "PARTN=1", "SEQNUM=2345"});
+    auto ret = UEvent::parse(message.data(), message.size());
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.getAction(), string("add"));
+    QCOMPARE(ret.first.getSubsystem(), string("block"));
+    QCOMPARE(ret.first.getDevName(), string("mmcblk1p1"));
+    QVERIFY(ret.first.isPartition());
+    QCOMPARE(ret.first.getDiskName(), string("mmcblk1"));
+}
+
+void TestUEventMonitor::testParseDisk()
+{
+    const string message = make_uevent("add@" MMC1_DEVPATH, {
+        "ACTION=add", "DEVPATH=" MMC1_DEVPATH, "SUBSYSTEM=block", "DEVNAME=mmcblk1", "DEVTYPE=disk"});
+    auto ret = UEvent::parse(message.data(), message.size());
+    QVERIFY(ret.second);
+    QVERIFY(!ret.first.isPartition());
+    QCOMPARE(ret.first.getDiskName(), string("mmcblk1"));
+}
+
+void TestUEventMonitor::testParseFullDevName()
+{
+    const string message = make_uevent("change@" MMC1_DEVPATH, {
+        "ACTION=change", "DEVPATH=" MMC1_DEVPATH, "SUBSYSTEM=block", "DEVNAME=/dev/mmcblk1", "DEVTYPE=disk"});
+    auto ret = UEvent::parse(message.data(), message.size());
+    QVERIFY(ret.second);
+    QCOMPARE(ret.first.getDevName(), string("mmcblk1"));
+}
+
+void TestUEventMonitor::testParseWithoutHeader()
+{
+    const string message = make_uevent("ACTION=add", {"DEVPATH=" MMC1_DEVPATH, "SUBSYSTEM=block"});
+    QCOMPARE(UEvent::parse(message.data(), message.size()).second, false);
+    // header only, not terminated
+    const char header[] = {'a', 'd', 'd', '@', '/'};
+    QCOMPARE(UEvent::parse(header, sizeof(header)).second, false);
+}
+
+void TestUEventMonitor::testParseMissingAction()
+{
+    const string message = make_uevent("add@" MMC1_DEVPATH, {"DEVPATH=" MMC1_DEVPATH, "SUBSYSTEM=block"});
+    QCOMPARE(UEvent::parse(message.data(), message.size()).second, false);
+}
+
+void TestUEventMonitor::testPartitionAdd()
+{
+    UEventMonitor monitor;
+    QSignalSpy spy(&monitor, &UEventMonitor::blockDeviceChanged);
+    const string message = make_uevent("add@" MMC1_DEVPATH "/mmcblk1p2", {
+        "ACTION=add", "DEVPATH=" MMC1_DEVPATH "/mmcblk1p2", "SUBSYSTEM=block",
+        "DEVNAME=mmcblk1p2", "DEVTYPE=partition"});
+    QVERIFY(monitor.handleMessage(message.data(), message.size()));
+    QCOMPARE(spy.count(), 1);
+    const auto arguments = spy.takeFirst();
+    QCOMPARE(arguments.at(0).toString(), QString("add"));
+    QCOMPARE(arguments.at(1).toString(), QString("mmcblk1"));
+    QCOMPARE(arguments.at(2).toString(), QString("mmcblk1p2"));
+}
+
+void TestUEventMonitor::testDiskRemove()
+{
+    UEventMonitor monitor;
+    QSignalSpy spy(&monitor, &UEventMonitor::blockDeviceChanged);
+    const string message = make_uevent("remove@" MMC1_DEVPATH, {
+        "ACTION=remove", "DEVPATH=" MMC1_DEVPATH, "SUBSYSTEM=block", "DEVNAME=mmcblk1", "DEVTYPE=disk"});
+    QVERIFY(monitor.handleMessage(message.data(), message.size()));
+    QCOMPARE(spy.count(), 1);
+    const auto arguments = spy.takeFirst();
+    QCOMPARE(arguments.at(0).toString(), QString("remove"));
+    QCOMPARE(arguments.at(1).toString(), QString("mmcblk1"));
+    // empty partition means the whole disk
+    QVERIFY(arguments.at(2).toString().isEmpty());
+}
+
+void TestUEventMonitor::testUsbInterface()
+{
+    UEventMonitor monitor;
+    QSignalSpy usbSpy(&monitor, &UEventMonitor::usbDeviceChanged);
+    QSignalSpy blockSpy(&monitor, &UEventMonitor::blockDeviceChanged);
+    const string message = make_uevent("add@" USB_DEVPATH "/1-1.2:1.0", {
+        "ACTION=add", "DEVPATH=" USB_DEVPATH "/1-1.2:1.0", "SUBSYSTEM=usb", "DEVTYPE=usb_interface",
+        "INTERFACE=8/6/80"});
+    QVERIFY(monitor.handleMessage(message.data(), message.size()));
+    QCOMPARE(usbSpy.count(), 1);
+    QCOMPARE(blockSpy.count(), 0);
+    const auto arguments = usbSpy.takeFirst();
+    QCOMPARE(arguments.at(0).toString(), QString("add"));
+    QCOMPARE(arguments.at(1).toString(), QString("1-1.2:1.0"));
+}
+
+void TestUEventMonitor::testIgnoreOtherSubsystem()
+{
+    UEventMonitor monitor;
+    QSignalSpy spy(&monitor, &UEventMonitor::blockDeviceChanged);
+    const string message = make_uevent("add@/devices/virtual/net/tun0", {
+        "ACTION=add", "DEVPATH=/devices/virtual/net/tun0", "SUBSYSTEM=net", "INTERFACE=tun0"});
+    QCOMPARE(monitor.handleMessage(message.data(), message.size()), false);
+    QCOMPARE(spy.count(), 0);
+}
+
+void TestUEventMonitor::testIgnoreUdevMessage()
+{
+    UEventMonitor monitor;
+    QSignalSpy spy(&monitor, &UEventMonitor::blockDeviceChanged);
+    // udev re-broadcast, handled by the kernel copy already
+    const string message = make_uevent("libudev", {
+        "ACTION=add", "DEVPATH=" MMC1_DEVPATH, "SUBSYSTEM=block", "DEVNAME=mmcblk1", "DEVTYPE=disk"});
+    QCOMPARE(monitor.handleMessage(message.data(), message.size()), false);
+    QCOMPARE(spy.count(), 0);
+}
+
+void TestUEventMonitor::testSeveralEvents()
+{
+    UEventMonitor monitor;
+    QSignalSpy spy(&monitor, &UEventMonitor::blockDeviceChanged);
+    // inserting a card gives the disk then each partition
+    const vector<string> messages = {
+        make_uevent("add@" MMC1_DEVPATH, {
+            "ACTION=add", "DEVPATH=" MMC1_DEVPATH, "SUBSYSTEM=block", "DEVNAME=mmcblk1", "DEVTYPE=disk"}),
+        make_uevent("add@" MMC1_DEVPATH "/mmcblk1p1", {
+            "ACTION=add", "DEVPATH=" MMC1_DEVPATH "/mmcblk1p1", "SUBSYSTEM=block",
+            "DEVNAME=mmcblk1p1", "DEVTYPE=partition"}),
+        make_uevent("add@" MMC1_DEVPATH "/mmcblk1p2", {
+            "ACTION=add", "DEVPATH=" MMC1_DEVPATH "/mmcblk1p2", "SUBSYSTEM=block",
+            "DEVNAME=mmcblk1p2", "DEVTYPE=partition"}),
+    };
+    for (auto &message : messages)
+        QVERIFY(monitor.handleMessage(message.data(), message.size()));
+    QCOMPARE(spy.count(), 3);
+    QVERIFY(spy.at(0).at(2).toString().isEmpty());
+    QCOMPARE(spy.at(2).at(2).toString(), QString("mmcblk1p2"));
+}
+
+QTEST_GUILESS_MAIN(TestUEventMonitor)
+#include "tst_uevent_monitor.moc"
@@ -0,0 +1,6 @@
+include(../tests.pri)
+TARGET = tst_uevent_monitor
+
+HEADERS += $$SRC_FOLDER/include/uevent_monitor.h
+SOURCES += tst_uevent_monitor.cpp \
+    $$SRC_FOLDER/uevent_monitor.cpp
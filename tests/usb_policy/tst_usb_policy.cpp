@@ -0,0 +1,453 @@
+// Copyright (C) 2022 The Advantech Company Ltd.
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "test_utility.h"
+#include "usb_policy.h"
+
+using namespace std;
+
+// fake /sys/bus/usb/devices and udev rules folder, the kernel side effects of writing authorized are not simulated,
+// interfaces a device would get are created up front
+class TestUsbPolicy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testParseClasses();
+    void testParsePorts();
+    void testIsAllowed();
+    void testDefaults();
+    void testGetDevicesOrder();
+    void testGetDevice();
+    void testApplyKeepsDefaultsOffWithBlockList();
+    void testApplyPortsOnly();
+    void testApplyWithoutBlockList();
+    void testApplyDisabled();
+    void testApplyOldKernel();
+    void testHotplugAuthorizesAllowedDevice();
+    void testHotplugBlockedClassInterface();
+    void testHotplugBlockedPort();
+    void testHotplugInterfaceEvent();
+    void testHotplugGone();
+    void testAuthorizedDefault();
+    void testUdevRules();
+    void testUdevRulesDisabled();
+    void testPolicyPersistsAfterExit();
+    void testPolicyRemovedWithoutBlockList();
+
+private:
+    void _add_root_hub(const string& name);
+    void _add_device(const string& name, int usbClass, bool authorized);
+    void _add_interface(const string& name, int usbClass, bool authorized);
+    string _read(const string& name, const char* attribute);
+
+    QTemporaryDir m_folder;
+    string m_sysfsFolder;
+    string m_rulesFile;
+};
+
+void TestUsbPolicy::init()
+{
+    QVERIFY(m_folder.isValid());
+    m_sysfsFolder = m_folder.path().toStdString() + "/" + QTest::currentTestFunction();
+    const string rulesFolder = m_folder.path().toStdString() + "/" + QTest::currentTestFunction() + "-rules.d";
+    QVERIFY(QDir().mkpath(QString::fromStdString(rulesFolder)));
+    m_rulesFile = rulesFolder + "/70-settings-usb-policy.rules";
+    _add_root_hub("usb1");
+    _add_interface("1-0:1.0", USB_CLASS_HUB, true);
+    _add_device("1-1", USB_CLASS_HUB, true);
+    _add_interface("1-1:1.0", USB_CLASS_HUB, true);
+}
+
+void TestUsbPolicy::_add_root_hub(const string& name)
+{
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/bDeviceClass", "09\n"));
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/authorized", "1\n"));
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/authorized_default", "1\n"));
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/interface_authorized_default", "1\n"));
+}
+
+void TestUsbPolicy::_add_device(const string& name, int usbClass, bool authorized)
+{
+    char buff[8] = {0};
+    snprintf(buff, sizeof(buff), "%02x\n", usbClass);
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/bDeviceClass", buff));
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/authorized", authorized ? "1\n" : "0\n"));
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/idVendor", "0781\n"));
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/idProduct", "5567\n"));
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/product", "Cruzer Blade\n"));
+}
+
+void TestUsbPolicy::_add_interface(const string& name, int usbClass, bool authorized)
+{
+    char buff[8] = {0};
+    snprintf(buff, sizeof(buff), "%02x\n", usbClass);
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/bInterfaceClass", buff));
+    QVERIFY(write_test_file(m_sysfsFolder + "/" + name + "/authorized", authorized ? "1\n" : "0\n"));
+}
+
+// first character, the policy writes a single digit over the kernel value
+string TestUsbPolicy::_read(const string& name, const char* attribute)
+{
+    return read_test_file(m_sysfsFolder + "/" + name + "/" + attribute).substr(0, 1);
+}
+
+void TestUsbPolicy::testParseClasses()
+{
+    QCOMPARE(parse_usb_classes("08 e0"), set<int>({0x08, 0xe0}));
+    QCOMPARE(parse_usb_classes("08,0e, ff"), set<int>({0x08, 0x0e, 0xff}));
+    QCOMPARE(parse_usb_classes("08 xyz 100 -1"), set<int>({0x08}));
+    QVERIFY(parse_usb_classes("").empty());
+    QCOMPARE(format_usb_classes({0xe0, 0x08}), string("08 e0"));
+}
+
+void TestUsbPolicy::testParsePorts()
+{
+    QCOMPARE(parse_usb_ports("1-1.2,1-2  1-1.2"), set<string>({"1-1.2", "1-2"}));
+    QCOMPARE(format_usb_ports({"1-2", "1-1.2"}), string("1-1.2 1-2"));
+}
+
+void TestUsbPolicy::testIsAllowed()
+{
+    UsbPolicy policy;
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE});
+    policy.setBlockedPorts({"1-1"});
+    UsbDeviceInfo info;
+    info.isRootHub = true;
+    info.isInterface = false;
+    info.port = "usb1";
+    info.usbClass = USB_CLASS_HUB;
+    QVERIFY(policy.isAllowed(info));
+
+    info.isRootHub = false;
+    // the port itself and everything behind it
+    info.port = "1-1";
+    QVERIFY(!policy.isAllowed(info));
+    info.port = "1-1.4.2";
+    QVERIFY(!policy.isAllowed(info));
+    // 1-10 only shares the prefix
+    info.port = "1-10";
+    QVERIFY(policy.isAllowed(info));
+
+    info.port = "1-2";
+    info.usbClass = USB_CLASS_MASS_STORAGE;
+    QVERIFY(!policy.isAllowed(info));
+    info.usbClass = 0x03;
+    QVERIFY(policy.isAllowed(info));
+
+    policy.setEnabled(false);
+    QVERIFY(!policy.isAllowed(info));
+    // hubs stay so nothing behind them changes state when usb is turned on again
+    info.usbClass = USB_CLASS_HUB;
+    QVERIFY(policy.isAllowed(info));
+}
+
+void TestUsbPolicy::testDefaults()
+{
+    UsbPolicy policy;
+    QVERIFY(policy.isDeviceDefaultAuthorized());
+    QVERIFY(policy.isInterfaceDefaultAuthorized());
+    policy.setBlockedPorts({"1-2"});
+    QVERIFY(!policy.isDeviceDefaultAuthorized());
+    QVERIFY(policy.isInterfaceDefaultAuthorized());
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE});
+    QVERIFY(!policy.isDeviceDefaultAuthorized());
+    QVERIFY(!policy.isInterfaceDefaultAuthorized());
+    policy.setBlockedPorts({});
+    QVERIFY(!policy.isDeviceDefaultAuthorized());
+    QVERIFY(!policy.isInterfaceDefaultAuthorized());
+    policy.setBlockedClasses({});
+    policy.setEnabled(false);
+    QVERIFY(!policy.isDeviceDefaultAuthorized());
+    QVERIFY(!policy.isInterfaceDefaultAuthorized());
+}
+
+void TestUsbPolicy::testGetDevicesOrder()
+{
+    _add_device("1-1.2", 0x00, true);
+    _add_interface("1-1.2:1.0", 0x03, true);
+    _add_root_hub("usb2");
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    vector<string> names;
+    for (auto &device : usbPolicyUtil.get_devices())
+        names.push_back(device.name);
+    QCOMPARE(names, vector<string>({"usb1", "usb2", "1-1", "1-1.2", "1-0:1.0", "1-1:1.0", "1-1.2:1.0"}));
+}
+
+void TestUsbPolicy::testGetDevice()
+{
+    _add_device("1-1.2", 0x00, false);
+    _add_interface("1-1.2:1.0", USB_CLASS_MASS_STORAGE, true);
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    auto ret = usbPolicyUtil.get_device("1-1.2");
+    QVERIFY(ret.second);
+    QVERIFY(!ret.first.isRootHub);
+    QVERIFY(!ret.first.isInterface);
+    QCOMPARE(ret.first.port, string("1-1.2"));
+    QCOMPARE(ret.first.usbClass, USB_CLASS_PER_INTERFACE);
+    QCOMPARE(ret.first.vendorId, string("0781"));
+    QCOMPARE(ret.first.product, string("Cruzer Blade"));
+    QVERIFY(!ret.first.authorized);
+
+    ret = usbPolicyUtil.get_device("1-1.2:1.0");
+    QVERIFY(ret.second);
+    QVERIFY(ret.first.isInterface);
+    QCOMPARE(ret.first.port, string("1-1.2"));
+    QCOMPARE(ret.first.usbClass, USB_CLASS_MASS_STORAGE);
+    QVERIFY(ret.first.authorized);
+
+    QVERIFY(usbPolicyUtil.get_device("usb1").first.isRootHub);
+    QVERIFY(!usbPolicyUtil.get_device("1-9").second);
+    QVERIFY(!usbPolicyUtil.get_device("").second);
+}
+
+void TestUsbPolicy::testApplyKeepsDefaultsOffWithBlockList()
+{
+    _add_device("1-1.1", 0x00, true);
+    _add_interface("1-1.1:1.0", USB_CLASS_MASS_STORAGE, true);
+    _add_device("1-1.2", 0x00, true);
+    _add_interface("1-1.2:1.0", 0x03, true);
+    UsbPolicy policy;
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE});
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(policy));
+
+    // a device plugged later waits for the add uevent instead of binding at once
+    QCOMPARE(_read("usb1", "authorized_default"), string("0"));
+    QCOMPARE(_read("usb1", "interface_authorized_default"), string("0"));
+    // present devices are judged now
+    QCOMPARE(_read("1-1.1", "authorized"), string("1"));
+    QCOMPARE(_read("1-1.1:1.0", "authorized"), string("0"));
+    QCOMPARE(_read("1-1.2:1.0", "authorized"), string("1"));
+    QCOMPARE(_read("1-1", "authorized"), string("1"));
+    QVERIFY(!usbPolicyUtil.get_authorized_default());
+}
+
+void TestUsbPolicy::testApplyPortsOnly()
+{
+    _add_device("1-1.1", 0x00, true);
+    UsbPolicy policy;
+    policy.setBlockedPorts({"1-1.1"});
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(policy));
+    QCOMPARE(_read("usb1", "authorized_default"), string("0"));
+    // interfaces only exist on authorized devices, which passed the port check
+    QCOMPARE(_read("usb1", "interface_authorized_default"), string("1"));
+    QCOMPARE(_read("1-1.1", "authorized"), string("0"));
+}
+
+void TestUsbPolicy::testApplyWithoutBlockList()
+{
+    write_test_file(m_sysfsFolder + "/usb1/authorized_default", "0\n");
+    write_test_file(m_sysfsFolder + "/usb1/interface_authorized_default", "0\n");
+    _add_device("1-1.1", 0x00, false);
+    _add_interface("1-1.1:1.0", USB_CLASS_MASS_STORAGE, false);
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(UsbPolicy()));
+    QCOMPARE(_read("usb1", "authorized_default"), string("1"));
+    QCOMPARE(_read("usb1", "interface_authorized_default"), string("1"));
+    QCOMPARE(_read("1-1.1", "authorized"), string("1"));
+    QCOMPARE(_read("1-1.1:1.0", "authorized"), string("1"));
+    QVERIFY(usbPolicyUtil.get_authorized_default());
+}
+
+void TestUsbPolicy::testApplyDisabled()
+{
+    _add_device("1-1.1", 0x00, true);
+    _add_interface("1-1.1:1.0", 0x03, true);
+    UsbPolicy policy;
+    policy.setEnabled(false);
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(policy));
+    QCOMPARE(_read("usb1", "authorized_default"), string("0"));
+    QCOMPARE(_read("usb1", "interface_authorized_default"), string("0"));
+    QCOMPARE(_read("1-1.1", "authorized"), string("0"));
+    QCOMPARE(_read("1-1", "authorized"), string("1"));
+}
+
+void TestUsbPolicy::testApplyOldKernel()
+{
+    QVERIFY(QFile::remove(QString::fromStdString(m_sysfsFolder + "/usb1/interface_authorized_default")));
+    UsbPolicy policy;
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE});
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(policy));
+    QCOMPARE(_read("usb1", "authorized_default"), string("0"));
+    QVERIFY(!QFile::exists(QString::fromStdString(m_sysfsFolder + "/usb1/interface_authorized_default")));
+}
+
+void TestUsbPolicy::testHotplugAuthorizesAllowedDevice()
+{
+    UsbPolicy policy;
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE});
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(policy));
+
+    // a keyboard arrives unauthorized because of the default
+    _add_device("1-1.3", 0x00, false);
+    _add_interface("1-1.3:1.0", 0x03, false);
+    _add_interface("1-1.3:1.1", 0x03, false);
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.3"));
+    QCOMPARE(_read("1-1.3", "authorized"), string("1"));
+    QCOMPARE(_read("1-1.3:1.0", "authorized"), string("1"));
+    QCOMPARE(_read("1-1.3:1.1", "authorized"), string("1"));
+}
+
+void TestUsbPolicy::testHotplugBlockedClassInterface()
+{
+    UsbPolicy policy;
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE});
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(policy));
+
+    // composite device, the storage interface never binds
+    _add_device("1-1.4", 0x00, false);
+    _add_interface("1-1.4:1.0", USB_CLASS_MASS_STORAGE, false);
+    _add_interface("1-1.4:1.1", 0x03, false);
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.4"));
+    QCOMPARE(_read("1-1.4", "authorized"), string("1"));
+    QCOMPARE(_read("1-1.4:1.0", "authorized"), string("0"));
+    QCOMPARE(_read("1-1.4:1.1", "authorized"), string("1"));
+
+    // a device class of its own is judged as the device
+    _add_device("1-1.5", USB_CLASS_MASS_STORAGE, false);
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.5"));
+    QCOMPARE(_read("1-1.5", "authorized"), string("0"));
+}
+
+void TestUsbPolicy::testHotplugBlockedPort()
+{
+    UsbPolicy policy;
+    policy.setBlockedPorts({"1-1.2"});
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(policy));
+
+    // a hub on the blocked port and a device behind it
+    _add_device("1-1.2", USB_CLASS_HUB, false);
+    _add_device("1-1.2.1", 0x00, false);
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.2"));
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.2.1"));
+    QCOMPARE(_read("1-1.2", "authorized"), string("0"));
+    QCOMPARE(_read("1-1.2.1", "authorized"), string("0"));
+
+    // hub on another port is authorized so its devices can be judged
+    _add_device("1-1.3", USB_CLASS_HUB, false);
+    _add_interface("1-1.3:1.0", USB_CLASS_HUB, false);
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.3"));
+    QCOMPARE(_read("1-1.3", "authorized"), string("1"));
+    QCOMPARE(_read("1-1.3:1.0", "authorized"), string("1"));
+}
+
+void TestUsbPolicy::testHotplugInterfaceEvent()
+{
+    UsbPolicy policy;
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE});
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    _add_device("1-1.4", 0x00, true);
+    _add_interface("1-1.4:1.0", USB_CLASS_MASS_STORAGE, false);
+    _add_interface("1-1.4:1.1", 0x03, false);
+    // add uevents of the interfaces, after they were judged with the device it is a no-op
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.4:1.0"));
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.4:1.1"));
+    QCOMPARE(_read("1-1.4:1.0", "authorized"), string("0"));
+    QCOMPARE(_read("1-1.4:1.1", "authorized"), string("1"));
+    QVERIFY(usbPolicyUtil.apply_policy(policy, "1-1.4:1.1"));
+}
+
+void TestUsbPolicy::testHotplugGone()
+{
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(!usbPolicyUtil.apply_policy(UsbPolicy(), "1-1.9"));
+    QVERIFY(!usbPolicyUtil.apply_policy(UsbPolicy(), nullptr));
+}
+
+void TestUsbPolicy::testAuthorizedDefault()
+{
+    _add_root_hub("usb2");
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.get_authorized_default());
+    write_test_file(m_sysfsFolder + "/usb2/authorized_default", "0\n");
+    QVERIFY(!usbPolicyUtil.get_authorized_default());
+
+    TPCUsbPolicyUtility missingUtil((m_sysfsFolder + "/missing").c_str(), m_rulesFile.c_str());
+    QVERIFY(missingUtil.get_devices().empty());
+    QVERIFY(missingUtil.get_authorized_default());
+}
+
+void TestUsbPolicy::testUdevRules()
+{
+    UsbPolicy policy;
+    QVERIFY(format_usb_udev_rules(policy).empty());
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE, 0xe0});
+    policy.setBlockedPorts({"1-1.2"});
+    const string rules = format_usb_udev_rules(policy);
+    QCOMPARE(rules, string(
+        "# generated by settings, do not edit\n"
+        "ACTION!=\"add\", GOTO=\"settings_usb_policy_end\"\n"
+        "SUBSYSTEM!=\"usb\", GOTO=\"settings_usb_policy_end\"\n"
+        "KERNEL==\"usb[0-9]*\", ATTR{authorized_default}=\"0\"\n"
+        "KERNEL==\"usb[0-9]*\", TEST==\"interface_authorized_default\", ATTR{interface_authorized_default}=\"0\"\n"
+        "KERNEL==\"usb[0-9]*\", GOTO=\"settings_usb_policy_end\"\n"
+        "TEST!=\"authorized\", GOTO=\"settings_usb_policy_end\"\n"
+        "KERNEL==\"1-1.2|1-1.2.*|1-1.2:*\", ATTR{authorized}=\"0\", GOTO=\"settings_usb_policy_end\"\n"
+        "ENV{DEVTYPE}==\"usb_device\", ATTR{bDeviceClass}==\"09\", ATTR{authorized}=\"1\", GOTO=\"settings_usb_policy_end\"\n"
+        "ENV{DEVTYPE}==\"usb_interface\", ATTR{bInterfaceClass}==\"09\", ATTR{authorized}=\"1\", GOTO=\"settings_usb_policy_end\"\n"
+        "ENV{DEVTYPE}==\"usb_device\", ATTR{bDeviceClass}==\"08|e0\", ATTR{authorized}=\"0\", GOTO=\"settings_usb_policy_end\"\n"
+        "ENV{DEVTYPE}==\"usb_interface\", ATTR{bInterfaceClass}==\"08|e0\", ATTR{authorized}=\"0\", GOTO=\"settings_usb_policy_end\"\n"
+        "ATTR{authorized}=\"1\"\n"
+        "LABEL=\"settings_usb_policy_end\"\n"));
+
+    // ports only, interfaces keep the kernel default
+    policy.setBlockedClasses({});
+    const string portRules = format_usb_udev_rules(policy);
+    QVERIFY(portRules.find("ATTR{interface_authorized_default}=\"1\"") != string::npos);
+    QVERIFY(portRules.find("bDeviceClass}==\"08") == string::npos);
+}
+
+void TestUsbPolicy::testUdevRulesDisabled()
+{
+    UsbPolicy policy;
+    policy.setEnabled(false);
+    const string rules = format_usb_udev_rules(policy);
+    // hubs stay, everything else is blocked and nothing authorizes afterwards
+    QVERIFY(rules.find("ATTR{bDeviceClass}==\"09\", ATTR{authorized}=\"1\"") != string::npos);
+    QVERIFY(rules.find("\nATTR{authorized}=\"0\", GOTO=\"settings_usb_policy_end\"\n") != string::npos);
+    QVERIFY(rules.find("\nATTR{authorized}=\"1\"\n") == string::npos);
+}
+
+void TestUsbPolicy::testPolicyPersistsAfterExit()
+{
+    UsbPolicy policy;
+    policy.setBlockedClasses({USB_CLASS_MASS_STORAGE});
+    {
+        TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+        QVERIFY(usbPolicyUtil.apply_policy(policy));
+    }
+    // the app is gone, udev keeps judging new devices with the same rules, also after a reboot
+    QCOMPARE(read_test_file(m_rulesFile), format_usb_udev_rules(policy));
+    QCOMPARE(_read("usb1", "authorized_default"), string("0"));
+
+    // the next start reads back what is enforced
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(!usbPolicyUtil.get_authorized_default());
+}
+
+void TestUsbPolicy::testPolicyRemovedWithoutBlockList()
+{
+    UsbPolicy policy;
+    policy.setBlockedPorts({"1-1.1"});
+    TPCUsbPolicyUtility usbPolicyUtil(m_sysfsFolder.c_str(), m_rulesFile.c_str());
+    QVERIFY(usbPolicyUtil.apply_policy(policy));
+    QVERIFY(QFile::exists(QString::fromStdString(m_rulesFile)));
+    // nothing blocked, the kernel defaults are enough
+    QVERIFY(usbPolicyUtil.apply_policy(UsbPolicy()));
+    QVERIFY(!QFile::exists(QString::fromStdString(m_rulesFile)));
+    QVERIFY(usbPolicyUtil.apply_policy(UsbPolicy()));
+}
+
+QTEST_GUILESS_MAIN(TestUsbPolicy)
+#include "tst_usb_policy.moc"
@@ -0,0 +1,6 @@
+include(../tests.pri)
+TARGET = tst_usb_policy
+
+SOURCES += tst_usb_policy.cpp \
+    $$SRC_FOLDER/usb_policy.cpp \
+    $$SRC_FOLDER/utility.cpp